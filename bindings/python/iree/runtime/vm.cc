@@ -6,6 +6,9 @@
 
 #include "bindings/python/iree/runtime/vm.h"
 
+#include <mutex>
+#include <vector>
+
 #include "absl/strings/str_cat.h"
 #include "absl/strings/str_join.h"
 #include "absl/types/optional.h"
@@ -48,16 +51,119 @@ VmModule CreateTensorListModule() {
 }
 
 // RAII wrapper for a Py_buffer which calls PyBuffer_Release when it goes
-// out of scope.
+// out of scope unless ownership has been transferred with Detach.
 class PyBufferReleaser {
  public:
-  PyBufferReleaser(Py_buffer& b) : b_(b) {}
-  ~PyBufferReleaser() { PyBuffer_Release(&b_); }
+  PyBufferReleaser(Py_buffer& b) : b_(&b) {}
+  ~PyBufferReleaser() {
+    if (b_) PyBuffer_Release(b_);
+  }
+  void Detach() { b_ = nullptr; }
 
  private:
-  Py_buffer& b_;
+  Py_buffer* b_;
 };
 
+// Py_buffers of HAL buffers destroyed on threads not holding the GIL. Acquiring
+// the GIL on those threads (such as task executor workers retiring work) can
+// deadlock with a thread that holds the GIL while waiting on them, so they are
+// instead released by the interpreter from a pending call.
+std::mutex& GetPendingPyBufferMutex() {
+  static std::mutex* mutex = new std::mutex();
+  return *mutex;
+}
+std::vector<Py_buffer*>& GetPendingPyBuffers() {
+  static std::vector<Py_buffer*>* py_views = new std::vector<Py_buffer*>();
+  return *py_views;
+}
+
+// Releases all pending Py_buffers. Must be called with the GIL held.
+int ReleasePendingPyBuffers(void* /*arg*/) {
+  std::vector<Py_buffer*> py_views;
+  {
+    std::lock_guard<std::mutex> lock(GetPendingPyBufferMutex());
+    py_views.swap(GetPendingPyBuffers());
+  }
+  for (Py_buffer* py_view : py_views) {
+    PyBuffer_Release(py_view);
+    delete py_view;
+  }
+  return 0;
+}
+
+// iree_allocator_t free function for HAL buffers wrapping Python memory.
+// |self| is a heap-allocated Py_buffer that keeps the exporting object (and
+// its memory) alive for as long as the HAL buffer exists. HAL buffers may be
+// released on any thread; the Py_buffer is released immediately if the thread
+// holds the GIL and otherwise deferred to the interpreter.
+void ReleaseWrappedPyBuffer(void* self, void* ptr) {
+  Py_buffer* py_view = static_cast<Py_buffer*>(self);
+  // During interpreter shutdown the exporter is already gone.
+  if (!Py_IsInitialized()) {
+    delete py_view;
+    return;
+  }
+  if (PyGILState_Check()) {
+    PyBuffer_Release(py_view);
+    delete py_view;
+    return;
+  }
+  bool schedule_release = false;
+  {
+    std::lock_guard<std::mutex> lock(GetPendingPyBufferMutex());
+    schedule_release = GetPendingPyBuffers().empty();
+    GetPendingPyBuffers().push_back(py_view);
+  }
+  // Py_AddPendingCall does not require the GIL. If its queue is full the
+  // buffers are released after the next invocation instead.
+  if (schedule_release) Py_AddPendingCall(ReleasePendingPyBuffers, nullptr);
+}
+
+// Attempts to wrap the memory referenced by |py_view| in a HAL buffer without
+// copying. On success ownership of |py_view| is transferred to the buffer and
+// it is released when the buffer is destroyed. Returns nullptr if the device
+// allocator cannot import the memory (not host-local, unaligned, read-only,
+// etc) and the caller must copy instead.
+iree_hal_buffer_t* TryWrapPyBuffer(HalDevice& device, Py_buffer& py_view,
+                                   iree_hal_memory_type_t memory_type) {
+  // Empty buffers may have no data pointer, in which case the HAL buffer never
+  // calls the free function and the Py_buffer would leak. There is nothing to
+  // avoid copying anyway.
+  if (py_view.len == 0 || !py_view.buf) return nullptr;
+  // Read-only memory (bytes, read-only arrays) cannot be handed to programs
+  // that may write to their inputs.
+  if (py_view.readonly) return nullptr;
+  // Generated code may assume buffers are aligned for vector loads.
+  if (reinterpret_cast<uintptr_t>(py_view.buf) % iree_max_align_t != 0) {
+    return nullptr;
+  }
+  iree_hal_buffer_compatibility_t compatibility =
+      iree_hal_allocator_query_buffer_compatibility(
+          device.allocator(), memory_type, IREE_HAL_BUFFER_USAGE_ALL,
+          IREE_HAL_BUFFER_USAGE_DISPATCH, py_view.len);
+  if (!iree_all_bits_set(compatibility,
+                         IREE_HAL_BUFFER_COMPATIBILITY_IMPORTABLE)) {
+    return nullptr;
+  }
+
+  Py_buffer* retained_view = new Py_buffer(py_view);
+  iree_allocator_t data_allocator = {retained_view /* self */,
+                                     nullptr /* alloc */,
+                                     ReleaseWrappedPyBuffer /* free */};
+  iree_hal_buffer_t* buffer = nullptr;
+  iree_status_t status = iree_hal_allocator_wrap_buffer(
+      device.allocator(), memory_type, IREE_HAL_MEMORY_ACCESS_ALL,
+      IREE_HAL_BUFFER_USAGE_ALL,
+      iree_make_byte_span(py_view.buf, py_view.len), data_allocator, &buffer);
+  if (!iree_status_is_ok(status)) {
+    // Some allocators report importable but only support certain memory.
+    iree_status_ignore(status);
+    delete retained_view;
+    return nullptr;
+  }
+  return buffer;
+}
+
 py::dict GetFunctionReflectionDict(iree_vm_function_t& f) {
   py::dict attrs;
   for (int i = 0;; ++i) {
@@ -131,9 +237,16 @@ void VmContext::RegisterModules(std::vector<VmModule*> modules) {
 
 void VmContext::Invoke(iree_vm_function_t f, VmVariantList& inputs,
                        VmVariantList& outputs) {
-  CheckApiStatus(iree_vm_invoke(raw_ptr(), f, nullptr, inputs.raw_ptr(),
-                                outputs.raw_ptr(), iree_allocator_system()),
-                 "Error invoking function");
+  // Invocations may block on device work that releases wrapped Python buffers
+  // and do not touch Python objects so they run without the GIL.
+  iree_status_t status;
+  {
+    py::gil_scoped_release release;
+    status = iree_vm_invoke(raw_ptr(), f, nullptr, inputs.raw_ptr(),
+                            outputs.raw_ptr(), iree_allocator_system());
+  }
+  ReleasePendingPyBuffers(nullptr);
+  CheckApiStatus(status, "Error invoking function");
 }
 
 //------------------------------------------------------------------------------
@@ -222,35 +335,25 @@ void VmVariantList::PushBufferView(HalDevice& device,
   }
   PyBufferReleaser py_view_releaser(py_view);
 
-  // Whether the py object needs to be retained with the argument.
-  // Should be set to true if directly mapping, false if copied.
-  bool depends_on_pyobject = false;
-
-  // Allocate a HalBuffer.
+  // Wrap the Python memory directly when the device can access it (host-local
+  // devices) and otherwise allocate a device visible buffer and copy.
   // This is hard-coded to C-contiguous right now.
   // TODO(laurenzo): Expand to other layouts as needed.
-  // TODO(laurenzo): Wrap and retain original buffer (depends_on_pyobject=true).
-  iree_hal_buffer_t* raw_buffer;
-  CheckApiStatus(iree_hal_allocator_allocate_buffer(
-                     device.allocator(),
-                     static_cast<iree_hal_memory_type_t>(
-                         IREE_HAL_MEMORY_TYPE_HOST_LOCAL |
-                         IREE_HAL_MEMORY_TYPE_DEVICE_VISIBLE),
-                     IREE_HAL_BUFFER_USAGE_ALL, py_view.len, &raw_buffer),
-                 "Failed to allocate device visible buffer");
-  CheckApiStatus(
-      iree_hal_buffer_write_data(raw_buffer, 0, py_view.buf, py_view.len),
-      "Error writing to input buffer");
-
-  // Only capture the reference to the exporting object (incrementing it)
-  // once guaranteed successful.
-  if (depends_on_pyobject) {
-    // Note for future implementation: there needs to be a place to stash
-    // references to be kept alive which back a buffer. This is likely an
-    // additional bag of refs returned from this function, which can then
-    // be attached to an invocation.
-    throw RaisePyError(PyExc_NotImplementedError,
-                       "Dependent buffer arguments not implemented");
+  iree_hal_memory_type_t memory_type =
+      static_cast<iree_hal_memory_type_t>(IREE_HAL_MEMORY_TYPE_HOST_LOCAL |
+                                          IREE_HAL_MEMORY_TYPE_DEVICE_VISIBLE);
+  iree_hal_buffer_t* raw_buffer = TryWrapPyBuffer(device, py_view, memory_type);
+  if (raw_buffer) {
+    // The wrapped buffer now owns the view and releases it when destroyed.
+    py_view_releaser.Detach();
+  } else {
+    CheckApiStatus(iree_hal_allocator_allocate_buffer(
+                       device.allocator(), memory_type,
+                       IREE_HAL_BUFFER_USAGE_ALL, py_view.len, &raw_buffer),
+                   "Failed to allocate device visible buffer");
+    CheckApiStatus(
+        iree_hal_buffer_write_data(raw_buffer, 0, py_view.buf, py_view.len),
+        "Error writing to input buffer");
   }
 
   // Create the buffer_view. (note that numpy shape is ssize_t)
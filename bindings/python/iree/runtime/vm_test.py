@@ -12,6 +12,7 @@ from absl.testing import absltest
 import iree.compiler
 import iree.runtime
 import numpy as np
+import weakref
 
 
 def create_add_scalar_module():
@@ -94,6 +95,35 @@ class VmTest(absltest.TestCase):
       with self.assertRaises(IndexError):
         lst.get_as_ndarray(1)
 
+  def test_variant_list_buffers_wrap(self):
+    ET = iree.runtime.HalElementType
+    # Aligned, writable arrays are wrapped without copying on host-local
+    # devices and are kept alive as long as the buffer view is.
+    lst = iree.runtime.VmVariantList(5)
+    ary1 = np.asarray([1, 2, 3, 4], dtype=np.float32)
+    ary1_address = ary1.__array_interface__["data"][0]
+    lst.push_buffer_view(self.device, ary1, ET.FLOAT_32)
+    del ary1
+    ary2 = lst.get_as_ndarray(0)
+    self.assertEqual(ary1_address, ary2.__array_interface__["data"][0])
+    np.testing.assert_array_equal(ary2, [1, 2, 3, 4])
+
+    # Read-only arrays are copied.
+    ary3 = np.asarray([5, 6, 7, 8], dtype=np.float32)
+    ary3.setflags(write=False)
+    lst.push_buffer_view(self.device, ary3, ET.FLOAT_32)
+    ary4 = lst.get_as_ndarray(1)
+    self.assertNotEqual(ary3.__array_interface__["data"][0],
+                        ary4.__array_interface__["data"][0])
+    np.testing.assert_array_equal(ary3, ary4)
+
+    # Empty arrays are copied and not retained by the buffer view.
+    ary5 = np.zeros([0], dtype=np.float32)
+    ary5_ref = weakref.ref(ary5)
+    lst.push_buffer_view(self.device, ary5, ET.FLOAT_32)
+    del ary5
+    self.assertIsNone(ary5_ref())
+
   def test_variant_list_list(self):
     lst1 = iree.runtime.VmVariantList(5)
     lst2 = iree.runtime.VmVariantList(5)
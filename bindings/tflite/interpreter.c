@@ -196,11 +196,11 @@ static iree_status_t _TfLiteInterpreterRefreshOutputShapes(
   return iree_ok_status();
 }
 
-// Refreshes both input and output tensor shapes by querying the module.
-// This should be called after each shape change so that we can let the module
-// run "shape propagation" and compute the new output shapes.
-static iree_status_t _TfLiteInterpreterRefreshIOShapes(
-    TfLiteInterpreter* interpreter) {
+// Refreshes output and (if |include_inputs|) input tensor shapes by querying
+// the module. This should be called after each shape change so that we can let
+// the module run "shape propagation" and compute the new output shapes.
+static iree_status_t _TfLiteInterpreterRefreshShapes(
+    TfLiteInterpreter* interpreter, bool include_inputs) {
   IREE_TRACE_ZONE_BEGIN(z0);
   _TfLiteInterpreterShapeFrame frame;
   IREE_RETURN_AND_END_ZONE_IF_ERROR(
@@ -208,7 +208,7 @@ static iree_status_t _TfLiteInterpreterRefreshIOShapes(
 
   // Query all shapes.
   iree_status_t status = iree_ok_status();
-  if (iree_status_is_ok(status)) {
+  if (iree_status_is_ok(status) && include_inputs) {
     status = _TfLiteInterpreterRefreshInputShapes(interpreter, &frame);
   }
   if (iree_status_is_ok(status)) {
@@ -220,6 +220,28 @@ static iree_status_t _TfLiteInterpreterRefreshIOShapes(
   return status;
 }
 
+// Refreshes both input and output tensor shapes if the input shapes have
+// changed since they were last queried. Shape queries are VM invocations per
+// tensor so we avoid them when the shapes are known to be unchanged.
+static iree_status_t _TfLiteInterpreterRefreshIOShapesIfNeeded(
+    TfLiteInterpreter* interpreter) {
+  if (!interpreter->io_shapes_dirty) return iree_ok_status();
+  IREE_RETURN_IF_ERROR(
+      _TfLiteInterpreterRefreshShapes(interpreter, /*include_inputs=*/true));
+  interpreter->io_shapes_dirty = false;
+
+  // Outputs whose shapes are still unknown depend on the data and will need
+  // to be queried again after each invocation.
+  interpreter->has_dynamic_output_shapes = false;
+  for (iree_host_size_t i = 0; i < interpreter->model->output_count; ++i) {
+    if (!_TfLiteTensorHasStaticShape(&interpreter->output_tensors[i])) {
+      interpreter->has_dynamic_output_shapes = true;
+      break;
+    }
+  }
+  return iree_ok_status();
+}
+
 //===----------------------------------------------------------------------===//
 // Creation and static initialization
 //===----------------------------------------------------------------------===//
@@ -252,6 +274,7 @@ static iree_status_t _TfLiteInterpreterAllocate(
                                              (void**)&interpreter));
   memset(interpreter, 0, interpreter_size);
   interpreter->allocator = model->allocator;
+  interpreter->io_shapes_dirty = true;
   _TfLiteInterpreterOptionsSetDefaults(&interpreter->options);
   *out_interpreter = interpreter;
 
@@ -497,6 +520,7 @@ static iree_status_t _TfLiteInterpreterResizeInputTensor(
   // NOTE: the allocation may now not match the requested shape. This is just
   // how the tflite API works unfortunately; until
   // TfLiteInterpreterAllocateTensors it will remain in an indeterminate state.
+  interpreter->io_shapes_dirty = true;
 
   _TfLiteInterpreterShapeFrameDeinitialize(&frame);
   return status;
@@ -519,9 +543,9 @@ static iree_status_t _TfLiteInterpreterAllocateTensors(
   // reallocated upon resize. That's no good. Instead, we realloc each tensor
   // if their size has changed.
 
-  // Refresh all shapes from the model. It should have all of the
-  // non-data-dependent output shapes.
-  IREE_RETURN_IF_ERROR(_TfLiteInterpreterRefreshIOShapes(interpreter));
+  // Refresh all shapes from the model if any inputs were resized. It should
+  // have all of the non-data-dependent output shapes.
+  IREE_RETURN_IF_ERROR(_TfLiteInterpreterRefreshIOShapesIfNeeded(interpreter));
 
   // Drop all input tensors we hang on to in the input list. This way we aren't
   // double-allocating during the resize.
@@ -538,11 +562,24 @@ static iree_status_t _TfLiteInterpreterAllocateTensors(
         iree_vm_list_push_ref_move(interpreter->input_list, &buffer_ref));
   }
 
-  // TODO(benvanik): preallocate outputs when we support using them.
-  // We could stash the buffer views in interpreter->output_list.
-  // For now we just drop them all.
+  // Preallocate (and map) outputs with static shapes so that they are valid
+  // prior to the first invocation as in tflite. Invocations replace them with
+  // the buffers they return so TfLiteTensorData must be queried again after
+  // each TfLiteInterpreterInvoke. Outputs with data-dependent shapes are only
+  // bound once the invocation produces them.
   for (iree_host_size_t i = 0; i < interpreter->model->output_count; ++i) {
-    _TfLiteTensorDiscardBuffer(&interpreter->output_tensors[i]);
+    TfLiteTensor* tensor = &interpreter->output_tensors[i];
+    if (!tensor->buffer_is_preallocated) {
+      // Never reuse a buffer returned from the module as it may be module state.
+      _TfLiteTensorDiscardBuffer(tensor);
+    }
+    if (_TfLiteTensorHasStaticShape(tensor)) {
+      IREE_RETURN_IF_ERROR(_TfLiteTensorReallocateIfNeeded(
+          tensor, iree_hal_device_allocator(interpreter->device),
+          interpreter->allocator));
+    } else {
+      _TfLiteTensorDiscardBuffer(tensor);
+    }
   }
 
   return iree_ok_status();
@@ -575,17 +612,28 @@ static iree_status_t _TfLiteInterpreterInvoke(TfLiteInterpreter* interpreter) {
                      /*policy=*/NULL, interpreter->input_list,
                      interpreter->output_list, interpreter->allocator));
 
-  // Refresh output shapes.
-  // TODO(#3975): just use buffer view results or at least just refresh outputs.
-  IREE_RETURN_IF_ERROR(_TfLiteInterpreterRefreshIOShapes(interpreter));
+  // Refresh shapes only if they may have changed: either the inputs were
+  // resized without a following TfLiteInterpreterAllocateTensors or the output
+  // shapes are data-dependent. Static-shape models skip this entirely.
+  if (interpreter->io_shapes_dirty) {
+    IREE_RETURN_IF_ERROR(
+        _TfLiteInterpreterRefreshIOShapesIfNeeded(interpreter));
+  } else if (interpreter->has_dynamic_output_shapes) {
+    // TODO(#3975): just use buffer view results.
+    IREE_RETURN_IF_ERROR(_TfLiteInterpreterRefreshShapes(
+        interpreter, /*include_inputs=*/false));
+  }
 
-  // Map the output buffers.
-  // NOTE: we could defer the mapping unless requested and ensure state buffers
-  // remain where they currently are for the next invocation.
+  // Bind the returned buffers directly to the output tensors, replacing any
+  // preallocated buffers. The _tflite_main ABI returns its results as new
+  // buffers and has no form taking output storage; copying the results into
+  // the preallocated buffers would cost a full copy of every output on every
+  // invocation.
   for (iree_host_size_t i = 0; i < interpreter->model->output_count; ++i) {
     iree_hal_buffer_t* buffer = (iree_hal_buffer_t*)iree_vm_list_get_ref_deref(
         interpreter->output_list, i, iree_hal_buffer_get_descriptor());
     TfLiteTensor* tensor = &interpreter->output_tensors[i];
+    if (buffer && buffer == tensor->buffer) continue;
     IREE_RETURN_IF_ERROR(_TfLiteTensorBind(tensor, buffer));
   }
 
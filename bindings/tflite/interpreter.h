@@ -43,6 +43,13 @@ struct TfLiteInterpreter {
   iree_vm_list_t* output_list;
   TfLiteTensor* input_tensors;
   TfLiteTensor* output_tensors;
+
+  // True if the input shapes may have changed since the I/O shapes were last
+  // queried from the module (such as after TfLiteInterpreterResizeInputTensor).
+  bool io_shapes_dirty;
+  // True if any output shape could not be determined from the input shapes
+  // alone and must be queried after each invocation.
+  bool has_dynamic_output_shapes;
 };
 
 #endif  // IREE_BINDINGS_TFLITE_INTERPRETER_H_
@@ -184,11 +184,15 @@ TEST(CApiSimple, StaticSmoke) {
                                        input.size() * sizeof(float)),
             kTfLiteOk);
 
-  ASSERT_EQ(TfLiteInterpreterInvoke(interpreter), kTfLiteOk);
-
+  // Static-shape outputs are available prior to the first invocation.
   const TfLiteTensor* output_tensor =
       TfLiteInterpreterGetOutputTensor(interpreter, 0);
   ASSERT_NE(output_tensor, nullptr);
+  void* output_data = TfLiteTensorData(output_tensor);
+  EXPECT_NE(output_data, nullptr);
+
+  ASSERT_EQ(TfLiteInterpreterInvoke(interpreter), kTfLiteOk);
+
   EXPECT_EQ(TfLiteTensorType(output_tensor), kTfLiteFloat32);
   EXPECT_EQ(TfLiteTensorNumDims(output_tensor), 4);
   EXPECT_EQ(TfLiteTensorDim(output_tensor, 0), 1);
@@ -196,6 +200,7 @@ TEST(CApiSimple, StaticSmoke) {
   EXPECT_EQ(TfLiteTensorDim(output_tensor, 2), 8);
   EXPECT_EQ(TfLiteTensorDim(output_tensor, 3), 3);
   EXPECT_EQ(TfLiteTensorByteSize(output_tensor), sizeof(float) * 1 * 8 * 8 * 3);
+  // Results are bound directly to the output in place of the preallocation.
   EXPECT_NE(TfLiteTensorData(output_tensor), nullptr);
   EXPECT_STREQ(TfLiteTensorName(output_tensor), "output");
 
@@ -211,6 +216,21 @@ TEST(CApiSimple, StaticSmoke) {
   EXPECT_EQ(output[0], 2.f);
   EXPECT_EQ(output[1], 6.f);
 
+  // Invoking again without resizing reuses the existing shapes.
+  input[0] = 5.f;
+  ASSERT_EQ(TfLiteTensorCopyFromBuffer(input_tensor, input.data(),
+                                       input.size() * sizeof(float)),
+            kTfLiteOk);
+  ASSERT_EQ(TfLiteInterpreterInvoke(interpreter), kTfLiteOk);
+  EXPECT_EQ(TfLiteTensorNumDims(output_tensor), 4);
+  EXPECT_EQ(TfLiteTensorByteSize(output_tensor), sizeof(float) * 1 * 8 * 8 * 3);
+  EXPECT_NE(TfLiteTensorData(output_tensor), nullptr);
+  ASSERT_EQ(TfLiteTensorCopyToBuffer(output_tensor, output.data(),
+                                     output.size() * sizeof(float)),
+            kTfLiteOk);
+  EXPECT_EQ(output[0], 10.f);
+  EXPECT_EQ(output[1], 6.f);
+
   TfLiteInterpreterDelete(interpreter);
 }
 
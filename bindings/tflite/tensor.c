@@ -103,6 +103,13 @@ static iree_status_t _TfLiteTypeToElementType(
   return iree_ok_status();
 }
 
+bool _TfLiteTensorHasStaticShape(const TfLiteTensor* tensor) {
+  for (int32_t i = 0; i < tensor->shape_rank; ++i) {
+    if (tensor->shape_dims[i] < 0) return false;
+  }
+  return true;
+}
+
 iree_status_t _TfLiteTensorReallocateIfNeeded(
     TfLiteTensor* tensor, iree_hal_allocator_t* buffer_allocator,
     iree_allocator_t heap_allocator) {
@@ -133,7 +140,8 @@ iree_status_t _TfLiteTensorReallocateIfNeeded(
     return iree_ok_status();
   }
 
-  // Allocate the underlying buffer for the tensor.
+  // Drop the old buffer (if any) and allocate the new one for the tensor.
+  _TfLiteTensorDiscardBuffer(tensor);
   IREE_RETURN_AND_END_ZONE_IF_ERROR(
       z0,
       iree_hal_allocator_allocate_buffer(
@@ -150,6 +158,7 @@ iree_status_t _TfLiteTensorReallocateIfNeeded(
       z0,
       iree_hal_buffer_map_range(tensor->buffer, IREE_HAL_MEMORY_ACCESS_ALL, 0,
                                 IREE_WHOLE_BUFFER, &tensor->buffer_mapping));
+  tensor->buffer_is_preallocated = true;
 
   IREE_TRACE_ZONE_END(z0);
   return iree_ok_status();
@@ -192,6 +201,7 @@ void _TfLiteTensorDiscardBuffer(TfLiteTensor* tensor) {
   }
   iree_hal_buffer_release(tensor->buffer);
   tensor->buffer = NULL;
+  tensor->buffer_is_preallocated = false;
   IREE_TRACE_ZONE_END(z0);
 }
 
@@ -38,6 +38,10 @@ struct TfLiteTensor {
   iree_hal_buffer_t* buffer;
   // Persistently mapped buffer; invalidated when buffer is resized.
   iree_hal_buffer_mapping_t buffer_mapping;
+  // True if |buffer| was allocated by the bindings instead of being returned
+  // from the module. Preallocated output buffers are only used until the first
+  // invocation binds the buffers it returns.
+  bool buffer_is_preallocated;
 };
 
 // Parses a tfl.io.names value and sets the |tensor| name.
@@ -53,6 +57,9 @@ iree_status_t _TfLiteTensorParseTypeAttr(TfLiteTensor* tensor,
 iree_status_t _TfLiteTensorParseQuantAttr(TfLiteTensor* tensor,
                                           iree_string_view_t attr);
 
+// Returns true if all dimensions of the tensor shape are known.
+bool _TfLiteTensorHasStaticShape(const TfLiteTensor* tensor);
+
 // Reallocates and remaps the tensor buffer view if needed.
 // No-op if the buffer view is already allocated and its shape matches the
 // current tensor shape.
@@ -177,6 +177,10 @@ typedef enum iree_status_code_e {
   IREE_STATUS_UNAVAILABLE = 14,
   IREE_STATUS_DATA_LOSS = 15,
   IREE_STATUS_UNAUTHENTICATED = 16,
+  // Not an error: the operation could not complete immediately and must be
+  // resumed or reissued once it is able to make progress. Used by the VM to
+  // signal that an invocation yielded back to the host.
+  IREE_STATUS_DEFERRED = 17,
 
   IREE_STATUS_CODE_MASK = 0x1Fu,
 } iree_status_code_t;
@@ -238,6 +242,8 @@ typedef struct iree_status_handle_t* iree_status_t;
   (iree_status_code(value) == IREE_STATUS_DATA_LOSS)
 #define iree_status_is_unauthenticated(value) \
   (iree_status_code(value) == IREE_STATUS_UNAUTHENTICATED)
+#define iree_status_is_deferred(value) \
+  (iree_status_code(value) == IREE_STATUS_DEFERRED)
 
 #define IREE_STATUS_IMPL_CONCAT_INNER_(x, y) x##y
 #define IREE_STATUS_IMPL_CONCAT_(x, y) IREE_STATUS_IMPL_CONCAT_INNER_(x, y)
@@ -12,8 +12,19 @@
 #include <sys/stat.h>
 #include <sys/types.h>
 
+#include "iree/base/target_platform.h"
 #include "iree/base/tracing.h"
 
+#if defined(IREE_PLATFORM_ANDROID) || defined(IREE_PLATFORM_APPLE) || \
+    defined(IREE_PLATFORM_LINUX)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#define IREE_FILE_IO_HAVE_MMAP 1
+#elif defined(IREE_PLATFORM_WINDOWS)
+#define IREE_FILE_IO_HAVE_MAP_VIEW 1
+#endif  // IREE_PLATFORM_*
+
 iree_status_t iree_file_exists(const char* path) {
   IREE_ASSERT_ARGUMENT(path);
   IREE_TRACE_ZONE_BEGIN(z0);
@@ -92,6 +103,191 @@ iree_status_t iree_file_read_contents(const char* path,
   return status;
 }
 
+#if defined(IREE_FILE_IO_HAVE_MMAP)
+
+static iree_status_t iree_file_map_contents_impl(
+    const char* path, iree_file_map_flags_t flags,
+    iree_file_contents_t* contents) {
+  int fd = open(path, O_RDONLY | O_CLOEXEC);
+  if (fd == -1) {
+    return iree_make_status(iree_status_code_from_errno(errno),
+                            "failed to open file '%s'", path);
+  }
+
+  struct stat stat_buf;
+  if (fstat(fd, &stat_buf) == -1) {
+    close(fd);
+    return iree_make_status(iree_status_code_from_errno(errno),
+                            "failed to stat file '%s'", path);
+  }
+  iree_host_size_t file_size = (iree_host_size_t)stat_buf.st_size;
+
+  // Zero-length mappings are invalid; empty files have empty contents.
+  void* ptr = NULL;
+  if (file_size > 0) {
+    ptr = mmap(NULL, file_size, PROT_READ, MAP_SHARED, fd, 0);
+    if (ptr == MAP_FAILED) {
+      close(fd);
+      return iree_make_status(iree_status_code_from_errno(errno),
+                              "failed to map %zu bytes of file '%s'",
+                              file_size, path);
+    }
+    if (flags & IREE_FILE_MAP_FLAG_PREFETCH) {
+      // Advisory only; failures are ignored as the mapping is still valid.
+      madvise(ptr, file_size, MADV_WILLNEED);
+    }
+  }
+
+  // The mapping holds its own reference to the file.
+  close(fd);
+
+  contents->const_buffer = iree_make_const_byte_span(ptr, file_size);
+  contents->mapped = true;
+  return iree_ok_status();
+}
+
+static void iree_file_unmap_contents(iree_file_contents_t* contents) {
+  if (contents->const_buffer.data_length == 0) return;
+  munmap((void*)contents->const_buffer.data,
+         contents->const_buffer.data_length);
+}
+
+#elif defined(IREE_FILE_IO_HAVE_MAP_VIEW)
+
+static iree_status_t iree_file_map_contents_impl(
+    const char* path, iree_file_map_flags_t flags,
+    iree_file_contents_t* contents) {
+  HANDLE file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, NULL,
+                            OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+  if (file == INVALID_HANDLE_VALUE) {
+    return iree_make_status(iree_status_code_from_win32_error(GetLastError()),
+                            "failed to open file '%s'", path);
+  }
+
+  LARGE_INTEGER file_size;
+  if (!GetFileSizeEx(file, &file_size)) {
+    CloseHandle(file);
+    return iree_make_status(iree_status_code_from_win32_error(GetLastError()),
+                            "failed to query size of file '%s'", path);
+  }
+
+  // Zero-length mappings are invalid; empty files have empty contents.
+  void* ptr = NULL;
+  if (file_size.QuadPart > 0) {
+    HANDLE mapping =
+        CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, /*lpName=*/NULL);
+    if (!mapping) {
+      CloseHandle(file);
+      return iree_make_status(
+          iree_status_code_from_win32_error(GetLastError()),
+          "failed to create mapping of file '%s'", path);
+    }
+    ptr = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    // The view holds its own reference to the mapping and file.
+    CloseHandle(mapping);
+    if (!ptr) {
+      CloseHandle(file);
+      return iree_make_status(
+          iree_status_code_from_win32_error(GetLastError()),
+          "failed to map view of file '%s'", path);
+    }
+    // TODO(#3909): use PrefetchVirtualMemory for IREE_FILE_MAP_FLAG_PREFETCH
+    // when targeting Windows 8+.
+  }
+  CloseHandle(file);
+
+  contents->const_buffer =
+      iree_make_const_byte_span(ptr, (iree_host_size_t)file_size.QuadPart);
+  contents->mapped = true;
+  return iree_ok_status();
+}
+
+static void iree_file_unmap_contents(iree_file_contents_t* contents) {
+  if (contents->const_buffer.data_length == 0) return;
+  UnmapViewOfFile(contents->const_buffer.data);
+}
+
+#else
+
+static iree_status_t iree_file_map_contents_impl(
+    const char* path, iree_file_map_flags_t flags,
+    iree_file_contents_t* contents) {
+  // No mapping support; read the contents into memory instead.
+  iree_byte_span_t buffer;
+  IREE_RETURN_IF_ERROR(
+      iree_file_read_contents(path, contents->allocator, &buffer));
+  contents->const_buffer =
+      iree_make_const_byte_span(buffer.data, buffer.data_length);
+  contents->mapped = false;
+  return iree_ok_status();
+}
+
+static void iree_file_unmap_contents(iree_file_contents_t* contents) {}
+
+#endif  // IREE_FILE_IO_HAVE_*
+
+iree_status_t iree_file_map_contents(const char* path,
+                                     iree_file_map_flags_t flags,
+                                     iree_allocator_t allocator,
+                                     iree_file_contents_t** out_contents) {
+  IREE_ASSERT_ARGUMENT(path);
+  IREE_ASSERT_ARGUMENT(out_contents);
+  IREE_TRACE_ZONE_BEGIN(z0);
+  *out_contents = NULL;
+
+  iree_file_contents_t* contents = NULL;
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0, iree_allocator_malloc(allocator, sizeof(*contents),
+                                (void**)&contents));
+  contents->allocator = allocator;
+
+  iree_status_t status = iree_file_map_contents_impl(path, flags, contents);
+  if (iree_status_is_ok(status)) {
+    *out_contents = contents;
+  } else {
+    iree_allocator_free(allocator, contents);
+  }
+
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
+void iree_file_contents_free(iree_file_contents_t* contents) {
+  if (!contents) return;
+  IREE_TRACE_ZONE_BEGIN(z0);
+  iree_allocator_t allocator = contents->allocator;
+  if (contents->mapped) {
+    iree_file_unmap_contents(contents);
+  } else {
+    iree_allocator_free(allocator, (void*)contents->const_buffer.data);
+  }
+  iree_allocator_free(allocator, contents);
+  IREE_TRACE_ZONE_END(z0);
+}
+
+static iree_status_t iree_file_contents_deallocator_alloc(
+    void* self, iree_allocation_mode_t mode, iree_host_size_t byte_length,
+    void** out_ptr) {
+  return iree_make_status(IREE_STATUS_FAILED_PRECONDITION,
+                          "file contents deallocator cannot allocate");
+}
+
+static void iree_file_contents_deallocator_free(void* self, void* ptr) {
+  iree_file_contents_t* contents = (iree_file_contents_t*)self;
+  IREE_ASSERT_EQ(ptr, contents->const_buffer.data);
+  iree_file_contents_free(contents);
+}
+
+iree_allocator_t iree_file_contents_deallocator(
+    iree_file_contents_t* contents) {
+  iree_allocator_t allocator = {
+      contents,
+      iree_file_contents_deallocator_alloc,
+      iree_file_contents_deallocator_free,
+  };
+  return allocator;
+}
+
 iree_status_t iree_file_write_contents(const char* path,
                                        iree_const_byte_span_t content) {
   IREE_ASSERT_ARGUMENT(path);
@@ -29,6 +29,47 @@ iree_status_t iree_file_read_contents(const char* path,
                                       iree_allocator_t allocator,
                                       iree_byte_span_t* out_contents);
 
+// Flags controlling how file contents are mapped into memory.
+enum iree_file_map_flag_bits_t {
+  IREE_FILE_MAP_FLAG_NONE = 0u,
+  // Advises the system that the contents will be accessed soon and that it
+  // should start paging them in asynchronously. This does not block the caller.
+  IREE_FILE_MAP_FLAG_PREFETCH = 1u << 0,
+};
+typedef uint32_t iree_file_map_flags_t;
+
+// Read-only contents of a file mapped into memory.
+typedef struct iree_file_contents_t {
+  // Allocator used for this structure and the contents when not mapped.
+  iree_allocator_t allocator;
+  // Read-only contents of the file. Must not be written to.
+  iree_const_byte_span_t const_buffer;
+  // True if |const_buffer| is a mapping of the file instead of an allocation.
+  bool mapped;
+} iree_file_contents_t;
+
+// Maps a file's contents into memory read-only.
+//
+// Where supported the file is mapped shared such that multiple processes
+// mapping the same file share the same physical pages from the system file
+// cache and pages are only read from disk as they are touched. On platforms
+// without mapping support the contents are read into memory allocated from
+// |allocator|.
+//
+// The contents must be freed with iree_file_contents_free.
+iree_status_t iree_file_map_contents(const char* path,
+                                     iree_file_map_flags_t flags,
+                                     iree_allocator_t allocator,
+                                     iree_file_contents_t** out_contents);
+
+// Unmaps/frees the file |contents| and the structure itself.
+void iree_file_contents_free(iree_file_contents_t* contents);
+
+// Returns an allocator that frees |contents| when the contents data pointer is
+// freed with it. This can be used to transfer ownership of the contents to APIs
+// that take a data pointer and an allocator used to free it.
+iree_allocator_t iree_file_contents_deallocator(iree_file_contents_t* contents);
+
 // Synchronously writes a byte buffer into a file.
 // Existing contents are overwritten.
 iree_status_t iree_file_write_contents(const char* path,
@@ -6,6 +6,7 @@
 
 #include "iree/base/internal/file_io.h"
 
+#include <cstdio>
 #include <cstdlib>
 #include <cstring>
 #include <ostream>
@@ -69,6 +70,58 @@ TEST(FileIO, ReadWriteContents) {
   iree_allocator_free(iree_allocator_system(), read_contents.data);
 }
 
+TEST(FileIO, MapContents) {
+  constexpr const char* kUniqueName = "MapContents";
+  auto path = GetUniquePath(kUniqueName);
+
+  // Write the contents to disk.
+  auto write_contents = GetUniqueContents(kUniqueName);
+  IREE_ASSERT_OK(iree_file_write_contents(
+      path.c_str(),
+      iree_make_const_byte_span(write_contents.data(), write_contents.size())));
+
+  // Map the contents back into memory.
+  iree_file_contents_t* contents = nullptr;
+  IREE_ASSERT_OK(iree_file_map_contents(path.c_str(),
+                                        IREE_FILE_MAP_FLAG_PREFETCH,
+                                        iree_allocator_system(), &contents));
+
+  // Expect the contents are equal.
+  EXPECT_EQ(write_contents.size(), contents->const_buffer.data_length);
+  EXPECT_EQ(memcmp(write_contents.data(), contents->const_buffer.data,
+                   contents->const_buffer.data_length),
+            0);
+
+  // Ownership can be transferred to the deallocator.
+  iree_allocator_t deallocator = iree_file_contents_deallocator(contents);
+  iree_allocator_free(deallocator, (void*)contents->const_buffer.data);
+}
+
+TEST(FileIO, MapEmptyContents) {
+  constexpr const char* kUniqueName = "MapEmptyContents";
+  auto path = GetUniquePath(kUniqueName);
+
+  FILE* file = fopen(path.c_str(), "wb");
+  ASSERT_NE(nullptr, file);
+  fclose(file);
+
+  iree_file_contents_t* contents = nullptr;
+  IREE_ASSERT_OK(iree_file_map_contents(path.c_str(), IREE_FILE_MAP_FLAG_NONE,
+                                        iree_allocator_system(), &contents));
+  EXPECT_EQ(0, contents->const_buffer.data_length);
+  iree_file_contents_free(contents);
+}
+
+TEST(FileIO, MapMissingFile) {
+  auto path = GetUniquePath("MapMissingFile");
+  iree_file_contents_t* contents = nullptr;
+  IREE_EXPECT_STATUS_IS(
+      IREE_STATUS_NOT_FOUND,
+      iree_file_map_contents(path.c_str(), IREE_FILE_MAP_FLAG_NONE,
+                             iree_allocator_system(), &contents));
+  EXPECT_EQ(nullptr, contents);
+}
+
 }  // namespace
 }  // namespace file_io
 }  // namespace iree
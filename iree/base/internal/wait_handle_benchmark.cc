@@ -0,0 +1,183 @@
+// Copyright 2021 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include <cstddef>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+#include "iree/base/internal/wait_handle.h"
+
+// Benchmarks iree_wait_set_t operations with varying numbers of outstanding
+// handles. This is built twice: wait_handle_benchmark uses the default
+// implementation for the platform (epoll on linux/android) and
+// wait_handle_poll_benchmark disables epoll to use ppoll/poll instead so that
+// the results can be compared directly.
+//
+// NOTE: large handle counts may exceed the default per-process fd limit on
+// some systems; raise it with `ulimit -n` if the 1024 variants are skipped.
+
+namespace {
+
+//==============================================================================
+// Utilities
+//==============================================================================
+
+// A wait set populated with |count| unsignaled events.
+class WaitSetFixture {
+ public:
+  explicit WaitSetFixture(benchmark::State& state, int count) {
+    iree_status_t status = iree_wait_set_allocate(
+        (iree_host_size_t)count, iree_allocator_system(), &set_);
+    events_.reserve(count);
+    for (int i = 0; i < count && iree_status_is_ok(status); ++i) {
+      iree_event_t event;
+      status = iree_event_initialize(/*initial_state=*/false, &event);
+      if (!iree_status_is_ok(status)) break;
+      events_.push_back(event);
+      status = iree_wait_set_insert(set_, event);
+    }
+    if (!iree_status_is_ok(status)) {
+      state.SkipWithError("failed to create wait set (fd limit too low?)");
+      iree_status_ignore(status);
+      ok_ = false;
+    }
+  }
+  ~WaitSetFixture() {
+    if (set_) iree_wait_set_free(set_);
+    for (auto& event : events_) iree_event_deinitialize(&event);
+  }
+
+  bool ok() const { return ok_; }
+  iree_wait_set_t* set() { return set_; }
+  iree_event_t* event(int i) { return &events_[i]; }
+  int count() const { return (int)events_.size(); }
+
+ private:
+  bool ok_ = true;
+  iree_wait_set_t* set_ = NULL;
+  std::vector<iree_event_t> events_;
+};
+
+//==============================================================================
+// iree_wait_any
+//==============================================================================
+
+// Polls a set where a single handle is signaled.
+// This is the steady-state cost of the task executor checking for completed
+// waits while many others are still outstanding.
+void BM_WaitAnyOneSignaled(benchmark::State& state) {
+  WaitSetFixture fixture(state, (int)state.range(0));
+  if (!fixture.ok()) return;
+  // Signal the handle in the middle of the set; poll scans up to it while
+  // epoll gets it from the ready list.
+  iree_event_set(fixture.event(fixture.count() / 2));
+  for (auto _ : state) {
+    iree_wait_handle_t wake_handle;
+    iree_status_t status =
+        iree_wait_any(fixture.set(), IREE_TIME_INFINITE_PAST, &wake_handle);
+    benchmark::DoNotOptimize(wake_handle);
+    if (!iree_status_is_ok(status)) {
+      state.SkipWithError("wait failed");
+      iree_status_ignore(status);
+      break;
+    }
+  }
+}
+BENCHMARK(BM_WaitAnyOneSignaled)->Arg(8)->Arg(64)->Arg(1024);
+
+// Polls a set where no handles are signaled.
+void BM_WaitAnyNoneSignaled(benchmark::State& state) {
+  WaitSetFixture fixture(state, (int)state.range(0));
+  if (!fixture.ok()) return;
+  for (auto _ : state) {
+    iree_wait_handle_t wake_handle;
+    iree_status_t status =
+        iree_wait_any(fixture.set(), IREE_TIME_INFINITE_PAST, &wake_handle);
+    benchmark::DoNotOptimize(wake_handle);
+    iree_status_ignore(status);
+  }
+}
+BENCHMARK(BM_WaitAnyNoneSignaled)->Arg(8)->Arg(64)->Arg(1024);
+
+// Wait-wake-erase-insert: a handle is woken, erased from the set, and a new
+// wait is inserted in its place. This mirrors how the task executor retires
+// completed waits and accepts new ones.
+void BM_WaitAnyEraseInsert(benchmark::State& state) {
+  WaitSetFixture fixture(state, (int)state.range(0));
+  if (!fixture.ok()) return;
+  int next_index = 0;
+  for (auto _ : state) {
+    iree_event_t* event = fixture.event(next_index);
+    next_index = (next_index + 1) % fixture.count();
+    iree_event_set(event);
+    iree_wait_handle_t wake_handle;
+    iree_status_t status =
+        iree_wait_any(fixture.set(), IREE_TIME_INFINITE_PAST, &wake_handle);
+    if (!iree_status_is_ok(status)) {
+      state.SkipWithError("wait failed");
+      iree_status_ignore(status);
+      break;
+    }
+    iree_wait_set_erase(fixture.set(), wake_handle);
+    iree_event_reset(event);
+    status = iree_wait_set_insert(fixture.set(), *event);
+    if (!iree_status_is_ok(status)) {
+      state.SkipWithError("insert failed");
+      iree_status_ignore(status);
+      break;
+    }
+  }
+}
+BENCHMARK(BM_WaitAnyEraseInsert)->Arg(8)->Arg(64)->Arg(1024);
+
+//==============================================================================
+// iree_wait_all
+//==============================================================================
+
+// Polls a set where all handles are signaled.
+void BM_WaitAllSignaled(benchmark::State& state) {
+  WaitSetFixture fixture(state, (int)state.range(0));
+  if (!fixture.ok()) return;
+  for (int i = 0; i < fixture.count(); ++i) iree_event_set(fixture.event(i));
+  for (auto _ : state) {
+    iree_status_t status =
+        iree_wait_all(fixture.set(), IREE_TIME_INFINITE_PAST);
+    if (!iree_status_is_ok(status)) {
+      state.SkipWithError("wait failed");
+      iree_status_ignore(status);
+      break;
+    }
+  }
+}
+BENCHMARK(BM_WaitAllSignaled)->Arg(8)->Arg(64)->Arg(1024);
+
+//==============================================================================
+// iree_wait_set_t construction
+//==============================================================================
+
+// Allocates a set, inserts all handles, and frees it. One-shot sets are used
+// for multi-waits on semaphores and pay this cost on every wait.
+void BM_SetPopulate(benchmark::State& state) {
+  WaitSetFixture fixture(state, (int)state.range(0));
+  if (!fixture.ok()) return;
+  for (auto _ : state) {
+    iree_wait_set_t* set = NULL;
+    iree_status_t status = iree_wait_set_allocate(
+        (iree_host_size_t)fixture.count(), iree_allocator_system(), &set);
+    for (int i = 0; i < fixture.count() && iree_status_is_ok(status); ++i) {
+      status = iree_wait_set_insert(set, *fixture.event(i));
+    }
+    if (set) iree_wait_set_free(set);
+    if (!iree_status_is_ok(status)) {
+      state.SkipWithError("populate failed");
+      iree_status_ignore(status);
+      break;
+    }
+  }
+}
+BENCHMARK(BM_SetPopulate)->Arg(8)->Arg(64)->Arg(1024);
+
+}  // namespace
@@ -9,58 +9,474 @@
 
 #if IREE_WAIT_API == IREE_WAIT_API_EPOLL
 
+#include <errno.h>
+#include <limits.h>
+#include <poll.h>
+#include <sys/epoll.h>
+#include <time.h>
+#include <unistd.h>
+
 #include "iree/base/internal/wait_handle_posix.h"
 #include "iree/base/tracing.h"
 
+//===----------------------------------------------------------------------===//
+// Platform utilities
+//===----------------------------------------------------------------------===//
+
+// epoll lets us route the wait set operations right to the kernel: handles are
+// registered once on insert and each wait only returns the handles that are
+// ready instead of requiring a scan of the whole set as poll does. The kernel
+// keeps registered fds on a ready list and level-triggered fds are requeued at
+// the tail after being reported so repeated wait-any calls fairly rotate
+// through signaled handles.
+//
+// epoll_wait only has millisecond timeout granularity (epoll_pwait2 fixes that
+// but requires linux 5.11+) so we round up timeouts to avoid waking before the
+// deadline and spuriously returning IREE_STATUS_DEADLINE_EXCEEDED.
+//
+// Documentation: https://man7.org/linux/man-pages/man7/epoll.7.html
+
+// Converts an absolute |deadline_ns| to an epoll_wait timeout in milliseconds.
+// Must be called each time a wait is retried as prior waits may have consumed
+// some of the time.
+static int iree_epoll_timeout_ms(iree_time_t deadline_ns) {
+  if (deadline_ns == IREE_TIME_INFINITE_PAST) {
+    return 0;  // block never
+  } else if (deadline_ns == IREE_TIME_INFINITE_FUTURE) {
+    return -1;  // block forever
+  }
+  iree_duration_t timeout_ns = deadline_ns - iree_time_now();
+  if (timeout_ns <= 0) return 0;
+  iree_duration_t timeout_ms = (timeout_ns + 999999ll) / 1000000ll;
+  return timeout_ms > INT_MAX ? INT_MAX : (int)timeout_ms;
+}
+
+// Waits for up to |max_events| events on |epoll_fd| until |deadline_ns|.
+// Returns IREE_STATUS_DEADLINE_EXCEEDED if no events were ready in time.
+static iree_status_t iree_syscall_epoll_wait(int epoll_fd,
+                                             struct epoll_event* events,
+                                             int max_events,
+                                             iree_time_t deadline_ns,
+                                             int* out_event_count) {
+  *out_event_count = 0;
+  int rv = -1;
+  do {
+    rv = epoll_wait(epoll_fd, events, max_events,
+                    iree_epoll_timeout_ms(deadline_ns));
+  } while (rv < 0 && errno == EINTR);
+  if (rv > 0) {
+    // One or more events set.
+    *out_event_count = rv;
+    return iree_ok_status();
+  } else if (IREE_UNLIKELY(rv < 0)) {
+    return iree_make_status(iree_status_code_from_errno(errno),
+                            "epoll_wait failure %d", errno);
+  }
+  // rv == 0
+  // Timeout; no events set.
+  return iree_status_from_code(IREE_STATUS_DEADLINE_EXCEEDED);
+}
+
+// Polls |fds| until |deadline_ns| using ppoll.
+// Used where epoll has no advantage: single handle waits don't need an epoll
+// instance and wait-all needs to check every handle anyway.
+static iree_status_t iree_syscall_ppoll(struct pollfd* fds, nfds_t nfds,
+                                        iree_time_t deadline_ns,
+                                        int* out_signaled_count) {
+  *out_signaled_count = 0;
+  int rv = -1;
+  do {
+    // Must be recomputed each iteration as a previous ppoll may have taken
+    // some of the time.
+    struct timespec timeout_ts;
+    struct timespec* tmo_p = &timeout_ts;
+    memset(&timeout_ts, 0, sizeof(timeout_ts));
+    if (deadline_ns == IREE_TIME_INFINITE_FUTURE) {
+      tmo_p = NULL;
+    } else if (deadline_ns != IREE_TIME_INFINITE_PAST) {
+      iree_duration_t timeout_ns = deadline_ns - iree_time_now();
+      if (timeout_ns > 0) {
+        timeout_ts.tv_sec = (time_t)(timeout_ns / 1000000000ull);
+        timeout_ts.tv_nsec = (long)(timeout_ns % 1000000000ull);
+      }
+    }
+    rv = ppoll(fds, nfds, tmo_p, NULL);
+  } while (rv < 0 && errno == EINTR);
+  if (rv > 0) {
+    // One or more events set.
+    *out_signaled_count = rv;
+    return iree_ok_status();
+  } else if (rv < 0) {
+    return iree_make_status(iree_status_code_from_errno(errno),
+                            "ppoll failure %d", errno);
+  }
+  // rv == 0
+  // Timeout; no events set.
+  return iree_status_from_code(IREE_STATUS_DEADLINE_EXCEEDED);
+}
+
+// Maps a poll revent bitfield result to a status (on failure) and an indicator
+// of whether the event was signaled.
+static iree_status_t iree_resolve_poll_events(short revents,
+                                              bool* out_signaled) {
+  if (revents & POLLERR) {
+    return iree_make_status(IREE_STATUS_INTERNAL, "POLLERR on fd");
+  } else if (revents & POLLHUP) {
+    return iree_make_status(IREE_STATUS_CANCELLED, "POLLHUP on fd");
+  } else if (revents & POLLNVAL) {
+    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT, "POLLNVAL on fd");
+  }
+  *out_signaled = (revents & POLLIN) != 0;
+  return iree_ok_status();
+}
+
 //===----------------------------------------------------------------------===//
 // iree_wait_set_t
 //===----------------------------------------------------------------------===//
 
-// TODO(benvanik): iree_wait_set_s using an epoll fd.
-// epoll lets us route the wait set operations right to kernel and not need our
-// own duplicate data structure. epoll is great, just not available on mac/ios
-// so we still need poll for that. linux/android/bsd all have epoll, though.
 struct iree_wait_set_t {
-  // NOTE: we could in theory use the epoll handle directly (iree_wait_set_s
-  // then is just a pointer). Then allocate/free just go straight to the system.
-  int reserved;
+  iree_allocator_t allocator;
+
+  // epoll instance that all unique handles in the set are registered with.
+  // Each registration stores the fd in epoll_event::data so that woken events
+  // can be mapped back to user handles with fd_table.
+  int epoll_fd;
+
+  // Total capacity of unique handles.
+  iree_host_size_t handle_capacity;
+
+  // Total number of valid user_handles.
+  iree_host_size_t handle_count;
+
+  // User-provided handles with set_internal.dupe_count tracking the number of
+  // additional times each has been inserted. The list is unordered and erasure
+  // swaps the tail entry into the erased slot.
+  iree_wait_handle_t* user_handles;
+
+  // Open addressed (linear probing) hash table mapping read fds to their
+  // index in user_handles. Slots store the index + 1 such that 0 is empty.
+  // The table is kept at least half empty to keep probe sequences short.
+  uint16_t* fd_table;
+  uint32_t fd_table_mask;
+
+  // Scratch pollfd list with handle_capacity entries used for wait-all.
+  struct pollfd* poll_fds;
 };
 
+static uint32_t iree_wait_set_fd_hash(const iree_wait_set_t* set, int fd) {
+  return ((uint32_t)fd * 0x9E3779B1u) & set->fd_table_mask;
+}
+
+// Returns the fd_table slot containing |fd| or the empty slot where it would
+// be inserted.
+static uint32_t iree_wait_set_find_slot(const iree_wait_set_t* set, int fd) {
+  uint32_t slot = iree_wait_set_fd_hash(set, fd);
+  while (set->fd_table[slot] != 0) {
+    const iree_wait_handle_t* user_handle =
+        &set->user_handles[set->fd_table[slot] - 1];
+    if (iree_wait_primitive_get_read_fd(user_handle) == fd) break;
+    slot = (slot + 1) & set->fd_table_mask;
+  }
+  return slot;
+}
+
+// Removes the entry at |slot| from the fd_table by shifting back any entries
+// in the same probe sequence so that lookups never need tombstones.
+static void iree_wait_set_remove_slot(iree_wait_set_t* set, uint32_t slot) {
+  set->fd_table[slot] = 0;
+  uint32_t next_slot = slot;
+  while (true) {
+    next_slot = (next_slot + 1) & set->fd_table_mask;
+    if (set->fd_table[next_slot] == 0) break;
+    const iree_wait_handle_t* user_handle =
+        &set->user_handles[set->fd_table[next_slot] - 1];
+    uint32_t home_slot = iree_wait_set_fd_hash(
+        set, iree_wait_primitive_get_read_fd(user_handle));
+    // Move the entry into the hole if its home slot is not cyclically within
+    // (slot, next_slot].
+    bool in_range = slot <= next_slot
+                        ? (home_slot > slot && home_slot <= next_slot)
+                        : (home_slot > slot || home_slot <= next_slot);
+    if (!in_range) {
+      set->fd_table[slot] = set->fd_table[next_slot];
+      set->fd_table[next_slot] = 0;
+      slot = next_slot;
+    }
+  }
+}
+
 iree_status_t iree_wait_set_allocate(iree_host_size_t capacity,
                                      iree_allocator_t allocator,
                                      iree_wait_set_t** out_set) {
-  // TODO(benvanik): epoll_create()
+  // Be reasonable; 64K objects is too high and our index tracking in
+  // iree_wait_handle_t is limited to 16-bits.
+  if (capacity >= UINT16_MAX) {
+    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                            "wait set capacity of %zu is unreasonably large",
+                            capacity);
+  }
+
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  // Size the fd table to the next power of two with at least 2x the capacity.
+  iree_host_size_t fd_table_capacity = 4;
+  while (fd_table_capacity < capacity * 2) fd_table_capacity <<= 1;
+
+  iree_host_size_t user_handle_list_size =
+      capacity * sizeof(iree_wait_handle_t);
+  iree_host_size_t poll_fd_list_size = capacity * sizeof(struct pollfd);
+  iree_host_size_t fd_table_size = fd_table_capacity * sizeof(uint16_t);
+  iree_host_size_t total_size = sizeof(iree_wait_set_t) +
+                                user_handle_list_size + poll_fd_list_size +
+                                fd_table_size;
+
+  iree_wait_set_t* set = NULL;
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0, iree_allocator_malloc(allocator, total_size, (void**)&set));
+  set->allocator = allocator;
+  set->handle_capacity = capacity;
+  set->handle_count = 0;
+  set->user_handles =
+      (iree_wait_handle_t*)((uint8_t*)set + sizeof(iree_wait_set_t));
+  set->poll_fds =
+      (struct pollfd*)((uint8_t*)set->user_handles + user_handle_list_size);
+  set->fd_table = (uint16_t*)((uint8_t*)set->poll_fds + poll_fd_list_size);
+  set->fd_table_mask = (uint32_t)fd_table_capacity - 1;
+  memset(set->fd_table, 0, fd_table_size);
+
+  set->epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+  if (IREE_UNLIKELY(set->epoll_fd < 0)) {
+    iree_status_t status =
+        iree_make_status(iree_status_code_from_errno(errno),
+                         "unable to create epoll instance (%d)", errno);
+    iree_allocator_free(allocator, set);
+    IREE_TRACE_ZONE_END(z0);
+    return status;
+  }
+
+  *out_set = set;
+  IREE_TRACE_ZONE_END(z0);
+  return iree_ok_status();
 }
 
 void iree_wait_set_free(iree_wait_set_t* set) {
-  // TODO(benvanik): close()
+  close(set->epoll_fd);
+  iree_allocator_free(set->allocator, set);
 }
 
 iree_status_t iree_wait_set_insert(iree_wait_set_t* set,
                                    iree_wait_handle_t handle) {
-  // TODO(benvanik): epoll_ctl(EPOLL_CTL_ADD)
+  int fd = iree_wait_primitive_get_read_fd(&handle);
+
+  // Duplicate handles are reference counted as epoll only allows each fd to be
+  // registered once.
+  uint32_t slot = iree_wait_set_find_slot(set, fd);
+  if (set->fd_table[slot] != 0) {
+    iree_wait_handle_t* user_handle =
+        &set->user_handles[set->fd_table[slot] - 1];
+    ++user_handle->set_internal.dupe_count;
+    return iree_ok_status();
+  }
+
+  if (set->handle_count + 1 > set->handle_capacity) {
+    return iree_make_status(IREE_STATUS_RESOURCE_EXHAUSTED,
+                            "wait set capacity reached");
+  }
+
+  // NOTE: as with poll handles without a valid fd are kept in the set but are
+  // never registered with epoll and thus never signal.
+  if (fd >= 0) {
+    struct epoll_event event;
+    memset(&event, 0, sizeof(event));
+    event.events = EPOLLIN | EPOLLPRI;  // implicit EPOLLERR | EPOLLHUP
+    event.data.fd = fd;
+    if (IREE_UNLIKELY(epoll_ctl(set->epoll_fd, EPOLL_CTL_ADD, fd, &event) <
+                      0)) {
+      return iree_make_status(iree_status_code_from_errno(errno),
+                              "epoll_ctl add failure %d", errno);
+    }
+  }
+
+  iree_host_size_t index = set->handle_count++;
+  iree_wait_handle_t* user_handle = &set->user_handles[index];
+  IREE_IGNORE_ERROR(
+      iree_wait_handle_wrap_primitive(handle.type, handle.value, user_handle));
+  user_handle->set_internal.dupe_count = 0;
+  set->fd_table[slot] = (uint16_t)(index + 1);
+
+  return iree_ok_status();
 }
 
 void iree_wait_set_erase(iree_wait_set_t* set, iree_wait_handle_t handle) {
-  // TODO(benvanik): epoll_ctl(EPOLL_CTL_DEL)
+  // The fd table lookup is as cheap as validating the set_internal.index hint
+  // and we need the table slot anyway so the hint is not used here.
+  int fd = iree_wait_primitive_get_read_fd(&handle);
+  uint32_t slot = iree_wait_set_find_slot(set, fd);
+  if (IREE_UNLIKELY(set->fd_table[slot] == 0)) return;  // not in the set
+  iree_host_size_t index = set->fd_table[slot] - 1;
+
+  // Only drop a reference if the handle was inserted multiple times.
+  iree_wait_handle_t* user_handle = &set->user_handles[index];
+  if (user_handle->set_internal.dupe_count > 0) {
+    --user_handle->set_internal.dupe_count;
+    return;
+  }
+
+  // NOTE: closing an fd only removes it from the epoll set once every fd
+  // referring to the same open file (such as those created with dup) has been
+  // closed so handles must be erased before their fds are closed. Failures are
+  // ignored as the fd may have already been closed or never been registered.
+  if (fd >= 0) epoll_ctl(set->epoll_fd, EPOLL_CTL_DEL, fd, NULL);
+  iree_wait_set_remove_slot(set, slot);
+
+  // Since we make no guarantees about the order of the list we can just swap
+  // with the last value and update its table entry to point at the new index.
+  iree_host_size_t tail_index = set->handle_count - 1;
+  if (tail_index > index) {
+    memcpy(&set->user_handles[index], &set->user_handles[tail_index],
+           sizeof(*set->user_handles));
+    uint32_t tail_slot = iree_wait_set_find_slot(
+        set, iree_wait_primitive_get_read_fd(&set->user_handles[index]));
+    set->fd_table[tail_slot] = (uint16_t)(index + 1);
+  }
+  --set->handle_count;
 }
 
 void iree_wait_set_clear(iree_wait_set_t* set) {
-  // TODO(benvanik): close and reopen?
+  for (iree_host_size_t i = 0; i < set->handle_count; ++i) {
+    int fd = iree_wait_primitive_get_read_fd(&set->user_handles[i]);
+    if (fd >= 0) epoll_ctl(set->epoll_fd, EPOLL_CTL_DEL, fd, NULL);
+  }
+  memset(set->fd_table, 0, (set->fd_table_mask + 1) * sizeof(uint16_t));
+  set->handle_count = 0;
+}
+
+// Maps epoll event bits to a status (on failure) and an indicator of whether
+// the event was signaled.
+static iree_status_t iree_wait_set_resolve_epoll_events(uint32_t events,
+                                                        bool* out_signaled) {
+  if (events & EPOLLERR) {
+    return iree_make_status(IREE_STATUS_INTERNAL, "EPOLLERR on fd");
+  } else if (events & EPOLLHUP) {
+    return iree_make_status(IREE_STATUS_CANCELLED, "EPOLLHUP on fd");
+  }
+  *out_signaled = (events & (EPOLLIN | EPOLLPRI)) != 0;
+  return iree_ok_status();
 }
 
 iree_status_t iree_wait_all(iree_wait_set_t* set, iree_time_t deadline_ns) {
-  // TODO(benvanik): epoll_wait
+  // Make the syscall only when we have at least one valid fd.
+  // Don't use this as a sleep.
+  if (set->handle_count <= 0) {
+    return iree_ok_status();
+  }
+
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  // epoll only tells us about handles that are ready and wait-all needs to
+  // know about all of them: in the common case where everything has already
+  // signaled epoll_wait has to report every handle and when they haven't we'd
+  // have to remove those that had to avoid spinning on them. ppoll does exactly
+  // what we need in a single syscall and wait-all is rare enough (most waits
+  // are wait-any on the task executor) that rebuilding the list is fine.
+  nfds_t poll_fd_count = (nfds_t)set->handle_count;
+  for (nfds_t i = 0; i < poll_fd_count; ++i) {
+    struct pollfd* poll_fd = &set->poll_fds[i];
+    poll_fd->fd = iree_wait_primitive_get_read_fd(&set->user_handles[i]);
+    poll_fd->events = POLLIN | POLLPRI;
+    poll_fd->revents = 0;
+  }
+
+  // Repeatedly poll until all handles have been signaled. Handles that have
+  // signaled are negated so that the kernel ignores them in subsequent polls.
+  // NOTE: unlike some other poll implementations linux correctly ignores
+  // negative fds at any position in the list.
+  iree_status_t status = iree_ok_status();
+  int unsignaled_count = (int)poll_fd_count;
+  do {
+    int signaled_count = 0;
+    status = iree_syscall_ppoll(set->poll_fds, poll_fd_count, deadline_ns,
+                                &signaled_count);
+    if (!iree_status_is_ok(status)) break;
+    unsignaled_count -= signaled_count;
+    for (nfds_t i = 0; i < poll_fd_count; ++i) {
+      struct pollfd* poll_fd = &set->poll_fds[i];
+      if (poll_fd->fd < 0) continue;
+      bool signaled = false;
+      status = iree_resolve_poll_events(poll_fd->revents, &signaled);
+      if (!iree_status_is_ok(status)) break;
+      if (signaled) poll_fd->fd = -poll_fd->fd - 1;
+    }
+  } while (iree_status_is_ok(status) && unsignaled_count > 0);
+
+  IREE_TRACE_ZONE_END(z0);
+  return status;
 }
 
 iree_status_t iree_wait_any(iree_wait_set_t* set, iree_time_t deadline_ns,
                             iree_wait_handle_t* out_wake_handle) {
-  // TODO(benvanik): epoll_wait
+  if (out_wake_handle) {
+    memset(out_wake_handle, 0, sizeof(*out_wake_handle));
+  }
+
+  // Make the syscall only when we have at least one valid fd.
+  // Don't use this as a sleep.
+  if (set->handle_count <= 0) {
+    return iree_ok_status();
+  }
+
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  // We only need a single ready handle and the kernel hands us one off its
+  // ready list without touching any of the others.
+  struct epoll_event event;
+  int event_count = 0;
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0, iree_syscall_epoll_wait(set->epoll_fd, &event, 1, deadline_ns,
+                                  &event_count));
+
+  bool signaled = false;
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0, iree_wait_set_resolve_epoll_events(event.events, &signaled));
+  uint32_t slot = iree_wait_set_find_slot(set, event.data.fd);
+  if (out_wake_handle && set->fd_table[slot] != 0) {
+    iree_host_size_t index = set->fd_table[slot] - 1;
+    memcpy(out_wake_handle, &set->user_handles[index],
+           sizeof(*out_wake_handle));
+    out_wake_handle->set_internal.index = index;
+  }
+
+  IREE_TRACE_ZONE_END(z0);
+  return iree_ok_status();
 }
 
 iree_status_t iree_wait_one(iree_wait_handle_t* handle,
                             iree_time_t deadline_ns) {
-  // TODO(benvanik): just use poll?
+  int fd = iree_wait_primitive_get_read_fd(handle);
+  if (IREE_UNLIKELY(fd < 0)) {
+    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                            "wait handle has no valid fd to wait on");
+  }
+
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  // TODO(benvanik): see if we can use tracy's mutex tracking to make waits
+  // nicer (at least showing signal->wait relations).
+
+  struct pollfd poll_fd;
+  poll_fd.fd = fd;
+  poll_fd.events = POLLIN;
+  poll_fd.revents = 0;
+  int signaled_count = 0;
+  iree_status_t status =
+      iree_syscall_ppoll(&poll_fd, 1, deadline_ns, &signaled_count);
+  if (iree_status_is_ok(status)) {
+    bool signaled = false;
+    status = iree_resolve_poll_events(poll_fd.revents, &signaled);
+  }
+
+  IREE_TRACE_ZONE_END(z0);
+  return status;
 }
 
 #endif  // IREE_WAIT_API == IREE_WAIT_API_EPOLL
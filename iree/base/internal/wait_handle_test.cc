@@ -471,6 +471,40 @@ TEST(WaitSet, WaitAny) {
   iree_event_deinitialize(&ev_set);
 }
 
+// Tests that handles without a valid fd can be inserted and erased but are
+// never signaled.
+TEST(WaitSet, InvalidHandle) {
+  iree_event_t ev_set;
+  IREE_ASSERT_OK(iree_event_initialize(/*initial_state=*/true, &ev_set));
+  iree_wait_handle_t invalid_handle;
+  memset(&invalid_handle, 0, sizeof(invalid_handle));
+  iree_wait_set_t* wait_set = NULL;
+  IREE_ASSERT_OK(
+      iree_wait_set_allocate(128, iree_allocator_system(), &wait_set));
+
+  IREE_ASSERT_OK(iree_wait_set_insert(wait_set, invalid_handle));
+  IREE_EXPECT_STATUS_IS(
+      IREE_STATUS_DEADLINE_EXCEEDED,
+      iree_wait_any(wait_set, iree_time_now() + kShortTimeoutNS, NULL));
+
+  // Wait-any wakes on the valid handle only.
+  IREE_ASSERT_OK(iree_wait_set_insert(wait_set, ev_set));
+  iree_wait_handle_t wake_handle;
+  IREE_ASSERT_OK(
+      iree_wait_any(wait_set, IREE_TIME_INFINITE_PAST, &wake_handle));
+  EXPECT_EQ(0, memcmp(&ev_set.value, &wake_handle.value, sizeof(ev_set.value)));
+
+  // Wait-all never completes while the invalid handle is in the set.
+  IREE_EXPECT_STATUS_IS(
+      IREE_STATUS_DEADLINE_EXCEEDED,
+      iree_wait_all(wait_set, iree_time_now() + kShortTimeoutNS));
+  iree_wait_set_erase(wait_set, invalid_handle);
+  IREE_ASSERT_OK(iree_wait_all(wait_set, IREE_TIME_INFINITE_PAST));
+
+  iree_wait_set_free(wait_set);
+  iree_event_deinitialize(&ev_set);
+}
+
 // Tests iree_wait_any when polling (deadline_ns = IREE_TIME_INFINITE_PAST).
 TEST(WaitSet, WaitAnyPolling) {
   iree_event_t ev_unset_0, ev_unset_1;
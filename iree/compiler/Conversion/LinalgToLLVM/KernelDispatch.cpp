@@ -6,22 +6,42 @@
 
 #include "iree/compiler/Conversion/LinalgToLLVM/KernelDispatch.h"
 
+#include <cmath>
+
 #include "iree/compiler/Conversion/CodegenUtils/FunctionUtils.h"
 #include "iree/compiler/Conversion/CodegenUtils/MarkerUtils.h"
 #include "iree/compiler/Conversion/Common/Transforms.h"
+#include "iree/compiler/Conversion/LinalgToLLVM/TuningDatabase.h"
 #include "iree/compiler/Dialect/Flow/IR/FlowOps.h"
+#include "iree/compiler/Dialect/HAL/IR/HALOps.h"
 #include "iree/compiler/Dialect/HAL/IR/LoweringConfig.h"
 #include "llvm/ADT/TypeSwitch.h"
 #include "llvm/Support/CommandLine.h"
+#include "llvm/Support/MathExtras.h"
 #include "mlir/Dialect/Linalg/IR/LinalgInterfaces.h"
 #include "mlir/Dialect/Linalg/IR/LinalgOps.h"
 #include "mlir/Dialect/Linalg/Transforms/Transforms.h"
 #include "mlir/Dialect/MemRef/IR/MemRef.h"
 #include "mlir/Dialect/StandardOps/IR/Ops.h"
+#include "mlir/Dialect/Utils/StructuredOpsUtils.h"
+#include "mlir/IR/AffineMap.h"
+#include "mlir/IR/TypeUtilities.h"
 #include "mlir/Transforms/GreedyPatternRewriteDriver.h"
 
 static const unsigned kNumMaxParallelDims = 3;
 
+// Largest workgroup tile size of each distributed loop of generic ops selected
+// for a target.
+static const int64_t kMaxGenericOpsWorkgroupTileSize = 1024;
+
+// Largest workgroup tile size of the output height and width of convolutions
+// selected for a target.
+static const int64_t kMaxConvSpatialWorkgroupTileSize = 64;
+
+// Largest number of workgroups a processor executes per reservation selected
+// for a target.
+static const int64_t kMaxWorkgroupsPerReservation = 64;
+
 namespace mlir {
 namespace iree_compiler {
 
@@ -33,6 +53,8 @@ static llvm::cl::list<unsigned> clLLVMTileSizes(
                    "LLVM code generation"),
     llvm::cl::ZeroOrMore, llvm::cl::MiscFlags::CommaSeparated);
 
+// Tile sizes used when no target description is available. When set on the
+// command line they override the tile sizes derived from the target.
 static llvm::cl::opt<int> matmulWorkgroupTileSize(
     "iree-codegen-llvm-matmul-workgroup-size",
     llvm::cl::desc(
@@ -67,6 +89,20 @@ static llvm::cl::opt<int> genericOpsWorkgroupTileSize(
         "linalg.generic and linalg.indexed_generic workgroup tile size"),
     llvm::cl::init(128));
 
+static llvm::cl::opt<std::string> clTuningDatabase(
+    "iree-codegen-llvm-tuning-db",
+    llvm::cl::desc("Path to a tuning database with the lowering configuration "
+                   "to use for dispatches by the signature of their root op. "
+                   "Takes precedence over all other tile size selection"),
+    llvm::cl::init(""));
+
+static llvm::cl::opt<std::string> clTuningDatabaseDumpDir(
+    "iree-codegen-llvm-tuning-db-dump-dir",
+    llvm::cl::desc("Directory to write the lowering configuration selected "
+                   "for each dispatch to as one tuning database per "
+                   "executable"),
+    llvm::cl::init(""));
+
 /// Usually the tile sizes for the first level of tiling decides the workgroup
 /// size for the dispatch on the CPU backend. This is a general helper that
 /// converts tile sizes of the first level into workgroup sizes.
@@ -91,69 +127,273 @@ static LogicalResult setTranslationInfo(
   return setTranslationInfo(entryPointOp, translationInfo);
 }
 
+namespace {
+/// Tile sizes of the M, N, and K dimensions of a (batch) matmul for each level
+/// of tiling.
+struct MatmulTileSizes {
+  int64_t mWorkgroup, nWorkgroup;
+  int64_t mL1, nL1, kL1;
+  int64_t mVector, nVector, kVector;
+};
+}  // namespace
+
+/// Returns the value of `option` if set on the command line and `value`
+/// otherwise.
+static int64_t getOptionOr(const llvm::cl::opt<int> &option, int64_t value) {
+  return option.getNumOccurrences() ? option.getValue() : value;
+}
+
+/// Returns the size in bytes of the element type of `value`.
+static int64_t getElementSize(Value value) {
+  Type elementType = getElementTypeOrSelf(value.getType());
+  if (!elementType.isIntOrFloat()) return 4;
+  return std::max<int64_t>(
+      llvm::divideCeil(elementType.getIntOrFloatBitWidth(), 8), 1);
+}
+
+/// Returns the size in bytes of the largest element type of the operands of
+/// `linalgOp`.
+static int64_t getMaxElementSize(linalg::LinalgOp linalgOp) {
+  int64_t maxSize = 1;
+  for (OpOperand *operand : linalgOp.getInputAndOutputOperands()) {
+    maxSize = std::max(maxSize, getElementSize(operand->get()));
+  }
+  return maxSize;
+}
+
+/// Returns the number of elements of `elementSize` bytes that fit in a native
+/// vector register of `target`.
+static int64_t getNumVectorLanes(const CPUTargetDescription &target,
+                                 int64_t elementSize) {
+  return std::max<int64_t>(target.vectorSize / elementSize, 1);
+}
+
+/// Returns the matmul tile sizes for `target` such that
+/// - the accumulators of the vector tile stay in registers,
+/// - the LHS, RHS, and result L1 tiles fit in half of the L1 cache,
+/// - the result workgroup tile along with the LHS and RHS panels of one L1 tile
+///   of K fit in half of the L2 cache, and
+/// - if K is static and non-zero, the full LHS and RHS panels of a workgroup tile fit in
+///   half of the last-level cache so they are reused across the result tile.
+static MatmulTileSizes getTargetMatmulTileSizes(
+    const CPUTargetDescription &target, int64_t elementSize, int64_t kSize) {
+  MatmulTileSizes sizes;
+  int64_t numLanes = getNumVectorLanes(target, elementSize);
+  // One vector register of accumulators per row of the vector tile using at
+  // most a quarter of the registers; the rest hold the LHS and RHS values.
+  sizes.mVector = std::min<int64_t>(
+      llvm::PowerOf2Floor(std::max<int64_t>(target.numVectorRegisters / 4, 1)),
+      numLanes);
+  sizes.nVector = numLanes;
+  sizes.kVector = numLanes;
+
+  // 3 * t^2 elements in half of the L1 cache.
+  int64_t l1Elements = target.l1CacheSize / 2 / elementSize;
+  int64_t l1TileSize = std::max<int64_t>(
+      llvm::PowerOf2Floor(static_cast<uint64_t>(
+          std::sqrt(static_cast<double>(l1Elements / 3)))),
+      numLanes);
+  sizes.mL1 = sizes.nL1 = sizes.kL1 = l1TileSize;
+
+  // t^2 + 2 * t * kL1 elements in half of the L2 cache.
+  int64_t l2Elements = target.l2CacheSize / 2 / elementSize;
+  int64_t workgroupTileSize =
+      static_cast<int64_t>(std::sqrt(
+          static_cast<double>(l1TileSize * l1TileSize + l2Elements))) -
+      l1TileSize;
+  // Empty (or unknown) reductions are sized as if K were dynamic.
+  if (kSize != ShapedType::kDynamicSize && kSize > 0) {
+    // 2 * t * K elements in half of the last-level cache.
+    int64_t llcElements = target.llcSize / 2 / elementSize;
+    workgroupTileSize = std::min(workgroupTileSize, llcElements / (2 * kSize));
+  }
+  workgroupTileSize = std::max<int64_t>(
+      llvm::PowerOf2Floor(std::max<int64_t>(workgroupTileSize, 0)),
+      l1TileSize);
+  sizes.mWorkgroup = sizes.nWorkgroup = workgroupTileSize;
+  return sizes;
+}
+
+/// Returns the largest tile size no larger than `maxSize` that evenly divides
+/// the static `dim` and is a multiple of `vectorSize`.
+static int64_t getTileSizeForDim(int64_t dim, int64_t maxSize,
+                                 int64_t vectorSize) {
+  if (dim == ShapedType::kDynamicSize) return maxSize;
+  if (dim < vectorSize) return vectorSize;
+  for (int64_t i = std::min(maxSize, dim); i > 0; --i) {
+    if (dim % i == 0 && i % vectorSize == 0) {
+      return i;
+    }
+  }
+  return maxSize;
+}
+
+/// Sets the lowering configuration of a (batch) matmul with `numBatchDims`
+/// leading batch dimensions using `sizes` adjusted to the static shape of the
+/// operands.
+static LogicalResult setMatmulRootConfig(
+    FuncOp entryPointFn, linalg::ContractionOpInterface contractionOp,
+    MatmulTileSizes sizes, unsigned numBatchDims) {
+  auto lhsShape = getUntiledShape(contractionOp.lhs());
+  auto rhsShape = getUntiledShape(contractionOp.rhs());
+  if (!lhsShape.empty() && !rhsShape.empty()) {
+    // Find largest tile size that is a multiple of the vector size.
+    sizes.mWorkgroup = getTileSizeForDim(lhsShape[numBatchDims],
+                                         sizes.mWorkgroup, sizes.mVector);
+    sizes.nWorkgroup = getTileSizeForDim(rhsShape[numBatchDims + 1],
+                                         sizes.nWorkgroup, sizes.nVector);
+    sizes.mL1 = getTileSizeForDim(sizes.mWorkgroup, sizes.mL1, sizes.mVector);
+    sizes.nL1 = getTileSizeForDim(sizes.nWorkgroup, sizes.nL1, sizes.nVector);
+    sizes.kL1 = getTileSizeForDim(rhsShape[numBatchDims], sizes.kL1,
+                                  sizes.kVector);
+  }
+  auto withBatchDims = [&](ArrayRef<int64_t> values) {
+    SmallVector<int64_t, 4> result(numBatchDims, 1);
+    result.append(values.begin(), values.end());
+    return result;
+  };
+  TileSizesListType tileSizes = {
+      withBatchDims({sizes.mWorkgroup, sizes.nWorkgroup}),
+      withBatchDims({sizes.mL1, sizes.nL1, sizes.kL1}),
+      withBatchDims({sizes.mVector, sizes.nVector, sizes.kVector})};
+  SmallVector<int64_t, 4> nativeVectorSize =
+      withBatchDims({sizes.mVector, sizes.nVector, sizes.kVector});
+  IREE::HAL::LoweringConfig config = buildConfigAttr(
+      tileSizes, nativeVectorSize, contractionOp->getContext());
+  setLoweringConfig(contractionOp, config);
+  return setTranslationInfo(
+      entryPointFn, IREE::HAL::DispatchLoweringPassPipeline::CPUVectorization,
+      getWorkloadPerWorkgroup(tileSizes[0]));
+}
+
 /// Sets the lowering configuration for dispatch region with root op that
 /// implements the contraction operation interface.
 static LogicalResult setRootConfig(
-    FuncOp entryPointFn, linalg::ContractionOpInterface contractionOp) {
+    FuncOp entryPointFn, linalg::ContractionOpInterface contractionOp,
+    const Optional<CPUTargetDescription> &targetDescription) {
   if (hasLoweringConfig(entryPointFn)) return success();
-  if (contractionOp.isRowMajorMatmul()) {
-    int mWorkgroupSize = matmulWorkgroupTileSize;
-    int nWorkgroupSize = matmulWorkgroupTileSize;
-    int mL1TileSize = matmulL1TileSize;
-    int nL1TileSize = matmulL1TileSize;
-    int kL1TileSize = matmulL1TileSize;
-    auto lhsShape = getUntiledShape(contractionOp.lhs());
+  bool isMatmul = contractionOp.isRowMajorMatmul();
+  bool isBatchMatmul = contractionOp.isRowMajorBatchMatmul();
+  if (!isMatmul && !isBatchMatmul) return success();
+  unsigned numBatchDims = isBatchMatmul ? 1 : 0;
+
+  const auto &workgroupTileSizeOption =
+      isMatmul ? matmulWorkgroupTileSize : batchMatmulWorkgroupTileSize;
+  const auto &l1TileSizeOption =
+      isMatmul ? matmulL1TileSize : batchMatmulL1TileSize;
+  const auto &vectorSizeOption =
+      isMatmul ? matmulVectorSize : batchMatmulL2TileSize;
+  MatmulTileSizes sizes;
+  if (targetDescription) {
     auto rhsShape = getUntiledShape(contractionOp.rhs());
-    if (!lhsShape.empty() && !rhsShape.empty()) {
-      // Find largest tile size that is a multiple of the vector size.
-      auto getTileSize = [](int dim, int maxSize) {
-        if (dim == ShapedType::kDynamicSize) return maxSize;
-        if (dim < matmulVectorSize) return matmulVectorSize.getValue();
-        for (int i = std::min(maxSize, dim); i > 0; --i) {
-          if (dim % i == 0 && i % matmulVectorSize == 0) {
-            return i;
-          }
-        }
-        return maxSize;
-      };
-      mWorkgroupSize = getTileSize(lhsShape[0], mWorkgroupSize);
-      nWorkgroupSize = getTileSize(rhsShape[1], nWorkgroupSize);
-      mL1TileSize = getTileSize(mWorkgroupSize, mL1TileSize);
-      nL1TileSize = getTileSize(nWorkgroupSize, nL1TileSize);
-      kL1TileSize = getTileSize(rhsShape[0], kL1TileSize);
-    }
-    TileSizesListType tileSizes = {
-        {mWorkgroupSize, nWorkgroupSize},
-        {mL1TileSize, nL1TileSize, kL1TileSize},
-        {matmulVectorSize, matmulVectorSize, matmulVectorSize}};
-    SmallVector<int64_t, 4> nativeVectorSize = {
-        matmulVectorSize, matmulVectorSize, matmulVectorSize};
-    IREE::HAL::LoweringConfig config = buildConfigAttr(
-        tileSizes, nativeVectorSize, contractionOp->getContext());
-    setLoweringConfig(contractionOp, config);
-    return setTranslationInfo(
-        entryPointFn, IREE::HAL::DispatchLoweringPassPipeline::CPUVectorization,
-        getWorkloadPerWorkgroup(tileSizes[0]));
-  }
-  if (contractionOp.isRowMajorBatchMatmul()) {
-    // TODO(ataei, ravishankarm): This should just use the configuration for
-    // matmul above. setting the tile size to 1 for all the batch dimensions.
-    TileSizesListType tileSizes = {
-        {1, batchMatmulWorkgroupTileSize, batchMatmulWorkgroupTileSize},
-        {1, batchMatmulL1TileSize, batchMatmulL1TileSize,
-         batchMatmulL1TileSize},
-        {1, batchMatmulL2TileSize, batchMatmulL2TileSize,
-         batchMatmulL2TileSize}};
-    SmallVector<int64_t, 4> nativeVectorSize = {
-        1, batchMatmulL2TileSize, batchMatmulL2TileSize, batchMatmulL2TileSize};
-    IREE::HAL::LoweringConfig config = buildConfigAttr(
-        tileSizes, nativeVectorSize, contractionOp->getContext());
-    setLoweringConfig(contractionOp, config);
-    return setTranslationInfo(
-        entryPointFn, IREE::HAL::DispatchLoweringPassPipeline::CPUVectorization,
-        getWorkloadPerWorkgroup(tileSizes[0]));
+    int64_t kSize = rhsShape.empty() ? ShapedType::kDynamicSize
+                                     : rhsShape[numBatchDims];
+    sizes = getTargetMatmulTileSizes(
+        *targetDescription,
+        getMaxElementSize(cast<linalg::LinalgOp>(contractionOp.getOperation())),
+        kSize);
+  } else {
+    sizes.mWorkgroup = sizes.nWorkgroup = workgroupTileSizeOption;
+    sizes.mL1 = sizes.nL1 = sizes.kL1 = l1TileSizeOption;
+    sizes.mVector = sizes.nVector = sizes.kVector = vectorSizeOption;
   }
-  return success();
+
+  // Tile sizes set on the command line override those of the target.
+  sizes.mWorkgroup = getOptionOr(workgroupTileSizeOption, sizes.mWorkgroup);
+  sizes.nWorkgroup = getOptionOr(workgroupTileSizeOption, sizes.nWorkgroup);
+  sizes.mL1 = getOptionOr(l1TileSizeOption, sizes.mL1);
+  sizes.nL1 = getOptionOr(l1TileSizeOption, sizes.nL1);
+  sizes.kL1 = getOptionOr(l1TileSizeOption, sizes.kL1);
+  sizes.mVector = getOptionOr(vectorSizeOption, sizes.mVector);
+  sizes.nVector = getOptionOr(vectorSizeOption, sizes.nVector);
+  sizes.kVector = getOptionOr(vectorSizeOption, sizes.kVector);
+
+  return setMatmulRootConfig(entryPointFn, contractionOp, sizes, numBatchDims);
+}
+
+/// Returns true if `genericOp` is the matmul on packed operands created by
+/// ConvertMatmulToMmt4d, i.e. with loops (M1, N1, K1, M0, N0, K0) reading a
+/// [M1, K1, M0, K0] LHS and a [N1, K1, N0, K0] RHS and accumulating into a
+/// [M1, N1, M0, N0] result.
+static bool isMmt4dOp(linalg::GenericOp genericOp) {
+  if (genericOp.getNumInputs() != 2 || genericOp.getNumOutputs() != 1 ||
+      genericOp.getNumLoops() != 6 ||
+      !linalg::isaContractionOpInterface(genericOp)) {
+    return false;
+  }
+  StringRef par = getParallelIteratorTypeName();
+  StringRef red = getReductionIteratorTypeName();
+  if (!llvm::equal(genericOp.iterator_types().getAsValueRange<StringAttr>(),
+                   ArrayRef<StringRef>{par, par, red, par, par, red})) {
+    return false;
+  }
+  MLIRContext *context = genericOp.getContext();
+  auto d = [&](unsigned i) { return getAffineDimExpr(i, context); };
+  SmallVector<AffineMap, 3> mmt4dMaps = {
+      AffineMap::get(6, 0, {d(0), d(2), d(3), d(5)}, context),
+      AffineMap::get(6, 0, {d(1), d(2), d(4), d(5)}, context),
+      AffineMap::get(6, 0, {d(0), d(1), d(3), d(4)}, context)};
+  return llvm::equal(genericOp.getIndexingMaps(), mmt4dMaps);
+}
+
+/// Sets the lowering configuration for dispatch region with root op being a
+/// matmul on packed operands. The outer M1, N1, and K1 loops are tiled with
+/// the matmul tile sizes scaled down by the block sizes and the vector level
+/// covers exactly one M0 x N0 x K0 block, which is contiguous in memory.
+static LogicalResult setMmt4dRootConfig(
+    FuncOp entryPointFn, linalg::GenericOp genericOp,
+    const Optional<CPUTargetDescription> &targetDescription) {
+  if (hasLoweringConfig(genericOp)) return success();
+  auto lhsShape = getUntiledShape(genericOp.getInputOperand(0)->get());
+  auto rhsShape = getUntiledShape(genericOp.getInputOperand(1)->get());
+  if (lhsShape.size() != 4 || rhsShape.size() != 4) return success();
+  int64_t m1 = lhsShape[0], k1 = lhsShape[1];
+  int64_t m0 = lhsShape[2], k0 = lhsShape[3];
+  int64_t n1 = rhsShape[0], n0 = rhsShape[2];
+  if (llvm::any_of(ArrayRef<int64_t>{m0, n0, k0}, [](int64_t size) {
+        return size == ShapedType::kDynamicSize;
+      })) {
+    return success();
+  }
+
+  MatmulTileSizes sizes;
+  if (targetDescription) {
+    int64_t kSize = k1 == ShapedType::kDynamicSize ? k1 : k1 * k0;
+    sizes = getTargetMatmulTileSizes(*targetDescription,
+                                     getMaxElementSize(genericOp), kSize);
+  } else {
+    sizes.mWorkgroup = sizes.nWorkgroup = matmulWorkgroupTileSize;
+    sizes.mL1 = sizes.nL1 = sizes.kL1 = matmulL1TileSize;
+  }
+  sizes.mWorkgroup = getOptionOr(matmulWorkgroupTileSize, sizes.mWorkgroup);
+  sizes.nWorkgroup = getOptionOr(matmulWorkgroupTileSize, sizes.nWorkgroup);
+  sizes.mL1 = getOptionOr(matmulL1TileSize, sizes.mL1);
+  sizes.nL1 = getOptionOr(matmulL1TileSize, sizes.nL1);
+  sizes.kL1 = getOptionOr(matmulL1TileSize, sizes.kL1);
+
+  // Converts a tile size of the unpacked matmul into a number of blocks.
+  auto getNumBlocks = [](int64_t tileSize, int64_t blockSize) {
+    return std::max<int64_t>(tileSize / blockSize, 1);
+  };
+  int64_t m1Workgroup =
+      getTileSizeForDim(m1, getNumBlocks(sizes.mWorkgroup, m0), 1);
+  int64_t n1Workgroup =
+      getTileSizeForDim(n1, getNumBlocks(sizes.nWorkgroup, n0), 1);
+  int64_t m1L1 =
+      getTileSizeForDim(m1Workgroup, getNumBlocks(sizes.mL1, m0), 1);
+  int64_t n1L1 =
+      getTileSizeForDim(n1Workgroup, getNumBlocks(sizes.nL1, n0), 1);
+  int64_t k1L1 = getTileSizeForDim(k1, getNumBlocks(sizes.kL1, k0), 1);
+  TileSizesListType tileSizes = {{m1Workgroup, n1Workgroup},
+                                 {m1L1, n1L1, k1L1},
+                                 {1, 1, 1, m0, n0, k0}};
+  SmallVector<int64_t, 4> nativeVectorSize = {1, 1, 1, m0, n0, k0};
+  IREE::HAL::LoweringConfig config =
+      buildConfigAttr(tileSizes, nativeVectorSize, genericOp->getContext());
+  setLoweringConfig(genericOp, config);
+  return setTranslationInfo(
+      entryPointFn, IREE::HAL::DispatchLoweringPassPipeline::CPUVectorization,
+      getWorkloadPerWorkgroup(tileSizes[0]));
 }
 
 /// Legalized the tile sizes for the first-level of tiling
@@ -170,14 +410,50 @@ static SmallVector<int64_t, 4> getTileSizesForWorkgroupDistribution(
   return distributedTileSizes;
 }
 
+/// Returns the workgroup tile size of each distributed loop of a generic op
+/// for `target` such that the tiles of all operands fit in half of the L2
+/// cache.
+static int64_t getTargetGenericOpTileSize(const CPUTargetDescription &target,
+                                          linalg::GenericOp genericOp,
+                                          int64_t numDistributedLoops) {
+  int64_t bytesPerIteration = 0;
+  for (OpOperand *operand : genericOp.getInputAndOutputOperands()) {
+    bytesPerIteration += getElementSize(operand->get());
+  }
+  int64_t minTileSize =
+      getNumVectorLanes(target, getMaxElementSize(genericOp));
+  int64_t tileSize = kMaxGenericOpsWorkgroupTileSize;
+  auto getWorkingSetSize = [&](int64_t size) {
+    int64_t numIterations = 1;
+    for (int64_t i = 0; i < numDistributedLoops; ++i) {
+      numIterations *= size;
+    }
+    return numIterations * bytesPerIteration;
+  };
+  while (tileSize > minTileSize &&
+         getWorkingSetSize(tileSize) > target.l2CacheSize / 2) {
+    tileSize /= 2;
+  }
+  return tileSize;
+}
+
 /// Sets the lowering configuration for dispatch region with root op being a
 /// generic op.
-static LogicalResult setRootConfig(FuncOp entryPointFn,
-                                   linalg::GenericOp genericOp) {
+static LogicalResult setRootConfig(
+    FuncOp entryPointFn, linalg::GenericOp genericOp,
+    const Optional<CPUTargetDescription> &targetDescription) {
   if (hasLoweringConfig(genericOp)) return success();
   int64_t numOuterParallelLoops = getNumOuterParallelLoops(genericOp);
-  SmallVector<int64_t, 4> workgroupTileSizes(numOuterParallelLoops,
-                                             genericOpsWorkgroupTileSize);
+  int64_t tileSize = genericOpsWorkgroupTileSize;
+  if (targetDescription) {
+    int64_t numDistributedLoops = std::min<int64_t>(
+        numOuterParallelLoops, static_cast<int64_t>(kNumMaxParallelDims));
+    tileSize = getOptionOr(
+        genericOpsWorkgroupTileSize,
+        getTargetGenericOpTileSize(*targetDescription, genericOp,
+                                   numDistributedLoops));
+  }
+  SmallVector<int64_t, 4> workgroupTileSizes(numOuterParallelLoops, tileSize);
   workgroupTileSizes = getTileSizesForWorkgroupDistribution(
       numOuterParallelLoops, workgroupTileSizes);
   TileSizesListType tileSizes = {workgroupTileSizes};
@@ -189,17 +465,129 @@ static LogicalResult setRootConfig(FuncOp entryPointFn,
       getWorkloadPerWorkgroup(tileSizes[0]));
 }
 
+/// Sets the lowering configuration for dispatch region with root op being a
+/// convolution. Only the workgroup level is tiled: the output tile along with
+/// the input window and the filter it reads are sized to fit in half of the L2
+/// cache of `target`. Unit strides are assumed and unknown filter sizes are
+/// assumed to be 3x3.
+static LogicalResult setConvRootConfig(FuncOp entryPointFn,
+                                       linalg::LinalgOp convOp,
+                                       const CPUTargetDescription &target,
+                                       bool isDepthwise) {
+  if (hasLoweringConfig(convOp)) return success();
+  auto filterShape = getUntiledShape(convOp.getInputOperand(1)->get());
+  auto outputShape = getUntiledShape(convOp.getOutputOperand(0)->get());
+  auto getStaticSize = [](ArrayRef<int64_t> shape, unsigned dim,
+                          int64_t defaultSize) {
+    if (dim >= shape.size() || shape[dim] == ShapedType::kDynamicSize) {
+      return defaultSize;
+    }
+    return shape[dim];
+  };
+  int64_t elementSize = getMaxElementSize(convOp);
+  int64_t numLanes = getNumVectorLanes(target, elementSize);
+  int64_t filterHeight = getStaticSize(filterShape, 0, 3);
+  int64_t filterWidth = getStaticSize(filterShape, 1, 3);
+  int64_t inputChannels = getStaticSize(filterShape, 2, 8 * numLanes);
+  int64_t outputChannels = getStaticSize(outputShape, 3, 8 * numLanes);
+
+  // Number of elements of the output, input, and filter tiles read and written
+  // by an output tile of `spatialTileSize`^2 x `channelTileSize`.
+  auto getWorkingSetElements = [&](int64_t spatialTileSize,
+                                   int64_t channelTileSize) {
+    int64_t inputTileChannels = isDepthwise ? channelTileSize : inputChannels;
+    int64_t filterElements = filterHeight * filterWidth * inputTileChannels;
+    if (!isDepthwise) filterElements *= channelTileSize;
+    return spatialTileSize * spatialTileSize * channelTileSize +
+           (spatialTileSize + filterHeight - 1) *
+               (spatialTileSize + filterWidth - 1) * inputTileChannels +
+           filterElements;
+  };
+  int64_t l2Elements = target.l2CacheSize / 2 / elementSize;
+  int64_t channelTileSize = std::max<int64_t>(
+      std::min<int64_t>(llvm::PowerOf2Floor(outputChannels), 8 * numLanes),
+      numLanes);
+  while (channelTileSize > numLanes &&
+         getWorkingSetElements(1, channelTileSize) > l2Elements) {
+    channelTileSize /= 2;
+  }
+  int64_t spatialTileSize = 1;
+  while (spatialTileSize < kMaxConvSpatialWorkgroupTileSize &&
+         getWorkingSetElements(spatialTileSize * 2, channelTileSize) <=
+             l2Elements) {
+    spatialTileSize *= 2;
+  }
+
+  // Both convolutions have (N, OH, OW, C) as their outer parallel loops.
+  int64_t numOuterParallelLoops = getNumOuterParallelLoops(convOp);
+  SmallVector<int64_t, 4> workgroupTileSizes = {1, spatialTileSize,
+                                                spatialTileSize,
+                                                channelTileSize};
+  workgroupTileSizes.resize(numOuterParallelLoops, 1);
+  workgroupTileSizes = getTileSizesForWorkgroupDistribution(
+      numOuterParallelLoops, workgroupTileSizes);
+  TileSizesListType tileSizes = {workgroupTileSizes};
+  IREE::HAL::LoweringConfig config =
+      buildConfigAttr(tileSizes, ArrayRef<int64_t>{}, convOp->getContext());
+  setLoweringConfig(convOp, config);
+  return setTranslationInfo(
+      entryPointFn, IREE::HAL::DispatchLoweringPassPipeline::CPUVectorization,
+      getWorkloadPerWorkgroup(tileSizes[0]));
+}
+
+/// Sets the lowering configuration of `linalgOp` to the one recorded for its
+/// signature in `tuningDatabase`, if any.
+static LogicalResult setTunedRootConfig(FuncOp entryPointFn,
+                                        linalg::LinalgOp linalgOp,
+                                        const TuningDatabase &tuningDatabase) {
+  if (tuningDatabase.empty() || hasLoweringConfig(linalgOp)) return success();
+  std::string signature = getDispatchSignature(linalgOp);
+  const TuningDatabaseEntry *entry = tuningDatabase.lookup(signature);
+  if (!entry) return success();
+  unsigned numLoops = linalgOp.getNumLoops();
+  for (auto &levelTileSizes : entry->tileSizes) {
+    if (levelTileSizes.size() > numLoops) {
+      return linalgOp.emitError("tuning database entry for '")
+             << signature << "' has more tile sizes than loops";
+    }
+  }
+  IREE::HAL::LoweringConfig config = buildConfigAttr(
+      entry->tileSizes, entry->nativeVectorSize, linalgOp->getContext());
+  setLoweringConfig(linalgOp, config);
+  return setTranslationInfo(
+      entryPointFn, IREE::HAL::DispatchLoweringPassPipeline::CPUVectorization,
+      getWorkloadPerWorkgroup(entry->tileSizes.front()));
+}
+
 /// Finds the root operation in the given list of linalg operations and sets its
-/// configuration. Returns the root operation.
-static LogicalResult setRootConfig(FuncOp entryPointFn,
-                                   ArrayRef<linalg::LinalgOp> linalgOps) {
-  linalg::LinalgOp rootOp = nullptr;
+/// configuration. `rootOp` is set to the root operation if one is found.
+static LogicalResult setRootConfig(
+    FuncOp entryPointFn, ArrayRef<linalg::LinalgOp> linalgOps,
+    const Optional<CPUTargetDescription> &targetDescription,
+    const TuningDatabase &tuningDatabase, linalg::LinalgOp &rootOp) {
+  rootOp = nullptr;
   for (auto linalgOp : linalgOps) {
     if (!hasMarker(linalgOp, getWorkgroupMarker())) continue;
+    if (!isa<linalg::GenericOp>(linalgOp.getOperation()) &&
+        failed(setTunedRootConfig(entryPointFn, linalgOp, tuningDatabase))) {
+      return failure();
+    }
     auto status =
         TypeSwitch<Operation *, LogicalResult>(linalgOp.getOperation())
-            .Case<linalg::ContractionOpInterface>(
-                [&](auto op) { return setRootConfig(entryPointFn, op); })
+            .Case<linalg::ContractionOpInterface>([&](auto op) {
+              return setRootConfig(entryPointFn, op, targetDescription);
+            })
+            .Case<linalg::ConvInputNHWCFilterHWCFOp>([&](auto op) {
+              // Convolutions are only distributed when tiled for a target.
+              if (!targetDescription) return success();
+              return setConvRootConfig(entryPointFn, op, *targetDescription,
+                                       /*isDepthwise=*/false);
+            })
+            .Case<linalg::DepthwiseConvInputNHWCFilterHWCOp>([&](auto op) {
+              if (!targetDescription) return success();
+              return setConvRootConfig(entryPointFn, op, *targetDescription,
+                                       /*isDepthwise=*/true);
+            })
             .Default([](Operation *) { return success(); });
     if (failed(status)) {
       return status;
@@ -221,7 +609,12 @@ static LogicalResult setRootConfig(FuncOp entryPointFn,
       if (!hasMarker(linalgOp, getWorkgroupMarker())) continue;
       auto genericOp = dyn_cast<linalg::GenericOp>(linalgOp.getOperation());
       if (!genericOp) continue;
-      if (failed(setRootConfig(entryPointFn, genericOp))) {
+      if (failed(setTunedRootConfig(entryPointFn, genericOp,
+                                    tuningDatabase)) ||
+          (isMmt4dOp(genericOp) &&
+           failed(setMmt4dRootConfig(entryPointFn, genericOp,
+                                     targetDescription))) ||
+          failed(setRootConfig(entryPointFn, genericOp, targetDescription))) {
         return failure();
       }
       if (hasLoweringConfig(genericOp)) {
@@ -237,9 +630,113 @@ static LogicalResult setRootConfig(FuncOp entryPointFn,
   return success();
 }
 
-LogicalResult initCPULaunchConfig(ModuleOp moduleOp) {
+/// Returns the number of bytes of the operands of `linalgOp` accessed by a
+/// workgroup with `workgroupTileSizes`, or 0 if unknown. Loops that are not
+/// tiled are accessed in full and operand dimensions indexed by combinations of
+/// loops (such as the input windows of convolutions) are assumed to be
+/// non-decreasing in each loop.
+static int64_t getWorkgroupWorkingSetSize(
+    linalg::LinalgOp linalgOp, ArrayRef<int64_t> workgroupTileSizes) {
+  // Find the trip count of each loop from the operand dimensions it indexes.
+  unsigned numLoops = linalgOp.getNumLoops();
+  SmallVector<int64_t, 4> loopRanges(numLoops, ShapedType::kDynamicSize);
+  for (OpOperand *operand : linalgOp.getInputAndOutputOperands()) {
+    ArrayRef<int64_t> shape = getUntiledShape(operand->get());
+    AffineMap indexingMap = linalgOp.getTiedIndexingMap(operand);
+    if (shape.size() != indexingMap.getNumResults()) return 0;
+    for (auto it : llvm::enumerate(indexingMap.getResults())) {
+      auto dimExpr = it.value().dyn_cast<AffineDimExpr>();
+      if (dimExpr && shape[it.index()] != ShapedType::kDynamicSize) {
+        loopRanges[dimExpr.getPosition()] = shape[it.index()];
+      }
+    }
+  }
+
+  // Bind each loop to its first and last iteration in a workgroup.
+  MLIRContext *context = linalgOp->getContext();
+  SmallVector<AffineExpr, 4> firstIterations, lastIterations;
+  for (unsigned i = 0; i < numLoops; ++i) {
+    int64_t extent = loopRanges[i];
+    int64_t tileSize =
+        i < workgroupTileSizes.size() ? workgroupTileSizes[i] : 0;
+    if (tileSize) {
+      extent = extent == ShapedType::kDynamicSize ? tileSize
+                                                   : std::min(extent, tileSize);
+    }
+    if (extent == ShapedType::kDynamicSize) return 0;
+    firstIterations.push_back(getAffineConstantExpr(0, context));
+    lastIterations.push_back(getAffineConstantExpr(extent - 1, context));
+  }
+
+  int64_t workingSetSize = 0;
+  for (OpOperand *operand : linalgOp.getInputAndOutputOperands()) {
+    AffineMap indexingMap = linalgOp.getTiedIndexingMap(operand);
+    int64_t numElements = 1;
+    for (AffineExpr expr : indexingMap.getResults()) {
+      auto first = expr.replaceDimsAndSymbols(firstIterations, {})
+                       .dyn_cast<AffineConstantExpr>();
+      auto last = expr.replaceDimsAndSymbols(lastIterations, {})
+                      .dyn_cast<AffineConstantExpr>();
+      if (!first || !last) return 0;
+      numElements *= last.getValue() - first.getValue() + 1;
+    }
+    workingSetSize += numElements * getElementSize(operand->get());
+  }
+  return workingSetSize;
+}
+
+/// Sets the number of workgroups a processor executes per reservation for each
+/// entry point in `moduleOp` such that the working sets of the workgroups fit
+/// in the L2 cache of `target`. Neighboring workgroups often share operands
+/// (such as the LHS rows of matmul tiles along N) that are then reused from the
+/// cache, while workgroups with large working sets are handed out one at a
+/// time to balance them across processors. The largest working set of the
+/// tiled operations of an entry point is used and the runtime chooses if any is
+/// unknown.
+static void setTargetWorkgroupsPerReservation(
+    ModuleOp moduleOp, const CPUTargetDescription &target) {
   llvm::StringMap<IREE::HAL::ExecutableEntryPointOp> entryPointOps =
       getAllEntryPoints(moduleOp);
+  for (auto funcOp : moduleOp.getOps<FuncOp>()) {
+    auto entryPointOp = entryPointOps.lookup(funcOp.getName());
+    if (!entryPointOp) continue;
+    int64_t workingSetSize = 0;
+    bool isKnown = true;
+    funcOp.walk([&](linalg::LinalgOp linalgOp) {
+      SmallVector<int64_t, 4> workgroupTileSizes = getTileSizes(
+          linalgOp, static_cast<unsigned>(TilingLevel::WorkGroupTiles));
+      if (workgroupTileSizes.empty()) return;
+      int64_t size = getWorkgroupWorkingSetSize(linalgOp, workgroupTileSizes);
+      if (!size) isKnown = false;
+      workingSetSize = std::max(workingSetSize, size);
+    });
+    int64_t workgroupsPerReservation = 0;
+    if (isKnown && workingSetSize) {
+      workgroupsPerReservation = llvm::PowerOf2Floor(std::max<int64_t>(
+          std::min(target.l2CacheSize / workingSetSize,
+                   kMaxWorkgroupsPerReservation),
+          1));
+    }
+    setWorkgroupsPerReservation(entryPointOp, workgroupsPerReservation);
+  }
+}
+
+LogicalResult initCPULaunchConfig(
+    ModuleOp moduleOp,
+    const Optional<CPUTargetDescription> &targetDescription) {
+  static const TuningDatabase emptyTuningDatabase;
+  const TuningDatabase *tuningDatabase = &emptyTuningDatabase;
+  std::shared_ptr<const TuningDatabase> loadedTuningDatabase;
+  if (!clTuningDatabase.empty()) {
+    loadedTuningDatabase =
+        TuningDatabase::getOrLoad(clTuningDatabase, moduleOp.getLoc());
+    if (!loadedTuningDatabase) return failure();
+    tuningDatabase = loadedTuningDatabase.get();
+  }
+
+  llvm::StringMap<IREE::HAL::ExecutableEntryPointOp> entryPointOps =
+      getAllEntryPoints(moduleOp);
+  SmallVector<std::pair<StringRef, linalg::LinalgOp>> entryPointRootOps;
   for (auto funcOp : moduleOp.getOps<FuncOp>()) {
     auto entryPointOp = entryPointOps.lookup(funcOp.getName());
     if (!entryPointOp) continue;
@@ -248,9 +745,12 @@ LogicalResult initCPULaunchConfig(ModuleOp moduleOp) {
     // If there are no linalg ops, not using Linalg based lowering.
     if (succeeded(getLinalgOps(funcOp, linalgOps, tiledLoops)) &&
         !linalgOps.empty()) {
-      if (failed(setRootConfig(funcOp, linalgOps))) {
+      linalg::LinalgOp rootOp;
+      if (failed(setRootConfig(funcOp, linalgOps, targetDescription,
+                               *tuningDatabase, rootOp))) {
         return failure();
       }
+      if (rootOp) entryPointRootOps.emplace_back(funcOp.getName(), rootOp);
     }
 
     // If the function entry point already doesnt have a lowering info attribute
@@ -263,6 +763,99 @@ LogicalResult initCPULaunchConfig(ModuleOp moduleOp) {
       }
     }
   }
+  if (targetDescription) {
+    setTargetWorkgroupsPerReservation(moduleOp, *targetDescription);
+  }
+
+  if (!clTuningDatabaseDumpDir.empty()) {
+    if (auto executableOp =
+            moduleOp->getParentOfType<IREE::HAL::ExecutableOp>()) {
+      return dumpTuningDatabaseEntries(clTuningDatabaseDumpDir,
+                                       executableOp.sym_name(),
+                                       entryPointRootOps, moduleOp.getLoc());
+    }
+  }
+  return success();
+}
+
+/// Returns the lowering configuration selected for a variant with
+/// `variantConfig` that uses the workgroup-level tile sizes of `baseConfig`.
+/// The tiles of the other levels are clamped to the workgroup tiles and the
+/// baseline configuration is returned if they no longer evenly divide them.
+static IREE::HAL::LoweringConfig getVariantLoweringConfig(
+    IREE::HAL::LoweringConfig baseConfig,
+    IREE::HAL::LoweringConfig variantConfig) {
+  TileSizesListType baseTileSizes = getTileSizes(baseConfig);
+  TileSizesListType tileSizes = getTileSizes(variantConfig);
+  if (baseTileSizes.empty() || tileSizes.empty()) return baseConfig;
+  unsigned workgroupLevel = static_cast<unsigned>(TilingLevel::WorkGroupTiles);
+  tileSizes[workgroupLevel] = baseTileSizes[workgroupLevel];
+  for (unsigned level = workgroupLevel + 1; level < tileSizes.size();
+       ++level) {
+    ArrayRef<int64_t> outerTileSizes = tileSizes[level - 1];
+    for (auto it : llvm::enumerate(tileSizes[level])) {
+      if (it.index() >= outerTileSizes.size()) break;
+      int64_t outerTileSize = outerTileSizes[it.index()];
+      int64_t &tileSize = it.value();
+      if (!outerTileSize || !tileSize) continue;
+      tileSize = std::min(tileSize, outerTileSize);
+      if (outerTileSize % tileSize != 0) return baseConfig;
+    }
+  }
+  return buildConfigAttr(tileSizes, getNativeVectorSize(variantConfig),
+                         variantConfig.getContext());
+}
+
+LogicalResult initCPUVariantLaunchConfig(
+    ModuleOp moduleOp, const CPUTargetDescription &baseTargetDescription,
+    const CPUTargetDescription &targetDescription) {
+  // Select the baseline configuration first to find the workgroup-level tile
+  // sizes the variant has to keep.
+  if (failed(initCPULaunchConfig(moduleOp, baseTargetDescription))) {
+    return failure();
+  }
+  llvm::StringMap<IREE::HAL::ExecutableEntryPointOp> entryPointOps =
+      getAllEntryPoints(moduleOp);
+  llvm::StringMap<IREE::HAL::TranslationInfo> baseTranslationInfos;
+  for (auto &it : entryPointOps) {
+    baseTranslationInfos[it.first()] = getTranslationInfo(it.second);
+    eraseTranslationInfo(it.second);
+  }
+  DenseMap<Operation *, IREE::HAL::LoweringConfig> baseConfigs;
+  moduleOp.walk([&](linalg::LinalgOp linalgOp) {
+    if (IREE::HAL::LoweringConfig config = getLoweringConfig(linalgOp)) {
+      baseConfigs[linalgOp] = config;
+      eraseLoweringConfig(linalgOp);
+    }
+  });
+
+  if (failed(initCPULaunchConfig(moduleOp, targetDescription))) {
+    return failure();
+  }
+
+  // The variant is dispatched with the workgroup count of the baseline so only
+  // the tiling within a workgroup may change.
+  moduleOp.walk([&](linalg::LinalgOp linalgOp) {
+    IREE::HAL::LoweringConfig config = getLoweringConfig(linalgOp);
+    eraseLoweringConfig(linalgOp);
+    IREE::HAL::LoweringConfig baseConfig = baseConfigs.lookup(linalgOp);
+    if (!baseConfig) return;
+    setLoweringConfig(linalgOp,
+                      config ? getVariantLoweringConfig(baseConfig, config)
+                             : baseConfig);
+  });
+  for (auto &it : entryPointOps) {
+    eraseTranslationInfo(it.second);
+    if (IREE::HAL::TranslationInfo translationInfo =
+            baseTranslationInfos.lookup(it.first())) {
+      if (failed(setTranslationInfo(it.second, translationInfo))) {
+        return failure();
+      }
+    }
+  }
+
+  // Workgroups keep the baseline tiles but run on the variant target.
+  setTargetWorkgroupsPerReservation(moduleOp, targetDescription);
   return success();
 }
 
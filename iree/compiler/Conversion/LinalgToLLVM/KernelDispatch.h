@@ -4,6 +4,9 @@
 // See https://llvm.org/LICENSE.txt for license information.
 // SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
 
+#ifndef IREE_COMPILER_CONVERSION_LINALGTOLLVM_KERNELDISPATCH_H_
+#define IREE_COMPILER_CONVERSION_LINALGTOLLVM_KERNELDISPATCH_H_
+
 #include "iree/compiler/Dialect/HAL/IR/LoweringConfig.h"
 #include "mlir/IR/BuiltinOps.h"
 
@@ -20,7 +23,39 @@ enum class TilingLevel : unsigned {
   NumTileLevels = 3
 };
 
-LogicalResult initCPULaunchConfig(ModuleOp moduleOp);
+/// Describes the memory hierarchy and vector unit of a CPU target. Used to
+/// select tile sizes such that the working set of each level of tiling fits in
+/// the corresponding level of the cache hierarchy.
+struct CPUTargetDescription {
+  /// Size in bytes of the L1 data cache of a core.
+  int64_t l1CacheSize = 32 * 1024;
+  /// Size in bytes of the L2 cache available to a core.
+  int64_t l2CacheSize = 256 * 1024;
+  /// Size in bytes of the share of the last-level cache available to a core.
+  int64_t llcSize = 1024 * 1024;
+  /// Width in bytes of a native vector register.
+  int64_t vectorSize = 16;
+  /// Number of architectural vector registers.
+  int64_t numVectorRegisters = 16;
+};
+
+/// Sets the lowering configuration of the root operation of each entry point in
+/// `moduleOp`. Tile sizes are derived from `targetDescription` when provided
+/// and use fixed defaults otherwise.
+LogicalResult initCPULaunchConfig(
+    ModuleOp moduleOp,
+    const Optional<CPUTargetDescription> &targetDescription = llvm::None);
+
+/// Sets the lowering configuration of the root operation of each entry point in
+/// `moduleOp` for a variant of the executable compiled for `targetDescription`.
+/// The workgroup-level tile sizes, and thus the number of workgroups each entry
+/// point is dispatched with, are those selected for `baseTargetDescription` so
+/// that the variant can replace the baseline at runtime.
+LogicalResult initCPUVariantLaunchConfig(
+    ModuleOp moduleOp, const CPUTargetDescription &baseTargetDescription,
+    const CPUTargetDescription &targetDescription);
 
 }  // namespace iree_compiler
 }  // namespace mlir
+
+#endif  // IREE_COMPILER_CONVERSION_LINALGTOLLVM_KERNELDISPATCH_H_
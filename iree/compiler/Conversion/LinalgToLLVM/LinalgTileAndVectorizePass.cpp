@@ -29,7 +29,9 @@ namespace iree_compiler {
 
 namespace {
 // Could just be linalg::TilingPattern with a ContractionOpInterface filter, but
-// that is always templated on an op.
+// that is always templated on an op. Generic ops that are structurally
+// contractions (e.g. the matmul on packed operands created by
+// ConvertMatmulToMmt4d) are tiled as well.
 struct TileWorkgroups : public linalg::LinalgBaseTilingPattern {
   using Base = linalg::LinalgBaseTilingPattern;
   TileWorkgroups(MLIRContext *context, linalg::LinalgTilingOptions options,
@@ -37,8 +39,12 @@ struct TileWorkgroups : public linalg::LinalgBaseTilingPattern {
       : LinalgBaseTilingPattern(context, options, marker) {}
   LogicalResult matchAndRewrite(Operation *op,
                                 PatternRewriter &rewriter) const override {
-    auto contractionOp = dyn_cast<linalg::ContractionOpInterface>(op);
-    if (!contractionOp) return failure();
+    if (!isa<linalg::ContractionOpInterface>(op)) {
+      auto genericOp = dyn_cast<linalg::GenericOp>(op);
+      if (!genericOp || !linalg::isaContractionOpInterface(genericOp)) {
+        return failure();
+      }
+    }
 
     linalg::TiledLinalgOp tiledLinalgOp;
     if (failed(Base::matchAndRewriteBase(op, rewriter, tiledLinalgOp)) ||
@@ -50,6 +56,25 @@ struct TileWorkgroups : public linalg::LinalgBaseTilingPattern {
   }
 };
 
+// Vectorizes generic ops that are structurally contractions (e.g. the matmul on
+// packed operands created by ConvertMatmulToMmt4d). Other generic ops are left
+// to the loop lowering as their vectorization is not tuned for this pipeline.
+struct VectorizeContractionGenericOp
+    : public linalg::LinalgBaseVectorizationPattern {
+  using Base = linalg::LinalgBaseVectorizationPattern;
+  VectorizeContractionGenericOp(MLIRContext *context,
+                                linalg::LinalgTransformationFilter marker)
+      : LinalgBaseVectorizationPattern(context, marker) {}
+  LogicalResult matchAndRewrite(Operation *op,
+                                PatternRewriter &rewriter) const override {
+    auto genericOp = dyn_cast<linalg::GenericOp>(op);
+    if (!genericOp || !linalg::isaContractionOpInterface(genericOp)) {
+      return failure();
+    }
+    return Base::matchAndRewrite(op, rewriter);
+  }
+};
+
 }  // namespace
 
 namespace {
@@ -233,6 +258,9 @@ void TileAndVectorizeWorkgroups::runOnFunction() {
         vectorizationPatterns, linalg::LinalgVectorizationOptions(),
         linalg::LinalgTransformationFilter(
             Identifier::get(getVectorizeMarker(), context)));
+    vectorizationPatterns.insert<VectorizeContractionGenericOp>(
+        context, linalg::LinalgTransformationFilter(
+                     Identifier::get(getVectorizeMarker(), context)));
     if (failed(applyPatternsAndFoldGreedily(
             funcOp, std::move(vectorizationPatterns)))) {
       return signalPassFailure();
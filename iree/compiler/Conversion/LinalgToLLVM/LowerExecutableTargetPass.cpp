@@ -33,9 +33,17 @@ class LowerExecutableTargetPass
                     LLVM::LLVMDialect, vector::VectorDialect>();
   }
 
-  LowerExecutableTargetPass(bool vectorize = true)
-      : lowerToVectors(vectorize) {}
-  LowerExecutableTargetPass(const LowerExecutableTargetPass &pass) {}
+  LowerExecutableTargetPass(
+      bool vectorize = true,
+      Optional<CPUTargetDescription> targetDescription = llvm::None,
+      Optional<CPUTargetDescription> baseTargetDescription = llvm::None)
+      : lowerToVectors(vectorize),
+        targetDescription(targetDescription),
+        baseTargetDescription(baseTargetDescription) {}
+  LowerExecutableTargetPass(const LowerExecutableTargetPass &pass)
+      : lowerToVectors(pass.lowerToVectors),
+        targetDescription(pass.targetDescription),
+        baseTargetDescription(pass.baseTargetDescription) {}
 
   void runOnOperation() override;
 
@@ -63,15 +71,67 @@ class LowerExecutableTargetPass
           "Specifies the workload per workgroup to use in x, y, z order. Is "
           "expected for use only with use-lowering-pipeline option")};
 
+  // Overrides of the target description used to select tile sizes. Mostly
+  // useful for lit-testing the configuration selected for different targets.
+  Option<int> l1CacheSize{
+      *this, "l1-cache-size",
+      llvm::cl::desc("Size in bytes of the L1 data cache of the target"),
+      llvm::cl::init(0)};
+  Option<int> l2CacheSize{
+      *this, "l2-cache-size",
+      llvm::cl::desc("Size in bytes of the L2 cache of the target"),
+      llvm::cl::init(0)};
+  Option<int> llcSize{
+      *this, "llc-size",
+      llvm::cl::desc("Size in bytes of the last-level cache share of a core"),
+      llvm::cl::init(0)};
+  Option<int> vectorSize{
+      *this, "vector-size",
+      llvm::cl::desc("Width in bytes of a vector register of the target"),
+      llvm::cl::init(0)};
+  Option<int> numVectorRegisters{
+      *this, "num-vector-registers",
+      llvm::cl::desc("Number of vector registers of the target"),
+      llvm::cl::init(0)};
+
+  /// Returns the target description with the overrides from the pass options
+  /// applied, if any.
+  Optional<CPUTargetDescription> getTargetDescription();
+
   /// TODO(ravishankarm): Option to not generate any `vector.` instructions. The
   /// VMVX backend uses the same lowering as the CPU pass but there is no
   /// lowering of these `vector.` operations to scalar code. So as a WAR do the
   /// same tiling scheme but avoid generating vector instructions. When VMVX can
   /// handle vector instructions, drop this options.
   bool lowerToVectors;
+
+  /// Description of the target used to select tile sizes, if known.
+  Optional<CPUTargetDescription> targetDescription;
+
+  /// Description of the baseline target when lowering a variant of the
+  /// executable. The workgroup tile sizes selected for it are kept so that the
+  /// variant uses the same number of workgroups as the baseline.
+  Optional<CPUTargetDescription> baseTargetDescription;
 };
 }  // namespace
 
+Optional<CPUTargetDescription>
+LowerExecutableTargetPass::getTargetDescription() {
+  Optional<CPUTargetDescription> description = targetDescription;
+  if (l1CacheSize || l2CacheSize || llcSize || vectorSize ||
+      numVectorRegisters) {
+    if (!description) description = CPUTargetDescription();
+    if (l1CacheSize) description->l1CacheSize = l1CacheSize;
+    if (l2CacheSize) description->l2CacheSize = l2CacheSize;
+    if (llcSize) description->llcSize = llcSize;
+    if (vectorSize) description->vectorSize = vectorSize;
+    if (numVectorRegisters) {
+      description->numVectorRegisters = numVectorRegisters;
+    }
+  }
+  return description;
+}
+
 /// The pipeline parser doesnt like strings that have `'` or `"` in them. But it
 /// is needed for demarcating the option value. So just drop them before sending
 /// it one.
@@ -108,7 +168,13 @@ void LowerExecutableTargetPass::runOnOperation() {
     }
   } else {
     // Use default heuristics.
-    if (failed(initCPULaunchConfig(moduleOp))) {
+    Optional<CPUTargetDescription> description = getTargetDescription();
+    if (baseTargetDescription && description) {
+      if (failed(initCPUVariantLaunchConfig(moduleOp, *baseTargetDescription,
+                                            *description))) {
+        return signalPassFailure();
+      }
+    } else if (failed(initCPULaunchConfig(moduleOp, description))) {
       return signalPassFailure();
     }
 
@@ -161,8 +227,11 @@ void LowerExecutableTargetPass::runOnOperation() {
 }
 
 std::unique_ptr<OperationPass<IREE::HAL::ExecutableTargetOp>>
-createLowerExecutableTargetPass(bool lowerToVectors) {
-  return std::make_unique<LowerExecutableTargetPass>(lowerToVectors);
+createLowerExecutableTargetPass(
+    bool lowerToVectors, Optional<CPUTargetDescription> targetDescription,
+    Optional<CPUTargetDescription> baseTargetDescription) {
+  return std::make_unique<LowerExecutableTargetPass>(
+      lowerToVectors, targetDescription, baseTargetDescription);
 }
 
 static PassRegistration<LowerExecutableTargetPass> pass(
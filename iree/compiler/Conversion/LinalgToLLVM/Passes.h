@@ -7,6 +7,7 @@
 #ifndef IREE_COMPILER_CONVERSION_LINALGTOLLVM_PASSES_H_
 #define IREE_COMPILER_CONVERSION_LINALGTOLLVM_PASSES_H_
 
+#include "iree/compiler/Conversion/LinalgToLLVM/KernelDispatch.h"
 #include "iree/compiler/Dialect/HAL/IR/HALOps.h"
 #include "iree/compiler/Dialect/HAL/IR/LoweringConfig.h"
 #include "mlir/Pass/Pass.h"
@@ -60,8 +61,14 @@ void addCPUVectorizationPassPipeline(OpPassManager &passManager,
 /// Pass to lower the module an hal.executable.target operation to external
 /// dialect. Currently this pass lowers to LLVM dialect, but could be
 /// generalized to lower to any "final" dialect like SPIR-V/NVVM, etc.
+/// Tile sizes are selected for `targetDescription` when provided. When
+/// `baseTargetDescription` is also provided the executable is lowered as a
+/// variant that keeps the workgroup tile sizes selected for it.
 std::unique_ptr<OperationPass<IREE::HAL::ExecutableTargetOp>>
-createLowerExecutableTargetPass(bool lowerToVectors = true);
+createLowerExecutableTargetPass(
+    bool lowerToVectors = true,
+    Optional<CPUTargetDescription> targetDescription = llvm::None,
+    Optional<CPUTargetDescription> baseTargetDescription = llvm::None);
 
 //===----------------------------------------------------------------------===//
 // Pass Pipelines for lowering to LLVM dialect.
@@ -0,0 +1,247 @@
+// Copyright 2021 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/compiler/Conversion/LinalgToLLVM/TuningDatabase.h"
+
+#include "iree/compiler/Conversion/CodegenUtils/FunctionUtils.h"
+#include "iree/compiler/Dialect/Flow/IR/FlowTypes.h"
+#include "llvm/ADT/SmallString.h"
+#include "llvm/ADT/TypeSwitch.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/FormatVariadic.h"
+#include "llvm/Support/JSON.h"
+#include "llvm/Support/ManagedStatic.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/Mutex.h"
+#include "llvm/Support/Path.h"
+#include "llvm/Support/ToolOutputFile.h"
+#include "mlir/IR/BuiltinTypes.h"
+#include "mlir/Support/FileUtilities.h"
+
+namespace mlir {
+namespace iree_compiler {
+
+/// Prints the untiled shape and element type of `value` as `4x?x8xf32`.
+static void printUntiledType(Value value, llvm::raw_ostream &os) {
+  Type type = getUntiledType(value);
+  auto printShaped = [&](ArrayRef<int64_t> shape, Type elementType) {
+    for (int64_t dim : shape) {
+      if (dim == ShapedType::kDynamicSize) {
+        os << "?x";
+      } else {
+        os << dim << "x";
+      }
+    }
+    elementType.print(os);
+  };
+  TypeSwitch<Type>(type)
+      .Case<ShapedType, IREE::Flow::DispatchTensorType>([&](auto shapedType) {
+        printShaped(shapedType.getShape(), shapedType.getElementType());
+      })
+      .Default([&](Type type) { type.print(os); });
+}
+
+std::string getDispatchSignature(linalg::LinalgOp rootOp) {
+  std::string signature;
+  llvm::raw_string_ostream os(signature);
+  os << rootOp->getName().getStringRef();
+  if (isa<linalg::GenericOp>(rootOp.getOperation())) {
+    os << "<";
+    llvm::interleave(
+        rootOp.iterator_types().getAsValueRange<StringAttr>(), os,
+        [&](StringRef iteratorType) { os << iteratorType; }, ",");
+    os << ">";
+  }
+  auto printOperands = [&](ArrayRef<OpOperand *> operands) {
+    os << "(";
+    llvm::interleave(
+        operands, os,
+        [&](OpOperand *operand) { printUntiledType(operand->get(), os); },
+        ",");
+    os << ")";
+  };
+  printOperands(rootOp.getInputOperands());
+  os << "->";
+  printOperands(rootOp.getOutputOperands());
+  return os.str();
+}
+
+/// Parses a JSON array of integers into `values`.
+static bool parseIntegerArray(const llvm::json::Value *value,
+                              SmallVectorImpl<int64_t> &values) {
+  const llvm::json::Array *array = value ? value->getAsArray() : nullptr;
+  if (!array) return false;
+  for (const llvm::json::Value &element : *array) {
+    auto integer = element.getAsInteger();
+    if (!integer || *integer < 0) return false;
+    values.push_back(*integer);
+  }
+  return true;
+}
+
+LogicalResult TuningDatabase::load(StringRef path, Location loc) {
+  std::string errorMessage;
+  std::unique_ptr<llvm::MemoryBuffer> file =
+      openInputFile(path, &errorMessage);
+  if (!file) {
+    return emitError(loc) << "failed to open tuning database '" << path
+                          << "': " << errorMessage;
+  }
+  auto root = llvm::json::parse(file->getBuffer());
+  if (!root) {
+    return emitError(loc) << "failed to parse tuning database '" << path
+                          << "': " << llvm::toString(root.takeError());
+  }
+  const llvm::json::Object *rootObject = root->getAsObject();
+  if (!rootObject) {
+    return emitError(loc) << "tuning database '" << path
+                          << "' is not a JSON object";
+  }
+  auto version = rootObject->getInteger("version");
+  if (!version || *version != kTuningDatabaseVersion) {
+    return emitError(loc) << "tuning database '" << path
+                          << "' has unsupported version; expected "
+                          << kTuningDatabaseVersion;
+  }
+  const llvm::json::Array *entryArray = rootObject->getArray("entries");
+  if (!entryArray) {
+    return emitError(loc) << "tuning database '" << path
+                          << "' has no entries array";
+  }
+  for (auto indexedEntry : llvm::enumerate(*entryArray)) {
+    auto emitEntryError = [&]() {
+      return emitError(loc) << "malformed entry " << indexedEntry.index()
+                            << " in tuning database '" << path << "'";
+    };
+    const llvm::json::Object *entryObject =
+        indexedEntry.value().getAsObject();
+    if (!entryObject) return emitEntryError();
+    auto signature = entryObject->getString("signature");
+    const llvm::json::Array *tileSizesArray =
+        entryObject->getArray("tileSizes");
+    if (!signature || !tileSizesArray || tileSizesArray->empty()) {
+      return emitEntryError();
+    }
+    TuningDatabaseEntry entry;
+    for (const llvm::json::Value &level : *tileSizesArray) {
+      if (!parseIntegerArray(&level, entry.tileSizes.emplace_back())) {
+        return emitEntryError();
+      }
+    }
+    if (const llvm::json::Value *nativeVectorSize =
+            entryObject->get("nativeVectorSize")) {
+      if (!parseIntegerArray(nativeVectorSize, entry.nativeVectorSize)) {
+        return emitEntryError();
+      }
+    }
+    // Later entries override earlier ones so that databases can be merged by
+    // concatenating their entries.
+    entries[*signature] = std::move(entry);
+  }
+  return success();
+}
+
+namespace {
+/// A tuning database along with the file state it was loaded from.
+struct CachedTuningDatabase {
+  llvm::sys::TimePoint<> modificationTime;
+  uint64_t size = 0;
+  std::shared_ptr<const TuningDatabase> database;
+};
+
+/// Tuning databases loaded by path. Executables may be compiled concurrently so
+/// all accesses are guarded by `mutex`.
+struct TuningDatabaseCache {
+  llvm::sys::SmartMutex<true> mutex;
+  llvm::StringMap<CachedTuningDatabase> databases;
+};
+}  // namespace
+
+static llvm::ManagedStatic<TuningDatabaseCache> tuningDatabaseCache;
+
+std::shared_ptr<const TuningDatabase> TuningDatabase::getOrLoad(StringRef path,
+                                                                Location loc) {
+  llvm::sys::fs::file_status fileStatus;
+  if (std::error_code error = llvm::sys::fs::status(path, fileStatus)) {
+    emitError(loc) << "failed to open tuning database '" << path
+                   << "': " << error.message();
+    return nullptr;
+  }
+
+  llvm::sys::SmartScopedLock<true> lock(tuningDatabaseCache->mutex);
+  auto &cached = tuningDatabaseCache->databases[path];
+  if (cached.database &&
+      cached.modificationTime == fileStatus.getLastModificationTime() &&
+      cached.size == fileStatus.getSize()) {
+    return cached.database;
+  }
+
+  // The file is new or was rewritten since it was last loaded. Users of the
+  // previous database keep it alive until they are done with it.
+  auto loaded = std::make_shared<TuningDatabase>();
+  if (failed(loaded->load(path, loc))) {
+    tuningDatabaseCache->databases.erase(path);
+    return nullptr;
+  }
+  cached.modificationTime = fileStatus.getLastModificationTime();
+  cached.size = fileStatus.getSize();
+  cached.database = std::move(loaded);
+  return cached.database;
+}
+
+const TuningDatabaseEntry *TuningDatabase::lookup(StringRef signature) const {
+  auto it = entries.find(signature);
+  return it == entries.end() ? nullptr : &it->second;
+}
+
+LogicalResult dumpTuningDatabaseEntries(
+    StringRef directory, StringRef executableName,
+    ArrayRef<std::pair<StringRef, linalg::LinalgOp>> entryPointRootOps,
+    Location loc) {
+  auto toJSONArray = [](ArrayRef<int64_t> values) {
+    llvm::json::Array array;
+    for (int64_t value : values) array.push_back(value);
+    return array;
+  };
+  llvm::json::Array entryArray;
+  for (auto entryPointRootOp : entryPointRootOps) {
+    linalg::LinalgOp rootOp = entryPointRootOp.second;
+    IREE::HAL::LoweringConfig config = getLoweringConfig(rootOp);
+    if (!config) continue;
+    llvm::json::Array tileSizesArray;
+    for (auto &levelTileSizes : getTileSizes(config)) {
+      tileSizesArray.push_back(toJSONArray(levelTileSizes));
+    }
+    entryArray.push_back(llvm::json::Object{
+        {"signature", getDispatchSignature(rootOp)},
+        {"executable", executableName},
+        {"entryPoint", entryPointRootOp.first},
+        {"tileSizes", std::move(tileSizesArray)},
+        {"nativeVectorSize", toJSONArray(getNativeVectorSize(config))},
+    });
+  }
+  if (entryArray.empty()) return success();
+
+  llvm::SmallString<256> path(directory);
+  llvm::sys::path::append(path, executableName + ".json");
+  std::string errorMessage;
+  std::unique_ptr<llvm::ToolOutputFile> file =
+      openOutputFile(path, &errorMessage);
+  if (!file) {
+    return emitError(loc) << "failed to open tuning database dump '"
+                          << path.str() << "': " << errorMessage;
+  }
+  llvm::json::Value root = llvm::json::Object{
+      {"version", kTuningDatabaseVersion},
+      {"entries", std::move(entryArray)},
+  };
+  file->os() << llvm::formatv("{0:2}", root) << "\n";
+  file->keep();
+  return success();
+}
+
+}  // namespace iree_compiler
+}  // namespace mlir
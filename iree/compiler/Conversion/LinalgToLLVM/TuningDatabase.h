@@ -0,0 +1,88 @@
+// Copyright 2021 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#ifndef IREE_COMPILER_CONVERSION_LINALGTOLLVM_TUNINGDATABASE_H_
+#define IREE_COMPILER_CONVERSION_LINALGTOLLVM_TUNINGDATABASE_H_
+
+#include <memory>
+#include <string>
+
+#include "iree/compiler/Dialect/HAL/IR/LoweringConfig.h"
+#include "llvm/ADT/StringMap.h"
+#include "mlir/Dialect/Linalg/IR/LinalgInterfaces.h"
+#include "mlir/IR/Location.h"
+
+namespace mlir {
+namespace iree_compiler {
+
+/// Version of the tuning database file format.
+static const int64_t kTuningDatabaseVersion = 1;
+
+/// Returns the signature of the root operation of a dispatch used to key
+/// tuning database entries. The signature is composed of the operation name,
+/// the iterator types of generic operations, and the untiled shape and element
+/// type of each operand, e.g.
+///   linalg.matmul(384x512xf32,512x128xf32)->(384x128xf32)
+std::string getDispatchSignature(linalg::LinalgOp rootOp);
+
+/// Lowering configuration of the root operation of a dispatch.
+struct TuningDatabaseEntry {
+  TileSizesListType tileSizes;
+  SmallVector<int64_t, 4> nativeVectorSize;
+};
+
+/// Lowering configurations of dispatches keyed by the signature of their root
+/// operation. Produced offline by benchmarking candidate configurations of each
+/// dispatch of a model on the target (see scripts/autotune_cpu_dispatches.py)
+/// and stored as JSON:
+///   {
+///     "version": 1,
+///     "entries": [
+///       {
+///         "signature": "linalg.matmul(...)->(...)",
+///         "tileSizes": [[64, 64], [32, 32, 32], [4, 4, 4]],
+///         "nativeVectorSize": [4, 4, 4]
+///       }
+///     ]
+///   }
+/// Additional keys of entries (such as the executable the entry was recorded
+/// from or its measured time) are ignored.
+class TuningDatabase {
+ public:
+  /// Returns the database at `path`, loading it on first use. Databases are
+  /// cached by path so that compiling many executables parses each file once
+  /// and are reloaded when the modification time or size of the file changes.
+  /// Emits an error at `loc` and returns nullptr if the file cannot be loaded;
+  /// failed loads are not cached.
+  static std::shared_ptr<const TuningDatabase> getOrLoad(StringRef path,
+                                                         Location loc);
+
+  /// Loads the database at `path`. Emits an error at `loc` and returns failure
+  /// if the file cannot be read or is malformed.
+  LogicalResult load(StringRef path, Location loc);
+
+  /// Returns the entry for `signature` or nullptr if there is none.
+  const TuningDatabaseEntry *lookup(StringRef signature) const;
+
+  bool empty() const { return entries.empty(); }
+
+ private:
+  llvm::StringMap<TuningDatabaseEntry> entries;
+};
+
+/// Writes the lowering configuration selected for the root operation of each
+/// entry point of `executableName` to `<directory>/<executableName>.json` in
+/// the format read by TuningDatabase. Entries also record the executable and
+/// entry point names so that tools can find the dispatch to benchmark.
+LogicalResult dumpTuningDatabaseEntries(
+    StringRef directory, StringRef executableName,
+    ArrayRef<std::pair<StringRef, linalg::LinalgOp>> entryPointRootOps,
+    Location loc);
+
+}  // namespace iree_compiler
+}  // namespace mlir
+
+#endif  // IREE_COMPILER_CONVERSION_LINALGTOLLVM_TUNINGDATABASE_H_
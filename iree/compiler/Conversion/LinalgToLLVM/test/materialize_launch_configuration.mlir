@@ -352,3 +352,49 @@ hal.executable @batch_matmul_tensors attributes {sym_visibility = "private"} {
 //      CHECK:  hal.return %[[D0]], %[[D1]], %[[ARG2]]
 //      CHECK:  linalg.batch_matmul
 // CHECK-SAME:    lowering.config = #[[CONFIG]]
+
+// -----
+
+hal.executable @mmt4d attributes {sym_visibility = "private"} {
+  hal.interface @io {
+    hal.interface.binding @arg0, set=0, binding=0, type="StorageBuffer", access="Read"
+    hal.interface.binding @arg1, set=0, binding=1, type="StorageBuffer", access="Read"
+    hal.interface.binding @ret0, set=0, binding=2, type="StorageBuffer", access="Read|Write"
+  }
+  hal.executable.target @llvm_aot, filter="dylib*" {
+    hal.executable.entry_point @mmt4d attributes {
+      interface = @io,
+      ordinal = 0 : index
+    }
+    module  {
+      func @mmt4d() {
+        %c0 = constant 0 : index
+        %0 = hal.interface.binding.subspan @io::@arg0[%c0] : memref<16x32x4x2xf32>
+        %1 = hal.interface.binding.subspan @io::@arg1[%c0] : memref<8x32x4x2xf32>
+        %2 = hal.interface.binding.subspan @io::@ret0[%c0] : memref<16x8x4x4xf32>
+        linalg.generic {
+          __internal_linalg_transform__ = "workgroup",
+          indexing_maps = [affine_map<(d0, d1, d2, d3, d4, d5) -> (d0, d2, d3, d5)>,
+                           affine_map<(d0, d1, d2, d3, d4, d5) -> (d1, d2, d4, d5)>,
+                           affine_map<(d0, d1, d2, d3, d4, d5) -> (d0, d1, d3, d4)>],
+          iterator_types = ["parallel", "parallel", "reduction", "parallel", "parallel", "reduction"]}
+          ins(%0, %1 : memref<16x32x4x2xf32>, memref<8x32x4x2xf32>) outs(%2 : memref<16x8x4x4xf32>) {
+          ^bb0(%arg0: f32, %arg1: f32, %arg2: f32):  // no predecessors
+            %3 = mulf %arg0, %arg1 : f32
+            %4 = addf %arg2, %3 : f32
+            linalg.yield %4 : f32
+          }
+        return
+      }
+      hal.interface @io attributes {sym_visibility = "private"} {
+        hal.interface.binding @arg0, set=0, binding=0, type="StorageBuffer", access="Read"
+        hal.interface.binding @arg1, set=0, binding=1, type="StorageBuffer", access="Read"
+        hal.interface.binding @ret0, set=0, binding=2, type="StorageBuffer", access="Read|Write"
+      }
+    }
+  }
+}
+//  CHECK-DAG: #[[CONFIG:.+]] = {nativeVectorSize = [1, 1, 1, 4, 4, 2], tileSizes = {{\[}}[16, 8], [8, 8, 16], [1, 1, 1, 4, 4, 2]{{\]}}}
+//      CHECK: hal.executable.entry_point @mmt4d
+//      CHECK: linalg.generic
+// CHECK-SAME:   lowering.config = #[[CONFIG]]
@@ -0,0 +1,270 @@
+// RUN: iree-opt -pass-pipeline="hal.executable(hal.executable.target(iree-lower-executable-target-pass{test-lowering-configuration=true l1-cache-size=32768 l2-cache-size=131072 llc-size=524288 vector-size=16 num-vector-registers=32}))" -cse -canonicalize -split-input-file %s | IreeFileCheck %s -check-prefix=ARM
+// RUN: iree-opt -pass-pipeline="hal.executable(hal.executable.target(iree-lower-executable-target-pass{test-lowering-configuration=true l1-cache-size=49152 l2-cache-size=2097152 llc-size=1966080 vector-size=64 num-vector-registers=32}))" -cse -canonicalize -split-input-file %s | IreeFileCheck %s -check-prefix=X86
+
+hal.executable @matmul_tensors attributes {sym_visibility = "private"} {
+  hal.interface @io {
+    hal.interface.binding @arg0, set=0, binding=0, type="StorageBuffer", access="Read"
+    hal.interface.binding @arg1, set=0, binding=1, type="StorageBuffer", access="Read"
+    hal.interface.binding @ret0, set=0, binding=2, type="StorageBuffer", access="Write|Discard"
+  }
+  hal.executable.target @llvm_aot, filter="dylib*" {
+    hal.executable.entry_point @matmul_tensors attributes {
+      interface = @io,
+      ordinal = 0 : index
+    }
+    module {
+      func @matmul_tensors() {
+        %c0 = constant 0 : index
+        %c1 = constant 1 : index
+        %0 = hal.interface.binding.subspan @io::@arg0[%c0] : memref<?x?xf32>
+        %2 = hal.interface.binding.subspan @io::@arg1[%c0] : memref<?x?xf32>
+        %4 = hal.interface.binding.subspan @io::@arg2[%c0] : memref<?x?xf32>
+        %6 = hal.interface.binding.subspan @io::@ret0[%c0] : memref<?x?xf32>
+        %M = memref.dim %0, %c0 : memref<?x?xf32>
+        %N = memref.dim %2, %c1 : memref<?x?xf32>
+        %K = memref.dim %0, %c1 : memref<?x?xf32>
+        %workgroup_size_x = hal.interface.workgroup.size[0] : index
+        %workgroup_size_y = hal.interface.workgroup.size[1] : index
+        %workgroup_id_x = hal.interface.workgroup.id[0] : index
+        %workgroup_count_x = hal.interface.workgroup.count[0] : index
+        %workgroup_id_y = hal.interface.workgroup.id[1] : index
+        %workgroup_count_y = hal.interface.workgroup.count[1] : index
+        %8 = muli %workgroup_size_y, %workgroup_id_y : index
+        %9 = muli %workgroup_size_y, %workgroup_count_y : index
+        scf.for %arg0 = %8 to %M step %9 {
+          %10 = muli %workgroup_size_x, %workgroup_id_x : index
+          %11 = muli %workgroup_size_x, %workgroup_count_x : index
+          scf.for %arg1 = %10 to %N step %11 {
+            %12 = affine.min affine_map<(d0)[s0, s1] -> (s0, -d0 + s1)>(%arg0)[%workgroup_size_y, %N]
+            %13 = memref.subview %0[%arg0, 0] [%12, %K] [1, 1] : memref<?x?xf32> to memref<?x?xf32, affine_map<(d0, d1)[s0, s1] -> (d0 * s1 + s0 + d1)>>
+            %14 = affine.min affine_map<(d0)[s0, s1] -> (s0, -d0 + s1)>(%arg1)[%workgroup_size_x, %M]
+            %15 = memref.subview %2[0, %arg1] [%K, %14] [1, 1] : memref<?x?xf32> to memref<?x?xf32, affine_map<(d0, d1)[s0, s1] -> (d0 * s1 + s0 + d1)>>
+            %16 = memref.subview %4[%arg0, %arg1] [%12, %14] [1, 1] : memref<?x?xf32> to memref<?x?xf32, affine_map<(d0, d1)[s0, s1] -> (d0 * s1 + s0 + d1)>>
+            %17 = memref.alloc(%12, %14) : memref<?x?xf32>
+            linalg.copy(%16, %17) : memref<?x?xf32, affine_map<(d0, d1)[s0, s1] -> (d0 * s1 + s0 + d1)>>, memref<?x?xf32>
+            linalg.matmul {__internal_linalg_transform__ = "workgroup"} ins(%13, %15 : memref<?x?xf32, affine_map<(d0, d1)[s0, s1] -> (d0 * s1 + s0 + d1)>>, memref<?x?xf32, affine_map<(d0, d1)[s0, s1] -> (d0 * s1 + s0 + d1)>>) outs(%17 : memref<?x?xf32>)
+            %18 = memref.subview %6[%arg0, %arg1] [%12, %14] [1, 1] : memref<?x?xf32> to memref<?x?xf32, affine_map<(d0, d1)[s0, s1] -> (d0 * s1 + s0 + d1)>>
+            linalg.copy(%17, %18) : memref<?x?xf32>, memref<?x?xf32, affine_map<(d0, d1)[s0, s1] -> (d0 * s1 + s0 + d1)>>
+          }
+        }
+        return
+      }
+    }
+  }
+}
+
+//  ARM-DAG: #[[CONFIG:.+]] = {nativeVectorSize = [4, 4, 4], tileSizes = {{\[}}[64, 64], [32, 32, 32], [4, 4, 4]{{\]}}}
+//      ARM: linalg.matmul
+// ARM-SAME:   lowering.config = #[[CONFIG]]
+
+//  X86-DAG: #[[CONFIG:.+]] = {nativeVectorSize = [8, 16, 16], tileSizes = {{\[}}[256, 256], [32, 32, 32], [8, 16, 16]{{\]}}}
+//      X86: linalg.matmul
+// X86-SAME:   lowering.config = #[[CONFIG]]
+
+// -----
+
+hal.executable @add attributes {sym_visibility = "private"} {
+  hal.interface @io {
+    hal.interface.binding @arg0, set=0, binding=0, type="StorageBuffer", access="Read"
+    hal.interface.binding @arg1, set=0, binding=1, type="StorageBuffer", access="Read"
+    hal.interface.binding @ret0, set=0, binding=2, type="StorageBuffer", access="Write|Discard"
+  }
+  hal.executable.target @llvm_aot, filter="dylib*" {
+    hal.executable.entry_point @add attributes {
+      interface = @io, ordinal = 0 : index,
+      signature = (!flow.dispatch.tensor<readonly:?x?xf32>, !flow.dispatch.tensor<readonly:?xf32>,
+        !flow.dispatch.tensor<writeonly:?x?xf32>) -> ()}
+    module  {
+      func @add() {
+        %c0 = constant 0 : index
+        %c1 = constant 1 : index
+        %0 = hal.interface.binding.subspan @io::@arg0[%c0] : memref<?x?xf32>
+        %2 = hal.interface.binding.subspan @io::@arg1[%c0] : memref<?xf32>
+        %6 = hal.interface.binding.subspan @io::@ret0[%c0] : memref<?x?xf32>
+        %M = memref.dim %0, %c0 : memref<?x?xf32>
+        %N = memref.dim %0, %c1 : memref<?x?xf32>
+        %workgroup_size_x = hal.interface.workgroup.size[0] : index
+        %workgroup_size_y = hal.interface.workgroup.size[1] : index
+        %workgroup_id_x = hal.interface.workgroup.id[0] : index
+        %workgroup_count_x = hal.interface.workgroup.count[0] : index
+        %workgroup_id_y = hal.interface.workgroup.id[1] : index
+        %workgroup_count_y = hal.interface.workgroup.count[1] : index
+        %8 = muli %workgroup_size_y, %workgroup_id_y : index
+        %9 = muli %workgroup_size_y, %workgroup_count_y : index
+        scf.for %arg0 = %8 to %M step %9 {
+          %10 = muli %workgroup_size_x, %workgroup_id_x : index
+          %11 = muli %workgroup_size_x, %workgroup_count_x : index
+          scf.for %arg1 = %10 to %N step %11 {
+            %12 = affine.min affine_map<(d0)[s0, s1] -> (s0, -d0 + s1)>(%arg0)[%workgroup_size_y, %M]
+            %13 = affine.min affine_map<(d0)[s0, s1] -> (s0, -d0 + s1)>(%arg1)[%workgroup_size_x, %N]
+            %14 = memref.subview %0[%arg0, %arg1] [%12, %13] [1, 1] : memref<?x?xf32> to memref<?x?xf32, affine_map<(d0, d1)[s0, s1] -> (d0 * s1 + s0 + d1)>>
+            %15 = memref.subview %2[%arg1] [%13] [1] : memref<?xf32> to memref<?xf32, affine_map<(d0)[s0] -> (d0 + s0)>>
+            %16 = memref.subview %6[%arg0, %arg1] [%12, %13] [1, 1] : memref<?x?xf32> to memref<?x?xf32, affine_map<(d0, d1)[s0, s1] -> (d0 * s1 + s0 + d1)>>
+            linalg.generic {
+              __internal_linalg_transform__ = "workgroup",
+              indexing_maps = [affine_map<(d0, d1) -> (d0, d1)>,
+                               affine_map<(d0, d1) -> (d1)>,
+                               affine_map<(d0, d1) -> (d0, d1)>],
+              iterator_types = ["parallel", "parallel"]}
+              ins(%14, %15 : memref<?x?xf32, affine_map<(d0, d1)[s0, s1] -> (d0 * s1 + s0 + d1)>>, memref<?xf32, affine_map<(d0)[s0] -> (d0 + s0)>>) outs(%16 : memref<?x?xf32, affine_map<(d0, d1)[s0, s1] -> (d0 * s1 + s0 + d1)>>) {
+              ^bb0(%arg2: f32, %arg3: f32, %arg4: f32):  // no predecessors
+                %3 = addf %arg2, %arg3 : f32
+                linalg.yield %3 : f32
+              }
+          }
+        }
+        return
+      }
+      hal.interface @io attributes {sym_visibility = "private"} {
+        hal.interface.binding @arg0, set=0, binding=0, type="StorageBuffer", access="Read"
+        hal.interface.binding @arg1, set=0, binding=1, type="StorageBuffer", access="Read"
+        hal.interface.binding @ret0, set=0, binding=2, type="StorageBuffer", access="Write|Discard"
+      }
+    }
+  }
+}
+
+//  ARM-DAG: #[[CONFIG:.+]] = {tileSizes = {{\[}}[64, 64]{{\]}}}
+//      ARM: linalg.generic
+// ARM-SAME:   lowering.config = #[[CONFIG]]
+
+//  X86-DAG: #[[CONFIG:.+]] = {tileSizes = {{\[}}[256, 256]{{\]}}}
+//      X86: linalg.generic
+// X86-SAME:   lowering.config = #[[CONFIG]]
+
+// -----
+
+hal.executable @conv attributes {sym_visibility = "private"} {
+  hal.interface @io {
+    hal.interface.binding @arg0, set=0, binding=0, type="StorageBuffer", access="Read"
+    hal.interface.binding @arg1, set=0, binding=1, type="StorageBuffer", access="Read"
+    hal.interface.binding @ret0, set=0, binding=2, type="StorageBuffer", access="Write|Discard"
+  }
+  hal.executable.target @llvm_aot, filter="dylib*" {
+    hal.executable.entry_point @conv attributes {
+      interface = @io,
+      ordinal = 0 : index
+    }
+    module  {
+      func @conv() {
+        %cst = constant 0.000000e+00 : f32
+        %c32 = constant 32 : index
+        %c112 = constant 112 : index
+        %c0 = constant 0 : index
+        %0 = hal.interface.binding.subspan @io::@arg0[%c0] : memref<1x225x225x16xf32>
+        %1 = hal.interface.binding.subspan @io::@arg1[%c0] : memref<3x3x16x32xf32>
+        %2 = hal.interface.binding.subspan @io::@ret0[%c0] : memref<1x112x112x32xf32>
+        %workgroup_size_x = hal.interface.workgroup.size[0] : index
+        %workgroup_size_y = hal.interface.workgroup.size[1] : index
+        %workgroup_size_z = hal.interface.workgroup.size[2] : index
+        %workgroup_id_x = hal.interface.workgroup.id[0] : index
+        %workgroup_count_x = hal.interface.workgroup.count[0] : index
+        %workgroup_id_y = hal.interface.workgroup.id[1] : index
+        %workgroup_count_y = hal.interface.workgroup.count[1] : index
+        %workgroup_id_z = hal.interface.workgroup.id[2] : index
+        %workgroup_count_z = hal.interface.workgroup.count[2] : index
+        %3 = affine.apply affine_map<()[s0, s1] -> (s0 * s1)>()[%workgroup_id_z, %workgroup_size_z]
+        %4 = affine.apply affine_map<()[s0, s1] -> (s0 * s1)>()[%workgroup_count_z, %workgroup_size_z]
+        scf.for %arg0 = %3 to %c112 step %4 {
+          %5 = affine.apply affine_map<()[s0, s1] -> (s0 * s1)>()[%workgroup_id_y, %workgroup_size_y]
+          %6 = affine.apply affine_map<()[s0, s1] -> (s0 * s1)>()[%workgroup_count_y, %workgroup_size_y]
+          scf.for %arg1 = %5 to %c112 step %6 {
+            %7 = affine.apply affine_map<()[s0, s1] -> (s0 * s1)>()[%workgroup_id_x, %workgroup_size_x]
+            %8 = affine.apply affine_map<()[s0, s1] -> (s0 * s1)>()[%workgroup_count_x, %workgroup_size_x]
+            scf.for %arg2 = %7 to %c32 step %8 {
+              %9 = affine.apply affine_map<(d0) -> (d0 * 2)>(%arg0)
+              %10 = affine.min affine_map<(d0)[s0] -> (s0 * 2 + 1, d0 * -2 + 225)>(%arg0)[%workgroup_size_z]
+              %11 = affine.apply affine_map<(d0) -> (d0 * 2)>(%arg1)
+              %12 = affine.min affine_map<(d0)[s0] -> (s0 * 2 + 1, d0 * -2 + 225)>(%arg1)[%workgroup_size_y]
+              %13 = memref.subview %0[0, %9, %11, 0] [1, %10, %12, 16] [1, 1, 1, 1] : memref<1x225x225x16xf32> to memref<1x?x?x16xf32, affine_map<(d0, d1, d2, d3)[s0] -> (d0 * 810000 + s0 + d1 * 3600 + d2 * 16 + d3)>>
+              %14 = affine.min affine_map<(d0)[s0] -> (s0, -d0 + 32)>(%arg2)[%workgroup_size_x]
+              %15 = memref.subview %1[0, 0, 0, %arg2] [3, 3, 16, %14] [1, 1, 1, 1] : memref<3x3x16x32xf32> to memref<3x3x16x?xf32, affine_map<(d0, d1, d2, d3)[s0] -> (d0 * 1536 + s0 + d1 * 512 + d2 * 32 + d3)>>
+              %16 = affine.min affine_map<(d0)[s0] -> (s0, -d0 + 112)>(%arg0)[%workgroup_size_z]
+              %17 = affine.min affine_map<(d0)[s0] -> (s0, -d0 + 112)>(%arg1)[%workgroup_size_y]
+              %18 = memref.subview %2[0, %arg0, %arg1, %arg2] [1, %16, %17, %14] [1, 1, 1, 1] : memref<1x112x112x32xf32> to memref<1x?x?x?xf32, affine_map<(d0, d1, d2, d3)[s0] -> (d0 * 401408 + s0 + d1 * 3584 + d2 * 32 + d3)>>
+              linalg.fill(%18, %cst) {__internal_linalg_transform__ = "workgroup"} : memref<1x?x?x?xf32, affine_map<(d0, d1, d2, d3)[s0] -> (d0 * 401408 + s0 + d1 * 3584 + d2 * 32 + d3)>>, f32
+              linalg.conv_2d_input_nhwc_filter_hwcf {__internal_linalg_transform__ = "workgroup", dilations = dense<1> : tensor<2xi64>, strides = dense<2> : tensor<2xi64>} ins(%13, %15 : memref<1x?x?x16xf32, affine_map<(d0, d1, d2, d3)[s0] -> (d0 * 810000 + s0 + d1 * 3600 + d2 * 16 + d3)>>, memref<3x3x16x?xf32, affine_map<(d0, d1, d2, d3)[s0] -> (d0 * 1536 + s0 + d1 * 512 + d2 * 32 + d3)>>) outs(%18 : memref<1x?x?x?xf32, affine_map<(d0, d1, d2, d3)[s0] -> (d0 * 401408 + s0 + d1 * 3584 + d2 * 32 + d3)>>)
+            }
+          }
+        }
+        return
+      }
+      hal.interface @io attributes {sym_visibility = "private"} {
+        hal.interface.binding @arg0, set=0, binding=0, type="StorageBuffer", access="Read"
+        hal.interface.binding @arg1, set=0, binding=1, type="StorageBuffer", access="Read"
+        hal.interface.binding @ret0, set=0, binding=2, type="StorageBuffer", access="Write|Discard"
+      }
+    }
+  }
+}
+
+// Each workgroup reads a 17x17x16 (ARM) or 129x129x16 (X86) input window and
+// the whole filter and writes an 8x8x32 or 64x64x32 output tile. The working
+// sets of two workgroups fit in the L2 cache of ARM and of one in that of X86.
+
+//  ARM-DAG: #[[CONFIG:.+]] = {tileSizes = {{\[}}[0, 8, 8, 32]{{\]}}}
+//      ARM: hal.executable.entry_point @conv
+// ARM-SAME:   workgroups_per_reservation = 2 : i64
+//      ARM: linalg.conv_2d_input_nhwc_filter_hwcf
+// ARM-SAME:   lowering.config = #[[CONFIG]]
+
+//  X86-DAG: #[[CONFIG:.+]] = {tileSizes = {{\[}}[0, 64, 64, 32]{{\]}}}
+//      X86: hal.executable.entry_point @conv
+// X86-SAME:   workgroups_per_reservation = 1 : i64
+//      X86: linalg.conv_2d_input_nhwc_filter_hwcf
+// X86-SAME:   lowering.config = #[[CONFIG]]
+
+// -----
+
+hal.executable @matmul_empty_reduction attributes {sym_visibility = "private"} {
+  hal.interface @io {
+    hal.interface.binding @arg0, set=0, binding=0, type="StorageBuffer", access="Read"
+    hal.interface.binding @arg1, set=0, binding=1, type="StorageBuffer", access="Read"
+    hal.interface.binding @ret0, set=0, binding=2, type="StorageBuffer", access="Write|Discard"
+  }
+  hal.executable.target @llvm_aot, filter="dylib*" {
+    hal.executable.entry_point @matmul_empty_reduction attributes {
+      interface = @io,
+      ordinal = 0 : index
+    }
+    module {
+      func @matmul_empty_reduction() {
+        %c0 = constant 0 : index
+        %c64 = constant 64 : index
+        %0 = hal.interface.binding.subspan @io::@arg0[%c0] : memref<64x0xf32>
+        %2 = hal.interface.binding.subspan @io::@arg1[%c0] : memref<0x64xf32>
+        %6 = hal.interface.binding.subspan @io::@ret0[%c0] : memref<64x64xf32>
+        %workgroup_size_x = hal.interface.workgroup.size[0] : index
+        %workgroup_size_y = hal.interface.workgroup.size[1] : index
+        %workgroup_id_x = hal.interface.workgroup.id[0] : index
+        %workgroup_count_x = hal.interface.workgroup.count[0] : index
+        %workgroup_id_y = hal.interface.workgroup.id[1] : index
+        %workgroup_count_y = hal.interface.workgroup.count[1] : index
+        %8 = muli %workgroup_size_y, %workgroup_id_y : index
+        %9 = muli %workgroup_size_y, %workgroup_count_y : index
+        scf.for %arg0 = %8 to %c64 step %9 {
+          %10 = muli %workgroup_size_x, %workgroup_id_x : index
+          %11 = muli %workgroup_size_x, %workgroup_count_x : index
+          scf.for %arg1 = %10 to %c64 step %11 {
+            %12 = affine.min affine_map<(d0)[s0] -> (s0, -d0 + 64)>(%arg0)[%workgroup_size_y]
+            %13 = memref.subview %0[%arg0, 0] [%12, 0] [1, 1] : memref<64x0xf32> to memref<?x0xf32, affine_map<(d0, d1)[s0] -> (d1 + s0)>>
+            %14 = affine.min affine_map<(d0)[s0] -> (s0, -d0 + 64)>(%arg1)[%workgroup_size_x]
+            %15 = memref.subview %2[0, %arg1] [0, %14] [1, 1] : memref<0x64xf32> to memref<0x?xf32, affine_map<(d0, d1)[s0] -> (d0 * 64 + s0 + d1)>>
+            %16 = memref.subview %6[%arg0, %arg1] [%12, %14] [1, 1] : memref<64x64xf32> to memref<?x?xf32, affine_map<(d0, d1)[s0] -> (d0 * 64 + s0 + d1)>>
+            linalg.matmul {__internal_linalg_transform__ = "workgroup"} ins(%13, %15 : memref<?x0xf32, affine_map<(d0, d1)[s0] -> (d1 + s0)>>, memref<0x?xf32, affine_map<(d0, d1)[s0] -> (d0 * 64 + s0 + d1)>>) outs(%16 : memref<?x?xf32, affine_map<(d0, d1)[s0] -> (d0 * 64 + s0 + d1)>>)
+          }
+        }
+        return
+      }
+    }
+  }
+}
+
+// Static empty reductions are tiled as if K were dynamic.
+//  ARM-DAG: #[[CONFIG:.+]] = {nativeVectorSize = [4, 4, 4], tileSizes = {{\[}}[64, 64], {{.+}}{{\]}}}
+//      ARM: linalg.matmul
+// ARM-SAME:   lowering.config = #[[CONFIG]]
+
+//  X86-DAG: #[[CONFIG:.+]] = {nativeVectorSize = [8, 16, 16], tileSizes = {{\[}}[64, 64], {{.+}}{{\]}}}
+//      X86: linalg.matmul
+// X86-SAME:   lowering.config = #[[CONFIG]]
@@ -0,0 +1,183 @@
+// RUN: iree-opt -pass-pipeline="hal.executable(hal.executable.target(iree-lower-executable-target-pass{test-lowering-configuration=true}))" -iree-codegen-llvm-tuning-db=<(echo '{"version": 1, "entries": [{"signature": "linalg.matmul(384x512xf32,512x128xf32)->(384x128xf32)", "tileSizes": [[128, 32], [64, 16, 32], [8, 8, 8]], "nativeVectorSize": [8, 8, 8]}, {"signature": "linalg.generic<parallel,parallel>(128x256xf32,256xf32)->(128x256xf32)", "tileSizes": [[16, 256]]}]}') -cse -canonicalize -split-input-file %s | IreeFileCheck %s
+
+hal.executable @matmul_tuned attributes {sym_visibility = "private"} {
+  hal.interface @io {
+    hal.interface.binding @arg0, set=0, binding=0, type="StorageBuffer", access="Read"
+    hal.interface.binding @arg1, set=0, binding=1, type="StorageBuffer", access="Read"
+    hal.interface.binding @ret0, set=0, binding=2, type="StorageBuffer", access="Write|Discard"
+  }
+  hal.executable.target @llvm_aot, filter="dylib*" {
+    hal.executable.entry_point @matmul_tuned attributes {
+      interface = @io,
+      ordinal = 0 : index
+    }
+    module {
+      func @matmul_tuned() {
+        %c0 = constant 0 : index
+        %c128 = constant 128 : index
+        %c384 = constant 384 : index
+        %0 = hal.interface.binding.subspan @io::@arg0[%c0] : memref<384x512xf32>
+        %1 = hal.interface.binding.subspan @io::@arg1[%c0] : memref<512x128xf32>
+        %2 = hal.interface.binding.subspan @io::@ret0[%c0] : memref<384x128xf32>
+        %workgroup_size_x = hal.interface.workgroup.size[0] : index
+        %workgroup_size_y = hal.interface.workgroup.size[1] : index
+        %workgroup_id_x = hal.interface.workgroup.id[0] : index
+        %workgroup_count_x = hal.interface.workgroup.count[0] : index
+        %workgroup_id_y = hal.interface.workgroup.id[1] : index
+        %workgroup_count_y = hal.interface.workgroup.count[1] : index
+        %3 = muli %workgroup_size_y, %workgroup_id_y : index
+        %4 = muli %workgroup_size_y, %workgroup_count_y : index
+        scf.for %arg0 = %3 to %c384 step %4 {
+          %5 = muli %workgroup_size_x, %workgroup_id_x : index
+          %6 = muli %workgroup_size_x, %workgroup_count_x : index
+          scf.for %arg1 = %5 to %c128 step %6 {
+            %7 = affine.min affine_map<(d0)[s0] -> (s0, -d0 + 384)>(%arg0)[%workgroup_size_y]
+            %8 = memref.subview %0[%arg0, 0] [%7, 512] [1, 1] : memref<384x512xf32> to memref<?x512xf32, affine_map<(d0, d1)[s0] -> (d0 * 512 + s0 + d1)>>
+            %9 = affine.min affine_map<(d0)[s0] -> (s0, -d0 + 128)>(%arg1)[%workgroup_size_x]
+            %10 = memref.subview %1[0, %arg1] [512, %9] [1, 1] : memref<512x128xf32> to memref<512x?xf32, affine_map<(d0, d1)[s0] -> (d0 * 128 + s0 + d1)>>
+            %11 = memref.subview %2[%arg0, %arg1] [%7, %9] [1, 1] : memref<384x128xf32> to memref<?x?xf32, affine_map<(d0, d1)[s0] -> (d0 * 128 + s0 + d1)>>
+            linalg.matmul {__internal_linalg_transform__ = "workgroup"} ins(%8, %10 : memref<?x512xf32, affine_map<(d0, d1)[s0] -> (d0 * 512 + s0 + d1)>>, memref<512x?xf32, affine_map<(d0, d1)[s0] -> (d0 * 128 + s0 + d1)>>) outs(%11 : memref<?x?xf32, affine_map<(d0, d1)[s0] -> (d0 * 128 + s0 + d1)>>)
+          }
+        }
+        return
+      }
+    }
+  }
+}
+
+//  CHECK-DAG: #[[CONFIG:.+]] = {nativeVectorSize = [8, 8, 8], tileSizes = {{\[}}[128, 32], [64, 16, 32], [8, 8, 8]{{\]}}}
+//  CHECK-DAG: #[[MAP0:.+]] = affine_map<()[s0] -> (s0 ceildiv 32)>
+//  CHECK-DAG: #[[MAP1:.+]] = affine_map<()[s0] -> (s0 ceildiv 128)>
+//      CHECK: hal.executable.entry_point @matmul_tuned
+// CHECK-NEXT:   (%[[ARG0:[a-zA-Z0-9_]+]]: index
+// CHECK-SAME:    %[[ARG1:[a-zA-Z0-9_]+]]: index
+// CHECK-SAME:    %[[ARG2:[a-zA-Z0-9_]+]]: index)
+//  CHECK-DAG:    %[[C1:.+]] = constant 1 : index
+//  CHECK-DAG:    %[[D0:.+]] = affine.apply #[[MAP0]]()[%[[ARG0]]]
+//  CHECK-DAG:    %[[D1:.+]] = affine.apply #[[MAP1]]()[%[[ARG1]]]
+//      CHECK:    hal.return %[[D0]], %[[D1]], %[[C1]] : index, index, index
+//      CHECK: linalg.matmul
+// CHECK-SAME:   lowering.config = #[[CONFIG]]
+
+// -----
+
+hal.executable @matmul_untuned attributes {sym_visibility = "private"} {
+  hal.interface @io {
+    hal.interface.binding @arg0, set=0, binding=0, type="StorageBuffer", access="Read"
+    hal.interface.binding @arg1, set=0, binding=1, type="StorageBuffer", access="Read"
+    hal.interface.binding @ret0, set=0, binding=2, type="StorageBuffer", access="Write|Discard"
+  }
+  hal.executable.target @llvm_aot, filter="dylib*" {
+    hal.executable.entry_point @matmul_untuned attributes {
+      interface = @io,
+      ordinal = 0 : index
+    }
+    module {
+      func @matmul_untuned() {
+        %c0 = constant 0 : index
+        %c64 = constant 64 : index
+        %c256 = constant 256 : index
+        %0 = hal.interface.binding.subspan @io::@arg0[%c0] : memref<256x128xf32>
+        %1 = hal.interface.binding.subspan @io::@arg1[%c0] : memref<128x64xf32>
+        %2 = hal.interface.binding.subspan @io::@ret0[%c0] : memref<256x64xf32>
+        %workgroup_size_x = hal.interface.workgroup.size[0] : index
+        %workgroup_size_y = hal.interface.workgroup.size[1] : index
+        %workgroup_id_x = hal.interface.workgroup.id[0] : index
+        %workgroup_count_x = hal.interface.workgroup.count[0] : index
+        %workgroup_id_y = hal.interface.workgroup.id[1] : index
+        %workgroup_count_y = hal.interface.workgroup.count[1] : index
+        %3 = muli %workgroup_size_y, %workgroup_id_y : index
+        %4 = muli %workgroup_size_y, %workgroup_count_y : index
+        scf.for %arg0 = %3 to %c256 step %4 {
+          %5 = muli %workgroup_size_x, %workgroup_id_x : index
+          %6 = muli %workgroup_size_x, %workgroup_count_x : index
+          scf.for %arg1 = %5 to %c64 step %6 {
+            %7 = affine.min affine_map<(d0)[s0] -> (s0, -d0 + 256)>(%arg0)[%workgroup_size_y]
+            %8 = memref.subview %0[%arg0, 0] [%7, 128] [1, 1] : memref<256x128xf32> to memref<?x128xf32, affine_map<(d0, d1)[s0] -> (d0 * 128 + s0 + d1)>>
+            %9 = affine.min affine_map<(d0)[s0] -> (s0, -d0 + 64)>(%arg1)[%workgroup_size_x]
+            %10 = memref.subview %1[0, %arg1] [128, %9] [1, 1] : memref<128x64xf32> to memref<128x?xf32, affine_map<(d0, d1)[s0] -> (d0 * 64 + s0 + d1)>>
+            %11 = memref.subview %2[%arg0, %arg1] [%7, %9] [1, 1] : memref<256x64xf32> to memref<?x?xf32, affine_map<(d0, d1)[s0] -> (d0 * 64 + s0 + d1)>>
+            linalg.matmul {__internal_linalg_transform__ = "workgroup"} ins(%8, %10 : memref<?x128xf32, affine_map<(d0, d1)[s0] -> (d0 * 128 + s0 + d1)>>, memref<128x?xf32, affine_map<(d0, d1)[s0] -> (d0 * 64 + s0 + d1)>>) outs(%11 : memref<?x?xf32, affine_map<(d0, d1)[s0] -> (d0 * 64 + s0 + d1)>>)
+          }
+        }
+        return
+      }
+    }
+  }
+}
+
+//  CHECK-DAG: #[[CONFIG:.+]] = {nativeVectorSize = [4, 4, 4], tileSizes = {{\[}}[64, 64], [32, 32, 32], [4, 4, 4]{{\]}}}
+//      CHECK: hal.executable.entry_point @matmul_untuned
+//      CHECK: linalg.matmul
+// CHECK-SAME:   lowering.config = #[[CONFIG]]
+
+// -----
+
+hal.executable @add_tuned attributes {sym_visibility = "private"} {
+  hal.interface @io {
+    hal.interface.binding @arg0, set=0, binding=0, type="StorageBuffer", access="Read"
+    hal.interface.binding @arg1, set=0, binding=1, type="StorageBuffer", access="Read"
+    hal.interface.binding @ret0, set=0, binding=2, type="StorageBuffer", access="Write|Discard"
+  }
+  hal.executable.target @llvm_aot, filter="dylib*" {
+    hal.executable.entry_point @add_tuned attributes {
+      interface = @io,
+      ordinal = 0 : index
+    }
+    module  {
+      func @add_tuned() {
+        %c0 = constant 0 : index
+        %c128 = constant 128 : index
+        %c256 = constant 256 : index
+        %0 = hal.interface.binding.subspan @io::@arg0[%c0] : memref<128x256xf32>
+        %1 = hal.interface.binding.subspan @io::@arg1[%c0] : memref<256xf32>
+        %2 = hal.interface.binding.subspan @io::@ret0[%c0] : memref<128x256xf32>
+        %workgroup_size_x = hal.interface.workgroup.size[0] : index
+        %workgroup_size_y = hal.interface.workgroup.size[1] : index
+        %workgroup_id_x = hal.interface.workgroup.id[0] : index
+        %workgroup_count_x = hal.interface.workgroup.count[0] : index
+        %workgroup_id_y = hal.interface.workgroup.id[1] : index
+        %workgroup_count_y = hal.interface.workgroup.count[1] : index
+        %3 = muli %workgroup_size_y, %workgroup_id_y : index
+        %4 = muli %workgroup_size_y, %workgroup_count_y : index
+        scf.for %arg0 = %3 to %c128 step %4 {
+          %5 = muli %workgroup_size_x, %workgroup_id_x : index
+          %6 = muli %workgroup_size_x, %workgroup_count_x : index
+          scf.for %arg1 = %5 to %c256 step %6 {
+            %7 = affine.min affine_map<(d0)[s0] -> (s0, -d0 + 128)>(%arg0)[%workgroup_size_y]
+            %8 = affine.min affine_map<(d0)[s0] -> (s0, -d0 + 256)>(%arg1)[%workgroup_size_x]
+            %9 = memref.subview %0[%arg0, %arg1] [%7, %8] [1, 1] : memref<128x256xf32> to memref<?x?xf32, affine_map<(d0, d1)[s0] -> (d0 * 256 + s0 + d1)>>
+            %10 = memref.subview %1[%arg1] [%8] [1] : memref<256xf32> to memref<?xf32, affine_map<(d0)[s0] -> (d0 + s0)>>
+            %11 = memref.subview %2[%arg0, %arg1] [%7, %8] [1, 1] : memref<128x256xf32> to memref<?x?xf32, affine_map<(d0, d1)[s0] -> (d0 * 256 + s0 + d1)>>
+            linalg.generic {
+              __internal_linalg_transform__ = "workgroup",
+              indexing_maps = [affine_map<(d0, d1) -> (d0, d1)>,
+                               affine_map<(d0, d1) -> (d1)>,
+                               affine_map<(d0, d1) -> (d0, d1)>],
+              iterator_types = ["parallel", "parallel"]}
+              ins(%9, %10 : memref<?x?xf32, affine_map<(d0, d1)[s0] -> (d0 * 256 + s0 + d1)>>, memref<?xf32, affine_map<(d0)[s0] -> (d0 + s0)>>) outs(%11 : memref<?x?xf32, affine_map<(d0, d1)[s0] -> (d0 * 256 + s0 + d1)>>) {
+              ^bb0(%arg2: f32, %arg3: f32, %arg4: f32):  // no predecessors
+                %12 = addf %arg2, %arg3 : f32
+                linalg.yield %12 : f32
+              }
+          }
+        }
+        return
+      }
+    }
+  }
+}
+
+//  CHECK-DAG: #[[CONFIG:.+]] = {tileSizes = {{\[}}[16, 256]{{\]}}}
+//  CHECK-DAG: #[[MAP0:.+]] = affine_map<()[s0] -> (s0 ceildiv 256)>
+//  CHECK-DAG: #[[MAP1:.+]] = affine_map<()[s0] -> (s0 ceildiv 16)>
+//      CHECK: hal.executable.entry_point @add_tuned
+// CHECK-NEXT:   (%[[ARG0:[a-zA-Z0-9_]+]]: index
+// CHECK-SAME:    %[[ARG1:[a-zA-Z0-9_]+]]: index
+// CHECK-SAME:    %[[ARG2:[a-zA-Z0-9_]+]]: index)
+//  CHECK-DAG:    %[[C1:.+]] = constant 1 : index
+//  CHECK-DAG:    %[[D0:.+]] = affine.apply #[[MAP0]]()[%[[ARG0]]]
+//  CHECK-DAG:    %[[D1:.+]] = affine.apply #[[MAP1]]()[%[[ARG1]]]
+//      CHECK:    hal.return %[[D0]], %[[D1]], %[[C1]] : index, index, index
+//      CHECK: linalg.generic
+// CHECK-SAME:   lowering.config = #[[CONFIG]]
@@ -0,0 +1,285 @@
+// Copyright 2021 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include <cstring>
+
+#include "mlir/Dialect/Linalg/IR/LinalgOps.h"
+#include "mlir/Dialect/StandardOps/IR/Ops.h"
+#include "mlir/IR/Builders.h"
+#include "mlir/IR/BuiltinAttributes.h"
+#include "mlir/IR/Matchers.h"
+#include "mlir/Pass/Pass.h"
+#include "mlir/Transforms/GreedyPatternRewriteDriver.h"
+
+namespace mlir {
+namespace iree_compiler {
+
+namespace {
+
+// clang-format off
+//
+// Converts a linalg.matmul on tensors into a matmul on operands packed into
+// contiguous register-sized blocks ("mmt4d"):
+//
+//   lhs:    MxK -> M1xK1xM0xK0  (M = M1 * M0, K = K1 * K0)
+//   rhs:    KxN -> N1xK1xN0xK0  (N = N1 * N0)
+//   result: MxN -> M1xN1xM0xN0
+//
+//   mmt4d(m1, n1, k1, m0, n0, k0):
+//     result[m1, n1, m0, n0] += lhs[m1, k1, m0, k0] * rhs[n1, k1, n0, k0]
+//
+// The packed matmul is a linalg.generic with the loops (m1, n1, k1, m0, n0, k0)
+// so the innermost M0xN0xK0 block maps onto a register-blocked kernel reading
+// contiguous M0xK0 and N0xK0 panels of the packed LHS and RHS. Packing and
+// unpacking are linalg.generic transposes of the expanded operands. Constant
+// operands (such as weights) are packed at compile time and an accumulator
+// produced by a linalg.fill is filled in its packed layout directly.
+//
+// clang-format on
+class ConvertMatmulToMmt4d : public OpRewritePattern<linalg::MatmulOp> {
+ public:
+  ConvertMatmulToMmt4d(MLIRContext *context, int64_t m0, int64_t n0,
+                       int64_t k0)
+      : OpRewritePattern<linalg::MatmulOp>(context), m0(m0), n0(n0), k0(k0) {}
+
+  LogicalResult matchAndRewrite(linalg::MatmulOp matmulOp,
+                                PatternRewriter &rewriter) const override {
+    if (!matmulOp.hasTensorSemantics()) return failure();
+    Value lhs = matmulOp.getInputOperand(0)->get();
+    Value rhs = matmulOp.getInputOperand(1)->get();
+    Value acc = matmulOp.getOutputOperand(0)->get();
+    auto lhsType = lhs.getType().dyn_cast<RankedTensorType>();
+    auto rhsType = rhs.getType().dyn_cast<RankedTensorType>();
+    auto accType = acc.getType().dyn_cast<RankedTensorType>();
+    if (!lhsType || !rhsType || !accType) return failure();
+    if (!lhsType.hasStaticShape() || !rhsType.hasStaticShape() ||
+        !accType.hasStaticShape()) {
+      return failure();
+    }
+
+    // Mixed precision matmuls are not supported by the packed kernel body.
+    Type elementType = accType.getElementType();
+    if (lhsType.getElementType() != elementType ||
+        rhsType.getElementType() != elementType ||
+        !elementType.isIntOrFloat()) {
+      return failure();
+    }
+
+    // TODO: Pad operands that are not a multiple of the block sizes.
+    int64_t m = lhsType.getShape()[0];
+    int64_t k = lhsType.getShape()[1];
+    int64_t n = rhsType.getShape()[1];
+    if (m % m0 != 0 || n % n0 != 0 || k % k0 != 0) return failure();
+    // A single block of rows or columns is a matrix-vector-like product that
+    // does not benefit from packing.
+    if (m <= m0 || n <= n0) return failure();
+    int64_t m1 = m / m0, n1 = n / n0, k1 = k / k0;
+
+    auto loc = matmulOp.getLoc();
+    Value packedLhs = packOperand(rewriter, loc, lhs, {m1, m0, k1, k0},
+                                  /*permutation=*/{0, 2, 1, 3});
+    Value packedRhs = packOperand(rewriter, loc, rhs, {k1, k0, n1, n0},
+                                  /*permutation=*/{2, 0, 3, 1});
+    Value packedAcc;
+    if (auto fillOp = acc.getDefiningOp<linalg::FillOp>()) {
+      Value initTensor = rewriter.create<linalg::InitTensorOp>(
+          loc, ArrayRef<int64_t>{m1, n1, m0, n0}, elementType);
+      packedAcc =
+          rewriter.create<linalg::FillOp>(loc, initTensor, fillOp.value())
+              .getResult(0);
+    } else {
+      packedAcc = packOperand(rewriter, loc, acc, {m1, m0, n1, n0},
+                              /*permutation=*/{0, 2, 1, 3});
+    }
+
+    auto d = [&](unsigned i) { return rewriter.getAffineDimExpr(i); };
+    // Loops: (m1, n1, k1, m0, n0, k0).
+    SmallVector<AffineMap, 3> indexingMaps = {
+        AffineMap::get(6, 0, {d(0), d(2), d(3), d(5)}, rewriter.getContext()),
+        AffineMap::get(6, 0, {d(1), d(2), d(4), d(5)}, rewriter.getContext()),
+        AffineMap::get(6, 0, {d(0), d(1), d(3), d(4)}, rewriter.getContext()),
+    };
+    SmallVector<StringRef, 6> iteratorTypes = {
+        getParallelIteratorTypeName(),  getParallelIteratorTypeName(),
+        getReductionIteratorTypeName(), getParallelIteratorTypeName(),
+        getParallelIteratorTypeName(),  getReductionIteratorTypeName()};
+    auto mmt4dOp = rewriter.create<linalg::GenericOp>(
+        loc, packedAcc.getType(),
+        /*inputs=*/ValueRange{packedLhs, packedRhs}, /*outputs=*/packedAcc,
+        indexingMaps, iteratorTypes,
+        [&](OpBuilder &nestedBuilder, Location nestedLoc, ValueRange args) {
+          Value mul, add;
+          if (elementType.isa<FloatType>()) {
+            mul = nestedBuilder.create<MulFOp>(nestedLoc, args[0], args[1]);
+            add = nestedBuilder.create<AddFOp>(nestedLoc, mul, args[2]);
+          } else {
+            mul = nestedBuilder.create<MulIOp>(nestedLoc, args[0], args[1]);
+            add = nestedBuilder.create<AddIOp>(nestedLoc, mul, args[2]);
+          }
+          nestedBuilder.create<linalg::YieldOp>(nestedLoc, add);
+        });
+
+    // Unpack M1xN1xM0xN0 into M1xM0xN1xN0 and collapse into MxN.
+    Value unpackedResult =
+        transposeOperand(rewriter, loc, mmt4dOp.getResult(0),
+                         /*permutation=*/{0, 2, 1, 3});
+    SmallVector<linalg::ReassociationIndices> reassociationIndices = {{0, 1},
+                                                                      {2, 3}};
+    Value result = rewriter.create<linalg::TensorCollapseShapeOp>(
+        loc, accType, unpackedResult, reassociationIndices);
+    rewriter.replaceOp(matmulOp, ArrayRef<Value>{result});
+    return success();
+  }
+
+ private:
+  /// Returns the 2D `value` expanded into the 4D `expandedShape` and
+  /// transposed such that dimension `i` of the result is dimension
+  /// `permutation[i]` of the expanded value.
+  Value packOperand(PatternRewriter &rewriter, Location loc, Value value,
+                    ArrayRef<int64_t> expandedShape,
+                    ArrayRef<int64_t> permutation) const {
+    DenseElementsAttr constantAttr;
+    if (matchPattern(value, m_Constant(&constantAttr))) {
+      if (auto packedAttr =
+              packConstant(constantAttr, expandedShape, permutation)) {
+        return rewriter.create<ConstantOp>(loc, packedAttr);
+      }
+    }
+    auto valueType = value.getType().cast<RankedTensorType>();
+    auto expandedType =
+        RankedTensorType::get(expandedShape, valueType.getElementType());
+    SmallVector<linalg::ReassociationIndices> reassociationIndices = {{0, 1},
+                                                                      {2, 3}};
+    Value expanded = rewriter.create<linalg::TensorExpandShapeOp>(
+        loc, expandedType, value, reassociationIndices);
+    return transposeOperand(rewriter, loc, expanded, permutation);
+  }
+
+  /// Returns a linalg.generic copying `value` into a tensor whose dimension
+  /// `i` is dimension `permutation[i]` of `value`.
+  Value transposeOperand(PatternRewriter &rewriter, Location loc, Value value,
+                         ArrayRef<int64_t> permutation) const {
+    auto valueType = value.getType().cast<RankedTensorType>();
+    unsigned rank = valueType.getRank();
+    SmallVector<int64_t, 4> transposedShape(rank);
+    SmallVector<AffineExpr, 4> inputExprs(rank);
+    for (unsigned i = 0; i < rank; ++i) {
+      transposedShape[i] = valueType.getDimSize(permutation[i]);
+      inputExprs[permutation[i]] = rewriter.getAffineDimExpr(i);
+    }
+    Value initTensor = rewriter.create<linalg::InitTensorOp>(
+        loc, transposedShape, valueType.getElementType());
+    SmallVector<AffineMap, 2> indexingMaps = {
+        AffineMap::get(rank, 0, inputExprs, rewriter.getContext()),
+        AffineMap::getMultiDimIdentityMap(rank, rewriter.getContext())};
+    SmallVector<StringRef, 4> iteratorTypes(rank,
+                                            getParallelIteratorTypeName());
+    auto transposeOp = rewriter.create<linalg::GenericOp>(
+        loc, initTensor.getType(), /*inputs=*/value, /*outputs=*/initTensor,
+        indexingMaps, iteratorTypes,
+        [&](OpBuilder &nestedBuilder, Location nestedLoc, ValueRange args) {
+          nestedBuilder.create<linalg::YieldOp>(nestedLoc, args[0]);
+        });
+    return transposeOp.getResult(0);
+  }
+
+  /// Returns the constant `attr` expanded into `expandedShape` and transposed
+  /// by `permutation` or nullptr if the elements cannot be reordered as bytes.
+  DenseElementsAttr packConstant(DenseElementsAttr attr,
+                                 ArrayRef<int64_t> expandedShape,
+                                 ArrayRef<int64_t> permutation) const {
+    Type elementType = attr.getType().getElementType();
+    SmallVector<int64_t, 4> packedShape;
+    for (int64_t dim : permutation) packedShape.push_back(expandedShape[dim]);
+    auto packedType = RankedTensorType::get(packedShape, elementType);
+    if (attr.isSplat()) {
+      return DenseElementsAttr::get(packedType, attr.getSplatValue());
+    }
+    // Sub-byte elements are bit-packed in the raw data.
+    if (!elementType.isIntOrFloat() ||
+        elementType.getIntOrFloatBitWidth() % 8 != 0) {
+      return nullptr;
+    }
+    int64_t elementSize = elementType.getIntOrFloatBitWidth() / 8;
+
+    // Strides in elements of the expanded source.
+    unsigned rank = expandedShape.size();
+    SmallVector<int64_t, 4> sourceStrides(rank, 1);
+    for (int i = rank - 2; i >= 0; --i) {
+      sourceStrides[i] = sourceStrides[i + 1] * expandedShape[i + 1];
+    }
+    ArrayRef<char> sourceData = attr.getRawData();
+    std::vector<char> packedData(sourceData.size());
+    SmallVector<int64_t, 4> index(rank, 0);
+    int64_t numElements = packedType.getNumElements();
+    for (int64_t packedOffset = 0; packedOffset < numElements;
+         ++packedOffset) {
+      int64_t sourceOffset = 0;
+      for (unsigned i = 0; i < rank; ++i) {
+        sourceOffset += index[i] * sourceStrides[permutation[i]];
+      }
+      std::memcpy(packedData.data() + packedOffset * elementSize,
+                  sourceData.data() + sourceOffset * elementSize, elementSize);
+      // Increment the packed index in row-major order.
+      for (int i = rank - 1; i >= 0; --i) {
+        if (++index[i] < packedShape[i]) break;
+        index[i] = 0;
+      }
+    }
+    return DenseElementsAttr::getFromRawBuffer(packedType, packedData,
+                                               /*isSplatBuffer=*/false);
+  }
+
+  int64_t m0, n0, k0;
+};
+
+struct ConvertMatmulToMmt4dPass
+    : public PassWrapper<ConvertMatmulToMmt4dPass, FunctionPass> {
+  ConvertMatmulToMmt4dPass() = default;
+  ConvertMatmulToMmt4dPass(const ConvertMatmulToMmt4dPass &pass) {}
+
+  void getDependentDialects(DialectRegistry &registry) const override {
+    registry.insert<linalg::LinalgDialect>();
+  }
+
+  void runOnFunction() override {
+    if (m0 <= 0 || n0 <= 0 || k0 <= 0) {
+      getOperation().emitError("invalid mmt4d block sizes");
+      return signalPassFailure();
+    }
+    MLIRContext *context = &getContext();
+    OwningRewritePatternList patterns(&getContext());
+    patterns.insert<ConvertMatmulToMmt4d>(context, m0, n0, k0);
+    (void)applyPatternsAndFoldGreedily(getOperation(), std::move(patterns));
+  }
+
+  Option<int> m0{*this, "M0",
+                 llvm::cl::desc("Block size of the M dimension of the LHS "
+                                "and result"),
+                 llvm::cl::init(8)};
+  Option<int> n0{*this, "N0",
+                 llvm::cl::desc("Block size of the N dimension of the RHS "
+                                "and result"),
+                 llvm::cl::init(8)};
+  Option<int> k0{*this, "K0",
+                 llvm::cl::desc("Block size of the K dimension of the LHS "
+                                "and RHS"),
+                 llvm::cl::init(1)};
+};
+
+}  // namespace
+
+std::unique_ptr<OperationPass<FuncOp>> createConvertMatmulToMmt4dPass() {
+  return std::make_unique<ConvertMatmulToMmt4dPass>();
+}
+
+static PassRegistration<ConvertMatmulToMmt4dPass> pass(
+    "iree-codegen-convert-matmul-to-mmt4d",
+    "Convert linalg.matmul ops to a matmul on operands packed into "
+    "contiguous blocks (mmt4d)");
+
+}  // namespace iree_compiler
+}  // namespace mlir
@@ -16,6 +16,10 @@ std::unique_ptr<OperationPass<FuncOp>> createConvert1x1ConvToMatmulPass();
 
 std::unique_ptr<OperationPass<FuncOp>> createConvertConv2DToImg2ColPass();
 
+/// Creates a pass to convert linalg.matmul ops into a matmul on operands packed
+/// into contiguous blocks (mmt4d) along with the packing and unpacking ops.
+std::unique_ptr<OperationPass<FuncOp>> createConvertMatmulToMmt4dPass();
+
 /// Pass to convert a linalg.pad_tensor operation into a linalg.fill +
 /// subtensor_insert. This allows lowering the operation into a single kernel.
 std::unique_ptr<OperationPass<>> createPadTensorToSubTensorInsertPass();
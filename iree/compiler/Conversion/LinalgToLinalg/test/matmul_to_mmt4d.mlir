@@ -0,0 +1,95 @@
+// RUN: iree-opt -split-input-file -iree-codegen-convert-matmul-to-mmt4d="M0=4 N0=4 K0=2" %s | IreeFileCheck %s
+
+func @matmul(%lhs: tensor<8x6xf32>, %rhs: tensor<6x12xf32>, %acc: tensor<8x12xf32>) -> tensor<8x12xf32> {
+  %0 = linalg.matmul ins(%lhs, %rhs : tensor<8x6xf32>, tensor<6x12xf32>) outs(%acc : tensor<8x12xf32>) -> tensor<8x12xf32>
+  return %0 : tensor<8x12xf32>
+}
+//  CHECK-DAG: #[[MAP_LHS_RESULT:.+]] = affine_map<(d0, d1, d2, d3) -> (d0, d2, d1, d3)>
+//  CHECK-DAG: #[[MAP_IDENTITY:.+]] = affine_map<(d0, d1, d2, d3) -> (d0, d1, d2, d3)>
+//  CHECK-DAG: #[[MAP_RHS:.+]] = affine_map<(d0, d1, d2, d3) -> (d1, d3, d0, d2)>
+//  CHECK-DAG: #[[MAP_MMT4D_LHS:.+]] = affine_map<(d0, d1, d2, d3, d4, d5) -> (d0, d2, d3, d5)>
+//  CHECK-DAG: #[[MAP_MMT4D_RHS:.+]] = affine_map<(d0, d1, d2, d3, d4, d5) -> (d1, d2, d4, d5)>
+//  CHECK-DAG: #[[MAP_MMT4D_ACC:.+]] = affine_map<(d0, d1, d2, d3, d4, d5) -> (d0, d1, d3, d4)>
+//      CHECK: func @matmul
+// CHECK-SAME:   %[[LHS:[a-zA-Z0-9_]+]]: tensor<8x6xf32>
+// CHECK-SAME:   %[[RHS:[a-zA-Z0-9_]+]]: tensor<6x12xf32>
+// CHECK-SAME:   %[[ACC:[a-zA-Z0-9_]+]]: tensor<8x12xf32>
+//      CHECK:   %[[LHS_4D:.+]] = linalg.tensor_expand_shape %[[LHS]]
+// CHECK-SAME:     [0, 1], [2, 3]
+// CHECK-SAME:     tensor<8x6xf32> into tensor<2x4x3x2xf32>
+//      CHECK:   %[[LHS_INIT:.+]] = linalg.init_tensor [2, 3, 4, 2]
+//      CHECK:   %[[PACKED_LHS:.+]] = linalg.generic
+// CHECK-SAME:     indexing_maps = [#[[MAP_LHS_RESULT]], #[[MAP_IDENTITY]]]
+// CHECK-SAME:     ins(%[[LHS_4D]] : tensor<2x4x3x2xf32>)
+// CHECK-SAME:     outs(%[[LHS_INIT]] : tensor<2x3x4x2xf32>)
+//      CHECK:   %[[RHS_4D:.+]] = linalg.tensor_expand_shape %[[RHS]]
+// CHECK-SAME:     tensor<6x12xf32> into tensor<3x2x3x4xf32>
+//      CHECK:   %[[RHS_INIT:.+]] = linalg.init_tensor [3, 3, 4, 2]
+//      CHECK:   %[[PACKED_RHS:.+]] = linalg.generic
+// CHECK-SAME:     indexing_maps = [#[[MAP_RHS]], #[[MAP_IDENTITY]]]
+// CHECK-SAME:     ins(%[[RHS_4D]] : tensor<3x2x3x4xf32>)
+// CHECK-SAME:     outs(%[[RHS_INIT]] : tensor<3x3x4x2xf32>)
+//      CHECK:   %[[ACC_4D:.+]] = linalg.tensor_expand_shape %[[ACC]]
+// CHECK-SAME:     tensor<8x12xf32> into tensor<2x4x3x4xf32>
+//      CHECK:   %[[PACKED_ACC:.+]] = linalg.generic
+// CHECK-SAME:     ins(%[[ACC_4D]] : tensor<2x4x3x4xf32>)
+//      CHECK:   %[[MMT4D:.+]] = linalg.generic
+// CHECK-SAME:     indexing_maps = [#[[MAP_MMT4D_LHS]], #[[MAP_MMT4D_RHS]], #[[MAP_MMT4D_ACC]]]
+// CHECK-SAME:     iterator_types = ["parallel", "parallel", "reduction", "parallel", "parallel", "reduction"]
+// CHECK-SAME:     ins(%[[PACKED_LHS]], %[[PACKED_RHS]] : tensor<2x3x4x2xf32>, tensor<3x3x4x2xf32>)
+// CHECK-SAME:     outs(%[[PACKED_ACC]] : tensor<2x3x4x4xf32>)
+//      CHECK:     mulf
+//      CHECK:     addf
+//      CHECK:   %[[UNPACKED:.+]] = linalg.generic
+// CHECK-SAME:     ins(%[[MMT4D]] : tensor<2x3x4x4xf32>)
+//      CHECK:   %[[RESULT:.+]] = linalg.tensor_collapse_shape %[[UNPACKED]]
+// CHECK-SAME:     tensor<2x4x3x4xf32> into tensor<8x12xf32>
+//      CHECK:   return %[[RESULT]]
+
+// -----
+
+func @matmul_fill(%lhs: tensor<8x6xf32>, %rhs: tensor<6x12xf32>) -> tensor<8x12xf32> {
+  %zero = constant 0.0 : f32
+  %init = linalg.init_tensor [8, 12] : tensor<8x12xf32>
+  %fill = linalg.fill(%init, %zero) : tensor<8x12xf32>, f32 -> tensor<8x12xf32>
+  %0 = linalg.matmul ins(%lhs, %rhs : tensor<8x6xf32>, tensor<6x12xf32>) outs(%fill : tensor<8x12xf32>) -> tensor<8x12xf32>
+  return %0 : tensor<8x12xf32>
+}
+//      CHECK: func @matmul_fill
+//  CHECK-DAG:   %[[ZERO:.+]] = constant 0.000000e+00 : f32
+//      CHECK:   %[[ACC_INIT:.+]] = linalg.init_tensor [2, 3, 4, 4] : tensor<2x3x4x4xf32>
+//      CHECK:   %[[PACKED_ACC:.+]] = linalg.fill(%[[ACC_INIT]], %[[ZERO]])
+//      CHECK:   %[[MMT4D:.+]] = linalg.generic
+// CHECK-SAME:     outs(%[[PACKED_ACC]] : tensor<2x3x4x4xf32>)
+//      CHECK:   linalg.generic
+// CHECK-SAME:     ins(%[[MMT4D]] : tensor<2x3x4x4xf32>)
+
+// -----
+
+func @matmul_constant_rhs(%lhs: tensor<8x4xi32>, %acc: tensor<8x8xi32>) -> tensor<8x8xi32> {
+  %rhs = constant dense<[[0, 1, 2, 3, 4, 5, 6, 7],
+                         [8, 9, 10, 11, 12, 13, 14, 15],
+                         [16, 17, 18, 19, 20, 21, 22, 23],
+                         [24, 25, 26, 27, 28, 29, 30, 31]]> : tensor<4x8xi32>
+  %0 = linalg.matmul ins(%lhs, %rhs : tensor<8x4xi32>, tensor<4x8xi32>) outs(%acc : tensor<8x8xi32>) -> tensor<8x8xi32>
+  return %0 : tensor<8x8xi32>
+}
+//      CHECK: func @matmul_constant_rhs
+//      CHECK:   %[[PACKED_RHS:.+]] = constant dense<
+// CHECK-SAME:     {{\[}}[0, 8], [1, 9], [2, 10], [3, 11]], {{\[}}[16, 24], [17, 25], [18, 26], [19, 27]]],
+// CHECK-SAME:     {{\[}}[4, 12], [5, 13], [6, 14], [7, 15]], {{\[}}[20, 28], [21, 29], [22, 30], [23, 31]]]
+// CHECK-SAME:     : tensor<2x2x4x2xi32>
+//  CHECK-NOT:   linalg.tensor_expand_shape %{{.+}} : tensor<4x8xi32>
+//      CHECK:   linalg.generic {{.+}} ins(%{{.+}}, %[[PACKED_RHS]] : tensor<2x2x4x2xi32>, tensor<2x2x4x2xi32>)
+//      CHECK:     muli
+//      CHECK:     addi
+
+// -----
+
+func @matmul_not_divisible(%lhs: tensor<10x6xf32>, %rhs: tensor<6x12xf32>, %acc: tensor<10x12xf32>) -> tensor<10x12xf32> {
+  %0 = linalg.matmul ins(%lhs, %rhs : tensor<10x6xf32>, tensor<6x12xf32>) outs(%acc : tensor<10x12xf32>) -> tensor<10x12xf32>
+  return %0 : tensor<10x12xf32>
+}
+//      CHECK: func @matmul_not_divisible
+//  CHECK-NOT:   linalg.generic
+//      CHECK:   linalg.matmul
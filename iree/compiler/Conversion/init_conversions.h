@@ -74,6 +74,7 @@ inline void registerLinalgToLinalgPasses() {
     // LinalgToLinalg
     createConvert1x1ConvToMatmulPass();
     createConvertConv2DToImg2ColPass();
+    createConvertMatmulToMmt4dPass();
     return true;
   }();
   (void)init_once;
@@ -8,10 +8,12 @@
 #include "iree/compiler/Dialect/Flow/Transforms/PassDetail.h"
 #include "iree/compiler/Dialect/Flow/Transforms/Passes.h"
 #include "iree/compiler/Dialect/IREE/IR/IREEOps.h"
+#include "llvm/ADT/DenseSet.h"
 #include "mlir/Dialect/StandardOps/IR/Ops.h"
 #include "mlir/IR/BlockAndValueMapping.h"
 #include "mlir/IR/Builders.h"
 #include "mlir/IR/BuiltinTypes.h"
+#include "mlir/IR/Matchers.h"
 #include "mlir/Pass/Pass.h"
 
 namespace mlir {
@@ -22,10 +24,18 @@ namespace Flow {
 // Clones each exported functions (including those just created) with
 // placeholder constant inputs instead of arguments and removes the exported
 // attribute from the old functions.
+// If exportDispatches is set also creates one function per dispatched
+// executable entry point that issues a single dispatch of it so that dispatches
+// can be benchmarked in isolation.
 // The input are provided using flow.variables.
 class ExportBenchmarkFuncsPass
     : public ExportBenchmarkFuncsBase<ExportBenchmarkFuncsPass> {
  public:
+  ExportBenchmarkFuncsPass() = default;
+  explicit ExportBenchmarkFuncsPass(bool exportDispatches) {
+    this->exportDispatches = exportDispatches;
+  }
+
   void runOnOperation() override {
     ModuleOp moduleOp = getOperation();
 
@@ -38,9 +48,26 @@ class ExportBenchmarkFuncsPass
         entryFuncOps.push_back(entryFuncOp);
       }
     }
+    SmallVector<DispatchOp, 4> dispatchOps;
+    if (exportDispatches) {
+      for (auto entryFuncOp : moduleOp.getOps<FuncOp>()) {
+        entryFuncOp.walk(
+            [&](DispatchOp dispatchOp) { dispatchOps.push_back(dispatchOp); });
+      }
+    }
     for (auto entryFuncOp : entryFuncOps) {
       createEntryPointBenchmarkFunc(moduleOp, entryFuncOp);
     }
+
+    // Benchmark each entry point using the first dispatch of it that can be
+    // reproduced with dummy inputs.
+    DenseSet<Attribute> benchmarkedEntryPoints;
+    for (auto dispatchOp : dispatchOps) {
+      if (benchmarkedEntryPoints.contains(dispatchOp.entry_point())) continue;
+      if (succeeded(createDispatchBenchmarkFunc(moduleOp, dispatchOp))) {
+        benchmarkedEntryPoints.insert(dispatchOp.entry_point());
+      }
+    }
   }
 
  private:
@@ -107,11 +134,75 @@ class ExportBenchmarkFuncsPass
     entryFuncOp.setPrivate();
   }
 
+  // Creates a `() -> ()` function issuing a clone of |dispatchOp| with dummy
+  // inputs in place of its tensor operands. Fails if any tensor operand has a
+  // dynamic shape or any other operand (workgroup count, dynamic dimensions,
+  // or scalars) is not a constant.
+  LogicalResult createDispatchBenchmarkFunc(ModuleOp moduleOp,
+                                            DispatchOp dispatchOp) {
+    auto isStaticTensor = [](Value value) {
+      auto tensorType = value.getType().dyn_cast<RankedTensorType>();
+      return tensorType && tensorType.hasStaticShape();
+    };
+    for (Value operand : dispatchOp->getOperands()) {
+      if (!isStaticTensor(operand) && !matchPattern(operand, m_Constant())) {
+        return failure();
+      }
+    }
+
+    OpBuilder moduleBuilder(&getContext());
+    moduleBuilder.setInsertionPointToEnd(moduleOp.getBody());
+    Location loc = dispatchOp.getLoc();
+    std::string funcName = dispatchOp.executable().str();
+    StringRef entryName = dispatchOp.entry_point().getLeafReference();
+    if (entryName != funcName) funcName += "_" + entryName.str();
+    funcName += "_benchmark";
+    auto funcOp = moduleBuilder.create<FuncOp>(
+        loc, funcName, moduleBuilder.getFunctionType({}, {}));
+    funcOp.setPublic();
+    funcOp->setAttr("iree.abi.stub", moduleBuilder.getUnitAttr());
+    SmallVector<NamedAttribute> reflectionAttrs = {
+        moduleBuilder.getNamedAttr("benchmark",
+                                   moduleBuilder.getStringAttr("dispatch")),
+    };
+    funcOp->setAttr("iree.reflection",
+                    moduleBuilder.getDictionaryAttr(reflectionAttrs));
+    Block* block = funcOp.addEntryBlock();
+
+    // Load tensor operands from dummy input variables (created before the
+    // function) and rematerialize the constants the dispatch uses.
+    moduleBuilder.setInsertionPoint(funcOp);
+    auto blockBuilder = OpBuilder::atBlockBegin(block);
+    BlockAndValueMapping mapping;
+    for (Value operand : dispatchOp->getOperands()) {
+      if (mapping.contains(operand)) continue;
+      if (isStaticTensor(operand)) {
+        auto variableOp =
+            createDummyInputVariableOp(loc, operand.getType(), moduleBuilder);
+        mapping.map(operand,
+                    blockBuilder.createOrFold<IREE::Flow::VariableLoadOp>(
+                        loc, variableOp));
+      } else {
+        blockBuilder.clone(*operand.getDefiningOp(), mapping);
+      }
+    }
+    auto clonedDispatchOp = blockBuilder.clone(*dispatchOp, mapping);
+
+    // Sink all results with do_not_optimize to ensure that DCE does not
+    // remove the dispatch.
+    for (auto result : clonedDispatchOp->getResults()) {
+      blockBuilder.create<IREE::DoNotOptimizeOp>(loc, result);
+    }
+    blockBuilder.create<mlir::ReturnOp>(loc);
+    return success();
+  }
+
   int uniqueId = 0;
 };
 
-std::unique_ptr<OperationPass<ModuleOp>> createExportBenchmarkFuncsPass() {
-  return std::make_unique<ExportBenchmarkFuncsPass>();
+std::unique_ptr<OperationPass<ModuleOp>> createExportBenchmarkFuncsPass(
+    bool exportDispatches) {
+  return std::make_unique<ExportBenchmarkFuncsPass>(exportDispatches);
 }
 
 }  // namespace Flow
@@ -28,8 +28,17 @@
 static llvm::cl::opt<bool> clExportBenchmarkFuncs(
     "iree-flow-export-benchmark-funcs",
     llvm::cl::desc(
-        "Exports one function per original module entry point and "
-        "unique flow.executable that dispatches with dummy arguments."),
+        "Exports one function per original module entry point that calls it "
+        "with dummy arguments."),
+    llvm::cl::init(false));
+
+// TODO(benvanik): change to a pipeline option.
+static llvm::cl::opt<bool> clExportDispatchBenchmarkFuncs(
+    "iree-flow-export-dispatch-benchmark-funcs",
+    llvm::cl::desc(
+        "Exports one function per unique flow.executable entry point that "
+        "dispatches it with dummy arguments. Implies "
+        "--iree-flow-export-benchmark-funcs."),
     llvm::cl::init(false));
 
 // TODO(benvanik): change to a pipeline option.
@@ -56,6 +65,12 @@ static llvm::cl::opt<bool> clEnableConvToImg2Col(
     llvm::cl::desc("Enable converting convolution ops to img2col form."),
     llvm::cl::init(false));
 
+static llvm::cl::opt<bool> clEnableMatmulToMmt4d(
+    "iree-flow-enable-matmul-to-mmt4d",
+    llvm::cl::desc("Enable converting linalg.matmul ops to a matmul on "
+                   "operands packed into contiguous blocks (mmt4d)."),
+    llvm::cl::init(false));
+
 namespace mlir {
 namespace iree_compiler {
 namespace IREE {
@@ -188,6 +203,12 @@ void buildFlowTransformPassPipeline(OpPassManager &passManager) {
     passManager.addNestedPass<FuncOp>(
         mlir::iree_compiler::createConvertConv2DToImg2ColPass());
   }
+  // Runs after the convolution conversions so the matmuls they produce are
+  // packed as well.
+  if (clEnableMatmulToMmt4d) {
+    passManager.addNestedPass<FuncOp>(
+        mlir::iree_compiler::createConvertMatmulToMmt4dPass());
+  }
   passManager.addPass(
       mlir::iree_compiler::createPadTensorToSubTensorInsertPass());
 
@@ -225,11 +246,12 @@ void buildFlowTransformPassPipeline(OpPassManager &passManager) {
   // typically coming from top level flow control.
   passManager.addNestedPass<FuncOp>(IREE::Flow::createPromoteTensorLoadsPass());
 
-  // Create one function per remaining flow.executable that can be used with
-  // iree-benchmark-module to benchmark each dispatch individually, as well as
-  // exporting all original model entry points.
-  if (clExportBenchmarkFuncs) {
-    passManager.addPass(IREE::Flow::createExportBenchmarkFuncsPass());
+  // Export all original model entry points and, if requested, one function per
+  // remaining flow.executable that can be used with iree-benchmark-module to
+  // benchmark each dispatch individually.
+  if (clExportBenchmarkFuncs || clExportDispatchBenchmarkFuncs) {
+    passManager.addPass(IREE::Flow::createExportBenchmarkFuncsPass(
+        clExportDispatchBenchmarkFuncs));
   }
 
   // Inject tracing that logs both input and output tensors from all dispatches.
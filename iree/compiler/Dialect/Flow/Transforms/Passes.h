@@ -97,8 +97,10 @@ std::unique_ptr<OperationPass<ModuleOp>> createOutlineDispatchRegionsPass();
 // Injects tracing markers for dispatch operation tensor inputs and outputs.
 std::unique_ptr<OperationPass<FuncOp>> createInjectDispatchTracingPass();
 
-// Exports all functions and dispatch executables as `() -> ()` benchmark funcs.
-std::unique_ptr<OperationPass<ModuleOp>> createExportBenchmarkFuncsPass();
+// Exports all functions as `() -> ()` benchmark funcs. If |exportDispatches|
+// is set each dispatched executable entry point is exported as well.
+std::unique_ptr<OperationPass<ModuleOp>> createExportBenchmarkFuncsPass(
+    bool exportDispatches = false);
 
 //===----------------------------------------------------------------------===//
 // Optimizations
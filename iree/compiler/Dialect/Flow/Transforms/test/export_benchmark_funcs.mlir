@@ -1,4 +1,5 @@
-// RUN: iree-opt -split-input-file -iree-mhlo-input-transformation-pipeline -iree-flow-transformation-pipeline -iree-flow-export-benchmark-funcs %s | IreeFileCheck %s
+// RUN: iree-opt -split-input-file -iree-mhlo-input-transformation-pipeline -iree-flow-transformation-pipeline -iree-flow-export-benchmark-funcs %s | IreeFileCheck %s --check-prefixes=CHECK,ENTRY
+// RUN: iree-opt -split-input-file -iree-mhlo-input-transformation-pipeline -iree-flow-transformation-pipeline -iree-flow-export-dispatch-benchmark-funcs %s | IreeFileCheck %s --check-prefixes=CHECK,DISPATCH
 
 module {
   func @two_dispatch(%arg0: tensor<5x3xf32>, %arg1: tensor<3x5xf32>) -> (tensor<5x5xf32>, tensor<3x5xf32>) {
@@ -17,6 +18,15 @@ module {
 // CHECK-DAG: iree.do_not_optimize(%[[RET]]#0) : tensor<5x5xf32>
 // CHECK-DAG: iree.do_not_optimize(%[[RET]]#1) : tensor<3x5xf32>
 
+// Dispatches are only exported with their own dummy inputs when requested.
+//     ENTRY-NOT: benchmark = "dispatch"
+//      DISPATCH: func @[[DISPATCH0:two_dispatch_dispatch_[0-9]+]]_benchmark() attributes {iree.abi.stub, iree.reflection = {benchmark = "dispatch"}}
+//      DISPATCH:   flow.dispatch @[[DISPATCH0]]::@[[DISPATCH0]]
+//      DISPATCH:   iree.do_not_optimize
+//      DISPATCH: func @[[DISPATCH1:two_dispatch_dispatch_[0-9]+]]_benchmark() attributes {iree.abi.stub, iree.reflection = {benchmark = "dispatch"}}
+//      DISPATCH:   flow.dispatch @[[DISPATCH1]]::@[[DISPATCH1]]
+//      DISPATCH:   iree.do_not_optimize
+
 // -----
 
 func @while(%start: tensor<i32>, %bound: tensor<i32>) -> tensor<i32> {
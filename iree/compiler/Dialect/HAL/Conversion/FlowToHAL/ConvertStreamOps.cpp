@@ -16,6 +16,7 @@
 #include "iree/compiler/Dialect/Shape/IR/Builders.h"
 #include "iree/compiler/Dialect/Shape/IR/ShapeOps.h"
 #include "llvm/ADT/DenseMap.h"
+#include "llvm/Support/CommandLine.h"
 #include "llvm/Support/Debug.h"
 #include "mlir/Analysis/Liveness.h"
 #include "mlir/Dialect/StandardOps/IR/Ops.h"
@@ -33,6 +34,14 @@ namespace mlir {
 namespace iree_compiler {
 namespace {
 
+static llvm::cl::opt<bool> clAsyncStreams{
+    "iree-hal-async-streams",
+    llvm::cl::desc(
+        "Submits streams asynchronously chained on a timeline semaphore and "
+        "only waits when a stream result is consumed outside of a stream. "
+        "When disabled every stream is submitted and waited on immediately."),
+    llvm::cl::init(false)};
+
 //===----------------------------------------------------------------------===//
 // Alias analysis
 //===----------------------------------------------------------------------===//
@@ -984,6 +993,33 @@ static LogicalResult recordStreamCommands(
   return success();
 }
 
+// Returns true if all results of |streamOp| are only consumed by other streams.
+// Streams are chained on the submission timeline and execute in order so such
+// results can be passed along without the host waiting on them.
+static bool areResultsOnlyUsedByStreams(
+    IREE::Flow::ExStreamFragmentOp streamOp) {
+  if (streamOp->getNumResults() == 0) return false;
+  for (auto *user : streamOp->getUsers()) {
+    if (!isa<IREE::Flow::ExStreamFragmentOp>(user)) return false;
+  }
+  return true;
+}
+
+// Submits |commandBuffer| chained after all prior submissions and, unless the
+// results are only consumed by subsequent streams, waits for it to complete.
+static void recordAsyncSubmission(IREE::Flow::ExStreamFragmentOp streamOp,
+                                  Value device, Value commandBuffer,
+                                  ConversionPatternRewriter &rewriter) {
+  auto submitOp = rewriter.create<IREE::HAL::ExSubmitOp>(streamOp.getLoc(),
+                                                         device, commandBuffer);
+  if (areResultsOnlyUsedByStreams(streamOp)) return;
+  auto awaitOp = rewriter.create<IREE::HAL::SemaphoreAwaitOp>(
+      streamOp.getLoc(), rewriter.getIntegerType(32),
+      submitOp.semaphore(), submitOp.timepoint());
+  rewriter.create<IREE::HAL::CheckSuccessOp>(
+      streamOp.getLoc(), awaitOp.status(), "stream execution failed");
+}
+
 class ExStreamFragmentOpConversion
     : public OpConversionPattern<IREE::Flow::ExStreamFragmentOp> {
  public:
@@ -1063,6 +1099,13 @@ class ExStreamFragmentOpConversion
     // TODO(benvanik): choose buffer mode/category based on stream commands.
     // NOTE: we are not doing any overlapping work today and can always allow
     // inline execution.
+    // NOTE: the command buffer is recorded on each invocation of the stream
+    // and submitted exactly once so it is always one-shot. Dropping OneShot
+    // would make backends like the task system snapshot the recording for
+    // reuse that never happens. Replaying streams across invocations requires
+    // caching the command buffer with its bindings made indirect and is not
+    // done yet; until then reusable command buffers are only used by hosts
+    // recording against the runtime API directly.
     auto mode = IREE::HAL::CommandBufferModeBitfield::OneShot |
                 IREE::HAL::CommandBufferModeBitfield::AllowInlineExecution;
     auto category = IREE::HAL::CommandCategoryBitfield::Dispatch |
@@ -1082,12 +1125,14 @@ class ExStreamFragmentOpConversion
     }
 
     // End and submit the command buffer.
-    // In a real version we'd want to setup a semaphore chain instead of
-    // submitting and waiting.
     rewriter.create<IREE::HAL::CommandBufferEndOp>(streamOp.getLoc(),
                                                    commandBuffer);
-    rewriter.create<IREE::HAL::ExSubmitAndWaitOp>(streamOp.getLoc(), device,
-                                                  commandBuffer);
+    if (clAsyncStreams) {
+      recordAsyncSubmission(streamOp, device, commandBuffer, rewriter);
+    } else {
+      rewriter.create<IREE::HAL::ExSubmitAndWaitOp>(streamOp.getLoc(), device,
+                                                    commandBuffer);
+    }
 
     // It's annoying but we need to do this replacement at the very end as
     // otherwise we lose access to the original values (which we need for
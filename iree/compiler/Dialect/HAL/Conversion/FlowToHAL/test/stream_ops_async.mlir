@@ -0,0 +1,53 @@
+// RUN: iree-opt -split-input-file -iree-convert-to-hal -iree-hal-async-streams -canonicalize %s | IreeFileCheck %s
+
+hal.executable @ex0 {
+  hal.interface @interface {
+    hal.interface.binding @s0b0, set=0, binding=0, type="StorageBuffer", access="Read"
+    hal.interface.binding @s0b1, set=0, binding=1, type="StorageBuffer", access="Read|Write"
+  }
+  hal.executable.target @vmvx, filter="vmvx" {
+    hal.executable.entry_point @entry0 attributes {
+      interface = @interface,
+      ordinal = 0 : index
+    }
+    module {}
+  }
+}
+
+// CHECK-LABEL: func @chainedStreams
+func @chainedStreams(%input: tensor<128xf32>) -> tensor<128xf32> {
+  %cst = constant 128 : index
+  // CHECK: %[[CMD0:.+]] = hal.command_buffer.create
+  %0 = flow.ex.stream.fragment(%cst, %input) : (index, tensor<128xf32>) -> tensor<128xf32> =
+      (%arg1: index, %arg2: tensor<128xf32>) -> tensor<128xf32> {
+    %1 = flow.dispatch @ex0::@entry0[%arg1](%arg2) {
+      hal.bindings = [
+        #hal.ex.operand_buffer<"s0b0", 0 : index>,
+        #hal.ex.result_buffer<"s0b1", 0 : index>
+      ]
+    } : (tensor<128xf32>) -> tensor<128xf32>
+    flow.return %1 : tensor<128xf32>
+  }
+  // The first stream only feeds the second and is not waited on.
+  //      CHECK: hal.command_buffer.end<%[[CMD0]]
+  // CHECK-NEXT: hal.ex.submit {{.+}}, %[[CMD0]]
+  //  CHECK-NOT: hal.semaphore.await
+  //      CHECK: %[[CMD1:.+]] = hal.command_buffer.create
+  %2 = flow.ex.stream.fragment(%cst, %0) : (index, tensor<128xf32>) -> tensor<128xf32> =
+      (%arg1: index, %arg2: tensor<128xf32>) -> tensor<128xf32> {
+    %3 = flow.dispatch @ex0::@entry0[%arg1](%arg2) {
+      hal.bindings = [
+        #hal.ex.operand_buffer<"s0b0", 0 : index>,
+        #hal.ex.result_buffer<"s0b1", 0 : index>
+      ]
+    } : (tensor<128xf32>) -> tensor<128xf32>
+    flow.return %3 : tensor<128xf32>
+  }
+  // The second stream result escapes to the host and must be waited on.
+  //      CHECK: hal.command_buffer.end<%[[CMD1]]
+  // CHECK-NEXT: %[[SEMAPHORE:.+]], %[[TIMEPOINT:.+]] = hal.ex.submit {{.+}}, %[[CMD1]]
+  // CHECK-NEXT: %[[STATUS:.+]] = hal.semaphore.await<%[[SEMAPHORE]] : !hal.semaphore> until(%[[TIMEPOINT]])
+  // CHECK-NEXT: hal.check_success %[[STATUS]], "stream execution failed"
+  // CHECK-NEXT: return
+  return %2 : tensor<128xf32>
+}
@@ -77,6 +77,9 @@ class ExecutableCreateOpConversion
     if (executableBinaryOp.mime_type().hasValue()) {
       rodataOp.mime_typeAttr(executableBinaryOp.mime_typeAttr());
     }
+    if (executableBinaryOp.alignment().hasValue()) {
+      rodataOp.alignmentAttr(executableBinaryOp.alignmentAttr());
+    }
     rewriter.restoreInsertionPoint(insertPoint);
 
     auto executableFormatString = detail::rewriteAttrToOperands(
@@ -84,3 +84,28 @@ func @multipleExecutables(
   %1 = hal.executable.create device(%device : !hal.device) target(@exe2::@binary2) layouts([%layout1, %layout0]) : !hal.executable
   return %0, %1 : !hal.executable, !hal.executable
 }
+
+// -----
+
+// CHECK: vm.rodata private @_exe_elf_elf_binary_binary_ex_elf dense<[127, 69, 76, 70]> : vector<4xi8> {alignment = 4096 : i64, mime_type = "application/x-elf"}
+hal.executable @exe_elf {
+  hal.interface @interface {
+    hal.interface.binding @s0b0, set=0, binding=0, type="StorageBuffer", access="Read"
+  }
+  hal.executable.binary @elf_binary attributes {
+    alignment = 4096 : i64,
+    data = dense<[127, 69, 76, 70]> : vector<4xi8>,
+    format = "EX_ELF",
+    mime_type = "application/x-elf"
+  }
+}
+
+// CHECK-LABEL: @executableCreateAligned
+func @executableCreateAligned(
+    %device : !hal.device,
+    %layout0 : !hal.executable_layout
+  ) -> !hal.executable {
+  // CHECK: vm.const.ref.rodata @_exe_elf_elf_binary_binary_ex_elf : !vm.buffer
+  %0 = hal.executable.create device(%device : !hal.device) target(@exe_elf::@elf_binary) layouts([%layout0]) : !hal.executable
+  return %0 : !hal.executable
+}
@@ -234,6 +234,16 @@ void ExSharedDeviceOp::getAsmResultNames(
   setNameFn(result(), "device");
 }
 
+//===----------------------------------------------------------------------===//
+// hal.ex.submit
+//===----------------------------------------------------------------------===//
+
+void ExSubmitOp::getAsmResultNames(
+    function_ref<void(Value, StringRef)> setNameFn) {
+  setNameFn(semaphore(), "semaphore");
+  setNameFn(timepoint(), "timepoint");
+}
+
 //===----------------------------------------------------------------------===//
 // hal.tensor.cast
 //===----------------------------------------------------------------------===//
@@ -11,6 +11,8 @@
 
 static const char kConfigAttrName[] = "lowering.config";
 static const char kTranslationInfoAttrName[] = "translation.info";
+static const char kWorkgroupsPerReservationAttrName[] =
+    "workgroups_per_reservation";
 
 #include "iree/compiler/Dialect/HAL/IR/LoweringConfig.cpp.inc"
 #include "iree/compiler/Dialect/HAL/IR/LoweringConfigEnums.cpp.inc"
@@ -59,6 +61,28 @@ LogicalResult setTranslationInfo(IREE::HAL::ExecutableEntryPointOp entryPointOp,
   return success();
 }
 
+void eraseTranslationInfo(IREE::HAL::ExecutableEntryPointOp entryPointOp) {
+  entryPointOp->removeAttr(kTranslationInfoAttrName);
+}
+
+int64_t getWorkgroupsPerReservation(
+    IREE::HAL::ExecutableEntryPointOp entryPointOp) {
+  auto attr = entryPointOp->getAttrOfType<IntegerAttr>(
+      kWorkgroupsPerReservationAttrName);
+  return attr ? attr.getInt() : 0;
+}
+
+void setWorkgroupsPerReservation(IREE::HAL::ExecutableEntryPointOp entryPointOp,
+                                 int64_t workgroupsPerReservation) {
+  if (!workgroupsPerReservation) {
+    entryPointOp->removeAttr(kWorkgroupsPerReservationAttrName);
+    return;
+  }
+  Builder builder(entryPointOp.getContext());
+  entryPointOp->setAttr(kWorkgroupsPerReservationAttrName,
+                        builder.getI64IntegerAttr(workgroupsPerReservation));
+}
+
 //===----------------------------------------------------------------------===//
 // Helpers for getting/setting the `hal.lowering.*` attributes that drive the
 // linalg-based lowering.
@@ -68,6 +68,20 @@ IREE::HAL::TranslationInfo getTranslationInfo(
 LogicalResult setTranslationInfo(IREE::HAL::ExecutableEntryPointOp entryPointOp,
                                  IREE::HAL::TranslationInfo translationInfo);
 
+/// Removes the translate executable info on the entry point op if it exists.
+void eraseTranslationInfo(IREE::HAL::ExecutableEntryPointOp entryPointOp);
+
+/// Returns the number of workgroups a processor should execute each time it
+/// takes work from a dispatch of `entryPointOp`, or 0 if the runtime should
+/// choose.
+int64_t getWorkgroupsPerReservation(
+    IREE::HAL::ExecutableEntryPointOp entryPointOp);
+
+/// Sets the number of workgroups a processor should execute each time it takes
+/// work from a dispatch of `entryPointOp`. A value of 0 removes it.
+void setWorkgroupsPerReservation(IREE::HAL::ExecutableEntryPointOp entryPointOp,
+                                 int64_t workgroupsPerReservation);
+
 //===----------------------------------------------------------------------===//
 // Helpers for getting/setting the `hal.lowering.*` attributes that drive the
 // linalg-based lowering.
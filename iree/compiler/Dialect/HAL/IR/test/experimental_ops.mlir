@@ -11,6 +11,17 @@ func @shared_device() -> !hal.device {
 
 // -----
 
+// CHECK-LABEL: @submit
+func @submit() -> (!hal.semaphore, index) {
+  %0 = "test_hal.device"() : () -> !hal.device
+  %1 = "test_hal.command_buffer"() : () -> !hal.command_buffer
+  // CHECK: %semaphore, %timepoint = hal.ex.submit %0, %1 : !hal.semaphore, index
+  %semaphore, %timepoint = hal.ex.submit %0, %1 : !hal.semaphore, index
+  return %semaphore, %timepoint : !hal.semaphore, index
+}
+
+// -----
+
 // CHECK-LABEL: @submit_and_wait
 func @submit_and_wait() {
   %0 = "test_hal.device"() : () -> !hal.device
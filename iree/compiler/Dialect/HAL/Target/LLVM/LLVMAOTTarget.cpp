@@ -8,7 +8,9 @@
 
 #include <cstdlib>
 
+#include "iree/compiler/Conversion/LinalgToLLVM/KernelDispatch.h"
 #include "iree/compiler/Conversion/LinalgToLLVM/Passes.h"
+#include "iree/compiler/Dialect/HAL/IR/LoweringConfig.h"
 #include "iree/compiler/Dialect/HAL/Target/LLVM/LLVMIRPasses.h"
 #include "iree/compiler/Dialect/HAL/Target/LLVM/LibraryBuilder.h"
 #include "iree/compiler/Dialect/HAL/Target/LLVM/LinkerTool.h"
@@ -17,9 +19,13 @@
 #include "iree/schemas/dylib_executable_def_builder.h"
 #include "llvm/IR/LLVMContext.h"
 #include "llvm/IR/Module.h"
+#include "llvm/Linker/Linker.h"
+#include "llvm/MC/MCSubtargetInfo.h"
 #include "llvm/Support/FormatVariadic.h"
+#include "llvm/Support/TargetRegistry.h"
 #include "llvm/Support/TargetSelect.h"
 #include "mlir/Dialect/LLVMIR/LLVMDialect.h"
+#include "mlir/Pass/PassManager.h"
 #include "mlir/Target/LLVMIR/Dialect/LLVMIR/LLVMToLLVMIRTranslation.h"
 #include "mlir/Target/LLVMIR/Export.h"
 
@@ -54,6 +60,294 @@ std::string guessModuleName(mlir::ModuleOp moduleOp) {
   }
 }
 
+// Returns the subtarget for |cpu| with |cpuFeatures| on |targetTriple| or
+// nullptr if the target is not registered.
+std::unique_ptr<llvm::MCSubtargetInfo> createSubtargetInfo(
+    const llvm::Triple &targetTriple, StringRef cpu, StringRef cpuFeatures) {
+  std::string errorMessage;
+  auto *target =
+      llvm::TargetRegistry::lookupTarget(targetTriple.str(), errorMessage);
+  if (!target) return nullptr;
+  return std::unique_ptr<llvm::MCSubtargetInfo>(
+      target->createMCSubtargetInfo(targetTriple.str(), cpu, cpuFeatures));
+}
+
+// An LLVM target feature with a runtime processor feature bit
+// (iree_hal_processor_feature_bits_t) the executable library can query.
+struct ProcessorFeatureMapping {
+  const char *llvmFeature;
+  LibraryBuilder::ProcessorFeatures feature;
+};
+
+// Returns the LLVM target features of |targetTriple| that the runtime can
+// detect on the host processor.
+ArrayRef<ProcessorFeatureMapping> getProcessorFeatureMappings(
+    const llvm::Triple &targetTriple) {
+  using ProcessorFeatures = LibraryBuilder::ProcessorFeatures;
+  static const ProcessorFeatureMapping kX86_64Features[] = {
+      {"+avx", ProcessorFeatures::X86_64_AVX},
+      {"+avx2", ProcessorFeatures::X86_64_AVX2},
+      {"+fma", ProcessorFeatures::X86_64_FMA},
+      {"+f16c", ProcessorFeatures::X86_64_F16C},
+      {"+avx512f", ProcessorFeatures::X86_64_AVX512F},
+      {"+avx512bw", ProcessorFeatures::X86_64_AVX512BW},
+      {"+avx512dq", ProcessorFeatures::X86_64_AVX512DQ},
+      {"+avx512vl", ProcessorFeatures::X86_64_AVX512VL},
+      {"+avx512vnni", ProcessorFeatures::X86_64_AVX512VNNI},
+  };
+  static const ProcessorFeatureMapping kArm64Features[] = {
+      {"+dotprod", ProcessorFeatures::ARM_64_DOTPROD},
+      {"+fullfp16", ProcessorFeatures::ARM_64_FP16},
+  };
+  if (targetTriple.getArch() == llvm::Triple::x86_64) {
+    return kX86_64Features;
+  } else if (targetTriple.isAArch64()) {
+    return kArm64Features;
+  }
+  return {};
+}
+
+// Returns the runtime processor features (iree_hal_processor_feature_bits_t)
+// available when compiling for |cpu| with |cpuFeatures| on |targetTriple|.
+uint64_t getProcessorFeatures(const llvm::Triple &targetTriple, StringRef cpu,
+                              StringRef cpuFeatures) {
+  auto subtargetInfo = createSubtargetInfo(targetTriple, cpu, cpuFeatures);
+  if (!subtargetInfo) return 0;
+  uint64_t features = 0;
+  for (auto &mapping : getProcessorFeatureMappings(targetTriple)) {
+    if (subtargetInfo->checkFeatures(mapping.llvmFeature)) {
+      features |= static_cast<uint64_t>(mapping.feature);
+    }
+  }
+  return features;
+}
+
+// Returns the LLVM target features used to compile |targetVariant|: the
+// baseline features in |options| plus the features of the variant CPU that
+// the runtime can detect. Code for a variant only runs on hosts that have its
+// required processor features so it must not use anything else the variant
+// CPU enables (such as avx512vbmi on icelake-server) that the runtime does not
+// check for. The variant CPU is still used to tune the generated code.
+std::string getVariantCPUFeatures(const LLVMTargetOptions &options,
+                                  const LLVMTargetVariant &targetVariant) {
+  llvm::Triple targetTriple(options.targetTriple);
+  std::string features = options.targetCPUFeatures;
+  auto subtargetInfo = createSubtargetInfo(
+      targetTriple, targetVariant.targetCPU, targetVariant.targetCPUFeatures);
+  if (!subtargetInfo) return features;
+  for (auto &mapping : getProcessorFeatureMappings(targetTriple)) {
+    if (!subtargetInfo->checkFeatures(mapping.llvmFeature)) continue;
+    if (!features.empty()) features += ",";
+    features += mapping.llvmFeature;
+  }
+  return features;
+}
+
+// Returns the memory hierarchy and vector unit of |cpu| with |cpuFeatures| on
+// |targetTriple| used to select tile sizes during code generation. Cache sizes
+// come from the known CPUs below and vector units from the CPU features.
+CPUTargetDescription getCPUTargetDescription(const llvm::Triple &targetTriple,
+                                             StringRef cpu,
+                                             StringRef cpuFeatures) {
+  struct CPUCacheSizes {
+    const char *cpu;
+    int64_t l1CacheSizeKiB;
+    int64_t l2CacheSizeKiB;
+    int64_t llcSizeKiB;
+  };
+  static const CPUCacheSizes kCPUCacheSizes[] = {
+      // x86-64; last-level cache sizes are per core.
+      {"haswell", 32, 256, 2560},
+      {"broadwell", 32, 256, 2560},
+      {"skylake", 32, 256, 2048},
+      {"skylake-avx512", 32, 1024, 1408},
+      {"cascadelake", 32, 1024, 1408},
+      {"icelake-server", 48, 1280, 1536},
+      {"sapphirerapids", 48, 2048, 1920},
+      {"znver1", 32, 512, 2048},
+      {"znver2", 32, 512, 4096},
+      {"znver3", 32, 512, 4096},
+      // AArch64; last-level cache sizes are per core.
+      {"cortex-a53", 32, 128, 128},
+      {"cortex-a55", 32, 128, 512},
+      {"cortex-a72", 32, 512, 512},
+      {"cortex-a76", 64, 256, 1024},
+      {"neoverse-n1", 64, 1024, 1024},
+      {"neoverse-v1", 64, 1024, 1024},
+  };
+
+  CPUTargetDescription description;
+  if (targetTriple.isAArch64()) {
+    // Conservative defaults for small-cache cores.
+    description.l2CacheSize = 128 * 1024;
+    description.llcSize = 512 * 1024;
+  }
+  for (auto &cacheSizes : kCPUCacheSizes) {
+    if (cpu == cacheSizes.cpu) {
+      description.l1CacheSize = cacheSizes.l1CacheSizeKiB * 1024;
+      description.l2CacheSize = cacheSizes.l2CacheSizeKiB * 1024;
+      description.llcSize = cacheSizes.llcSizeKiB * 1024;
+      break;
+    }
+  }
+
+  auto subtargetInfo = createSubtargetInfo(targetTriple, cpu, cpuFeatures);
+  auto hasFeature = [&](StringRef feature) {
+    return subtargetInfo && subtargetInfo->checkFeatures(feature);
+  };
+  if (targetTriple.getArch() == llvm::Triple::x86_64) {
+    if (hasFeature("+avx512f")) {
+      description.vectorSize = 64;
+      description.numVectorRegisters = 32;
+    } else if (hasFeature("+avx")) {
+      description.vectorSize = 32;
+      description.numVectorRegisters = 16;
+    }
+  } else if (targetTriple.isAArch64()) {
+    description.vectorSize = 16;
+    description.numVectorRegisters = 32;
+  }
+  return description;
+}
+
+// Returns the target description of the baseline CPU in |options|. Sizes set
+// explicitly in |options| take precedence over those derived from the CPU.
+CPUTargetDescription getCPUTargetDescription(
+    const LLVMTargetOptions &options) {
+  CPUTargetDescription description =
+      getCPUTargetDescription(llvm::Triple(options.targetTriple),
+                              options.targetCPU, options.targetCPUFeatures);
+  if (options.targetL1CacheSize) {
+    description.l1CacheSize = options.targetL1CacheSize;
+  }
+  if (options.targetL2CacheSize) {
+    description.l2CacheSize = options.targetL2CacheSize;
+  }
+  if (options.targetLLCSize) description.llcSize = options.targetLLCSize;
+  if (options.targetVectorSize) {
+    description.vectorSize = options.targetVectorSize;
+  }
+  if (options.targetNumVectorRegisters) {
+    description.numVectorRegisters = options.targetNumVectorRegisters;
+  }
+  return description;
+}
+
+// Returns the alignment of embedded ELF data within the module file. This
+// matches the default maximum page size lld aligns segment file offsets to so
+// that any host page size up to it can map the segments directly.
+int64_t getEmbeddedELFAlignment(const llvm::Triple &targetTriple) {
+  return targetTriple.isAArch64() ? 64 * 1024 : 4 * 1024;
+}
+
+// Returns the name of the module and library compiled for the CPU variant at
+// |index| in LLVMTargetOptions::targetVariants.
+std::string getVariantName(size_t index) {
+  return llvm::formatv("variant{0}", index).str();
+}
+
+// Adds the passes lowering a hal.executable.target to the LLVM dialect with
+// tile sizes and vector widths selected for |targetDescription|. Variants also
+// pass |baseTargetDescription| to keep the workgroup tiles of the baseline.
+void buildLLVMLoweringPassPipeline(
+    OpPassManager &passManager, const LLVMTargetOptions &options,
+    const CPUTargetDescription &targetDescription,
+    Optional<CPUTargetDescription> baseTargetDescription = llvm::None) {
+  passManager.addPass(createLowerExecutableTargetPass(
+      /*lowerToVectors=*/true, targetDescription, baseTargetDescription));
+  // Set target specific options.
+  // TODO(ataei): This is temporary here, should move when target specific
+  // overrides options grows.
+  llvm::Triple triple(options.targetTriple);
+  LLVMTransformPassPipelineOptions codeGenOptions;
+  if (triple.isWasm()) {
+    codeGenOptions.unfuseFMAOps = true;
+  }
+  buildLLVMTransformPassPipeline(passManager, codeGenOptions);
+}
+
+// Lowers a hal.executable.target for the baseline CPU and for each CPU variant
+// in the options. Variants are lowered from a copy of the target made before
+// the baseline is lowered so that tile sizes and vector widths are selected
+// for each CPU. The lowered module of each variant is added to the target as
+// `module @variantN` next to the baseline module.
+class LowerCPUVariantsPass
+    : public PassWrapper<LowerCPUVariantsPass,
+                         OperationPass<IREE::HAL::ExecutableTargetOp>> {
+ public:
+  explicit LowerCPUVariantsPass(LLVMTargetOptions options)
+      : options(std::move(options)) {}
+
+  void getDependentDialects(DialectRegistry &registry) const override {
+    OpPassManager pipeline(IREE::HAL::ExecutableTargetOp::getOperationName());
+    buildLLVMLoweringPassPipeline(pipeline, options,
+                                  getCPUTargetDescription(options));
+    pipeline.getDependentDialects(registry);
+  }
+
+  void runOnOperation() override {
+    auto targetOp = getOperation();
+    auto executableOp = targetOp->getParentOfType<IREE::HAL::ExecutableOp>();
+    llvm::Triple targetTriple(options.targetTriple);
+    CPUTargetDescription baseDescription = getCPUTargetDescription(options);
+
+    // Copy the target along with the interfaces it references into a
+    // standalone module per variant before anything is lowered.
+    SmallVector<OwningModuleRef, 2> variantModuleOps;
+    SmallVector<IREE::HAL::ExecutableTargetOp, 2> variantTargetOps;
+    for (size_t i = 0; i < options.targetVariants.size(); ++i) {
+      OwningModuleRef variantModuleOp(ModuleOp::create(targetOp.getLoc()));
+      auto builder = OpBuilder::atBlockBegin(variantModuleOp->getBody());
+      auto variantExecutableOp = builder.create<IREE::HAL::ExecutableOp>(
+          executableOp.getLoc(),
+          llvm::formatv("{0}_{1}", executableOp.getName(), getVariantName(i))
+              .str());
+      builder.setInsertionPointToStart(variantExecutableOp.getBody());
+      for (auto interfaceOp : executableOp.getOps<IREE::HAL::InterfaceOp>()) {
+        builder.clone(*interfaceOp.getOperation());
+      }
+      variantTargetOps.push_back(cast<IREE::HAL::ExecutableTargetOp>(
+          builder.clone(*targetOp.getOperation())));
+      variantModuleOps.push_back(std::move(variantModuleOp));
+    }
+
+    OpPassManager basePipeline(
+        IREE::HAL::ExecutableTargetOp::getOperationName());
+    buildLLVMLoweringPassPipeline(basePipeline, options, baseDescription);
+    if (failed(runPipeline(basePipeline, targetOp))) {
+      return signalPassFailure();
+    }
+
+    for (auto it : llvm::enumerate(options.targetVariants)) {
+      const auto &targetVariant = it.value();
+      PassManager passManager(&getContext());
+      OpPassManager &variantPipeline =
+          passManager.nest<IREE::HAL::ExecutableOp>()
+              .nest<IREE::HAL::ExecutableTargetOp>();
+      buildLLVMLoweringPassPipeline(
+          variantPipeline, options,
+          getCPUTargetDescription(targetTriple, targetVariant.targetCPU,
+                                  targetVariant.targetCPUFeatures),
+          baseDescription);
+      if (failed(passManager.run(*variantModuleOps[it.index()]))) {
+        targetOp.emitError() << "failed to lower the executable for CPU "
+                                "variant '"
+                             << targetVariant.targetCPU << "'";
+        return signalPassFailure();
+      }
+      auto variantInnerModuleOp =
+          variantTargetOps[it.index()].getInnerModule();
+      variantInnerModuleOp->setAttr(
+          SymbolTable::getSymbolAttrName(),
+          StringAttr::get(&getContext(), getVariantName(it.index())));
+      variantInnerModuleOp->moveBefore(&targetOp.getBlock().back());
+    }
+  }
+
+ private:
+  LLVMTargetOptions options;
+};
+
 }  // namespace
 
 class LLVMAOTTargetBackend final : public TargetBackend {
@@ -73,16 +367,12 @@ class LLVMAOTTargetBackend final : public TargetBackend {
   }
 
   void buildTranslationPassPipeline(OpPassManager &passManager) override {
-    passManager.addPass(createLowerExecutableTargetPass());
-    // Set target specific options.
-    // TODO(ataei): This is temporary here, should move when target specific
-    // overrides options grows.
-    llvm::Triple triple(options_.targetTriple);
-    LLVMTransformPassPipelineOptions codeGenOptions;
-    if (triple.isWasm()) {
-      codeGenOptions.unfuseFMAOps = true;
+    if (!options_.targetVariants.empty()) {
+      passManager.addPass(std::make_unique<LowerCPUVariantsPass>(options_));
+      return;
     }
-    buildLLVMTransformPassPipeline(passManager, codeGenOptions);
+    buildLLVMLoweringPassPipeline(passManager, options_,
+                                  getCPUTargetDescription(options_));
   }
 
   LogicalResult linkExecutables(mlir::ModuleOp moduleOp) override {
@@ -109,17 +399,21 @@ class LLVMAOTTargetBackend final : public TargetBackend {
           continue;
         }
 
-        auto sourceModuleOp = targetOp.getInnerModule();
-        for (auto globalOp : sourceModuleOp.getOps<LLVM::GlobalOp>()) {
-          if (globalOp.linkage() != LLVM::Linkage::Private) {
-            continue;
+        // Modules compiled for CPU variants are linked separately from the
+        // baseline module but need unique names all the same.
+        for (auto sourceModuleOp : targetOp.getBlock().getOps<ModuleOp>()) {
+          for (auto globalOp : sourceModuleOp.getOps<LLVM::GlobalOp>()) {
+            if (globalOp.linkage() != LLVM::Linkage::Private) {
+              continue;
+            }
+            auto disambiguateName =
+                llvm::formatv("{0}_{1}", globalOp.sym_name(), moduleNumber)
+                    .str();
+            SymbolTableCollection symbolTable;
+            SymbolUserMap symbolUsers(symbolTable, sourceModuleOp);
+            symbolUsers.replaceAllUsesWith(globalOp, disambiguateName);
+            SymbolTable::setSymbolName(globalOp, disambiguateName);
           }
-          auto disambiguateName =
-              llvm::formatv("{0}_{1}", globalOp.sym_name(), moduleNumber).str();
-          SymbolTableCollection symbolTable;
-          SymbolUserMap symbolUsers(symbolTable, sourceModuleOp);
-          symbolUsers.replaceAllUsesWith(globalOp, disambiguateName);
-          SymbolTable::setSymbolName(globalOp, disambiguateName);
         }
         moduleNumber++;
       }
@@ -179,6 +473,78 @@ class LLVMAOTTargetBackend final : public TargetBackend {
                                      "dialect to the native llvm::Module";
     }
 
+    // Link in the code compiled for each CPU variant. Definitions of a variant
+    // are suffixed with its name to keep them apart from the baseline and only
+    // its entry points are reachable from the library.
+    struct Variant {
+      std::string name;
+      uint64_t requiredFeatures;
+      SmallVector<llvm::Function *, 4> funcs;
+    };
+    SmallVector<Variant, 2> variants;
+    for (auto it : llvm::enumerate(options_.targetVariants)) {
+      const auto &targetVariant = it.value();
+      Variant variant;
+      variant.name = getVariantName(it.index());
+      variant.requiredFeatures =
+          getProcessorFeatures(targetTriple, targetVariant.targetCPU,
+                               targetVariant.targetCPUFeatures);
+      std::string variantCPUFeatures =
+          getVariantCPUFeatures(options_, targetVariant);
+      auto variantModuleOp = dyn_cast_or_null<ModuleOp>(
+          SymbolTable::lookupSymbolIn(targetOp, variant.name));
+      if (!variantModuleOp) {
+        return targetOp.emitError()
+               << "missing code for CPU variant '" << targetVariant.targetCPU
+               << "'";
+      }
+      variantModuleOp->setAttr(
+          LLVM::LLVMDialect::getTargetTripleAttrName(),
+          executableBuilder.getStringAttr(targetTriple.str()));
+      auto variantLLVMModule = mlir::translateModuleToLLVMIR(
+          variantModuleOp, context, libraryName + "_" + variant.name);
+      if (!variantLLVMModule) {
+        return targetOp.emitError()
+               << "failed to translate the MLIR LLVM dialect of CPU variant '"
+               << targetVariant.targetCPU << "' to the native llvm::Module";
+      }
+      SmallVector<std::string, 4> definitionNames;
+      auto suffixDefinition = [&](llvm::GlobalValue &value) {
+        if (value.isDeclaration() || value.hasLocalLinkage()) return;
+        value.setName(value.getName() + "_" + variant.name);
+        definitionNames.push_back(value.getName().str());
+      };
+      for (auto &func : *variantLLVMModule) {
+        if (func.isDeclaration()) continue;
+        func.addFnAttr("target-cpu", options_.targetCPU);
+        func.addFnAttr("tune-cpu", targetVariant.targetCPU);
+        if (!variantCPUFeatures.empty()) {
+          func.addFnAttr("target-features", variantCPUFeatures);
+        }
+        suffixDefinition(func);
+      }
+      for (auto &global : variantLLVMModule->globals()) {
+        suffixDefinition(global);
+      }
+      if (llvm::Linker::linkModules(*llvmModule,
+                                    std::move(variantLLVMModule))) {
+        return targetOp.emitError()
+               << "failed to link the code of CPU variant '"
+               << targetVariant.targetCPU << "'";
+      }
+      for (auto &definitionName : definitionNames) {
+        auto *value = llvmModule->getNamedValue(definitionName);
+        value->setLinkage(llvm::GlobalValue::LinkageTypes::InternalLinkage);
+        value->setDSOLocal(true);
+      }
+      for (auto entryPointOp :
+           targetOp.getBlock().getOps<ExecutableEntryPointOp>()) {
+        variant.funcs.push_back(llvmModule->getFunction(
+            (entryPointOp.getName() + "_" + variant.name).str()));
+      }
+      variants.push_back(std::move(variant));
+    }
+
     // Configure the functions in the module. This may override defaults set
     // during the MLIR->LLVM conversion.
     for (auto &func : *llvmModule) {
@@ -197,7 +563,7 @@ class LLVMAOTTargetBackend final : public TargetBackend {
     // find the entry point functions and their information.
     LibraryBuilder libraryBuilder(
         llvmModule.get(), LibraryBuilder::Mode::INCLUDE_REFLECTION_ATTRS,
-        LibraryBuilder::Version::V_0);
+        LibraryBuilder::Version::V_0_4);
     switch (options_.sanitizerKind) {
       case SanitizerKind::kNone: {
         libraryBuilder.setSanitizerKind(LibraryBuilder::SanitizerKind::NONE);
@@ -210,12 +576,42 @@ class LLVMAOTTargetBackend final : public TargetBackend {
         }
       } break;
     }
+    switch (options_.executablePreparation) {
+      case ExecutablePreparation::kEager:
+        libraryBuilder.setPreparation(LibraryBuilder::Preparation::EAGER);
+        break;
+      case ExecutablePreparation::kDeferred:
+        libraryBuilder.setPreparation(LibraryBuilder::Preparation::DEFERRED);
+        break;
+      case ExecutablePreparation::kAsync:
+        libraryBuilder.setPreparation(LibraryBuilder::Preparation::ASYNC);
+        break;
+    }
     for (auto entryPointOp :
          targetOp.getBlock().getOps<ExecutableEntryPointOp>()) {
       auto *llvmFunc = llvmModule->getFunction(entryPointOp.getName());
       llvmFunc->setLinkage(llvm::GlobalValue::LinkageTypes::InternalLinkage);
       llvmFunc->setDSOLocal(true);
-      libraryBuilder.addEntryPoint(entryPointOp.getName(), "", llvmFunc);
+
+      // Advertise the workgroup size the entry point was compiled for and how
+      // many workgroups a processor should take at a time (selected from the
+      // working set of the workgroup tiles) so that the runtime can schedule
+      // around them.
+      LibraryBuilder::DispatchAttrs dispatchAttrs;
+      if (auto workgroupSizeAttr = entryPointOp.workgroup_sizeAttr()) {
+        for (auto it : llvm::enumerate(workgroupSizeAttr)) {
+          dispatchAttrs.workgroupSize[it.index()] =
+              it.value().cast<IntegerAttr>().getInt();
+        }
+      }
+      dispatchAttrs.workgroupsPerReservation =
+          getWorkgroupsPerReservation(entryPointOp);
+      libraryBuilder.addEntryPoint(entryPointOp.getName(), "", llvmFunc,
+                                   dispatchAttrs);
+    }
+    for (auto &variant : variants) {
+      libraryBuilder.addVariant(variant.name, variant.requiredFeatures,
+                                variant.funcs);
     }
     auto *queryLibraryFunc =
         libraryBuilder.build("iree_hal_executable_library_query");
@@ -252,6 +648,9 @@ class LLVMAOTTargetBackend final : public TargetBackend {
     }
     llvmModule->setDataLayout(targetMachine->createDataLayout());
     llvmModule->setTargetTriple(targetMachine->getTargetTriple().str());
+    if (options_.printLibraryIR) {
+      llvmModule->print(llvm::errs(), /*AAW=*/nullptr);
+    }
     if (failed(
             runLLVMIRPasses(options_, targetMachine.get(), llvmModule.get()))) {
       return targetOp.emitError()
@@ -316,6 +715,12 @@ class LLVMAOTTargetBackend final : public TargetBackend {
           bufferAttr);
       binaryOp.mime_typeAttr(
           executableBuilder.getStringAttr("application/x-elf"));
+
+      // Align the ELF in the module file to the maximum page size the linker
+      // aligned segments to. When the module file is mapped the runtime can
+      // then map the segments directly from the file instead of copying them.
+      binaryOp.alignmentAttr(executableBuilder.getI64IntegerAttr(
+          getEmbeddedELFAlignment(targetTriple)));
     } else {
       FlatbufferBuilder builder;
       iree_DyLibExecutableDef_start_as_root(builder);
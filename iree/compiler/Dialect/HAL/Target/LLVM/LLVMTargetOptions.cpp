@@ -67,6 +67,43 @@ LLVMTargetOptions getLLVMTargetOptionsFromFlags() {
                      "host native CPU"),
       llvm::cl::init(""));
 
+  static llvm::cl::list<std::string> clTargetCPUVariants(
+      "iree-llvm-target-cpu-variants",
+      llvm::cl::desc(
+          "Additional LLVM target machine CPUs to compile each executable for "
+          "in order of preference, such as `skylake-avx512,haswell`. Each may "
+          "add features as `cpu:+feature+feature`. The runtime selects the "
+          "first variant supported by the host and otherwise uses the "
+          "--iree-llvm-target-cpu configuration"),
+      llvm::cl::CommaSeparated);
+
+  static llvm::cl::opt<unsigned> clTargetL1CacheSize(
+      "iree-llvm-target-l1-cache-size",
+      llvm::cl::desc("Size in bytes of the L1 data cache of the target CPU; "
+                     "derived from the target CPU when 0"),
+      llvm::cl::init(0));
+  static llvm::cl::opt<unsigned> clTargetL2CacheSize(
+      "iree-llvm-target-l2-cache-size",
+      llvm::cl::desc("Size in bytes of the L2 cache of the target CPU; "
+                     "derived from the target CPU when 0"),
+      llvm::cl::init(0));
+  static llvm::cl::opt<unsigned> clTargetLLCSize(
+      "iree-llvm-target-llc-size",
+      llvm::cl::desc("Size in bytes of the last-level cache available to each "
+                     "core of the target CPU; derived from the target CPU "
+                     "when 0"),
+      llvm::cl::init(0));
+  static llvm::cl::opt<unsigned> clTargetVectorSize(
+      "iree-llvm-target-vector-size",
+      llvm::cl::desc("Width in bytes of the vector registers of the target "
+                     "CPU; derived from the target CPU features when 0"),
+      llvm::cl::init(0));
+  static llvm::cl::opt<unsigned> clTargetNumVectorRegisters(
+      "iree-llvm-target-num-vector-registers",
+      llvm::cl::desc("Number of vector registers of the target CPU; derived "
+                     "from the target CPU features when 0"),
+      llvm::cl::init(0));
+
   static llvm::cl::opt<bool> llvmLoopInterleaving(
       "iree-llvm-loop-interleaving", llvm::cl::init(false),
       llvm::cl::desc("Enable LLVM loop interleaving opt"));
@@ -87,6 +124,28 @@ LLVMTargetOptions getLLVMTargetOptionsFromFlags() {
   if (clTargetCPUFeatures != "host") {
     llvmTargetOptions.targetCPUFeatures = clTargetCPUFeatures;
   }
+  for (auto &variantSpec : clTargetCPUVariants) {
+    // `cpu:+a+b-c` -> {cpu, "+a,+b,-c"}
+    auto cpuAndFeatures = llvm::StringRef(variantSpec).split(':');
+    LLVMTargetVariant variant;
+    variant.targetCPU = cpuAndFeatures.first.str();
+    llvm::StringRef features = cpuAndFeatures.second;
+    while (!features.empty()) {
+      size_t end = features.find_first_of("+-", /*From=*/1);
+      if (!variant.targetCPUFeatures.empty()) {
+        variant.targetCPUFeatures += ",";
+      }
+      variant.targetCPUFeatures += features.substr(0, end).str();
+      features = features.substr(end);
+    }
+    llvmTargetOptions.targetVariants.push_back(std::move(variant));
+  }
+
+  llvmTargetOptions.targetL1CacheSize = clTargetL1CacheSize;
+  llvmTargetOptions.targetL2CacheSize = clTargetL2CacheSize;
+  llvmTargetOptions.targetLLCSize = clTargetLLCSize;
+  llvmTargetOptions.targetVectorSize = clTargetVectorSize;
+  llvmTargetOptions.targetNumVectorRegisters = clTargetNumVectorRegisters;
 
   // LLVM opt options.
   llvmTargetOptions.pipelineTuningOptions.LoopInterleaving =
@@ -104,6 +163,19 @@ LLVMTargetOptions getLLVMTargetOptionsFromFlags() {
                                   "Address sanitizer support")));
   llvmTargetOptions.sanitizerKind = clSanitizerKind;
 
+  static llvm::cl::opt<ExecutablePreparation> clExecutablePreparation(
+      "iree-llvm-executable-preparation",
+      llvm::cl::desc("Hint for when the runtime should prepare executables"),
+      llvm::cl::init(llvmTargetOptions.executablePreparation),
+      llvm::cl::values(
+          clEnumValN(ExecutablePreparation::kEager, "eager",
+                     "Prepare executables when they are created"),
+          clEnumValN(ExecutablePreparation::kDeferred, "deferred",
+                     "Prepare executables before their first dispatch"),
+          clEnumValN(ExecutablePreparation::kAsync, "async",
+                     "Prepare executables in the background")));
+  llvmTargetOptions.executablePreparation = clExecutablePreparation;
+
   static llvm::cl::opt<std::string> clTargetABI(
       "iree-llvm-target-abi",
       llvm::cl::desc("LLVM target machine ABI; specify for -mabi"),
@@ -150,6 +222,13 @@ LLVMTargetOptions getLLVMTargetOptionsFromFlags() {
       llvm::cl::init(llvmTargetOptions.keepLinkerArtifacts));
   llvmTargetOptions.keepLinkerArtifacts = clKeepLinkerArtifacts;
 
+  static llvm::cl::opt<bool> clPrintLibraryIR(
+      "iree-llvm-print-library-ir",
+      llvm::cl::desc("Print the LLVM IR of each executable library to stderr "
+                     "before optimization"),
+      llvm::cl::init(llvmTargetOptions.printLibraryIR));
+  llvmTargetOptions.printLibraryIR = clPrintLibraryIR;
+
   return llvmTargetOptions;
 }
 
@@ -7,6 +7,10 @@
 #ifndef IREE_COMPILER_DIALECT_HAL_TARGET_LLVM_LLVMTARGETOPTIONS_H_
 #define IREE_COMPILER_DIALECT_HAL_TARGET_LLVM_LLVMTARGETOPTIONS_H_
 
+#include <cstdint>
+#include <string>
+#include <vector>
+
 #include "llvm/Passes/PassBuilder.h"
 #include "llvm/Target/TargetOptions.h"
 
@@ -22,12 +26,45 @@ enum class SanitizerKind {
   kAddress,
 };
 
+// When the runtime should prepare executables for execution.
+enum class ExecutablePreparation {
+  // Prepared when created.
+  kEager = 0,
+  // Prepared before the first dispatch using the executable is recorded.
+  kDeferred,
+  // Prepared in the background after being created.
+  kAsync,
+};
+
+// Additional CPU configuration an executable is compiled for alongside the
+// baseline targetCPU/targetCPUFeatures. Variants are tuned for targetCPU but
+// only use the baseline features plus those the runtime can detect on the
+// host (AVX/AVX2/FMA/F16C/AVX-512 on x86-64 and dotprod/fp16 on arm64).
+struct LLVMTargetVariant {
+  std::string targetCPU;
+  std::string targetCPUFeatures;
+};
+
 struct LLVMTargetOptions {
   // Target machine configuration.
   std::string targetTriple;
   std::string targetCPU;
   std::string targetCPUFeatures;
 
+  // Additional variants of each executable compiled into the same binary in
+  // order of preference. The runtime selects the first variant supported by
+  // the host processor and otherwise uses the baseline configuration.
+  std::vector<LLVMTargetVariant> targetVariants;
+
+  // Memory hierarchy and vector unit of the target CPU used to select tile
+  // sizes during code generation. Values of 0 are derived from the target
+  // triple, CPU, and CPU features.
+  int64_t targetL1CacheSize = 0;
+  int64_t targetL2CacheSize = 0;
+  int64_t targetLLCSize = 0;
+  int64_t targetVectorSize = 0;
+  int64_t targetNumVectorRegisters = 0;
+
   llvm::PipelineTuningOptions pipelineTuningOptions;
   llvm::PassBuilder::OptimizationLevel optLevel;
   llvm::TargetOptions options;
@@ -41,6 +78,12 @@ struct LLVMTargetOptions {
   // Sanitizer Kind for CPU Kernels
   SanitizerKind sanitizerKind = SanitizerKind::kNone;
 
+  // Hint embedded in each executable for when the runtime should prepare it.
+  // Deferring reduces load time for programs with many executables that may
+  // not all be used at the cost of reporting load errors on first dispatch.
+  // Currently only read by the runtime when linking embedded ELFs.
+  ExecutablePreparation executablePreparation = ExecutablePreparation::kEager;
+
   // Build for the IREE embedded platform-agnostic ELF loader.
   bool linkEmbedded = false;
 
@@ -51,6 +94,10 @@ struct LLVMTargetOptions {
 
   // True to keep linker artifacts for debugging.
   bool keepLinkerArtifacts = false;
+
+  // True to print the LLVM IR of each library, including the library query
+  // function, before optimization for debugging.
+  bool printLibraryIR = false;
 };
 
 // Returns LLVMTargetOptions struct intialized with the iree-llvm-* flags.
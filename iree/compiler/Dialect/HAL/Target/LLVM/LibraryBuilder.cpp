@@ -31,8 +31,8 @@ namespace HAL {
 // on the executable_library.h header: https://godbolt.org/z/6bMv5jfvf
 
 // %struct.iree_hal_executable_import_table_v0_t = type {
-//   i64,
-//   i8*
+//   i32,
+//   i8**
 // }
 static llvm::StructType *makeImportTableType(llvm::LLVMContext &context) {
   if (auto *existingType = llvm::StructType::getTypeByName(
@@ -40,11 +40,11 @@ static llvm::StructType *makeImportTableType(llvm::LLVMContext &context) {
     return existingType;
   }
   auto *i8PtrType = llvm::IntegerType::getInt8PtrTy(context);
-  auto *i64Type = llvm::IntegerType::getInt64Ty(context);
+  auto *i32Type = llvm::IntegerType::getInt32Ty(context);
   auto *type = llvm::StructType::create(context,
                                         {
-                                            i64Type,
-                                            i8PtrType,
+                                            i32Type,
+                                            i8PtrType->getPointerTo(),
                                         },
                                         "iree_hal_executable_import_table_v0_t",
                                         /*isPacked=*/false);
@@ -78,7 +78,8 @@ static llvm::StructType *makeVec3Type(llvm::LLVMContext &context) {
 //   i64,
 //   i8**,
 //   i64*,
-//   %struct.iree_hal_executable_import_table_v0_t*
+//   i32 (i8*)**,
+//   ...
 // }
 static llvm::StructType *makeDispatchStateType(llvm::LLVMContext &context) {
   auto *type = llvm::StructType::getTypeByName(
@@ -127,13 +128,57 @@ static llvm::StructType *makeLibraryHeaderType(llvm::LLVMContext &context) {
   return type;
 }
 
+// %struct.iree_hal_executable_dispatch_attrs_v0_t = type {
+//   %union.iree_hal_vec3_t,
+//   i32
+// }
+static llvm::StructType *makeDispatchAttrsType(llvm::LLVMContext &context) {
+  if (auto *existingType = llvm::StructType::getTypeByName(
+          context, "iree_hal_executable_dispatch_attrs_v0_t")) {
+    return existingType;
+  }
+  auto *i32Type = llvm::IntegerType::getInt32Ty(context);
+  auto *type =
+      llvm::StructType::create(context,
+                               {
+                                   makeVec3Type(context),
+                                   i32Type,
+                               },
+                               "iree_hal_executable_dispatch_attrs_v0_t",
+                               /*isPacked=*/false);
+  return type;
+}
+
+// %struct.iree_hal_executable_library_hints_v0_t = type {
+//   i32,
+//   i32
+// }
+static llvm::StructType *makeLibraryHintsType(llvm::LLVMContext &context) {
+  if (auto *existingType = llvm::StructType::getTypeByName(
+          context, "iree_hal_executable_library_hints_v0_t")) {
+    return existingType;
+  }
+  auto *i32Type = llvm::IntegerType::getInt32Ty(context);
+  auto *type =
+      llvm::StructType::create(context,
+                               {
+                                   i32Type,
+                                   i32Type,
+                               },
+                               "iree_hal_executable_library_hints_v0_t",
+                               /*isPacked=*/false);
+  return type;
+}
+
 // %struct.iree_hal_executable_library_v0_t = type {
 //   %struct.iree_hal_executable_library_header_t*,
 //   i32,
 //   i32 (%struct.iree_hal_executable_dispatch_state_v0_t*,
 //        %union.iree_hal_vec3_t*)**,
 //   i8**,
-//   i8**
+//   i8**,
+//   %struct.iree_hal_executable_dispatch_attrs_v0_t*,
+//   %struct.iree_hal_executable_import_table_v0_t
 // }
 static llvm::StructType *makeLibraryType(llvm::StructType *libraryHeaderType) {
   auto &context = libraryHeaderType->getContext();
@@ -143,6 +188,8 @@ static llvm::StructType *makeLibraryType(llvm::StructType *libraryHeaderType) {
   }
   auto *i32Type = llvm::IntegerType::getInt32Ty(context);
   auto *dispatchFunctionType = makeDispatchFunctionType(context);
+  auto *dispatchAttrsType = makeDispatchAttrsType(context);
+  auto *importTableType = makeImportTableType(context);
   auto *i8PtrType = llvm::IntegerType::getInt8PtrTy(context);
   auto *type = llvm::StructType::create(
       context,
@@ -152,6 +199,8 @@ static llvm::StructType *makeLibraryType(llvm::StructType *libraryHeaderType) {
           dispatchFunctionType->getPointerTo()->getPointerTo(),
           i8PtrType->getPointerTo(),
           i8PtrType->getPointerTo(),
+          dispatchAttrsType->getPointerTo(),
+          importTableType,
       },
       "iree_hal_executable_library_v0_t",
       /*isPacked=*/false);
@@ -209,23 +258,147 @@ llvm::Function *LibraryBuilder::build(StringRef queryFuncName) {
   auto *entryBlock = llvm::BasicBlock::Create(context, "entry", func);
   llvm::IRBuilder<> builder(entryBlock);
 
+  auto *v0 = buildLibraryV0((queryFuncName + "_v0").str());
+  if (preparation != Preparation::EAGER) buildHintsV0();
+
+  // Select the first variant supported by the environment, if any:
+  //   if (max_version >= V_0_4 && environment) {
+  //     if ((environment->processor_features & a_features) == a_features) {
+  //       return &library_a;
+  //     }
+  //     ...
+  //   }
+  if (static_cast<uint32_t>(version) >=
+          static_cast<uint32_t>(Version::V_0_4) &&
+      !variants.empty()) {
+    auto *i64Type = llvm::IntegerType::getInt64Ty(context);
+    auto *fallbackBlock = llvm::BasicBlock::Create(context, "fallback", func);
+    auto *selectBlock = llvm::BasicBlock::Create(context, "select", func);
+    builder.CreateCondBr(
+        builder.CreateAnd(
+            builder.CreateICmpUGE(
+                func->getArg(0),
+                llvm::ConstantInt::get(
+                    i32Type, static_cast<int64_t>(Version::V_0_4))),
+            builder.CreateIsNotNull(func->getArg(1))),
+        selectBlock, fallbackBlock);
+
+    // iree_hal_executable_environment_v0_t::processor_features is the first
+    // field of the environment.
+    builder.SetInsertPoint(selectBlock);
+    auto *processorFeatures = builder.CreateLoad(
+        i64Type,
+        builder.CreatePointerCast(func->getArg(1), i64Type->getPointerTo()));
+    for (auto &variant : variants) {
+      auto *variantLibrary = buildLibraryV0Variant(
+          v0, (queryFuncName + "_v0_" + variant.name).str(), variant);
+      auto *requiredFeatures =
+          llvm::ConstantInt::get(i64Type, variant.requiredFeatures);
+      auto *selectedBlock = llvm::BasicBlock::Create(
+          context, "select_" + variant.name, func);
+      auto *nextBlock = llvm::BasicBlock::Create(context, "next", func);
+      builder.CreateCondBr(
+          builder.CreateICmpEQ(
+              builder.CreateAnd(processorFeatures, requiredFeatures),
+              requiredFeatures),
+          selectedBlock, nextBlock);
+      builder.SetInsertPoint(selectedBlock);
+      builder.CreateRet(builder.CreatePointerCast(
+          variantLibrary, libraryHeaderType->getPointerTo()));
+      builder.SetInsertPoint(nextBlock);
+    }
+    builder.CreateBr(fallbackBlock);
+    builder.SetInsertPoint(fallbackBlock);
+  }
+
   // Build out the header for each version and select it at runtime.
   // NOTE: today there is just one version so this is rather simple:
-  //   return max_version == 0 ? &library : NULL;
-  auto *v0 = buildLibraryV0((queryFuncName + "_v0").str());
+  //   return max_version >= version ? &library : NULL;
   builder.CreateRet(builder.CreateSelect(
-      builder.CreateICmpEQ(func->getArg(0), llvm::ConstantInt::get(i32Type, 0)),
+      builder.CreateICmpUGE(
+          func->getArg(0),
+          llvm::ConstantInt::get(i32Type, static_cast<int64_t>(version))),
       builder.CreatePointerCast(v0, libraryHeaderType->getPointerTo()),
       llvm::ConstantPointerNull::get(libraryHeaderType->getPointerTo())));
 
   return func;
 }
 
-llvm::Constant *LibraryBuilder::buildLibraryV0(std::string libraryName) {
+llvm::GlobalVariable *LibraryBuilder::buildHintsV0() {
+  auto &context = module->getContext();
+  auto *hintsType = makeLibraryHintsType(context);
+  auto *i32Type = llvm::IntegerType::getInt32Ty(context);
+  auto *hints = new llvm::GlobalVariable(
+      *module, hintsType, /*isConstant=*/true,
+      llvm::GlobalVariable::ExternalLinkage,
+      llvm::ConstantStruct::get(
+          hintsType,
+          {
+              // version=
+              llvm::ConstantInt::get(i32Type, 0),
+              // preparation=
+              llvm::ConstantInt::get(i32Type,
+                                     static_cast<uint32_t>(preparation)),
+          }),
+      /*Name=*/"iree_hal_executable_library_hints");
+  // The runtime finds the hints by section name without loading the library.
+  // The export keeps the section alive when the linker drops unused sections.
+  hints->setSection(".iree.hints");
+  hints->setVisibility(llvm::GlobalValue::VisibilityTypes::DefaultVisibility);
+  hints->setAlignment(llvm::MaybeAlign(4));
+  return hints;
+}
+
+llvm::Constant *LibraryBuilder::buildEntryPointFuncs(
+    std::string libraryName, ArrayRef<llvm::Function *> funcs) {
+  auto &context = module->getContext();
+  auto *dispatchFunctionType = makeDispatchFunctionType(context);
+  auto *i32Type = llvm::IntegerType::getInt32Ty(context);
+  llvm::Constant *zero = llvm::ConstantInt::get(i32Type, 0);
+
+  SmallVector<llvm::Constant *, 4> entryPointFuncValues;
+  for (auto *func : funcs) {
+    entryPointFuncValues.push_back(func);
+  }
+  auto *entryPointFuncsType = llvm::ArrayType::get(
+      dispatchFunctionType->getPointerTo(), entryPointFuncValues.size());
+  llvm::Constant *entryPointFuncs = new llvm::GlobalVariable(
+      *module, entryPointFuncsType, /*isConstant=*/true,
+      llvm::GlobalVariable::PrivateLinkage,
+      llvm::ConstantArray::get(entryPointFuncsType, entryPointFuncValues),
+      /*Name=*/libraryName + "_funcs");
+  // TODO(benvanik): force alignment (16? natural pointer width *2?)
+  return llvm::ConstantExpr::getInBoundsGetElementPtr(
+      entryPointFuncsType, entryPointFuncs,
+      ArrayRef<llvm::Constant *>{zero, zero});
+}
+
+llvm::GlobalVariable *LibraryBuilder::buildLibraryV0Variant(
+    llvm::GlobalVariable *library, std::string libraryName,
+    const Variant &variant) {
+  // Variants share all metadata with the base library and only differ in the
+  // entry point functions.
+  auto *libraryValue =
+      llvm::cast<llvm::ConstantStruct>(library->getInitializer());
+  SmallVector<llvm::Constant *, 8> fieldValues;
+  for (unsigned i = 0; i < libraryValue->getNumOperands(); ++i) {
+    fieldValues.push_back(libraryValue->getOperand(i));
+  }
+  // entry_points=
+  fieldValues[2] = buildEntryPointFuncs(libraryName, variant.funcs);
+  auto *variantLibrary = new llvm::GlobalVariable(
+      *module, libraryValue->getType(), /*isConstant=*/true,
+      llvm::GlobalVariable::PrivateLinkage,
+      llvm::ConstantStruct::get(libraryValue->getType(), fieldValues),
+      /*Name=*/libraryName);
+  // TODO(benvanik): force alignment (8? natural pointer width?)
+  return variantLibrary;
+}
+
+llvm::GlobalVariable *LibraryBuilder::buildLibraryV0(std::string libraryName) {
   auto &context = module->getContext();
   auto *libraryHeaderType = makeLibraryHeaderType(context);
   auto *libraryType = makeLibraryType(libraryHeaderType);
-  auto *dispatchFunctionType = makeDispatchFunctionType(context);
   auto *i8Type = llvm::IntegerType::getInt8Ty(context);
   auto *i32Type = llvm::IntegerType::getInt32Ty(context);
   llvm::Constant *zero = llvm::ConstantInt::get(i32Type, 0);
@@ -239,8 +412,7 @@ llvm::Constant *LibraryBuilder::buildLibraryV0(std::string libraryName) {
           libraryHeaderType,
           {
               // version=
-              llvm::ConstantInt::get(i32Type,
-                                     static_cast<int64_t>(Version::V_0)),
+              llvm::ConstantInt::get(i32Type, static_cast<int64_t>(version)),
               // name=
               getStringConstant(module->getName(), module),
               // features=
@@ -254,21 +426,12 @@ llvm::Constant *LibraryBuilder::buildLibraryV0(std::string libraryName) {
 
   // ----- Entry points -----
 
-  SmallVector<llvm::Constant *, 4> entryPointFuncValues;
+  SmallVector<llvm::Function *, 4> entryPointFuncValues;
   for (auto entryPoint : entryPoints) {
     entryPointFuncValues.push_back(entryPoint.func);
   }
-  auto *entryPointFuncsType = llvm::ArrayType::get(
-      dispatchFunctionType->getPointerTo(), entryPointFuncValues.size());
-  llvm::Constant *entryPointFuncs = new llvm::GlobalVariable(
-      *module, entryPointFuncsType, /*isConstant=*/true,
-      llvm::GlobalVariable::PrivateLinkage,
-      llvm::ConstantArray::get(entryPointFuncsType, entryPointFuncValues),
-      /*Name=*/libraryName + "_funcs");
-  // TODO(benvanik): force alignment (16? natural pointer width *2?)
-  entryPointFuncs = llvm::ConstantExpr::getInBoundsGetElementPtr(
-      entryPointFuncsType, entryPointFuncs,
-      ArrayRef<llvm::Constant *>{zero, zero});
+  llvm::Constant *entryPointFuncs =
+      buildEntryPointFuncs(libraryName, entryPointFuncValues);
 
   llvm::Constant *entryPointNames =
       llvm::Constant::getNullValue(i8Type->getPointerTo());
@@ -311,6 +474,79 @@ llvm::Constant *LibraryBuilder::buildLibraryV0(std::string libraryName) {
         entryPointTagsType, global, ArrayRef<llvm::Constant *>{zero, zero});
   }
 
+  // ----- Dispatch attributes -----
+
+  auto *dispatchAttrsType = makeDispatchAttrsType(context);
+  llvm::Constant *entryPointAttrs =
+      llvm::Constant::getNullValue(dispatchAttrsType->getPointerTo());
+  bool anyNonDefaultAttrs = llvm::any_of(
+      entryPoints, [](const EntryPoint &entryPoint) {
+        return !entryPoint.attrs.isDefault();
+      });
+  if (static_cast<uint32_t>(version) >=
+          static_cast<uint32_t>(Version::V_0_2) &&
+      anyNonDefaultAttrs) {
+    auto *vec3Type = makeVec3Type(context);
+    SmallVector<llvm::Constant *, 4> entryPointAttrValues;
+    for (auto entryPoint : entryPoints) {
+      const auto &attrs = entryPoint.attrs;
+      entryPointAttrValues.push_back(llvm::ConstantStruct::get(
+          dispatchAttrsType,
+          {
+              // workgroup_size=
+              llvm::ConstantStruct::get(
+                  vec3Type,
+                  {
+                      llvm::ConstantInt::get(i32Type, attrs.workgroupSize[0]),
+                      llvm::ConstantInt::get(i32Type, attrs.workgroupSize[1]),
+                      llvm::ConstantInt::get(i32Type, attrs.workgroupSize[2]),
+                  }),
+              // workgroups_per_reservation=
+              llvm::ConstantInt::get(i32Type, attrs.workgroupsPerReservation),
+          }));
+    }
+    auto *entryPointAttrsType =
+        llvm::ArrayType::get(dispatchAttrsType, entryPointAttrValues.size());
+    auto *global = new llvm::GlobalVariable(
+        *module, entryPointAttrsType, /*isConstant=*/true,
+        llvm::GlobalVariable::PrivateLinkage,
+        llvm::ConstantArray::get(entryPointAttrsType, entryPointAttrValues),
+        /*Name=*/libraryName + "_attrs");
+    // TODO(benvanik): force alignment (16? natural pointer width *2?)
+
+    entryPointAttrs = llvm::ConstantExpr::getInBoundsGetElementPtr(
+        entryPointAttrsType, global, ArrayRef<llvm::Constant *>{zero, zero});
+  }
+
+  // ----- Imports -----
+
+  auto *importTableType = makeImportTableType(context);
+  llvm::Constant *importSymbols =
+      llvm::Constant::getNullValue(i8Type->getPointerTo()->getPointerTo());
+  uint32_t importCount = 0;
+  if (static_cast<uint32_t>(version) >=
+          static_cast<uint32_t>(Version::V_0_3) &&
+      !imports.empty()) {
+    SmallVector<llvm::Constant *, 4> importSymbolValues;
+    for (auto import : imports) {
+      // Optional imports are prefixed with `?` as in the runtime header.
+      importSymbolValues.push_back(getStringConstant(
+          import.weak ? "?" + import.symbolName : import.symbolName, module));
+    }
+    auto *importSymbolsType = llvm::ArrayType::get(i8Type->getPointerTo(),
+                                                   importSymbolValues.size());
+    auto *global = new llvm::GlobalVariable(
+        *module, importSymbolsType, /*isConstant=*/true,
+        llvm::GlobalVariable::PrivateLinkage,
+        llvm::ConstantArray::get(importSymbolsType, importSymbolValues),
+        /*Name=*/libraryName + "_import_names");
+    // TODO(benvanik): force alignment (16? natural pointer width *2?)
+
+    importSymbols = llvm::ConstantExpr::getInBoundsGetElementPtr(
+        importSymbolsType, global, ArrayRef<llvm::Constant *>{zero, zero});
+    importCount = static_cast<uint32_t>(importSymbolValues.size());
+  }
+
   // ----- Library -----
 
   auto *library = new llvm::GlobalVariable(
@@ -329,6 +565,17 @@ llvm::Constant *LibraryBuilder::buildLibraryV0(std::string libraryName) {
               entryPointNames,
               // entry_point_tags=
               entryPointTags,
+              // entry_point_attrs=
+              entryPointAttrs,
+              // imports=
+              llvm::ConstantStruct::get(
+                  importTableType,
+                  {
+                      // count=
+                      llvm::ConstantInt::get(i32Type, importCount),
+                      // symbols=
+                      importSymbols,
+                  }),
           }),
       /*Name=*/libraryName);
   // TODO(benvanik): force alignment (8? natural pointer width?)
@@ -45,6 +45,14 @@ class LibraryBuilder {
   enum class Version : uint32_t {
     // IREE_HAL_EXECUTABLE_LIBRARY_VERSION_0
     V_0 = 0u,
+    // IREE_HAL_EXECUTABLE_LIBRARY_VERSION_0_1
+    V_0_1 = 1u,
+    // IREE_HAL_EXECUTABLE_LIBRARY_VERSION_0_2
+    V_0_2 = 2u,
+    // IREE_HAL_EXECUTABLE_LIBRARY_VERSION_0_3
+    V_0_3 = 3u,
+    // IREE_HAL_EXECUTABLE_LIBRARY_VERSION_0_4
+    V_0_4 = 4u,
   };
 
   // iree_hal_executable_library_features_t
@@ -53,6 +61,27 @@ class LibraryBuilder {
     NONE = 0u,
   };
 
+  // iree_hal_processor_feature_bits_t
+  // Bits alias across architectures and are only meaningful for the target
+  // architecture of the library.
+  enum class ProcessorFeatures : uint64_t {
+    // IREE_HAL_PROCESSOR_FEATURE_NONE
+    NONE = 0ull,
+    // IREE_HAL_PROCESSOR_FEATURE_X86_64_*
+    X86_64_AVX = 1ull << 0,
+    X86_64_AVX2 = 1ull << 1,
+    X86_64_FMA = 1ull << 2,
+    X86_64_F16C = 1ull << 3,
+    X86_64_AVX512F = 1ull << 4,
+    X86_64_AVX512BW = 1ull << 5,
+    X86_64_AVX512DQ = 1ull << 6,
+    X86_64_AVX512VL = 1ull << 7,
+    X86_64_AVX512VNNI = 1ull << 8,
+    // IREE_HAL_PROCESSOR_FEATURE_ARM_64_*
+    ARM_64_DOTPROD = 1ull << 0,
+    ARM_64_FP16 = 1ull << 1,
+  };
+
   // iree_hal_executable_library_sanitizer_kind_t
   enum class SanitizerKind : uint32_t {
     // IREE_HAL_EXECUTABLE_LIBRARY_SANITIZER_NONE
@@ -67,6 +96,16 @@ class LibraryBuilder {
     UNDEFINED = 4u,
   };
 
+  // iree_hal_executable_library_preparation_t
+  enum class Preparation : uint32_t {
+    // IREE_HAL_EXECUTABLE_LIBRARY_PREPARATION_EAGER
+    EAGER = 0u,
+    // IREE_HAL_EXECUTABLE_LIBRARY_PREPARATION_DEFERRED
+    DEFERRED = 1u,
+    // IREE_HAL_EXECUTABLE_LIBRARY_PREPARATION_ASYNC
+    ASYNC = 2u,
+  };
+
   LibraryBuilder(llvm::Module *module, Mode mode,
                  Version version = Version::V_0)
       : module(module), mode(mode), version(version) {}
@@ -84,11 +123,55 @@ class LibraryBuilder {
     this->sanitizerKind = sanitizerKind;
   }
 
+  // Sets when the runtime should prepare the library. Anything other than
+  // Preparation::EAGER is emitted as an iree_hal_executable_library_hints_v0_t
+  // that the runtime can read without loading the library.
+  void setPreparation(Preparation preparation) {
+    this->preparation = preparation;
+  }
+
+  // iree_hal_executable_dispatch_attrs_v0_t
+  // Only emitted in libraries of Version::V_0_2 or later.
+  struct DispatchAttrs {
+    // Workgroup size the entry point was compiled for or 0 if unknown.
+    uint32_t workgroupSize[3] = {0, 0, 0};
+    // Preferred workgroups a processor should execute at a time or 0 to let
+    // the runtime choose.
+    uint32_t workgroupsPerReservation = 0;
+
+    bool isDefault() const {
+      return !workgroupSize[0] && !workgroupSize[1] && !workgroupSize[2] &&
+             !workgroupsPerReservation;
+    }
+  };
+
   // Defines a new entry point on the library implemented by |func|.
   // |name| will be used as the library export and an optional |tag| will be
-  // attached.
-  void addEntryPoint(StringRef name, StringRef tag, llvm::Function *func) {
-    entryPoints.push_back({name.str(), tag.str(), func});
+  // attached. |attrs| are used by the runtime to schedule dispatches.
+  void addEntryPoint(StringRef name, StringRef tag, llvm::Function *func,
+                     DispatchAttrs attrs = {}) {
+    entryPoints.push_back({name.str(), tag.str(), func, attrs});
+  }
+
+  // Declares a function imported from the runtime under |symbolName|.
+  // The resolved functions are passed to each entry point in the order they
+  // were added. If |weak| is set the runtime is not required to provide the
+  // import and will pass NULL if it does not.
+  // Only emitted in libraries of Version::V_0_3 or later.
+  void addImport(StringRef symbolName, bool weak = false) {
+    imports.push_back({symbolName.str(), weak});
+  }
+
+  // Adds a variant of the library using |funcs| as the entry points, 1:1 with
+  // those added by addEntryPoint. The query function returns the first variant
+  // (in the order added) whose |requiredFeatures| are all available in the
+  // runtime environment and otherwise the library built from the entry points.
+  // Only emitted in libraries of Version::V_0_4 or later.
+  void addVariant(StringRef name, uint64_t requiredFeatures,
+                  ArrayRef<llvm::Function *> funcs) {
+    variants.push_back({name.str(), requiredFeatures,
+                        std::vector<llvm::Function *>(funcs.begin(),
+                                                      funcs.end())});
   }
 
   // Builds a `iree_hal_executable_library_query_fn_t` with the given
@@ -103,20 +186,48 @@ class LibraryBuilder {
 
  private:
   // Builds and returns an iree_hal_executable_library_v0_t global constant.
-  llvm::Constant *buildLibraryV0(std::string libraryName);
+  llvm::GlobalVariable *buildLibraryV0(std::string libraryName);
+
+  // Builds the exported iree_hal_executable_library_hints_v0_t global.
+  llvm::GlobalVariable *buildHintsV0();
+
+  // Builds the iree_hal_executable_library_v0_t::entry_points table.
+  llvm::Constant *buildEntryPointFuncs(std::string libraryName,
+                                       ArrayRef<llvm::Function *> funcs);
+
+  // Builds a variant of |library| with the entry points of |variant|.
+  struct Variant;
+  llvm::GlobalVariable *buildLibraryV0Variant(llvm::GlobalVariable *library,
+                                              std::string libraryName,
+                                              const Variant &variant);
 
   llvm::Module *module = nullptr;
   Mode mode = Mode::INCLUDE_REFLECTION_ATTRS;
   Version version = Version::V_0;
   Features features = Features::NONE;
   SanitizerKind sanitizerKind = SanitizerKind::NONE;
+  Preparation preparation = Preparation::EAGER;
 
   struct EntryPoint {
     std::string name;
     std::string tag;
     llvm::Function *func;
+    DispatchAttrs attrs;
   };
   std::vector<EntryPoint> entryPoints;
+
+  struct Import {
+    std::string symbolName;
+    bool weak;
+  };
+  std::vector<Import> imports;
+
+  struct Variant {
+    std::string name;
+    uint64_t requiredFeatures;
+    std::vector<llvm::Function *> funcs;
+  };
+  std::vector<Variant> variants;
 };
 
 }  // namespace HAL
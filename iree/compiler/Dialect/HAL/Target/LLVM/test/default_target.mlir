@@ -0,0 +1,139 @@
+// RUN: iree-opt -split-input-file -pass-pipeline='hal.executable(hal.executable.target(iree-hal-translate-executables))' -iree-hal-target-backends=dylib-llvm-aot -iree-llvm-target-triple=x86_64-unknown-linux-gnu %s | IreeFileCheck %s -check-prefix=X86
+// RUN: iree-opt -split-input-file -pass-pipeline='hal.executable(hal.executable.target(iree-hal-translate-executables))' -iree-hal-target-backends=dylib-llvm-aot -iree-llvm-target-triple=aarch64-none-linux-android %s | IreeFileCheck %s -check-prefix=ARM
+
+// Lowering configurations selected for the default (generic) CPU of each
+// triple as used by the e2e tests. Generic x86-64 has 128-bit vectors and the
+// default 32KiB L1, 256KiB L2, and 1MiB LLC share; AArch64 has 128-bit
+// vectors with 32 registers and a 128KiB L2 and 512KiB LLC share.
+
+hal.executable @matmul_static attributes {sym_visibility = "private"} {
+  hal.interface @io {
+    hal.interface.binding @arg0, set=0, binding=0, type="StorageBuffer", access="Read"
+    hal.interface.binding @arg1, set=0, binding=1, type="StorageBuffer", access="Read"
+    hal.interface.binding @ret0, set=0, binding=2, type="StorageBuffer", access="Write|Discard"
+  }
+  hal.executable.target @llvm_aot, filter="dylib*" {
+    hal.executable.entry_point @matmul_static attributes {
+      interface = @io,
+      ordinal = 0 : index
+    }
+    module {
+      func @matmul_static() {
+        %c0 = constant 0 : index
+        %c96 = constant 96 : index
+        %c256 = constant 256 : index
+        %0 = hal.interface.binding.subspan @io::@arg0[%c0] : memref<96x512xf32>
+        %1 = hal.interface.binding.subspan @io::@arg1[%c0] : memref<512x256xf32>
+        %2 = hal.interface.binding.subspan @io::@ret0[%c0] : memref<96x256xf32>
+        %workgroup_size_x = hal.interface.workgroup.size[0] : index
+        %workgroup_size_y = hal.interface.workgroup.size[1] : index
+        %workgroup_id_x = hal.interface.workgroup.id[0] : index
+        %workgroup_count_x = hal.interface.workgroup.count[0] : index
+        %workgroup_id_y = hal.interface.workgroup.id[1] : index
+        %workgroup_count_y = hal.interface.workgroup.count[1] : index
+        %3 = muli %workgroup_size_y, %workgroup_id_y : index
+        %4 = muli %workgroup_size_y, %workgroup_count_y : index
+        scf.for %arg0 = %3 to %c96 step %4 {
+          %5 = muli %workgroup_size_x, %workgroup_id_x : index
+          %6 = muli %workgroup_size_x, %workgroup_count_x : index
+          scf.for %arg1 = %5 to %c256 step %6 {
+            %7 = affine.min affine_map<(d0)[s0] -> (s0, -d0 + 96)>(%arg0)[%workgroup_size_y]
+            %8 = memref.subview %0[%arg0, 0] [%7, 512] [1, 1] : memref<96x512xf32> to memref<?x512xf32, affine_map<(d0, d1)[s0] -> (d0 * 512 + s0 + d1)>>
+            %9 = affine.min affine_map<(d0)[s0] -> (s0, -d0 + 256)>(%arg1)[%workgroup_size_x]
+            %10 = memref.subview %1[0, %arg1] [512, %9] [1, 1] : memref<512x256xf32> to memref<512x?xf32, affine_map<(d0, d1)[s0] -> (d0 * 256 + s0 + d1)>>
+            %11 = memref.subview %2[%arg0, %arg1] [%7, %9] [1, 1] : memref<96x256xf32> to memref<?x?xf32, affine_map<(d0, d1)[s0] -> (d0 * 256 + s0 + d1)>>
+            linalg.matmul {__internal_linalg_transform__ = "workgroup"} ins(%8, %10 : memref<?x512xf32, affine_map<(d0, d1)[s0] -> (d0 * 512 + s0 + d1)>>, memref<512x?xf32, affine_map<(d0, d1)[s0] -> (d0 * 256 + s0 + d1)>>) outs(%11 : memref<?x?xf32, affine_map<(d0, d1)[s0] -> (d0 * 256 + s0 + d1)>>)
+          }
+        }
+        return
+      }
+    }
+  }
+}
+
+// The 128x128 (X86) and 64x64 (ARM) workgroup tiles keep the LHS and RHS panels
+// in half of the LLC share and are shrunk along M to evenly divide 96. Neither
+// working set fits in L2 so workgroups are reserved one at a time.
+//      X86: hal.executable.entry_point @matmul_static
+// X86-SAME:   workloadPerWorkgroup = [128, 96]
+// X86-SAME:   workgroups_per_reservation = 1 : i64
+//      ARM: hal.executable.entry_point @matmul_static
+// ARM-SAME:   workloadPerWorkgroup = [64, 48]
+// ARM-SAME:   workgroups_per_reservation = 1 : i64
+
+// -----
+
+hal.executable @conv attributes {sym_visibility = "private"} {
+  hal.interface @io {
+    hal.interface.binding @arg0, set=0, binding=0, type="StorageBuffer", access="Read"
+    hal.interface.binding @arg1, set=0, binding=1, type="StorageBuffer", access="Read"
+    hal.interface.binding @ret0, set=0, binding=2, type="StorageBuffer", access="Write|Discard"
+  }
+  hal.executable.target @llvm_aot, filter="dylib*" {
+    hal.executable.entry_point @conv attributes {
+      interface = @io,
+      ordinal = 0 : index
+    }
+    module  {
+      func @conv() {
+        %cst = constant 0.000000e+00 : f32
+        %c32 = constant 32 : index
+        %c112 = constant 112 : index
+        %c0 = constant 0 : index
+        %0 = hal.interface.binding.subspan @io::@arg0[%c0] : memref<1x225x225x16xf32>
+        %1 = hal.interface.binding.subspan @io::@arg1[%c0] : memref<3x3x16x32xf32>
+        %2 = hal.interface.binding.subspan @io::@ret0[%c0] : memref<1x112x112x32xf32>
+        %workgroup_size_x = hal.interface.workgroup.size[0] : index
+        %workgroup_size_y = hal.interface.workgroup.size[1] : index
+        %workgroup_size_z = hal.interface.workgroup.size[2] : index
+        %workgroup_id_x = hal.interface.workgroup.id[0] : index
+        %workgroup_count_x = hal.interface.workgroup.count[0] : index
+        %workgroup_id_y = hal.interface.workgroup.id[1] : index
+        %workgroup_count_y = hal.interface.workgroup.count[1] : index
+        %workgroup_id_z = hal.interface.workgroup.id[2] : index
+        %workgroup_count_z = hal.interface.workgroup.count[2] : index
+        %3 = affine.apply affine_map<()[s0, s1] -> (s0 * s1)>()[%workgroup_id_z, %workgroup_size_z]
+        %4 = affine.apply affine_map<()[s0, s1] -> (s0 * s1)>()[%workgroup_count_z, %workgroup_size_z]
+        scf.for %arg0 = %3 to %c112 step %4 {
+          %5 = affine.apply affine_map<()[s0, s1] -> (s0 * s1)>()[%workgroup_id_y, %workgroup_size_y]
+          %6 = affine.apply affine_map<()[s0, s1] -> (s0 * s1)>()[%workgroup_count_y, %workgroup_size_y]
+          scf.for %arg1 = %5 to %c112 step %6 {
+            %7 = affine.apply affine_map<()[s0, s1] -> (s0 * s1)>()[%workgroup_id_x, %workgroup_size_x]
+            %8 = affine.apply affine_map<()[s0, s1] -> (s0 * s1)>()[%workgroup_count_x, %workgroup_size_x]
+            scf.for %arg2 = %7 to %c32 step %8 {
+              %9 = affine.apply affine_map<(d0) -> (d0 * 2)>(%arg0)
+              %10 = affine.min affine_map<(d0)[s0] -> (s0 * 2 + 1, d0 * -2 + 225)>(%arg0)[%workgroup_size_z]
+              %11 = affine.apply affine_map<(d0) -> (d0 * 2)>(%arg1)
+              %12 = affine.min affine_map<(d0)[s0] -> (s0 * 2 + 1, d0 * -2 + 225)>(%arg1)[%workgroup_size_y]
+              %13 = memref.subview %0[0, %9, %11, 0] [1, %10, %12, 16] [1, 1, 1, 1] : memref<1x225x225x16xf32> to memref<1x?x?x16xf32, affine_map<(d0, d1, d2, d3)[s0] -> (d0 * 810000 + s0 + d1 * 3600 + d2 * 16 + d3)>>
+              %14 = affine.min affine_map<(d0)[s0] -> (s0, -d0 + 32)>(%arg2)[%workgroup_size_x]
+              %15 = memref.subview %1[0, 0, 0, %arg2] [3, 3, 16, %14] [1, 1, 1, 1] : memref<3x3x16x32xf32> to memref<3x3x16x?xf32, affine_map<(d0, d1, d2, d3)[s0] -> (d0 * 1536 + s0 + d1 * 512 + d2 * 32 + d3)>>
+              %16 = affine.min affine_map<(d0)[s0] -> (s0, -d0 + 112)>(%arg0)[%workgroup_size_z]
+              %17 = affine.min affine_map<(d0)[s0] -> (s0, -d0 + 112)>(%arg1)[%workgroup_size_y]
+              %18 = memref.subview %2[0, %arg0, %arg1, %arg2] [1, %16, %17, %14] [1, 1, 1, 1] : memref<1x112x112x32xf32> to memref<1x?x?x?xf32, affine_map<(d0, d1, d2, d3)[s0] -> (d0 * 401408 + s0 + d1 * 3584 + d2 * 32 + d3)>>
+              linalg.fill(%18, %cst) {__internal_linalg_transform__ = "workgroup"} : memref<1x?x?x?xf32, affine_map<(d0, d1, d2, d3)[s0] -> (d0 * 401408 + s0 + d1 * 3584 + d2 * 32 + d3)>>, f32
+              linalg.conv_2d_input_nhwc_filter_hwcf {__internal_linalg_transform__ = "workgroup", dilations = dense<1> : tensor<2xi64>, strides = dense<2> : tensor<2xi64>} ins(%13, %15 : memref<1x?x?x16xf32, affine_map<(d0, d1, d2, d3)[s0] -> (d0 * 810000 + s0 + d1 * 3600 + d2 * 16 + d3)>>, memref<3x3x16x?xf32, affine_map<(d0, d1, d2, d3)[s0] -> (d0 * 1536 + s0 + d1 * 512 + d2 * 32 + d3)>>) outs(%18 : memref<1x?x?x?xf32, affine_map<(d0, d1, d2, d3)[s0] -> (d0 * 401408 + s0 + d1 * 3584 + d2 * 32 + d3)>>)
+            }
+          }
+        }
+        return
+      }
+      hal.interface @io attributes {sym_visibility = "private"} {
+        hal.interface.binding @arg0, set=0, binding=0, type="StorageBuffer", access="Read"
+        hal.interface.binding @arg1, set=0, binding=1, type="StorageBuffer", access="Read"
+        hal.interface.binding @ret0, set=0, binding=2, type="StorageBuffer", access="Write|Discard"
+      }
+    }
+  }
+}
+
+// Convolutions are distributed over the output height, width, and channels.
+// The 16x16x32 (X86) and 8x8x32 (ARM) output tiles along with their 33x33x16
+// and 17x17x16 input windows and the filter fit in half of L2, and the working
+// sets of two workgroups fit in the full L2.
+//      X86: hal.executable.entry_point @conv
+// X86-SAME:   workloadPerWorkgroup = [32, 16, 16]
+// X86-SAME:   workgroups_per_reservation = 2 : i64
+//      ARM: hal.executable.entry_point @conv
+// ARM-SAME:   workloadPerWorkgroup = [32, 8, 8]
+// ARM-SAME:   workgroups_per_reservation = 2 : i64
@@ -1,4 +1,5 @@
 // RUN: iree-opt -split-input-file -iree-hal-transformation-pipeline -iree-hal-target-backends=dylib-llvm-aot %s | IreeFileCheck %s
+// RUN: iree-opt -split-input-file -iree-hal-transformation-pipeline -iree-hal-target-backends=dylib-llvm-aot -iree-llvm-executable-preparation=deferred -iree-llvm-print-library-ir %s -o /dev/null 2>&1 | IreeFileCheck %s --check-prefix=HINTS
 
 #map = affine_map<(d0) -> (d0)>
 flow.executable @add_dispatch_0 {
@@ -24,3 +25,7 @@ flow.executable @add_dispatch_0 {
 // CHECK:       hal.executable.binary @llvm_aot attributes {
 // CHECK-SAME:     data = dense
 // CHECK-SAME:     format = "DLIB"
+
+// The preparation hint is exported in a section the runtime reads without
+// loading the library.
+// HINTS: @iree_hal_executable_library_hints = {{.*}}constant %iree_hal_executable_library_hints_v0_t { i32 0, i32 1 }, section ".iree.hints"
@@ -0,0 +1,78 @@
+// RUN: iree-opt -pass-pipeline='hal.executable(hal.executable.target(iree-hal-translate-executables))' -iree-hal-target-backends=dylib-llvm-aot -iree-llvm-target-triple=x86_64-unknown-linux-gnu -iree-llvm-target-cpu=haswell -iree-llvm-target-cpu-variants=skylake-avx512 %s | IreeFileCheck %s
+// RUN: iree-opt -pass-pipeline='hal.executable(hal.executable.target(iree-hal-translate-executables),iree-hal-serialize-executables)' -iree-hal-target-backends=dylib-llvm-aot -iree-llvm-target-triple=x86_64-unknown-linux-gnu -iree-llvm-target-cpu=haswell -iree-llvm-target-cpu-variants=skylake-avx512 -iree-llvm-print-library-ir %s -o /dev/null 2>&1 | IreeFileCheck %s -check-prefix=IR
+
+hal.executable @matmul_test attributes {sym_visibility = "private"} {
+  hal.interface @io {
+    hal.interface.binding @arg0, set=0, binding=0, type="StorageBuffer", access="Read"
+    hal.interface.binding @arg1, set=0, binding=1, type="StorageBuffer", access="Read"
+    hal.interface.binding @ret0, set=0, binding=2, type="StorageBuffer", access="Write|Discard"
+  }
+  hal.executable.target @llvm_aot, filter="dylib*" {
+    hal.executable.entry_point @matmul_test attributes {
+      interface = @io,
+      ordinal = 0 : index
+    }
+    module {
+      func @matmul_test() {
+        %c0 = constant 0 : index
+        %c128 = constant 128 : index
+        %0 = hal.interface.binding.subspan @io::@arg0[%c0] : memref<128x128xf32>
+        %1 = hal.interface.binding.subspan @io::@arg1[%c0] : memref<128x128xf32>
+        %2 = hal.interface.binding.subspan @io::@ret0[%c0] : memref<128x128xf32>
+        %workgroup_size_x = hal.interface.workgroup.size[0] : index
+        %workgroup_size_y = hal.interface.workgroup.size[1] : index
+        %workgroup_id_x = hal.interface.workgroup.id[0] : index
+        %workgroup_count_x = hal.interface.workgroup.count[0] : index
+        %workgroup_id_y = hal.interface.workgroup.id[1] : index
+        %workgroup_count_y = hal.interface.workgroup.count[1] : index
+        %3 = muli %workgroup_size_y, %workgroup_id_y : index
+        %4 = muli %workgroup_size_y, %workgroup_count_y : index
+        scf.for %arg0 = %3 to %c128 step %4 {
+          %5 = muli %workgroup_size_x, %workgroup_id_x : index
+          %6 = muli %workgroup_size_x, %workgroup_count_x : index
+          scf.for %arg1 = %5 to %c128 step %6 {
+            %7 = affine.min affine_map<(d0)[s0] -> (s0, -d0 + 128)>(%arg0)[%workgroup_size_y]
+            %8 = memref.subview %0[%arg0, 0] [%7, 128] [1, 1] : memref<128x128xf32> to memref<?x128xf32, affine_map<(d0, d1)[s0] -> (d0 * 128 + s0 + d1)>>
+            %9 = affine.min affine_map<(d0)[s0] -> (s0, -d0 + 128)>(%arg1)[%workgroup_size_x]
+            %10 = memref.subview %1[0, %arg1] [128, %9] [1, 1] : memref<128x128xf32> to memref<128x?xf32, affine_map<(d0, d1)[s0] -> (d0 * 128 + s0 + d1)>>
+            %11 = memref.subview %2[%arg0, %arg1] [%7, %9] [1, 1] : memref<128x128xf32> to memref<?x?xf32, affine_map<(d0, d1)[s0] -> (d0 * 128 + s0 + d1)>>
+            linalg.matmul {__internal_linalg_transform__ = "workgroup"} ins(%8, %10 : memref<?x128xf32, affine_map<(d0, d1)[s0] -> (d0 * 128 + s0 + d1)>>, memref<128x?xf32, affine_map<(d0, d1)[s0] -> (d0 * 128 + s0 + d1)>>) outs(%11 : memref<?x?xf32, affine_map<(d0, d1)[s0] -> (d0 * 128 + s0 + d1)>>)
+          }
+        }
+        return
+      }
+    }
+  }
+}
+
+// The variant is dispatched with the workgroup count of the baseline and
+// vectorized for 512-bit registers.
+//       CHECK: hal.executable.entry_point @matmul_test
+//  CHECK-SAME:   workloadPerWorkgroup = [128, 128]
+//       CHECK: module {{ *}}{
+//   CHECK-NOT:   vector<16xf32>
+//       CHECK:   llvm.func @matmul_test
+//       CHECK:     vector<8xf32>
+//       CHECK: module @variant0
+//       CHECK:   llvm.func @matmul_test
+//       CHECK:     vector<16xf32>
+
+// The query function selects the variant when the host has its features and
+// otherwise falls back to the baseline library.
+//      IR-DAG: @iree_hal_executable_library_query_v0_variant0_funcs = private constant {{.+}} @matmul_test_variant0
+//      IR-DAG: @iree_hal_executable_library_query_v0_funcs = private constant {{.+}} @matmul_test
+//      IR-DAG: define internal void @matmul_test_variant0({{.+}} #[[$VARIANT_ATTRS:[0-9]+]]
+//  IR-LABEL: define {{.*}}@iree_hal_executable_library_query(
+//       IR: entry:
+//       IR:   br i1 %{{.+}}, label %select, label %fallback
+//       IR: select:
+//       IR:   %[[FEATURES:.+]] = load i64
+//       IR:   %[[MASKED:.+]] = and i64 %[[FEATURES]], [[REQUIRED:[0-9]+]]
+//       IR:   icmp eq i64 %[[MASKED]], [[REQUIRED]]
+//       IR: select_variant0:
+//       IR:   ret {{.+}}@iree_hal_executable_library_query_v0_variant0
+//       IR: fallback:
+//       IR:   ret {{.+}}@iree_hal_executable_library_query_v0
+// The variant only uses the baseline CPU features plus the features the
+// runtime checks for and is tuned for the variant CPU.
+//       IR: attributes #[[$VARIANT_ATTRS]] = {{.+}}"target-cpu"="haswell"{{.+}}"target-features"="{{.*}}+avx512f{{.*}}"{{.+}}"tune-cpu"="skylake-avx512"
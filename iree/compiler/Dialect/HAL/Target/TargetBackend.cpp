@@ -215,6 +215,7 @@ LogicalResult TargetBackend::linkExecutablesInto(
   llvm::SmallVector<IREE::HAL::InterfaceOp, 4> linkedInterfaceOps;
   int nextEntryPointOrdinal = 0;
   DenseMap<StringRef, Operation *> targetSymbolMap;
+  llvm::StringMap<DenseMap<StringRef, Operation *>> namedTargetSymbolMaps;
   DenseMap<Attribute, Attribute> entryPointRefReplacements;
 
   auto linkedExecutableBuilder =
@@ -283,6 +284,26 @@ LogicalResult TargetBackend::linkExecutablesInto(
         return failure();
       }
 
+      // Merge any additional named modules into the linked module of the same
+      // name, creating it if needed.
+      auto namedModuleOps =
+          llvm::to_vector<4>(targetOp.getBlock().getOps<mlir::ModuleOp>());
+      for (auto namedModuleOp : llvm::drop_begin(namedModuleOps, 1)) {
+        auto moduleName = namedModuleOp.getName();
+        if (!moduleName) continue;
+        auto linkedNamedModuleOp =
+            SymbolTable::lookupSymbolIn(linkedTargetOp, *moduleName);
+        if (!linkedNamedModuleOp) {
+          OpBuilder moduleBuilder(&linkedTargetOp.getBlock().back());
+          linkedNamedModuleOp = moduleBuilder.create<mlir::ModuleOp>(
+              namedModuleOp.getLoc(), *moduleName);
+        }
+        if (failed(mergeModuleInto(namedModuleOp, linkedNamedModuleOp,
+                                   namedTargetSymbolMaps[*moduleName]))) {
+          return failure();
+        }
+      }
+
       targetOp.erase();
     }
 
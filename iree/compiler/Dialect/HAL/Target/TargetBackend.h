@@ -311,6 +311,9 @@ class TargetBackend {
  protected:
   // Links all executables for the current target found in |moduleOp| into
   // |linkedExecutableOp|. Functions will be cloned into |linkedModuleOp|.
+  // Additional named modules in the targets, such as code compiled for other
+  // configurations of the target, are merged into the module of the same name
+  // in |linkedTargetOp|.
   LogicalResult linkExecutablesInto(
       mlir::ModuleOp moduleOp,
       ArrayRef<IREE::HAL::ExecutableOp> sourceExecutableOps,
@@ -252,7 +252,8 @@ class MaterializeConstantPoolBuffersPass
 
     // Fill the buffers (memset).
     // We do this with a command buffer so that we can allow the device to
-    // fill them in asynchronously and without memory mapping.
+    // fill them in asynchronously and without memory mapping. The initializer
+    // runs once and the command buffer is never resubmitted so it is one-shot.
     auto commandBufferValue =
         funcBuilder.createOrFold<IREE::HAL::CommandBufferCreateOp>(
             variableLoc, IREE::HAL::CommandBufferType::get(context),
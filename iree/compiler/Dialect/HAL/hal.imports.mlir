@@ -11,6 +11,14 @@ vm.module @hal {
 vm.import @ex.shared_device() -> !vm.ref<!hal.device>
 attributes {nosideeffects}
 
+// Submits the command buffer after all prior submissions and returns the
+// submission timeline semaphore and the payload value it reaches once the
+// command buffer has completed.
+vm.import @ex.submit(
+  %device : !vm.ref<!hal.device>,
+  %command_buffer : !vm.ref<!hal.command_buffer>
+) -> (!vm.ref<!hal.semaphore>, i32)
+
 vm.import @ex.submit_and_wait(
   %device : !vm.ref<!hal.device>,
   %command_buffer : !vm.ref<!hal.command_buffer>
@@ -0,0 +1,529 @@
+// Copyright 2021 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/compiler/Dialect/Modules/VMVX/Conversion/LinalgToVMVX/ConvertLinalgToVMVX.h"
+
+#include "iree/compiler/Dialect/HAL/IR/HALOps.h"
+#include "iree/compiler/Dialect/Modules/VMVX/IR/VMVXDialect.h"
+#include "iree/compiler/Dialect/Modules/VMVX/IR/VMVXOps.h"
+#include "llvm/ADT/STLExtras.h"
+#include "mlir/Dialect/Linalg/IR/LinalgOps.h"
+#include "mlir/Dialect/MemRef/IR/MemRef.h"
+#include "mlir/Dialect/StandardOps/IR/Ops.h"
+#include "mlir/Dialect/Utils/StructuredOpsUtils.h"
+#include "mlir/IR/Attributes.h"
+#include "mlir/IR/Builders.h"
+#include "mlir/IR/BuiltinTypes.h"
+#include "mlir/IR/Matchers.h"
+#include "mlir/IR/PatternMatch.h"
+
+namespace mlir {
+namespace iree_compiler {
+
+namespace {
+
+//===----------------------------------------------------------------------===//
+// Strided views
+//===----------------------------------------------------------------------===//
+
+// A memref operand that is a (possibly empty) chain of subviews of an interface
+// binding with a static row-major shape.
+struct ViewSource {
+  Value memref;
+  IREE::HAL::InterfaceBindingSubspanOp subspanOp;
+  // Subviews from the operand (front) back to the binding (back).
+  SmallVector<memref::SubViewOp, 4> subviewOps;
+};
+
+// A 2-D strided view of a flattened binding with offsets and strides in
+// elements. Rank-0 and rank-1 memrefs are viewed as a single row.
+struct StridedView {
+  Value buffer;
+  Value offset;
+  Value strides[2];
+  Value sizes[2];
+};
+
+// Matches |memref| as a view of an interface binding. Returns None if any of
+// the ops producing it cannot be expressed as an offset and strides.
+static Optional<ViewSource> matchViewSource(Value memref) {
+  auto memrefType = memref.getType().dyn_cast<MemRefType>();
+  if (!memrefType || memrefType.getRank() > 2) return llvm::None;
+  int64_t elementBitWidth = memrefType.getElementTypeBitWidth();
+  if (elementBitWidth != 8 && elementBitWidth != 16 && elementBitWidth != 32) {
+    return llvm::None;
+  }
+
+  ViewSource source;
+  source.memref = memref;
+  Value value = memref;
+  while (auto subviewOp = value.getDefiningOp<memref::SubViewOp>()) {
+    // Rank-reducing subviews drop dimensions we'd need to track.
+    if (subviewOp.getSourceType().getRank() != memrefType.getRank()) {
+      return llvm::None;
+    }
+    source.subviewOps.push_back(subviewOp);
+    value = subviewOp.source();
+  }
+
+  source.subspanOp =
+      value.getDefiningOp<IREE::HAL::InterfaceBindingSubspanOp>();
+  if (!source.subspanOp || source.subspanOp.byte_length()) return llvm::None;
+  auto bindingType = source.subspanOp.getType().dyn_cast<MemRefType>();
+  if (!bindingType || !bindingType.hasStaticShape() ||
+      !bindingType.getAffineMaps().empty()) {
+    return llvm::None;
+  }
+
+  // The byte offset is converted to an element offset and must be aligned.
+  // Dynamic offsets are verified at runtime by buildStridedView.
+  APInt byteOffset;
+  if (matchPattern(source.subspanOp.byte_offset(),
+                   m_ConstantInt(&byteOffset)) &&
+      byteOffset.getZExtValue() % (elementBitWidth / 8) != 0) {
+    return llvm::None;
+  }
+  return source;
+}
+
+// Returns true if the innermost dimension of |source| is statically known to
+// be contiguous in memory.
+static bool hasUnitInnerStride(const ViewSource &source) {
+  for (auto subviewOp : source.subviewOps) {
+    auto strides = subviewOp.getMixedStrides();
+    auto innerStride = strides.back().dyn_cast<Attribute>();
+    if (!innerStride || innerStride.cast<IntegerAttr>().getInt() != 1) {
+      return false;
+    }
+  }
+  return true;
+}
+
+static Value materializeIndex(OpBuilder &builder, Location loc,
+                              OpFoldResult value) {
+  if (auto dynamicValue = value.dyn_cast<Value>()) return dynamicValue;
+  return builder.createOrFold<ConstantIndexOp>(
+      loc, value.get<Attribute>().cast<IntegerAttr>().getInt());
+}
+
+// Materializes the offset, strides, and sizes of |source| as index values.
+// The byte offset of the binding is folded into the element offset so that the
+// buffer passed to the microkernels always starts at the binding base. Dynamic
+// byte offsets are asserted to be element-aligned; static ones are rejected by
+// matchViewSource.
+static StridedView buildStridedView(OpBuilder &builder, Location loc,
+                                    const ViewSource &source) {
+  auto bindingType = source.subspanOp.getType().cast<MemRefType>();
+  Type elementType = bindingType.getElementType();
+  int64_t rank = bindingType.getRank();
+  int64_t elementBytes = elementType.getIntOrFloatBitWidth() / 8;
+
+  Value zero = builder.createOrFold<ConstantIndexOp>(loc, 0);
+  Value binding = source.subspanOp.result();
+  Value offset = zero;
+  if (!matchPattern(source.subspanOp.byte_offset(), m_Zero())) {
+    binding = builder.create<IREE::HAL::InterfaceBindingSubspanOp>(
+        loc, bindingType, source.subspanOp.binding(), zero,
+        source.subspanOp.byte_length());
+    Value byteOffset = source.subspanOp.byte_offset();
+    Value elementBytesValue =
+        builder.createOrFold<ConstantIndexOp>(loc, elementBytes);
+    if (elementBytes > 1 && !matchPattern(byteOffset, m_Constant())) {
+      Value remainder = builder.createOrFold<UnsignedRemIOp>(
+          loc, byteOffset, elementBytesValue);
+      Value isAligned = builder.createOrFold<CmpIOp>(loc, CmpIPredicate::eq,
+                                                     remainder, zero);
+      builder.create<AssertOp>(
+          loc, isAligned,
+          builder.getStringAttr(
+              "binding byte offset must be a multiple of the element size"));
+    }
+    offset = builder.createOrFold<UnsignedDivIOp>(loc, byteOffset,
+                                                  elementBytesValue);
+  }
+
+  // Row-major strides of the binding.
+  SmallVector<Value, 2> strides(rank);
+  int64_t runningStride = 1;
+  for (int64_t i = rank - 1; i >= 0; --i) {
+    strides[i] = builder.createOrFold<ConstantIndexOp>(loc, runningStride);
+    runningStride *= bindingType.getDimSize(i);
+  }
+
+  // Apply each subview from the binding outward.
+  for (auto subviewOp : llvm::reverse(source.subviewOps)) {
+    auto subviewOffsets = subviewOp.getMixedOffsets();
+    auto subviewStrides = subviewOp.getMixedStrides();
+    for (int64_t i = 0; i < rank; ++i) {
+      Value dimOffset = builder.createOrFold<MulIOp>(
+          loc, materializeIndex(builder, loc, subviewOffsets[i]), strides[i]);
+      offset = builder.createOrFold<AddIOp>(loc, offset, dimOffset);
+      strides[i] = builder.createOrFold<MulIOp>(
+          loc, strides[i], materializeIndex(builder, loc, subviewStrides[i]));
+    }
+  }
+
+  SmallVector<Value, 2> sizes(rank);
+  auto memrefType = source.memref.getType().cast<MemRefType>();
+  for (int64_t i = 0; i < rank; ++i) {
+    if (!memrefType.isDynamicDim(i)) {
+      sizes[i] = builder.createOrFold<ConstantIndexOp>(
+          loc, memrefType.getDimSize(i));
+    } else {
+      sizes[i] = materializeIndex(builder, loc,
+                                  source.subviewOps.front().getMixedSizes()[i]);
+    }
+  }
+
+  // Buffers are type and shape erased when converted to the VM and we match
+  // that here so that the later flattening has nothing left to do.
+  StridedView view;
+  view.buffer = builder
+                    .create<UnrealizedConversionCastOp>(
+                        loc,
+                        MemRefType::get({ShapedType::kDynamicSize},
+                                        elementType),
+                        binding)
+                    .getResult(0);
+  view.offset = offset;
+  Value one = builder.createOrFold<ConstantIndexOp>(loc, 1);
+  view.strides[0] = rank == 2 ? strides[0] : zero;
+  view.strides[1] = rank >= 1 ? strides[rank - 1] : zero;
+  view.sizes[0] = rank == 2 ? sizes[0] : one;
+  view.sizes[1] = rank >= 1 ? sizes[rank - 1] : one;
+  return view;
+}
+
+// Returns the ops in the body of |op| excluding the terminator.
+static SmallVector<Operation *, 2> getBodyOps(linalg::GenericOp op) {
+  SmallVector<Operation *, 2> bodyOps;
+  for (auto &bodyOp : op->getRegion(0).front().without_terminator()) {
+    bodyOps.push_back(&bodyOp);
+  }
+  return bodyOps;
+}
+
+// Returns the value yielded from the body of |op|.
+static Value getYieldedValue(linalg::GenericOp op) {
+  auto yieldOp =
+      cast<linalg::YieldOp>(op->getRegion(0).front().getTerminator());
+  return yieldOp.getNumOperands() == 1 ? yieldOp.getOperand(0) : Value{};
+}
+
+// Returns true if |op| has operands |lhs| and |rhs| in either order.
+static bool hasOperands(Operation *op, Value lhs, Value rhs) {
+  if (op->getNumOperands() != 2) return false;
+  return (op->getOperand(0) == lhs && op->getOperand(1) == rhs) ||
+         (op->getOperand(0) == rhs && op->getOperand(1) == lhs);
+}
+
+//===----------------------------------------------------------------------===//
+// linalg.copy / linalg.fill
+//===----------------------------------------------------------------------===//
+
+struct LinalgCopyToVMVX : public OpRewritePattern<linalg::CopyOp> {
+  using OpRewritePattern::OpRewritePattern;
+
+  LogicalResult matchAndRewrite(linalg::CopyOp op,
+                                PatternRewriter &rewriter) const override {
+    if (op.inputPermutation() || op.outputPermutation()) return failure();
+    auto source = matchViewSource(op.input());
+    auto target = matchViewSource(op.output());
+    if (!source || !target) return failure();
+    auto loc = op.getLoc();
+    auto sourceView = buildStridedView(rewriter, loc, *source);
+    auto targetView = buildStridedView(rewriter, loc, *target);
+    rewriter.replaceOpWithNewOp<IREE::VMVX::CopyOp>(
+        op, sourceView.buffer, sourceView.offset, sourceView.strides[0],
+        sourceView.strides[1], targetView.buffer, targetView.offset,
+        targetView.strides[0], targetView.strides[1], targetView.sizes[0],
+        targetView.sizes[1]);
+    return success();
+  }
+};
+
+struct LinalgFillToVMVX : public OpRewritePattern<linalg::FillOp> {
+  using OpRewritePattern::OpRewritePattern;
+
+  LogicalResult matchAndRewrite(linalg::FillOp op,
+                                PatternRewriter &rewriter) const override {
+    if (!op.hasBufferSemantics()) return failure();
+    auto target = matchViewSource(op.output());
+    if (!target) return failure();
+
+    // The runtime takes a 32-bit pattern. Floating-point values are only
+    // supported when constant as their bits are taken at compile time.
+    auto loc = op.getLoc();
+    Value value = op.value();
+    Type valueType = value.getType();
+    FloatAttr floatAttr;
+    if (valueType.isa<FloatType>() &&
+        !matchPattern(value, m_Constant(&floatAttr))) {
+      return failure();
+    } else if (!valueType.isa<FloatType>() && !valueType.isSignlessInteger()) {
+      return failure();
+    }
+
+    Value pattern;
+    if (floatAttr) {
+      pattern = rewriter.create<ConstantIntOp>(
+          loc, floatAttr.getValue().bitcastToAPInt().getZExtValue(),
+          rewriter.getI32Type());
+    } else if (valueType.getIntOrFloatBitWidth() < 32) {
+      pattern = rewriter.createOrFold<ZeroExtendIOp>(loc, value,
+                                                     rewriter.getI32Type());
+    } else {
+      pattern = value;
+    }
+
+    auto targetView = buildStridedView(rewriter, loc, *target);
+    rewriter.replaceOpWithNewOp<IREE::VMVX::FillOp>(
+        op, pattern, targetView.buffer, targetView.offset,
+        targetView.strides[0], targetView.strides[1], targetView.sizes[0],
+        targetView.sizes[1]);
+    return success();
+  }
+};
+
+//===----------------------------------------------------------------------===//
+// Elementwise linalg.generic
+//===----------------------------------------------------------------------===//
+
+// Rewrites all-parallel linalg.generic ops with identity indexing maps whose
+// bodies are a single add/mul or a mul feeding an add (fma).
+struct LinalgElementwiseToVMVX : public OpRewritePattern<linalg::GenericOp> {
+  using OpRewritePattern::OpRewritePattern;
+
+  LogicalResult matchAndRewrite(linalg::GenericOp op,
+                                PatternRewriter &rewriter) const override {
+    if (!op.hasBufferSemantics() || op.getNumOutputs() != 1 ||
+        op.getNumLoops() != op.getNumParallelLoops() || op.getNumLoops() > 2) {
+      return failure();
+    }
+    for (auto map : op.getIndexingMaps()) {
+      if (!map.isIdentity()) return failure();
+    }
+
+    // All operands must share an element type supported by the kernels.
+    Type elementType =
+        op.getOutputOperand(0)->get().getType().cast<MemRefType>()
+            .getElementType();
+    if (!elementType.isF32() && !elementType.isInteger(32)) return failure();
+    SmallVector<ViewSource, 4> sources;
+    for (auto *operand : op.getInputAndOutputOperands()) {
+      auto memrefType = operand->get().getType().dyn_cast<MemRefType>();
+      if (!memrefType || memrefType.getElementType() != elementType) {
+        return failure();
+      }
+      auto source = matchViewSource(operand->get());
+      if (!source) return failure();
+      sources.push_back(*source);
+    }
+
+    Block &body = op->getRegion(0).front();
+    auto bodyOps = getBodyOps(op);
+    Value yielded = getYieldedValue(op);
+    if (!yielded || bodyOps.empty() || yielded != bodyOps.back()->getResult(0))
+      return failure();
+    auto loc = op.getLoc();
+    int64_t numInputs = op.getNumInputs();
+    Value outArg = body.getArgument(numInputs);
+    bool readsOut = !outArg.use_empty();
+
+    if (bodyOps.size() == 1 && numInputs == 2 && !readsOut &&
+        hasOperands(bodyOps[0], body.getArgument(0), body.getArgument(1))) {
+      Operation *bodyOp = bodyOps[0];
+      bool isAdd = isa<AddFOp, AddIOp>(bodyOp);
+      bool isMul = isa<MulFOp, MulIOp>(bodyOp);
+      if (!isAdd && !isMul) return failure();
+      auto lhs = buildStridedView(rewriter, loc, sources[0]);
+      auto rhs = buildStridedView(rewriter, loc, sources[1]);
+      auto out = buildStridedView(rewriter, loc, sources[2]);
+      SmallVector<Value, 14> operands = {
+          lhs.buffer,     lhs.offset,     lhs.strides[0], lhs.strides[1],
+          rhs.buffer,     rhs.offset,     rhs.strides[0], rhs.strides[1],
+          out.buffer,     out.offset,     out.strides[0], out.strides[1],
+          out.sizes[0],   out.sizes[1],
+      };
+      if (isAdd) {
+        rewriter.create<IREE::VMVX::AddOp>(loc, TypeRange{}, operands);
+      } else {
+        rewriter.create<IREE::VMVX::MulOp>(loc, TypeRange{}, operands);
+      }
+      rewriter.eraseOp(op);
+      return success();
+    }
+
+    // fma: a * b + c where c is either the third input or the output itself.
+    if (bodyOps.size() != 2 || !elementType.isF32()) return failure();
+    auto mulOp = dyn_cast<MulFOp>(bodyOps[0]);
+    auto addOp = dyn_cast<AddFOp>(bodyOps[1]);
+    if (!mulOp || !addOp || !mulOp.getResult().hasOneUse()) return failure();
+    if (numInputs == 3 && readsOut) return failure();
+    if (numInputs != 3 && numInputs != 2) return failure();
+    if (!hasOperands(mulOp, body.getArgument(0), body.getArgument(1))) {
+      return failure();
+    }
+    int64_t cIndex = numInputs == 3 ? 2 : numInputs;
+    if (!hasOperands(addOp, mulOp.getResult(), body.getArgument(cIndex))) {
+      return failure();
+    }
+    auto a = buildStridedView(rewriter, loc, sources[0]);
+    auto b = buildStridedView(rewriter, loc, sources[1]);
+    auto c = buildStridedView(rewriter, loc, sources[cIndex]);
+    auto out = buildStridedView(rewriter, loc, sources[numInputs]);
+    rewriter.create<IREE::VMVX::FmaOp>(
+        loc, a.buffer, a.offset, a.strides[0], a.strides[1], b.buffer,
+        b.offset, b.strides[0], b.strides[1], c.buffer, c.offset, c.strides[0],
+        c.strides[1], out.buffer, out.offset, out.strides[0], out.strides[1],
+        out.sizes[0], out.sizes[1]);
+    rewriter.eraseOp(op);
+    return success();
+  }
+};
+
+//===----------------------------------------------------------------------===//
+// Reduction linalg.generic
+//===----------------------------------------------------------------------===//
+
+// Rewrites linalg.generic ops reducing a single dimension of a 1-D or 2-D input
+// with a sum or max into the output.
+struct LinalgReductionToVMVX : public OpRewritePattern<linalg::GenericOp> {
+  using OpRewritePattern::OpRewritePattern;
+
+  LogicalResult matchAndRewrite(linalg::GenericOp op,
+                                PatternRewriter &rewriter) const override {
+    if (!op.hasBufferSemantics() || op.getNumInputs() != 1 ||
+        op.getNumOutputs() != 1 || op.getNumReductionLoops() != 1 ||
+        op.getNumLoops() > 2) {
+      return failure();
+    }
+    int64_t numLoops = op.getNumLoops();
+    int64_t reductionDim = 0;
+    for (auto iteratorType : llvm::enumerate(op.iterator_types())) {
+      if (isReductionIterator(iteratorType.value())) {
+        reductionDim = iteratorType.index();
+      }
+    }
+
+    // The input is read in iteration order and the output drops the reduced
+    // dimension.
+    auto maps = op.getIndexingMaps();
+    if (!maps[0].isIdentity()) return failure();
+    SmallVector<AffineExpr, 1> outputExprs;
+    for (int64_t i = 0; i < numLoops; ++i) {
+      if (i == reductionDim) continue;
+      outputExprs.push_back(rewriter.getAffineDimExpr(i));
+    }
+    if (maps[1] !=
+        AffineMap::get(numLoops, 0, outputExprs, rewriter.getContext())) {
+      return failure();
+    }
+
+    Value input = op.getInputOperand(0)->get();
+    Value output = op.getOutputOperand(0)->get();
+    Type elementType = input.getType().cast<MemRefType>().getElementType();
+    if (output.getType().cast<MemRefType>().getElementType() != elementType) {
+      return failure();
+    }
+    auto inputSource = matchViewSource(input);
+    auto outputSource = matchViewSource(output);
+    if (!inputSource || !outputSource) return failure();
+
+    // Match the combiner on (in, out).
+    Block &body = op->getRegion(0).front();
+    Value inArg = body.getArgument(0);
+    Value outArg = body.getArgument(1);
+    auto bodyOps = getBodyOps(op);
+    Value yielded = getYieldedValue(op);
+    if (!yielded || bodyOps.empty() || yielded != bodyOps.back()->getResult(0))
+      return failure();
+    bool isSum = false;
+    if (bodyOps.size() == 1 && hasOperands(bodyOps[0], inArg, outArg)) {
+      isSum = (elementType.isF32() && isa<AddFOp>(bodyOps[0])) ||
+              (elementType.isInteger(32) && isa<AddIOp>(bodyOps[0]));
+      if (!isSum) return failure();
+    } else if (bodyOps.size() == 2 && elementType.isF32()) {
+      // max: select(cmpf ogt(in, out), in, out)
+      auto cmpOp = dyn_cast<CmpFOp>(bodyOps[0]);
+      auto selectOp = dyn_cast<SelectOp>(bodyOps[1]);
+      if (!cmpOp || !selectOp ||
+          cmpOp.getPredicate() != CmpFPredicate::OGT ||
+          cmpOp.lhs() != inArg || cmpOp.rhs() != outArg ||
+          selectOp.condition() != cmpOp.getResult() ||
+          selectOp.true_value() != inArg || selectOp.false_value() != outArg) {
+        return failure();
+      }
+    } else {
+      return failure();
+    }
+
+    auto loc = op.getLoc();
+    auto in = buildStridedView(rewriter, loc, *inputSource);
+    auto out = buildStridedView(rewriter, loc, *outputSource);
+    // The kernels reduce the inner dimension; transpose the input view when
+    // reducing the outer one.
+    if (numLoops == 2 && reductionDim == 0) {
+      std::swap(in.strides[0], in.strides[1]);
+      std::swap(in.sizes[0], in.sizes[1]);
+    }
+    SmallVector<Value, 9> operands = {
+        in.buffer,  in.offset,      in.strides[0], in.strides[1], out.buffer,
+        out.offset, out.strides[1], in.sizes[0],   in.sizes[1],
+    };
+    if (isSum) {
+      rewriter.create<IREE::VMVX::ReduceSumOp>(loc, TypeRange{}, operands);
+    } else {
+      rewriter.create<IREE::VMVX::ReduceMaxOp>(loc, TypeRange{}, operands);
+    }
+    rewriter.eraseOp(op);
+    return success();
+  }
+};
+
+//===----------------------------------------------------------------------===//
+// linalg.matmul
+//===----------------------------------------------------------------------===//
+
+struct LinalgMatmulToVMVX : public OpRewritePattern<linalg::MatmulOp> {
+  using OpRewritePattern::OpRewritePattern;
+
+  LogicalResult matchAndRewrite(linalg::MatmulOp op,
+                                PatternRewriter &rewriter) const override {
+    if (!op.hasBufferSemantics()) return failure();
+    SmallVector<ViewSource, 3> sources;
+    for (auto *operand : op.getInputAndOutputOperands()) {
+      auto memrefType = operand->get().getType().dyn_cast<MemRefType>();
+      if (!memrefType || !memrefType.getElementType().isF32()) {
+        return failure();
+      }
+      auto source = matchViewSource(operand->get());
+      if (!source || !hasUnitInnerStride(*source)) return failure();
+      sources.push_back(*source);
+    }
+
+    auto loc = op.getLoc();
+    auto lhs = buildStridedView(rewriter, loc, sources[0]);
+    auto rhs = buildStridedView(rewriter, loc, sources[1]);
+    auto out = buildStridedView(rewriter, loc, sources[2]);
+    rewriter.replaceOpWithNewOp<IREE::VMVX::MatmulOp>(
+        op, lhs.buffer, lhs.offset, lhs.strides[0], rhs.buffer, rhs.offset,
+        rhs.strides[0], out.buffer, out.offset, out.strides[0], lhs.sizes[0],
+        rhs.sizes[1], lhs.sizes[1]);
+    return success();
+  }
+};
+
+}  // namespace
+
+void populateLinalgToVMVXPatterns(MLIRContext *context,
+                                  OwningRewritePatternList &patterns) {
+  patterns.insert<LinalgCopyToVMVX, LinalgElementwiseToVMVX, LinalgFillToVMVX,
+                  LinalgMatmulToVMVX, LinalgReductionToVMVX>(context);
+}
+
+}  // namespace iree_compiler
+}  // namespace mlir
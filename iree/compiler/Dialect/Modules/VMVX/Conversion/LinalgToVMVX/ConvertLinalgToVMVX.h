@@ -0,0 +1,24 @@
+// Copyright 2021 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#ifndef IREE_COMPILER_DIALECT_MODULES_VMVX_CONVERSION_LINALGTOVMVX_CONVERTLINALGTOVMVX_H_
+#define IREE_COMPILER_DIALECT_MODULES_VMVX_CONVERSION_LINALGTOVMVX_CONVERTLINALGTOVMVX_H_
+
+#include "mlir/IR/PatternMatch.h"
+
+namespace mlir {
+namespace iree_compiler {
+
+// Populates patterns that rewrite linalg ops on buffers to VMVX microkernel
+// ops. Only ops whose operands can be expressed as strided views of interface
+// bindings are rewritten; all others are left to be lowered to loops.
+void populateLinalgToVMVXPatterns(MLIRContext *context,
+                                  OwningRewritePatternList &patterns);
+
+}  // namespace iree_compiler
+}  // namespace mlir
+
+#endif  // IREE_COMPILER_DIALECT_MODULES_VMVX_CONVERSION_LINALGTOVMVX_CONVERTLINALGTOVMVX_H_
@@ -0,0 +1,183 @@
+// RUN: iree-opt -split-input-file -iree-vmvx-lower-linalg-microkernels -canonicalize %s | IreeFileCheck %s
+
+hal.interface @io attributes {sym_visibility = "private"} {
+  hal.interface.binding @s0b0_ro_external, set=0, binding=0, type="StorageBuffer", access="Read"
+  hal.interface.binding @s0b1_ro_external, set=0, binding=1, type="StorageBuffer", access="Read"
+  hal.interface.binding @s0b2_xw_external, set=0, binding=2, type="StorageBuffer", access="Write|Discard"
+}
+
+// CHECK-LABEL: func @matmul
+func @matmul() {
+  %c0 = constant 0 : index
+  %c8 = constant 8 : index
+  %c16 = constant 16 : index
+  //  CHECK-DAG: %[[C0:.+]] = constant 0 : index
+  //  CHECK-DAG: %[[C4:.+]] = constant 4 : index
+  //  CHECK-DAG: %[[C8:.+]] = constant 8 : index
+  //  CHECK-DAG: %[[C16:.+]] = constant 16 : index
+  //  CHECK-DAG: %[[C32:.+]] = constant 32 : index
+  //  CHECK-DAG: %[[C64:.+]] = constant 64 : index
+  //      CHECK: %[[LHS:.+]] = hal.interface.binding.subspan @io::@s0b0_ro_external[%[[C0]]] : memref<16x32xf32>
+  //      CHECK: %[[RHS:.+]] = hal.interface.binding.subspan @io::@s0b1_ro_external[%[[C0]]] : memref<32x64xf32>
+  //      CHECK: %[[OUT:.+]] = hal.interface.binding.subspan @io::@s0b2_xw_external[%[[C0]]] : memref<16x64xf32>
+  %lhs = hal.interface.binding.subspan @io::@s0b0_ro_external[%c0] : memref<16x32xf32>
+  %rhs = hal.interface.binding.subspan @io::@s0b1_ro_external[%c0] : memref<32x64xf32>
+  %out = hal.interface.binding.subspan @io::@s0b2_xw_external[%c0] : memref<16x64xf32>
+  %0 = memref.subview %lhs[%c8, 0] [4, 32] [1, 1] : memref<16x32xf32> to memref<4x32xf32, affine_map<(d0, d1)[s0] -> (d0 * 32 + s0 + d1)>>
+  %1 = memref.subview %rhs[0, %c16] [32, 8] [1, 1] : memref<32x64xf32> to memref<32x8xf32, affine_map<(d0, d1)[s0] -> (d0 * 64 + s0 + d1)>>
+  %2 = memref.subview %out[%c8, %c16] [4, 8] [1, 1] : memref<16x64xf32> to memref<4x8xf32, affine_map<(d0, d1)[s0] -> (d0 * 64 + s0 + d1)>>
+  //  CHECK-DAG: %[[LHS_BUFFER:.+]] = unrealized_conversion_cast %[[LHS]] : memref<16x32xf32> to memref<?xf32>
+  //  CHECK-DAG: %[[RHS_BUFFER:.+]] = unrealized_conversion_cast %[[RHS]] : memref<32x64xf32> to memref<?xf32>
+  //  CHECK-DAG: %[[OUT_BUFFER:.+]] = unrealized_conversion_cast %[[OUT]] : memref<16x64xf32> to memref<?xf32>
+  //      CHECK: vmvx.matmul
+  // CHECK-SAME:   lhs(%[[LHS_BUFFER]] offset %[[C256:.+]] row_stride %[[C32]] : memref<?xf32>)
+  // CHECK-SAME:   rhs(%[[RHS_BUFFER]] offset %[[C16]] row_stride %[[C64]] : memref<?xf32>)
+  // CHECK-SAME:   out(%[[OUT_BUFFER]] offset %[[C528:.+]] row_stride %[[C64]] : memref<?xf32>)
+  // CHECK-SAME:   sizes(%[[C4]], %[[C8]], %[[C32]])
+  //  CHECK-NOT: linalg.matmul
+  linalg.matmul ins(%0, %1 : memref<4x32xf32, affine_map<(d0, d1)[s0] -> (d0 * 32 + s0 + d1)>>, memref<32x8xf32, affine_map<(d0, d1)[s0] -> (d0 * 64 + s0 + d1)>>)
+                outs(%2 : memref<4x8xf32, affine_map<(d0, d1)[s0] -> (d0 * 64 + s0 + d1)>>)
+  return
+}
+
+// -----
+
+hal.interface @io attributes {sym_visibility = "private"} {
+  hal.interface.binding @s0b0_ro_external, set=0, binding=0, type="StorageBuffer", access="Read"
+  hal.interface.binding @s0b1_xw_external, set=0, binding=1, type="StorageBuffer", access="Write|Discard"
+}
+
+// CHECK-LABEL: func @copy_fill
+func @copy_fill() {
+  %c0 = constant 0 : index
+  %c64 = constant 64 : index
+  %cst = constant 1.000000e+00 : f32
+  //  CHECK-DAG: %[[C0:.+]] = constant 0 : index
+  //  CHECK-DAG: %[[C1:.+]] = constant 1 : index
+  //  CHECK-DAG: %[[C4:.+]] = constant 4 : index
+  //  CHECK-DAG: %[[C8:.+]] = constant 8 : index
+  //  CHECK-DAG: %[[C16:.+]] = constant 16 : index
+  //  CHECK-DAG: %[[C32:.+]] = constant 32 : index
+  //  CHECK-DAG: %[[ONE_BITS:.+]] = constant 1065353216 : i32
+  %src = hal.interface.binding.subspan @io::@s0b0_ro_external[%c0] : memref<8x16xi16>
+  // The byte offset of the target is folded into the element offset.
+  //      CHECK: hal.interface.binding.subspan @io::@s0b1_xw_external[%[[C0]]] : memref<8x16xi16>
+  %dst = hal.interface.binding.subspan @io::@s0b1_xw_external[%c64] : memref<8x16xi16>
+  //      CHECK: vmvx.copy
+  // CHECK-SAME:   source(%{{.+}} offset %[[C0]] strides[%[[C16]], %[[C1]]] : memref<?xi16>)
+  // CHECK-SAME:   target(%{{.+}} offset %[[C32]] strides[%[[C16]], %[[C1]]] : memref<?xi16>)
+  // CHECK-SAME:   sizes(%[[C8]], %[[C16]])
+  linalg.copy(%src, %dst) : memref<8x16xi16>, memref<8x16xi16>
+  %out = hal.interface.binding.subspan @io::@s0b1_xw_external[%c0] : memref<4x8xf32>
+  //      CHECK: vmvx.fill
+  // CHECK-SAME:   value(%[[ONE_BITS]])
+  // CHECK-SAME:   sizes(%[[C4]], %[[C8]])
+  linalg.fill(%out, %cst) : memref<4x8xf32>, f32
+  return
+}
+
+// -----
+
+hal.interface @io attributes {sym_visibility = "private"} {
+  hal.interface.binding @s0b0_ro_external, set=0, binding=0, type="StorageBuffer", access="Read"
+  hal.interface.binding @s0b1_ro_external, set=0, binding=1, type="StorageBuffer", access="Read"
+  hal.interface.binding @s0b2_xw_external, set=0, binding=2, type="StorageBuffer", access="Write|Discard"
+}
+
+#map = affine_map<(d0, d1) -> (d0, d1)>
+
+// CHECK-LABEL: func @elementwise
+func @elementwise() {
+  %c0 = constant 0 : index
+  %lhs = hal.interface.binding.subspan @io::@s0b0_ro_external[%c0] : memref<4x8xf32>
+  %rhs = hal.interface.binding.subspan @io::@s0b1_ro_external[%c0] : memref<4x8xf32>
+  %out = hal.interface.binding.subspan @io::@s0b2_xw_external[%c0] : memref<4x8xf32>
+  //      CHECK: vmvx.add
+  //  CHECK-NOT: linalg.generic
+  linalg.generic {indexing_maps = [#map, #map, #map], iterator_types = ["parallel", "parallel"]}
+      ins(%lhs, %rhs : memref<4x8xf32>, memref<4x8xf32>) outs(%out : memref<4x8xf32>) {
+  ^bb0(%a: f32, %b: f32, %c: f32):
+    %0 = addf %a, %b : f32
+    linalg.yield %0 : f32
+  }
+  //      CHECK: vmvx.fma
+  linalg.generic {indexing_maps = [#map, #map, #map], iterator_types = ["parallel", "parallel"]}
+      ins(%lhs, %rhs : memref<4x8xf32>, memref<4x8xf32>) outs(%out : memref<4x8xf32>) {
+  ^bb0(%a: f32, %b: f32, %c: f32):
+    %0 = mulf %a, %b : f32
+    %1 = addf %0, %c : f32
+    linalg.yield %1 : f32
+  }
+  // Unsupported bodies are left for the loop lowering.
+  //      CHECK: linalg.generic
+  //      CHECK: subf
+  linalg.generic {indexing_maps = [#map, #map, #map], iterator_types = ["parallel", "parallel"]}
+      ins(%lhs, %rhs : memref<4x8xf32>, memref<4x8xf32>) outs(%out : memref<4x8xf32>) {
+  ^bb0(%a: f32, %b: f32, %c: f32):
+    %0 = subf %a, %b : f32
+    linalg.yield %0 : f32
+  }
+  return
+}
+
+// -----
+
+hal.interface @io attributes {sym_visibility = "private"} {
+  hal.interface.binding @s0b0_ro_external, set=0, binding=0, type="StorageBuffer", access="Read"
+  hal.interface.binding @s0b1_xw_external, set=0, binding=1, type="StorageBuffer", access="Write|Discard"
+}
+
+// CHECK-LABEL: func @reduce
+func @reduce() {
+  %c0 = constant 0 : index
+  //  CHECK-DAG: %[[C0:.+]] = constant 0 : index
+  //  CHECK-DAG: %[[C1:.+]] = constant 1 : index
+  //  CHECK-DAG: %[[C4:.+]] = constant 4 : index
+  //  CHECK-DAG: %[[C8:.+]] = constant 8 : index
+  %in = hal.interface.binding.subspan @io::@s0b0_ro_external[%c0] : memref<4x8xf32>
+  %out = hal.interface.binding.subspan @io::@s0b1_xw_external[%c0] : memref<8xf32>
+  // Reducing the outer dimension transposes the input view.
+  //      CHECK: vmvx.reduce.max
+  // CHECK-SAME:   in(%{{.+}} offset %[[C0]] strides[%[[C1]], %[[C8]]] : memref<?xf32>)
+  // CHECK-SAME:   out(%{{.+}} offset %[[C0]] strides[%[[C1]]] : memref<?xf32>)
+  // CHECK-SAME:   sizes(%[[C8]], %[[C4]])
+  linalg.generic {indexing_maps = [affine_map<(d0, d1) -> (d0, d1)>, affine_map<(d0, d1) -> (d1)>], iterator_types = ["reduction", "parallel"]}
+      ins(%in : memref<4x8xf32>) outs(%out : memref<8xf32>) {
+  ^bb0(%a: f32, %b: f32):
+    %0 = cmpf ogt, %a, %b : f32
+    %1 = select %0, %a, %b : f32
+    linalg.yield %1 : f32
+  }
+  return
+}
+
+// -----
+
+hal.interface @io attributes {sym_visibility = "private"} {
+  hal.interface.binding @s0b0_ro_external, set=0, binding=0, type="StorageBuffer", access="Read"
+  hal.interface.binding @s0b1_xw_external, set=0, binding=1, type="StorageBuffer", access="Write|Discard"
+}
+
+// CHECK-LABEL: func @byte_offset_alignment
+func @byte_offset_alignment(%offset: index) {
+  %c0 = constant 0 : index
+  %c2 = constant 2 : index
+  //  CHECK-DAG: %[[C0:.+]] = constant 0 : index
+  //  CHECK-DAG: %[[C4:.+]] = constant 4 : index
+  %src = hal.interface.binding.subspan @io::@s0b0_ro_external[%c0] : memref<4xf32>
+  // Static byte offsets that are not a multiple of the element size cannot be
+  // expressed as an element offset and are left for the loop lowering.
+  //      CHECK: linalg.copy
+  %unaligned = hal.interface.binding.subspan @io::@s0b1_xw_external[%c2] : memref<4xf32>
+  linalg.copy(%src, %unaligned) : memref<4xf32>, memref<4xf32>
+  // Dynamic byte offsets are checked at runtime.
+  //      CHECK: %[[REM:.+]] = remi_unsigned %{{.+}}, %[[C4]] : index
+  //      CHECK: %[[ALIGNED:.+]] = cmpi eq, %[[REM]], %[[C0]] : index
+  //      CHECK: assert %[[ALIGNED]], "binding byte offset must be a multiple of the element size"
+  //      CHECK: %[[ELEMENT_OFFSET:.+]] = divi_unsigned %{{.+}}, %[[C4]] : index
+  //      CHECK: vmvx.copy
+  // CHECK-SAME:   target(%{{.+}} offset %[[ELEMENT_OFFSET]]
+  %dynamic = hal.interface.binding.subspan @io::@s0b1_xw_external[%offset] : memref<4xf32>
+  linalg.copy(%src, %dynamic) : memref<4xf32>, memref<4xf32>
+  return
+}
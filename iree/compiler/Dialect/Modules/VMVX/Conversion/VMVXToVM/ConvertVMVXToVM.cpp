@@ -112,12 +112,76 @@ class VMVXImportOpConversion : public OpConversionPattern<T> {
   patterns.insert<VMVXImportOpConversion<op_type>>( \
       context, importSymbols, typeConverter, op_mnemonic);
 
+// Returns the element type of a memref buffer |value|.
+static Type getBufferElementType(Value value) {
+  return value.getType().cast<MemRefType>().getElementType();
+}
+
+// Ops that only care about the bit width of their elements, like copies.
+// Imported as `<name>.x<bits>`.
+template <typename T>
+class VMVXSizedImportOpConversion : public VMVXImportOpConversion<T> {
+ public:
+  using VMVXImportOpConversion<T>::VMVXImportOpConversion;
+
+ protected:
+  std::string getImportSuffix(T op) const override {
+    return "." +
+           this->getSizedTypeStr(getBufferElementType(op.target_buffer()));
+  }
+};
+
+// Ops whose behavior depends on the element type of their result buffer, like
+// arithmetic. Imported as `<name>.<type>`.
+template <typename T>
+class VMVXTypedImportOpConversion : public VMVXImportOpConversion<T> {
+ public:
+  using VMVXImportOpConversion<T>::VMVXImportOpConversion;
+
+ protected:
+  std::string getImportSuffix(T op) const override {
+    return "." + this->getTypedTypeStr(getBufferElementType(op.out_buffer()));
+  }
+};
+
+// Matmuls are imported with the element types of all operands, as in
+// `matmul.f32f32f32`.
+class VMVXMatmulOpConversion
+    : public VMVXImportOpConversion<IREE::VMVX::MatmulOp> {
+ public:
+  using VMVXImportOpConversion::VMVXImportOpConversion;
+
+ protected:
+  std::string getImportSuffix(IREE::VMVX::MatmulOp op) const override {
+    return "." + getTypedTypeStr(getBufferElementType(op.lhs_buffer())) +
+           getTypedTypeStr(getBufferElementType(op.rhs_buffer())) +
+           getTypedTypeStr(getBufferElementType(op.out_buffer()));
+  }
+};
+
 }  // namespace
 
 void populateVMVXToVMPatterns(MLIRContext *context,
                               TypeConverter &typeConverter,
                               SymbolTable &importSymbols,
-                              OwningRewritePatternList &patterns) {}
+                              OwningRewritePatternList &patterns) {
+  patterns.insert<VMVXSizedImportOpConversion<IREE::VMVX::CopyOp>>(
+      context, importSymbols, typeConverter, "vmvx.copy.2d");
+  patterns.insert<VMVXSizedImportOpConversion<IREE::VMVX::FillOp>>(
+      context, importSymbols, typeConverter, "vmvx.fill.2d");
+  patterns.insert<VMVXTypedImportOpConversion<IREE::VMVX::AddOp>>(
+      context, importSymbols, typeConverter, "vmvx.add.2d");
+  patterns.insert<VMVXTypedImportOpConversion<IREE::VMVX::MulOp>>(
+      context, importSymbols, typeConverter, "vmvx.mul.2d");
+  patterns.insert<VMVXTypedImportOpConversion<IREE::VMVX::FmaOp>>(
+      context, importSymbols, typeConverter, "vmvx.fma.2d");
+  patterns.insert<VMVXTypedImportOpConversion<IREE::VMVX::ReduceMaxOp>>(
+      context, importSymbols, typeConverter, "vmvx.reduce.max.2d");
+  patterns.insert<VMVXTypedImportOpConversion<IREE::VMVX::ReduceSumOp>>(
+      context, importSymbols, typeConverter, "vmvx.reduce.sum.2d");
+  patterns.insert<VMVXMatmulOpConversion>(context, importSymbols,
+                                          typeConverter, "vmvx.matmul");
+}
 
 }  // namespace iree_compiler
 }  // namespace mlir
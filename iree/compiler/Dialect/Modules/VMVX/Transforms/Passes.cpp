@@ -50,6 +50,9 @@ static void buildVectorVMVXTransformPassPipeline(OpPassManager &passManager) {
   // nestedModulePM.addNestedPass<FuncOp>(
   //     createLinalgTileAndVectorizeWorkgroupsPass());
 
+  // Linalg -> VMVX microkernels. Anything not matched is lowered to loops.
+  nestedModulePM.addNestedPass<FuncOp>(createLowerLinalgMicrokernelsPass());
+
   // Linalg -> SCF.
   nestedModulePM.addNestedPass<FuncOp>(createConvertLinalgToLoopsPass());
   nestedModulePM.addNestedPass<FuncOp>(createCanonicalizerPass());
@@ -44,6 +44,10 @@ void createVMVXTransformPassPipeline();
 // Converts from various dialects (HAL, standard, etc) to the VMVX dialect.
 std::unique_ptr<OperationPass<mlir::ModuleOp>> createConversionPass();
 
+// Replaces linalg ops on strided views of interface bindings with calls to the
+// equivalent VMVX microkernels. Unmatched ops are left for the loop lowering.
+std::unique_ptr<OperationPass<FuncOp>> createLowerLinalgMicrokernelsPass();
+
 //===----------------------------------------------------------------------===//
 // Register all Passes
 //===----------------------------------------------------------------------===//
@@ -26,7 +26,235 @@
 vm.module @vmvx {
 
 //===----------------------------------------------------------------------===//
-// VMVX Ops: TODO
+// VMVX Ops: microkernels
 //===----------------------------------------------------------------------===//
+//
+// Buffers are passed as 2-D strided views of (buffer, offset, stride0, stride1)
+// with offsets and strides in elements of the type encoded in the name. All
+// views of a call share the same size0 x size1 shape.
+
+// Copies an 8-bit element view.
+vm.import @copy.2d.x8(
+  %source_buffer : !vm.buffer,
+  %source_offset : i32,
+  %source_stride0 : i32,
+  %source_stride1 : i32,
+  %target_buffer : !vm.buffer,
+  %target_offset : i32,
+  %target_stride0 : i32,
+  %target_stride1 : i32,
+  %size0 : i32,
+  %size1 : i32
+)
+
+// Copies a 16-bit element view.
+vm.import @copy.2d.x16(
+  %source_buffer : !vm.buffer,
+  %source_offset : i32,
+  %source_stride0 : i32,
+  %source_stride1 : i32,
+  %target_buffer : !vm.buffer,
+  %target_offset : i32,
+  %target_stride0 : i32,
+  %target_stride1 : i32,
+  %size0 : i32,
+  %size1 : i32
+)
+
+// Copies a 32-bit element view.
+vm.import @copy.2d.x32(
+  %source_buffer : !vm.buffer,
+  %source_offset : i32,
+  %source_stride0 : i32,
+  %source_stride1 : i32,
+  %target_buffer : !vm.buffer,
+  %target_offset : i32,
+  %target_stride0 : i32,
+  %target_stride1 : i32,
+  %size0 : i32,
+  %size1 : i32
+)
+
+// Fills an 8-bit element view with the low bits of |value|.
+vm.import @fill.2d.x8(
+  %value : i32,
+  %target_buffer : !vm.buffer,
+  %target_offset : i32,
+  %target_stride0 : i32,
+  %target_stride1 : i32,
+  %size0 : i32,
+  %size1 : i32
+)
+
+// Fills a 16-bit element view with the low bits of |value|.
+vm.import @fill.2d.x16(
+  %value : i32,
+  %target_buffer : !vm.buffer,
+  %target_offset : i32,
+  %target_stride0 : i32,
+  %target_stride1 : i32,
+  %size0 : i32,
+  %size1 : i32
+)
+
+// Fills a 32-bit element view with the low bits of |value|.
+vm.import @fill.2d.x32(
+  %value : i32,
+  %target_buffer : !vm.buffer,
+  %target_offset : i32,
+  %target_stride0 : i32,
+  %target_stride1 : i32,
+  %size0 : i32,
+  %size1 : i32
+)
+
+// out = lhs + rhs
+vm.import @add.2d.f32(
+  %lhs_buffer : !vm.buffer,
+  %lhs_offset : i32,
+  %lhs_stride0 : i32,
+  %lhs_stride1 : i32,
+  %rhs_buffer : !vm.buffer,
+  %rhs_offset : i32,
+  %rhs_stride0 : i32,
+  %rhs_stride1 : i32,
+  %out_buffer : !vm.buffer,
+  %out_offset : i32,
+  %out_stride0 : i32,
+  %out_stride1 : i32,
+  %size0 : i32,
+  %size1 : i32
+)
+
+// out = lhs + rhs
+vm.import @add.2d.i32(
+  %lhs_buffer : !vm.buffer,
+  %lhs_offset : i32,
+  %lhs_stride0 : i32,
+  %lhs_stride1 : i32,
+  %rhs_buffer : !vm.buffer,
+  %rhs_offset : i32,
+  %rhs_stride0 : i32,
+  %rhs_stride1 : i32,
+  %out_buffer : !vm.buffer,
+  %out_offset : i32,
+  %out_stride0 : i32,
+  %out_stride1 : i32,
+  %size0 : i32,
+  %size1 : i32
+)
+
+// out = lhs * rhs
+vm.import @mul.2d.f32(
+  %lhs_buffer : !vm.buffer,
+  %lhs_offset : i32,
+  %lhs_stride0 : i32,
+  %lhs_stride1 : i32,
+  %rhs_buffer : !vm.buffer,
+  %rhs_offset : i32,
+  %rhs_stride0 : i32,
+  %rhs_stride1 : i32,
+  %out_buffer : !vm.buffer,
+  %out_offset : i32,
+  %out_stride0 : i32,
+  %out_stride1 : i32,
+  %size0 : i32,
+  %size1 : i32
+)
+
+// out = lhs * rhs
+vm.import @mul.2d.i32(
+  %lhs_buffer : !vm.buffer,
+  %lhs_offset : i32,
+  %lhs_stride0 : i32,
+  %lhs_stride1 : i32,
+  %rhs_buffer : !vm.buffer,
+  %rhs_offset : i32,
+  %rhs_stride0 : i32,
+  %rhs_stride1 : i32,
+  %out_buffer : !vm.buffer,
+  %out_offset : i32,
+  %out_stride0 : i32,
+  %out_stride1 : i32,
+  %size0 : i32,
+  %size1 : i32
+)
+
+// out = a * b + c
+vm.import @fma.2d.f32(
+  %a_buffer : !vm.buffer,
+  %a_offset : i32,
+  %a_stride0 : i32,
+  %a_stride1 : i32,
+  %b_buffer : !vm.buffer,
+  %b_offset : i32,
+  %b_stride0 : i32,
+  %b_stride1 : i32,
+  %c_buffer : !vm.buffer,
+  %c_offset : i32,
+  %c_stride0 : i32,
+  %c_stride1 : i32,
+  %out_buffer : !vm.buffer,
+  %out_offset : i32,
+  %out_stride0 : i32,
+  %out_stride1 : i32,
+  %size0 : i32,
+  %size1 : i32
+)
+
+// out[i] = max(out[i], in[i, 0..size1))
+vm.import @reduce.max.2d.f32(
+  %in_buffer : !vm.buffer,
+  %in_offset : i32,
+  %in_stride0 : i32,
+  %in_stride1 : i32,
+  %out_buffer : !vm.buffer,
+  %out_offset : i32,
+  %out_stride : i32,
+  %size0 : i32,
+  %size1 : i32
+)
+
+// out[i] = sum(out[i], in[i, 0..size1))
+vm.import @reduce.sum.2d.f32(
+  %in_buffer : !vm.buffer,
+  %in_offset : i32,
+  %in_stride0 : i32,
+  %in_stride1 : i32,
+  %out_buffer : !vm.buffer,
+  %out_offset : i32,
+  %out_stride : i32,
+  %size0 : i32,
+  %size1 : i32
+)
+
+// out[i] = sum(out[i], in[i, 0..size1))
+vm.import @reduce.sum.2d.i32(
+  %in_buffer : !vm.buffer,
+  %in_offset : i32,
+  %in_stride0 : i32,
+  %in_stride1 : i32,
+  %out_buffer : !vm.buffer,
+  %out_offset : i32,
+  %out_stride : i32,
+  %size0 : i32,
+  %size1 : i32
+)
+
+// out[m, n] += lhs[m, k] * rhs[k, n] with row-major unit inner strides.
+vm.import @matmul.f32f32f32(
+  %lhs_buffer : !vm.buffer,
+  %lhs_offset : i32,
+  %lhs_row_stride : i32,
+  %rhs_buffer : !vm.buffer,
+  %rhs_offset : i32,
+  %rhs_row_stride : i32,
+  %out_buffer : !vm.buffer,
+  %out_offset : i32,
+  %out_row_stride : i32,
+  %m : i32,
+  %n : i32,
+  %k : i32
+)
 
 }  // module
@@ -746,7 +746,8 @@ static ParseResult parseRodataOp(OpAsmParser &parser, OperationState *result) {
   if (failed(parser.parseSymbolName(nameAttr,
                                     mlir::SymbolTable::getSymbolAttrName(),
                                     result->attributes)) ||
-      failed(parser.parseAttribute(valueAttr, "value", result->attributes))) {
+      failed(parser.parseAttribute(valueAttr, "value", result->attributes)) ||
+      failed(parser.parseOptionalAttrDict(result->attributes))) {
     return failure();
   }
 
@@ -765,6 +766,10 @@ static void printRodataOp(OpAsmPrinter &p, RodataOp &op) {
   p.printSymbolName(op.sym_name());
   p << ' ';
   p.printAttribute(op.value());
+  p.printOptionalAttrDict(
+      op->getAttrs(),
+      /*elidedAttrs=*/{visibilityAttrName, SymbolTable::getSymbolAttrName(),
+                       "value"});
 }
 
 void RodataOp::build(OpBuilder &builder, OperationState &result, StringRef name,
@@ -471,6 +471,18 @@ static iree_vm_FunctionSignatureDef_ref_t makeInternalFunctionSignatureDef(
                                     cconv.getValue(), reflectionAttrsRef, fbb);
 }
 
+// Returns the ordinals of |names| sorted by name. The runtime binary searches
+// these to look up functions by name and compares names bytewise as StringRef
+// does.
+static SmallVector<int32_t, 8> sortOrdinalsByName(ArrayRef<StringRef> names) {
+  SmallVector<int32_t, 8> ordinals(names.size());
+  for (size_t i = 0; i < names.size(); ++i) ordinals[i] = (int32_t)i;
+  llvm::stable_sort(ordinals, [&](int32_t lhs, int32_t rhs) {
+    return names[lhs] < names[rhs];
+  });
+  return ordinals;
+}
+
 // Builds a complete BytecodeModuleDef FlatBuffer object in |fbb|.
 // The order of the encoding is ordered to ensure that all metadata is at the
 // front of the resulting buffer. Large read-only data and bytecode blobs always
@@ -686,6 +698,25 @@ static LogicalResult buildFlatBufferModule(BytecodeTargetOptions targetOptions,
   auto importFuncsRef = fbb.createOffsetVecDestructive(importFuncRefs);
   auto typesRef = fbb.createOffsetVecDestructive(typeRefs);
 
+  // Name indices allow the runtime to resolve functions by name without
+  // scanning the tables. Internal functions only have names when symbols are
+  // preserved.
+  auto importNameIndexRef = fbb.createInt32Vec(sortOrdinalsByName(
+      llvm::to_vector<8>(llvm::map_range(importFuncOps, [](auto importOp) {
+        return importOp.getName();
+      }))));
+  auto exportNameIndexRef = fbb.createInt32Vec(sortOrdinalsByName(
+      llvm::to_vector<8>(llvm::map_range(exportFuncOps, [](auto exportOp) {
+        return exportOp.export_name();
+      }))));
+  flatbuffers_int32_vec_ref_t internalNameIndexRef = 0;
+  if (!targetOptions.stripSymbols) {
+    internalNameIndexRef = fbb.createInt32Vec(sortOrdinalsByName(
+        llvm::to_vector<8>(llvm::map_range(internalFuncOps, [](auto funcOp) {
+          return funcOp.getName();
+        }))));
+  }
+
   int32_t globalRefs = ordinalCounts.global_refs();
   int32_t globalBytes = ordinalCounts.global_bytes();
 
@@ -711,6 +742,12 @@ static LogicalResult buildFlatBufferModule(BytecodeTargetOptions targetOptions,
   iree_vm_BytecodeModuleDef_function_descriptors_add(fbb,
                                                      functionDescriptorsRef);
   iree_vm_BytecodeModuleDef_bytecode_data_add(fbb, bytecodeDataRef);
+  iree_vm_BytecodeModuleDef_imported_function_name_index_add(
+      fbb, importNameIndexRef);
+  iree_vm_BytecodeModuleDef_exported_function_name_index_add(
+      fbb, exportNameIndexRef);
+  iree_vm_BytecodeModuleDef_internal_function_name_index_add(
+      fbb, internalNameIndexRef);
   iree_vm_BytecodeModuleDef_end_as_root(fbb);
 
   return success();
@@ -30,3 +30,32 @@ vm.module @simple_module {
   // CHECK-NEXT:   0
   // CHECK-NEXT: ]
 }
+
+// -----
+
+// CHECK: "name": "name_index_module"
+vm.module @name_index_module {
+  vm.export @c
+  vm.export @a
+  vm.export @b
+  vm.func @c() {
+    vm.return
+  }
+  vm.func @a() {
+    vm.return
+  }
+  vm.func @b() {
+    vm.return
+  }
+
+  //      CHECK: "exported_function_name_index": [
+  // CHECK-NEXT:   1,
+  // CHECK-NEXT:   2,
+  // CHECK-NEXT:   0
+  // CHECK-NEXT: ]
+  //      CHECK: "internal_function_name_index": [
+  // CHECK-NEXT:   1,
+  // CHECK-NEXT:   2,
+  // CHECK-NEXT:   0
+  // CHECK-NEXT: ]
+}
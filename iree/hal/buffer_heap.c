@@ -55,7 +55,7 @@ iree_status_t iree_hal_heap_buffer_create(
   }
 
   IREE_TRACE_ZONE_END(z0);
-  return iree_ok_status();
+  return status;
 }
 
 IREE_API_EXPORT iree_status_t iree_hal_heap_buffer_wrap(
@@ -89,7 +89,7 @@ IREE_API_EXPORT iree_status_t iree_hal_heap_buffer_wrap(
   }
 
   IREE_TRACE_ZONE_END(z0);
-  return iree_ok_status();
+  return status;
 }
 
 static void iree_hal_heap_buffer_destroy(iree_hal_buffer_t* base_buffer) {
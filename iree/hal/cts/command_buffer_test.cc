@@ -248,6 +248,206 @@ TEST_P(CommandBufferTest, CopySubBuffer) {
   iree_hal_buffer_release(host_buffer);
 }
 
+TEST_P(CommandBufferTest, SubmitReusable) {
+  // Omitting IREE_HAL_COMMAND_BUFFER_MODE_ONE_SHOT allows the command buffer to
+  // be submitted multiple times.
+  iree_hal_command_buffer_t* command_buffer;
+  IREE_ASSERT_OK(iree_hal_command_buffer_create(
+      device_, /*mode=*/0, IREE_HAL_COMMAND_CATEGORY_TRANSFER,
+      IREE_HAL_QUEUE_AFFINITY_ANY, &command_buffer));
+
+  iree_hal_buffer_t* device_buffer;
+  IREE_ASSERT_OK(iree_hal_allocator_allocate_buffer(
+      device_allocator_,
+      IREE_HAL_MEMORY_TYPE_DEVICE_LOCAL | IREE_HAL_MEMORY_TYPE_HOST_VISIBLE,
+      IREE_HAL_BUFFER_USAGE_ALL, kBufferSize, &device_buffer));
+
+  std::vector<uint8_t> reference_buffer(kBufferSize);
+
+  IREE_ASSERT_OK(iree_hal_command_buffer_begin(command_buffer));
+  uint8_t val1 = 0x07;
+  IREE_ASSERT_OK(iree_hal_command_buffer_fill_buffer(
+      command_buffer, device_buffer,
+      /*target_offset=*/0, /*length=*/kBufferSize / 2, /*pattern=*/&val1,
+      /*pattern_length=*/sizeof(val1)));
+  std::memset(reference_buffer.data(), val1, kBufferSize / 2);
+  IREE_ASSERT_OK(iree_hal_command_buffer_execution_barrier(
+      command_buffer, IREE_HAL_EXECUTION_STAGE_COMMAND_RETIRE,
+      IREE_HAL_EXECUTION_STAGE_COMMAND_ISSUE,
+      IREE_HAL_EXECUTION_BARRIER_FLAG_NONE,
+      /*memory_barrier_count=*/0, /*memory_barriers=*/NULL,
+      /*buffer_barrier_count=*/0, /*buffer_barriers=*/NULL));
+  uint8_t val2 = 0xbe;
+  IREE_ASSERT_OK(
+      iree_hal_command_buffer_fill_buffer(command_buffer, device_buffer,
+                                          /*target_offset=*/kBufferSize / 2,
+                                          /*length=*/kBufferSize / 2,
+                                          /*pattern=*/&val2,
+                                          /*pattern_length=*/sizeof(val2)));
+  std::memset(reference_buffer.data() + kBufferSize / 2, val2, kBufferSize / 2);
+  IREE_ASSERT_OK(iree_hal_command_buffer_end(command_buffer));
+
+  for (int i = 0; i < 3; ++i) {
+    // Clear the buffer so that we know each submission produced the results.
+    uint8_t zero = 0;
+    IREE_ASSERT_OK(iree_hal_buffer_fill(device_buffer, /*byte_offset=*/0,
+                                        /*byte_length=*/kBufferSize, &zero,
+                                        /*pattern_length=*/sizeof(zero)));
+
+    IREE_ASSERT_OK(SubmitCommandBufferAndWait(
+        IREE_HAL_COMMAND_CATEGORY_TRANSFER, command_buffer));
+
+    std::vector<uint8_t> actual_data(kBufferSize);
+    IREE_ASSERT_OK(
+        iree_hal_buffer_read_data(device_buffer, /*source_offset=*/0,
+                                  /*target_buffer=*/actual_data.data(),
+                                  /*data_length=*/kBufferSize));
+    EXPECT_THAT(actual_data, ContainerEq(reference_buffer));
+  }
+
+  // Must release the command buffer before resources used by it.
+  iree_hal_command_buffer_release(command_buffer);
+  iree_hal_buffer_release(device_buffer);
+}
+
+TEST_P(CommandBufferTest, SubmitReusableWhilePending) {
+  // TODO(#4680): semaphores are not implemented on the cuda backend yet.
+  if (GetParam() == "cuda") {
+    GTEST_SKIP();
+  }
+
+  iree_hal_buffer_t* buffers[4] = {NULL};
+  for (int i = 0; i < IREE_ARRAYSIZE(buffers); ++i) {
+    IREE_ASSERT_OK(iree_hal_allocator_allocate_buffer(
+        device_allocator_,
+        IREE_HAL_MEMORY_TYPE_DEVICE_LOCAL | IREE_HAL_MEMORY_TYPE_HOST_VISIBLE,
+        IREE_HAL_BUFFER_USAGE_ALL, kBufferSize, &buffers[i]));
+    uint8_t zero = 0;
+    IREE_ASSERT_OK(iree_hal_buffer_fill(buffers[i], /*byte_offset=*/0,
+                                        /*byte_length=*/kBufferSize, &zero,
+                                        /*pattern_length=*/sizeof(zero)));
+  }
+  iree_hal_buffer_t* source_buffer = buffers[0];
+  iree_hal_buffer_t* target_buffer = buffers[1];
+  iree_hal_buffer_t* result_buffer_a = buffers[2];
+  iree_hal_buffer_t* result_buffer_b = buffers[3];
+  uint8_t val = 0x5a;
+  IREE_ASSERT_OK(iree_hal_buffer_fill(source_buffer, /*byte_offset=*/0,
+                                      /*byte_length=*/kBufferSize, &val,
+                                      /*pattern_length=*/sizeof(val)));
+  std::vector<uint8_t> reference_buffer(kBufferSize, val);
+
+  // Reusable command buffer copying source -> target.
+  iree_hal_command_buffer_t* reusable_command_buffer;
+  IREE_ASSERT_OK(iree_hal_command_buffer_create(
+      device_, /*mode=*/0, IREE_HAL_COMMAND_CATEGORY_TRANSFER,
+      IREE_HAL_QUEUE_AFFINITY_ANY, &reusable_command_buffer));
+  IREE_ASSERT_OK(iree_hal_command_buffer_begin(reusable_command_buffer));
+  IREE_ASSERT_OK(iree_hal_command_buffer_copy_buffer(
+      reusable_command_buffer, source_buffer, /*source_offset=*/0,
+      target_buffer, /*target_offset=*/0, /*length=*/kBufferSize));
+  IREE_ASSERT_OK(iree_hal_command_buffer_end(reusable_command_buffer));
+
+  // Captures target -> result_a and then clears target so that the second
+  // submission of the reusable command buffer must produce its own results.
+  iree_hal_command_buffer_t* capture_command_buffer_a;
+  IREE_ASSERT_OK(iree_hal_command_buffer_create(
+      device_, IREE_HAL_COMMAND_BUFFER_MODE_ONE_SHOT,
+      IREE_HAL_COMMAND_CATEGORY_TRANSFER, IREE_HAL_QUEUE_AFFINITY_ANY,
+      &capture_command_buffer_a));
+  IREE_ASSERT_OK(iree_hal_command_buffer_begin(capture_command_buffer_a));
+  IREE_ASSERT_OK(iree_hal_command_buffer_copy_buffer(
+      capture_command_buffer_a, target_buffer, /*source_offset=*/0,
+      result_buffer_a, /*target_offset=*/0, /*length=*/kBufferSize));
+  IREE_ASSERT_OK(iree_hal_command_buffer_execution_barrier(
+      capture_command_buffer_a, IREE_HAL_EXECUTION_STAGE_COMMAND_RETIRE,
+      IREE_HAL_EXECUTION_STAGE_COMMAND_ISSUE,
+      IREE_HAL_EXECUTION_BARRIER_FLAG_NONE,
+      /*memory_barrier_count=*/0, /*memory_barriers=*/NULL,
+      /*buffer_barrier_count=*/0, /*buffer_barriers=*/NULL));
+  uint8_t zero = 0;
+  IREE_ASSERT_OK(iree_hal_command_buffer_fill_buffer(
+      capture_command_buffer_a, target_buffer, /*target_offset=*/0,
+      /*length=*/kBufferSize, /*pattern=*/&zero,
+      /*pattern_length=*/sizeof(zero)));
+  IREE_ASSERT_OK(iree_hal_command_buffer_end(capture_command_buffer_a));
+
+  // Captures target -> result_b.
+  iree_hal_command_buffer_t* capture_command_buffer_b;
+  IREE_ASSERT_OK(iree_hal_command_buffer_create(
+      device_, IREE_HAL_COMMAND_BUFFER_MODE_ONE_SHOT,
+      IREE_HAL_COMMAND_CATEGORY_TRANSFER, IREE_HAL_QUEUE_AFFINITY_ANY,
+      &capture_command_buffer_b));
+  IREE_ASSERT_OK(iree_hal_command_buffer_begin(capture_command_buffer_b));
+  IREE_ASSERT_OK(iree_hal_command_buffer_copy_buffer(
+      capture_command_buffer_b, target_buffer, /*source_offset=*/0,
+      result_buffer_b, /*target_offset=*/0, /*length=*/kBufferSize));
+  IREE_ASSERT_OK(iree_hal_command_buffer_end(capture_command_buffer_b));
+
+  // Chain the submissions on a timeline gated on a value only the host
+  // signals. The reusable command buffer is submitted a second time while its
+  // first submission is still pending.
+  iree_hal_semaphore_t* semaphore;
+  IREE_ASSERT_OK(iree_hal_semaphore_create(device_, 0ull, &semaphore));
+  iree_hal_command_buffer_t* command_buffers[] = {
+      reusable_command_buffer,
+      capture_command_buffer_a,
+      reusable_command_buffer,
+      capture_command_buffer_b,
+  };
+  for (int i = 0; i < IREE_ARRAYSIZE(command_buffers); ++i) {
+    uint64_t wait_value = 1ull + i;
+    uint64_t signal_value = 2ull + i;
+    iree_hal_submission_batch_t submission_batch;
+    submission_batch.wait_semaphores.count = 1;
+    submission_batch.wait_semaphores.semaphores = &semaphore;
+    submission_batch.wait_semaphores.payload_values = &wait_value;
+    submission_batch.command_buffer_count = 1;
+    submission_batch.command_buffers = &command_buffers[i];
+    submission_batch.signal_semaphores.count = 1;
+    submission_batch.signal_semaphores.semaphores = &semaphore;
+    submission_batch.signal_semaphores.payload_values = &signal_value;
+    IREE_ASSERT_OK(iree_hal_device_queue_submit(
+        device_, IREE_HAL_COMMAND_CATEGORY_TRANSFER,
+        IREE_HAL_QUEUE_AFFINITY_ANY, /*batch_count=*/1, &submission_batch));
+  }
+
+  // Nothing may have executed before the gate is opened.
+  std::vector<uint8_t> zero_buffer(kBufferSize, 0);
+  std::vector<uint8_t> actual_data(kBufferSize);
+  IREE_ASSERT_OK(iree_hal_buffer_read_data(result_buffer_a,
+                                           /*source_offset=*/0,
+                                           /*target_buffer=*/actual_data.data(),
+                                           /*data_length=*/kBufferSize));
+  EXPECT_THAT(actual_data, ContainerEq(zero_buffer));
+
+  IREE_ASSERT_OK(iree_hal_semaphore_signal(semaphore, 1ull));
+  IREE_ASSERT_OK(iree_hal_semaphore_wait(
+      semaphore, 1ull + IREE_ARRAYSIZE(command_buffers),
+      iree_infinite_timeout()));
+
+  // Both submissions of the reusable command buffer produced their results.
+  IREE_ASSERT_OK(iree_hal_buffer_read_data(result_buffer_a,
+                                           /*source_offset=*/0,
+                                           /*target_buffer=*/actual_data.data(),
+                                           /*data_length=*/kBufferSize));
+  EXPECT_THAT(actual_data, ContainerEq(reference_buffer));
+  IREE_ASSERT_OK(iree_hal_buffer_read_data(result_buffer_b,
+                                           /*source_offset=*/0,
+                                           /*target_buffer=*/actual_data.data(),
+                                           /*data_length=*/kBufferSize));
+  EXPECT_THAT(actual_data, ContainerEq(reference_buffer));
+
+  // Must release the command buffers before resources used by them.
+  iree_hal_semaphore_release(semaphore);
+  iree_hal_command_buffer_release(capture_command_buffer_b);
+  iree_hal_command_buffer_release(capture_command_buffer_a);
+  iree_hal_command_buffer_release(reusable_command_buffer);
+  for (int i = 0; i < IREE_ARRAYSIZE(buffers); ++i) {
+    iree_hal_buffer_release(buffers[i]);
+  }
+}
+
 INSTANTIATE_TEST_SUITE_P(
     AllDrivers, CommandBufferTest,
     ::testing::ValuesIn(testing::EnumerateAvailableDrivers()),
@@ -123,6 +123,70 @@ TEST_P(EventTest, SubmitWithChainedCommandBuffers) {
   iree_hal_event_release(event);
 }
 
+TEST_P(EventTest, WaitOrdersWithinCommandBuffer) {
+  const iree_device_size_t kBufferSize = 1024;
+  iree_hal_event_t* event;
+  IREE_ASSERT_OK(iree_hal_event_create(device_, &event));
+
+  iree_hal_buffer_t* buffers[3];
+  for (size_t i = 0; i < IREE_ARRAYSIZE(buffers); ++i) {
+    IREE_ASSERT_OK(iree_hal_allocator_allocate_buffer(
+        device_allocator_,
+        IREE_HAL_MEMORY_TYPE_DEVICE_LOCAL | IREE_HAL_MEMORY_TYPE_HOST_VISIBLE,
+        IREE_HAL_BUFFER_USAGE_ALL, kBufferSize, &buffers[i]));
+  }
+
+  iree_hal_command_buffer_t* command_buffer;
+  IREE_ASSERT_OK(iree_hal_command_buffer_create(
+      device_, IREE_HAL_COMMAND_BUFFER_MODE_ONE_SHOT,
+      IREE_HAL_COMMAND_CATEGORY_TRANSFER, IREE_HAL_QUEUE_AFFINITY_ANY,
+      &command_buffer));
+
+  // The copy must observe the fill that precedes the signal but is not
+  // ordered against the unrelated fill recorded between signal and wait.
+  IREE_ASSERT_OK(iree_hal_command_buffer_begin(command_buffer));
+  uint8_t first_value = 0x12;
+  IREE_ASSERT_OK(iree_hal_command_buffer_fill_buffer(
+      command_buffer, buffers[0], /*target_offset=*/0, kBufferSize,
+      &first_value, sizeof(first_value)));
+  IREE_ASSERT_OK(iree_hal_command_buffer_signal_event(
+      command_buffer, event, IREE_HAL_EXECUTION_STAGE_COMMAND_RETIRE));
+  uint8_t second_value = 0x34;
+  IREE_ASSERT_OK(iree_hal_command_buffer_fill_buffer(
+      command_buffer, buffers[1], /*target_offset=*/0, kBufferSize,
+      &second_value, sizeof(second_value)));
+  const iree_hal_event_t* event_pts[] = {event};
+  IREE_ASSERT_OK(iree_hal_command_buffer_wait_events(
+      command_buffer, IREE_ARRAYSIZE(event_pts), event_pts,
+      /*source_stage_mask=*/IREE_HAL_EXECUTION_STAGE_COMMAND_RETIRE,
+      /*target_stage_mask=*/IREE_HAL_EXECUTION_STAGE_COMMAND_ISSUE,
+      /*memory_barrier_count=*/0,
+      /*memory_barriers=*/NULL, /*buffer_barrier_count=*/0,
+      /*buffer_barriers=*/NULL));
+  IREE_ASSERT_OK(iree_hal_command_buffer_copy_buffer(
+      command_buffer, /*source_buffer=*/buffers[0], /*source_offset=*/0,
+      /*target_buffer=*/buffers[2], /*target_offset=*/0, kBufferSize));
+  IREE_ASSERT_OK(iree_hal_command_buffer_end(command_buffer));
+
+  IREE_ASSERT_OK(SubmitCommandBufferAndWait(IREE_HAL_COMMAND_CATEGORY_TRANSFER,
+                                            command_buffer));
+
+  std::vector<uint8_t> actual_data(kBufferSize);
+  IREE_ASSERT_OK(iree_hal_buffer_read_data(buffers[2], /*source_offset=*/0,
+                                           actual_data.data(), kBufferSize));
+  EXPECT_EQ(std::vector<uint8_t>(kBufferSize, first_value), actual_data);
+  IREE_ASSERT_OK(iree_hal_buffer_read_data(buffers[1], /*source_offset=*/0,
+                                           actual_data.data(), kBufferSize));
+  EXPECT_EQ(std::vector<uint8_t>(kBufferSize, second_value), actual_data);
+
+  // Must release the command buffer before resources used by it.
+  iree_hal_command_buffer_release(command_buffer);
+  for (size_t i = 0; i < IREE_ARRAYSIZE(buffers); ++i) {
+    iree_hal_buffer_release(buffers[i]);
+  }
+  iree_hal_event_release(event);
+}
+
 INSTANTIATE_TEST_SUITE_P(
     AllDrivers, EventTest,
     ::testing::ValuesIn(testing::EnumerateAvailableDrivers()),
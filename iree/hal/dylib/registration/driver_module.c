@@ -8,9 +8,11 @@
 
 #include <inttypes.h>
 #include <stddef.h>
+#include <string.h>
 
 #include "iree/base/api.h"
 #include "iree/base/internal/flags.h"
+#include "iree/hal/local/executable_import_registry.h"
 #include "iree/hal/local/executable_loader.h"
 #include "iree/hal/local/loaders/embedded_library_loader.h"
 #include "iree/hal/local/loaders/legacy_library_loader.h"
@@ -27,6 +29,37 @@
 
 #define IREE_HAL_DYLIB_DRIVER_ID 0x58444C4Cu  // XDLL
 
+IREE_FLAG(
+    string, dylib_executable_preparation, "eager",
+    "Controls when executables are prepared (loaded and linked):\n"
+    " 'eager':\n"
+    "   Prepares each executable when it is created by the program.\n"
+    " 'deferred':\n"
+    "   Prepares each executable when it is first dispatched. Executables\n"
+    "   that are never dispatched are never prepared.\n"
+    " 'async':\n"
+    "   Prepares executables concurrently on the task system workers while\n"
+    "   the program continues loading. Dispatches wait for preparation to\n"
+    "   complete.");
+
+static iree_status_t iree_hal_dylib_driver_caching_mode_from_flags(
+    iree_hal_executable_caching_mode_t* out_caching_mode) {
+  const char* mode = FLAG_dylib_executable_preparation;
+  if (strcmp(mode, "eager") == 0) {
+    *out_caching_mode = 0;
+  } else if (strcmp(mode, "deferred") == 0) {
+    *out_caching_mode =
+        IREE_HAL_EXECUTABLE_CACHING_MODE_ALLOW_DEFERRED_PREPARATION;
+  } else if (strcmp(mode, "async") == 0) {
+    *out_caching_mode =
+        IREE_HAL_EXECUTABLE_CACHING_MODE_ALLOW_ASYNC_PREPARATION;
+  } else {
+    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                            "unknown executable preparation mode '%s'", mode);
+  }
+  return iree_ok_status();
+}
+
 static iree_status_t iree_hal_dylib_driver_factory_enumerate(
     void* self, const iree_hal_driver_info_t** out_driver_infos,
     iree_host_size_t* out_driver_info_count) {
@@ -56,17 +89,23 @@ static iree_status_t iree_hal_dylib_driver_factory_try_create(
   iree_hal_task_device_params_t default_params;
   iree_hal_task_device_params_initialize(&default_params);
 
-  iree_status_t status = iree_ok_status();
+  iree_status_t status = iree_hal_dylib_driver_caching_mode_from_flags(
+      &default_params.executable_caching_mode);
+
+  // Executables can import the functions built into the runtime.
+  iree_hal_executable_import_provider_t import_provider =
+      iree_hal_executable_import_registry_provider(
+          iree_hal_executable_import_registry_builtin());
 
   iree_hal_executable_loader_t* loaders[2] = {NULL, NULL};
   iree_host_size_t loader_count = 0;
   if (iree_status_is_ok(status)) {
-    status = iree_hal_embedded_library_loader_create(allocator,
-                                                     &loaders[loader_count++]);
+    status = iree_hal_embedded_library_loader_create(
+        import_provider, allocator, &loaders[loader_count++]);
   }
   if (iree_status_is_ok(status)) {
-    status = iree_hal_legacy_library_loader_create(allocator,
-                                                   &loaders[loader_count++]);
+    status = iree_hal_legacy_library_loader_create(
+        import_provider, allocator, &loaders[loader_count++]);
   }
 
   iree_task_executor_t* executor = NULL;
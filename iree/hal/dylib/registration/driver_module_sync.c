@@ -10,6 +10,7 @@
 #include <stddef.h>
 
 #include "iree/base/api.h"
+#include "iree/hal/local/executable_import_registry.h"
 #include "iree/hal/local/executable_loader.h"
 #include "iree/hal/local/loaders/legacy_library_loader.h"
 #include "iree/hal/local/sync_device.h"
@@ -49,8 +50,10 @@ static iree_status_t iree_hal_dylib_sync_driver_factory_try_create(
   iree_hal_sync_device_params_initialize(&default_params);
 
   iree_hal_executable_loader_t* dylib_loader = NULL;
-  iree_status_t status =
-      iree_hal_legacy_library_loader_create(allocator, &dylib_loader);
+  iree_status_t status = iree_hal_legacy_library_loader_create(
+      iree_hal_executable_import_registry_provider(
+          iree_hal_executable_import_registry_builtin()),
+      allocator, &dylib_loader);
   iree_hal_executable_loader_t* loaders[1] = {dylib_loader};
 
   if (iree_status_is_ok(status)) {
@@ -68,6 +68,21 @@ enum iree_hal_executable_caching_mode_bits_t {
   // be enabled for real usage as the verification is the best way to catch
   // API misuse.
   IREE_HAL_EXECUTABLE_CACHING_MODE_DISABLE_VERIFICATION = 1u << 6,
+  // Allows the cache to return an executable before it has been prepared and
+  // defer preparation until the executable is first used. This reduces load
+  // time for programs containing many executables that may not all be used.
+  // Errors encountered during deferred preparation are reported when the
+  // first dispatch using the executable is recorded instead of when it is
+  // created. Executables may also request this when compiled with a hint.
+  // Caches that do not support deferred preparation ignore this bit.
+  IREE_HAL_EXECUTABLE_CACHING_MODE_ALLOW_DEFERRED_PREPARATION = 1u << 7,
+  // Allows the cache to return an executable before it has been prepared and
+  // begin preparing it asynchronously (such as concurrently with other
+  // executables on worker threads). Uses of the executable prior to the
+  // preparation completing wait for it to complete. Errors are reported as
+  // with IREE_HAL_EXECUTABLE_CACHING_MODE_ALLOW_DEFERRED_PREPARATION.
+  // Caches that do not support asynchronous preparation ignore this bit.
+  IREE_HAL_EXECUTABLE_CACHING_MODE_ALLOW_ASYNC_PREPARATION = 1u << 8,
 };
 typedef uint32_t iree_hal_executable_caching_mode_t;
 
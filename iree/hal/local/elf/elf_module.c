@@ -14,6 +14,28 @@
 #include "iree/hal/local/elf/arch.h"
 #include "iree/hal/local/elf/platform.h"
 
+// Set to 0 to disable mapping segments directly from file-backed ELF data and
+// always copy them into anonymous memory instead.
+#if !defined(IREE_ELF_ENABLE_FILE_MAPPING)
+#define IREE_ELF_ENABLE_FILE_MAPPING 1
+#endif  // !IREE_ELF_ENABLE_FILE_MAPPING
+
+// Minimum total size of the file-backed segment data required to map from a
+// file instead of copying. Small modules are faster to copy than to query for
+// their backing file and map.
+#if !defined(IREE_ELF_FILE_MAPPING_MIN_SIZE)
+#define IREE_ELF_FILE_MAPPING_MIN_SIZE (64 * 1024)
+#endif  // !IREE_ELF_FILE_MAPPING_MIN_SIZE
+
+// Runtime value of the file mapping threshold; see
+// iree_elf_module_set_file_mapping_min_size.
+static iree_host_size_t iree_elf_module_file_mapping_min_size =
+    IREE_ELF_FILE_MAPPING_MIN_SIZE;
+
+void iree_elf_module_set_file_mapping_min_size(iree_host_size_t min_size) {
+  iree_elf_module_file_mapping_min_size = min_size;
+}
+
 //==============================================================================
 // Verification and section/info caching
 //==============================================================================
@@ -25,6 +47,11 @@ typedef struct iree_elf_module_load_state_t {
   const iree_elf_phdr_t* phdr_table;  // ehdr.e_phnum has count
   const iree_elf_shdr_t* shdr_table;  // ehdr.e_shnum has count
 
+  // File backing the ELF data, if any, that segments can be mapped from.
+  // Only valid during iree_elf_module_load_segments.
+  iree_memory_file_t source_file;
+  bool has_source_file;
+
   const iree_elf_dyn_t* dyn_table;  // PT_DYNAMIC
   iree_host_size_t dyn_table_count;
 
@@ -230,6 +257,100 @@ static iree_byte_range_t iree_elf_module_calculate_vaddr_range(
   return byte_range;
 }
 
+// Opens the file backing |raw_data| if all PT_LOAD segments can be mapped
+// directly from it. This requires that each segment's file offset be congruent
+// with its virtual address modulo the host page size and that no two segments
+// share a host page. The check is performed on the data address first so that
+// the (relatively expensive) query is only performed when the ELF is at a
+// suitable alignment, which heap-allocated data practically never is.
+static bool iree_elf_module_open_source_file(
+    iree_const_byte_span_t raw_data, iree_elf_module_load_state_t* load_state) {
+#if IREE_ELF_ENABLE_FILE_MAPPING
+  load_state->has_source_file = false;
+  const iree_host_size_t page_size = load_state->memory_info.normal_page_size;
+  iree_host_size_t mappable_size = 0;
+  for (iree_elf_half_t i = 0; i < load_state->ehdr->e_phnum; ++i) {
+    const iree_elf_phdr_t* phdr = &load_state->phdr_table[i];
+    if (phdr->p_type != IREE_ELF_PT_LOAD || phdr->p_filesz == 0) continue;
+    if (((uintptr_t)raw_data.data + phdr->p_offset) % page_size !=
+        phdr->p_vaddr % page_size) {
+      return false;
+    }
+    uintptr_t page_start = iree_page_align_start(phdr->p_vaddr, page_size);
+    uintptr_t page_end =
+        iree_page_align_end(phdr->p_vaddr + phdr->p_memsz, page_size);
+    for (iree_elf_half_t j = 0; j < i; ++j) {
+      const iree_elf_phdr_t* other_phdr = &load_state->phdr_table[j];
+      if (other_phdr->p_type != IREE_ELF_PT_LOAD) continue;
+      uintptr_t other_page_start =
+          iree_page_align_start(other_phdr->p_vaddr, page_size);
+      uintptr_t other_page_end = iree_page_align_end(
+          other_phdr->p_vaddr + other_phdr->p_memsz, page_size);
+      if (page_start < other_page_end && other_page_start < page_end) {
+        return false;
+      }
+    }
+    mappable_size += phdr->p_filesz;
+  }
+  if (mappable_size < iree_elf_module_file_mapping_min_size) return false;
+
+  iree_status_t status = iree_memory_file_open_from_address(
+      raw_data.data, raw_data.data_length, &load_state->source_file);
+  if (!iree_status_is_ok(status)) {
+    iree_status_ignore(status);
+    return false;
+  }
+  load_state->has_source_file = true;
+  return true;
+#else
+  return false;
+#endif  // IREE_ELF_ENABLE_FILE_MAPPING
+}
+
+// Maps a PT_LOAD segment directly from the source file. Pages are mapped
+// copy-on-write so read-only and executable pages are shared with the system
+// file cache while any pages written during relocation (or at runtime for
+// writable segments) receive private copies.
+static iree_status_t iree_elf_module_map_segment(
+    iree_elf_module_load_state_t* load_state, const iree_elf_phdr_t* phdr,
+    iree_elf_module_t* module) {
+  const iree_host_size_t page_size = load_state->memory_info.normal_page_size;
+
+  // Map the pages containing data present in the file, initially with write
+  // access so that we can apply relocations.
+  iree_byte_range_t file_range = {
+      .offset = phdr->p_vaddr,
+      .length = phdr->p_filesz,
+  };
+  IREE_RETURN_IF_ERROR(iree_memory_view_map_file_range(
+      module->vaddr_bias, file_range, &load_state->source_file,
+      load_state->source_file.offset + phdr->p_offset,
+      IREE_MEMORY_ACCESS_READ | IREE_MEMORY_ACCESS_WRITE));
+
+  if (phdr->p_memsz > phdr->p_filesz) {
+    // The remainder of the last file page contains whatever follows the segment
+    // in the file and must be zeroed (giving the page a private copy).
+    uintptr_t file_end = phdr->p_vaddr + phdr->p_filesz;
+    uintptr_t file_page_end = iree_page_align_end(file_end, page_size);
+    uintptr_t mem_end = phdr->p_vaddr + phdr->p_memsz;
+    memset(module->vaddr_bias + file_end, 0,
+           iree_min(file_page_end, mem_end) - file_end);
+
+    // Any whole pages beyond the file data are committed zero-initialized.
+    if (mem_end > file_page_end) {
+      iree_byte_range_t zero_range = {
+          .offset = file_page_end,
+          .length = mem_end - file_page_end,
+      };
+      IREE_RETURN_IF_ERROR(iree_memory_view_commit_ranges(
+          module->vaddr_bias, 1, &zero_range,
+          IREE_MEMORY_ACCESS_READ | IREE_MEMORY_ACCESS_WRITE));
+    }
+  }
+
+  return iree_ok_status();
+}
+
 // Allocates space for and loads all DT_LOAD segments into the host virtual
 // address space.
 static iree_status_t iree_elf_module_load_segments(
@@ -253,6 +374,15 @@ static iree_status_t iree_elf_module_load_segments(
     const iree_elf_phdr_t* phdr = &load_state->phdr_table[i];
     if (phdr->p_type != IREE_ELF_PT_LOAD) continue;
 
+    // If the source data is a mapped file we can map the segment directly from
+    // it instead of copying. This avoids the copy and allows processes loading
+    // the same file to share the physical pages.
+    if (load_state->has_source_file && phdr->p_filesz > 0) {
+      IREE_RETURN_IF_ERROR(
+          iree_elf_module_map_segment(load_state, phdr, module));
+      continue;
+    }
+
     // Commit the range of pages used by this segment, initially with write
     // access so that we can modify the pages.
     iree_byte_range_t byte_range = {
@@ -264,13 +394,6 @@ static iree_status_t iree_elf_module_load_segments(
         IREE_MEMORY_ACCESS_READ | IREE_MEMORY_ACCESS_WRITE));
 
     // Copy data present in the file.
-    // TODO(benvanik): infra for being able to detect if the source model is in
-    // a mapped file - if it is, we can remap the page and directly reference it
-    // here for read-only segments and setup copy-on-write for writeable ones.
-    // We'd need a way to pass in the underlying mapping and some guarantees on
-    // the lifetime of it. Today we are just always committing above and copying
-    // here because it keeps this all super simple (you know, as simple as an
-    // entire custom ELF loader can be :).
     if (phdr->p_filesz > 0) {
       memcpy(module->vaddr_bias + phdr->p_vaddr, raw_data.data + phdr->p_offset,
              phdr->p_filesz);
@@ -548,6 +671,30 @@ static const iree_elf_sym_t* iree_elf_module_lookup_global_symbol(
 // API
 //==============================================================================
 
+// Loads the segments of the ELF into memory and links them such that the
+// module is ready for initialization.
+static iree_status_t iree_elf_module_load_and_link(
+    iree_const_byte_span_t raw_data, iree_elf_module_load_state_t* load_state,
+    iree_elf_module_t* module) {
+  // Allocate and load the ELF into memory.
+  IREE_RETURN_IF_ERROR(
+      iree_elf_module_load_segments(raw_data, load_state, module));
+
+  // Parse required dynamic symbol tables in loaded memory. These are used for
+  // runtime symbol resolution and relocation.
+  IREE_RETURN_IF_ERROR(
+      iree_elf_module_parse_dynamic_tables(load_state, module));
+
+  // TODO(benvanik): imports would happen here.
+
+  // Apply relocations to the loaded pages.
+  IREE_RETURN_IF_ERROR(iree_elf_module_apply_relocations(load_state, module));
+
+  // Apply final protections to the loaded pages now that relocations have been
+  // performed.
+  return iree_elf_module_protect_segments(load_state, module);
+}
+
 iree_status_t iree_elf_module_initialize_from_memory(
     iree_const_byte_span_t raw_data,
     const iree_elf_import_table_t* import_table,
@@ -564,29 +711,24 @@ iree_status_t iree_elf_module_initialize_from_memory(
   iree_status_t status =
       iree_elf_module_parse_headers(raw_data, &load_state, out_module);
 
-  // Allocate and load the ELF into memory.
+  // Allocate, load, and link the ELF in memory. If the data is backed by a
+  // file we first try mapping the segments from it and if that fails for any
+  // reason (such as the file residing on a noexec mount) retry by copying.
   iree_memory_jit_context_begin();
-  if (iree_status_is_ok(status)) {
-    status = iree_elf_module_load_segments(raw_data, &load_state, out_module);
-  }
-
-  // Parse required dynamic symbol tables in loaded memory. These are used for
-  // runtime symbol resolution and relocation.
-  if (iree_status_is_ok(status)) {
-    status = iree_elf_module_parse_dynamic_tables(&load_state, out_module);
-  }
-
-  // TODO(benvanik): imports would happen here.
-
-  // Apply relocations to the loaded pages.
-  if (iree_status_is_ok(status)) {
-    status = iree_elf_module_apply_relocations(&load_state, out_module);
-  }
-
-  // Apply final protections to the loaded pages now that relocations have been
-  // performed.
-  if (iree_status_is_ok(status)) {
-    status = iree_elf_module_protect_segments(&load_state, out_module);
+  if (iree_status_is_ok(status) &&
+      iree_elf_module_open_source_file(raw_data, &load_state)) {
+    status = iree_elf_module_load_and_link(raw_data, &load_state, out_module);
+    iree_memory_file_close(&load_state.source_file);
+    load_state.has_source_file = false;
+    if (iree_status_is_ok(status)) {
+      out_module->is_file_mapped = true;
+    } else {
+      iree_status_ignore(status);
+      iree_elf_module_unload_segments(out_module);
+      status = iree_elf_module_load_and_link(raw_data, &load_state, out_module);
+    }
+  } else if (iree_status_is_ok(status)) {
+    status = iree_elf_module_load_and_link(raw_data, &load_state, out_module);
   }
   iree_memory_jit_context_end();
 
@@ -604,6 +746,56 @@ iree_status_t iree_elf_module_initialize_from_memory(
   return status;
 }
 
+iree_status_t iree_elf_module_query_section(
+    iree_const_byte_span_t raw_data, iree_string_view_t section_name,
+    iree_const_byte_span_t* out_contents) {
+  IREE_ASSERT_ARGUMENT(out_contents);
+  *out_contents = iree_make_const_byte_span(NULL, 0);
+  IREE_RETURN_IF_ERROR(iree_elf_module_verify_ehdr(raw_data));
+
+  // Section names are stored in the section referenced by e_shstrndx.
+  const iree_elf_ehdr_t* ehdr = (const iree_elf_ehdr_t*)raw_data.data;
+  const iree_elf_shdr_t* shdr_table =
+      (const iree_elf_shdr_t*)(raw_data.data + ehdr->e_shoff);
+  if (ehdr->e_shstrndx == IREE_ELF_SHN_UNDEF ||
+      ehdr->e_shstrndx >= ehdr->e_shnum) {
+    return iree_make_status(IREE_STATUS_NOT_FOUND,
+                            "ELF has no section name table");
+  }
+  const iree_elf_shdr_t* shstrtab = &shdr_table[ehdr->e_shstrndx];
+  if (shstrtab->sh_offset + shstrtab->sh_size > raw_data.data_length) {
+    return iree_make_status(IREE_STATUS_FAILED_PRECONDITION,
+                            "section name table outside of file extents");
+  }
+  const char* names = (const char*)raw_data.data + shstrtab->sh_offset;
+
+  for (iree_elf_half_t i = 0; i < ehdr->e_shnum; ++i) {
+    const iree_elf_shdr_t* shdr = &shdr_table[i];
+    if (shdr->sh_name >= shstrtab->sh_size) continue;
+    // Names are NUL-terminated; bound the comparison to the table so that a
+    // malformed name cannot read past it.
+    const char* name = names + shdr->sh_name;
+    iree_host_size_t name_capacity = shstrtab->sh_size - shdr->sh_name;
+    if (section_name.size >= name_capacity ||
+        memcmp(name, section_name.data, section_name.size) != 0 ||
+        name[section_name.size] != 0) {
+      continue;
+    }
+    if (shdr->sh_type == IREE_ELF_SHT_NOBITS ||
+        shdr->sh_offset + shdr->sh_size > raw_data.data_length) {
+      return iree_make_status(IREE_STATUS_FAILED_PRECONDITION,
+                              "section '%.*s' has no contents in the file",
+                              (int)section_name.size, section_name.data);
+    }
+    *out_contents = iree_make_const_byte_span(
+        raw_data.data + shdr->sh_offset, (iree_host_size_t)shdr->sh_size);
+    return iree_ok_status();
+  }
+  return iree_make_status(IREE_STATUS_NOT_FOUND,
+                          "section '%.*s' not found in module",
+                          (int)section_name.size, section_name.data);
+}
+
 void iree_elf_module_deinitialize(iree_elf_module_t* module) {
   IREE_TRACE_ZONE_BEGIN(z0);
 
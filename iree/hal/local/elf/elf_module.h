@@ -7,6 +7,7 @@
 #ifndef IREE_HAL_LOCAL_ELF_ELF_LINKER_H_
 #define IREE_HAL_LOCAL_ELF_ELF_LINKER_H_
 
+#include <stdbool.h>
 #include <stdint.h>
 
 #include "iree/base/api.h"
@@ -53,12 +54,23 @@ typedef struct iree_elf_module_t {
   // Dynamic symbol table (.dynsym).
   const iree_elf_sym_t* dynsym;   // DT_SYMTAB
   iree_host_size_t dynsym_count;  // DT_SYMENT (bytes) / sizeof(iree_elf_sym_t)
+
+  // True if the segments were mapped from the file backing the source data
+  // instead of being copied into anonymous pages.
+  bool is_file_mapped;
 } iree_elf_module_t;
 
 // Initializes an ELF module from the ELF |raw_data| in memory.
 // |raw_data| only needs to remain valid for the initialization of the module
 // and may be discarded afterward.
 //
+// If |raw_data| resides in a mapping of a file (such as from
+// iree_file_map_contents) with page-aligned segments then the segments are
+// mapped copy-on-write directly from the file instead of being copied. Pages
+// not written during loading are shared with the system file cache and any
+// other process loading the same file. As with any file mapping the file must
+// not be modified in place while the module is loaded.
+//
 // An optional |import_table| may be specified to provide a set of symbols that
 // the module may import. Strong imports will not be resolved from the host
 // system and initialization will fail if any are not present in the provided
@@ -74,6 +86,24 @@ iree_status_t iree_elf_module_initialize_from_memory(
     const iree_elf_import_table_t* import_table,
     iree_allocator_t host_allocator, iree_elf_module_t* out_module);
 
+// Sets the minimum total size, in bytes, of the file-backed segment data of a
+// module required for iree_elf_module_initialize_from_memory to map segments
+// from the file backing the data instead of copying them. Defaults to
+// IREE_ELF_FILE_MAPPING_MIN_SIZE. Intended for tests that need to exercise file
+// mapping with small modules and must not be called while modules are being
+// initialized on other threads.
+void iree_elf_module_set_file_mapping_min_size(iree_host_size_t min_size);
+
+// Returns the file contents of the section named |section_name| in the ELF
+// |raw_data| in |out_contents| without loading the module. The contents alias
+// |raw_data|. Returns IREE_STATUS_NOT_FOUND if no such section is present.
+//
+// This only parses the ELF headers and can be used to inspect metadata the
+// compiler attached to the module prior to deciding whether to load it.
+iree_status_t iree_elf_module_query_section(
+    iree_const_byte_span_t raw_data, iree_string_view_t section_name,
+    iree_const_byte_span_t* out_contents);
+
 // Deinitializes a |module|, releasing any allocated executable or data pages.
 // Invalidates all symbol pointers previous retrieved from the module and any
 // pointer to data that may have been in the module text or rwdata.
@@ -4,7 +4,13 @@
 // See https://llvm.org/LICENSE.txt for license information.
 // SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
 
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
 #include "iree/base/api.h"
+#include "iree/base/internal/file_io.h"
 #include "iree/base/target_platform.h"
 #include "iree/hal/local/elf/elf_module.h"
 #include "iree/hal/local/executable_library.h"
@@ -42,19 +48,17 @@ const iree_const_byte_span_t GetCurrentPlatformFile() {
   return iree_make_const_byte_span(NULL, 0);
 }
 
-iree_status_t Run() {
+// Loads the ELF in |file_data| and runs the simple_mul dispatch.
+static iree_status_t LoadAndRunModule(iree_const_byte_span_t file_data,
+                                      bool* out_is_file_mapped) {
   iree_status_t ret_status = iree_ok_status();
-  const iree_const_byte_span_t file_data = GetCurrentPlatformFile();
-  if (!file_data.data_length) {
-    fprintf(stdout, "No ELF file built for this platform, skip");
-    return ret_status;
-  }
 
   iree_elf_import_table_t import_table;
   memset(&import_table, 0, sizeof(import_table));
   iree_elf_module_t module;
   IREE_RETURN_IF_ERROR(iree_elf_module_initialize_from_memory(
       file_data, &import_table, iree_allocator_system(), &module));
+  *out_is_file_mapped = module.is_file_mapped;
 
   void* query_fn_ptr = NULL;
   IREE_RETURN_IF_ERROR(iree_elf_module_lookup_export(
@@ -67,7 +71,7 @@ iree_status_t Run() {
   library.header =
       (const iree_hal_executable_library_header_t**)iree_elf_call_p_ip(
           query_fn_ptr, IREE_HAL_EXECUTABLE_LIBRARY_LATEST_VERSION,
-          /*reserved=*/NULL);
+          /*environment=*/NULL);
   if (library.header == NULL) {
     return iree_make_status(IREE_STATUS_NOT_FOUND, "library header is empty");
   }
@@ -131,6 +135,95 @@ iree_status_t Run() {
   return ret_status;
 }
 
+// Writes |file_data| to a temporary file and loads it from a mapping of that
+// file. Platforms that support it must map the segments from the file instead
+// of copying them.
+static iree_status_t RunFromFileMapping(iree_const_byte_span_t file_data) {
+  // The test modules are smaller than the default threshold below which
+  // segments are always copied.
+  iree_elf_module_set_file_mapping_min_size(0);
+
+  const char* tmpdir = getenv("TEST_TMPDIR");
+  if (!tmpdir) tmpdir = getenv("TMPDIR");
+  if (!tmpdir) tmpdir = "/tmp";
+  char path[1024];
+  snprintf(path, sizeof(path), "%s/iree_elf_module_test.so", tmpdir);
+  IREE_RETURN_IF_ERROR(iree_file_write_contents(path, file_data));
+
+  iree_file_contents_t* contents = NULL;
+  IREE_RETURN_IF_ERROR(iree_file_map_contents(path, IREE_FILE_MAP_FLAG_NONE,
+                                              iree_allocator_system(),
+                                              &contents));
+  bool is_file_mapped = false;
+  iree_status_t status =
+      LoadAndRunModule(contents->const_buffer, &is_file_mapped);
+#if defined(IREE_PLATFORM_ANDROID) || defined(IREE_PLATFORM_LINUX)
+  if (iree_status_is_ok(status) && contents->mapped && !is_file_mapped) {
+    status = iree_make_status(IREE_STATUS_INTERNAL,
+                              "segments were copied instead of being mapped "
+                              "from the file backing the data");
+  }
+#endif  // IREE_PLATFORM_ANDROID || IREE_PLATFORM_LINUX
+  iree_file_contents_free(contents);
+  remove(path);
+  return status;
+}
+
+// Queries sections of |file_data| without loading it.
+static iree_status_t QuerySections(iree_const_byte_span_t file_data) {
+  // Every module has its dynamic symbol table in a section.
+  iree_const_byte_span_t contents;
+  IREE_RETURN_IF_ERROR(iree_elf_module_query_section(
+      file_data, iree_make_cstring_view(".dynsym"), &contents));
+  if (contents.data < file_data.data ||
+      contents.data + contents.data_length >
+          file_data.data + file_data.data_length ||
+      contents.data_length == 0) {
+    return iree_make_status(IREE_STATUS_INTERNAL,
+                            "section contents outside of the file");
+  }
+
+  // Names must match exactly and not just by prefix.
+  iree_status_t status = iree_elf_module_query_section(
+      file_data, iree_make_cstring_view(".dyn"), &contents);
+  if (!iree_status_is_not_found(status)) {
+    iree_status_ignore(status);
+    return iree_make_status(IREE_STATUS_INTERNAL,
+                            "expected a prefix of a name to not match");
+  }
+  iree_status_ignore(status);
+
+  // The test module was compiled without hints.
+  status = iree_elf_module_query_section(
+      file_data,
+      iree_make_cstring_view(IREE_HAL_EXECUTABLE_LIBRARY_HINTS_SECTION_NAME),
+      &contents);
+  if (!iree_status_is_not_found(status)) {
+    iree_status_ignore(status);
+    return iree_make_status(IREE_STATUS_INTERNAL, "expected no hints section");
+  }
+  iree_status_ignore(status);
+  return iree_ok_status();
+}
+
+iree_status_t Run() {
+  const iree_const_byte_span_t file_data = GetCurrentPlatformFile();
+  if (!file_data.data_length) {
+    fprintf(stdout, "No ELF file built for this platform, skip");
+    return iree_ok_status();
+  }
+
+  // Inspect the module without loading it.
+  IREE_RETURN_IF_ERROR(QuerySections(file_data));
+
+  // Load from memory embedded in the binary; the segments are copied.
+  bool is_file_mapped = false;
+  IREE_RETURN_IF_ERROR(LoadAndRunModule(file_data, &is_file_mapped));
+
+  // Load from a mapping of a file; the segments are mapped from the file.
+  return RunFromFileMapping(file_data);
+}
+
 int main() {
   const iree_status_t result = Run();
   int ret = (int)iree_status_code(result);
@@ -156,4 +156,43 @@ iree_status_t iree_memory_view_protect_ranges(void* base_address,
 // executing code from any pages that have been written during load.
 void iree_memory_view_flush_icache(void* base_address, iree_host_size_t length);
 
+//==============================================================================
+// File-backed memory
+//==============================================================================
+
+// A file opened for reading that backs a range of host memory.
+typedef struct iree_memory_file_t {
+  // Platform file handle (such as a file descriptor).
+  intptr_t handle;
+  // Offset in the file of the host memory the file was opened from.
+  uint64_t offset;
+} iree_memory_file_t;
+
+// Opens the file backing the host memory range [|address|, |address|+|length|)
+// if the range lies entirely within a mapping of a regular file. The file must
+// be closed with iree_memory_file_close.
+//
+// Returns IREE_STATUS_UNAVAILABLE if the memory is not backed by a file or the
+// platform does not support querying it; callers are expected to fall back to
+// copying the memory instead.
+iree_status_t iree_memory_file_open_from_address(const void* address,
+                                                 iree_host_size_t length,
+                                                 iree_memory_file_t* out_file);
+
+// Closes a |file| opened with iree_memory_file_open_from_address.
+void iree_memory_file_close(iree_memory_file_t* file);
+
+// Maps the pages overlapping |range| of a view reserved with
+// iree_memory_view_reserve directly from |file| starting at |file_offset|.
+// |file_offset| must be congruent with |range.offset| modulo the page size.
+// Pages are mapped copy-on-write such that reads share the physical pages
+// with the system file cache (and other processes mapping the same file) and
+// writes create private copies.
+//
+// Implemented by mmap+MAP_PRIVATE|MAP_FIXED.
+iree_status_t iree_memory_view_map_file_range(
+    void* base_address, iree_byte_range_t range,
+    const iree_memory_file_t* file, uint64_t file_offset,
+    iree_memory_access_t initial_access);
+
 #endif  // IREE_HAL_LOCAL_ELF_PLATFORM_H_
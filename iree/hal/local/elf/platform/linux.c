@@ -11,7 +11,13 @@
 #if defined(IREE_PLATFORM_ANDROID) || defined(IREE_PLATFORM_LINUX)
 
 #include <errno.h>
+#include <fcntl.h>
+#include <inttypes.h>
+#include <stdio.h>
+#include <string.h>
 #include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/sysmacros.h>
 #include <unistd.h>
 
 //==============================================================================
@@ -156,4 +162,128 @@ void iree_memory_view_flush_icache(void* base_address,
   IREE_ELF_CLEAR_CACHE(base_address, base_address + length);
 }
 
+//==============================================================================
+// File-backed memory
+//==============================================================================
+
+// Finds the file mapping containing [|address|, |address|+|length|) in
+// /proc/self/maps. On success |out_path| contains the mapped file path and
+// |out_offset| is the file offset of |address|.
+static bool iree_memory_file_find_mapping(uintptr_t address,
+                                          iree_host_size_t length,
+                                          char* out_path,
+                                          iree_host_size_t path_capacity,
+                                          uint64_t* out_offset,
+                                          dev_t* out_dev, ino_t* out_ino) {
+  FILE* maps = fopen("/proc/self/maps", "re");
+  if (!maps) return false;
+  bool found = false;
+  char line[4096 + 128];
+  while (!found && fgets(line, sizeof(line), maps)) {
+    // Format: start-end perms offset major:minor inode [path]
+    uintptr_t start = 0, end = 0;
+    uint64_t offset = 0;
+    unsigned int dev_major = 0, dev_minor = 0;
+    unsigned long inode = 0;
+    int path_start = 0;
+    if (sscanf(line, "%" SCNxPTR "-%" SCNxPTR " %*s %" SCNx64 " %x:%x %lu %n",
+               &start, &end, &offset, &dev_major, &dev_minor, &inode,
+               &path_start) < 6) {
+      continue;
+    }
+    if (address < start || address + length > end) continue;
+    // Anonymous mappings have no inode and pseudo-files do not start with /.
+    if (inode == 0 || path_start == 0 || line[path_start] != '/') break;
+    iree_host_size_t path_length = strcspn(line + path_start, "\n");
+    if (path_length + 1 > path_capacity) break;
+    memcpy(out_path, line + path_start, path_length);
+    out_path[path_length] = 0;
+    *out_offset = offset + (address - start);
+    *out_dev = makedev(dev_major, dev_minor);
+    *out_ino = (ino_t)inode;
+    found = true;
+  }
+  fclose(maps);
+  return found;
+}
+
+iree_status_t iree_memory_file_open_from_address(const void* address,
+                                                 iree_host_size_t length,
+                                                 iree_memory_file_t* out_file) {
+  memset(out_file, 0, sizeof(*out_file));
+  out_file->handle = -1;
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  char path[4096];
+  uint64_t offset = 0;
+  dev_t dev = 0;
+  ino_t ino = 0;
+  if (!iree_memory_file_find_mapping((uintptr_t)address, length, path,
+                                     sizeof(path), &offset, &dev, &ino)) {
+    IREE_TRACE_ZONE_END(z0);
+    return iree_make_status(IREE_STATUS_UNAVAILABLE,
+                            "memory is not backed by a file mapping");
+  }
+
+  // Ensure the file we opened is the one that is mapped and not one that has
+  // since replaced it at the same path.
+  int fd = open(path, O_RDONLY | O_CLOEXEC);
+  struct stat stat_buf;
+  if (fd == -1 || fstat(fd, &stat_buf) == -1 || !S_ISREG(stat_buf.st_mode) ||
+      stat_buf.st_dev != dev || stat_buf.st_ino != ino) {
+    if (fd != -1) close(fd);
+    IREE_TRACE_ZONE_END(z0);
+    return iree_make_status(IREE_STATUS_UNAVAILABLE,
+                            "mapped file '%s' is no longer accessible", path);
+  }
+
+  out_file->handle = fd;
+  out_file->offset = offset;
+  IREE_TRACE_ZONE_END(z0);
+  return iree_ok_status();
+}
+
+void iree_memory_file_close(iree_memory_file_t* file) {
+  if (file->handle != -1) close((int)file->handle);
+  file->handle = -1;
+}
+
+iree_status_t iree_memory_view_map_file_range(
+    void* base_address, iree_byte_range_t range,
+    const iree_memory_file_t* file, uint64_t file_offset,
+    iree_memory_access_t initial_access) {
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  iree_host_size_t page_size = getpagesize();
+  uintptr_t range_start = iree_page_align_start(
+      (uintptr_t)base_address + range.offset, page_size);
+  uintptr_t range_end =
+      iree_page_align_end((uintptr_t)base_address + range.offset + range.length,
+                          page_size);
+  uint64_t page_offset =
+      file_offset - ((uintptr_t)base_address + range.offset - range_start);
+
+  int mmap_prot = iree_memory_access_to_prot(initial_access);
+  int mmap_flags = MAP_PRIVATE | MAP_FIXED;
+
+  iree_status_t status = iree_ok_status();
+  if (page_offset % page_size != 0) {
+    status = iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                              "file offset %" PRIu64
+                              " not congruent with the view page offset",
+                              file_offset);
+  } else {
+    void* result = mmap((void*)range_start, range_end - range_start,
+                        mmap_prot, mmap_flags, (int)file->handle,
+                        (off_t)page_offset);
+    if (result == MAP_FAILED) {
+      status = iree_make_status(iree_status_code_from_errno(errno),
+                                "mmap file range failed");
+    }
+  }
+
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
 #endif  // IREE_PLATFORM_*
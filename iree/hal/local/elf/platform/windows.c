@@ -148,4 +148,26 @@ void iree_memory_view_flush_icache(void* base_address,
   FlushInstructionCache(GetCurrentProcess(), base_address, length);
 }
 
+//==============================================================================
+// File-backed memory
+//==============================================================================
+
+iree_status_t iree_memory_file_open_from_address(const void* address,
+                                                 iree_host_size_t length,
+                                                 iree_memory_file_t* out_file) {
+  memset(out_file, 0, sizeof(*out_file));
+  return iree_make_status(IREE_STATUS_UNAVAILABLE,
+                          "file-backed memory queries not implemented");
+}
+
+void iree_memory_file_close(iree_memory_file_t* file) {}
+
+iree_status_t iree_memory_view_map_file_range(
+    void* base_address, iree_byte_range_t range,
+    const iree_memory_file_t* file, uint64_t file_offset,
+    iree_memory_access_t initial_access) {
+  return iree_make_status(IREE_STATUS_UNAVAILABLE,
+                          "file mapping not implemented");
+}
+
 #endif  // IREE_PLATFORM_WINDOWS
@@ -0,0 +1,84 @@
+// Copyright 2021 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/hal/local/executable_environment.h"
+
+#include <cpuinfo.h>
+#include <string.h>
+
+#include "iree/base/target_platform.h"
+#include "iree/base/tracing.h"
+
+//===----------------------------------------------------------------------===//
+// iree_hal_executable_environment_v0_t
+//===----------------------------------------------------------------------===//
+
+void iree_hal_executable_environment_initialize(
+    iree_hal_executable_environment_v0_t* out_environment) {
+  IREE_ASSERT_ARGUMENT(out_environment);
+  memset(out_environment, 0, sizeof(*out_environment));
+}
+
+// Returns the features available on the host processors as reported by
+// cpuinfo. cpuinfo reports the features common to all processors and returns
+// false for features of other architectures.
+static iree_hal_processor_features_t
+iree_hal_executable_environment_query_processor_features(void) {
+  iree_hal_processor_features_t features = IREE_HAL_PROCESSOR_FEATURE_NONE;
+#if defined(IREE_ARCH_X86_64)
+  if (cpuinfo_has_x86_avx()) {
+    features |= IREE_HAL_PROCESSOR_FEATURE_X86_64_AVX;
+  }
+  if (cpuinfo_has_x86_avx2()) {
+    features |= IREE_HAL_PROCESSOR_FEATURE_X86_64_AVX2;
+  }
+  if (cpuinfo_has_x86_fma3()) {
+    features |= IREE_HAL_PROCESSOR_FEATURE_X86_64_FMA;
+  }
+  if (cpuinfo_has_x86_f16c()) {
+    features |= IREE_HAL_PROCESSOR_FEATURE_X86_64_F16C;
+  }
+  if (cpuinfo_has_x86_avx512f()) {
+    features |= IREE_HAL_PROCESSOR_FEATURE_X86_64_AVX512F;
+  }
+  if (cpuinfo_has_x86_avx512bw()) {
+    features |= IREE_HAL_PROCESSOR_FEATURE_X86_64_AVX512BW;
+  }
+  if (cpuinfo_has_x86_avx512dq()) {
+    features |= IREE_HAL_PROCESSOR_FEATURE_X86_64_AVX512DQ;
+  }
+  if (cpuinfo_has_x86_avx512vl()) {
+    features |= IREE_HAL_PROCESSOR_FEATURE_X86_64_AVX512VL;
+  }
+  if (cpuinfo_has_x86_avx512vnni()) {
+    features |= IREE_HAL_PROCESSOR_FEATURE_X86_64_AVX512VNNI;
+  }
+#elif defined(IREE_ARCH_ARM_64)
+  if (cpuinfo_has_arm_neon_dot()) {
+    features |= IREE_HAL_PROCESSOR_FEATURE_ARM_64_DOTPROD;
+  }
+  if (cpuinfo_has_arm_neon_fp16_arith()) {
+    features |= IREE_HAL_PROCESSOR_FEATURE_ARM_64_FP16;
+  }
+#endif  // IREE_ARCH_*
+  return features;
+}
+
+void iree_hal_executable_environment_initialize_from_host(
+    iree_hal_executable_environment_v0_t* out_environment) {
+  IREE_ASSERT_ARGUMENT(out_environment);
+  IREE_TRACE_ZONE_BEGIN(z0);
+  iree_hal_executable_environment_initialize(out_environment);
+
+  // If cpuinfo is unavailable we fall back to the most portable variants.
+  if (cpuinfo_initialize()) {
+    out_environment->processor_features =
+        iree_hal_executable_environment_query_processor_features();
+  }
+  IREE_TRACE_ZONE_APPEND_VALUE(z0, out_environment->processor_features);
+
+  IREE_TRACE_ZONE_END(z0);
+}
@@ -0,0 +1,39 @@
+// Copyright 2021 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#ifndef IREE_HAL_LOCAL_EXECUTABLE_ENVIRONMENT_H_
+#define IREE_HAL_LOCAL_EXECUTABLE_ENVIRONMENT_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "iree/base/api.h"
+#include "iree/hal/local/executable_library.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif  // __cplusplus
+
+//===----------------------------------------------------------------------===//
+// iree_hal_executable_environment_v0_t
+//===----------------------------------------------------------------------===//
+
+// Initializes |out_environment| to an environment with no optional processor
+// features. Libraries will select their most portable variant.
+void iree_hal_executable_environment_initialize(
+    iree_hal_executable_environment_v0_t* out_environment);
+
+// Initializes |out_environment| to describe the host processors.
+// Only features available on all processors in the system are reported such
+// that selected library variants can be executed from any thread.
+void iree_hal_executable_environment_initialize_from_host(
+    iree_hal_executable_environment_v0_t* out_environment);
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif  // __cplusplus
+
+#endif  // IREE_HAL_LOCAL_EXECUTABLE_ENVIRONMENT_H_
@@ -0,0 +1,87 @@
+// Copyright 2021 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/hal/local/executable_import_registry.h"
+
+//===----------------------------------------------------------------------===//
+// iree_hal_executable_import_registry_t
+//===----------------------------------------------------------------------===//
+
+static iree_status_t iree_hal_executable_import_registry_resolve(
+    void* self, iree_string_view_t symbol_name, void** out_fn_ptr) {
+  for (const iree_hal_executable_import_registry_t* registry =
+           (const iree_hal_executable_import_registry_t*)self;
+       registry; registry = registry->parent) {
+    for (iree_host_size_t i = 0; i < registry->count; ++i) {
+      const iree_hal_executable_import_registration_t* registration =
+          &registry->registrations[i];
+      if (iree_string_view_equal(
+              symbol_name,
+              iree_make_cstring_view(registration->symbol_name))) {
+        *out_fn_ptr = (void*)registration->fn;
+        return iree_ok_status();
+      }
+    }
+  }
+  return iree_make_status(IREE_STATUS_NOT_FOUND,
+                          "executable import '%.*s' not found in the registry",
+                          (int)symbol_name.size, symbol_name.data);
+}
+
+iree_hal_executable_import_provider_t
+iree_hal_executable_import_registry_provider(
+    const iree_hal_executable_import_registry_t* registry) {
+  iree_hal_executable_import_provider_t provider = {
+      (void*)registry,
+      iree_hal_executable_import_registry_resolve,
+  };
+  return provider;
+}
+
+//===----------------------------------------------------------------------===//
+// Builtin imports
+//===----------------------------------------------------------------------===//
+
+static int iree_hal_dot_i8i8i32(void* import_params) {
+  const iree_hal_dot_i8i8i32_params_t* params =
+      (const iree_hal_dot_i8i8i32_params_t*)import_params;
+  const int8_t* IREE_RESTRICT lhs = params->lhs;
+  const int8_t* IREE_RESTRICT rhs = params->rhs;
+  const size_t count = params->count;
+  // Independent partial sums break the loop-carried dependency on a single
+  // accumulator so the compiler can vectorize the main loop with widening
+  // multiplies on any target.
+  int32_t sums[4] = {0, 0, 0, 0};
+  size_t i = 0;
+  for (; i + 4 <= count; i += 4) {
+    sums[0] += (int32_t)lhs[i + 0] * (int32_t)rhs[i + 0];
+    sums[1] += (int32_t)lhs[i + 1] * (int32_t)rhs[i + 1];
+    sums[2] += (int32_t)lhs[i + 2] * (int32_t)rhs[i + 2];
+    sums[3] += (int32_t)lhs[i + 3] * (int32_t)rhs[i + 3];
+  }
+  for (; i < count; ++i) {
+    sums[0] += (int32_t)lhs[i] * (int32_t)rhs[i];
+  }
+  *params->result = (sums[0] + sums[1]) + (sums[2] + sums[3]);
+  return 0;
+}
+
+static const iree_hal_executable_import_registration_t
+    iree_hal_executable_import_builtins[] = {
+        {"iree_hal_dot_i8i8i32", iree_hal_dot_i8i8i32},
+};
+
+static const iree_hal_executable_import_registry_t
+    iree_hal_executable_import_builtin_registry = {
+        NULL,
+        IREE_ARRAYSIZE(iree_hal_executable_import_builtins),
+        iree_hal_executable_import_builtins,
+};
+
+const iree_hal_executable_import_registry_t*
+iree_hal_executable_import_registry_builtin(void) {
+  return &iree_hal_executable_import_builtin_registry;
+}
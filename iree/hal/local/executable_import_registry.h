@@ -0,0 +1,78 @@
+// Copyright 2021 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#ifndef IREE_HAL_LOCAL_EXECUTABLE_IMPORT_REGISTRY_H_
+#define IREE_HAL_LOCAL_EXECUTABLE_IMPORT_REGISTRY_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "iree/base/api.h"
+#include "iree/hal/local/executable_library.h"
+#include "iree/hal/local/executable_loader.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif  // __cplusplus
+
+//===----------------------------------------------------------------------===//
+// iree_hal_executable_import_registry_t
+//===----------------------------------------------------------------------===//
+
+// A function that can be imported by executables under |symbol_name|.
+typedef struct iree_hal_executable_import_registration_t {
+  const char* symbol_name;
+  iree_hal_executable_import_v0_t fn;
+} iree_hal_executable_import_registration_t;
+
+// A static table of functions that can be imported by executables.
+// Registries are immutable and usually declared as constants such that hosts
+// can layer their own functions on top of those provided by the runtime by
+// chaining registries with |parent|.
+typedef struct iree_hal_executable_import_registry_t {
+  // Optional registry searched when a symbol is not found in this one.
+  const struct iree_hal_executable_import_registry_t* parent;
+  // Total number of functions in |registrations|.
+  iree_host_size_t count;
+  // Registered functions; if a symbol is registered multiple times the first
+  // registration is used.
+  const iree_hal_executable_import_registration_t* registrations;
+} iree_hal_executable_import_registry_t;
+
+// Returns an import provider that resolves symbols from |registry|.
+// The registry must remain valid for the lifetime of all loaders using the
+// provider.
+iree_hal_executable_import_provider_t
+iree_hal_executable_import_registry_provider(
+    const iree_hal_executable_import_registry_t* registry);
+
+// Returns the registry of functions built into the runtime.
+// These are compiled once with the runtime for the host architecture and can
+// be shared by all executables instead of each executable embedding its own
+// copy.
+const iree_hal_executable_import_registry_t*
+iree_hal_executable_import_registry_builtin(void);
+
+//===----------------------------------------------------------------------===//
+// Builtin imports
+//===----------------------------------------------------------------------===//
+// NOTE: the parameter structures here are part of the executable ABI and must
+// be versioned by changing the symbol name when modified.
+
+// Parameters to `iree_hal_dot_i8i8i32`:
+//   *result = sum(lhs[i] * rhs[i] for i in [0, count))
+typedef struct iree_hal_dot_i8i8i32_params_t {
+  const int8_t* lhs;
+  const int8_t* rhs;
+  size_t count;
+  int32_t* result;
+} iree_hal_dot_i8i8i32_params_t;
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif  // __cplusplus
+
+#endif  // IREE_HAL_LOCAL_EXECUTABLE_IMPORT_REGISTRY_H_
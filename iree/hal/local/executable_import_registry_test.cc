@@ -0,0 +1,380 @@
+// Copyright 2021 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/hal/local/executable_import_registry.h"
+
+#include <cstdint>
+#include <cstring>
+
+#include "iree/base/api.h"
+#include "iree/hal/api.h"
+#include "iree/hal/local/executable_library.h"
+#include "iree/hal/local/executable_loader.h"
+#include "iree/hal/local/loaders/static_library_loader.h"
+#include "iree/hal/local/sync_device.h"
+#include "iree/testing/gtest.h"
+#include "iree/testing/status_matchers.h"
+
+namespace {
+
+//===----------------------------------------------------------------------===//
+// Test imports
+//===----------------------------------------------------------------------===//
+
+// Parameters of the test imports: *result = value + addend.
+struct TestAddParams {
+  int32_t value;
+  int32_t* result;
+};
+
+static int TestAdd1(void* import_params) {
+  TestAddParams* params = reinterpret_cast<TestAddParams*>(import_params);
+  *params->result = params->value + 1;
+  return 0;
+}
+
+static int TestAdd100(void* import_params) {
+  TestAddParams* params = reinterpret_cast<TestAddParams*>(import_params);
+  *params->result = params->value + 100;
+  return 0;
+}
+
+static const iree_hal_executable_import_registration_t kParentRegistrations[] =
+    {
+        {"test_add", TestAdd100},
+        {"test_add_parent", TestAdd100},
+};
+static const iree_hal_executable_import_registry_t kParentRegistry = {
+    iree_hal_executable_import_registry_builtin(),
+    IREE_ARRAYSIZE(kParentRegistrations),
+    kParentRegistrations,
+};
+
+// Shadows `test_add` from the parent and chains to it for the rest.
+static const iree_hal_executable_import_registration_t kChildRegistrations[] = {
+    {"test_add", TestAdd1},
+};
+static const iree_hal_executable_import_registry_t kChildRegistry = {
+    &kParentRegistry,
+    IREE_ARRAYSIZE(kChildRegistrations),
+    kChildRegistrations,
+};
+
+static void* Resolve(const iree_hal_executable_import_registry_t* registry,
+                     const char* symbol_name) {
+  void* fn_ptr = nullptr;
+  IREE_CHECK_OK(iree_hal_executable_import_provider_resolve(
+      iree_hal_executable_import_registry_provider(registry),
+      iree_make_cstring_view(symbol_name), &fn_ptr));
+  return fn_ptr;
+}
+
+TEST(ExecutableImportRegistryTest, Resolve) {
+  EXPECT_EQ(Resolve(&kChildRegistry, "test_add"), (void*)TestAdd1);
+  EXPECT_EQ(Resolve(&kParentRegistry, "test_add"), (void*)TestAdd100);
+}
+
+TEST(ExecutableImportRegistryTest, ResolveFromParent) {
+  EXPECT_EQ(Resolve(&kChildRegistry, "test_add_parent"), (void*)TestAdd100);
+  EXPECT_NE(Resolve(&kChildRegistry, "iree_hal_dot_i8i8i32"), nullptr);
+}
+
+TEST(ExecutableImportRegistryTest, ResolveNotFound) {
+  void* fn_ptr = nullptr;
+  IREE_EXPECT_STATUS_IS(
+      IREE_STATUS_NOT_FOUND,
+      iree_hal_executable_import_provider_resolve(
+          iree_hal_executable_import_registry_provider(&kChildRegistry),
+          iree_make_cstring_view("test_missing"), &fn_ptr));
+  // Prefixes of registered symbols do not match.
+  IREE_EXPECT_STATUS_IS(
+      IREE_STATUS_NOT_FOUND,
+      iree_hal_executable_import_provider_resolve(
+          iree_hal_executable_import_registry_provider(&kChildRegistry),
+          iree_make_cstring_view("test_ad"), &fn_ptr));
+}
+
+TEST(ExecutableImportRegistryTest, NullProvider) {
+  void* fn_ptr = nullptr;
+  IREE_EXPECT_STATUS_IS(IREE_STATUS_NOT_FOUND,
+                        iree_hal_executable_import_provider_resolve(
+                            iree_hal_executable_import_provider_null(),
+                            iree_make_cstring_view("test_add"), &fn_ptr));
+}
+
+TEST(ExecutableImportRegistryTest, BuiltinDotI8I8I32) {
+  iree_hal_executable_import_v0_t dot = (iree_hal_executable_import_v0_t)
+      Resolve(iree_hal_executable_import_registry_builtin(),
+              "iree_hal_dot_i8i8i32");
+  static const int8_t kLhs[] = {1, -2, 3, 127, -128, 5, 6, 7, 8};
+  static const int8_t kRhs[] = {4, 5, -6, 127, -128, 1, 1, 1, 1};
+  int32_t expected = 0;
+  for (size_t i = 0; i < IREE_ARRAYSIZE(kLhs); ++i) {
+    expected += (int32_t)kLhs[i] * (int32_t)kRhs[i];
+  }
+  int32_t result = 0;
+  iree_hal_dot_i8i8i32_params_t params = {kLhs, kRhs, IREE_ARRAYSIZE(kLhs),
+                                          &result};
+  EXPECT_EQ(0, dot(&params));
+  EXPECT_EQ(expected, result);
+
+  // Empty dot products are 0.
+  result = -1;
+  params.count = 0;
+  EXPECT_EQ(0, dot(&params));
+  EXPECT_EQ(0, result);
+}
+
+//===----------------------------------------------------------------------===//
+// Hand-built executable library declaring imports
+//===----------------------------------------------------------------------===//
+
+// Values observed by the entry point of the test library.
+struct DispatchResults {
+  int dispatch_count;
+  const iree_hal_executable_import_v0_t* imports;
+  int32_t required_result;
+  bool optional_missing_is_null;
+  int32_t optional_present_result;
+};
+static DispatchResults dispatch_results;
+
+// Calls each import as generated code would with a NULL check on the optional
+// ones.
+static int ImportingEntryPoint(
+    const iree_hal_executable_dispatch_state_v0_t* dispatch_state,
+    const iree_hal_vec3_t* workgroup_id) {
+  ++dispatch_results.dispatch_count;
+  dispatch_results.imports = dispatch_state->imports;
+  if (!dispatch_state->imports) return 0;
+  TestAddParams required_params = {1, &dispatch_results.required_result};
+  int ret = dispatch_state->imports[0](&required_params);
+  if (ret != 0) return ret;
+  dispatch_results.optional_missing_is_null = !dispatch_state->imports[1];
+  if (dispatch_state->imports[2]) {
+    TestAddParams optional_params = {2,
+                                     &dispatch_results.optional_present_result};
+    ret = dispatch_state->imports[2](&optional_params);
+  }
+  return ret;
+}
+
+static const iree_hal_executable_dispatch_v0_t kEntryPoints[] = {
+    ImportingEntryPoint,
+};
+
+static const char* const kImportSymbols[] = {
+    "test_add",
+    "?test_missing",
+    "?test_add_parent",
+};
+static const iree_hal_executable_library_header_t kImportingHeader = {
+    IREE_HAL_EXECUTABLE_LIBRARY_VERSION_0_3,
+    "importing",
+    IREE_HAL_EXECUTABLE_LIBRARY_FEATURE_NONE,
+    IREE_HAL_EXECUTABLE_LIBRARY_SANITIZER_NONE,
+};
+static const iree_hal_executable_library_v0_t kImportingLibrary = {
+    &kImportingHeader,
+    IREE_ARRAYSIZE(kEntryPoints),
+    kEntryPoints,
+    /*entry_point_names=*/nullptr,
+    /*entry_point_tags=*/nullptr,
+    /*entry_point_attrs=*/nullptr,
+    {IREE_ARRAYSIZE(kImportSymbols), kImportSymbols},
+};
+
+static const char* const kMissingImportSymbols[] = {
+    "test_add",
+    "test_missing",
+};
+static const iree_hal_executable_library_header_t kMissingImportHeader = {
+    IREE_HAL_EXECUTABLE_LIBRARY_VERSION_0_3,
+    "missing_import",
+    IREE_HAL_EXECUTABLE_LIBRARY_FEATURE_NONE,
+    IREE_HAL_EXECUTABLE_LIBRARY_SANITIZER_NONE,
+};
+static const iree_hal_executable_library_v0_t kMissingImportLibrary = {
+    &kMissingImportHeader,
+    IREE_ARRAYSIZE(kEntryPoints),
+    kEntryPoints,
+    /*entry_point_names=*/nullptr,
+    /*entry_point_tags=*/nullptr,
+    /*entry_point_attrs=*/nullptr,
+    {IREE_ARRAYSIZE(kMissingImportSymbols), kMissingImportSymbols},
+};
+
+static const iree_hal_executable_library_header_t kNoImportsHeader = {
+    IREE_HAL_EXECUTABLE_LIBRARY_VERSION_0_3,
+    "no_imports",
+    IREE_HAL_EXECUTABLE_LIBRARY_FEATURE_NONE,
+    IREE_HAL_EXECUTABLE_LIBRARY_SANITIZER_NONE,
+};
+static const iree_hal_executable_library_v0_t kNoImportsLibrary = {
+    &kNoImportsHeader,
+    IREE_ARRAYSIZE(kEntryPoints),
+    kEntryPoints,
+    /*entry_point_names=*/nullptr,
+    /*entry_point_tags=*/nullptr,
+    /*entry_point_attrs=*/nullptr,
+    {0, nullptr},
+};
+
+// The loader takes the header pointers as returned by library query functions,
+// which alias the start of the v0 library structure.
+static const iree_hal_executable_library_header_t** const kLibraries[] = {
+    (const iree_hal_executable_library_header_t**)&kImportingLibrary,
+    (const iree_hal_executable_library_header_t**)&kMissingImportLibrary,
+    (const iree_hal_executable_library_header_t**)&kNoImportsLibrary,
+};
+
+//===----------------------------------------------------------------------===//
+// Import resolution through the HAL
+//===----------------------------------------------------------------------===//
+
+// Loads the test libraries on a sync device with imports resolved from
+// kChildRegistry and dispatches them with inline command buffers.
+class ExecutableImportTest : public ::testing::Test {
+ protected:
+  void TearDown() override {
+    iree_hal_executable_layout_release(executable_layout_);
+    iree_hal_executable_cache_release(executable_cache_);
+    iree_hal_device_release(device_);
+  }
+
+  void CreateDevice(iree_hal_executable_caching_mode_t caching_mode) {
+    memset(&dispatch_results, 0, sizeof(dispatch_results));
+    iree_hal_executable_loader_t* loader = nullptr;
+    IREE_ASSERT_OK(iree_hal_static_library_loader_create(
+        IREE_ARRAYSIZE(kLibraries), kLibraries,
+        iree_hal_executable_import_registry_provider(&kChildRegistry),
+        iree_allocator_system(), &loader));
+    iree_hal_sync_device_params_t params;
+    iree_hal_sync_device_params_initialize(&params);
+    params.executable_caching_mode = caching_mode;
+    iree_status_t status = iree_hal_sync_device_create(
+        iree_make_cstring_view("sync"), &params, /*loader_count=*/1, &loader,
+        iree_allocator_system(), &device_);
+    iree_hal_executable_loader_release(loader);
+    IREE_ASSERT_OK(status);
+    IREE_ASSERT_OK(iree_hal_executable_cache_create(
+        device_, iree_make_cstring_view("cache"), &executable_cache_));
+    IREE_ASSERT_OK(iree_hal_executable_layout_create(
+        device_, /*push_constants=*/0, /*set_layout_count=*/0,
+        /*set_layouts=*/nullptr, &executable_layout_));
+  }
+
+  iree_status_t PrepareExecutable(const char* library_name,
+                                  iree_hal_executable_t** out_executable) {
+    iree_hal_executable_spec_t spec;
+    iree_hal_executable_spec_initialize(&spec);
+    spec.executable_format = iree_make_cstring_view("static");
+    spec.executable_data = iree_make_const_byte_span(
+        library_name, strlen(library_name));
+    spec.executable_layout_count = 1;
+    spec.executable_layouts = &executable_layout_;
+    return iree_hal_executable_cache_prepare_executable(
+        executable_cache_, &spec, out_executable);
+  }
+
+  // Records a single workgroup dispatch of |executable| into an inline command
+  // buffer that executes it as it is recorded.
+  iree_status_t Dispatch(iree_hal_executable_t* executable) {
+    iree_hal_command_buffer_t* command_buffer = nullptr;
+    IREE_RETURN_IF_ERROR(iree_hal_command_buffer_create(
+        device_,
+        IREE_HAL_COMMAND_BUFFER_MODE_ONE_SHOT |
+            IREE_HAL_COMMAND_BUFFER_MODE_ALLOW_INLINE_EXECUTION,
+        IREE_HAL_COMMAND_CATEGORY_DISPATCH, IREE_HAL_QUEUE_AFFINITY_ANY,
+        &command_buffer));
+    iree_status_t status = iree_hal_command_buffer_begin(command_buffer);
+    if (iree_status_is_ok(status)) {
+      status = iree_hal_command_buffer_dispatch(command_buffer, executable,
+                                                /*entry_point=*/0, 1, 1, 1);
+    }
+    if (iree_status_is_ok(status)) {
+      status = iree_hal_command_buffer_end(command_buffer);
+    }
+    iree_hal_command_buffer_release(command_buffer);
+    return status;
+  }
+
+  // Verifies the entry point observed the imports resolved from
+  // kChildRegistry.
+  static void VerifyResolvedImports() {
+    EXPECT_EQ(dispatch_results.dispatch_count, 1);
+    ASSERT_NE(dispatch_results.imports, nullptr);
+    // Required import resolved from the child, shadowing the parent.
+    EXPECT_EQ(dispatch_results.imports[0], TestAdd1);
+    EXPECT_EQ(dispatch_results.required_result, 1 + 1);
+    // Missing optional import left NULL.
+    EXPECT_TRUE(dispatch_results.optional_missing_is_null);
+    // Optional import resolved from the parent registry.
+    EXPECT_EQ(dispatch_results.imports[2], TestAdd100);
+    EXPECT_EQ(dispatch_results.optional_present_result, 2 + 100);
+  }
+
+  iree_hal_device_t* device_ = nullptr;
+  iree_hal_executable_cache_t* executable_cache_ = nullptr;
+  iree_hal_executable_layout_t* executable_layout_ = nullptr;
+};
+
+TEST_F(ExecutableImportTest, ResolvedImportsInDispatchState) {
+  CreateDevice(/*caching_mode=*/0);
+  iree_hal_executable_t* executable = nullptr;
+  IREE_ASSERT_OK(PrepareExecutable("importing", &executable));
+  IREE_ASSERT_OK(Dispatch(executable));
+  VerifyResolvedImports();
+  iree_hal_executable_release(executable);
+}
+
+TEST_F(ExecutableImportTest, NoImports) {
+  CreateDevice(/*caching_mode=*/0);
+  iree_hal_executable_t* executable = nullptr;
+  IREE_ASSERT_OK(PrepareExecutable("no_imports", &executable));
+  IREE_ASSERT_OK(Dispatch(executable));
+  EXPECT_EQ(dispatch_results.dispatch_count, 1);
+  EXPECT_EQ(dispatch_results.imports, nullptr);
+  iree_hal_executable_release(executable);
+}
+
+TEST_F(ExecutableImportTest, RequiredImportNotFound) {
+  CreateDevice(/*caching_mode=*/0);
+  iree_hal_executable_t* executable = nullptr;
+  IREE_EXPECT_STATUS_IS(IREE_STATUS_NOT_FOUND,
+                        PrepareExecutable("missing_import", &executable));
+  EXPECT_EQ(executable, nullptr);
+}
+
+// Deferred executables resolve imports when prepared for their first dispatch
+// and forward the resolved table to the dispatch state.
+TEST_F(ExecutableImportTest, DeferredResolvedImportsInDispatchState) {
+  CreateDevice(IREE_HAL_EXECUTABLE_CACHING_MODE_ALLOW_DEFERRED_PREPARATION);
+  iree_hal_executable_t* executable = nullptr;
+  IREE_ASSERT_OK(PrepareExecutable("importing", &executable));
+  IREE_ASSERT_OK(Dispatch(executable));
+  VerifyResolvedImports();
+
+  // The same table is used by later dispatches.
+  const iree_hal_executable_import_v0_t* imports = dispatch_results.imports;
+  IREE_ASSERT_OK(Dispatch(executable));
+  EXPECT_EQ(dispatch_results.dispatch_count, 2);
+  EXPECT_EQ(dispatch_results.imports, imports);
+  iree_hal_executable_release(executable);
+}
+
+// Deferred executables report missing required imports on first dispatch
+// without running the entry point.
+TEST_F(ExecutableImportTest, DeferredRequiredImportNotFound) {
+  CreateDevice(IREE_HAL_EXECUTABLE_CACHING_MODE_ALLOW_DEFERRED_PREPARATION);
+  iree_hal_executable_t* executable = nullptr;
+  IREE_ASSERT_OK(PrepareExecutable("missing_import", &executable));
+  IREE_EXPECT_STATUS_IS(IREE_STATUS_NOT_FOUND, Dispatch(executable));
+  EXPECT_EQ(dispatch_results.dispatch_count, 0);
+  iree_hal_executable_release(executable);
+}
+
+}  // namespace
@@ -81,6 +81,33 @@ typedef enum iree_hal_executable_library_version_e {
   // structure.
   IREE_HAL_EXECUTABLE_LIBRARY_VERSION_0 = 0,
 
+  // iree_hal_executable_library_v0_t is used as the API communication
+  // structure and iree_hal_executable_dispatch_state_v0_t includes the
+  // |processor_id| and |local_memory| fields. The fields are appended to the
+  // VERSION_0 dispatch state such that VERSION_0 libraries remain compatible
+  // with runtimes supporting this version.
+  IREE_HAL_EXECUTABLE_LIBRARY_VERSION_0_1 = 1,
+
+  // As with IREE_HAL_EXECUTABLE_LIBRARY_VERSION_0_1 and
+  // iree_hal_executable_library_v0_t includes the |entry_point_attrs| table.
+  // The field is appended to the library structure such that earlier libraries
+  // remain compatible with runtimes supporting this version.
+  IREE_HAL_EXECUTABLE_LIBRARY_VERSION_0_2 = 2,
+
+  // As with IREE_HAL_EXECUTABLE_LIBRARY_VERSION_0_2 and
+  // iree_hal_executable_library_v0_t includes the |imports| table declaring
+  // the functions the library requires from the runtime.
+  // iree_hal_executable_dispatch_state_v0_t::imports contains the resolved
+  // import functions.
+  IREE_HAL_EXECUTABLE_LIBRARY_VERSION_0_3 = 3,
+
+  // As with IREE_HAL_EXECUTABLE_LIBRARY_VERSION_0_3 and the query function
+  // receives an iree_hal_executable_environment_v0_t describing the host such
+  // that libraries can select between variants compiled for different
+  // processor features. Libraries must only access the environment when the
+  // |max_version| passed to the query function is at least this version.
+  IREE_HAL_EXECUTABLE_LIBRARY_VERSION_0_4 = 4,
+
   IREE_HAL_EXECUTABLE_LIBRARY_VERSION_MAX_ENUM = INT32_MAX,
 } iree_hal_executable_library_version_t;
 static_assert(sizeof(iree_hal_executable_library_version_t) == 4, "uint32_t");
@@ -88,7 +115,7 @@ static_assert(sizeof(iree_hal_executable_library_version_t) == 4, "uint32_t");
 // The latest version of the library API; can be used to populate the
 // iree_hal_executable_library_header_t::version when building libraries.
 #define IREE_HAL_EXECUTABLE_LIBRARY_LATEST_VERSION \
-  IREE_HAL_EXECUTABLE_LIBRARY_VERSION_0
+  IREE_HAL_EXECUTABLE_LIBRARY_VERSION_0_4
 
 // A header present at the top of all versions of the library API used by the
 // runtime to ensure version compatibility.
@@ -106,26 +133,115 @@ typedef struct iree_hal_executable_library_header_t {
   iree_hal_executable_library_sanitizer_kind_t sanitizer;
 } iree_hal_executable_library_header_t;
 
+// Architecture-specific processor features that libraries may be compiled to
+// require. Bits are only meaningful for the architecture the library was
+// compiled for and may alias across architectures.
+enum iree_hal_processor_feature_bits_t {
+  IREE_HAL_PROCESSOR_FEATURE_NONE = 0ull,
+
+  // x86-64:
+  IREE_HAL_PROCESSOR_FEATURE_X86_64_AVX = 1ull << 0,
+  IREE_HAL_PROCESSOR_FEATURE_X86_64_AVX2 = 1ull << 1,
+  IREE_HAL_PROCESSOR_FEATURE_X86_64_FMA = 1ull << 2,
+  IREE_HAL_PROCESSOR_FEATURE_X86_64_F16C = 1ull << 3,
+  IREE_HAL_PROCESSOR_FEATURE_X86_64_AVX512F = 1ull << 4,
+  IREE_HAL_PROCESSOR_FEATURE_X86_64_AVX512BW = 1ull << 5,
+  IREE_HAL_PROCESSOR_FEATURE_X86_64_AVX512DQ = 1ull << 6,
+  IREE_HAL_PROCESSOR_FEATURE_X86_64_AVX512VL = 1ull << 7,
+  IREE_HAL_PROCESSOR_FEATURE_X86_64_AVX512VNNI = 1ull << 8,
+
+  // arm64:
+  IREE_HAL_PROCESSOR_FEATURE_ARM_64_DOTPROD = 1ull << 0,
+  IREE_HAL_PROCESSOR_FEATURE_ARM_64_FP16 = 1ull << 1,
+};
+typedef uint64_t iree_hal_processor_features_t;
+
+// Describes the environment the library is being loaded into.
+// Provided to the query function of libraries built for
+// IREE_HAL_EXECUTABLE_LIBRARY_VERSION_0_4 or later.
+typedef struct iree_hal_executable_environment_v0_t {
+  // Features available on all processors that may execute the library.
+  iree_hal_processor_features_t processor_features;
+} iree_hal_executable_environment_v0_t;
+
 // Exported function from dynamic libraries for querying library information.
 // The provided |max_version| is the maximum version the caller supports;
 // callees must return NULL if their lowest available version is greater
 // than the max version supported by the caller.
+//
+// If |max_version| is at least IREE_HAL_EXECUTABLE_LIBRARY_VERSION_0_4 then
+// |environment| describes the host and libraries may return a variant
+// specialized for it (such as one using wider vector instructions). Callees
+// must only return variants that are executable in the given environment.
 typedef const iree_hal_executable_library_header_t** (
     *iree_hal_executable_library_query_fn_t)(
-    iree_hal_executable_library_version_t max_version, void* reserved);
+    iree_hal_executable_library_version_t max_version,
+    const iree_hal_executable_environment_v0_t* environment);
 
 // Function name exported from dynamic libraries (pass to dlsym).
 #define IREE_HAL_EXECUTABLE_LIBRARY_EXPORT_NAME \
   "iree_hal_executable_library_query"
 
+// When the runtime should prepare a library for execution.
+enum iree_hal_executable_library_preparation_e {
+  // Prepared when the executable is created.
+  IREE_HAL_EXECUTABLE_LIBRARY_PREPARATION_EAGER = 0u,
+  // Prepared before the first dispatch using the executable is recorded.
+  IREE_HAL_EXECUTABLE_LIBRARY_PREPARATION_DEFERRED = 1u,
+  // Prepared in the background after the executable is created or before the
+  // first dispatch using the executable is recorded, whichever comes first.
+  IREE_HAL_EXECUTABLE_LIBRARY_PREPARATION_ASYNC = 2u,
+};
+typedef uint32_t iree_hal_executable_library_preparation_t;
+
+// Optional hints from the compiler describing how the runtime should handle a
+// library. Unlike the library header these are readable without loading the
+// library: loaders of formats that support it (such as ELF) find them in a
+// section named IREE_HAL_EXECUTABLE_LIBRARY_HINTS_SECTION_NAME that is kept
+// alive by an export named IREE_HAL_EXECUTABLE_LIBRARY_HINTS_EXPORT_NAME.
+// Hints may only relax runtime behavior and the runtime may ignore them.
+typedef struct iree_hal_executable_library_hints_v0_t {
+  // Version of the hints structure. Must be 0.
+  uint32_t version;
+  // When the library should be prepared.
+  iree_hal_executable_library_preparation_t preparation;
+} iree_hal_executable_library_hints_v0_t;
+
+// Name of the section holding the iree_hal_executable_library_hints_v0_t.
+#define IREE_HAL_EXECUTABLE_LIBRARY_HINTS_SECTION_NAME ".iree.hints"
+
+// Name of the exported symbol defining the hints within the section.
+#define IREE_HAL_EXECUTABLE_LIBRARY_HINTS_EXPORT_NAME \
+  "iree_hal_executable_library_hints"
+
 //===----------------------------------------------------------------------===//
 // IREE_HAL_EXECUTABLE_LIBRARY_VERSION_0
 //===----------------------------------------------------------------------===//
 
-// TBD: do not use this yet.
+// Function signature of functions imported from the runtime.
+// Imports take a single pointer to an import-specific parameter structure
+// such that the calling convention is independent of the arguments and the
+// ABI of each import can be versioned by its symbol name.
+//
+// Returns 0 on success and non-zero on failure. Failures are propagated by the
+// calling entry point in the same way as its own failures.
+typedef int (*iree_hal_executable_import_v0_t)(void* import_params);
+
+// Declares the functions a library imports from the runtime.
+// The runtime resolves each symbol when the library is loaded and passes the
+// resolved functions to each workgroup in the same order as
+// iree_hal_executable_dispatch_state_v0_t::imports.
+//
+// Symbols prefixed with `?` are optional (weak) imports: if the runtime does
+// not provide them the corresponding function will be NULL and the library
+// must check before calling it (such as when selecting between an
+// architecture-specific microkernel and a generic fallback). Libraries with
+// required imports the runtime does not provide will fail to load.
 typedef struct iree_hal_executable_import_table_v0_t {
-  size_t import_count;
-  void* import_fns;
+  // Total number of imported symbols.
+  uint32_t count;
+  // Names of the imported symbols.
+  const char* const* symbols;
 } iree_hal_executable_import_table_v0_t;
 
 typedef union iree_hal_vec3_t {
@@ -138,6 +254,9 @@ typedef union iree_hal_vec3_t {
 } iree_hal_vec3_t;
 
 // Read-only per-dispatch state passed to each workgroup in a dispatch.
+// Fields after |imports| are only available to libraries declaring
+// IREE_HAL_EXECUTABLE_LIBRARY_VERSION_0_1 or later and may vary per workgroup
+// based on which processor is executing it.
 typedef struct iree_hal_executable_dispatch_state_v0_t {
   // Total workgroup count for the dispatch. This is sourced from either the
   // original dispatch call (for iree_hal_command_buffer_dispatch) or the
@@ -161,8 +280,23 @@ typedef struct iree_hal_executable_dispatch_state_v0_t {
   // The length of each binding in bytes, 1:1 with |binding_ptrs|.
   const size_t* binding_lengths;
 
-  // Optional imported functions available for use within the executable.
-  const iree_hal_executable_import_table_v0_t* imports;
+  // Imported functions 1:1 with the library import table. Only available to
+  // libraries declaring IREE_HAL_EXECUTABLE_LIBRARY_VERSION_0_3 or later and
+  // NULL if the library declares no imports.
+  const iree_hal_executable_import_v0_t* imports;
+
+  // Logical ID of the processor executing the workgroup. Workgroups executing
+  // concurrently are guaranteed to have unique processor IDs. The ID can be
+  // used to index into processor-local data structures.
+  uint32_t processor_id;
+
+  // Scratch memory local to the processor executing the workgroup.
+  // The contents are undefined at the start of each workgroup and must not be
+  // retained across workgroups. The memory is aligned to at least a cache line
+  // and may be NULL/0 in which case workgroups must fall back to providing
+  // their own storage.
+  size_t local_memory_size;
+  void* IREE_RESTRICT local_memory;
 } iree_hal_executable_dispatch_state_v0_t;
 
 // Function signature of exported executable entry points.
@@ -179,6 +313,23 @@ typedef int (*iree_hal_executable_dispatch_v0_t)(
     const iree_hal_executable_dispatch_state_v0_t* dispatch_state,
     const iree_hal_vec3_t* workgroup_id);
 
+// Attributes describing how an entry point should be dispatched.
+// The runtime uses these to schedule the workgroups of a dispatch and all
+// fields are optional hints; a zero-initialized structure indicates that the
+// runtime should choose.
+typedef struct iree_hal_executable_dispatch_attrs_v0_t {
+  // Workgroup size the entry point was compiled for. Passed to each workgroup
+  // as iree_hal_executable_dispatch_state_v0_t::workgroup_size. 0 in any
+  // dimension indicates that the entry point does not declare a size.
+  iree_hal_vec3_t workgroup_size;
+  // Preferred number of workgroups a processor should execute each time it
+  // takes work from a dispatch. Cheap workgroups benefit from larger values
+  // that amortize scheduling overhead while expensive workgroups benefit from
+  // smaller values that balance the work across processors. 0 indicates that
+  // the runtime should choose based on the dispatch size.
+  uint32_t workgroups_per_reservation;
+} iree_hal_executable_dispatch_attrs_v0_t;
+
 // Structure used for v0 library interfaces.
 // The entire structure is designed to be read-only and able to live embedded in
 // the binary .rdata section.
@@ -209,7 +360,15 @@ typedef struct iree_hal_executable_library_v0_t {
   // point.
   const char* const* entry_point_tags;
 
-  // TODO(benvanik): optional import declarations.
+  // Optional table of dispatch attributes 1:1 with entry_points.
+  // Only present in libraries declaring
+  // IREE_HAL_EXECUTABLE_LIBRARY_VERSION_0_2 or later.
+  const iree_hal_executable_dispatch_attrs_v0_t* entry_point_attrs;
+
+  // Functions imported by the library from the runtime.
+  // Only present in libraries declaring
+  // IREE_HAL_EXECUTABLE_LIBRARY_VERSION_0_3 or later.
+  iree_hal_executable_import_table_v0_t imports;
 } iree_hal_executable_library_v0_t;
 
 #endif  // IREE_HAL_LOCAL_EXECUTABLE_LIBRARY_H_
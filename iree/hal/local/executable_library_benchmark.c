@@ -13,6 +13,7 @@
 #include "iree/base/internal/flags.h"
 #include "iree/base/tracing.h"
 #include "iree/hal/api.h"
+#include "iree/hal/local/executable_import_registry.h"
 #include "iree/hal/local/executable_library.h"
 #include "iree/hal/local/executable_loader.h"
 #include "iree/hal/local/local_descriptor_set_layout.h"
@@ -136,8 +137,10 @@ static iree_status_t iree_hal_executable_library_create_loader(
     iree_hal_executable_loader_t** out_executable_loader) {
 #if defined(IREE_HAL_HAVE_EMBEDDED_LIBRARY_LOADER)
   if (strcmp(FLAG_executable_format, "EX_ELF") == 0) {
-    return iree_hal_embedded_library_loader_create(host_allocator,
-                                                   out_executable_loader);
+    return iree_hal_embedded_library_loader_create(
+        iree_hal_executable_import_registry_provider(
+            iree_hal_executable_import_registry_builtin()),
+        host_allocator, out_executable_loader);
   }
 #endif  // IREE_HAL_HAVE_EMBEDDED_LIBRARY_LOADER
   return iree_make_status(
@@ -279,7 +282,7 @@ static iree_status_t iree_hal_executable_library_run(
       .binding_count = dispatch_params.binding_count,
       .binding_ptrs = binding_ptrs,
       .binding_lengths = binding_lengths,
-      .imports = NULL,  // not yet implemented
+      .imports = iree_hal_local_executable_cast(executable)->imports,
   };
 
   // Execute benchmark the workgroup invocation.
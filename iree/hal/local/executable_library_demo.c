@@ -34,6 +34,15 @@ static int dispatch_tile_a(
   return 0;
 }
 
+// Variant of dispatch_tile_a that would be compiled for processors with the
+// features required by library_avx2 below. It must compute the same results as
+// the baseline as the runtime may pick either based on the host.
+static int dispatch_tile_a_avx2(
+    const iree_hal_executable_dispatch_state_v0_t* dispatch_state,
+    const iree_hal_vec3_t* workgroup_id) {
+  return dispatch_tile_a(dispatch_state, workgroup_id);
+}
+
 // Just another entry point.
 static int dispatch_tile_b(
     const iree_hal_executable_dispatch_state_v0_t* dispatch_state,
@@ -67,12 +76,38 @@ static const char* entry_point_tags[2] = {
     "matmul+div",
     "conv2d[512x512]",
 };
+// Optional scheduling hints for each entry point. Here dispatch_tile_a is cheap
+// and would like each worker to grab many workgroups at a time while
+// dispatch_tile_b leaves the choice up to the runtime.
+static const iree_hal_executable_dispatch_attrs_v0_t entry_point_attrs[2] = {
+    {.workgroup_size = {{1, 1, 1}}, .workgroups_per_reservation = 64},
+    {.workgroup_size = {{0, 0, 0}}, .workgroups_per_reservation = 0},
+};
 static const iree_hal_executable_library_v0_t library = {
     .header = &header,
     .entry_point_count = 2,
     .entry_points = entry_points,
     .entry_point_names = entry_point_names,
     .entry_point_tags = entry_point_tags,
+    .entry_point_attrs = entry_point_attrs,
+};
+
+// A variant of the library for processors with AVX2 and FMA. Variants share
+// all metadata with the baseline library and only swap out entry points.
+static const iree_hal_processor_features_t library_avx2_features =
+    IREE_HAL_PROCESSOR_FEATURE_X86_64_AVX2 |
+    IREE_HAL_PROCESSOR_FEATURE_X86_64_FMA;
+static const iree_hal_executable_dispatch_v0_t entry_points_avx2[2] = {
+    dispatch_tile_a_avx2,
+    dispatch_tile_b,
+};
+static const iree_hal_executable_library_v0_t library_avx2 = {
+    .header = &header,
+    .entry_point_count = 2,
+    .entry_points = entry_points_avx2,
+    .entry_point_names = entry_point_names,
+    .entry_point_tags = entry_point_tags,
+    .entry_point_attrs = entry_point_attrs,
 };
 
 // The primary access point to the executable: in a static library this is
@@ -81,12 +116,18 @@ static const iree_hal_executable_library_v0_t library = {
 // that you would be dlsym'ing.
 //
 // This is just code: if the executable wants to return different headers based
-// on the currently executing architecture or the requested version it can. For
-// example, an executable may want to swap out a few entry points to an
-// architecture-specific version.
+// on the currently executing architecture or the requested version it can.
+// Here the AVX2 variant of the library is returned when |environment| reports
+// the processor features it requires. Environments are only passed by
+// runtimes supporting VERSION_0_4 and may be omitted.
 const iree_hal_executable_library_header_t** demo_executable_library_query(
-    iree_hal_executable_library_version_t max_version, void* reserved) {
-  return max_version <= 0
-             ? (const iree_hal_executable_library_header_t**)&library
-             : NULL;
+    iree_hal_executable_library_version_t max_version,
+    const iree_hal_executable_environment_v0_t* environment) {
+  if (max_version < header.version) return NULL;
+  if (max_version >= IREE_HAL_EXECUTABLE_LIBRARY_VERSION_0_4 && environment &&
+      (environment->processor_features & library_avx2_features) ==
+          library_avx2_features) {
+    return (const iree_hal_executable_library_header_t**)&library_avx2;
+  }
+  return (const iree_hal_executable_library_header_t**)&library;
 }
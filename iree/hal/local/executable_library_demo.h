@@ -42,8 +42,13 @@ typedef union {
 //       push constants: 0
 //       bindings: 0
 //
+// A variant of the library with its own 'dispatch_tile_a' is returned when
+// |environment| reports both IREE_HAL_PROCESSOR_FEATURE_X86_64_AVX2 and
+// IREE_HAL_PROCESSOR_FEATURE_X86_64_FMA.
+//
 const iree_hal_executable_library_header_t** demo_executable_library_query(
-    iree_hal_executable_library_version_t max_version, void* reserved);
+    iree_hal_executable_library_version_t max_version,
+    const iree_hal_executable_environment_v0_t* environment);
 
 #ifdef __cplusplus
 }  // extern "C"
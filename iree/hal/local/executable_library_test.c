@@ -10,42 +10,12 @@
 #include <string.h>
 
 #include "iree/base/api.h"
+#include "iree/hal/local/executable_environment.h"
 #include "iree/hal/local/executable_library_demo.h"
 
-// Demonstration of the HAL-side of the iree_hal_executable_library_t ABI.
-// This is the lowest level of the system right before calling into generated
-// code.
-//
-// This shows what the various execution systems are doing (through a lot
-// of fancy means): all `inline_command_buffer.c` and `task_command_buffer.c`
-// lead up to just calling into the iree_hal_executable_dispatch_v0_t entry
-// point functions with a state structure and a workgroup XYZ.
-//
-// Below walks through acquiring the library pointer (which in this case is a
-// hand-coded example to show the codegen-side), setting up the I/O buffers and
-// state, and calling the function to do some math.
-//
-// See iree/hal/local/executable_library.h for more information.
-int main(int argc, char** argv) {
-  // Query the library header at the requested version.
-  // The query call in this example is going into the handwritten demo code
-  // but could be targeted at generated files or runtime-loaded shared objects.
-  union {
-    const iree_hal_executable_library_header_t** header;
-    const iree_hal_executable_library_v0_t* v0;
-  } library;
-  library.header = demo_executable_library_query(
-      IREE_HAL_EXECUTABLE_LIBRARY_LATEST_VERSION, /*reserved=*/NULL);
-  const iree_hal_executable_library_header_t* header = *library.header;
-  IREE_ASSERT_NE(header, NULL, "version may not have matched");
-  IREE_ASSERT_LE(
-      header->version, IREE_HAL_EXECUTABLE_LIBRARY_LATEST_VERSION,
-      "expecting the library to have the same or older version as us");
-  IREE_ASSERT(strcmp(header->name, "demo_library") == 0,
-              "library name can be used to rendezvous in a registry");
-  IREE_ASSERT_GT(library.v0->entry_point_count, 0,
-                 "expected at least one entry point");
-
+// Dispatches the 'dispatch_tile_a' entry point of |library| and returns true
+// if it produced the expected results.
+static bool RunDispatchTileA(const iree_hal_executable_library_v0_t* library) {
   // Push constants are an array of 4-byte values that are much more efficient
   // to specify (no buffer pointer indirection) and more efficient to access
   // (static struct offset address calculation, all fit in a few cache lines,
@@ -71,7 +41,7 @@ int main(int argc, char** argv) {
 
   // Resolve the entry point by ordinal.
   const iree_hal_executable_dispatch_v0_t entry_fn_ptr =
-      library.v0->entry_points[0];
+      library->entry_points[0];
 
   // Dispatch each workgroup with the same state.
   iree_hal_executable_dispatch_state_v0_t dispatch_state = {
@@ -104,5 +74,104 @@ int main(int argc, char** argv) {
     IREE_ASSERT_EQ(ret0[i], ret0_expected[i], "math is hard");
     all_match = all_match && ret0[i] == ret0_expected[i];
   }
+  return all_match;
+}
+
+// Queries the demo library with |environment| and returns the v0 library.
+static const iree_hal_executable_library_v0_t* QueryLibrary(
+    const iree_hal_executable_environment_v0_t* environment) {
+  const iree_hal_executable_library_header_t** header =
+      demo_executable_library_query(IREE_HAL_EXECUTABLE_LIBRARY_LATEST_VERSION,
+                                    environment);
+  IREE_ASSERT_NE(header, NULL, "version may not have matched");
+  return (const iree_hal_executable_library_v0_t*)header;
+}
+
+// Demonstration of how the environment passed to the query function selects
+// a variant of the library. Variants share all metadata with the baseline and
+// only swap out entry points, so they must produce the same results.
+static bool TestVariantSelection(
+    const iree_hal_executable_library_v0_t* baseline) {
+  iree_hal_executable_environment_v0_t environment;
+
+  // Without processor features the portable baseline is returned.
+  iree_hal_executable_environment_initialize(&environment);
+  IREE_ASSERT_EQ(environment.processor_features,
+                 IREE_HAL_PROCESSOR_FEATURE_NONE);
+  IREE_ASSERT(QueryLibrary(&environment) == baseline,
+              "no features must select the baseline");
+
+  // Having only some of the required features falls back to the baseline.
+  environment.processor_features = IREE_HAL_PROCESSOR_FEATURE_X86_64_AVX2;
+  IREE_ASSERT(QueryLibrary(&environment) == baseline,
+              "missing FMA must fall back to the baseline");
+
+  // Having all of the required features, and more, selects the variant.
+  environment.processor_features = IREE_HAL_PROCESSOR_FEATURE_X86_64_AVX |
+                                   IREE_HAL_PROCESSOR_FEATURE_X86_64_AVX2 |
+                                   IREE_HAL_PROCESSOR_FEATURE_X86_64_FMA;
+  const iree_hal_executable_library_v0_t* variant = QueryLibrary(&environment);
+  IREE_ASSERT(variant != baseline, "AVX2+FMA must select the variant");
+  IREE_ASSERT(variant->header == baseline->header,
+              "variants share the library header");
+  IREE_ASSERT_EQ(variant->entry_point_count, baseline->entry_point_count);
+  IREE_ASSERT(variant->entry_point_names == baseline->entry_point_names,
+              "variants share the entry point metadata");
+  IREE_ASSERT(variant->entry_points[0] != baseline->entry_points[0],
+              "variants swap out entry points");
+  if (!RunDispatchTileA(variant)) return false;
+
+  // The host environment selects whichever the host supports.
+  iree_hal_executable_environment_initialize_from_host(&environment);
+  iree_hal_processor_features_t variant_features =
+      IREE_HAL_PROCESSOR_FEATURE_X86_64_AVX2 |
+      IREE_HAL_PROCESSOR_FEATURE_X86_64_FMA;
+  const iree_hal_executable_library_v0_t* host_library =
+      QueryLibrary(&environment);
+  if ((environment.processor_features & variant_features) ==
+      variant_features) {
+    IREE_ASSERT(host_library == variant, "host supports the variant");
+  } else {
+    IREE_ASSERT(host_library == baseline, "host requires the baseline");
+  }
+  return RunDispatchTileA(host_library);
+}
+
+// Demonstration of the HAL-side of the iree_hal_executable_library_t ABI.
+// This is the lowest level of the system right before calling into generated
+// code.
+//
+// This shows what the various execution systems are doing (through a lot
+// of fancy means): all `inline_command_buffer.c` and `task_command_buffer.c`
+// lead up to just calling into the iree_hal_executable_dispatch_v0_t entry
+// point functions with a state structure and a workgroup XYZ.
+//
+// Below walks through acquiring the library pointer (which in this case is a
+// hand-coded example to show the codegen-side), setting up the I/O buffers and
+// state, and calling the function to do some math.
+//
+// See iree/hal/local/executable_library.h for more information.
+int main(int argc, char** argv) {
+  // Query the library header at the requested version.
+  // The query call in this example is going into the handwritten demo code
+  // but could be targeted at generated files or runtime-loaded shared objects.
+  union {
+    const iree_hal_executable_library_header_t** header;
+    const iree_hal_executable_library_v0_t* v0;
+  } library;
+  library.header = demo_executable_library_query(
+      IREE_HAL_EXECUTABLE_LIBRARY_LATEST_VERSION, /*environment=*/NULL);
+  const iree_hal_executable_library_header_t* header = *library.header;
+  IREE_ASSERT_NE(header, NULL, "version may not have matched");
+  IREE_ASSERT_LE(
+      header->version, IREE_HAL_EXECUTABLE_LIBRARY_LATEST_VERSION,
+      "expecting the library to have the same or older version as us");
+  IREE_ASSERT(strcmp(header->name, "demo_library") == 0,
+              "library name can be used to rendezvous in a registry");
+  IREE_ASSERT_GT(library.v0->entry_point_count, 0,
+                 "expected at least one entry point");
+
+  bool all_match = RunDispatchTileA(library.v0);
+  all_match = TestVariantSelection(library.v0) && all_match;
   return all_match ? 0 : 1;
 }
@@ -8,10 +8,27 @@
 
 #include "iree/base/api.h"
 
+iree_status_t iree_hal_executable_import_provider_resolve(
+    const iree_hal_executable_import_provider_t import_provider,
+    iree_string_view_t symbol_name, void** out_fn_ptr) {
+  IREE_ASSERT_ARGUMENT(out_fn_ptr);
+  *out_fn_ptr = NULL;
+  if (!import_provider.resolve) {
+    return iree_make_status(IREE_STATUS_NOT_FOUND,
+                            "no import provider registered; cannot resolve "
+                            "'%.*s'",
+                            (int)symbol_name.size, symbol_name.data);
+  }
+  return import_provider.resolve(import_provider.self, symbol_name,
+                                 out_fn_ptr);
+}
+
 void iree_hal_executable_loader_initialize(
-    const void* vtable, iree_hal_executable_loader_t* out_base_loader) {
+    const void* vtable, iree_hal_executable_import_provider_t import_provider,
+    iree_hal_executable_loader_t* out_base_loader) {
   iree_atomic_ref_count_init(&out_base_loader->ref_count);
   out_base_loader->vtable = vtable;
+  out_base_loader->import_provider = import_provider;
 }
 
 void iree_hal_executable_loader_retain(
@@ -38,6 +55,17 @@ bool iree_hal_executable_loader_query_support(
       executable_loader, caching_mode, executable_format);
 }
 
+iree_hal_executable_caching_mode_t
+iree_hal_executable_loader_query_caching_mode(
+    iree_hal_executable_loader_t* executable_loader,
+    const iree_hal_executable_spec_t* executable_spec) {
+  IREE_ASSERT_ARGUMENT(executable_loader);
+  IREE_ASSERT_ARGUMENT(executable_spec);
+  if (!executable_loader->vtable->query_caching_mode) return 0;
+  return executable_loader->vtable->query_caching_mode(executable_loader,
+                                                       executable_spec);
+}
+
 iree_status_t iree_hal_executable_loader_try_load(
     iree_hal_executable_loader_t* executable_loader,
     const iree_hal_executable_spec_t* executable_spec,
@@ -52,3 +80,11 @@ iree_status_t iree_hal_executable_loader_try_load(
   return executable_loader->vtable->try_load(executable_loader, executable_spec,
                                              out_executable);
 }
+
+iree_status_t iree_hal_executable_loader_resolve_import(
+    iree_hal_executable_loader_t* executable_loader,
+    iree_string_view_t symbol_name, void** out_fn_ptr) {
+  IREE_ASSERT_ARGUMENT(executable_loader);
+  return iree_hal_executable_import_provider_resolve(
+      executable_loader->import_provider, symbol_name, out_fn_ptr);
+}
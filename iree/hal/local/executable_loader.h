@@ -18,6 +18,39 @@
 extern "C" {
 #endif  // __cplusplus
 
+//===----------------------------------------------------------------------===//
+// iree_hal_executable_import_provider_t
+//===----------------------------------------------------------------------===//
+
+// Interface used to resolve executable imports at load-time.
+// This virtualizes some external provider (such as a registry of microkernels
+// shipped with the runtime) and does not take ownership of the instance:
+// callers must ensure that the provider remains valid for the lifetime of the
+// executable loader that it is providing for.
+typedef struct iree_hal_executable_import_provider_t {
+  // User-defined pointer passed to all functions.
+  void* self;
+
+  // Resolves |symbol_name| to a function pointer in |out_fn_ptr|.
+  // Returns IREE_STATUS_NOT_FOUND if the symbol is not provided.
+  iree_status_t(IREE_API_PTR* resolve)(void* self,
+                                       iree_string_view_t symbol_name,
+                                       void** out_fn_ptr);
+} iree_hal_executable_import_provider_t;
+
+// Returns a provider that resolves no imports.
+static inline iree_hal_executable_import_provider_t
+iree_hal_executable_import_provider_null(void) {
+  iree_hal_executable_import_provider_t provider = {NULL, NULL};
+  return provider;
+}
+
+// Resolves an import |symbol_name| to a function pointer in |out_fn_ptr|.
+// Returns IREE_STATUS_NOT_FOUND if the symbol is not provided.
+iree_status_t iree_hal_executable_import_provider_resolve(
+    const iree_hal_executable_import_provider_t import_provider,
+    iree_string_view_t symbol_name, void** out_fn_ptr);
+
 //===----------------------------------------------------------------------===//
 // iree_hal_executable_loader_t
 //===----------------------------------------------------------------------===//
@@ -37,12 +70,15 @@ typedef struct iree_hal_executable_loader_vtable_t
 typedef struct iree_hal_executable_loader_t {
   iree_atomic_ref_count_t ref_count;
   const iree_hal_executable_loader_vtable_t* vtable;
+  iree_hal_executable_import_provider_t import_provider;
 } iree_hal_executable_loader_t;
 
 // Initializes the base iree_hal_executable_loader_t type.
-// Called by subclasses upon allocating their loader.
+// Called by subclasses upon allocating their loader. |import_provider| is used
+// to resolve the imports of executables loaded by the loader.
 void iree_hal_executable_loader_initialize(
-    const void* vtable, iree_hal_executable_loader_t* out_base_loader);
+    const void* vtable, iree_hal_executable_import_provider_t import_provider,
+    iree_hal_executable_loader_t* out_base_loader);
 
 // Retains the given |executable_loader| for the caller.
 void iree_hal_executable_loader_retain(
@@ -60,6 +96,16 @@ bool iree_hal_executable_loader_query_support(
     iree_hal_executable_caching_mode_t caching_mode,
     iree_string_view_t executable_format);
 
+// Returns caching mode bits requested by the executable in |executable_spec|,
+// such as IREE_HAL_EXECUTABLE_CACHING_MODE_ALLOW_DEFERRED_PREPARATION when the
+// compiler hinted that the executable may be prepared lazily. Only inspects
+// the executable data and does not load it. Returns 0 if the loader does not
+// support hints or the executable has none.
+iree_hal_executable_caching_mode_t
+iree_hal_executable_loader_query_caching_mode(
+    iree_hal_executable_loader_t* executable_loader,
+    const iree_hal_executable_spec_t* executable_spec);
+
 // Tries loading the |executable_data| provided in the given
 // |executable_format|. May fail even if the executable is valid if it requires
 // features not supported by the current host or runtime (such as available
@@ -77,6 +123,12 @@ iree_status_t iree_hal_executable_loader_try_load(
     const iree_hal_executable_spec_t* executable_spec,
     iree_hal_executable_t** out_executable);
 
+// Resolves an import |symbol_name| using the import provider of the loader.
+// Returns IREE_STATUS_NOT_FOUND if the symbol is not provided.
+iree_status_t iree_hal_executable_loader_resolve_import(
+    iree_hal_executable_loader_t* executable_loader,
+    iree_string_view_t symbol_name, void** out_fn_ptr);
+
 //===----------------------------------------------------------------------===//
 // iree_hal_executable_loader_t implementation details
 //===----------------------------------------------------------------------===//
@@ -93,6 +145,11 @@ typedef struct iree_hal_executable_loader_vtable_t {
       iree_hal_executable_loader_t* executable_loader,
       const iree_hal_executable_spec_t* executable_spec,
       iree_hal_executable_t** out_executable);
+
+  // Optional; NULL if the loader does not support executable hints.
+  iree_hal_executable_caching_mode_t(IREE_API_PTR* query_caching_mode)(
+      iree_hal_executable_loader_t* executable_loader,
+      const iree_hal_executable_spec_t* executable_spec);
 } iree_hal_executable_loader_vtable_t;
 
 #ifdef __cplusplus
@@ -384,16 +384,19 @@ static iree_status_t iree_hal_inline_command_buffer_dispatch(
   iree_hal_local_executable_layout_t* local_layout =
       local_executable->executable_layouts[entry_point];
 
+  // Executables with deferred preparation only know their dispatch attributes
+  // and imports once prepared.
+  IREE_RETURN_IF_ERROR(iree_hal_local_executable_prepare(local_executable));
+
   iree_hal_executable_dispatch_state_v0_t* dispatch_state =
       &command_buffer->state.dispatch_state;
 
-  // TODO(benvanik): pull imports from layout.
-  dispatch_state->imports = NULL;
+  // Each executable may import a unique set of functions that were resolved
+  // when it was loaded.
+  dispatch_state->imports = local_executable->imports;
 
-  // TODO(benvanik): expose on API or keep fixed on executable.
-  dispatch_state->workgroup_size.x = 1;
-  dispatch_state->workgroup_size.y = 1;
-  dispatch_state->workgroup_size.z = 1;
+  dispatch_state->workgroup_size =
+      iree_hal_local_executable_workgroup_size(local_executable, entry_point);
   dispatch_state->workgroup_count.x = workgroup_x;
   dispatch_state->workgroup_count.y = workgroup_y;
   dispatch_state->workgroup_count.z = workgroup_z;
@@ -9,10 +9,12 @@
 #include <stdbool.h>
 #include <stddef.h>
 #include <stdint.h>
+#include <string.h>
 
 #include "iree/base/tracing.h"
 #include "iree/hal/api.h"
 #include "iree/hal/local/elf/elf_module.h"
+#include "iree/hal/local/executable_environment.h"
 #include "iree/hal/local/executable_library.h"
 #include "iree/hal/local/local_executable.h"
 #include "iree/hal/local/local_executable_layout.h"
@@ -40,18 +42,22 @@ typedef struct iree_hal_elf_executable_t {
 extern const iree_hal_local_executable_vtable_t iree_hal_elf_executable_vtable;
 
 static iree_status_t iree_hal_elf_executable_query_library(
-    iree_hal_elf_executable_t* executable) {
+    iree_hal_elf_executable_t* executable,
+    const iree_hal_executable_environment_v0_t* environment,
+    iree_hal_executable_import_provider_t import_provider) {
   // Get the exported symbol used to get the library metadata.
   iree_hal_executable_library_query_fn_t query_fn = NULL;
   IREE_RETURN_IF_ERROR(iree_elf_module_lookup_export(
       &executable->module, IREE_HAL_EXECUTABLE_LIBRARY_EXPORT_NAME,
       (void**)&query_fn));
 
-  // Query for a compatible version of the library.
+  // Query for a compatible version of the library. Libraries containing
+  // variants for multiple processor feature sets will select one based on the
+  // environment.
   executable->library.header =
       (const iree_hal_executable_library_header_t**)iree_elf_call_p_ip(
           query_fn, IREE_HAL_EXECUTABLE_LIBRARY_LATEST_VERSION,
-          /*reserved=*/NULL);
+          (void*)environment);
   if (!executable->library.header) {
     return iree_make_status(
         IREE_STATUS_FAILED_PRECONDITION,
@@ -79,6 +85,17 @@ static iree_status_t iree_hal_elf_executable_query_library(
 
   executable->identifier = iree_make_cstring_view(header->name);
 
+  // Dispatch attributes are only present in newer libraries.
+  if (header->version >= IREE_HAL_EXECUTABLE_LIBRARY_VERSION_0_2) {
+    executable->base.dispatch_attrs = executable->library.v0->entry_point_attrs;
+  }
+
+  // Imports are only present in newer libraries.
+  if (header->version >= IREE_HAL_EXECUTABLE_LIBRARY_VERSION_0_3) {
+    IREE_RETURN_IF_ERROR(iree_hal_local_executable_resolve_imports(
+        &executable->base, &executable->library.v0->imports, import_provider));
+  }
+
   return iree_ok_status();
 }
 
@@ -86,6 +103,8 @@ static iree_status_t iree_hal_elf_executable_create(
     iree_hal_executable_caching_mode_t caching_mode,
     iree_const_byte_span_t elf_data, iree_host_size_t executable_layout_count,
     iree_hal_executable_layout_t* const* executable_layouts,
+    const iree_hal_executable_environment_v0_t* environment,
+    iree_hal_executable_import_provider_t import_provider,
     iree_allocator_t host_allocator, iree_hal_executable_t** out_executable) {
   IREE_ASSERT_ARGUMENT(elf_data.data && elf_data.data_length);
   IREE_ASSERT_ARGUMENT(!executable_layout_count || executable_layouts);
@@ -115,7 +134,8 @@ static iree_status_t iree_hal_elf_executable_create(
   }
   if (iree_status_is_ok(status)) {
     // Query metadata and get the entry point function pointers.
-    status = iree_hal_elf_executable_query_library(executable);
+    status = iree_hal_elf_executable_query_library(executable, environment,
+                                                   import_provider);
   }
   if (iree_status_is_ok(status) &&
       !iree_all_bits_set(
@@ -211,12 +231,15 @@ const iree_hal_local_executable_vtable_t iree_hal_elf_executable_vtable = {
 typedef struct iree_hal_embedded_library_loader_t {
   iree_hal_executable_loader_t base;
   iree_allocator_t host_allocator;
+  // Host environment used to select between library variants.
+  iree_hal_executable_environment_v0_t environment;
 } iree_hal_embedded_library_loader_t;
 
 extern const iree_hal_executable_loader_vtable_t
     iree_hal_embedded_library_loader_vtable;
 
 iree_status_t iree_hal_embedded_library_loader_create(
+    iree_hal_executable_import_provider_t import_provider,
     iree_allocator_t host_allocator,
     iree_hal_executable_loader_t** out_executable_loader) {
   IREE_ASSERT_ARGUMENT(out_executable_loader);
@@ -228,8 +251,11 @@ iree_status_t iree_hal_embedded_library_loader_create(
       host_allocator, sizeof(*executable_loader), (void**)&executable_loader);
   if (iree_status_is_ok(status)) {
     iree_hal_executable_loader_initialize(
-        &iree_hal_embedded_library_loader_vtable, &executable_loader->base);
+        &iree_hal_embedded_library_loader_vtable, import_provider,
+        &executable_loader->base);
     executable_loader->host_allocator = host_allocator;
+    iree_hal_executable_environment_initialize_from_host(
+        &executable_loader->environment);
     *out_executable_loader = (iree_hal_executable_loader_t*)executable_loader;
   }
 
@@ -271,16 +297,48 @@ static iree_status_t iree_hal_embedded_library_loader_try_load(
   iree_status_t status = iree_hal_elf_executable_create(
       executable_spec->caching_mode, executable_spec->executable_data,
       executable_spec->executable_layout_count,
-      executable_spec->executable_layouts, executable_loader->host_allocator,
-      out_executable);
+      executable_spec->executable_layouts, &executable_loader->environment,
+      executable_loader->base.import_provider,
+      executable_loader->host_allocator, out_executable);
 
   IREE_TRACE_ZONE_END(z0);
   return status;
 }
 
+static iree_hal_executable_caching_mode_t
+iree_hal_embedded_library_loader_query_caching_mode(
+    iree_hal_executable_loader_t* base_executable_loader,
+    const iree_hal_executable_spec_t* executable_spec) {
+  // Hints are optional and invalid ELFs will fail when loaded so any failure
+  // here is treated as there being no hints.
+  iree_const_byte_span_t contents = iree_make_const_byte_span(NULL, 0);
+  iree_status_t status = iree_elf_module_query_section(
+      executable_spec->executable_data,
+      iree_make_cstring_view(IREE_HAL_EXECUTABLE_LIBRARY_HINTS_SECTION_NAME),
+      &contents);
+  if (!iree_status_is_ok(status)) {
+    iree_status_ignore(status);
+    return 0;
+  }
+  iree_hal_executable_library_hints_v0_t hints;
+  if (contents.data_length < sizeof(hints)) return 0;
+  memcpy(&hints, contents.data, sizeof(hints));
+  if (hints.version != 0) return 0;
+  switch (hints.preparation) {
+    case IREE_HAL_EXECUTABLE_LIBRARY_PREPARATION_DEFERRED:
+      return IREE_HAL_EXECUTABLE_CACHING_MODE_ALLOW_DEFERRED_PREPARATION;
+    case IREE_HAL_EXECUTABLE_LIBRARY_PREPARATION_ASYNC:
+      return IREE_HAL_EXECUTABLE_CACHING_MODE_ALLOW_ASYNC_PREPARATION;
+    default:
+      return 0;
+  }
+}
+
 const iree_hal_executable_loader_vtable_t
     iree_hal_embedded_library_loader_vtable = {
         .destroy = iree_hal_embedded_library_loader_destroy,
         .query_support = iree_hal_embedded_library_loader_query_support,
         .try_load = iree_hal_embedded_library_loader_try_load,
+        .query_caching_mode =
+            iree_hal_embedded_library_loader_query_caching_mode,
 };
@@ -21,7 +21,10 @@ extern "C" {
 // libraries on any platform. This allows us to use a single file format across
 // all operating systems at the cost of some missing debugging/profiling
 // features.
+//
+// Functions imported by executables are resolved with |import_provider|.
 iree_status_t iree_hal_embedded_library_loader_create(
+    iree_hal_executable_import_provider_t import_provider,
     iree_allocator_t host_allocator,
     iree_hal_executable_loader_t** out_executable_loader);
 
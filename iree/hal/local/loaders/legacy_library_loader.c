@@ -13,6 +13,7 @@
 #include "iree/base/internal/dynamic_library.h"
 #include "iree/base/tracing.h"
 #include "iree/hal/api.h"
+#include "iree/hal/local/executable_environment.h"
 #include "iree/hal/local/executable_library.h"
 #include "iree/hal/local/local_executable.h"
 #include "iree/hal/local/local_executable_layout.h"
@@ -113,16 +114,20 @@ static iree_status_t iree_hal_legacy_executable_extract_and_load(
 }
 
 static iree_status_t iree_hal_legacy_executable_query_library(
-    iree_hal_legacy_executable_t* executable) {
+    iree_hal_legacy_executable_t* executable,
+    const iree_hal_executable_environment_v0_t* environment,
+    iree_hal_executable_import_provider_t import_provider) {
   // Get the exported symbol used to get the library metadata.
   iree_hal_executable_library_query_fn_t query_fn = NULL;
   IREE_RETURN_IF_ERROR(iree_dynamic_library_lookup_symbol(
       executable->handle, IREE_HAL_EXECUTABLE_LIBRARY_EXPORT_NAME,
       (void**)&query_fn));
 
-  // Query for a compatible version of the library.
+  // Query for a compatible version of the library. Libraries containing
+  // variants for multiple processor feature sets will select one based on the
+  // environment.
   executable->library.header =
-      query_fn(IREE_HAL_EXECUTABLE_LIBRARY_LATEST_VERSION, /*reserved=*/NULL);
+      query_fn(IREE_HAL_EXECUTABLE_LIBRARY_LATEST_VERSION, environment);
   if (!executable->library.header) {
     return iree_make_status(
         IREE_STATUS_FAILED_PRECONDITION,
@@ -163,6 +168,17 @@ static iree_status_t iree_hal_legacy_executable_query_library(
 
   executable->identifier = iree_make_cstring_view(header->name);
 
+  // Dispatch attributes are only present in newer libraries.
+  if (header->version >= IREE_HAL_EXECUTABLE_LIBRARY_VERSION_0_2) {
+    executable->base.dispatch_attrs = executable->library.v0->entry_point_attrs;
+  }
+
+  // Imports are only present in newer libraries.
+  if (header->version >= IREE_HAL_EXECUTABLE_LIBRARY_VERSION_0_3) {
+    IREE_RETURN_IF_ERROR(iree_hal_local_executable_resolve_imports(
+        &executable->base, &executable->library.v0->imports, import_provider));
+  }
+
   return iree_ok_status();
 }
 
@@ -170,6 +186,8 @@ static iree_status_t iree_hal_legacy_executable_create(
     iree_DyLibExecutableDef_table_t executable_def,
     iree_host_size_t executable_layout_count,
     iree_hal_executable_layout_t* const* executable_layouts,
+    const iree_hal_executable_environment_v0_t* environment,
+    iree_hal_executable_import_provider_t import_provider,
     iree_allocator_t host_allocator, iree_hal_executable_t** out_executable) {
   IREE_ASSERT_ARGUMENT(executable_def);
   IREE_ASSERT_ARGUMENT(!executable_layout_count || executable_layouts);
@@ -203,7 +221,8 @@ static iree_status_t iree_hal_legacy_executable_create(
   }
   if (iree_status_is_ok(status)) {
     // Query metadata and get the entry point function pointers.
-    status = iree_hal_legacy_executable_query_library(executable);
+    status = iree_hal_legacy_executable_query_library(executable, environment,
+                                                      import_provider);
   }
   if (iree_status_is_ok(status)) {
     // Check to make sure that the entry point count matches the layouts
@@ -291,12 +310,15 @@ const iree_hal_local_executable_vtable_t iree_hal_legacy_executable_vtable = {
 typedef struct iree_hal_legacy_library_loader_t {
   iree_hal_executable_loader_t base;
   iree_allocator_t host_allocator;
+  // Host environment used to select between library variants.
+  iree_hal_executable_environment_v0_t environment;
 } iree_hal_legacy_library_loader_t;
 
 extern const iree_hal_executable_loader_vtable_t
     iree_hal_legacy_library_loader_vtable;
 
 iree_status_t iree_hal_legacy_library_loader_create(
+    iree_hal_executable_import_provider_t import_provider,
     iree_allocator_t host_allocator,
     iree_hal_executable_loader_t** out_executable_loader) {
   IREE_ASSERT_ARGUMENT(out_executable_loader);
@@ -308,8 +330,11 @@ iree_status_t iree_hal_legacy_library_loader_create(
       host_allocator, sizeof(*executable_loader), (void**)&executable_loader);
   if (iree_status_is_ok(status)) {
     iree_hal_executable_loader_initialize(
-        &iree_hal_legacy_library_loader_vtable, &executable_loader->base);
+        &iree_hal_legacy_library_loader_vtable, import_provider,
+        &executable_loader->base);
     executable_loader->host_allocator = host_allocator;
+    iree_hal_executable_environment_initialize_from_host(
+        &executable_loader->environment);
     *out_executable_loader = (iree_hal_executable_loader_t*)executable_loader;
   }
 
@@ -357,6 +382,8 @@ static iree_status_t iree_hal_legacy_library_loader_try_load(
       z0, iree_hal_legacy_executable_create(
               executable_def, executable_spec->executable_layout_count,
               executable_spec->executable_layouts,
+              &executable_loader->environment,
+              executable_loader->base.import_provider,
               executable_loader->host_allocator, out_executable));
 
   IREE_TRACE_ZONE_END(z0);
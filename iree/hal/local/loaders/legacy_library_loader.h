@@ -23,7 +23,10 @@ extern "C" {
 // This uses the legacy "dylib"-style format that will be deleted soon and is
 // only a placeholder until the compiler can be switched to output
 // iree_hal_executable_library_t-compatible files.
+//
+// Functions imported by executables are resolved with |import_provider|.
 iree_status_t iree_hal_legacy_library_loader_create(
+    iree_hal_executable_import_provider_t import_provider,
     iree_allocator_t host_allocator,
     iree_hal_executable_loader_t** out_executable_loader);
 
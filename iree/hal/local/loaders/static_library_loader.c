@@ -27,7 +27,7 @@ typedef struct iree_hal_static_executable_t {
   iree_string_view_t identifier;
 
   union {
-    const iree_hal_executable_library_header_t* header;
+    const iree_hal_executable_library_header_t** header;
     const iree_hal_executable_library_v0_t* v0;
   } library;
 } iree_hal_static_executable_t;
@@ -36,9 +36,10 @@ static const iree_hal_local_executable_vtable_t
     iree_hal_static_executable_vtable;
 
 static iree_status_t iree_hal_static_executable_create(
-    const iree_hal_executable_library_header_t* library_header,
+    const iree_hal_executable_library_header_t** library_header,
     iree_host_size_t executable_layout_count,
     iree_hal_executable_layout_t* const* executable_layouts,
+    iree_hal_executable_import_provider_t import_provider,
     iree_allocator_t host_allocator, iree_hal_executable_t** out_executable) {
   IREE_ASSERT_ARGUMENT(library_header);
   IREE_ASSERT_ARGUMENT(!executable_layout_count || executable_layouts);
@@ -61,8 +62,22 @@ static iree_status_t iree_hal_static_executable_create(
         executable_layouts, executable_layouts_ptr, host_allocator,
         &executable->base);
     executable->library.header = library_header;
-    executable->identifier = iree_make_cstring_view(library_header->name);
+    executable->identifier = iree_make_cstring_view((*library_header)->name);
+    if ((*library_header)->version >= IREE_HAL_EXECUTABLE_LIBRARY_VERSION_0_2) {
+      executable->base.dispatch_attrs =
+          executable->library.v0->entry_point_attrs;
+    }
+    if ((*library_header)->version >= IREE_HAL_EXECUTABLE_LIBRARY_VERSION_0_3) {
+      status = iree_hal_local_executable_resolve_imports(
+          &executable->base, &executable->library.v0->imports,
+          import_provider);
+    }
+  }
+
+  if (iree_status_is_ok(status)) {
     *out_executable = (iree_hal_executable_t*)executable;
+  } else {
+    iree_hal_executable_release((iree_hal_executable_t*)executable);
   }
 
   IREE_TRACE_ZONE_END(z0);
@@ -138,7 +153,7 @@ typedef struct iree_hal_static_library_loader_t {
   iree_hal_executable_loader_t base;
   iree_allocator_t host_allocator;
   iree_host_size_t library_count;
-  iree_hal_executable_library_header_t* const libraries[];
+  const iree_hal_executable_library_header_t** libraries[];
 } iree_hal_static_library_loader_t;
 
 static const iree_hal_executable_loader_vtable_t
@@ -146,7 +161,8 @@ static const iree_hal_executable_loader_vtable_t
 
 iree_status_t iree_hal_static_library_loader_create(
     iree_host_size_t library_count,
-    const iree_hal_executable_library_header_t* const* libraries,
+    const iree_hal_executable_library_header_t** const* libraries,
+    iree_hal_executable_import_provider_t import_provider,
     iree_allocator_t host_allocator,
     iree_hal_executable_loader_t** out_executable_loader) {
   IREE_ASSERT_ARGUMENT(out_executable_loader);
@@ -158,12 +174,12 @@ iree_status_t iree_hal_static_library_loader_create(
   // version of the IREE compiler that are then linked with an older version of
   // the runtime are difficult to spot otherwise.
   for (iree_host_size_t i = 0; i < library_count; ++i) {
-    if (libraries[i]->version > IREE_HAL_EXECUTABLE_LIBRARY_LATEST_VERSION) {
+    if ((*libraries[i])->version > IREE_HAL_EXECUTABLE_LIBRARY_LATEST_VERSION) {
       IREE_TRACE_ZONE_END(z0);
       return iree_make_status(IREE_STATUS_FAILED_PRECONDITION,
                               "executable does not support this version of the "
                               "runtime (executable: %d, runtime: %d)",
-                              libraries[i]->version,
+                              (*libraries[i])->version,
                               IREE_HAL_EXECUTABLE_LIBRARY_LATEST_VERSION);
     }
   }
@@ -176,7 +192,8 @@ iree_status_t iree_hal_static_library_loader_create(
                                                (void**)&executable_loader);
   if (iree_status_is_ok(status)) {
     iree_hal_executable_loader_initialize(
-        &iree_hal_static_library_loader_vtable, &executable_loader->base);
+        &iree_hal_static_library_loader_vtable, import_provider,
+        &executable_loader->base);
     executable_loader->host_allocator = host_allocator;
     executable_loader->library_count = library_count;
     memcpy((void*)executable_loader->libraries, libraries,
@@ -228,11 +245,12 @@ static iree_status_t iree_hal_static_library_loader_try_load(
   for (iree_host_size_t i = 0; i < executable_loader->library_count; ++i) {
     if (iree_string_view_equal(
             library_name,
-            iree_make_cstring_view(executable_loader->libraries[i]->name))) {
+            iree_make_cstring_view((*executable_loader->libraries[i])->name))) {
       return iree_hal_static_executable_create(
           executable_loader->libraries[i],
           executable_spec->executable_layout_count,
           executable_spec->executable_layouts,
+          executable_loader->base.import_provider,
           executable_loader->host_allocator, out_executable);
     }
   }
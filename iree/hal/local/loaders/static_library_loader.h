@@ -19,7 +19,8 @@ extern "C" {
 #endif  // __cplusplus
 
 // Creates a library loader that exposes the provided libraries to the HAL for
-// use as executables.
+// use as executables. Each library is the value returned by its
+// iree_hal_executable_library_query_fn_t.
 //
 // This loader will handle executable formats of 'static'. Version checks will
 // ensure that the IREE compiler-produced static library version is one that the
@@ -33,9 +34,12 @@ extern "C" {
 // Multiple static library loaders can be registered in cases when several
 // independent sets of libraries are linked in however duplicate names both
 // within and across loaders will result in undefined behavior.
+//
+// Functions imported by executables are resolved with |import_provider|.
 iree_status_t iree_hal_static_library_loader_create(
     iree_host_size_t library_count,
-    const iree_hal_executable_library_header_t* const* libraries,
+    const iree_hal_executable_library_header_t** const* libraries,
+    iree_hal_executable_import_provider_t import_provider,
     iree_allocator_t host_allocator,
     iree_hal_executable_loader_t** out_executable_loader);
 
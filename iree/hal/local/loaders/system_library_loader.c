@@ -39,6 +39,7 @@ static iree_status_t iree_hal_system_executable_create(
     const iree_hal_executable_library_header_t* library_header,
     iree_host_size_t executable_layout_count,
     iree_hal_executable_layout_t* const* executable_layouts,
+    iree_hal_executable_import_provider_t import_provider,
     iree_allocator_t host_allocator, iree_hal_executable_t** out_executable) {
   IREE_ASSERT_ARGUMENT(library_header);
   IREE_ASSERT_ARGUMENT(!executable_layout_count || executable_layouts);
@@ -61,7 +62,23 @@ static iree_status_t iree_hal_system_executable_create(
         executable_layouts, executable_layouts_ptr, host_allocator,
         &executable->base);
     executable->library.header = library_header;
+    if (executable->library.v0->header->version >=
+        IREE_HAL_EXECUTABLE_LIBRARY_VERSION_0_2) {
+      executable->base.dispatch_attrs =
+          executable->library.v0->entry_point_attrs;
+    }
+    if (executable->library.v0->header->version >=
+        IREE_HAL_EXECUTABLE_LIBRARY_VERSION_0_3) {
+      status = iree_hal_local_executable_resolve_imports(
+          &executable->base, &executable->library.v0->imports,
+          import_provider);
+    }
+  }
+
+  if (iree_status_is_ok(status)) {
     *out_executable = (iree_hal_executable_t*)executable;
+  } else {
+    iree_hal_executable_release((iree_hal_executable_t*)executable);
   }
 
   IREE_TRACE_ZONE_END(z0);
@@ -139,6 +156,7 @@ static const iree_hal_executable_loader_vtable_t
     iree_hal_system_library_loader_vtable;
 
 iree_status_t iree_hal_system_library_loader_create(
+    iree_hal_executable_import_provider_t import_provider,
     iree_allocator_t host_allocator,
     iree_hal_executable_loader_t** out_executable_loader) {
   IREE_ASSERT_ARGUMENT(out_executable_loader);
@@ -150,7 +168,8 @@ iree_status_t iree_hal_system_library_loader_create(
       host_allocator, sizeof(*executable_loader), (void**)&executable_loader);
   if (iree_status_is_ok(status)) {
     iree_hal_executable_loader_initialize(
-        &iree_hal_system_library_loader_vtable, &executable_loader->base);
+        &iree_hal_system_library_loader_vtable, import_provider,
+        &executable_loader->base);
     executable_loader->host_allocator = host_allocator;
     *out_executable_loader = (iree_hal_executable_loader_t*)executable_loader;
   }
@@ -19,7 +19,10 @@ extern "C" {
 
 // Creates an executable loader that can load files from platform-supported
 // dynamic libraries (such as .dylib on darwin, .so on linux, .dll on windows).
+//
+// Functions imported by executables are resolved with |import_provider|.
 iree_status_t iree_hal_system_library_loader_create(
+    iree_hal_executable_import_provider_t import_provider,
     iree_allocator_t host_allocator,
     iree_hal_executable_loader_t** out_executable_loader);
 
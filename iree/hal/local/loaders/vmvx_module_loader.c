@@ -11,6 +11,7 @@
 #include <stdint.h>
 #include <string.h>
 
+#include "iree/base/internal/atomics.h"
 #include "iree/base/tracing.h"
 #include "iree/hal/api.h"
 #include "iree/hal/local/executable_library.h"
@@ -19,20 +20,154 @@
 #include "iree/modules/vmvx/module.h"
 #include "iree/vm/bytecode_module.h"
 
+#define IREE_VMVX_ENTRY_SIGNATURE "0rrriiiiiiiii_v"
+
+// Maximum number of processors that may keep cached invocation state on an
+// executable. Processors with larger IDs allocate their state per call.
+#define IREE_VMVX_MAX_CACHED_PROCESSOR_COUNT 64
+
 //===----------------------------------------------------------------------===//
-// iree_hal_vmvx_executable_t
+// iree_hal_vmvx_invocation_cache_t
 //===----------------------------------------------------------------------===//
 
-// Maximum size allowed for the scratchpad memory used by dispatches.
-// TODO(benvanik): allow this to be specified as a reflection attr on the entry
-// points. For now we aren't even generating any code using it so keep it 0.
-// #define IREE_VMVX_MAX_SCRATCHPAD_SIZE (64 * 1024)
-#define IREE_VMVX_MAX_SCRATCHPAD_SIZE 0
+// Invocation state reused across all workgroups issued on a single processor.
+// Building the binding list, wrapping the buffers, and initializing the VM
+// stack costs more than many small workgroups take to execute so we do it once
+// and then only update the buffer spans and call arguments per workgroup.
+//
+// A cache is exclusively owned by the thread issuing a call: it is swapped out
+// of the executable slot for the processor on acquire and swapped back in on
+// release. If multiple threads share a processor ID (such as with inline
+// execution) any that find the slot empty allocate a temporary cache.
+typedef struct iree_hal_vmvx_invocation_cache_t {
+  // Total number of bindings that can be wrapped by |binding_buffers|.
+  iree_host_size_t binding_capacity;
+  // List of |binding_buffers| passed as the bindings argument. The list size
+  // matches the binding count of the last call issued with the cache.
+  iree_vm_list_t* binding_list;
+  iree_vm_buffer_t* binding_buffers;
+  iree_vm_buffer_t scratchpad_buffer;
+  iree_vm_buffer_t constants_buffer;
+  // Empty between calls with its storage retained for reuse.
+  iree_vm_stack_t* stack;
+} iree_hal_vmvx_invocation_cache_t;
+
+static void iree_hal_vmvx_invocation_cache_free(
+    iree_hal_vmvx_invocation_cache_t* cache, iree_allocator_t host_allocator) {
+  if (!cache) return;
+  iree_vm_stack_deinitialize(cache->stack);
+  iree_vm_list_deinitialize(cache->binding_list);
+  for (iree_host_size_t i = 0; i < cache->binding_capacity; ++i) {
+    iree_vm_buffer_deinitialize(&cache->binding_buffers[i]);
+  }
+  iree_vm_buffer_deinitialize(&cache->scratchpad_buffer);
+  iree_vm_buffer_deinitialize(&cache->constants_buffer);
+  iree_allocator_free(host_allocator, cache);
+}
+
+// Allocates a cache with storage for |binding_capacity| bindings and the VM
+// stack in a single block.
+static iree_status_t iree_hal_vmvx_invocation_cache_allocate(
+    iree_vm_context_t* context, iree_host_size_t binding_capacity,
+    iree_allocator_t host_allocator,
+    iree_hal_vmvx_invocation_cache_t** out_cache) {
+  *out_cache = NULL;
+  IREE_TRACE_ZONE_BEGIN(z0);
 
-// Maximum number of bytes we can allocate on the stack for scratchpad storage.
-#define IREE_VMVX_MAX_STACK_SCRATCHPAD_SIZE (16 * 1024)
+  iree_vm_type_def_t buffer_type =
+      iree_vm_type_def_make_ref_type(iree_vm_buffer_type_id());
+  iree_host_size_t binding_list_size =
+      iree_vm_list_storage_size(&buffer_type, binding_capacity);
+  iree_host_size_t binding_buffers_offset =
+      iree_host_align(sizeof(iree_hal_vmvx_invocation_cache_t),
+                      iree_max_align_t);
+  iree_host_size_t binding_list_offset = iree_host_align(
+      binding_buffers_offset + binding_capacity * sizeof(iree_vm_buffer_t),
+      iree_max_align_t);
+  iree_host_size_t stack_offset = iree_host_align(
+      binding_list_offset + binding_list_size, iree_max_align_t);
+  iree_host_size_t total_size = stack_offset + IREE_VM_STACK_DEFAULT_SIZE;
+
+  iree_hal_vmvx_invocation_cache_t* cache = NULL;
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0, iree_allocator_malloc(host_allocator, total_size, (void**)&cache));
+  uint8_t* cache_ptr = (uint8_t*)cache;
+
+  iree_status_t status = iree_vm_list_initialize(
+      iree_make_byte_span(cache_ptr + binding_list_offset, binding_list_size),
+      &buffer_type, binding_capacity, &cache->binding_list);
+  if (!iree_status_is_ok(status)) {
+    iree_allocator_free(host_allocator, cache);
+    IREE_TRACE_ZONE_END(z0);
+    return status;
+  }
 
-#define IREE_VMVX_ENTRY_SIGNATURE "0rrriiiiiiiii_v"
+  // TODO(benvanik): executable layout contains the required access
+  // information. We will likely want to encode a bitmap of mutable bindings
+  // such that we can quickly set the access bit, though.
+  cache->binding_capacity = binding_capacity;
+  cache->binding_buffers =
+      (iree_vm_buffer_t*)(cache_ptr + binding_buffers_offset);
+  for (iree_host_size_t i = 0; i < binding_capacity; ++i) {
+    iree_vm_buffer_initialize(
+        IREE_VM_BUFFER_ACCESS_MUTABLE | IREE_VM_BUFFER_ACCESS_ORIGIN_HOST,
+        iree_make_byte_span(NULL, 0), iree_allocator_null(),
+        &cache->binding_buffers[i]);
+  }
+  iree_vm_buffer_initialize(
+      IREE_VM_BUFFER_ACCESS_MUTABLE | IREE_VM_BUFFER_ACCESS_ORIGIN_HOST,
+      iree_make_byte_span(NULL, 0), iree_allocator_null(),
+      &cache->scratchpad_buffer);
+  iree_vm_buffer_initialize(IREE_VM_BUFFER_ACCESS_ORIGIN_HOST,
+                            iree_make_byte_span(NULL, 0),
+                            iree_allocator_null(), &cache->constants_buffer);
+
+  // The stack may grow beyond its inline storage for deep call trees; the
+  // growth is kept for subsequent calls.
+  IREE_IGNORE_ERROR(iree_vm_stack_initialize(
+      iree_make_byte_span(cache_ptr + stack_offset,
+                          IREE_VM_STACK_DEFAULT_SIZE),
+      iree_vm_context_state_resolver(context), host_allocator, &cache->stack));
+
+  *out_cache = cache;
+  IREE_TRACE_ZONE_END(z0);
+  return iree_ok_status();
+}
+
+// Updates |cache| to wrap the bindings and push constants in |dispatch_state|.
+static iree_status_t iree_hal_vmvx_invocation_cache_bind(
+    iree_hal_vmvx_invocation_cache_t* cache,
+    const iree_hal_executable_dispatch_state_v0_t* dispatch_state) {
+  // The list only needs to be rebuilt when the binding count changes; the
+  // buffers it references are updated in-place below.
+  if (iree_vm_list_size(cache->binding_list) !=
+      dispatch_state->binding_count) {
+    IREE_RETURN_IF_ERROR(iree_vm_list_resize(cache->binding_list, 0));
+    for (iree_host_size_t i = 0; i < dispatch_state->binding_count; ++i) {
+      iree_vm_ref_t ref = {0};
+      IREE_RETURN_IF_ERROR(iree_vm_ref_wrap_assign(
+          &cache->binding_buffers[i], iree_vm_buffer_type_id(), &ref));
+      IREE_RETURN_IF_ERROR(
+          iree_vm_list_push_ref_retain(cache->binding_list, &ref));
+    }
+  }
+  for (iree_host_size_t i = 0; i < dispatch_state->binding_count; ++i) {
+    cache->binding_buffers[i].data =
+        iree_make_byte_span(dispatch_state->binding_ptrs[i],
+                            dispatch_state->binding_lengths[i]);
+  }
+
+  // Map the push constant memory directly from the dispatch state.
+  cache->constants_buffer.data = iree_make_byte_span(
+      (void*)dispatch_state->push_constants,
+      sizeof(uint32_t) * dispatch_state->push_constant_count);
+
+  return iree_ok_status();
+}
+
+//===----------------------------------------------------------------------===//
+// iree_hal_vmvx_executable_t
+//===----------------------------------------------------------------------===//
 
 typedef struct iree_hal_vmvx_executable_t {
   iree_hal_local_executable_t base;
@@ -40,6 +175,10 @@ typedef struct iree_hal_vmvx_executable_t {
   // Context containing both the VMVX module and the loaded executable.
   iree_vm_context_t* context;
 
+  // Invocation caches indexed by processor ID. Slots are NULL until first used
+  // by a processor and while a processor has the cache acquired.
+  iree_atomic_intptr_t invocation_caches[IREE_VMVX_MAX_CACHED_PROCESSOR_COUNT];
+
   // Resolved entry functions from the module.
   iree_host_size_t entry_fn_count;
   iree_vm_function_t entry_fns[];
@@ -135,6 +274,13 @@ static void iree_hal_vmvx_executable_destroy(
   iree_allocator_t host_allocator = executable->base.host_allocator;
   IREE_TRACE_ZONE_BEGIN(z0);
 
+  for (iree_host_size_t i = 0;
+       i < IREE_ARRAYSIZE(executable->invocation_caches); ++i) {
+    iree_hal_vmvx_invocation_cache_free(
+        (iree_hal_vmvx_invocation_cache_t*)iree_atomic_load_intptr(
+            &executable->invocation_caches[i], iree_memory_order_acquire),
+        host_allocator);
+  }
   iree_vm_context_release(executable->context);
   iree_hal_local_executable_deinitialize(
       (iree_hal_local_executable_t*)base_executable);
@@ -143,6 +289,46 @@ static void iree_hal_vmvx_executable_destroy(
   IREE_TRACE_ZONE_END(z0);
 }
 
+// Acquires the invocation cache for |processor_id| with capacity for at least
+// |binding_count| bindings, allocating a new one if none is available.
+static iree_status_t iree_hal_vmvx_executable_acquire_cache(
+    iree_hal_vmvx_executable_t* executable, uint32_t processor_id,
+    iree_host_size_t binding_count,
+    iree_hal_vmvx_invocation_cache_t** out_cache) {
+  iree_hal_vmvx_invocation_cache_t* cache = NULL;
+  if (processor_id < IREE_ARRAYSIZE(executable->invocation_caches)) {
+    cache = (iree_hal_vmvx_invocation_cache_t*)iree_atomic_exchange_intptr(
+        &executable->invocation_caches[processor_id], 0,
+        iree_memory_order_acquire);
+  }
+  if (cache && cache->binding_capacity >= binding_count) {
+    *out_cache = cache;
+    return iree_ok_status();
+  }
+  iree_hal_vmvx_invocation_cache_free(cache, executable->base.host_allocator);
+  return iree_hal_vmvx_invocation_cache_allocate(
+      executable->context, binding_count, executable->base.host_allocator,
+      out_cache);
+}
+
+// Returns |cache| to the slot for |processor_id| for reuse by subsequent calls.
+// The cache is freed if the slot has been filled by another thread sharing the
+// processor ID in the meantime.
+static void iree_hal_vmvx_executable_release_cache(
+    iree_hal_vmvx_executable_t* executable, uint32_t processor_id,
+    iree_hal_vmvx_invocation_cache_t* cache) {
+  if (processor_id < IREE_ARRAYSIZE(executable->invocation_caches)) {
+    intptr_t expected = 0;
+    if (iree_atomic_compare_exchange_strong_intptr(
+            &executable->invocation_caches[processor_id], &expected,
+            (intptr_t)cache, iree_memory_order_release,
+            iree_memory_order_relaxed)) {
+      return;
+    }
+  }
+  iree_hal_vmvx_invocation_cache_free(cache, executable->base.host_allocator);
+}
+
 static iree_status_t iree_hal_vmvx_executable_issue_call(
     iree_hal_local_executable_t* base_executable, iree_host_size_t ordinal,
     const iree_hal_executable_dispatch_state_v0_t* dispatch_state,
@@ -165,76 +351,31 @@ static iree_status_t iree_hal_vmvx_executable_issue_call(
                                       entry_point_name.size);
 #endif  // IREE_TRACING_FEATURES & IREE_TRACING_FEATURE_INSTRUMENTATION
 
-  // On-stack interface local to this invocation.
-  // Note that we _could_ share this across all invocations in a dispatch, but
-  // it's tricky to find a good place when threading is happening and it's
-  // intentionally fairly cheap to construct by matching the dispatch_state.
-  // The list would only need to be constructed once and we could avoid the
-  // extraneous retain/releases and mappings.
-  iree_vm_type_def_t buffer_type =
-      iree_vm_type_def_make_ref_type(iree_vm_buffer_type_id());
-  iree_host_size_t binding_list_size =
-      iree_vm_list_storage_size(&buffer_type, dispatch_state->binding_count);
-  void* binding_list_storage = iree_alloca(binding_list_size);
-  iree_vm_list_t* binding_list = NULL;
-  IREE_RETURN_IF_ERROR(iree_vm_list_initialize(
-      iree_make_byte_span(binding_list_storage, binding_list_size),
-      &buffer_type, dispatch_state->binding_count, &binding_list));
-  iree_vm_list_retain(binding_list);  // for call
-
-  // Map bindings into on-stack VMVX buffers.
-  iree_vm_buffer_t* binding_buffers = (iree_vm_buffer_t*)iree_alloca(
-      dispatch_state->binding_count * sizeof(iree_vm_buffer_t));
-  for (iree_host_size_t i = 0; i < dispatch_state->binding_count; ++i) {
-    iree_vm_buffer_t* binding_buffer = &binding_buffers[i];
-    // TODO(benvanik): executable layout contains the required access
-    // information. We will likely want to encode a bitmap of mutable bindings
-    // such that we can quickly set the access bit, though.
-    iree_vm_buffer_access_t access =
-        IREE_VM_BUFFER_ACCESS_MUTABLE | IREE_VM_BUFFER_ACCESS_ORIGIN_HOST;
-    iree_vm_buffer_initialize(
-        access,
-        iree_make_byte_span(dispatch_state->binding_ptrs[i],
-                            dispatch_state->binding_lengths[i]),
-        iree_allocator_null(), binding_buffer);
-    iree_vm_ref_t ref = {0};
-    IREE_RETURN_IF_ERROR(iree_vm_ref_wrap_assign(
-        binding_buffer, iree_vm_buffer_type_id(), &ref));
-    IREE_RETURN_IF_ERROR(iree_vm_list_push_ref_retain(binding_list, &ref));
+  // Interface state shared with all other workgroups issued on this processor.
+  // Only the buffer spans are updated for each call.
+  iree_hal_vmvx_invocation_cache_t* cache = NULL;
+  iree_status_t status = iree_hal_vmvx_executable_acquire_cache(
+      executable, dispatch_state->processor_id, dispatch_state->binding_count,
+      &cache);
+  if (iree_status_is_ok(status)) {
+    status = iree_hal_vmvx_invocation_cache_bind(cache, dispatch_state);
   }
-
-  // Acquire scratchpad memory for the dispatch.
-  // If it's small enough we can take it from the stack.
-  // TODO(benvanik): pull size from entry reflection attr (cache on executable).
-  // TODO(benvanik): allocate the stack/interface/etc from this same buffer.
-  iree_host_size_t scratchpad_size = IREE_VMVX_MAX_SCRATCHPAD_SIZE;
-  iree_byte_span_t scratch_memory;
-  if (scratchpad_size == 0) {
-    scratch_memory = iree_make_byte_span(NULL, 0);
-  } else if (scratchpad_size <= IREE_VMVX_MAX_STACK_SCRATCHPAD_SIZE) {
-    scratch_memory =
-        iree_make_byte_span(iree_alloca(scratchpad_size), scratchpad_size);
-  } else {
-    scratch_memory.data_length = scratchpad_size;
-    IREE_RETURN_IF_ERROR(iree_allocator_malloc(executable->base.host_allocator,
-                                               scratchpad_size,
-                                               (void**)&scratch_memory.data));
+  if (!iree_status_is_ok(status)) {
+    iree_hal_vmvx_invocation_cache_free(cache,
+                                        executable->base.host_allocator);
+    IREE_TRACE_ZONE_END(z0);
+    return status;
   }
-  iree_vm_buffer_t scratchpad_buffer;
-  iree_vm_buffer_initialize(
-      IREE_VM_BUFFER_ACCESS_MUTABLE | IREE_VM_BUFFER_ACCESS_ORIGIN_HOST,
-      scratch_memory, iree_allocator_null(), &scratchpad_buffer);
-  iree_vm_buffer_retain(&scratchpad_buffer);  // for call
 
-  // Map the push constant memory directly from the dispatch state.
-  iree_vm_buffer_t constants_buffer;
-  iree_vm_buffer_initialize(
-      IREE_VM_BUFFER_ACCESS_ORIGIN_HOST,
-      iree_make_byte_span(
-          (void*)dispatch_state->push_constants,
-          sizeof(uint32_t) * dispatch_state->push_constant_count),
-      iree_allocator_null(), &constants_buffer);
-  iree_vm_buffer_retain(&constants_buffer);  // for call
+  // The compiler does not generate code using scratchpad memory yet so the
+  // scratchpad is always empty.
+  // TODO(benvanik): pull the scratchpad size from an entry reflection attr and
+  // map it from the processor-local memory in the dispatch state.
+
+  // The callee takes ownership of the argument references.
+  iree_vm_buffer_retain(&cache->scratchpad_buffer);
+  iree_vm_buffer_retain(&cache->constants_buffer);
+  iree_vm_list_retain(cache->binding_list);
 
   // Prepare call argument buffer. We've verified the signature on creation and
   // know the exact format we can assume here.
@@ -273,19 +414,19 @@ static iree_status_t iree_hal_vmvx_executable_issue_call(
       .scratchpad =
           {
               .type = iree_vm_buffer_type_id(),
-              .ptr = &scratchpad_buffer,
+              .ptr = &cache->scratchpad_buffer,
               .offsetof_counter = 0,
           },
       .constants =
           {
               .type = iree_vm_buffer_type_id(),
-              .ptr = &constants_buffer,
+              .ptr = &cache->constants_buffer,
               .offsetof_counter = 0,
           },
       .bindings =
           {
               .type = iree_vm_list_type_id(),
-              .ptr = binding_list,
+              .ptr = cache->binding_list,
               .offsetof_counter = 0,
           },
       .workgroup_x = workgroup_id->x,
@@ -299,12 +440,6 @@ static iree_status_t iree_hal_vmvx_executable_issue_call(
       .workgroup_count_z = dispatch_state->workgroup_count.z,
   };
 
-  // On-stack stack. We really do abuse the stack too much here.
-  // TODO(benvanik): pass in an iree_arena_t that can be used for this.
-  IREE_VM_INLINE_STACK_INITIALIZE(
-      stack, iree_vm_context_state_resolver(executable->context),
-      executable->base.host_allocator);
-
   // Direct call interface.
   iree_vm_function_call_t call;
   memset(&call, 0, sizeof(call));
@@ -312,16 +447,17 @@ static iree_status_t iree_hal_vmvx_executable_issue_call(
   call.arguments = iree_make_byte_span(&call_args, sizeof(call_args));
   call.results = iree_make_byte_span(NULL, 0);
   iree_vm_execution_result_t result;
-  iree_status_t status =
-      entry_fn.module->begin_call(entry_fn.module->self, stack, &call, &result);
+  status = entry_fn.module->begin_call(entry_fn.module->self, cache->stack,
+                                       &call, &result);
 
-  iree_vm_stack_deinitialize(stack);
-
-  iree_vm_buffer_deinitialize(&scratchpad_buffer);
-  iree_vm_buffer_deinitialize(&constants_buffer);
-  iree_vm_list_deinitialize(binding_list);
-  for (iree_host_size_t i = 0; i < dispatch_state->binding_count; ++i) {
-    iree_vm_buffer_deinitialize(&binding_buffers[i]);
+  // Failed calls may leave frames on the stack so we drop the cache instead of
+  // trying to reset it.
+  if (iree_status_is_ok(status)) {
+    iree_hal_vmvx_executable_release_cache(
+        executable, dispatch_state->processor_id, cache);
+  } else {
+    iree_hal_vmvx_invocation_cache_free(cache,
+                                        executable->base.host_allocator);
   }
 
   IREE_TRACE_ZONE_END(z0);
@@ -367,8 +503,9 @@ iree_status_t iree_hal_vmvx_module_loader_create(
   iree_status_t status = iree_allocator_malloc(
       host_allocator, sizeof(*executable_loader), (void**)&executable_loader);
   if (iree_status_is_ok(status)) {
-    iree_hal_executable_loader_initialize(&iree_hal_vmvx_module_loader_vtable,
-                                          &executable_loader->base);
+    iree_hal_executable_loader_initialize(
+        &iree_hal_vmvx_module_loader_vtable,
+        iree_hal_executable_import_provider_null(), &executable_loader->base);
     executable_loader->host_allocator = host_allocator;
     executable_loader->instance = instance;
     iree_vm_instance_retain(executable_loader->instance);
@@ -20,6 +20,8 @@ void iree_hal_local_executable_initialize(
 
   out_base_executable->executable_layout_count = executable_layout_count;
   out_base_executable->executable_layouts = target_executable_layouts;
+  out_base_executable->dispatch_attrs = NULL;
+  out_base_executable->imports = NULL;
   for (iree_host_size_t i = 0; i < executable_layout_count; ++i) {
     target_executable_layouts[i] =
         (iree_hal_local_executable_layout_t*)source_executable_layouts[i];
@@ -34,6 +36,8 @@ void iree_hal_local_executable_deinitialize(
     iree_hal_executable_layout_release(
         (iree_hal_executable_layout_t*)base_executable->executable_layouts[i]);
   }
+  iree_allocator_free(base_executable->host_allocator,
+                      base_executable->imports);
 }
 
 iree_hal_local_executable_t* iree_hal_local_executable_cast(
@@ -41,6 +45,77 @@ iree_hal_local_executable_t* iree_hal_local_executable_cast(
   return (iree_hal_local_executable_t*)base_value;
 }
 
+iree_status_t iree_hal_local_executable_resolve_imports(
+    iree_hal_local_executable_t* executable,
+    const iree_hal_executable_import_table_v0_t* import_table,
+    iree_hal_executable_import_provider_t import_provider) {
+  IREE_ASSERT_ARGUMENT(executable);
+  IREE_ASSERT_ARGUMENT(import_table);
+  if (!import_table->count) return iree_ok_status();
+  IREE_TRACE_ZONE_BEGIN(z0);
+  IREE_TRACE_ZONE_APPEND_VALUE(z0, import_table->count);
+
+  iree_hal_executable_import_v0_t* imports = NULL;
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0, iree_allocator_malloc(executable->host_allocator,
+                                import_table->count * sizeof(*imports),
+                                (void**)&imports));
+
+  iree_status_t status = iree_ok_status();
+  for (uint32_t i = 0; i < import_table->count; ++i) {
+    // Optional imports are prefixed with `?` and may be left unresolved.
+    iree_string_view_t symbol_name =
+        iree_make_cstring_view(import_table->symbols[i]);
+    bool is_optional = iree_string_view_consume_prefix(
+        &symbol_name, iree_make_cstring_view("?"));
+    void* fn_ptr = NULL;
+    status = iree_hal_executable_import_provider_resolve(
+        import_provider, symbol_name, &fn_ptr);
+    if (is_optional && iree_status_is_not_found(status)) {
+      status = iree_status_ignore(status);
+      fn_ptr = NULL;
+    }
+    if (!iree_status_is_ok(status)) {
+      status = iree_status_annotate_f(
+          status, "resolving required executable import %u '%.*s'", i,
+          (int)symbol_name.size, symbol_name.data);
+      break;
+    }
+    imports[i] = (iree_hal_executable_import_v0_t)fn_ptr;
+  }
+
+  if (iree_status_is_ok(status)) {
+    iree_allocator_free(executable->host_allocator, executable->imports);
+    executable->imports = imports;
+  } else {
+    iree_allocator_free(executable->host_allocator, imports);
+  }
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
+iree_status_t iree_hal_local_executable_prepare(
+    iree_hal_local_executable_t* executable) {
+  IREE_ASSERT_ARGUMENT(executable);
+  const iree_hal_local_executable_vtable_t* vtable =
+      (const iree_hal_local_executable_vtable_t*)executable->resource.vtable;
+  if (!vtable->prepare) return iree_ok_status();
+  return vtable->prepare(executable);
+}
+
+iree_hal_vec3_t iree_hal_local_executable_workgroup_size(
+    iree_hal_local_executable_t* executable, iree_host_size_t ordinal) {
+  iree_hal_vec3_t workgroup_size = {{1, 1, 1}};
+  if (executable->dispatch_attrs) {
+    const iree_hal_vec3_t* declared_size =
+        &executable->dispatch_attrs[ordinal].workgroup_size;
+    if (declared_size->x && declared_size->y && declared_size->z) {
+      workgroup_size = *declared_size;
+    }
+  }
+  return workgroup_size;
+}
+
 iree_status_t iree_hal_local_executable_issue_call(
     iree_hal_local_executable_t* executable, iree_host_size_t ordinal,
     const iree_hal_executable_dispatch_state_v0_t* dispatch_state,
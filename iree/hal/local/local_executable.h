@@ -10,6 +10,7 @@
 #include "iree/base/api.h"
 #include "iree/hal/api.h"
 #include "iree/hal/local/executable_library.h"
+#include "iree/hal/local/executable_loader.h"
 #include "iree/hal/local/local_executable_layout.h"
 
 #ifdef __cplusplus
@@ -21,6 +22,12 @@ typedef struct iree_hal_local_executable_t {
   iree_allocator_t host_allocator;
   iree_host_size_t executable_layout_count;
   iree_hal_local_executable_layout_t** executable_layouts;
+  // Optional dispatch attributes 1:1 with the entry points of the executable.
+  // NULL if the executable does not provide them.
+  const iree_hal_executable_dispatch_attrs_v0_t* dispatch_attrs;
+  // Resolved import functions passed to each workgroup. NULL if the executable
+  // declares no imports.
+  iree_hal_executable_import_v0_t* imports;
 } iree_hal_local_executable_t;
 
 typedef struct iree_hal_local_executable_vtable_t {
@@ -30,6 +37,9 @@ typedef struct iree_hal_local_executable_vtable_t {
       iree_hal_local_executable_t* executable, iree_host_size_t ordinal,
       const iree_hal_executable_dispatch_state_v0_t* dispatch_state,
       const iree_hal_vec3_t* workgroup_id);
+
+  // Optional; NULL if the executable is always prepared upon creation.
+  iree_status_t(IREE_API_PTR* prepare)(iree_hal_local_executable_t* executable);
 } iree_hal_local_executable_vtable_t;
 
 // Callers must allocate memory for |target_executable_layouts| with at least
@@ -48,6 +58,27 @@ void iree_hal_local_executable_deinitialize(
 iree_hal_local_executable_t* iree_hal_local_executable_cast(
     iree_hal_executable_t* base_value);
 
+// Resolves the functions declared in |import_table| using |import_provider|
+// and retains them in |executable| for passing to each workgroup. Fails if any
+// required import is not provided.
+iree_status_t iree_hal_local_executable_resolve_imports(
+    iree_hal_local_executable_t* executable,
+    const iree_hal_executable_import_table_v0_t* import_table,
+    iree_hal_executable_import_provider_t import_provider);
+
+// Ensures that |executable| is prepared for execution, blocking the caller
+// until preparation completes if it was deferred. Must be called before
+// recording a dispatch of the executable: the |dispatch_attrs| and |imports|
+// of executables with deferred preparation are only valid afterward. Returns
+// any error encountered while preparing.
+iree_status_t iree_hal_local_executable_prepare(
+    iree_hal_local_executable_t* executable);
+
+// Returns the workgroup size declared by the entry point |ordinal| or 1x1x1 if
+// the executable does not declare one.
+iree_hal_vec3_t iree_hal_local_executable_workgroup_size(
+    iree_hal_local_executable_t* executable, iree_host_size_t ordinal);
+
 iree_status_t iree_hal_local_executable_issue_call(
     iree_hal_local_executable_t* executable, iree_host_size_t ordinal,
     const iree_hal_executable_dispatch_state_v0_t* dispatch_state,
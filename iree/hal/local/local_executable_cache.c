@@ -8,13 +8,383 @@
 
 #include <stdbool.h>
 #include <stddef.h>
+#include <string.h>
 
+#include "iree/base/internal/atomics.h"
+#include "iree/base/internal/synchronization.h"
 #include "iree/base/tracing.h"
+#include "iree/hal/local/local_executable.h"
+#include "iree/hal/local/local_executable_layout.h"
+
+//===----------------------------------------------------------------------===//
+// iree_hal_local_executable_cache_storage_t
+//===----------------------------------------------------------------------===//
+
+// Caching mode bits that do not change the executable that gets loaded.
+// All other bits must match for an executable to be shared.
+#define IREE_HAL_LOCAL_EXECUTABLE_CACHE_STORAGE_IGNORED_CACHING_MODES \
+  (IREE_HAL_EXECUTABLE_CACHING_MODE_ALIAS_PROVIDED_DATA |             \
+   IREE_HAL_EXECUTABLE_CACHING_MODE_ALLOW_PERSISTENT_CACHING |        \
+   IREE_HAL_EXECUTABLE_CACHING_MODE_ALLOW_DEFERRED_PREPARATION |      \
+   IREE_HAL_EXECUTABLE_CACHING_MODE_ALLOW_ASYNC_PREPARATION)
+
+// Caching mode bits that request per-load instrumentation. Executables
+// prepared with any of these are never shared.
+#define IREE_HAL_LOCAL_EXECUTABLE_CACHE_STORAGE_UNSHARED_CACHING_MODES \
+  (IREE_HAL_EXECUTABLE_CACHING_MODE_ENABLE_DEBUGGING |                 \
+   IREE_HAL_EXECUTABLE_CACHING_MODE_ENABLE_COVERAGE |                  \
+   IREE_HAL_EXECUTABLE_CACHING_MODE_ENABLE_PROFILING)
+
+// Identity of the contents an executable was loaded from and the loader that
+// loaded it.
+typedef struct iree_hal_local_executable_cache_key_t {
+  // Length of the executable data.
+  iree_host_size_t data_length;
+  // Hash of the format and all of the executable data. Matching entries are
+  // compared in full so collisions only cost a comparison.
+  uint64_t hash;
+  // Kind of the loader and the provider it resolves imports with. Imports are
+  // resolved when loading so executables are only shared between loaders that
+  // would resolve them to the same functions.
+  const iree_hal_executable_loader_vtable_t* loader_vtable;
+  iree_hal_executable_import_provider_t import_provider;
+} iree_hal_local_executable_cache_key_t;
+
+typedef struct iree_hal_local_executable_cache_entry_t {
+  struct iree_hal_local_executable_cache_entry_t* next;
+  iree_hal_local_executable_cache_key_t key;
+  // Caching mode with the IGNORED_CACHING_MODES bits cleared.
+  iree_hal_executable_caching_mode_t caching_mode;
+  // Stored in the trailing allocation of the entry.
+  iree_string_view_t executable_format;
+  // Copy of the executable data compared against on lookup. Stored in the
+  // trailing allocation of the entry.
+  iree_const_byte_span_t executable_data;
+  // Shared executable; retained.
+  iree_hal_executable_t* executable;
+} iree_hal_local_executable_cache_entry_t;
+
+struct iree_hal_local_executable_cache_storage_t {
+  iree_atomic_ref_count_t ref_count;
+  iree_allocator_t host_allocator;
+  iree_host_size_t capacity;
+
+  // Guards the entry list. Not held while loading executables.
+  iree_slim_mutex_t mutex;
+  // Entries in most-recently-used order.
+  iree_hal_local_executable_cache_entry_t* entry_head IREE_GUARDED_BY(mutex);
+  iree_host_size_t entry_count IREE_GUARDED_BY(mutex);
+};
+
+// 64-bit FNV-1a hash of |data| continuing from |hash|.
+static uint64_t iree_hal_local_executable_cache_hash(uint64_t hash,
+                                                     const uint8_t* data,
+                                                     iree_host_size_t length) {
+  for (iree_host_size_t i = 0; i < length; ++i) {
+    hash ^= data[i];
+    hash *= 0x100000001B3ull;
+  }
+  return hash;
+}
+
+// Sets the loader identity of |key| to that of |executable_loader|.
+static void iree_hal_local_executable_cache_key_set_loader(
+    iree_hal_executable_loader_t* executable_loader,
+    iree_hal_local_executable_cache_key_t* key) {
+  key->loader_vtable = executable_loader ? executable_loader->vtable : NULL;
+  key->import_provider = executable_loader
+                             ? executable_loader->import_provider
+                             : iree_hal_executable_import_provider_null();
+}
+
+// Computes the storage key of |executable_spec| loaded by |executable_loader|
+// by hashing all of its data.
+static iree_hal_local_executable_cache_key_t
+iree_hal_local_executable_cache_make_key(
+    iree_hal_executable_loader_t* executable_loader,
+    const iree_hal_executable_spec_t* executable_spec) {
+  IREE_TRACE_ZONE_BEGIN(z0);
+  IREE_TRACE_ZONE_APPEND_VALUE(z0,
+                               executable_spec->executable_data.data_length);
+  uint64_t hash = 0xCBF29CE484222325ull;
+  hash = iree_hal_local_executable_cache_hash(
+      hash, (const uint8_t*)executable_spec->executable_format.data,
+      executable_spec->executable_format.size);
+  hash = iree_hal_local_executable_cache_hash(
+      hash, executable_spec->executable_data.data,
+      executable_spec->executable_data.data_length);
+  iree_hal_local_executable_cache_key_t key = {
+      .data_length = executable_spec->executable_data.data_length,
+      .hash = hash,
+  };
+  iree_hal_local_executable_cache_key_set_loader(executable_loader, &key);
+  IREE_TRACE_ZONE_END(z0);
+  return key;
+}
+
+static void iree_hal_local_executable_cache_entry_free(
+    iree_allocator_t host_allocator,
+    iree_hal_local_executable_cache_entry_t* entry) {
+  iree_hal_executable_release(entry->executable);
+  iree_allocator_free(host_allocator, entry);
+}
+
+iree_status_t iree_hal_local_executable_cache_storage_create(
+    iree_host_size_t capacity, iree_allocator_t host_allocator,
+    iree_hal_local_executable_cache_storage_t** out_storage) {
+  IREE_ASSERT_ARGUMENT(out_storage);
+  *out_storage = NULL;
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  iree_hal_local_executable_cache_storage_t* storage = NULL;
+  iree_status_t status = iree_allocator_malloc(
+      host_allocator, sizeof(*storage), (void**)&storage);
+  if (iree_status_is_ok(status)) {
+    memset(storage, 0, sizeof(*storage));
+    iree_atomic_ref_count_init(&storage->ref_count);
+    storage->host_allocator = host_allocator;
+    storage->capacity = capacity;
+    iree_slim_mutex_initialize(&storage->mutex);
+    *out_storage = storage;
+  }
+
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
+static void iree_hal_local_executable_cache_storage_destroy(
+    iree_hal_local_executable_cache_storage_t* storage) {
+  iree_allocator_t host_allocator = storage->host_allocator;
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  iree_hal_local_executable_cache_storage_trim(storage);
+  iree_slim_mutex_deinitialize(&storage->mutex);
+  iree_allocator_free(host_allocator, storage);
+
+  IREE_TRACE_ZONE_END(z0);
+}
+
+void iree_hal_local_executable_cache_storage_retain(
+    iree_hal_local_executable_cache_storage_t* storage) {
+  if (IREE_LIKELY(storage)) {
+    iree_atomic_ref_count_inc(&storage->ref_count);
+  }
+}
+
+void iree_hal_local_executable_cache_storage_release(
+    iree_hal_local_executable_cache_storage_t* storage) {
+  if (IREE_LIKELY(storage) &&
+      iree_atomic_ref_count_dec(&storage->ref_count) == 1) {
+    iree_hal_local_executable_cache_storage_destroy(storage);
+  }
+}
+
+void iree_hal_local_executable_cache_storage_trim(
+    iree_hal_local_executable_cache_storage_t* storage) {
+  IREE_ASSERT_ARGUMENT(storage);
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  // Detach the list under the lock and release outside of it as releasing the
+  // executables may be expensive (unmapping/unloading/etc).
+  iree_slim_mutex_lock(&storage->mutex);
+  iree_hal_local_executable_cache_entry_t* entry = storage->entry_head;
+  storage->entry_head = NULL;
+  storage->entry_count = 0;
+  iree_slim_mutex_unlock(&storage->mutex);
+
+  while (entry) {
+    iree_hal_local_executable_cache_entry_t* next = entry->next;
+    iree_hal_local_executable_cache_entry_free(storage->host_allocator, entry);
+    entry = next;
+  }
+
+  IREE_TRACE_ZONE_END(z0);
+}
+
+// Returns true if |executable_spec| is allowed to be shared via storage.
+static bool iree_hal_local_executable_cache_storage_is_shareable(
+    const iree_hal_executable_spec_t* executable_spec) {
+  return iree_all_bits_set(
+             executable_spec->caching_mode,
+             IREE_HAL_EXECUTABLE_CACHING_MODE_ALLOW_PERSISTENT_CACHING) &&
+         !iree_any_bit_set(
+             executable_spec->caching_mode,
+             IREE_HAL_LOCAL_EXECUTABLE_CACHE_STORAGE_UNSHARED_CACHING_MODES);
+}
+
+// Returns true if the |entry| holds an executable loaded from the same
+// contents as |executable_spec| with a compatible set of layouts.
+static bool iree_hal_local_executable_cache_entry_matches(
+    const iree_hal_local_executable_cache_entry_t* entry,
+    const iree_hal_local_executable_cache_key_t* key,
+    const iree_hal_executable_spec_t* executable_spec) {
+  if (entry->key.data_length != key->data_length ||
+      entry->key.hash != key->hash ||
+      entry->key.loader_vtable != key->loader_vtable ||
+      entry->key.import_provider.self != key->import_provider.self ||
+      entry->key.import_provider.resolve != key->import_provider.resolve) {
+    return false;
+  }
+  if (entry->caching_mode !=
+      (executable_spec->caching_mode &
+       ~IREE_HAL_LOCAL_EXECUTABLE_CACHE_STORAGE_IGNORED_CACHING_MODES)) {
+    return false;
+  }
+  if (!iree_string_view_equal(entry->executable_format,
+                              executable_spec->executable_format)) {
+    return false;
+  }
+  if (memcmp(entry->executable_data.data,
+             executable_spec->executable_data.data,
+             entry->executable_data.data_length) != 0) {
+    return false;
+  }
+  iree_hal_local_executable_t* local_executable =
+      iree_hal_local_executable_cast(entry->executable);
+  if (local_executable->executable_layout_count !=
+      executable_spec->executable_layout_count) {
+    return false;
+  }
+  for (iree_host_size_t i = 0; i < executable_spec->executable_layout_count;
+       ++i) {
+    if (!iree_hal_local_executable_layout_is_compatible(
+            (iree_hal_executable_layout_t*)
+                local_executable->executable_layouts[i],
+            executable_spec->executable_layouts[i])) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// Looks up an executable matching |executable_spec| and returns it retained in
+// |out_executable|, or NULL if not found. Hits are moved to the front of the
+// list.
+static void iree_hal_local_executable_cache_storage_lookup(
+    iree_hal_local_executable_cache_storage_t* storage,
+    const iree_hal_local_executable_cache_key_t* key,
+    const iree_hal_executable_spec_t* executable_spec,
+    iree_hal_executable_t** out_executable) {
+  *out_executable = NULL;
+  iree_slim_mutex_lock(&storage->mutex);
+  iree_hal_local_executable_cache_entry_t* prev = NULL;
+  iree_hal_local_executable_cache_entry_t* entry = storage->entry_head;
+  while (entry) {
+    if (iree_hal_local_executable_cache_entry_matches(entry, key,
+                                                      executable_spec)) {
+      if (prev) {
+        prev->next = entry->next;
+        entry->next = storage->entry_head;
+        storage->entry_head = entry;
+      }
+      iree_hal_executable_retain(entry->executable);
+      *out_executable = entry->executable;
+      break;
+    }
+    prev = entry;
+    entry = entry->next;
+  }
+  iree_slim_mutex_unlock(&storage->mutex);
+}
+
+// Inserts |executable| loaded from |executable_spec| into the |storage|.
+// If another thread inserted a matching executable while this one was loading
+// then that executable is returned retained in |out_executable| instead so that
+// all users share the same one.
+static iree_status_t iree_hal_local_executable_cache_storage_insert(
+    iree_hal_local_executable_cache_storage_t* storage,
+    const iree_hal_local_executable_cache_key_t* key,
+    const iree_hal_executable_spec_t* executable_spec,
+    iree_hal_executable_t* executable, iree_hal_executable_t** out_executable) {
+  *out_executable = NULL;
+
+  iree_hal_local_executable_cache_entry_t* entry = NULL;
+  iree_host_size_t total_size = sizeof(*entry) +
+                                executable_spec->executable_format.size +
+                                executable_spec->executable_data.data_length;
+  IREE_RETURN_IF_ERROR(iree_allocator_malloc(storage->host_allocator,
+                                             total_size, (void**)&entry));
+  entry->next = NULL;
+  entry->key = *key;
+  entry->caching_mode =
+      executable_spec->caching_mode &
+      ~IREE_HAL_LOCAL_EXECUTABLE_CACHE_STORAGE_IGNORED_CACHING_MODES;
+  uint8_t* entry_data = (uint8_t*)entry + sizeof(*entry);
+  iree_string_view_append_to_buffer(executable_spec->executable_format,
+                                    &entry->executable_format,
+                                    (char*)entry_data);
+  entry_data += executable_spec->executable_format.size;
+  memcpy(entry_data, executable_spec->executable_data.data,
+         executable_spec->executable_data.data_length);
+  entry->executable_data = iree_make_const_byte_span(
+      entry_data, executable_spec->executable_data.data_length);
+  entry->executable = executable;
+  iree_hal_executable_retain(executable);
+
+  iree_hal_local_executable_cache_entry_t* evicted_entry = NULL;
+  iree_slim_mutex_lock(&storage->mutex);
+  iree_hal_local_executable_cache_entry_t* prev = NULL;
+  iree_hal_local_executable_cache_entry_t* existing = storage->entry_head;
+  while (existing) {
+    if (iree_hal_local_executable_cache_entry_matches(existing, key,
+                                                      executable_spec)) {
+      break;
+    }
+    prev = existing;
+    existing = existing->next;
+  }
+  if (existing) {
+    // Lost the race; use the existing executable and drop ours.
+    iree_hal_executable_retain(existing->executable);
+    *out_executable = existing->executable;
+    evicted_entry = entry;
+  } else {
+    entry->next = storage->entry_head;
+    storage->entry_head = entry;
+    ++storage->entry_count;
+    iree_hal_executable_retain(executable);
+    *out_executable = executable;
+    if (storage->entry_count > storage->capacity) {
+      // Evict the least recently used entry (the tail).
+      prev = NULL;
+      evicted_entry = storage->entry_head;
+      while (evicted_entry->next) {
+        prev = evicted_entry;
+        evicted_entry = evicted_entry->next;
+      }
+      prev->next = NULL;
+      --storage->entry_count;
+    }
+  }
+  iree_slim_mutex_unlock(&storage->mutex);
+
+  if (evicted_entry) {
+    iree_hal_local_executable_cache_entry_free(storage->host_allocator,
+                                               evicted_entry);
+  }
+  return iree_ok_status();
+}
+
+//===----------------------------------------------------------------------===//
+// iree_hal_local_executable_cache_t
+//===----------------------------------------------------------------------===//
+
+// Caching mode bits that allow an executable to be returned before it has been
+// prepared.
+#define IREE_HAL_LOCAL_EXECUTABLE_CACHE_DEFERRED_CACHING_MODES     \
+  (IREE_HAL_EXECUTABLE_CACHING_MODE_ALLOW_DEFERRED_PREPARATION | \
+   IREE_HAL_EXECUTABLE_CACHING_MODE_ALLOW_ASYNC_PREPARATION)
 
 typedef struct iree_hal_local_executable_cache_t {
   iree_hal_resource_t resource;
   iree_allocator_t host_allocator;
   iree_string_view_t identifier;
+  // Optional storage shared with other caches; retained.
+  iree_hal_local_executable_cache_storage_t* storage;
+  // Caching mode bits added to all executable specs.
+  iree_hal_executable_caching_mode_t default_caching_mode;
+  // Optional scheduler for asynchronous preparation; NULL schedule if absent.
+  iree_hal_local_executable_cache_scheduler_t scheduler;
   iree_host_size_t loader_count;
   iree_hal_executable_loader_t* loaders[];
 } iree_hal_local_executable_cache_t;
@@ -29,8 +399,12 @@ static iree_hal_local_executable_cache_t* iree_hal_local_executable_cache_cast(
 }
 
 iree_status_t iree_hal_local_executable_cache_create(
-    iree_string_view_t identifier, iree_host_size_t loader_count,
-    iree_hal_executable_loader_t** loaders, iree_allocator_t host_allocator,
+    iree_string_view_t identifier,
+    iree_hal_local_executable_cache_storage_t* storage,
+    iree_hal_executable_caching_mode_t default_caching_mode,
+    const iree_hal_local_executable_cache_scheduler_t* scheduler,
+    iree_host_size_t loader_count, iree_hal_executable_loader_t** loaders,
+    iree_allocator_t host_allocator,
     iree_hal_executable_cache_t** out_executable_cache) {
   IREE_ASSERT_ARGUMENT(!loader_count || loaders);
   IREE_ASSERT_ARGUMENT(out_executable_cache);
@@ -52,6 +426,17 @@ iree_status_t iree_hal_local_executable_cache_create(
         identifier, &executable_cache->identifier,
         (char*)executable_cache + total_size - identifier.size);
 
+    executable_cache->storage = storage;
+    iree_hal_local_executable_cache_storage_retain(storage);
+
+    executable_cache->default_caching_mode = default_caching_mode;
+    if (scheduler) {
+      executable_cache->scheduler = *scheduler;
+    } else {
+      memset(&executable_cache->scheduler, 0,
+             sizeof(executable_cache->scheduler));
+    }
+
     executable_cache->loader_count = loader_count;
     for (iree_host_size_t i = 0; i < executable_cache->loader_count; ++i) {
       executable_cache->loaders[i] = loaders[i];
@@ -75,6 +460,7 @@ static void iree_hal_local_executable_cache_destroy(
   for (iree_host_size_t i = 0; i < executable_cache->loader_count; ++i) {
     iree_hal_executable_loader_release(executable_cache->loaders[i]);
   }
+  iree_hal_local_executable_cache_storage_release(executable_cache->storage);
   iree_allocator_free(host_allocator, executable_cache);
 
   IREE_TRACE_ZONE_END(z0);
@@ -95,12 +481,43 @@ static bool iree_hal_local_executable_cache_can_prepare_format(
   return false;
 }
 
-static iree_status_t iree_hal_local_executable_cache_prepare_executable(
-    iree_hal_executable_cache_t* base_executable_cache,
+// Returns the first loader that supports the format of |executable_spec| or
+// NULL if none do.
+static iree_hal_executable_loader_t*
+iree_hal_local_executable_cache_select_loader(
+    iree_hal_local_executable_cache_t* executable_cache,
+    const iree_hal_executable_spec_t* executable_spec) {
+  for (iree_host_size_t i = 0; i < executable_cache->loader_count; ++i) {
+    if (iree_hal_executable_loader_query_support(
+            executable_cache->loaders[i], executable_spec->caching_mode,
+            executable_spec->executable_format)) {
+      return executable_cache->loaders[i];
+    }
+  }
+  return NULL;
+}
+
+// Returns the caching mode bits requested by the executable itself as reported
+// by the first loader that supports its format.
+static iree_hal_executable_caching_mode_t
+iree_hal_local_executable_cache_query_caching_mode(
+    iree_hal_local_executable_cache_t* executable_cache,
+    const iree_hal_executable_spec_t* executable_spec) {
+  iree_hal_executable_loader_t* executable_loader =
+      iree_hal_local_executable_cache_select_loader(executable_cache,
+                                                    executable_spec);
+  return executable_loader ? iree_hal_executable_loader_query_caching_mode(
+                                 executable_loader, executable_spec)
+                           : 0;
+}
+
+// Loads the executable with the first loader that supports it and returns the
+// loader used in |out_executable_loader| if provided.
+static iree_status_t iree_hal_local_executable_cache_load_executable(
+    iree_hal_local_executable_cache_t* executable_cache,
     const iree_hal_executable_spec_t* executable_spec,
-    iree_hal_executable_t** out_executable) {
-  iree_hal_local_executable_cache_t* executable_cache =
-      iree_hal_local_executable_cache_cast(base_executable_cache);
+    iree_hal_executable_t** out_executable,
+    iree_hal_executable_loader_t** out_executable_loader) {
   for (iree_host_size_t i = 0; i < executable_cache->loader_count; ++i) {
     if (!iree_hal_executable_loader_query_support(
             executable_cache->loaders[i], executable_spec->caching_mode,
@@ -115,6 +532,9 @@ static iree_status_t iree_hal_local_executable_cache_prepare_executable(
         executable_cache->loaders[i], executable_spec, out_executable);
     if (iree_status_is_ok(status)) {
       // Executable was successfully loaded.
+      if (out_executable_loader) {
+        *out_executable_loader = executable_cache->loaders[i];
+      }
       return status;
     } else if (!iree_status_is_cancelled(status)) {
       // Error beyond just the try failing due to unsupported formats.
@@ -129,6 +549,397 @@ static iree_status_t iree_hal_local_executable_cache_prepare_executable(
       executable_spec->executable_format.data);
 }
 
+// Returns true if |executable_spec| is shared via the storage of
+// |executable_cache| and needs a storage key.
+static bool iree_hal_local_executable_cache_uses_storage(
+    iree_hal_local_executable_cache_t* executable_cache,
+    const iree_hal_executable_spec_t* executable_spec) {
+  return executable_cache->storage && executable_cache->storage->capacity &&
+         iree_hal_local_executable_cache_storage_is_shareable(executable_spec);
+}
+
+// Prepares the executable immediately, sharing it via the cache storage if
+// possible. |key| is the storage key of |executable_spec| and is only used if
+// the spec uses the storage.
+static iree_status_t iree_hal_local_executable_cache_prepare_immediately(
+    iree_hal_local_executable_cache_t* executable_cache,
+    const iree_hal_local_executable_cache_key_t* key,
+    const iree_hal_executable_spec_t* executable_spec,
+    iree_hal_executable_t** out_executable) {
+  *out_executable = NULL;
+
+  iree_hal_local_executable_cache_storage_t* storage =
+      executable_cache->storage;
+  if (!iree_hal_local_executable_cache_uses_storage(executable_cache,
+                                                    executable_spec)) {
+    return iree_hal_local_executable_cache_load_executable(
+        executable_cache, executable_spec, out_executable,
+        /*out_executable_loader=*/NULL);
+  }
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  // Fast path: an executable has already been loaded from the same data.
+  iree_hal_local_executable_cache_storage_lookup(storage, key, executable_spec,
+                                                 out_executable);
+  if (*out_executable) {
+    IREE_TRACE_ZONE_APPEND_TEXT_CSTRING(z0, "hit");
+    IREE_TRACE_ZONE_END(z0);
+    return iree_ok_status();
+  }
+  IREE_TRACE_ZONE_APPEND_TEXT_CSTRING(z0, "miss");
+
+  // Load without aliasing the provided data as the executable may outlive the
+  // module that is loading it.
+  iree_hal_executable_spec_t shared_spec = *executable_spec;
+  shared_spec.caching_mode &=
+      ~IREE_HAL_EXECUTABLE_CACHING_MODE_ALIAS_PROVIDED_DATA;
+  iree_hal_executable_t* executable = NULL;
+  iree_hal_executable_loader_t* executable_loader = NULL;
+  iree_status_t status = iree_hal_local_executable_cache_load_executable(
+      executable_cache, &shared_spec, &executable, &executable_loader);
+  if (iree_status_is_ok(status)) {
+    // The first supporting loader may have declined the executable and left it
+    // to a later one; the entry must record the loader actually used.
+    iree_hal_local_executable_cache_key_t loaded_key = *key;
+    iree_hal_local_executable_cache_key_set_loader(executable_loader,
+                                                   &loaded_key);
+    status = iree_hal_local_executable_cache_storage_insert(
+        storage, &loaded_key, executable_spec, executable, out_executable);
+  }
+  iree_hal_executable_release(executable);
+
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
+//===----------------------------------------------------------------------===//
+// iree_hal_local_deferred_executable_t
+//===----------------------------------------------------------------------===//
+
+typedef enum iree_hal_local_deferred_executable_state_e {
+  // Preparation has not started.
+  IREE_HAL_LOCAL_DEFERRED_EXECUTABLE_STATE_PENDING = 0,
+  // A thread is preparing the executable; others must wait.
+  IREE_HAL_LOCAL_DEFERRED_EXECUTABLE_STATE_PREPARING = 1,
+  // The executable was prepared and |executable| is valid.
+  IREE_HAL_LOCAL_DEFERRED_EXECUTABLE_STATE_READY = 2,
+  // Preparation failed and |status| holds the error.
+  IREE_HAL_LOCAL_DEFERRED_EXECUTABLE_STATE_FAILED = 3,
+} iree_hal_local_deferred_executable_state_t;
+
+// An executable returned from the cache before it has been prepared.
+// Preparation happens either when the first dispatch using the executable is
+// recorded or asynchronously via the cache scheduler, whichever comes first.
+// Once prepared the dispatch attributes and imports of the prepared executable
+// are exposed on the deferred executable and all calls are forwarded to it.
+//
+// The executable layouts are retained up front so that command buffers can
+// use them without requiring preparation to have completed.
+typedef struct iree_hal_local_deferred_executable_t {
+  iree_hal_local_executable_t base;
+  // Cache used to prepare the executable; retained.
+  iree_hal_local_executable_cache_t* executable_cache;
+  // Spec used to prepare the executable with the deferral bits cleared.
+  // The format and data are only valid until preparation completes.
+  iree_hal_executable_spec_t spec;
+  // Copy of the executable data if the caller did not allow aliasing it.
+  void* owned_data;
+  // Storage key computed when the executable was created so that the data is
+  // only hashed once.
+  iree_hal_local_executable_cache_key_t key;
+
+  // iree_hal_local_deferred_executable_state_t.
+  iree_atomic_int32_t state;
+  // Posted when preparation completes (successfully or otherwise).
+  iree_notification_t notification;
+  // Prepared executable when READY.
+  iree_hal_executable_t* executable;
+  // Preparation failure when FAILED.
+  iree_status_t status;
+
+  iree_hal_local_executable_layout_t* executable_layouts[];
+} iree_hal_local_deferred_executable_t;
+
+static const iree_hal_local_executable_vtable_t
+    iree_hal_local_deferred_executable_vtable;
+
+static iree_status_t iree_hal_local_deferred_executable_create(
+    iree_hal_local_executable_cache_t* executable_cache,
+    const iree_hal_local_executable_cache_key_t* key,
+    const iree_hal_executable_spec_t* executable_spec,
+    iree_hal_local_deferred_executable_t** out_executable) {
+  *out_executable = NULL;
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  bool copy_data = !iree_all_bits_set(
+      executable_spec->caching_mode,
+      IREE_HAL_EXECUTABLE_CACHING_MODE_ALIAS_PROVIDED_DATA);
+
+  iree_hal_local_deferred_executable_t* executable = NULL;
+  iree_host_size_t total_size =
+      sizeof(*executable) +
+      executable_spec->executable_layout_count *
+          sizeof(*executable->executable_layouts) +
+      executable_spec->executable_format.size;
+  iree_status_t status = iree_allocator_malloc(
+      executable_cache->host_allocator, total_size, (void**)&executable);
+  if (iree_status_is_ok(status)) {
+    executable->owned_data = NULL;
+    if (copy_data) {
+      // NOTE: allocated separately so that the data has the natural alignment
+      // of the allocator as loaders may access headers in-place.
+      status = iree_allocator_clone(executable_cache->host_allocator,
+                                    executable_spec->executable_data,
+                                    &executable->owned_data);
+    }
+  }
+  if (iree_status_is_ok(status)) {
+    iree_hal_local_executable_initialize(
+        &iree_hal_local_deferred_executable_vtable,
+        executable_spec->executable_layout_count,
+        executable_spec->executable_layouts, executable->executable_layouts,
+        executable_cache->host_allocator, &executable->base);
+    executable->executable_cache = executable_cache;
+    iree_hal_executable_cache_retain(
+        (iree_hal_executable_cache_t*)executable_cache);
+
+    executable->key = *key;
+    executable->spec = *executable_spec;
+    executable->spec.caching_mode &=
+        ~IREE_HAL_LOCAL_EXECUTABLE_CACHE_DEFERRED_CACHING_MODES;
+    iree_string_view_append_to_buffer(
+        executable_spec->executable_format, &executable->spec.executable_format,
+        (char*)executable + total_size -
+            executable_spec->executable_format.size);
+    if (copy_data) {
+      executable->spec.executable_data = iree_make_const_byte_span(
+          executable->owned_data, executable_spec->executable_data.data_length);
+    }
+    executable->spec.executable_layouts =
+        (iree_hal_executable_layout_t* const*)executable->executable_layouts;
+
+    iree_atomic_store_int32(&executable->state,
+                            IREE_HAL_LOCAL_DEFERRED_EXECUTABLE_STATE_PENDING,
+                            iree_memory_order_release);
+    iree_notification_initialize(&executable->notification);
+    executable->executable = NULL;
+    executable->status = iree_ok_status();
+    *out_executable = executable;
+  } else if (executable) {
+    iree_allocator_free(executable_cache->host_allocator, executable);
+  }
+
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
+static void iree_hal_local_deferred_executable_destroy(
+    iree_hal_executable_t* base_executable) {
+  iree_hal_local_deferred_executable_t* executable =
+      (iree_hal_local_deferred_executable_t*)base_executable;
+  iree_allocator_t host_allocator = executable->base.host_allocator;
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  // The imports are owned by the prepared executable.
+  executable->base.imports = NULL;
+  iree_hal_executable_release(executable->executable);
+  iree_status_ignore(executable->status);
+  iree_allocator_free(host_allocator, executable->owned_data);
+  iree_notification_deinitialize(&executable->notification);
+  iree_hal_executable_cache_release(
+      (iree_hal_executable_cache_t*)executable->executable_cache);
+  iree_hal_local_executable_deinitialize(
+      (iree_hal_local_executable_t*)base_executable);
+  iree_allocator_free(host_allocator, executable);
+
+  IREE_TRACE_ZONE_END(z0);
+}
+
+static bool iree_hal_local_deferred_executable_is_prepared(void* arg) {
+  iree_hal_local_deferred_executable_t* executable =
+      (iree_hal_local_deferred_executable_t*)arg;
+  return iree_atomic_load_int32(&executable->state,
+                                iree_memory_order_acquire) >=
+         IREE_HAL_LOCAL_DEFERRED_EXECUTABLE_STATE_READY;
+}
+
+// Prepares the executable if it has not yet been prepared, waiting for any
+// other thread that is currently preparing it. Returns the preparation status.
+static iree_status_t iree_hal_local_deferred_executable_prepare(
+    iree_hal_local_deferred_executable_t* executable) {
+  int32_t state = IREE_HAL_LOCAL_DEFERRED_EXECUTABLE_STATE_PENDING;
+  if (iree_atomic_compare_exchange_strong_int32(
+          &executable->state, &state,
+          IREE_HAL_LOCAL_DEFERRED_EXECUTABLE_STATE_PREPARING,
+          iree_memory_order_acq_rel, iree_memory_order_acquire)) {
+    // We won the race and are responsible for preparing the executable.
+    IREE_TRACE_ZONE_BEGIN(z0);
+    iree_status_t status = iree_hal_local_executable_cache_prepare_immediately(
+        executable->executable_cache, &executable->key, &executable->spec,
+        &executable->executable);
+    if (iree_status_is_ok(status)) {
+      // Expose the metadata of the prepared executable to command buffers.
+      // Both remain valid for as long as the prepared executable is retained.
+      iree_hal_local_executable_t* target_executable =
+          iree_hal_local_executable_cast(executable->executable);
+      executable->base.dispatch_attrs = target_executable->dispatch_attrs;
+      executable->base.imports = target_executable->imports;
+      state = IREE_HAL_LOCAL_DEFERRED_EXECUTABLE_STATE_READY;
+    } else {
+      executable->status = status;
+      state = IREE_HAL_LOCAL_DEFERRED_EXECUTABLE_STATE_FAILED;
+    }
+    // The data is no longer needed; if the loader required it then it made its
+    // own copy as aliasing was not allowed.
+    iree_allocator_free(executable->base.host_allocator,
+                        executable->owned_data);
+    executable->owned_data = NULL;
+    executable->spec.executable_data = iree_make_const_byte_span(NULL, 0);
+    iree_atomic_store_int32(&executable->state, state,
+                            iree_memory_order_release);
+    iree_notification_post(&executable->notification, IREE_ALL_WAITERS);
+    IREE_TRACE_ZONE_END(z0);
+  } else if (state == IREE_HAL_LOCAL_DEFERRED_EXECUTABLE_STATE_PREPARING) {
+    iree_notification_await(&executable->notification,
+                            iree_hal_local_deferred_executable_is_prepared,
+                            executable);
+    state = iree_atomic_load_int32(&executable->state,
+                                   iree_memory_order_acquire);
+  }
+  return state == IREE_HAL_LOCAL_DEFERRED_EXECUTABLE_STATE_READY
+             ? iree_ok_status()
+             : iree_status_clone(executable->status);
+}
+
+static void iree_hal_local_deferred_executable_prepare_async(void* user_data,
+                                                             bool cancelled) {
+  iree_hal_local_deferred_executable_t* executable =
+      (iree_hal_local_deferred_executable_t*)user_data;
+  if (!cancelled) {
+    // Errors are reported when the executable is first used.
+    iree_status_ignore(iree_hal_local_deferred_executable_prepare(executable));
+  }
+  iree_hal_executable_release((iree_hal_executable_t*)executable);
+}
+
+static iree_status_t iree_hal_local_deferred_executable_prepare_for_dispatch(
+    iree_hal_local_executable_t* base_executable) {
+  iree_hal_local_deferred_executable_t* executable =
+      (iree_hal_local_deferred_executable_t*)base_executable;
+  if (IREE_LIKELY(iree_atomic_load_int32(&executable->state,
+                                         iree_memory_order_acquire) ==
+                  IREE_HAL_LOCAL_DEFERRED_EXECUTABLE_STATE_READY)) {
+    return iree_ok_status();
+  }
+  return iree_hal_local_deferred_executable_prepare(executable);
+}
+
+static iree_status_t iree_hal_local_deferred_executable_issue_call(
+    iree_hal_local_executable_t* base_executable, iree_host_size_t ordinal,
+    const iree_hal_executable_dispatch_state_v0_t* dispatch_state,
+    const iree_hal_vec3_t* workgroup_id) {
+  iree_hal_local_deferred_executable_t* executable =
+      (iree_hal_local_deferred_executable_t*)base_executable;
+  // Command buffers prepare executables when recording dispatches so by the
+  // time a workgroup runs the executable must be ready.
+  if (IREE_UNLIKELY(iree_atomic_load_int32(&executable->state,
+                                           iree_memory_order_acquire) !=
+                    IREE_HAL_LOCAL_DEFERRED_EXECUTABLE_STATE_READY)) {
+    return iree_make_status(IREE_STATUS_FAILED_PRECONDITION,
+                            "executable dispatched before being prepared");
+  }
+  return iree_hal_local_executable_issue_call(
+      iree_hal_local_executable_cast(executable->executable), ordinal,
+      dispatch_state, workgroup_id);
+}
+
+static const iree_hal_local_executable_vtable_t
+    iree_hal_local_deferred_executable_vtable = {
+        .base =
+            {
+                .destroy = iree_hal_local_deferred_executable_destroy,
+            },
+        .issue_call = iree_hal_local_deferred_executable_issue_call,
+        .prepare = iree_hal_local_deferred_executable_prepare_for_dispatch,
+};
+
+//===----------------------------------------------------------------------===//
+// iree_hal_executable_cache_t implementation
+//===----------------------------------------------------------------------===//
+
+static iree_status_t iree_hal_local_executable_cache_prepare_executable(
+    iree_hal_executable_cache_t* base_executable_cache,
+    const iree_hal_executable_spec_t* executable_spec,
+    iree_hal_executable_t** out_executable) {
+  iree_hal_local_executable_cache_t* executable_cache =
+      iree_hal_local_executable_cache_cast(base_executable_cache);
+  *out_executable = NULL;
+
+  // Executables compiled with a preparation hint may request deferral even if
+  // the host did not opt in for all executables.
+  iree_hal_executable_spec_t spec = *executable_spec;
+  spec.caching_mode |= executable_cache->default_caching_mode;
+  spec.caching_mode |=
+      iree_hal_local_executable_cache_query_caching_mode(executable_cache,
+                                                         &spec) &
+      IREE_HAL_LOCAL_EXECUTABLE_CACHE_DEFERRED_CACHING_MODES;
+  iree_hal_local_executable_cache_key_t key = {0};
+  bool uses_storage =
+      iree_hal_local_executable_cache_uses_storage(executable_cache, &spec);
+  if (uses_storage) {
+    key = iree_hal_local_executable_cache_make_key(
+        iree_hal_local_executable_cache_select_loader(executable_cache, &spec),
+        &spec);
+  }
+  if (!iree_any_bit_set(
+          spec.caching_mode,
+          IREE_HAL_LOCAL_EXECUTABLE_CACHE_DEFERRED_CACHING_MODES)) {
+    return iree_hal_local_executable_cache_prepare_immediately(
+        executable_cache, &key, &spec, out_executable);
+  }
+
+  // Unsupported formats are reported immediately as there is no chance the
+  // executable could ever be prepared.
+  if (!iree_hal_local_executable_cache_can_prepare_format(
+          base_executable_cache, spec.caching_mode, spec.executable_format)) {
+    return iree_make_status(
+        IREE_STATUS_NOT_FOUND,
+        "no executable loader registered for the given executable format "
+        "'%.*s'",
+        (int)spec.executable_format.size, spec.executable_format.data);
+  }
+
+  // Executables already present in the shared storage are ready to use.
+  if (uses_storage) {
+    iree_hal_local_executable_cache_storage_lookup(
+        executable_cache->storage, &key, &spec, out_executable);
+    if (*out_executable) return iree_ok_status();
+  }
+
+  iree_hal_local_deferred_executable_t* executable = NULL;
+  IREE_RETURN_IF_ERROR(iree_hal_local_deferred_executable_create(
+      executable_cache, &key, &spec, &executable));
+
+  if (iree_all_bits_set(
+          spec.caching_mode,
+          IREE_HAL_EXECUTABLE_CACHING_MODE_ALLOW_ASYNC_PREPARATION) &&
+      executable_cache->scheduler.schedule) {
+    // The scheduled work holds a reference until it runs or is cancelled.
+    iree_hal_executable_retain((iree_hal_executable_t*)executable);
+    iree_status_t status = executable_cache->scheduler.schedule(
+        executable_cache->scheduler.self,
+        iree_hal_local_deferred_executable_prepare_async, executable);
+    if (!iree_status_is_ok(status)) {
+      // Fall back to preparing on first use.
+      iree_status_ignore(status);
+      iree_hal_executable_release((iree_hal_executable_t*)executable);
+    }
+  }
+
+  *out_executable = (iree_hal_executable_t*)executable;
+  return iree_ok_status();
+}
+
 static const iree_hal_executable_cache_vtable_t
     iree_hal_local_executable_cache_vtable = {
         .destroy = iree_hal_local_executable_cache_destroy,
@@ -15,17 +15,106 @@
 extern "C" {
 #endif  // __cplusplus
 
-// TODO(benvanik): when we refactor executable caches this can become something
-// more specialized; like nop_executable_cache (does nothing but pass through)
-// or inproc_lru_executable_cache (simple in-memory LRU of recent executables).
+//===----------------------------------------------------------------------===//
+// iree_hal_local_executable_cache_storage_t
+//===----------------------------------------------------------------------===//
+
+// In-memory storage of prepared executables that may be shared by executable
+// caches across devices and contexts. When multiple contexts load the same
+// module the executable data is only parsed, relocated, and protected once and
+// the resulting executable is shared by all of them. Storage is opt-in: devices
+// only share executables when a storage is provided in their parameters.
+//
+// Executables are identified by the full contents of the data they were
+// loaded from: the data is hashed once per prepare and compared in full on a
+// hit, so distinct copies of the same module (such as those loaded separately
+// by each session) share one executable and changed data never matches a
+// stale entry. Each entry keeps a copy of the data it was loaded from.
+//
+// Matching entries must also have structurally equal executable layouts, the
+// same caching mode, and have been loaded by the same kind of loader with the
+// same import provider as imports are resolved when loading. Only executables with
+// IREE_HAL_EXECUTABLE_CACHING_MODE_ALLOW_PERSISTENT_CACHING set and no
+// instrumentation (debugging/coverage/profiling) requested are stored. Shared
+// executables are always loaded without
+// IREE_HAL_EXECUTABLE_CACHING_MODE_ALIAS_PROVIDED_DATA so that they do not
+// reference the data of the module that first loaded them.
+//
+// Up to |capacity| executables are retained by the storage with the least
+// recently used evicted first. Evicted executables remain valid for as long as
+// their users retain them.
 //
-// We can also set this up so they share storage. Ideally a JIT'ed executable in
-// one device is the same JIT'ed executable in another, and in multi-tenant
-// situations we're likely to want that isolation _and_ sharing.
+// Thread-safe - multiple caches may prepare executables simultaneously.
+typedef struct iree_hal_local_executable_cache_storage_t
+    iree_hal_local_executable_cache_storage_t;
+
+// Creates executable cache storage retaining up to |capacity| executables.
+iree_status_t iree_hal_local_executable_cache_storage_create(
+    iree_host_size_t capacity, iree_allocator_t host_allocator,
+    iree_hal_local_executable_cache_storage_t** out_storage);
+
+// Retains the given |storage| for the caller.
+void iree_hal_local_executable_cache_storage_retain(
+    iree_hal_local_executable_cache_storage_t* storage);
+
+// Releases the given |storage| from the caller.
+void iree_hal_local_executable_cache_storage_release(
+    iree_hal_local_executable_cache_storage_t* storage);
+
+// Drops all executables retained by the |storage|.
+void iree_hal_local_executable_cache_storage_trim(
+    iree_hal_local_executable_cache_storage_t* storage);
 
+//===----------------------------------------------------------------------===//
+// iree_hal_local_executable_cache_scheduler_t
+//===----------------------------------------------------------------------===//
+
+// Performs asynchronous executable preparation work.
+// |cancelled| is true if the work will never be performed (such as when the
+// scheduler is discarding pending work) and only resources must be released.
+typedef void(IREE_API_PTR* iree_hal_local_executable_cache_work_fn_t)(
+    void* user_data, bool cancelled);
+
+// Schedules asynchronous executable preparation work on behalf of a cache.
+// Used when executables are prepared with
+// IREE_HAL_EXECUTABLE_CACHING_MODE_ALLOW_ASYNC_PREPARATION.
+typedef struct iree_hal_local_executable_cache_scheduler_t {
+  // Opaque pointer passed to |schedule|. Must remain valid for the lifetime
+  // of all caches created with the scheduler.
+  void* self;
+
+  // Schedules |work_fn| to be called with |work_user_data| from any thread.
+  // If scheduling succeeds |work_fn| must be called exactly once. If it fails
+  // |work_fn| must not be called and the cache will prepare the executable on
+  // first use instead.
+  iree_status_t(IREE_API_PTR* schedule)(
+      void* self, iree_hal_local_executable_cache_work_fn_t work_fn,
+      void* work_user_data);
+} iree_hal_local_executable_cache_scheduler_t;
+
+//===----------------------------------------------------------------------===//
+// iree_hal_local_executable_cache_t
+//===----------------------------------------------------------------------===//
+
+// Creates an executable cache that prepares executables using |loaders|.
+// If |storage| is provided it is retained and used to share executables with
+// all other caches using the same storage.
+//
+// |default_caching_mode| bits are added to the caching mode of all executables
+// prepared by the cache. Hosts can use this to opt in to
+// IREE_HAL_EXECUTABLE_CACHING_MODE_ALLOW_DEFERRED_PREPARATION or
+// IREE_HAL_EXECUTABLE_CACHING_MODE_ALLOW_ASYNC_PREPARATION for all programs.
+//
+// If |scheduler| is provided it is used to prepare executables asynchronously
+// when allowed by their caching mode. Without a scheduler asynchronous
+// preparation is treated as deferred preparation.
 iree_status_t iree_hal_local_executable_cache_create(
-    iree_string_view_t identifier, iree_host_size_t loader_count,
-    iree_hal_executable_loader_t** loaders, iree_allocator_t host_allocator,
+    iree_string_view_t identifier,
+    iree_hal_local_executable_cache_storage_t* storage,
+    iree_hal_executable_caching_mode_t default_caching_mode,
+    const iree_hal_local_executable_cache_scheduler_t* scheduler,
+    iree_host_size_t loader_count, iree_hal_executable_loader_t** loaders,
+    iree_allocator_t host_allocator,
     iree_hal_executable_cache_t** out_executable_cache);
 
 #ifdef __cplusplus
@@ -0,0 +1,803 @@
+// Copyright 2021 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/hal/local/local_executable_cache.h"
+
+#include <cstring>
+#include <utility>
+#include <vector>
+
+#include "iree/base/api.h"
+#include "iree/hal/api.h"
+#include "iree/hal/local/executable_loader.h"
+#include "iree/hal/local/local_executable.h"
+#include "iree/hal/local/local_executable_layout.h"
+#include "iree/testing/gtest.h"
+#include "iree/testing/status_matchers.h"
+
+namespace {
+
+// Executable format handled by the test loader.
+static const char kTestFormat[] = "TEST";
+
+static int TestImport(void* import_params) { return 0; }
+
+//===----------------------------------------------------------------------===//
+// Test executable
+//===----------------------------------------------------------------------===//
+
+// Behavior and counters shared by the test loader and its executables.
+struct TestLoaderState {
+  // Caching mode bits reported as hinted by the executable data.
+  iree_hal_executable_caching_mode_t hinted_caching_mode = 0;
+  // Status code returned from loads; OK to load successfully.
+  iree_status_code_t load_status_code = IREE_STATUS_OK;
+  // Dispatch attributes of loaded executables.
+  iree_hal_executable_dispatch_attrs_v0_t dispatch_attrs = {};
+
+  int load_count = 0;
+  int issue_count = 0;
+  // Caching mode of the last executable loaded.
+  iree_hal_executable_caching_mode_t last_loaded_caching_mode = 0;
+  // Imports passed to the last workgroup issued.
+  const iree_hal_executable_import_v0_t* last_issued_imports = nullptr;
+};
+
+struct TestExecutable {
+  iree_hal_local_executable_t base;
+  TestLoaderState* state;
+};
+
+static void TestExecutableDestroy(iree_hal_executable_t* base_executable) {
+  TestExecutable* executable =
+      reinterpret_cast<TestExecutable*>(base_executable);
+  iree_allocator_t host_allocator = executable->base.host_allocator;
+  iree_hal_local_executable_deinitialize(&executable->base);
+  iree_allocator_free(host_allocator, executable);
+}
+
+static iree_status_t TestExecutableIssueCall(
+    iree_hal_local_executable_t* base_executable, iree_host_size_t ordinal,
+    const iree_hal_executable_dispatch_state_v0_t* dispatch_state,
+    const iree_hal_vec3_t* workgroup_id) {
+  TestExecutable* executable =
+      reinterpret_cast<TestExecutable*>(base_executable);
+  ++executable->state->issue_count;
+  executable->state->last_issued_imports = dispatch_state->imports;
+  return iree_ok_status();
+}
+
+static const iree_hal_local_executable_vtable_t* TestExecutableVtable() {
+  static iree_hal_local_executable_vtable_t vtable = [] {
+    iree_hal_local_executable_vtable_t vtable;
+    memset(&vtable, 0, sizeof(vtable));
+    vtable.base.destroy = TestExecutableDestroy;
+    vtable.issue_call = TestExecutableIssueCall;
+    return vtable;
+  }();
+  return &vtable;
+}
+
+//===----------------------------------------------------------------------===//
+// Test loader
+//===----------------------------------------------------------------------===//
+
+struct TestLoader {
+  iree_hal_executable_loader_t base;
+  TestLoaderState* state;
+};
+
+static void TestLoaderDestroy(iree_hal_executable_loader_t* base_loader) {
+  // Owned by the test fixture.
+}
+
+static bool TestLoaderQuerySupport(
+    iree_hal_executable_loader_t* base_loader,
+    iree_hal_executable_caching_mode_t caching_mode,
+    iree_string_view_t executable_format) {
+  return iree_string_view_equal(executable_format,
+                                iree_make_cstring_view(kTestFormat));
+}
+
+static iree_status_t TestLoaderTryLoad(
+    iree_hal_executable_loader_t* base_loader,
+    const iree_hal_executable_spec_t* executable_spec,
+    iree_hal_executable_t** out_executable) {
+  TestLoaderState* state = reinterpret_cast<TestLoader*>(base_loader)->state;
+  ++state->load_count;
+  state->last_loaded_caching_mode = executable_spec->caching_mode;
+  if (state->load_status_code != IREE_STATUS_OK) {
+    return iree_make_status(state->load_status_code, "test load failure");
+  }
+
+  iree_allocator_t host_allocator = iree_allocator_system();
+  TestExecutable* executable = nullptr;
+  iree_host_size_t total_size =
+      sizeof(*executable) + executable_spec->executable_layout_count *
+                                sizeof(iree_hal_local_executable_layout_t*);
+  IREE_RETURN_IF_ERROR(iree_allocator_malloc(host_allocator, total_size,
+                                             (void**)&executable));
+  iree_hal_local_executable_initialize(
+      TestExecutableVtable(), executable_spec->executable_layout_count,
+      executable_spec->executable_layouts,
+      reinterpret_cast<iree_hal_local_executable_layout_t**>(executable + 1),
+      host_allocator, &executable->base);
+  executable->state = state;
+  executable->base.dispatch_attrs = &state->dispatch_attrs;
+  iree_status_t status = iree_allocator_malloc(
+      host_allocator, sizeof(*executable->base.imports),
+      (void**)&executable->base.imports);
+  if (iree_status_is_ok(status)) {
+    executable->base.imports[0] = TestImport;
+    *out_executable = reinterpret_cast<iree_hal_executable_t*>(executable);
+  } else {
+    iree_hal_executable_release((iree_hal_executable_t*)executable);
+  }
+  return status;
+}
+
+static iree_hal_executable_caching_mode_t TestLoaderQueryCachingMode(
+    iree_hal_executable_loader_t* base_loader,
+    const iree_hal_executable_spec_t* executable_spec) {
+  return reinterpret_cast<TestLoader*>(base_loader)->state->hinted_caching_mode;
+}
+
+static const iree_hal_executable_loader_vtable_t* TestLoaderVtable() {
+  static iree_hal_executable_loader_vtable_t vtable = [] {
+    iree_hal_executable_loader_vtable_t vtable;
+    memset(&vtable, 0, sizeof(vtable));
+    vtable.destroy = TestLoaderDestroy;
+    vtable.query_support = TestLoaderQuerySupport;
+    vtable.try_load = TestLoaderTryLoad;
+    vtable.query_caching_mode = TestLoaderQueryCachingMode;
+    return vtable;
+  }();
+  return &vtable;
+}
+
+//===----------------------------------------------------------------------===//
+// Test scheduler
+//===----------------------------------------------------------------------===//
+
+// Scheduler that queues work until the test runs it.
+struct TestScheduler {
+  iree_status_code_t schedule_status_code = IREE_STATUS_OK;
+  std::vector<std::pair<iree_hal_local_executable_cache_work_fn_t, void*>>
+      pending_work;
+
+  static iree_status_t Schedule(
+      void* self, iree_hal_local_executable_cache_work_fn_t work_fn,
+      void* work_user_data) {
+    TestScheduler* scheduler = reinterpret_cast<TestScheduler*>(self);
+    if (scheduler->schedule_status_code != IREE_STATUS_OK) {
+      return iree_make_status(scheduler->schedule_status_code);
+    }
+    scheduler->pending_work.emplace_back(work_fn, work_user_data);
+    return iree_ok_status();
+  }
+
+  void RunAll(bool cancelled) {
+    auto work = std::move(pending_work);
+    pending_work.clear();
+    for (auto& item : work) item.first(item.second, cancelled);
+  }
+};
+
+//===----------------------------------------------------------------------===//
+// iree_hal_local_executable_cache_t
+//===----------------------------------------------------------------------===//
+
+class LocalExecutableCacheTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    iree_hal_executable_loader_initialize(
+        TestLoaderVtable(), iree_hal_executable_import_provider_null(),
+        &loader_.base);
+    loader_.state = &state_;
+  }
+
+  void TearDown() override {
+    iree_hal_executable_cache_release(executable_cache_);
+    iree_hal_executable_loader_release(&loader_.base);
+  }
+
+  // Creates the cache under test with |default_caching_mode| and optionally
+  // the test |scheduler|.
+  void CreateCache(iree_hal_executable_caching_mode_t default_caching_mode,
+                   TestScheduler* scheduler = nullptr) {
+    iree_hal_local_executable_cache_scheduler_t cache_scheduler;
+    cache_scheduler.self = scheduler;
+    cache_scheduler.schedule = TestScheduler::Schedule;
+    iree_hal_executable_loader_t* loaders[1] = {&loader_.base};
+    IREE_ASSERT_OK(iree_hal_local_executable_cache_create(
+        iree_make_cstring_view("test"), /*storage=*/nullptr,
+        default_caching_mode, scheduler ? &cache_scheduler : nullptr,
+        IREE_ARRAYSIZE(loaders), loaders, iree_allocator_system(),
+        &executable_cache_));
+  }
+
+  iree_status_t PrepareExecutable(
+      const char* format, iree_hal_local_executable_t** out_executable) {
+    static const uint8_t kData[4] = {1, 2, 3, 4};
+    iree_hal_executable_spec_t spec;
+    iree_hal_executable_spec_initialize(&spec);
+    spec.executable_format = iree_make_cstring_view(format);
+    spec.executable_data = iree_make_const_byte_span(kData, sizeof(kData));
+    iree_hal_executable_t* executable = nullptr;
+    iree_status_t status = iree_hal_executable_cache_prepare_executable(
+        executable_cache_, &spec, &executable);
+    *out_executable = iree_hal_local_executable_cast(executable);
+    return status;
+  }
+
+  // Sets the workgroup size declared by loaded executables.
+  void SetWorkgroupSize(uint32_t x, uint32_t y, uint32_t z) {
+    state_.dispatch_attrs.workgroup_size.x = x;
+    state_.dispatch_attrs.workgroup_size.y = y;
+    state_.dispatch_attrs.workgroup_size.z = z;
+  }
+
+  // Issues a single workgroup of |executable| as a command buffer would.
+  iree_status_t IssueWorkgroup(iree_hal_local_executable_t* executable) {
+    iree_hal_executable_dispatch_state_v0_t dispatch_state;
+    memset(&dispatch_state, 0, sizeof(dispatch_state));
+    dispatch_state.workgroup_count.x = 1;
+    dispatch_state.workgroup_count.y = 1;
+    dispatch_state.workgroup_count.z = 1;
+    dispatch_state.workgroup_size =
+        iree_hal_local_executable_workgroup_size(executable, 0);
+    dispatch_state.imports = executable->imports;
+    iree_hal_vec3_t workgroup_id = {{0, 0, 0}};
+    return iree_hal_local_executable_issue_call(executable, 0, &dispatch_state,
+                                                &workgroup_id);
+  }
+
+  TestLoaderState state_;
+  TestLoader loader_;
+  iree_hal_executable_cache_t* executable_cache_ = nullptr;
+};
+
+TEST_F(LocalExecutableCacheTest, EagerPreparation) {
+  SetWorkgroupSize(4, 2, 1);
+  CreateCache(/*default_caching_mode=*/0);
+
+  iree_hal_local_executable_t* executable = nullptr;
+  IREE_ASSERT_OK(PrepareExecutable(kTestFormat, &executable));
+  EXPECT_EQ(state_.load_count, 1);
+  EXPECT_EQ(executable->dispatch_attrs, &state_.dispatch_attrs);
+  ASSERT_NE(executable->imports, nullptr);
+  EXPECT_EQ(executable->imports[0], TestImport);
+
+  // Preparing an eagerly prepared executable is a no-op.
+  IREE_EXPECT_OK(iree_hal_local_executable_prepare(executable));
+  EXPECT_EQ(state_.load_count, 1);
+
+  iree_hal_executable_release((iree_hal_executable_t*)executable);
+}
+
+TEST_F(LocalExecutableCacheTest, UnsupportedFormatFailsImmediately) {
+  CreateCache(IREE_HAL_EXECUTABLE_CACHING_MODE_ALLOW_DEFERRED_PREPARATION);
+  iree_hal_local_executable_t* executable = nullptr;
+  IREE_EXPECT_STATUS_IS(IREE_STATUS_NOT_FOUND,
+                        PrepareExecutable("UNKNOWN", &executable));
+  EXPECT_EQ(executable, nullptr);
+  EXPECT_EQ(state_.load_count, 0);
+}
+
+// Deferred executables are prepared when command buffers prepare them before
+// recording their first dispatch and then expose the dispatch attributes and
+// imports of the prepared executable.
+TEST_F(LocalExecutableCacheTest, DeferredPreparation) {
+  SetWorkgroupSize(4, 2, 1);
+  state_.dispatch_attrs.workgroups_per_reservation = 8;
+  CreateCache(IREE_HAL_EXECUTABLE_CACHING_MODE_ALLOW_DEFERRED_PREPARATION);
+
+  iree_hal_local_executable_t* executable = nullptr;
+  IREE_ASSERT_OK(PrepareExecutable(kTestFormat, &executable));
+  EXPECT_EQ(state_.load_count, 0);
+  EXPECT_EQ(executable->dispatch_attrs, nullptr);
+  EXPECT_EQ(executable->imports, nullptr);
+
+  IREE_ASSERT_OK(iree_hal_local_executable_prepare(executable));
+  EXPECT_EQ(state_.load_count, 1);
+  ASSERT_NE(executable->dispatch_attrs, nullptr);
+  EXPECT_EQ(executable->dispatch_attrs[0].workgroups_per_reservation, 8u);
+  iree_hal_vec3_t workgroup_size =
+      iree_hal_local_executable_workgroup_size(executable, 0);
+  EXPECT_EQ(workgroup_size.x, 4u);
+  EXPECT_EQ(workgroup_size.y, 2u);
+  EXPECT_EQ(workgroup_size.z, 1u);
+  ASSERT_NE(executable->imports, nullptr);
+  EXPECT_EQ(executable->imports[0], TestImport);
+
+  // Workgroups are forwarded to the prepared executable with its imports.
+  IREE_ASSERT_OK(IssueWorkgroup(executable));
+  EXPECT_EQ(state_.issue_count, 1);
+  EXPECT_EQ(state_.last_issued_imports, executable->imports);
+
+  // Subsequent preparation is a no-op.
+  IREE_EXPECT_OK(iree_hal_local_executable_prepare(executable));
+  EXPECT_EQ(state_.load_count, 1);
+
+  iree_hal_executable_release((iree_hal_executable_t*)executable);
+}
+
+TEST_F(LocalExecutableCacheTest, DeferredIssueBeforePrepareFails) {
+  CreateCache(IREE_HAL_EXECUTABLE_CACHING_MODE_ALLOW_DEFERRED_PREPARATION);
+  iree_hal_local_executable_t* executable = nullptr;
+  IREE_ASSERT_OK(PrepareExecutable(kTestFormat, &executable));
+  IREE_EXPECT_STATUS_IS(IREE_STATUS_FAILED_PRECONDITION,
+                        IssueWorkgroup(executable));
+  EXPECT_EQ(state_.load_count, 0);
+  EXPECT_EQ(state_.issue_count, 0);
+  iree_hal_executable_release((iree_hal_executable_t*)executable);
+}
+
+// Executables compiled with a preparation hint are deferred even when the host
+// did not opt in.
+TEST_F(LocalExecutableCacheTest, HintedDeferredPreparation) {
+  state_.hinted_caching_mode =
+      IREE_HAL_EXECUTABLE_CACHING_MODE_ALLOW_DEFERRED_PREPARATION;
+  CreateCache(/*default_caching_mode=*/0);
+
+  iree_hal_local_executable_t* executable = nullptr;
+  IREE_ASSERT_OK(PrepareExecutable(kTestFormat, &executable));
+  EXPECT_EQ(state_.load_count, 0);
+  IREE_ASSERT_OK(iree_hal_local_executable_prepare(executable));
+  EXPECT_EQ(state_.load_count, 1);
+  iree_hal_executable_release((iree_hal_executable_t*)executable);
+}
+
+// Hints may only request deferral; other caching mode bits are ignored.
+TEST_F(LocalExecutableCacheTest, HintedCachingModesAreFiltered) {
+  state_.hinted_caching_mode =
+      IREE_HAL_EXECUTABLE_CACHING_MODE_ALIAS_PROVIDED_DATA;
+  CreateCache(/*default_caching_mode=*/0);
+
+  iree_hal_local_executable_t* executable = nullptr;
+  IREE_ASSERT_OK(PrepareExecutable(kTestFormat, &executable));
+  EXPECT_EQ(state_.load_count, 1);
+  iree_hal_executable_release((iree_hal_executable_t*)executable);
+}
+
+TEST_F(LocalExecutableCacheTest, AsyncPreparation) {
+  TestScheduler scheduler;
+  CreateCache(IREE_HAL_EXECUTABLE_CACHING_MODE_ALLOW_ASYNC_PREPARATION,
+              &scheduler);
+
+  iree_hal_local_executable_t* executable = nullptr;
+  IREE_ASSERT_OK(PrepareExecutable(kTestFormat, &executable));
+  EXPECT_EQ(state_.load_count, 0);
+  ASSERT_EQ(scheduler.pending_work.size(), 1u);
+
+  // The scheduled work prepares the executable.
+  scheduler.RunAll(/*cancelled=*/false);
+  EXPECT_EQ(state_.load_count, 1);
+
+  // Command buffers find it already prepared.
+  IREE_ASSERT_OK(iree_hal_local_executable_prepare(executable));
+  EXPECT_EQ(state_.load_count, 1);
+  EXPECT_NE(executable->dispatch_attrs, nullptr);
+  IREE_EXPECT_OK(IssueWorkgroup(executable));
+
+  iree_hal_executable_release((iree_hal_executable_t*)executable);
+}
+
+// Preparing before the scheduled work runs prepares on the caller and the
+// scheduled work then has nothing to do.
+TEST_F(LocalExecutableCacheTest, AsyncPreparationRacedByDispatch) {
+  TestScheduler scheduler;
+  CreateCache(IREE_HAL_EXECUTABLE_CACHING_MODE_ALLOW_ASYNC_PREPARATION,
+              &scheduler);
+
+  iree_hal_local_executable_t* executable = nullptr;
+  IREE_ASSERT_OK(PrepareExecutable(kTestFormat, &executable));
+  IREE_ASSERT_OK(iree_hal_local_executable_prepare(executable));
+  EXPECT_EQ(state_.load_count, 1);
+
+  // The scheduled work holds a reference to the executable.
+  iree_hal_executable_release((iree_hal_executable_t*)executable);
+  scheduler.RunAll(/*cancelled=*/false);
+  EXPECT_EQ(state_.load_count, 1);
+}
+
+TEST_F(LocalExecutableCacheTest, AsyncPreparationCancelled) {
+  TestScheduler scheduler;
+  CreateCache(IREE_HAL_EXECUTABLE_CACHING_MODE_ALLOW_ASYNC_PREPARATION,
+              &scheduler);
+
+  iree_hal_local_executable_t* executable = nullptr;
+  IREE_ASSERT_OK(PrepareExecutable(kTestFormat, &executable));
+  scheduler.RunAll(/*cancelled=*/true);
+  EXPECT_EQ(state_.load_count, 0);
+
+  // Falls back to preparing when first dispatched.
+  IREE_ASSERT_OK(iree_hal_local_executable_prepare(executable));
+  EXPECT_EQ(state_.load_count, 1);
+  iree_hal_executable_release((iree_hal_executable_t*)executable);
+}
+
+TEST_F(LocalExecutableCacheTest, AsyncPreparationScheduleFailure) {
+  TestScheduler scheduler;
+  scheduler.schedule_status_code = IREE_STATUS_RESOURCE_EXHAUSTED;
+  CreateCache(IREE_HAL_EXECUTABLE_CACHING_MODE_ALLOW_ASYNC_PREPARATION,
+              &scheduler);
+
+  // Scheduling failures fall back to deferred preparation.
+  iree_hal_local_executable_t* executable = nullptr;
+  IREE_ASSERT_OK(PrepareExecutable(kTestFormat, &executable));
+  EXPECT_TRUE(scheduler.pending_work.empty());
+  EXPECT_EQ(state_.load_count, 0);
+  IREE_ASSERT_OK(iree_hal_local_executable_prepare(executable));
+  EXPECT_EQ(state_.load_count, 1);
+  iree_hal_executable_release((iree_hal_executable_t*)executable);
+}
+
+TEST_F(LocalExecutableCacheTest, AsyncWithoutSchedulerIsDeferred) {
+  CreateCache(IREE_HAL_EXECUTABLE_CACHING_MODE_ALLOW_ASYNC_PREPARATION);
+  iree_hal_local_executable_t* executable = nullptr;
+  IREE_ASSERT_OK(PrepareExecutable(kTestFormat, &executable));
+  EXPECT_EQ(state_.load_count, 0);
+  IREE_ASSERT_OK(iree_hal_local_executable_prepare(executable));
+  EXPECT_EQ(state_.load_count, 1);
+  iree_hal_executable_release((iree_hal_executable_t*)executable);
+}
+
+// Preparation failures are reported to every dispatch of the executable and
+// preparation is only attempted once.
+TEST_F(LocalExecutableCacheTest, DeferredPreparationFailure) {
+  state_.load_status_code = IREE_STATUS_DATA_LOSS;
+  CreateCache(IREE_HAL_EXECUTABLE_CACHING_MODE_ALLOW_DEFERRED_PREPARATION);
+
+  iree_hal_local_executable_t* executable = nullptr;
+  IREE_ASSERT_OK(PrepareExecutable(kTestFormat, &executable));
+  IREE_EXPECT_STATUS_IS(IREE_STATUS_DATA_LOSS,
+                        iree_hal_local_executable_prepare(executable));
+  IREE_EXPECT_STATUS_IS(IREE_STATUS_DATA_LOSS,
+                        iree_hal_local_executable_prepare(executable));
+  EXPECT_EQ(state_.load_count, 1);
+  EXPECT_EQ(executable->dispatch_attrs, nullptr);
+  IREE_EXPECT_STATUS_IS(IREE_STATUS_FAILED_PRECONDITION,
+                        IssueWorkgroup(executable));
+  iree_hal_executable_release((iree_hal_executable_t*)executable);
+}
+
+TEST_F(LocalExecutableCacheTest, AsyncPreparationFailure) {
+  state_.load_status_code = IREE_STATUS_DATA_LOSS;
+  TestScheduler scheduler;
+  CreateCache(IREE_HAL_EXECUTABLE_CACHING_MODE_ALLOW_ASYNC_PREPARATION,
+              &scheduler);
+
+  iree_hal_local_executable_t* executable = nullptr;
+  IREE_ASSERT_OK(PrepareExecutable(kTestFormat, &executable));
+  scheduler.RunAll(/*cancelled=*/false);
+  EXPECT_EQ(state_.load_count, 1);
+
+  // The failure from the background preparation is reported when dispatched.
+  IREE_EXPECT_STATUS_IS(IREE_STATUS_DATA_LOSS,
+                        iree_hal_local_executable_prepare(executable));
+  EXPECT_EQ(state_.load_count, 1);
+  iree_hal_executable_release((iree_hal_executable_t*)executable);
+}
+
+//===----------------------------------------------------------------------===//
+// iree_hal_local_executable_cache_storage_t
+//===----------------------------------------------------------------------===//
+
+// Two caches sharing one storage, as when two contexts load the same module.
+class LocalExecutableCacheStorageTest : public LocalExecutableCacheTest {
+ protected:
+  void TearDown() override {
+    iree_hal_executable_cache_release(other_executable_cache_);
+    iree_hal_local_executable_cache_storage_release(storage_);
+    LocalExecutableCacheTest::TearDown();
+  }
+
+  // Creates storage retaining |capacity| executables and two caches using it.
+  void CreateCaches(iree_host_size_t capacity,
+                    iree_hal_executable_caching_mode_t other_caching_mode = 0) {
+    IREE_ASSERT_OK(iree_hal_local_executable_cache_storage_create(
+        capacity, iree_allocator_system(), &storage_));
+    iree_hal_executable_loader_t* loaders[1] = {&loader_.base};
+    IREE_ASSERT_OK(iree_hal_local_executable_cache_create(
+        iree_make_cstring_view("test"), storage_, /*default_caching_mode=*/0,
+        /*scheduler=*/nullptr, IREE_ARRAYSIZE(loaders), loaders,
+        iree_allocator_system(), &executable_cache_));
+    IREE_ASSERT_OK(iree_hal_local_executable_cache_create(
+        iree_make_cstring_view("other"), storage_, other_caching_mode,
+        /*scheduler=*/nullptr, IREE_ARRAYSIZE(loaders), loaders,
+        iree_allocator_system(), &other_executable_cache_));
+  }
+
+  // Prepares |data| from |executable_cache| with the given |caching_mode| and
+  // an optional |executable_layout|.
+  iree_hal_executable_t* Prepare(
+      iree_hal_executable_cache_t* executable_cache, const uint8_t* data,
+      iree_hal_executable_layout_t* executable_layout = nullptr,
+      iree_hal_executable_caching_mode_t caching_mode =
+          IREE_HAL_EXECUTABLE_CACHING_MODE_ALLOW_PERSISTENT_CACHING) {
+    iree_hal_executable_spec_t spec;
+    iree_hal_executable_spec_initialize(&spec);
+    spec.caching_mode = caching_mode;
+    spec.executable_format = iree_make_cstring_view(kTestFormat);
+    spec.executable_data = iree_make_const_byte_span(data, kDataSize);
+    if (executable_layout) {
+      spec.executable_layout_count = 1;
+      spec.executable_layouts = &executable_layout;
+    }
+    iree_hal_executable_t* executable = nullptr;
+    IREE_CHECK_OK(iree_hal_executable_cache_prepare_executable(
+        executable_cache, &spec, &executable));
+    return executable;
+  }
+
+  static iree_hal_executable_layout_t* CreateLayout(
+      iree_host_size_t push_constants) {
+    iree_hal_executable_layout_t* executable_layout = nullptr;
+    IREE_CHECK_OK(iree_hal_local_executable_layout_create(
+        push_constants, /*set_layout_count=*/0, /*set_layouts=*/nullptr,
+        iree_allocator_system(), &executable_layout));
+    return executable_layout;
+  }
+
+  static constexpr iree_host_size_t kDataSize = 256;
+  uint8_t data_a_[kDataSize] = {1};
+  uint8_t data_b_[kDataSize] = {2};
+  uint8_t data_c_[kDataSize] = {3};
+
+  iree_hal_local_executable_cache_storage_t* storage_ = nullptr;
+  iree_hal_executable_cache_t* other_executable_cache_ = nullptr;
+};
+
+TEST_F(LocalExecutableCacheStorageTest, Hit) {
+  CreateCaches(/*capacity=*/4);
+  iree_hal_executable_t* executable = Prepare(executable_cache_, data_a_);
+  iree_hal_executable_t* other_executable =
+      Prepare(other_executable_cache_, data_a_);
+  EXPECT_EQ(executable, other_executable);
+  EXPECT_EQ(state_.load_count, 1);
+  // Shared executables never alias the data of the first module loading them.
+  EXPECT_FALSE(iree_all_bits_set(
+      state_.last_loaded_caching_mode,
+      IREE_HAL_EXECUTABLE_CACHING_MODE_ALIAS_PROVIDED_DATA));
+  iree_hal_executable_release(executable);
+  iree_hal_executable_release(other_executable);
+}
+
+TEST_F(LocalExecutableCacheStorageTest, Miss) {
+  CreateCaches(/*capacity=*/4);
+  iree_hal_executable_t* executable = Prepare(executable_cache_, data_a_);
+  iree_hal_executable_t* other_executable =
+      Prepare(other_executable_cache_, data_b_);
+  EXPECT_NE(executable, other_executable);
+  EXPECT_EQ(state_.load_count, 2);
+  iree_hal_executable_release(executable);
+  iree_hal_executable_release(other_executable);
+}
+
+// Executables are identified by the contents of their data and shared between
+// separately loaded copies of the same module.
+TEST_F(LocalExecutableCacheStorageTest, HitOnCopiedData) {
+  CreateCaches(/*capacity=*/4);
+  memcpy(data_b_, data_a_, kDataSize);
+  iree_hal_executable_t* executable = Prepare(executable_cache_, data_a_);
+  iree_hal_executable_t* other_executable =
+      Prepare(other_executable_cache_, data_b_);
+  EXPECT_EQ(executable, other_executable);
+  EXPECT_EQ(state_.load_count, 1);
+  iree_hal_executable_release(executable);
+  iree_hal_executable_release(other_executable);
+}
+
+// Data of the same size reloaded at the same address with different contents,
+// as when a recompiled module replaces the original, is not matched.
+TEST_F(LocalExecutableCacheStorageTest, MissOnChangedData) {
+  CreateCaches(/*capacity=*/4);
+  iree_hal_executable_t* executable = Prepare(executable_cache_, data_a_);
+  data_a_[kDataSize / 2 + 3] = 0xFF;
+  iree_hal_executable_t* other_executable =
+      Prepare(other_executable_cache_, data_a_);
+  EXPECT_NE(executable, other_executable);
+  EXPECT_EQ(state_.load_count, 2);
+  iree_hal_executable_release(executable);
+  iree_hal_executable_release(other_executable);
+}
+
+// Entries keep a copy of their data and still match after the data they were
+// loaded from has been overwritten and restored.
+TEST_F(LocalExecutableCacheStorageTest, HitAfterDataRestored) {
+  CreateCaches(/*capacity=*/4);
+  iree_hal_executable_t* executable = Prepare(executable_cache_, data_a_);
+  uint8_t original_data[kDataSize];
+  memcpy(original_data, data_a_, kDataSize);
+  memset(data_a_, 0xFF, kDataSize);
+  iree_hal_executable_t* other_executable =
+      Prepare(other_executable_cache_, original_data);
+  EXPECT_EQ(executable, other_executable);
+  EXPECT_EQ(state_.load_count, 1);
+  iree_hal_executable_release(executable);
+  iree_hal_executable_release(other_executable);
+}
+
+TEST_F(LocalExecutableCacheStorageTest, MissWithoutPersistentCaching) {
+  CreateCaches(/*capacity=*/4);
+  iree_hal_executable_t* executable =
+      Prepare(executable_cache_, data_a_, nullptr, /*caching_mode=*/0);
+  iree_hal_executable_t* other_executable =
+      Prepare(other_executable_cache_, data_a_, nullptr, /*caching_mode=*/0);
+  EXPECT_NE(executable, other_executable);
+  EXPECT_EQ(state_.load_count, 2);
+  iree_hal_executable_release(executable);
+  iree_hal_executable_release(other_executable);
+}
+
+TEST_F(LocalExecutableCacheStorageTest, MissWithZeroCapacity) {
+  CreateCaches(/*capacity=*/0);
+  iree_hal_executable_release(Prepare(executable_cache_, data_a_));
+  iree_hal_executable_release(Prepare(other_executable_cache_, data_a_));
+  EXPECT_EQ(state_.load_count, 2);
+}
+
+// The least recently used executable is evicted when over capacity.
+TEST_F(LocalExecutableCacheStorageTest, Eviction) {
+  CreateCaches(/*capacity=*/2);
+  iree_hal_executable_release(Prepare(executable_cache_, data_a_));
+  iree_hal_executable_release(Prepare(executable_cache_, data_b_));
+  EXPECT_EQ(state_.load_count, 2);
+  // Hit moves A to the front so that B is evicted by C.
+  iree_hal_executable_release(Prepare(other_executable_cache_, data_a_));
+  EXPECT_EQ(state_.load_count, 2);
+  iree_hal_executable_release(Prepare(executable_cache_, data_c_));
+  EXPECT_EQ(state_.load_count, 3);
+  iree_hal_executable_release(Prepare(other_executable_cache_, data_a_));
+  EXPECT_EQ(state_.load_count, 3);
+  iree_hal_executable_release(Prepare(other_executable_cache_, data_b_));
+  EXPECT_EQ(state_.load_count, 4);
+}
+
+// Evicted executables remain valid while retained by their users.
+TEST_F(LocalExecutableCacheStorageTest, EvictedExecutablesRemainValid) {
+  CreateCaches(/*capacity=*/1);
+  iree_hal_executable_t* executable = Prepare(executable_cache_, data_a_);
+  iree_hal_executable_release(Prepare(executable_cache_, data_b_));
+  EXPECT_EQ(state_.load_count, 2);
+  iree_hal_local_executable_t* local_executable =
+      iree_hal_local_executable_cast(executable);
+  IREE_EXPECT_OK(IssueWorkgroup(local_executable));
+  EXPECT_EQ(state_.issue_count, 1);
+  iree_hal_executable_release(executable);
+}
+
+TEST_F(LocalExecutableCacheStorageTest, Trim) {
+  CreateCaches(/*capacity=*/4);
+  iree_hal_executable_release(Prepare(executable_cache_, data_a_));
+  iree_hal_local_executable_cache_storage_trim(storage_);
+  iree_hal_executable_release(Prepare(other_executable_cache_, data_a_));
+  EXPECT_EQ(state_.load_count, 2);
+}
+
+// Executables are shared between distinct loaders of the same kind that resolve
+// imports with the same provider.
+TEST_F(LocalExecutableCacheStorageTest, HitWithEquivalentLoader) {
+  CreateCaches(/*capacity=*/4);
+  TestLoader other_loader;
+  iree_hal_executable_loader_initialize(
+      TestLoaderVtable(), iree_hal_executable_import_provider_null(),
+      &other_loader.base);
+  other_loader.state = &state_;
+  iree_hal_executable_loader_t* loaders[1] = {&other_loader.base};
+  iree_hal_executable_cache_t* loader_executable_cache = nullptr;
+  IREE_ASSERT_OK(iree_hal_local_executable_cache_create(
+      iree_make_cstring_view("loader"), storage_, /*default_caching_mode=*/0,
+      /*scheduler=*/nullptr, IREE_ARRAYSIZE(loaders), loaders,
+      iree_allocator_system(), &loader_executable_cache));
+  iree_hal_executable_t* executable = Prepare(executable_cache_, data_a_);
+  iree_hal_executable_t* other_executable =
+      Prepare(loader_executable_cache, data_a_);
+  EXPECT_EQ(executable, other_executable);
+  EXPECT_EQ(state_.load_count, 1);
+  iree_hal_executable_release(executable);
+  iree_hal_executable_release(other_executable);
+  iree_hal_executable_cache_release(loader_executable_cache);
+  iree_hal_executable_loader_release(&other_loader.base);
+}
+
+static iree_status_t ResolveTestImport(void* self,
+                                       iree_string_view_t symbol_name,
+                                       void** out_fn_ptr) {
+  *out_fn_ptr = (void*)TestImport;
+  return iree_ok_status();
+}
+
+// Executables loaded with one import provider are not shared with loaders
+// that would resolve their imports with another.
+TEST_F(LocalExecutableCacheStorageTest, MissWithDifferentImportProvider) {
+  CreateCaches(/*capacity=*/4);
+  TestLoader other_loader;
+  iree_hal_executable_import_provider_t import_provider = {
+      /*self=*/nullptr, ResolveTestImport};
+  iree_hal_executable_loader_initialize(TestLoaderVtable(), import_provider,
+                                        &other_loader.base);
+  other_loader.state = &state_;
+  iree_hal_executable_loader_t* loaders[1] = {&other_loader.base};
+  iree_hal_executable_cache_t* loader_executable_cache = nullptr;
+  IREE_ASSERT_OK(iree_hal_local_executable_cache_create(
+      iree_make_cstring_view("loader"), storage_, /*default_caching_mode=*/0,
+      /*scheduler=*/nullptr, IREE_ARRAYSIZE(loaders), loaders,
+      iree_allocator_system(), &loader_executable_cache));
+  iree_hal_executable_t* executable = Prepare(executable_cache_, data_a_);
+  iree_hal_executable_t* other_executable =
+      Prepare(loader_executable_cache, data_a_);
+  EXPECT_NE(executable, other_executable);
+  EXPECT_EQ(state_.load_count, 2);
+  iree_hal_executable_release(executable);
+  iree_hal_executable_release(other_executable);
+  iree_hal_executable_cache_release(loader_executable_cache);
+  iree_hal_executable_loader_release(&other_loader.base);
+}
+
+// Structurally equal layouts are compatible even if distinct objects.
+TEST_F(LocalExecutableCacheStorageTest, CompatibleLayouts) {
+  CreateCaches(/*capacity=*/4);
+  iree_hal_executable_layout_t* layout = CreateLayout(/*push_constants=*/2);
+  iree_hal_executable_layout_t* other_layout =
+      CreateLayout(/*push_constants=*/2);
+  iree_hal_executable_t* executable =
+      Prepare(executable_cache_, data_a_, layout);
+  iree_hal_executable_t* other_executable =
+      Prepare(other_executable_cache_, data_a_, other_layout);
+  EXPECT_EQ(executable, other_executable);
+  EXPECT_EQ(state_.load_count, 1);
+  iree_hal_executable_release(executable);
+  iree_hal_executable_release(other_executable);
+  iree_hal_executable_layout_release(layout);
+  iree_hal_executable_layout_release(other_layout);
+}
+
+TEST_F(LocalExecutableCacheStorageTest, IncompatibleLayoutsRejected) {
+  CreateCaches(/*capacity=*/4);
+  iree_hal_executable_layout_t* layout = CreateLayout(/*push_constants=*/2);
+  iree_hal_executable_layout_t* other_layout =
+      CreateLayout(/*push_constants=*/3);
+  iree_hal_executable_t* executable =
+      Prepare(executable_cache_, data_a_, layout);
+  iree_hal_executable_t* other_executable =
+      Prepare(other_executable_cache_, data_a_, other_layout);
+  EXPECT_NE(executable, other_executable);
+  EXPECT_EQ(state_.load_count, 2);
+  iree_hal_executable_release(executable);
+  iree_hal_executable_release(other_executable);
+  iree_hal_executable_layout_release(layout);
+  iree_hal_executable_layout_release(other_layout);
+}
+
+// Deferred executables copy the data they are given but are still shared with
+// other loads of the original data.
+TEST_F(LocalExecutableCacheStorageTest, DeferredPreparationShares) {
+  CreateCaches(/*capacity=*/4,
+               IREE_HAL_EXECUTABLE_CACHING_MODE_ALLOW_DEFERRED_PREPARATION);
+  iree_hal_executable_t* deferred_executable =
+      Prepare(other_executable_cache_, data_a_);
+  EXPECT_EQ(state_.load_count, 0);
+  IREE_ASSERT_OK(iree_hal_local_executable_prepare(
+      iree_hal_local_executable_cast(deferred_executable)));
+  EXPECT_EQ(state_.load_count, 1);
+
+  iree_hal_executable_t* executable = Prepare(executable_cache_, data_a_);
+  EXPECT_EQ(state_.load_count, 1);
+
+  // Executables already in storage are returned ready for dispatch.
+  iree_hal_executable_t* other_executable =
+      Prepare(other_executable_cache_, data_a_);
+  EXPECT_EQ(other_executable, executable);
+  EXPECT_EQ(state_.load_count, 1);
+
+  iree_hal_executable_release(deferred_executable);
+  iree_hal_executable_release(executable);
+  iree_hal_executable_release(other_executable);
+}
+
+}  // namespace
@@ -86,6 +86,45 @@ iree_status_t iree_hal_local_executable_layout_create(
   return status;
 }
 
+static bool iree_hal_local_descriptor_set_layout_is_compatible(
+    iree_hal_descriptor_set_layout_t* base_a,
+    iree_hal_descriptor_set_layout_t* base_b) {
+  if (base_a == base_b) return true;
+  iree_hal_local_descriptor_set_layout_t* a =
+      iree_hal_local_descriptor_set_layout_cast(base_a);
+  iree_hal_local_descriptor_set_layout_t* b =
+      iree_hal_local_descriptor_set_layout_cast(base_b);
+  if (a->usage_type != b->usage_type) return false;
+  if (a->binding_count != b->binding_count) return false;
+  for (iree_host_size_t i = 0; i < a->binding_count; ++i) {
+    if (a->bindings[i].binding != b->bindings[i].binding ||
+        a->bindings[i].type != b->bindings[i].type ||
+        a->bindings[i].access != b->bindings[i].access) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool iree_hal_local_executable_layout_is_compatible(
+    iree_hal_executable_layout_t* base_a,
+    iree_hal_executable_layout_t* base_b) {
+  if (base_a == base_b) return true;
+  iree_hal_local_executable_layout_t* a =
+      iree_hal_local_executable_layout_cast(base_a);
+  iree_hal_local_executable_layout_t* b =
+      iree_hal_local_executable_layout_cast(base_b);
+  if (a->push_constants != b->push_constants) return false;
+  if (a->set_layout_count != b->set_layout_count) return false;
+  for (iree_host_size_t i = 0; i < a->set_layout_count; ++i) {
+    if (!iree_hal_local_descriptor_set_layout_is_compatible(
+            a->set_layouts[i], b->set_layouts[i])) {
+      return false;
+    }
+  }
+  return true;
+}
+
 static void iree_hal_local_executable_layout_destroy(
     iree_hal_executable_layout_t* base_layout) {
   iree_hal_local_executable_layout_t* layout =
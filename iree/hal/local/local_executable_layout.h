@@ -7,6 +7,7 @@
 #ifndef IREE_HAL_LOCAL_LOCAL_EXECUTABLE_LAYOUT_H_
 #define IREE_HAL_LOCAL_LOCAL_EXECUTABLE_LAYOUT_H_
 
+#include <stdbool.h>
 #include <stdint.h>
 
 #include "iree/base/api.h"
@@ -43,6 +44,12 @@ iree_status_t iree_hal_local_executable_layout_create(
 iree_hal_local_executable_layout_t* iree_hal_local_executable_layout_cast(
     iree_hal_executable_layout_t* base_value);
 
+// Returns true if executables prepared against layout |a| can be dispatched
+// with layout |b| (and vice versa). Layouts are compatible if they are the same
+// object or describe the same push constants and descriptor set bindings.
+bool iree_hal_local_executable_layout_is_compatible(
+    iree_hal_executable_layout_t* a, iree_hal_executable_layout_t* b);
+
 #ifdef __cplusplus
 }  // extern "C"
 #endif  // __cplusplus
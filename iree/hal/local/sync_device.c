@@ -26,6 +26,11 @@ typedef struct iree_hal_sync_device_t {
   iree_host_size_t loader_count;
   iree_hal_executable_loader_t** loaders;
 
+  // Storage shared by all executable caches created from the device.
+  iree_hal_local_executable_cache_storage_t* executable_cache_storage;
+  // Caching mode bits added to all executables prepared by the device.
+  iree_hal_executable_caching_mode_t executable_caching_mode;
+
   iree_allocator_t host_allocator;
   iree_hal_allocator_t* device_allocator;
 
@@ -84,10 +89,17 @@ iree_status_t iree_hal_sync_device_create(
       device->loaders[i] = loaders[i];
       iree_hal_executable_loader_retain(device->loaders[i]);
     }
+    device->executable_caching_mode = params->executable_caching_mode;
 
     iree_hal_sync_semaphore_state_initialize(&device->semaphore_state);
   }
 
+  if (iree_status_is_ok(status)) {
+    device->executable_cache_storage = params->executable_cache_storage;
+    iree_hal_local_executable_cache_storage_retain(
+        device->executable_cache_storage);
+  }
+
   if (iree_status_is_ok(status)) {
     status = iree_hal_allocator_create_heap(identifier, host_allocator,
                                             &device->device_allocator);
@@ -109,6 +121,8 @@ static void iree_hal_sync_device_destroy(iree_hal_device_t* base_device) {
 
   iree_hal_sync_semaphore_state_deinitialize(&device->semaphore_state);
 
+  iree_hal_local_executable_cache_storage_release(
+      device->executable_cache_storage);
   for (iree_host_size_t i = 0; i < device->loader_count; ++i) {
     iree_hal_executable_loader_release(device->loaders[i]);
   }
@@ -190,7 +204,9 @@ static iree_status_t iree_hal_sync_device_create_executable_cache(
     iree_hal_executable_cache_t** out_executable_cache) {
   iree_hal_sync_device_t* device = iree_hal_sync_device_cast(base_device);
   return iree_hal_local_executable_cache_create(
-      identifier, device->loader_count, device->loaders,
+      identifier, device->executable_cache_storage,
+      device->executable_caching_mode, /*scheduler=*/NULL,
+      device->loader_count, device->loaders,
       iree_hal_device_host_allocator(base_device), out_executable_cache);
 }
 
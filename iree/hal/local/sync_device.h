@@ -10,6 +10,7 @@
 #include "iree/base/api.h"
 #include "iree/hal/api.h"
 #include "iree/hal/local/executable_loader.h"
+#include "iree/hal/local/local_executable_cache.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -18,7 +19,17 @@ extern "C" {
 // Parameters configuring an iree_hal_sync_device_t.
 // Must be initialized with iree_hal_sync_device_params_initialize prior to use.
 typedef struct iree_hal_sync_device_params_t {
-  int reserved;
+  // Optional storage used to share prepared executables across all executable
+  // caches created from devices using the same storage; retained by devices
+  // and drivers. If omitted (the default) each executable cache prepares its
+  // own executables.
+  iree_hal_local_executable_cache_storage_t* executable_cache_storage;
+
+  // Caching mode bits added to all executables prepared by the device.
+  // Set IREE_HAL_EXECUTABLE_CACHING_MODE_ALLOW_DEFERRED_PREPARATION to defer
+  // preparing executables until they are first dispatched. The sync device has
+  // no worker threads and treats asynchronous preparation as deferred.
+  iree_hal_executable_caching_mode_t executable_caching_mode;
 } iree_hal_sync_device_params_t;
 
 // Initializes |out_params| to default values.
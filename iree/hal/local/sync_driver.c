@@ -60,6 +60,10 @@ iree_status_t iree_hal_sync_driver_create(
     memcpy(&driver->default_params, default_params,
            sizeof(driver->default_params));
 
+    // Devices created from the driver share the storage if provided.
+    iree_hal_local_executable_cache_storage_retain(
+        driver->default_params.executable_cache_storage);
+
     driver->loader_count = loader_count;
     for (iree_host_size_t i = 0; i < driver->loader_count; ++i) {
       driver->loaders[i] = loaders[i];
@@ -84,6 +88,8 @@ static void iree_hal_sync_driver_destroy(iree_hal_driver_t* base_driver) {
   for (iree_host_size_t i = 0; i < driver->loader_count; ++i) {
     iree_hal_executable_loader_release(driver->loaders[i]);
   }
+  iree_hal_local_executable_cache_storage_release(
+      driver->default_params.executable_cache_storage);
   iree_allocator_free(host_allocator, driver);
 
   IREE_TRACE_ZONE_END(z0);
@@ -9,9 +9,11 @@
 #include <stdbool.h>
 #include <stddef.h>
 #include <stdint.h>
+#include <stdlib.h>
 #include <string.h>
 
 #include "iree/base/api.h"
+#include "iree/base/internal/atomics.h"
 #include "iree/base/tracing.h"
 #include "iree/hal/local/executable_library.h"
 #include "iree/hal/local/local_descriptor_set_layout.h"
@@ -21,11 +23,47 @@
 #include "iree/task/list.h"
 #include "iree/task/submission.h"
 #include "iree/task/task.h"
+#include "iree/task/tuning.h"
 
 //===----------------------------------------------------------------------===//
 // iree_hal_task_command_buffer_t
 //===----------------------------------------------------------------------===//
 
+// A task recorded into a reusable command buffer.
+// Records are chained in recording order while the command buffer is being
+// recorded and flattened into the reusable task table when recording ends.
+typedef struct iree_hal_task_command_buffer_record_t {
+  struct iree_hal_task_command_buffer_record_t* next;
+  iree_task_t* task;
+} iree_hal_task_command_buffer_record_t;
+
+// Immutable description of a recorded task used to restore or clone it each
+// time a reusable command buffer is issued. Dependency edges are stored as
+// indices into the task table so that clones can be rewired without lookups.
+typedef struct iree_hal_task_command_buffer_template_t {
+  // Live task as recorded. Issued in-place when the command buffer is idle.
+  iree_task_t* task;
+  // Snapshot of the task as it was when recording ended.
+  const iree_task_t* pristine;
+  // Size of the task structure in bytes (based on the task type).
+  iree_host_size_t task_size;
+  // Index of the completion task in the table or UINT32_MAX if none.
+  uint32_t completion_index;
+  // Number of entries in |dependent_indices| (barriers only).
+  uint32_t dependent_count;
+  // Indices of the barrier dependent tasks in the table (barriers only).
+  const uint32_t* dependent_indices;
+} iree_hal_task_command_buffer_template_t;
+
+// An event signaled within the command buffer during recording.
+// Waits on the event depend on |signal_task|, which joins all tasks recorded
+// prior to the signal.
+typedef struct iree_hal_task_command_buffer_event_t {
+  struct iree_hal_task_command_buffer_event_t* next;
+  const iree_hal_event_t* event;
+  iree_task_barrier_t* signal_task;
+} iree_hal_task_command_buffer_event_t;
+
 // iree/task/-based command buffer.
 // We track a minimal amount of state here and incrementally build out the task
 // DAG that we can submit to the task system directly. There's no intermediate
@@ -46,6 +84,11 @@ typedef struct iree_hal_task_command_buffer_t {
   // Arena used for all allocations; references the shared device block pool.
   iree_arena_allocator_t arena;
 
+  // Dispatch statistics aggregated from all dispatches issued from the command
+  // buffer as they retire. Only counted when
+  // IREE_TASK_DISPATCH_STATISTICS_ENABLE is set.
+  iree_task_dispatch_statistics_t statistics;
+
   // One or more tasks at the root of the command buffer task DAG.
   // These tasks are all able to execute concurrently and will be the initial
   // ready task set in the submission.
@@ -58,6 +101,30 @@ typedef struct iree_hal_task_command_buffer_t {
   // An empty list indicates that root_tasks are also the leaves.
   iree_task_list_t leaf_tasks;
 
+  // State used by command buffers that are not one-shot and may be issued
+  // multiple times. The recorded tasks are kept as a template that is restored
+  // in-place on each issue or, if a previous issue is still in-flight, cloned
+  // into the submission arena (copy-on-submit).
+  struct {
+    // All recorded tasks in reverse recording order. Only valid while
+    // recording.
+    iree_hal_task_command_buffer_record_t* record_head;
+    iree_host_size_t record_count;
+
+    // Flattened task table built when recording ends.
+    iree_host_size_t task_count;
+    iree_hal_task_command_buffer_template_t* tasks;
+
+    // Indices into |tasks| of the DAG roots and leaves.
+    iree_host_size_t root_count;
+    uint32_t* root_indices;
+    iree_host_size_t leaf_count;
+    uint32_t* leaf_indices;
+
+    // 1 when the live tasks have been issued in-place and not yet retired.
+    iree_atomic_int32_t in_flight;
+  } reusable;
+
   // TODO(benvanik): move this out of the struct and allocate from the arena -
   // we only need this during recording and it's ~4KB of waste otherwise.
   // State tracked within the command buffer during recording only.
@@ -77,6 +144,22 @@ typedef struct iree_hal_task_command_buffer_t {
     // All execution tasks emitted that must execute after |open_barrier|.
     iree_task_list_t open_tasks;
 
+    // Tasks in the current synchronization scope that are not forked from
+    // |open_barrier| but must complete before the next barrier, such as the
+    // tasks marking event signals and waits.
+    iree_task_list_t join_tasks;
+
+    // The barrier forking out to all tasks recorded after the most recent
+    // wait_events in the current scope, if any. As with |open_barrier| the
+    // dependent tasks are only assigned when the wait is closed. The tasks
+    // after |open_wait_tail| in |open_tasks| (or all if NULL) are the
+    // dependents.
+    iree_task_barrier_t* open_wait;
+    iree_task_t* open_wait_tail;
+
+    // Events signaled within the command buffer, most recent first.
+    iree_hal_task_command_buffer_event_t* events;
+
     // A flattened list of all available descriptor set bindings.
     // As descriptor sets are pushed/bound the bindings will be updated to
     // represent the fully-translated binding data pointer.
@@ -112,20 +195,6 @@ iree_status_t iree_hal_task_command_buffer_create(
     iree_hal_command_buffer_t** out_command_buffer) {
   IREE_ASSERT_ARGUMENT(out_command_buffer);
   *out_command_buffer = NULL;
-  if (!iree_all_bits_set(mode, IREE_HAL_COMMAND_BUFFER_MODE_ONE_SHOT)) {
-    // If we want reuse we'd need to support duplicating the task DAG after
-    // recording or have some kind of copy-on-submit behavior that does so if
-    // a command buffer is submitted for execution twice. Allowing for the same
-    // command buffer to be enqueued multiple times would be fine so long as
-    // execution doesn't overlap (`cmdbuf|cmdbuf` vs
-    // `cmdbuf -> semaphore -> cmdbuf`) though we'd still need to be careful
-    // that we did the enqueuing and reset of the task structures at the right
-    // times. Definitely something that'll be useful in the future... but not
-    // today :)
-    return iree_make_status(IREE_STATUS_UNIMPLEMENTED,
-                            "only one-shot command buffer usage is supported");
-  }
-
   IREE_TRACE_ZONE_BEGIN(z0);
 
   iree_hal_task_command_buffer_t* command_buffer = NULL;
@@ -140,9 +209,12 @@ iree_status_t iree_hal_task_command_buffer_create(
     command_buffer->allowed_categories = command_categories;
     command_buffer->queue_affinity = queue_affinity;
     iree_arena_initialize(block_pool, &command_buffer->arena);
+    memset(&command_buffer->statistics, 0,
+           sizeof(command_buffer->statistics));
     iree_task_list_initialize(&command_buffer->root_tasks);
     iree_task_list_initialize(&command_buffer->leaf_tasks);
     memset(&command_buffer->state, 0, sizeof(command_buffer->state));
+    memset(&command_buffer->reusable, 0, sizeof(command_buffer->reusable));
     *out_command_buffer = (iree_hal_command_buffer_t*)command_buffer;
   }
 
@@ -150,8 +222,35 @@ iree_status_t iree_hal_task_command_buffer_create(
   return status;
 }
 
+// Returns true if the command buffer may be issued multiple times.
+static bool iree_hal_task_command_buffer_is_reusable(
+    const iree_hal_task_command_buffer_t* command_buffer) {
+  return !iree_all_bits_set(command_buffer->mode,
+                            IREE_HAL_COMMAND_BUFFER_MODE_ONE_SHOT);
+}
+
+bool iree_hal_task_command_buffer_isa(
+    iree_hal_command_buffer_t* command_buffer) {
+  return iree_hal_resource_is(command_buffer,
+                              &iree_hal_task_command_buffer_vtable);
+}
+
+iree_task_dispatch_statistics_t iree_hal_task_command_buffer_consume_statistics(
+    iree_hal_command_buffer_t* base_command_buffer) {
+  iree_hal_task_command_buffer_t* command_buffer =
+      iree_hal_task_command_buffer_cast(base_command_buffer);
+  iree_task_dispatch_statistics_t result = command_buffer->statistics;
+  memset(&command_buffer->statistics, 0, sizeof(command_buffer->statistics));
+  return result;
+}
+
 static void iree_hal_task_command_buffer_reset(
     iree_hal_task_command_buffer_t* command_buffer) {
+  // NOTE: the command buffer must not be in-flight; the HAL requires that
+  // command buffers are not reset or released while executing.
+  IREE_ASSERT_EQ(0, iree_atomic_load_int32(&command_buffer->reusable.in_flight,
+                                           iree_memory_order_acquire));
+  memset(&command_buffer->reusable, 0, sizeof(command_buffer->reusable));
   memset(&command_buffer->state, 0, sizeof(command_buffer->state));
   iree_task_list_discard(&command_buffer->leaf_tasks);
   iree_task_list_discard(&command_buffer->root_tasks);
@@ -190,6 +289,8 @@ iree_hal_task_command_buffer_allowed_categories(
 
 static iree_status_t iree_hal_task_command_buffer_flush_tasks(
     iree_hal_task_command_buffer_t* command_buffer);
+static iree_status_t iree_hal_task_command_buffer_build_templates(
+    iree_hal_task_command_buffer_t* command_buffer);
 
 static iree_status_t iree_hal_task_command_buffer_begin(
     iree_hal_command_buffer_t* base_command_buffer) {
@@ -216,6 +317,64 @@ static iree_status_t iree_hal_task_command_buffer_end(
                         &command_buffer->root_tasks);
   }
 
+  // Snapshot the recorded DAG so that it can be issued multiple times.
+  if (iree_hal_task_command_buffer_is_reusable(command_buffer)) {
+    IREE_RETURN_IF_ERROR(
+        iree_hal_task_command_buffer_build_templates(command_buffer));
+  }
+
+  return iree_ok_status();
+}
+
+// Sets |join_task| as the completion task of all tasks in |list| that have not
+// yet been joined into another task. Tasks that have been joined (such as those
+// recorded prior to an event signal) complete before their join task does and
+// need no additional edge. Returns true if any task was joined.
+static bool iree_hal_task_command_buffer_join_list(iree_task_list_t* list,
+                                                   iree_task_t* join_task) {
+  bool any_joined = false;
+  for (iree_task_t* task = iree_task_list_front(list); task != NULL;
+       task = task->next_task) {
+    if (task->completion_task) continue;
+    iree_task_set_completion_task(task, join_task);
+    any_joined = true;
+  }
+  return any_joined;
+}
+
+// Closes the open wait (if any) by assigning all tasks recorded after it as its
+// dependents. |next_wait| is an optional subsequent wait that must also be
+// ordered after the open wait.
+static iree_status_t iree_hal_task_command_buffer_close_wait(
+    iree_hal_task_command_buffer_t* command_buffer,
+    iree_task_barrier_t* next_wait) {
+  iree_task_barrier_t* open_wait = command_buffer->state.open_wait;
+  if (open_wait == NULL) return iree_ok_status();
+
+  iree_task_t* task_head =
+      command_buffer->state.open_wait_tail
+          ? command_buffer->state.open_wait_tail->next_task
+          : iree_task_list_front(&command_buffer->state.open_tasks);
+  iree_host_size_t dependent_task_count = next_wait ? 1 : 0;
+  for (iree_task_t* task = task_head; task != NULL; task = task->next_task) {
+    ++dependent_task_count;
+  }
+  if (dependent_task_count > 0) {
+    iree_task_t** dependent_tasks = NULL;
+    IREE_RETURN_IF_ERROR(iree_arena_allocate(
+        &command_buffer->arena, dependent_task_count * sizeof(iree_task_t*),
+        (void**)&dependent_tasks));
+    iree_host_size_t i = 0;
+    for (iree_task_t* task = task_head; task != NULL; task = task->next_task) {
+      dependent_tasks[i++] = task;
+    }
+    if (next_wait) dependent_tasks[i++] = &next_wait->header;
+    iree_task_barrier_set_dependent_tasks(open_wait, dependent_task_count,
+                                          dependent_tasks);
+  }
+
+  command_buffer->state.open_wait = NULL;
+  command_buffer->state.open_wait_tail = NULL;
   return iree_ok_status();
 }
 
@@ -226,6 +385,10 @@ static iree_status_t iree_hal_task_command_buffer_end(
 // tasks that will be recorded after (if any).
 static iree_status_t iree_hal_task_command_buffer_flush_tasks(
     iree_hal_task_command_buffer_t* command_buffer) {
+  // Fork the open wait (if any) out to the tasks recorded after it.
+  IREE_RETURN_IF_ERROR(
+      iree_hal_task_command_buffer_close_wait(command_buffer, NULL));
+
   iree_task_barrier_t* open_barrier = command_buffer->state.open_barrier;
   if (open_barrier != NULL) {
     // There is an open barrier we need to fixup the fork out to all of the open
@@ -264,7 +427,27 @@ static iree_status_t iree_hal_task_command_buffer_flush_tasks(
                         &command_buffer->leaf_tasks);
     command_buffer->state.open_task_count = 0;
   }
+  iree_task_list_append(&command_buffer->leaf_tasks,
+                        &command_buffer->state.join_tasks);
+
+  return iree_ok_status();
+}
 
+// Tracks |task| as part of the recorded DAG if the command buffer is reusable.
+// All tasks recorded must be tracked so that they can be restored or cloned
+// when the command buffer is issued.
+static iree_status_t iree_hal_task_command_buffer_track_task(
+    iree_hal_task_command_buffer_t* command_buffer, iree_task_t* task) {
+  if (!iree_hal_task_command_buffer_is_reusable(command_buffer)) {
+    return iree_ok_status();
+  }
+  iree_hal_task_command_buffer_record_t* record = NULL;
+  IREE_RETURN_IF_ERROR(iree_arena_allocate(
+      &command_buffer->arena, sizeof(*record), (void**)&record));
+  record->next = command_buffer->reusable.record_head;
+  record->task = task;
+  command_buffer->reusable.record_head = record;
+  ++command_buffer->reusable.record_count;
   return iree_ok_status();
 }
 
@@ -290,12 +473,12 @@ static iree_status_t iree_hal_task_command_buffer_emit_global_barrier(
   IREE_RETURN_IF_ERROR(iree_arena_allocate(&command_buffer->arena,
                                            sizeof(*barrier), (void**)&barrier));
   iree_task_barrier_initialize_empty(command_buffer->scope, barrier);
+  IREE_RETURN_IF_ERROR(iree_hal_task_command_buffer_track_task(
+      command_buffer, &barrier->header));
 
   // If there were previous tasks then join them to the barrier.
-  for (iree_task_t* task = iree_task_list_front(&command_buffer->leaf_tasks);
-       task != NULL; task = task->next_task) {
-    iree_task_set_completion_task(task, &barrier->header);
-  }
+  iree_hal_task_command_buffer_join_list(&command_buffer->leaf_tasks,
+                                         &barrier->header);
 
   // Move the tasks from the leaf list (tail) to the root list (head) if this
   // was the first set of tasks recorded.
@@ -322,6 +505,16 @@ static iree_status_t iree_hal_task_command_buffer_emit_global_barrier(
 // scope (after state.open_barrier and before the next barrier).
 static iree_status_t iree_hal_task_command_buffer_emit_execution_task(
     iree_hal_task_command_buffer_t* command_buffer, iree_task_t* task) {
+#if IREE_TASK_DISPATCH_STATISTICS_ENABLE
+  // Attribute dispatch statistics to the command buffer. Reusable command
+  // buffers snapshot this so that clones report here as well.
+  if (task->type == IREE_TASK_TYPE_DISPATCH) {
+    ((iree_task_dispatch_t*)task)->parent_statistics =
+        &command_buffer->statistics;
+  }
+#endif  // IREE_TASK_DISPATCH_STATISTICS_ENABLE
+  IREE_RETURN_IF_ERROR(
+      iree_hal_task_command_buffer_track_task(command_buffer, task));
   if (command_buffer->state.open_barrier == NULL) {
     // If there is no open barrier then we are at the head and going right into
     // the task DAG.
@@ -334,6 +527,332 @@ static iree_status_t iree_hal_task_command_buffer_emit_execution_task(
   return iree_ok_status();
 }
 
+//===----------------------------------------------------------------------===//
+// iree_hal_task_command_buffer_t reusable templates
+//===----------------------------------------------------------------------===//
+
+// Returns the size in bytes of the task structure for the task |type|.
+// Only task types that may be recorded into a command buffer are supported.
+static iree_host_size_t iree_hal_task_command_buffer_task_size(
+    iree_task_type_t type) {
+  switch (type) {
+    case IREE_TASK_TYPE_NOP:
+      return sizeof(iree_task_nop_t);
+    case IREE_TASK_TYPE_CALL:
+      return sizeof(iree_task_call_t);
+    case IREE_TASK_TYPE_BARRIER:
+      return sizeof(iree_task_barrier_t);
+    case IREE_TASK_TYPE_DISPATCH:
+      return sizeof(iree_task_dispatch_t);
+    default:
+      return 0;
+  }
+}
+
+typedef struct iree_hal_task_command_buffer_task_index_t {
+  const iree_task_t* task;
+  uint32_t index;
+} iree_hal_task_command_buffer_task_index_t;
+
+static int iree_hal_task_command_buffer_task_index_cmp(const void* lhs_ptr,
+                                                       const void* rhs_ptr) {
+  uintptr_t lhs =
+      (uintptr_t)((const iree_hal_task_command_buffer_task_index_t*)lhs_ptr)
+          ->task;
+  uintptr_t rhs =
+      (uintptr_t)((const iree_hal_task_command_buffer_task_index_t*)rhs_ptr)
+          ->task;
+  return lhs < rhs ? -1 : (lhs > rhs ? 1 : 0);
+}
+
+// Returns the index of |task| in the sorted |task_map| or UINT32_MAX if the
+// task is not part of the command buffer.
+static uint32_t iree_hal_task_command_buffer_lookup_task_index(
+    const iree_hal_task_command_buffer_task_index_t* task_map,
+    iree_host_size_t task_count, const iree_task_t* task) {
+  if (!task) return UINT32_MAX;
+  iree_hal_task_command_buffer_task_index_t key = {task, 0};
+  const iree_hal_task_command_buffer_task_index_t* entry =
+      (const iree_hal_task_command_buffer_task_index_t*)bsearch(
+          &key, task_map, task_count, sizeof(*task_map),
+          iree_hal_task_command_buffer_task_index_cmp);
+  return entry ? entry->index : UINT32_MAX;
+}
+
+// Populates an index list from the tasks in |list|. If |unjoined_only| is set
+// then tasks that already have a completion task are skipped.
+static iree_status_t iree_hal_task_command_buffer_build_index_list(
+    iree_hal_task_command_buffer_t* command_buffer,
+    const iree_hal_task_command_buffer_task_index_t* task_map,
+    iree_host_size_t task_count, iree_task_list_t* list, bool unjoined_only,
+    iree_host_size_t* out_count, uint32_t** out_indices) {
+  iree_host_size_t count = 0;
+  for (iree_task_t* task = iree_task_list_front(list); task != NULL;
+       task = task->next_task) {
+    if (!unjoined_only || !task->completion_task) ++count;
+  }
+  uint32_t* indices = NULL;
+  if (count > 0) {
+    IREE_RETURN_IF_ERROR(iree_arena_allocate(
+        &command_buffer->arena, count * sizeof(*indices), (void**)&indices));
+  }
+  iree_host_size_t i = 0;
+  for (iree_task_t* task = iree_task_list_front(list); task != NULL;
+       task = task->next_task) {
+    if (unjoined_only && task->completion_task) continue;
+    indices[i++] = iree_hal_task_command_buffer_lookup_task_index(
+        task_map, task_count, task);
+  }
+  *out_count = count;
+  *out_indices = indices;
+  return iree_ok_status();
+}
+
+// Builds the reusable task table from the tasks recorded into the command
+// buffer. Each task has its initial state snapshotted so that it can be
+// restored prior to being issued again and its dependency edges are translated
+// into table indices so that the DAG can be cloned when issues overlap.
+static iree_status_t iree_hal_task_command_buffer_build_templates(
+    iree_hal_task_command_buffer_t* command_buffer) {
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  iree_host_size_t task_count = command_buffer->reusable.record_count;
+  command_buffer->reusable.task_count = 0;
+  if (task_count == 0) {
+    IREE_TRACE_ZONE_END(z0);
+    return iree_ok_status();
+  }
+
+  // Flatten the records into the table in recording order.
+  iree_hal_task_command_buffer_template_t* tasks = NULL;
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0, iree_arena_allocate(&command_buffer->arena,
+                              task_count * sizeof(*tasks), (void**)&tasks));
+  iree_host_size_t i = task_count;
+  for (iree_hal_task_command_buffer_record_t* record =
+           command_buffer->reusable.record_head;
+       record != NULL; record = record->next) {
+    --i;
+    tasks[i].task = record->task;
+    tasks[i].task_size =
+        iree_hal_task_command_buffer_task_size(record->task->type);
+    IREE_ASSERT(tasks[i].task_size > 0);
+  }
+  command_buffer->reusable.record_head = NULL;
+  command_buffer->reusable.record_count = 0;
+
+  // Sorted task pointer -> index map used only while building the table. We
+  // use the host allocator as this can be large and is immediately discarded.
+  iree_hal_task_command_buffer_task_index_t* task_map = NULL;
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0,
+      iree_allocator_malloc(command_buffer->host_allocator,
+                            task_count * sizeof(*task_map), (void**)&task_map));
+  for (i = 0; i < task_count; ++i) {
+    task_map[i].task = tasks[i].task;
+    task_map[i].index = (uint32_t)i;
+  }
+  qsort(task_map, task_count, sizeof(*task_map),
+        iree_hal_task_command_buffer_task_index_cmp);
+
+  iree_status_t status = iree_ok_status();
+  for (i = 0; i < task_count && iree_status_is_ok(status); ++i) {
+    iree_hal_task_command_buffer_template_t* entry = &tasks[i];
+    entry->completion_index = iree_hal_task_command_buffer_lookup_task_index(
+        task_map, task_count, entry->task->completion_task);
+    entry->dependent_count = 0;
+    entry->dependent_indices = NULL;
+    if (entry->task->type == IREE_TASK_TYPE_BARRIER) {
+      iree_task_barrier_t* barrier = (iree_task_barrier_t*)entry->task;
+      uint32_t* dependent_indices = NULL;
+      if (barrier->dependent_task_count > 0) {
+        status = iree_arena_allocate(
+            &command_buffer->arena,
+            barrier->dependent_task_count * sizeof(*dependent_indices),
+            (void**)&dependent_indices);
+      }
+      for (iree_host_size_t j = 0;
+           j < barrier->dependent_task_count && iree_status_is_ok(status);
+           ++j) {
+        dependent_indices[j] = iree_hal_task_command_buffer_lookup_task_index(
+            task_map, task_count, barrier->dependent_tasks[j]);
+      }
+      entry->dependent_count = (uint32_t)barrier->dependent_task_count;
+      entry->dependent_indices = dependent_indices;
+    }
+
+    // Snapshot the pristine task state.
+    void* pristine = NULL;
+    if (iree_status_is_ok(status)) {
+      status = iree_arena_allocate(&command_buffer->arena, entry->task_size,
+                                   &pristine);
+    }
+    if (iree_status_is_ok(status)) {
+      memcpy(pristine, entry->task, entry->task_size);
+      entry->pristine = (const iree_task_t*)pristine;
+    }
+  }
+
+  // Roots and leaves; if there are no leaves then the roots are the leaves.
+  if (iree_status_is_ok(status)) {
+    status = iree_hal_task_command_buffer_build_index_list(
+        command_buffer, task_map, task_count, &command_buffer->root_tasks,
+        /*unjoined_only=*/false, &command_buffer->reusable.root_count,
+        &command_buffer->reusable.root_indices);
+  }
+  if (iree_status_is_ok(status)) {
+    iree_task_list_t* leaf_list =
+        iree_task_list_is_empty(&command_buffer->leaf_tasks)
+            ? &command_buffer->root_tasks
+            : &command_buffer->leaf_tasks;
+    status = iree_hal_task_command_buffer_build_index_list(
+        command_buffer, task_map, task_count, leaf_list,
+        /*unjoined_only=*/true, &command_buffer->reusable.leaf_count,
+        &command_buffer->reusable.leaf_indices);
+  }
+
+  iree_allocator_free(command_buffer->host_allocator, task_map);
+  if (iree_status_is_ok(status)) {
+    command_buffer->reusable.tasks = tasks;
+    command_buffer->reusable.task_count = task_count;
+  }
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
+// Nop task joining all leaves of an in-place issue of a reusable command
+// buffer. When it retires the live tasks are no longer in use and the next
+// issue can reuse them directly.
+typedef struct iree_hal_task_command_buffer_join_t {
+  iree_task_nop_t task;
+  iree_hal_task_command_buffer_t* command_buffer;
+} iree_hal_task_command_buffer_join_t;
+
+static void iree_hal_task_command_buffer_join_cleanup(iree_task_t* task,
+                                                      iree_status_t status) {
+  iree_hal_task_command_buffer_join_t* join =
+      (iree_hal_task_command_buffer_join_t*)task;
+  iree_atomic_store_int32(&join->command_buffer->reusable.in_flight, 0,
+                          iree_memory_order_release);
+}
+
+// Issues the live recorded tasks after restoring them to their pristine state.
+// Must only be called when no prior issue of the command buffer is in-flight.
+static iree_status_t iree_hal_task_command_buffer_issue_in_place(
+    iree_hal_task_command_buffer_t* command_buffer,
+    iree_hal_task_command_buffer_join_t* join,
+    iree_task_submission_t* pending_submission) {
+  const iree_hal_task_command_buffer_template_t* tasks =
+      command_buffer->reusable.tasks;
+  for (iree_host_size_t i = 0; i < command_buffer->reusable.task_count; ++i) {
+    memcpy(tasks[i].task, tasks[i].pristine, tasks[i].task_size);
+  }
+
+  // Chain all leaves to the join so we know when the tasks can be reused.
+  for (iree_host_size_t i = 0; i < command_buffer->reusable.leaf_count; ++i) {
+    iree_task_set_completion_task(
+        tasks[command_buffer->reusable.leaf_indices[i]].task,
+        &join->task.header);
+  }
+
+  iree_task_list_t root_tasks;
+  iree_task_list_initialize(&root_tasks);
+  for (iree_host_size_t i = 0; i < command_buffer->reusable.root_count; ++i) {
+    iree_task_list_push_back(
+        &root_tasks, tasks[command_buffer->reusable.root_indices[i]].task);
+  }
+  iree_task_submission_enqueue_list(pending_submission, &root_tasks);
+  return iree_ok_status();
+}
+
+// Clones the recorded tasks into |arena| and issues the clones. Used when a
+// prior issue of the command buffer is still in-flight and the live tasks
+// cannot be reused.
+static iree_status_t iree_hal_task_command_buffer_issue_clone(
+    iree_hal_task_command_buffer_t* command_buffer, iree_task_t* retire_task,
+    iree_arena_allocator_t* arena, iree_task_submission_t* pending_submission) {
+  IREE_TRACE_ZONE_BEGIN(z0);
+  const iree_hal_task_command_buffer_template_t* tasks =
+      command_buffer->reusable.tasks;
+  iree_host_size_t task_count = command_buffer->reusable.task_count;
+
+  iree_task_t** clones = NULL;
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0, iree_arena_allocate(arena, task_count * sizeof(*clones),
+                              (void**)&clones));
+  for (iree_host_size_t i = 0; i < task_count; ++i) {
+    IREE_RETURN_AND_END_ZONE_IF_ERROR(
+        z0, iree_arena_allocate(arena, tasks[i].task_size, (void**)&clones[i]));
+    memcpy(clones[i], tasks[i].pristine, tasks[i].task_size);
+  }
+
+  // Rewire the dependency edges to point at the clones.
+  for (iree_host_size_t i = 0; i < task_count; ++i) {
+    iree_task_t* clone = clones[i];
+    clone->completion_task = tasks[i].completion_index != UINT32_MAX
+                                 ? clones[tasks[i].completion_index]
+                                 : NULL;
+    if (clone->type == IREE_TASK_TYPE_BARRIER) {
+      iree_task_t** dependent_tasks = NULL;
+      if (tasks[i].dependent_count > 0) {
+        IREE_RETURN_AND_END_ZONE_IF_ERROR(
+            z0, iree_arena_allocate(
+                    arena, tasks[i].dependent_count * sizeof(*dependent_tasks),
+                    (void**)&dependent_tasks));
+      }
+      for (uint32_t j = 0; j < tasks[i].dependent_count; ++j) {
+        dependent_tasks[j] = clones[tasks[i].dependent_indices[j]];
+      }
+      ((iree_task_barrier_t*)clone)->dependent_tasks = dependent_tasks;
+    }
+  }
+
+  for (iree_host_size_t i = 0; i < command_buffer->reusable.leaf_count; ++i) {
+    iree_task_set_completion_task(
+        clones[command_buffer->reusable.leaf_indices[i]], retire_task);
+  }
+
+  iree_task_list_t root_tasks;
+  iree_task_list_initialize(&root_tasks);
+  for (iree_host_size_t i = 0; i < command_buffer->reusable.root_count; ++i) {
+    iree_task_list_push_back(&root_tasks,
+                             clones[command_buffer->reusable.root_indices[i]]);
+  }
+  iree_task_submission_enqueue_list(pending_submission, &root_tasks);
+
+  IREE_TRACE_ZONE_END(z0);
+  return iree_ok_status();
+}
+
+// Issues a reusable command buffer either in-place or as a clone.
+static iree_status_t iree_hal_task_command_buffer_issue_reusable(
+    iree_hal_task_command_buffer_t* command_buffer, iree_task_t* retire_task,
+    iree_arena_allocator_t* arena, iree_task_submission_t* pending_submission) {
+  // If the command buffer is empty (valid!) then we are a no-op.
+  if (command_buffer->reusable.task_count == 0) return iree_ok_status();
+
+  // Allocate the join prior to claiming the live tasks so that we don't need
+  // to unwind on failure.
+  iree_hal_task_command_buffer_join_t* join = NULL;
+  IREE_RETURN_IF_ERROR(
+      iree_arena_allocate(arena, sizeof(*join), (void**)&join));
+  iree_task_nop_initialize(command_buffer->scope, &join->task);
+  iree_task_set_cleanup_fn(&join->task.header,
+                           iree_hal_task_command_buffer_join_cleanup);
+  join->command_buffer = command_buffer;
+
+  int32_t expected = 0;
+  if (iree_atomic_compare_exchange_strong_int32(
+          &command_buffer->reusable.in_flight, &expected, 1,
+          iree_memory_order_acq_rel, iree_memory_order_relaxed)) {
+    iree_task_set_completion_task(&join->task.header, retire_task);
+    return iree_hal_task_command_buffer_issue_in_place(command_buffer, join,
+                                                       pending_submission);
+  }
+  return iree_hal_task_command_buffer_issue_clone(command_buffer, retire_task,
+                                                  arena, pending_submission);
+}
+
 //===----------------------------------------------------------------------===//
 // iree_hal_task_command_buffer_t execution
 //===----------------------------------------------------------------------===//
@@ -345,6 +864,12 @@ iree_status_t iree_hal_task_command_buffer_issue(
   iree_hal_task_command_buffer_t* command_buffer =
       iree_hal_task_command_buffer_cast(base_command_buffer);
 
+  // Reusable command buffers keep their recorded tasks as a template.
+  if (iree_hal_task_command_buffer_is_reusable(command_buffer)) {
+    return iree_hal_task_command_buffer_issue_reusable(
+        command_buffer, retire_task, arena, pending_submission);
+  }
+
   // If the command buffer is empty (valid!) then we are a no-op.
   bool has_root_tasks = !iree_task_list_is_empty(&command_buffer->root_tasks);
   if (!has_root_tasks) {
@@ -355,17 +880,13 @@ iree_status_t iree_hal_task_command_buffer_issue(
   if (has_leaf_tasks) {
     // Chain the retire task onto the leaf tasks as their completion indicates
     // that all commands have completed.
-    for (iree_task_t* task = command_buffer->leaf_tasks.head; task != NULL;
-         task = task->next_task) {
-      iree_task_set_completion_task(task, retire_task);
-    }
+    iree_hal_task_command_buffer_join_list(&command_buffer->leaf_tasks,
+                                           retire_task);
   } else {
     // If we have no leaf tasks it means that this is a single layer DAG and
     // after the root tasks complete the entire command buffer has completed.
-    for (iree_task_t* task = command_buffer->root_tasks.head; task != NULL;
-         task = task->next_task) {
-      iree_task_set_completion_task(task, retire_task);
-    }
+    iree_hal_task_command_buffer_join_list(&command_buffer->root_tasks,
+                                           retire_task);
   }
 
   // Enqueue all root tasks that are ready to run immediately.
@@ -399,6 +920,84 @@ static iree_status_t iree_hal_task_command_buffer_execution_barrier(
   return iree_hal_task_command_buffer_emit_global_barrier(command_buffer);
 }
 
+//===----------------------------------------------------------------------===//
+// Events
+//===----------------------------------------------------------------------===//
+// Events are implemented as edges in the recorded task DAG and are only
+// meaningful within a single command buffer. A signal inserts a barrier task
+// joining all tasks recorded in the current synchronization scope and a wait
+// inserts a barrier task that depends on the signals of all events waited on
+// and forks out to all tasks recorded after it. Unlike a global barrier this
+// only orders tasks recorded after the wait against those recorded before the
+// signals: tasks recorded between the two can still run concurrently.
+//
+// Waits on events not signaled within the command buffer (such as those
+// signaled by the host or another command buffer) cannot be tracked as DAG
+// edges and conservatively fall back to a global barrier.
+
+// Ensures that there is an open barrier that all subsequently recorded tasks
+// fork from. Event signals and waits need a task to fork from so that they
+// can be ordered without turning recorded tasks into roots. If no barrier has
+// been recorded yet then all tasks recorded so far (the roots) are moved to
+// a new head barrier.
+static iree_status_t iree_hal_task_command_buffer_ensure_open_barrier(
+    iree_hal_task_command_buffer_t* command_buffer) {
+  if (command_buffer->state.open_barrier != NULL) return iree_ok_status();
+  IREE_ASSERT(iree_task_list_is_empty(&command_buffer->root_tasks));
+
+  iree_task_barrier_t* barrier = NULL;
+  IREE_RETURN_IF_ERROR(iree_arena_allocate(&command_buffer->arena,
+                                           sizeof(*barrier), (void**)&barrier));
+  iree_task_barrier_initialize_empty(command_buffer->scope, barrier);
+  IREE_RETURN_IF_ERROR(iree_hal_task_command_buffer_track_task(
+      command_buffer, &barrier->header));
+  iree_task_list_push_back(&command_buffer->root_tasks, &barrier->header);
+
+  command_buffer->state.open_task_count =
+      iree_task_list_calculate_size(&command_buffer->leaf_tasks);
+  iree_task_list_move(&command_buffer->leaf_tasks,
+                      &command_buffer->state.open_tasks);
+  command_buffer->state.open_barrier = barrier;
+  return iree_ok_status();
+}
+
+// Returns the event record for |event| or NULL if it has not been signaled
+// within the command buffer.
+static iree_hal_task_command_buffer_event_t*
+iree_hal_task_command_buffer_find_event(
+    iree_hal_task_command_buffer_t* command_buffer,
+    const iree_hal_event_t* event) {
+  for (iree_hal_task_command_buffer_event_t* record =
+           command_buffer->state.events;
+       record != NULL; record = record->next) {
+    if (record->event == event) return record;
+  }
+  return NULL;
+}
+
+// Adds |wait_task| as a dependent of the event |signal_task|.
+// Event signals may be waited on any number of times so the dependent list is
+// grown for each wait.
+static iree_status_t iree_hal_task_command_buffer_add_event_dependent(
+    iree_hal_task_command_buffer_t* command_buffer,
+    iree_task_barrier_t* signal_task, iree_task_barrier_t* wait_task) {
+  iree_host_size_t dependent_task_count = signal_task->dependent_task_count;
+  iree_task_t** dependent_tasks = NULL;
+  IREE_RETURN_IF_ERROR(iree_arena_allocate(
+      &command_buffer->arena, (dependent_task_count + 1) * sizeof(iree_task_t*),
+      (void**)&dependent_tasks));
+  if (dependent_task_count > 0) {
+    memcpy(dependent_tasks, signal_task->dependent_tasks,
+           dependent_task_count * sizeof(iree_task_t*));
+  }
+  dependent_tasks[dependent_task_count] = &wait_task->header;
+  signal_task->dependent_tasks = dependent_tasks;
+  signal_task->dependent_task_count = dependent_task_count + 1;
+  iree_atomic_fetch_add_int32(&wait_task->header.pending_dependency_count, 1,
+                              iree_memory_order_relaxed);
+  return iree_ok_status();
+}
+
 //===----------------------------------------------------------------------===//
 // iree_hal_command_buffer_signal_event
 //===----------------------------------------------------------------------===//
@@ -406,7 +1005,45 @@ static iree_status_t iree_hal_task_command_buffer_execution_barrier(
 static iree_status_t iree_hal_task_command_buffer_signal_event(
     iree_hal_command_buffer_t* base_command_buffer, iree_hal_event_t* event,
     iree_hal_execution_stage_t source_stage_mask) {
-  // TODO(#4518): implement events. For now we just insert global barriers.
+  iree_hal_task_command_buffer_t* command_buffer =
+      iree_hal_task_command_buffer_cast(base_command_buffer);
+  IREE_RETURN_IF_ERROR(
+      iree_hal_task_command_buffer_ensure_open_barrier(command_buffer));
+
+  iree_hal_task_command_buffer_event_t* record =
+      iree_hal_task_command_buffer_find_event(command_buffer, event);
+  if (record == NULL) {
+    IREE_RETURN_IF_ERROR(iree_arena_allocate(
+        &command_buffer->arena, sizeof(*record), (void**)&record));
+    record->event = event;
+    record->next = command_buffer->state.events;
+    command_buffer->state.events = record;
+  }
+
+  iree_task_barrier_t* signal_task = NULL;
+  IREE_RETURN_IF_ERROR(iree_arena_allocate(
+      &command_buffer->arena, sizeof(*signal_task), (void**)&signal_task));
+  iree_task_barrier_initialize_empty(command_buffer->scope, signal_task);
+  IREE_RETURN_IF_ERROR(iree_hal_task_command_buffer_track_task(
+      command_buffer, &signal_task->header));
+  record->signal_task = signal_task;
+
+  // Join all tasks recorded in the current scope. Tasks from prior scopes are
+  // transitively joined as the current scope forks from the open barrier.
+  bool any_joined = iree_hal_task_command_buffer_join_list(
+      &command_buffer->state.open_tasks, &signal_task->header);
+  any_joined |= iree_hal_task_command_buffer_join_list(
+      &command_buffer->state.join_tasks, &signal_task->header);
+  if (any_joined) {
+    iree_task_list_push_back(&command_buffer->state.join_tasks,
+                             &signal_task->header);
+  } else {
+    // Nothing recorded in the current scope yet so the signal happens as soon
+    // as the open barrier is reached.
+    iree_task_list_push_back(&command_buffer->state.open_tasks,
+                             &signal_task->header);
+    ++command_buffer->state.open_task_count;
+  }
   return iree_ok_status();
 }
 
@@ -417,7 +1054,12 @@ static iree_status_t iree_hal_task_command_buffer_signal_event(
 static iree_status_t iree_hal_task_command_buffer_reset_event(
     iree_hal_command_buffer_t* base_command_buffer, iree_hal_event_t* event,
     iree_hal_execution_stage_t source_stage_mask) {
-  // TODO(#4518): implement events. For now we just insert global barriers.
+  iree_hal_task_command_buffer_t* command_buffer =
+      iree_hal_task_command_buffer_cast(base_command_buffer);
+  // Subsequent waits will not find a signal and fall back to global barriers.
+  iree_hal_task_command_buffer_event_t* record =
+      iree_hal_task_command_buffer_find_event(command_buffer, event);
+  if (record) record->signal_task = NULL;
   return iree_ok_status();
 }
 
@@ -436,8 +1078,43 @@ static iree_status_t iree_hal_task_command_buffer_wait_events(
     const iree_hal_buffer_barrier_t* buffer_barriers) {
   iree_hal_task_command_buffer_t* command_buffer =
       iree_hal_task_command_buffer_cast(base_command_buffer);
-  // TODO(#4518): implement events. For now we just insert global barriers.
-  return iree_hal_task_command_buffer_emit_global_barrier(command_buffer);
+
+  // If any event was not signaled within the command buffer we can't know
+  // when it will be signaled and must wait for everything recorded so far.
+  for (iree_host_size_t i = 0; i < event_count; ++i) {
+    iree_hal_task_command_buffer_event_t* record =
+        iree_hal_task_command_buffer_find_event(command_buffer, events[i]);
+    if (!record || !record->signal_task) {
+      return iree_hal_task_command_buffer_emit_global_barrier(command_buffer);
+    }
+  }
+
+  IREE_RETURN_IF_ERROR(
+      iree_hal_task_command_buffer_ensure_open_barrier(command_buffer));
+
+  iree_task_barrier_t* wait_task = NULL;
+  IREE_RETURN_IF_ERROR(iree_arena_allocate(
+      &command_buffer->arena, sizeof(*wait_task), (void**)&wait_task));
+  iree_task_barrier_initialize_empty(command_buffer->scope, wait_task);
+  IREE_RETURN_IF_ERROR(iree_hal_task_command_buffer_track_task(
+      command_buffer, &wait_task->header));
+  for (iree_host_size_t i = 0; i < event_count; ++i) {
+    iree_hal_task_command_buffer_event_t* record =
+        iree_hal_task_command_buffer_find_event(command_buffer, events[i]);
+    IREE_RETURN_IF_ERROR(iree_hal_task_command_buffer_add_event_dependent(
+        command_buffer, record->signal_task, wait_task));
+  }
+
+  // Waits are cumulative: tasks recorded after this wait must also be ordered
+  // after any prior wait in the scope, which we get by chaining the waits.
+  IREE_RETURN_IF_ERROR(
+      iree_hal_task_command_buffer_close_wait(command_buffer, wait_task));
+  iree_task_list_push_back(&command_buffer->state.join_tasks,
+                           &wait_task->header);
+  command_buffer->state.open_wait = wait_task;
+  command_buffer->state.open_wait_tail =
+      iree_task_list_back(&command_buffer->state.open_tasks);
+  return iree_ok_status();
 }
 
 //===----------------------------------------------------------------------===//
@@ -449,15 +1126,73 @@ static iree_status_t iree_hal_task_command_buffer_discard_buffer(
   return iree_ok_status();
 }
 
+//===----------------------------------------------------------------------===//
+// Tiled transfer utilities
+//===----------------------------------------------------------------------===//
+// Large transfers are split into IREE_TASK_TRANSFER_TILE_SIZE tiles and issued
+// as a dispatch so that they can be processed by all workers in parallel.
+// Smaller transfers are performed by a single call task as the fixed cost of
+// fanning out and joining the tiles outweighs the additional bandwidth.
+
+// Task storage for transfer commands that may be either a single call or a
+// tiled dispatch. Only the variant matching the header type is valid.
+typedef union iree_hal_cmd_transfer_task_t {
+  iree_task_t header;
+  iree_task_call_t call;
+  iree_task_dispatch_t dispatch;
+} iree_hal_cmd_transfer_task_t;
+
+// Returns the number of tiles a transfer of |length| bytes should be split
+// into or 0 if the transfer should be performed by a single call task.
+static uint32_t iree_hal_cmd_transfer_tile_count(iree_device_size_t length) {
+  if (length < IREE_TASK_TRANSFER_TILING_THRESHOLD) return 0;
+  iree_device_size_t tile_count =
+      (length + IREE_TASK_TRANSFER_TILE_SIZE - 1) /
+      IREE_TASK_TRANSFER_TILE_SIZE;
+  return tile_count > UINT32_MAX ? 0 : (uint32_t)tile_count;
+}
+
+// Returns the byte range of the transfer of |length| bytes covered by the tile
+// in |tile_context|.
+static void iree_hal_cmd_transfer_tile_range(
+    const iree_task_tile_context_t* tile_context, iree_device_size_t length,
+    iree_device_size_t* out_tile_offset, iree_device_size_t* out_tile_length) {
+  iree_device_size_t tile_offset =
+      (iree_device_size_t)tile_context->workgroup_xyz[0] *
+      IREE_TASK_TRANSFER_TILE_SIZE;
+  iree_device_size_t tile_length = length - tile_offset;
+  if (tile_length > IREE_TASK_TRANSFER_TILE_SIZE) {
+    tile_length = IREE_TASK_TRANSFER_TILE_SIZE;
+  }
+  *out_tile_offset = tile_offset;
+  *out_tile_length = tile_length;
+}
+
+// Initializes |task| as either a single call to |call_fn| or a dispatch of
+// |tile_count| tiles each calling |tile_fn|.
+static void iree_hal_cmd_transfer_task_initialize(
+    iree_task_scope_t* scope, uint32_t tile_count,
+    iree_task_call_closure_fn_t call_fn,
+    iree_task_dispatch_closure_fn_t tile_fn, uintptr_t user_context,
+    iree_hal_cmd_transfer_task_t* task) {
+  if (tile_count == 0) {
+    iree_task_call_initialize(
+        scope, iree_task_make_call_closure(call_fn, user_context), &task->call);
+  } else {
+    const uint32_t workgroup_size[3] = {1, 1, 1};
+    const uint32_t workgroup_count[3] = {tile_count, 1, 1};
+    iree_task_dispatch_initialize(
+        scope, iree_task_make_dispatch_closure(tile_fn, user_context),
+        workgroup_size, workgroup_count, &task->dispatch);
+  }
+}
+
 //===----------------------------------------------------------------------===//
 // iree_hal_command_buffer_fill_buffer
 //===----------------------------------------------------------------------===//
-// NOTE: for large fills we could dispatch this as tiles for parallelism.
-// We'd want to do some measurement for when it's worth it; filling a 200KB
-// buffer: maybe not, filling a 200MB buffer: yeah.
 
 typedef struct iree_hal_cmd_fill_buffer_t {
-  iree_task_call_t task;
+  iree_hal_cmd_transfer_task_t task;
   iree_hal_buffer_t* target_buffer;
   iree_device_size_t target_offset;
   iree_device_size_t length;
@@ -478,6 +1213,25 @@ static iree_status_t iree_hal_cmd_fill_buffer(
   return status;
 }
 
+static iree_status_t iree_hal_cmd_fill_buffer_tile(
+    uintptr_t user_context, const iree_task_tile_context_t* tile_context,
+    iree_task_submission_t* pending_submission) {
+  const iree_hal_cmd_fill_buffer_t* cmd =
+      (const iree_hal_cmd_fill_buffer_t*)user_context;
+  IREE_TRACE_ZONE_BEGIN(z0);
+  // NOTE: the tile size is a multiple of all pattern lengths so each tile
+  // starts on a pattern boundary.
+  iree_device_size_t tile_offset = 0;
+  iree_device_size_t tile_length = 0;
+  iree_hal_cmd_transfer_tile_range(tile_context, cmd->length, &tile_offset,
+                                   &tile_length);
+  iree_status_t status = iree_hal_buffer_fill(
+      cmd->target_buffer, cmd->target_offset + tile_offset, tile_length,
+      cmd->pattern, cmd->pattern_length);
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
 static iree_status_t iree_hal_task_command_buffer_fill_buffer(
     iree_hal_command_buffer_t* base_command_buffer,
     iree_hal_buffer_t* target_buffer, iree_device_size_t target_offset,
@@ -490,9 +1244,9 @@ static iree_status_t iree_hal_task_command_buffer_fill_buffer(
   IREE_RETURN_IF_ERROR(
       iree_arena_allocate(&command_buffer->arena, sizeof(*cmd), (void**)&cmd));
 
-  iree_task_call_initialize(
-      command_buffer->scope,
-      iree_task_make_call_closure(iree_hal_cmd_fill_buffer, (uintptr_t)cmd),
+  iree_hal_cmd_transfer_task_initialize(
+      command_buffer->scope, iree_hal_cmd_transfer_tile_count(length),
+      iree_hal_cmd_fill_buffer, iree_hal_cmd_fill_buffer_tile, (uintptr_t)cmd,
       &cmd->task);
   cmd->target_buffer = target_buffer;
   cmd->target_offset = target_offset;
@@ -560,12 +1314,9 @@ static iree_status_t iree_hal_task_command_buffer_update_buffer(
 //===----------------------------------------------------------------------===//
 // iree_hal_command_buffer_copy_buffer
 //===----------------------------------------------------------------------===//
-// NOTE: for large copies we could dispatch this as tiles for parallelism.
-// We'd want to do some measurement for when it's worth it; copying a 200KB
-// buffer: maybe not, copying a 200MB buffer: yeah.
 
 typedef struct iree_hal_cmd_copy_buffer_t {
-  iree_task_call_t task;
+  iree_hal_cmd_transfer_task_t task;
   iree_hal_buffer_t* source_buffer;
   iree_device_size_t source_offset;
   iree_hal_buffer_t* target_buffer;
@@ -586,6 +1337,23 @@ static iree_status_t iree_hal_cmd_copy_buffer(
   return status;
 }
 
+static iree_status_t iree_hal_cmd_copy_buffer_tile(
+    uintptr_t user_context, const iree_task_tile_context_t* tile_context,
+    iree_task_submission_t* pending_submission) {
+  const iree_hal_cmd_copy_buffer_t* cmd =
+      (const iree_hal_cmd_copy_buffer_t*)user_context;
+  IREE_TRACE_ZONE_BEGIN(z0);
+  iree_device_size_t tile_offset = 0;
+  iree_device_size_t tile_length = 0;
+  iree_hal_cmd_transfer_tile_range(tile_context, cmd->length, &tile_offset,
+                                   &tile_length);
+  iree_status_t status = iree_hal_buffer_copy_data(
+      cmd->source_buffer, cmd->source_offset + tile_offset, cmd->target_buffer,
+      cmd->target_offset + tile_offset, tile_length);
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
 static iree_status_t iree_hal_task_command_buffer_copy_buffer(
     iree_hal_command_buffer_t* base_command_buffer,
     iree_hal_buffer_t* source_buffer, iree_device_size_t source_offset,
@@ -598,9 +1366,9 @@ static iree_status_t iree_hal_task_command_buffer_copy_buffer(
   IREE_RETURN_IF_ERROR(
       iree_arena_allocate(&command_buffer->arena, sizeof(*cmd), (void**)&cmd));
 
-  iree_task_call_initialize(
-      command_buffer->scope,
-      iree_task_make_call_closure(iree_hal_cmd_copy_buffer, (uintptr_t)cmd),
+  iree_hal_cmd_transfer_task_initialize(
+      command_buffer->scope, iree_hal_cmd_transfer_tile_count(length),
+      iree_hal_cmd_copy_buffer, iree_hal_cmd_copy_buffer_tile, (uintptr_t)cmd,
       &cmd->task);
   cmd->source_buffer = source_buffer;
   cmd->source_offset = source_offset;
@@ -749,10 +1517,15 @@ static iree_status_t iree_hal_cmd_dispatch_tile(
   state.binding_lengths = (size_t*)cmd_ptr;
   cmd_ptr += cmd->binding_count * sizeof(*state.binding_lengths);
 
-  // When we support imports we can populate those here based on what the
-  // executable declared (as each executable may import a unique set of
-  // functions).
-  state.imports = NULL;
+  // Each executable may import a unique set of functions that were resolved
+  // when it was loaded.
+  state.imports = cmd->executable->imports;
+
+  // Worker-local scratch memory is exclusively owned by this tile while it
+  // executes.
+  state.processor_id = tile_context->worker_id;
+  state.local_memory_size = tile_context->local_memory.data_length;
+  state.local_memory = tile_context->local_memory.data;
 
   iree_status_t status = iree_hal_local_executable_issue_call(
       cmd->executable, cmd->ordinal, &state,
@@ -775,6 +1548,11 @@ static iree_status_t iree_hal_task_command_buffer_build_dispatch(
   iree_hal_local_executable_layout_t* local_layout =
       local_executable->executable_layouts[entry_point];
   iree_host_size_t push_constant_count = local_layout->push_constants;
+
+  // Executables with deferred preparation are prepared before their first
+  // dispatch is recorded so that workgroups never wait on preparation and so
+  // that their dispatch attributes can be used to build the dispatch task.
+  IREE_RETURN_IF_ERROR(iree_hal_local_executable_prepare(local_executable));
   iree_hal_local_binding_mask_t used_binding_mask = local_layout->used_bindings;
   iree_host_size_t used_binding_count =
       iree_math_count_ones_u64(used_binding_mask);
@@ -800,12 +1578,20 @@ static iree_status_t iree_hal_task_command_buffer_build_dispatch(
   cmd->binding_count = used_binding_count;
 
   const uint32_t workgroup_count[3] = {workgroup_x, workgroup_y, workgroup_z};
-  // TODO(benvanik): expose on API or keep fixed on executable.
-  const uint32_t workgroup_size[3] = {1, 1, 1};
+  const iree_hal_vec3_t workgroup_size =
+      iree_hal_local_executable_workgroup_size(local_executable, entry_point);
   iree_task_dispatch_initialize(command_buffer->scope,
                                 iree_task_make_dispatch_closure(
                                     iree_hal_cmd_dispatch_tile, (uintptr_t)cmd),
-                                workgroup_size, workgroup_count, &cmd->task);
+                                workgroup_size.value, workgroup_count,
+                                &cmd->task);
+
+  // Let the executable tune how workgroups are distributed across workers.
+  if (local_executable->dispatch_attrs) {
+    cmd->task.tiles_per_reservation =
+        local_executable->dispatch_attrs[entry_point]
+            .workgroups_per_reservation;
+  }
 
   // Copy only the push constant range used by the executable.
   uint8_t* cmd_ptr = (uint8_t*)cmd + sizeof(*cmd);
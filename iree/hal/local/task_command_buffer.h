@@ -25,6 +25,17 @@ iree_status_t iree_hal_task_command_buffer_create(
     iree_arena_block_pool_t* block_pool, iree_allocator_t host_allocator,
     iree_hal_command_buffer_t** out_command_buffer);
 
+// Returns true if |command_buffer| is an iree/task/-based command buffer.
+bool iree_hal_task_command_buffer_isa(
+    iree_hal_command_buffer_t* command_buffer);
+
+// Returns and resets the dispatch statistics aggregated from all dispatches
+// issued from |command_buffer| that have retired since the last query.
+// Statistics are only counted when IREE_TASK_DISPATCH_STATISTICS_ENABLE is set
+// and may experience tearing if queried while the command buffer is in-flight.
+iree_task_dispatch_statistics_t iree_hal_task_command_buffer_consume_statistics(
+    iree_hal_command_buffer_t* command_buffer);
+
 // Issues a recorded command buffer using the serial |queue_state|.
 // |queue_state| is used to track the synchronization scope of the queue from
 // prior commands such as signaled events and will be mutated as events are
@@ -0,0 +1,238 @@
+// Copyright 2021 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "iree/base/api.h"
+#include "iree/base/internal/flags.h"
+#include "iree/hal/api.h"
+#include "iree/task/api.h"
+#include "iree/task/tuning.h"
+#include "iree/testing/benchmark.h"
+
+// Benchmarks the two strategies the task command buffer uses to execute buffer
+// fill/copy commands:
+//   `untiled`: a single call task performing the whole transfer on one worker.
+//   `tiled`: a dispatch of IREE_TASK_TRANSFER_TILE_SIZE tiles across workers.
+//
+// The command buffer picks `tiled` for transfers of at least
+// IREE_TASK_TRANSFER_TILING_THRESHOLD bytes. Both strategies are run at sizes
+// on either side of the threshold so that the crossover point can be checked
+// on a particular machine. Use --task_topology_* flags to control the number
+// of workers.
+
+// Shared executor and scope used by all benchmarks.
+static iree_task_executor_t* executor = NULL;
+static iree_task_scope_t scope;
+
+typedef enum iree_hal_transfer_op_e {
+  IREE_HAL_TRANSFER_OP_FILL = 0,
+  IREE_HAL_TRANSFER_OP_COPY,
+} iree_hal_transfer_op_t;
+
+typedef struct iree_hal_transfer_t {
+  iree_hal_transfer_op_t op;
+  iree_hal_buffer_t* source_buffer;
+  iree_hal_buffer_t* target_buffer;
+  iree_device_size_t length;
+} iree_hal_transfer_t;
+
+// Performs the |length| bytes of |transfer| starting at |offset|.
+static iree_status_t iree_hal_transfer_range(
+    const iree_hal_transfer_t* transfer, iree_device_size_t offset,
+    iree_device_size_t length) {
+  if (transfer->op == IREE_HAL_TRANSFER_OP_FILL) {
+    const uint32_t pattern = 0xCDCDCDCDu;
+    return iree_hal_buffer_fill(transfer->target_buffer, offset, length,
+                                &pattern, sizeof(pattern));
+  }
+  return iree_hal_buffer_copy_data(transfer->source_buffer, offset,
+                                   transfer->target_buffer, offset, length);
+}
+
+static iree_status_t iree_hal_transfer_call(
+    uintptr_t user_context, iree_task_t* task,
+    iree_task_submission_t* pending_submission) {
+  const iree_hal_transfer_t* transfer =
+      (const iree_hal_transfer_t*)user_context;
+  return iree_hal_transfer_range(transfer, 0, transfer->length);
+}
+
+static iree_status_t iree_hal_transfer_tile(
+    uintptr_t user_context, const iree_task_tile_context_t* tile_context,
+    iree_task_submission_t* pending_submission) {
+  const iree_hal_transfer_t* transfer =
+      (const iree_hal_transfer_t*)user_context;
+  iree_device_size_t tile_offset =
+      (iree_device_size_t)tile_context->workgroup_xyz[0] *
+      IREE_TASK_TRANSFER_TILE_SIZE;
+  iree_device_size_t tile_length = transfer->length - tile_offset;
+  if (tile_length > IREE_TASK_TRANSFER_TILE_SIZE) {
+    tile_length = IREE_TASK_TRANSFER_TILE_SIZE;
+  }
+  return iree_hal_transfer_range(transfer, tile_offset, tile_length);
+}
+
+// Submits |task| to the shared executor and waits for it to complete.
+static iree_status_t iree_hal_submit_and_wait(iree_task_t* task) {
+  iree_task_fence_t* fence = NULL;
+  IREE_RETURN_IF_ERROR(
+      iree_task_executor_acquire_fence(executor, &scope, &fence));
+  iree_task_set_completion_task(task, &fence->header);
+  iree_task_submission_t submission;
+  iree_task_submission_initialize(&submission);
+  iree_task_submission_enqueue(&submission, task);
+  iree_task_executor_submit(executor, &submission);
+  iree_task_executor_flush(executor);
+  IREE_RETURN_IF_ERROR(
+      iree_task_scope_wait_idle(&scope, IREE_TIME_INFINITE_FUTURE));
+  return iree_task_scope_consume_status(&scope);
+}
+
+static iree_status_t iree_hal_transfer_benchmark_run(
+    iree_benchmark_state_t* benchmark_state, iree_hal_transfer_op_t op,
+    bool tiled, iree_device_size_t length) {
+  iree_hal_allocator_t* allocator = NULL;
+  IREE_RETURN_IF_ERROR(iree_hal_allocator_create_heap(
+      iree_make_cstring_view("benchmark"), iree_allocator_system(),
+      &allocator));
+  iree_hal_transfer_t transfer = {
+      .op = op,
+      .source_buffer = NULL,
+      .target_buffer = NULL,
+      .length = length,
+  };
+  iree_status_t status = iree_hal_allocator_allocate_buffer(
+      allocator,
+      IREE_HAL_MEMORY_TYPE_DEVICE_LOCAL | IREE_HAL_MEMORY_TYPE_HOST_VISIBLE,
+      IREE_HAL_BUFFER_USAGE_ALL, length, &transfer.source_buffer);
+  if (iree_status_is_ok(status)) {
+    status = iree_hal_allocator_allocate_buffer(
+        allocator,
+        IREE_HAL_MEMORY_TYPE_DEVICE_LOCAL | IREE_HAL_MEMORY_TYPE_HOST_VISIBLE,
+        IREE_HAL_BUFFER_USAGE_ALL, length, &transfer.target_buffer);
+  }
+
+  const uint32_t workgroup_size[3] = {1, 1, 1};
+  const uint32_t workgroup_count[3] = {
+      (uint32_t)((length + IREE_TASK_TRANSFER_TILE_SIZE - 1) /
+                 IREE_TASK_TRANSFER_TILE_SIZE),
+      1,
+      1,
+  };
+  int64_t total_bytes = 0;
+  while (iree_status_is_ok(status) &&
+         iree_benchmark_keep_running(benchmark_state, /*batch_count=*/1)) {
+    // Tasks are single-use and must be reinitialized for each submission.
+    if (tiled) {
+      iree_task_dispatch_t dispatch;
+      iree_task_dispatch_initialize(
+          &scope,
+          iree_task_make_dispatch_closure(iree_hal_transfer_tile,
+                                          (uintptr_t)&transfer),
+          workgroup_size, workgroup_count, &dispatch);
+      status = iree_hal_submit_and_wait(&dispatch.header);
+    } else {
+      iree_task_call_t call;
+      iree_task_call_initialize(
+          &scope,
+          iree_task_make_call_closure(iree_hal_transfer_call,
+                                      (uintptr_t)&transfer),
+          &call);
+      status = iree_hal_submit_and_wait(&call.header);
+    }
+    total_bytes += (int64_t)length;
+  }
+  iree_benchmark_set_bytes_processed(benchmark_state, total_bytes);
+
+  iree_hal_buffer_release(transfer.target_buffer);
+  iree_hal_buffer_release(transfer.source_buffer);
+  iree_hal_allocator_release(allocator);
+  return status;
+}
+
+// Sizes around IREE_TASK_TRANSFER_TILING_THRESHOLD.
+#define IREE_HAL_TRANSFER_BENCHMARK_SIZES(V)                   \
+  V(threshold_div8, IREE_TASK_TRANSFER_TILING_THRESHOLD / 8)   \
+  V(threshold_div4, IREE_TASK_TRANSFER_TILING_THRESHOLD / 4)   \
+  V(threshold_div2, IREE_TASK_TRANSFER_TILING_THRESHOLD / 2)   \
+  V(threshold, IREE_TASK_TRANSFER_TILING_THRESHOLD)            \
+  V(threshold_mul2, IREE_TASK_TRANSFER_TILING_THRESHOLD * 2)   \
+  V(threshold_mul4, IREE_TASK_TRANSFER_TILING_THRESHOLD * 4)   \
+  V(threshold_mul8, IREE_TASK_TRANSFER_TILING_THRESHOLD * 8)
+
+#define IREE_HAL_TRANSFER_BENCHMARK_DEFINE_OP(prefix, op, tiled, name, length) \
+  static iree_status_t prefix##_##name(iree_benchmark_state_t* state) {        \
+    return iree_hal_transfer_benchmark_run(state, op, tiled, length);          \
+  }
+#define IREE_HAL_TRANSFER_BENCHMARK_DEFINE(name, length)                   \
+  IREE_HAL_TRANSFER_BENCHMARK_DEFINE_OP(fill_untiled,                      \
+                                        IREE_HAL_TRANSFER_OP_FILL, false,  \
+                                        name, length)                      \
+  IREE_HAL_TRANSFER_BENCHMARK_DEFINE_OP(fill_tiled,                        \
+                                        IREE_HAL_TRANSFER_OP_FILL, true,   \
+                                        name, length)                      \
+  IREE_HAL_TRANSFER_BENCHMARK_DEFINE_OP(copy_untiled,                      \
+                                        IREE_HAL_TRANSFER_OP_COPY, false,  \
+                                        name, length)                      \
+  IREE_HAL_TRANSFER_BENCHMARK_DEFINE_OP(copy_tiled,                        \
+                                        IREE_HAL_TRANSFER_OP_COPY, true,   \
+                                        name, length)
+IREE_HAL_TRANSFER_BENCHMARK_SIZES(IREE_HAL_TRANSFER_BENCHMARK_DEFINE)
+#undef IREE_HAL_TRANSFER_BENCHMARK_DEFINE
+#undef IREE_HAL_TRANSFER_BENCHMARK_DEFINE_OP
+
+static const struct {
+  const char* name;
+  iree_status_t (*run)(iree_benchmark_state_t* state);
+} iree_hal_transfer_benchmarks[] = {
+#define IREE_HAL_TRANSFER_BENCHMARK_ENTRY(name, length) \
+  {"fill_untiled_" #name, fill_untiled_##name},         \
+      {"fill_tiled_" #name, fill_tiled_##name},         \
+      {"copy_untiled_" #name, copy_untiled_##name},     \
+      {"copy_tiled_" #name, copy_tiled_##name},
+    IREE_HAL_TRANSFER_BENCHMARK_SIZES(IREE_HAL_TRANSFER_BENCHMARK_ENTRY)
+#undef IREE_HAL_TRANSFER_BENCHMARK_ENTRY
+};
+
+// Benchmark definitions must outlive registration.
+static iree_benchmark_def_t iree_hal_transfer_benchmark_defs[IREE_ARRAYSIZE(
+    iree_hal_transfer_benchmarks)];
+
+int main(int argc, char** argv) {
+  iree_flags_set_usage(
+      "task_command_buffer_benchmark",
+      "Benchmarks tiled and untiled buffer fill/copy on the task executor.\n"
+      "Compare the `untiled` (single worker) and `tiled` (split across\n"
+      "workers) variants to find the tiling crossover point.\n");
+  iree_flags_parse_checked(IREE_FLAGS_PARSE_MODE_UNDEFINED_OK, &argc, &argv);
+  iree_benchmark_initialize(&argc, argv);
+
+  IREE_CHECK_OK(
+      iree_task_executor_create_from_flags(iree_allocator_system(), &executor));
+  iree_task_scope_initialize(iree_make_cstring_view("benchmark"), &scope);
+
+  for (iree_host_size_t i = 0; i < IREE_ARRAYSIZE(iree_hal_transfer_benchmarks);
+       ++i) {
+    iree_benchmark_def_t* benchmark_def = &iree_hal_transfer_benchmark_defs[i];
+    benchmark_def->flags = IREE_BENCHMARK_FLAG_USE_REAL_TIME;
+    benchmark_def->time_unit = IREE_BENCHMARK_UNIT_MICROSECOND;
+    benchmark_def->minimum_duration_ns = 0;
+    benchmark_def->iteration_count = 0;
+    benchmark_def->run = iree_hal_transfer_benchmarks[i].run;
+    iree_benchmark_register(
+        iree_make_cstring_view(iree_hal_transfer_benchmarks[i].name),
+        benchmark_def);
+  }
+
+  iree_benchmark_run_specified();
+
+  iree_task_scope_deinitialize(&scope);
+  iree_task_executor_release(executor);
+  return 0;
+}
@@ -43,6 +43,14 @@ typedef struct iree_hal_task_device_t {
   iree_host_size_t loader_count;
   iree_hal_executable_loader_t** loaders;
 
+  // Storage shared by all executable caches created from the device.
+  iree_hal_local_executable_cache_storage_t* executable_cache_storage;
+  // Caching mode bits added to all executables prepared by the device.
+  iree_hal_executable_caching_mode_t executable_caching_mode;
+  // Scope of all asynchronous executable preparation tasks issued by the
+  // device. Must be idle before the device is destroyed.
+  iree_task_scope_t preparation_scope;
+
   iree_allocator_t host_allocator;
   iree_hal_allocator_t* device_allocator;
 
@@ -62,6 +70,8 @@ void iree_hal_task_device_params_initialize(
     iree_hal_task_device_params_t* out_params) {
   out_params->arena_block_size = 32 * 1024;
   out_params->queue_count = 8;
+  out_params->executable_cache_storage = NULL;
+  out_params->executable_caching_mode = 0;
 }
 
 static iree_status_t iree_hal_task_device_check_params(
@@ -123,6 +133,9 @@ iree_status_t iree_hal_task_device_create(
       device->loaders[i] = loaders[i];
       iree_hal_executable_loader_retain(device->loaders[i]);
     }
+    device->executable_caching_mode = params->executable_caching_mode;
+    iree_task_scope_initialize(device->identifier,
+                               &device->preparation_scope);
 
     device->queue_count = params->queue_count;
     for (iree_host_size_t i = 0; i < device->queue_count; ++i) {
@@ -133,6 +146,12 @@ iree_status_t iree_hal_task_device_create(
     }
   }
 
+  if (iree_status_is_ok(status)) {
+    device->executable_cache_storage = params->executable_cache_storage;
+    iree_hal_local_executable_cache_storage_retain(
+        device->executable_cache_storage);
+  }
+
   if (iree_status_is_ok(status)) {
     status = iree_hal_allocator_create_heap(identifier, host_allocator,
                                             &device->device_allocator);
@@ -161,6 +180,13 @@ static void iree_hal_task_device_destroy(iree_hal_device_t* base_device) {
   for (iree_host_size_t i = 0; i < device->queue_count; ++i) {
     iree_hal_task_queue_deinitialize(&device->queues[i]);
   }
+  // Executables being prepared retain everything they need but the tasks
+  // preparing them reference the scope.
+  IREE_IGNORE_ERROR(iree_task_scope_wait_idle(&device->preparation_scope,
+                                              IREE_TIME_INFINITE_FUTURE));
+  iree_task_scope_deinitialize(&device->preparation_scope);
+  iree_hal_local_executable_cache_storage_release(
+      device->executable_cache_storage);
   for (iree_host_size_t i = 0; i < device->loader_count; ++i) {
     iree_hal_executable_loader_release(device->loaders[i]);
   }
@@ -257,13 +283,84 @@ static iree_status_t iree_hal_task_device_create_event(
                                     out_event);
 }
 
+// A heap-allocated task preparing an executable asynchronously.
+typedef struct iree_hal_task_device_preparation_t {
+  iree_task_call_t task;
+  iree_allocator_t host_allocator;
+  iree_task_scope_t* scope;
+  iree_hal_local_executable_cache_work_fn_t work_fn;
+  void* work_user_data;
+  bool executed;
+} iree_hal_task_device_preparation_t;
+
+static iree_status_t iree_hal_task_device_preparation_execute(
+    uintptr_t user_context, iree_task_t* task,
+    iree_task_submission_t* pending_submission) {
+  iree_hal_task_device_preparation_t* preparation =
+      (iree_hal_task_device_preparation_t*)user_context;
+  preparation->executed = true;
+  preparation->work_fn(preparation->work_user_data, /*cancelled=*/false);
+  return iree_ok_status();
+}
+
+static void iree_hal_task_device_preparation_cleanup(iree_task_t* task,
+                                                     iree_status_t status) {
+  iree_hal_task_device_preparation_t* preparation =
+      (iree_hal_task_device_preparation_t*)task;
+  if (!preparation->executed) {
+    // Task was discarded before it could run.
+    preparation->work_fn(preparation->work_user_data, /*cancelled=*/true);
+  }
+  iree_task_scope_t* scope = preparation->scope;
+  iree_allocator_free(preparation->host_allocator, preparation);
+  iree_task_scope_end(scope);
+}
+
+// Schedules executable preparation work on the device executor so that
+// multiple executables can be prepared concurrently.
+static iree_status_t iree_hal_task_device_schedule_preparation(
+    void* self, iree_hal_local_executable_cache_work_fn_t work_fn,
+    void* work_user_data) {
+  iree_hal_task_device_t* device = (iree_hal_task_device_t*)self;
+
+  iree_hal_task_device_preparation_t* preparation = NULL;
+  IREE_RETURN_IF_ERROR(iree_allocator_malloc(
+      device->host_allocator, sizeof(*preparation), (void**)&preparation));
+  preparation->host_allocator = device->host_allocator;
+  preparation->scope = &device->preparation_scope;
+  preparation->work_fn = work_fn;
+  preparation->work_user_data = work_user_data;
+  preparation->executed = false;
+  iree_task_call_initialize(
+      &device->preparation_scope,
+      iree_task_make_call_closure(iree_hal_task_device_preparation_execute,
+                                  (uintptr_t)preparation),
+      &preparation->task);
+  iree_task_set_cleanup_fn(&preparation->task.header,
+                           iree_hal_task_device_preparation_cleanup);
+
+  iree_task_scope_begin(&device->preparation_scope);
+  iree_task_submission_t submission;
+  iree_task_submission_initialize(&submission);
+  iree_task_submission_enqueue(&submission, &preparation->task.header);
+  iree_task_executor_submit(device->executor, &submission);
+  iree_task_executor_flush(device->executor);
+  return iree_ok_status();
+}
+
 static iree_status_t iree_hal_task_device_create_executable_cache(
     iree_hal_device_t* base_device, iree_string_view_t identifier,
     iree_hal_executable_cache_t** out_executable_cache) {
   iree_hal_task_device_t* device = iree_hal_task_device_cast(base_device);
+  const iree_hal_local_executable_cache_scheduler_t scheduler = {
+      .self = device,
+      .schedule = iree_hal_task_device_schedule_preparation,
+  };
   return iree_hal_local_executable_cache_create(
-      identifier, device->loader_count, device->loaders,
-      iree_hal_device_host_allocator(base_device), out_executable_cache);
+      identifier, device->executable_cache_storage,
+      device->executable_caching_mode, &scheduler, device->loader_count,
+      device->loaders, iree_hal_device_host_allocator(base_device),
+      out_executable_cache);
 }
 
 static iree_status_t iree_hal_task_device_create_executable_layout(
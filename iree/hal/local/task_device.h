@@ -10,6 +10,7 @@
 #include "iree/base/api.h"
 #include "iree/hal/api.h"
 #include "iree/hal/local/executable_loader.h"
+#include "iree/hal/local/local_executable_cache.h"
 #include "iree/task/executor.h"
 
 #ifdef __cplusplus
@@ -28,6 +29,20 @@ typedef struct iree_hal_task_device_params_t {
   // Larger sizes will lower overhead and ensure the heap isn't hit for
   // transient allocations while also increasing memory consumption.
   iree_host_size_t arena_block_size;
+
+  // Optional storage used to share prepared executables across all executable
+  // caches created from devices using the same storage; retained by devices
+  // and drivers. If omitted (the default) each executable cache prepares its
+  // own executables.
+  iree_hal_local_executable_cache_storage_t* executable_cache_storage;
+
+  // Caching mode bits added to all executables prepared by the device.
+  // Set IREE_HAL_EXECUTABLE_CACHING_MODE_ALLOW_ASYNC_PREPARATION to prepare
+  // executables concurrently on the executor workers while the program
+  // continues loading or
+  // IREE_HAL_EXECUTABLE_CACHING_MODE_ALLOW_DEFERRED_PREPARATION to only prepare
+  // executables when they are first dispatched.
+  iree_hal_executable_caching_mode_t executable_caching_mode;
 } iree_hal_task_device_params_t;
 
 // Initializes |out_params| to default values.
@@ -182,11 +182,31 @@ typedef struct iree_hal_task_queue_issue_cmd_t {
   // if we are the last issue pending.
   iree_hal_task_queue_t* queue;
 
+  // Issue task of the next submission on the queue that is waiting for this
+  // issue to complete in order to preserve FIFO issue order, if any.
+  // Guarded by the queue mutex.
+  iree_task_t* next_issue_task;
+
   // Command buffers to be issued in the order the appeared in the submission.
   iree_host_size_t command_buffer_count;
   iree_hal_command_buffer_t* command_buffers[];
 } iree_hal_task_queue_issue_cmd_t;
 
+// Detaches |cmd| from the queue FIFO issue order and returns the issue task of
+// the next submission if it was waiting on |cmd|. The caller must release the
+// returned task dependency.
+static iree_task_t* iree_hal_task_queue_issue_cmd_detach(
+    iree_hal_task_queue_issue_cmd_t* cmd) {
+  iree_slim_mutex_lock(&cmd->queue->mutex);
+  iree_task_t* next_issue_task = cmd->next_issue_task;
+  cmd->next_issue_task = NULL;
+  if (cmd->queue->tail_issue_task == &cmd->task.header) {
+    cmd->queue->tail_issue_task = NULL;
+  }
+  iree_slim_mutex_unlock(&cmd->queue->mutex);
+  return next_issue_task;
+}
+
 // Issues a set of command buffers without waiting for them to complete.
 static iree_status_t iree_hal_task_queue_issue_cmd(
     uintptr_t user_context, iree_task_t* task,
@@ -207,6 +227,14 @@ static iree_status_t iree_hal_task_queue_issue_cmd(
     }
   }
 
+  // Allow the next submission on the queue to issue now that we have.
+  iree_task_t* next_issue_task = iree_hal_task_queue_issue_cmd_detach(cmd);
+  if (next_issue_task &&
+      iree_atomic_fetch_sub_int32(&next_issue_task->pending_dependency_count, 1,
+                                  iree_memory_order_acq_rel) == 1) {
+    iree_task_submission_enqueue(pending_submission, next_issue_task);
+  }
+
   IREE_TRACE_ZONE_END(z0);
   return status;
 }
@@ -217,12 +245,24 @@ static void iree_hal_task_queue_issue_cmd_cleanup(iree_task_t* task,
                                                   iree_status_t status) {
   iree_hal_task_queue_issue_cmd_t* cmd = (iree_hal_task_queue_issue_cmd_t*)task;
 
-  // Reset queue tail issue task if it was us.
-  iree_slim_mutex_lock(&cmd->queue->mutex);
-  if (cmd->queue->tail_issue_task == task) {
-    cmd->queue->tail_issue_task = NULL;
+  // Reset queue tail issue task if it was us. If the issue ran then it has
+  // already released the next submission and this finds nothing to do.
+  //
+  // If the issue never ran (it was discarded due to a failure or executor
+  // shutdown) then the next submission waiting on us must not issue out of
+  // order. Cleanup may be running from within the executor/worker teardown so
+  // we can't submit to the executor here; instead if we held the last
+  // dependency we discard the next submission as well, which cascades to its
+  // retire command and fails its signal semaphores.
+  iree_task_t* next_issue_task = iree_hal_task_queue_issue_cmd_detach(cmd);
+  if (next_issue_task &&
+      iree_atomic_fetch_sub_int32(&next_issue_task->pending_dependency_count, 1,
+                                  iree_memory_order_acq_rel) == 1) {
+    iree_task_list_t discard_list;
+    iree_task_list_initialize(&discard_list);
+    iree_task_list_push_back(&discard_list, next_issue_task);
+    iree_task_list_discard(&discard_list);
   }
-  iree_slim_mutex_unlock(&cmd->queue->mutex);
 }
 
 // Allocates and initializes a iree_hal_task_queue_issue_cmd_t task.
@@ -244,6 +284,7 @@ static iree_status_t iree_hal_task_queue_issue_cmd_allocate(
                            iree_hal_task_queue_issue_cmd_cleanup);
   cmd->arena = arena;
   cmd->queue = queue;
+  cmd->next_issue_task = NULL;
 
   cmd->command_buffer_count = command_buffer_count;
   memcpy(cmd->command_buffers, command_buffers,
@@ -463,10 +504,6 @@ static iree_status_t iree_hal_task_queue_submit_batch(
     // Ensure that we only issue command buffers after all waits have completed.
     iree_task_set_completion_task(&wait_cmd->task.header,
                                   &issue_cmd->task.header);
-    iree_task_submission_enqueue(&submission, &wait_cmd->task.header);
-  } else {
-    // No waits needed; directly enqueue.
-    iree_task_submission_enqueue(&submission, &issue_cmd->task.header);
   }
 
   iree_slim_mutex_lock(&queue->mutex);
@@ -474,15 +511,30 @@ static iree_status_t iree_hal_task_queue_submit_batch(
   // If there is an in-flight issue pending then we need to chain onto that
   // so that we ensure FIFO submission order is preserved. Note that we are only
   // waiting for the issue to complete and *not* all of the commands that are
-  // issued.
+  // issued. The issue task already has the retire task as its completion task
+  // so the edge is tracked on the prior issue command and released when it
+  // has issued.
+  bool is_chained = false;
   if (queue->tail_issue_task != NULL) {
-    iree_task_set_completion_task(queue->tail_issue_task,
-                                  &issue_cmd->task.header);
+    iree_hal_task_queue_issue_cmd_t* tail_issue_cmd =
+        (iree_hal_task_queue_issue_cmd_t*)queue->tail_issue_task;
+    tail_issue_cmd->next_issue_task = &issue_cmd->task.header;
+    iree_atomic_fetch_add_int32(
+        &issue_cmd->task.header.pending_dependency_count, 1,
+        iree_memory_order_seq_cst);
+    is_chained = true;
   }
   queue->tail_issue_task = &issue_cmd->task.header;
 
   iree_slim_mutex_unlock(&queue->mutex);
 
+  if (wait_cmd != NULL) {
+    iree_task_submission_enqueue(&submission, &wait_cmd->task.header);
+  } else if (!is_chained) {
+    // No waits needed; directly enqueue.
+    iree_task_submission_enqueue(&submission, &issue_cmd->task.header);
+  }
+
   // Submit the tasks immediately. The executor may queue them up until we
   // force the flush after all batches have been processed.
   iree_task_executor_submit(queue->executor, &submission);
@@ -82,6 +82,7 @@ static void iree_hal_task_timepoint_list_erase(
     iree_hal_task_timepoint_list_t* list,
     iree_hal_task_timepoint_t* timepoint) {
   if (timepoint->prev != NULL) timepoint->prev->next = timepoint->next;
+  if (timepoint->next != NULL) timepoint->next->prev = timepoint->prev;
   if (timepoint == list->head) list->head = timepoint->next;
   if (timepoint == list->tail) list->tail = timepoint->prev;
   timepoint->prev = NULL;
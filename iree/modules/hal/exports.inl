@@ -61,6 +61,7 @@ EXPORT_FN("device.match.id", iree_hal_module_device_match_id, rr, i)
 EXPORT_FN("device.query.i32", iree_hal_module_device_query_i32, rr, ii)
 
 EXPORT_FN("ex.shared_device", iree_hal_module_ex_shared_device, v, r)
+EXPORT_FN("ex.submit", iree_hal_module_ex_submit, rr, ri)
 EXPORT_FN("ex.submit_and_wait", iree_hal_module_ex_submit_and_wait, rr, v)
 
 EXPORT_FN("executable.create", iree_hal_module_executable_create, rrrCrD, r)
@@ -215,6 +215,81 @@ void iree_hal_module_ex_defer_release(iree_hal_module_state_t* state,
       iree_vm_list_push_ref_retain(state->deferred_releases, &value));
 }
 
+// Drops all pending deferred releases (references to everything in flight).
+// Must only be called once all submissions made so far have completed.
+// This will be replaced with resource sets in the future that are attached to
+// each command buffer.
+static iree_status_t iree_hal_module_ex_flush_deferred_releases(
+    iree_hal_module_state_t* state) {
+  IREE_RETURN_IF_ERROR(iree_vm_list_resize(state->deferred_releases, 0));
+  memset(state->deferred_lru, 0, sizeof(state->deferred_lru));
+  return iree_ok_status();
+}
+
+// Populates |batch| with a single |command_buffer| ordered after all prior
+// submissions made through the module: the batch waits on the current
+// submission timepoint of the state semaphore and signals the next one.
+// |storage| must remain live until the batch has been submitted.
+typedef struct iree_hal_module_ex_batch_storage_t {
+  iree_hal_command_buffer_t* command_buffer_ptrs[1];
+  iree_hal_semaphore_t* wait_semaphore_ptrs[1];
+  uint64_t wait_semaphore_values[1];
+  iree_hal_semaphore_t* signal_semaphore_ptrs[1];
+  uint64_t signal_semaphore_values[1];
+} iree_hal_module_ex_batch_storage_t;
+static uint64_t iree_hal_module_ex_chain_batch(
+    iree_hal_module_state_t* state, iree_hal_command_buffer_t* command_buffer,
+    iree_hal_module_ex_batch_storage_t* storage,
+    iree_hal_submission_batch_t* out_batch) {
+  memset(out_batch, 0, sizeof(*out_batch));
+
+  storage->command_buffer_ptrs[0] = command_buffer;
+  out_batch->command_buffer_count = IREE_ARRAYSIZE(storage->command_buffer_ptrs);
+  out_batch->command_buffers = storage->command_buffer_ptrs;
+
+  storage->wait_semaphore_ptrs[0] = state->submit_semaphore;
+  storage->wait_semaphore_values[0] = state->submit_value;
+  out_batch->wait_semaphores.count =
+      IREE_ARRAYSIZE(storage->wait_semaphore_ptrs);
+  out_batch->wait_semaphores.semaphores = storage->wait_semaphore_ptrs;
+  out_batch->wait_semaphores.payload_values = storage->wait_semaphore_values;
+
+  uint64_t next_semaphore_value = ++state->submit_value;
+  storage->signal_semaphore_ptrs[0] = state->submit_semaphore;
+  storage->signal_semaphore_values[0] = next_semaphore_value;
+  out_batch->signal_semaphores.count =
+      IREE_ARRAYSIZE(storage->signal_semaphore_ptrs);
+  out_batch->signal_semaphores.semaphores = storage->signal_semaphore_ptrs;
+  out_batch->signal_semaphores.payload_values =
+      storage->signal_semaphore_values;
+
+  return next_semaphore_value;
+}
+
+IREE_VM_ABI_EXPORT(iree_hal_module_ex_submit,  //
+                   iree_hal_module_state_t,    //
+                   rr, ri) {
+  iree_hal_device_t* device = NULL;
+  IREE_RETURN_IF_ERROR(iree_hal_device_check_deref(args->r0, &device));
+  iree_hal_command_buffer_t* command_buffer = NULL;
+  IREE_RETURN_IF_ERROR(
+      iree_hal_command_buffer_check_deref(args->r1, &command_buffer));
+
+  // Chain the command buffer after everything submitted so far and return the
+  // timepoint at which it completes. The caller is responsible for waiting on
+  // the timepoint (via hal.semaphore.await) before reading any results.
+  iree_hal_module_ex_batch_storage_t storage;
+  iree_hal_submission_batch_t batch;
+  uint64_t timepoint =
+      iree_hal_module_ex_chain_batch(state, command_buffer, &storage, &batch);
+  IREE_RETURN_IF_ERROR(iree_hal_device_queue_submit(
+      device, IREE_HAL_COMMAND_CATEGORY_ANY, 0, 1, &batch));
+
+  rets->r0 = iree_hal_semaphore_retain_ref(state->submit_semaphore);
+  rets->i1 = (int32_t)timepoint;
+  return iree_ok_status();
+}
+
 IREE_VM_ABI_EXPORT(iree_hal_module_ex_submit_and_wait,  //
                    iree_hal_module_state_t,             //
                    rr, v) {
@@ -224,20 +299,12 @@ IREE_VM_ABI_EXPORT(iree_hal_module_ex_submit_and_wait,  //
   IREE_RETURN_IF_ERROR(
       iree_hal_command_buffer_check_deref(args->r1, &command_buffer));
 
-  // Batch with our single command buffer.
+  // Batch with our single command buffer. It is still ordered after any
+  // asynchronous submissions that may be in flight.
+  iree_hal_module_ex_batch_storage_t storage;
   iree_hal_submission_batch_t batch;
-  memset(&batch, 0, sizeof(batch));
-
-  iree_hal_command_buffer_t* command_buffer_ptrs[] = {command_buffer};
-  batch.command_buffer_count = IREE_ARRAYSIZE(command_buffer_ptrs);
-  batch.command_buffers = command_buffer_ptrs;
-
-  uint64_t next_semaphore_value = ++state->submit_value;
-  iree_hal_semaphore_t* signal_semaphore_ptrs[] = {state->submit_semaphore};
-  uint64_t signal_semaphore_values[] = {next_semaphore_value};
-  batch.signal_semaphores.count = IREE_ARRAYSIZE(signal_semaphore_ptrs);
-  batch.signal_semaphores.semaphores = signal_semaphore_ptrs;
-  batch.signal_semaphores.payload_values = signal_semaphore_values;
+  uint64_t next_semaphore_value =
+      iree_hal_module_ex_chain_batch(state, command_buffer, &storage, &batch);
 
   iree_status_t status = iree_hal_device_submit_and_wait(
       device, IREE_HAL_COMMAND_CATEGORY_ANY, 0, 1, &batch,
@@ -246,13 +313,7 @@ IREE_VM_ABI_EXPORT(iree_hal_module_ex_submit_and_wait,  //
     return status;
   }
 
-  // Drop all pending deferred releases (references to everything in flight).
-  // This will be replaced with resource sets in the future that are attached to
-  // each command buffer.
-  IREE_RETURN_IF_ERROR(iree_vm_list_resize(state->deferred_releases, 0));
-  memset(state->deferred_lru, 0, sizeof(state->deferred_lru));
-
-  return iree_ok_status();
+  return iree_hal_module_ex_flush_deferred_releases(state);
 }
 
 //===----------------------------------------------------------------------===//
@@ -984,6 +1045,14 @@ IREE_VM_ABI_EXPORT(iree_hal_module_semaphore_fail,  //
   return iree_ok_status();
 }
 
+// Blocking wait used by hosts resuming an invocation suspended on an await.
+static iree_status_t iree_hal_module_semaphore_wait_fn(void* object,
+                                                       uint64_t value,
+                                                       iree_timeout_t timeout) {
+  return iree_hal_semaphore_wait((iree_hal_semaphore_t*)object, value,
+                                 timeout);
+}
+
 IREE_VM_ABI_EXPORT(iree_hal_module_semaphore_await,  //
                    iree_hal_module_state_t,          //
                    ri, i) {
@@ -991,11 +1060,34 @@ IREE_VM_ABI_EXPORT(iree_hal_module_semaphore_await,  //
   IREE_RETURN_IF_ERROR(iree_hal_semaphore_check_deref(args->r0, &semaphore));
   uint64_t new_value = (uint32_t)args->i1;
 
-  // TODO(benvanik): coroutine magic.
+  // If the timepoint has not yet been reached yield back to the host with the
+  // wait instead of blocking the thread. The host resumes us (reissuing this
+  // call) once the semaphore is signaled and we'll fall through below.
+  uint64_t current_value = 0;
+  iree_status_t query_status =
+      iree_hal_semaphore_query(semaphore, &current_value);
+  if (iree_status_is_ok(query_status) && current_value < new_value) {
+    out_result->yield_reason = IREE_VM_YIELD_REASON_AWAIT;
+    out_result->wait.type = iree_hal_semaphore_type_id();
+    out_result->wait.object = semaphore;
+    out_result->wait.value = new_value;
+    out_result->wait.wait_fn = iree_hal_module_semaphore_wait_fn;
+    return iree_status_from_code(IREE_STATUS_DEFERRED);
+  }
+  iree_status_ignore(query_status);
+
+  // Reached (or failed): this returns immediately with the semaphore status.
   iree_status_t status =
       iree_hal_semaphore_wait(semaphore, new_value, iree_infinite_timeout());
   if (iree_status_is_ok(status)) {
     rets->i0 = 0;
+    // Waiting on the latest timepoint of the submission timeline means that
+    // nothing is in flight anymore and we can drop the deferred releases that
+    // were keeping resources alive for asynchronous submissions.
+    if (semaphore == state->submit_semaphore &&
+        new_value >= state->submit_value) {
+      status = iree_hal_module_ex_flush_deferred_releases(state);
+    }
   } else if (iree_status_is_deadline_exceeded(status)) {
     // Propagate deadline exceeded back to the VM.
     rets->i0 = (int32_t)iree_status_consume_code(status);
@@ -19,10 +19,30 @@
 // name in a way compatible with iree_string_view_compare.
 //
 // Users are meant to `#define EXPORT_FN` to be able to access the information.
-// #define EXPORT_FN(name, arg_type, ret_type, target_fn)
+// #define EXPORT_FN(name, target_fn, arg_types, ret_types)
 
 // clang-format off
 
-EXPORT_FN("_placeholder", iree_vmvx_module_placeholder, v, v)
+EXPORT_FN("add.2d.f32", iree_vmvx_module_add_2d_f32, riiiriiiriiiii, v)
+EXPORT_FN("add.2d.i32", iree_vmvx_module_add_2d_i32, riiiriiiriiiii, v)
+
+EXPORT_FN("copy.2d.x16", iree_vmvx_module_copy_2d_x16, riiiriiiii, v)
+EXPORT_FN("copy.2d.x32", iree_vmvx_module_copy_2d_x32, riiiriiiii, v)
+EXPORT_FN("copy.2d.x8", iree_vmvx_module_copy_2d_x8, riiiriiiii, v)
+
+EXPORT_FN("fill.2d.x16", iree_vmvx_module_fill_2d_x16, iriiiii, v)
+EXPORT_FN("fill.2d.x32", iree_vmvx_module_fill_2d_x32, iriiiii, v)
+EXPORT_FN("fill.2d.x8", iree_vmvx_module_fill_2d_x8, iriiiii, v)
+
+EXPORT_FN("fma.2d.f32", iree_vmvx_module_fma_2d_f32, riiiriiiriiiriiiii, v)
+
+EXPORT_FN("matmul.f32f32f32", iree_vmvx_module_matmul_f32f32f32, riiriiriiiii, v)
+
+EXPORT_FN("mul.2d.f32", iree_vmvx_module_mul_2d_f32, riiiriiiriiiii, v)
+EXPORT_FN("mul.2d.i32", iree_vmvx_module_mul_2d_i32, riiiriiiriiiii, v)
+
+EXPORT_FN("reduce.max.2d.f32", iree_vmvx_module_reduce_max_2d_f32, riiiriiii, v)
+EXPORT_FN("reduce.sum.2d.f32", iree_vmvx_module_reduce_sum_2d_f32, riiiriiii, v)
+EXPORT_FN("reduce.sum.2d.i32", iree_vmvx_module_reduce_sum_2d_i32, riiiriiii, v)
 
 // clang-format on
@@ -91,13 +91,369 @@ iree_vmvx_module_free_state(void* self, iree_vm_module_state_t* module_state) {
 }
 
 //===----------------------------------------------------------------------===//
-// TODO
+// Strided buffer views
 //===----------------------------------------------------------------------===//
 
-// Placeholder to make the function pointer arrays happy (they can't be empty).
-IREE_VM_ABI_EXPORT(iree_vmvx_module_placeholder,  //
+// All microkernels operate on 2-D strided views of !vm.buffers. A view is
+// described by a (buffer, offset, stride0, stride1) tuple with the offset and
+// strides in elements and a (size0, size1) shape shared by all views of an op.
+// 1-D views are passed with size0 = 1. The compiler flattens higher-rank
+// memrefs into these views prior to calling in.
+
+// Maps a view of |size0| x |size1| elements of |element_size| bytes each
+// starting at element |offset| of |buffer_ref| and returns a pointer to the
+// first element in |out_ptr|. Fails if any element of the view lies outside
+// of the buffer or if |writable| is set and the buffer is read-only.
+static iree_status_t iree_vmvx_map_view_2d(
+    iree_vm_ref_t buffer_ref, bool writable, iree_host_size_t element_size,
+    int32_t offset, int32_t stride0, int32_t stride1, int32_t size0,
+    int32_t size1, void** out_ptr) {
+  *out_ptr = NULL;
+  iree_vm_buffer_t* buffer = NULL;
+  IREE_RETURN_IF_ERROR(iree_vm_buffer_check_deref(buffer_ref, &buffer));
+  if (writable &&
+      !iree_all_bits_set(buffer->access, IREE_VM_BUFFER_ACCESS_MUTABLE)) {
+    return iree_make_status(IREE_STATUS_PERMISSION_DENIED,
+                            "buffer is read-only and cannot be written");
+  }
+  if (offset < 0 || stride0 < 0 || stride1 < 0 || size0 < 0 || size1 < 0) {
+    return iree_make_status(
+        IREE_STATUS_INVALID_ARGUMENT,
+        "invalid view (offset=%d, strides=[%d, %d], sizes=[%d, %d])", offset,
+        stride0, stride1, size0, size1);
+  }
+  iree_byte_span_t data = buffer->data;
+  if (size0 == 0 || size1 == 0) {
+    // Empty views are never dereferenced.
+    *out_ptr = data.data;
+    return iree_ok_status();
+  }
+  uint64_t last_element = (uint64_t)offset +
+                          (uint64_t)(size0 - 1) * (uint64_t)stride0 +
+                          (uint64_t)(size1 - 1) * (uint64_t)stride1;
+  if ((last_element + 1) * element_size > data.data_length) {
+    return iree_make_status(
+        IREE_STATUS_OUT_OF_RANGE,
+        "view (offset=%d, strides=[%d, %d], sizes=[%d, %d]) out of range of a "
+        "buffer of %zu bytes",
+        offset, stride0, stride1, size0, size1, data.data_length);
+  }
+  *out_ptr = data.data + (iree_host_size_t)offset * element_size;
+  return iree_ok_status();
+}
+
+//===----------------------------------------------------------------------===//
+// Copy and fill
+//===----------------------------------------------------------------------===//
+
+static iree_status_t iree_vmvx_copy_2d(const iree_vm_abi_riiiriiiii_t* args,
+                                       iree_host_size_t element_size) {
+  int32_t size0 = args->i8;
+  int32_t size1 = args->i9;
+  void* source_ptr = NULL;
+  IREE_RETURN_IF_ERROR(iree_vmvx_map_view_2d(args->r0, /*writable=*/false,
+                                             element_size, args->i1, args->i2,
+                                             args->i3, size0, size1,
+                                             &source_ptr));
+  void* target_ptr = NULL;
+  IREE_RETURN_IF_ERROR(iree_vmvx_map_view_2d(args->r4, /*writable=*/true,
+                                             element_size, args->i5, args->i6,
+                                             args->i7, size0, size1,
+                                             &target_ptr));
+  const uint8_t* source = (const uint8_t*)source_ptr;
+  uint8_t* target = (uint8_t*)target_ptr;
+  iree_host_size_t source_stride0 = (iree_host_size_t)args->i2 * element_size;
+  iree_host_size_t source_stride1 = (iree_host_size_t)args->i3 * element_size;
+  iree_host_size_t target_stride0 = (iree_host_size_t)args->i6 * element_size;
+  iree_host_size_t target_stride1 = (iree_host_size_t)args->i7 * element_size;
+  if (source_stride1 == element_size && target_stride1 == element_size) {
+    // Contiguous rows; memmove as views produced from the same binding may
+    // overlap.
+    for (int32_t i = 0; i < size0; ++i) {
+      memmove(target + i * target_stride0, source + i * source_stride0,
+              size1 * element_size);
+    }
+    return iree_ok_status();
+  }
+  for (int32_t i = 0; i < size0; ++i) {
+    const uint8_t* source_row = source + i * source_stride0;
+    uint8_t* target_row = target + i * target_stride0;
+    for (int32_t j = 0; j < size1; ++j) {
+      memcpy(target_row + j * target_stride1, source_row + j * source_stride1,
+             element_size);
+    }
+  }
+  return iree_ok_status();
+}
+
+IREE_VM_ABI_EXPORT(iree_vmvx_module_copy_2d_x8,  //
+                   iree_vmvx_module_state_t,     //
+                   riiiriiiii, v) {
+  return iree_vmvx_copy_2d(args, sizeof(uint8_t));
+}
+
+IREE_VM_ABI_EXPORT(iree_vmvx_module_copy_2d_x16,  //
                    iree_vmvx_module_state_t,      //
-                   v, v) {
+                   riiiriiiii, v) {
+  return iree_vmvx_copy_2d(args, sizeof(uint16_t));
+}
+
+IREE_VM_ABI_EXPORT(iree_vmvx_module_copy_2d_x32,  //
+                   iree_vmvx_module_state_t,      //
+                   riiiriiiii, v) {
+  return iree_vmvx_copy_2d(args, sizeof(uint32_t));
+}
+
+// Defines a fill of |T| elements with the low bits of the i32 pattern.
+#define IREE_VMVX_DEFINE_FILL_2D(name, T)                                      \
+  IREE_VM_ABI_EXPORT(iree_vmvx_module_fill_2d_##name,                          \
+                     iree_vmvx_module_state_t, iriiiii, v) {                   \
+    const T value = (T)args->i0;                                               \
+    int32_t size0 = args->i5;                                                  \
+    int32_t size1 = args->i6;                                                  \
+    void* target_ptr = NULL;                                                   \
+    IREE_RETURN_IF_ERROR(iree_vmvx_map_view_2d(                                \
+        args->r1, /*writable=*/true, sizeof(T), args->i2, args->i3, args->i4,  \
+        size0, size1, &target_ptr));                                           \
+    T* IREE_RESTRICT target = (T*)target_ptr;                                  \
+    iree_host_size_t stride0 = (iree_host_size_t)args->i3;                     \
+    iree_host_size_t stride1 = (iree_host_size_t)args->i4;                     \
+    for (int32_t i = 0; i < size0; ++i) {                                      \
+      T* IREE_RESTRICT target_row = target + i * stride0;                      \
+      if (stride1 == 1) {                                                      \
+        for (int32_t j = 0; j < size1; ++j) target_row[j] = value;             \
+      } else {                                                                 \
+        for (int32_t j = 0; j < size1; ++j) target_row[j * stride1] = value;   \
+      }                                                                        \
+    }                                                                          \
+    return iree_ok_status();                                                   \
+  }
+IREE_VMVX_DEFINE_FILL_2D(x8, uint8_t)
+IREE_VMVX_DEFINE_FILL_2D(x16, uint16_t)
+IREE_VMVX_DEFINE_FILL_2D(x32, uint32_t)
+#undef IREE_VMVX_DEFINE_FILL_2D
+
+//===----------------------------------------------------------------------===//
+// Elementwise arithmetic
+//===----------------------------------------------------------------------===//
+
+// The inner loops below have a unit-stride path written so that compilers can
+// auto-vectorize them for whatever SIMD ISA the runtime is built for.
+
+// Defines `out = lhs <op> rhs` over |T| elements.
+#define IREE_VMVX_DEFINE_BINARY_2D(name, T, op)                                \
+  IREE_VM_ABI_EXPORT(iree_vmvx_module_##name, iree_vmvx_module_state_t,        \
+                     riiiriiiriiiii, v) {                                      \
+    int32_t size0 = args->i12;                                                 \
+    int32_t size1 = args->i13;                                                 \
+    void* lhs_ptr = NULL;                                                      \
+    IREE_RETURN_IF_ERROR(iree_vmvx_map_view_2d(                                \
+        args->r0, /*writable=*/false, sizeof(T), args->i1, args->i2, args->i3, \
+        size0, size1, &lhs_ptr));                                              \
+    void* rhs_ptr = NULL;                                                      \
+    IREE_RETURN_IF_ERROR(iree_vmvx_map_view_2d(                                \
+        args->r4, /*writable=*/false, sizeof(T), args->i5, args->i6, args->i7, \
+        size0, size1, &rhs_ptr));                                              \
+    void* out_ptr = NULL;                                                      \
+    IREE_RETURN_IF_ERROR(iree_vmvx_map_view_2d(                                \
+        args->r8, /*writable=*/true, sizeof(T), args->i9, args->i10,           \
+        args->i11, size0, size1, &out_ptr));                                   \
+    const T* lhs = (const T*)lhs_ptr;                                          \
+    const T* rhs = (const T*)rhs_ptr;                                          \
+    T* out = (T*)out_ptr;                                                      \
+    iree_host_size_t lhs_stride1 = (iree_host_size_t)args->i3;                 \
+    iree_host_size_t rhs_stride1 = (iree_host_size_t)args->i7;                 \
+    iree_host_size_t out_stride1 = (iree_host_size_t)args->i11;                \
+    for (int32_t i = 0; i < size0; ++i) {                                      \
+      const T* lhs_row = lhs + i * (iree_host_size_t)args->i2;                 \
+      const T* rhs_row = rhs + i * (iree_host_size_t)args->i6;                 \
+      T* out_row = out + i * (iree_host_size_t)args->i10;                      \
+      if (lhs_stride1 == 1 && rhs_stride1 == 1 && out_stride1 == 1) {          \
+        for (int32_t j = 0; j < size1; ++j) {                                  \
+          out_row[j] = lhs_row[j] op rhs_row[j];                               \
+        }                                                                      \
+      } else {                                                                 \
+        for (int32_t j = 0; j < size1; ++j) {                                  \
+          out_row[j * out_stride1] =                                           \
+              lhs_row[j * lhs_stride1] op rhs_row[j * rhs_stride1];            \
+        }                                                                      \
+      }                                                                        \
+    }                                                                          \
+    return iree_ok_status();                                                   \
+  }
+IREE_VMVX_DEFINE_BINARY_2D(add_2d_f32, float, +)
+IREE_VMVX_DEFINE_BINARY_2D(add_2d_i32, int32_t, +)
+IREE_VMVX_DEFINE_BINARY_2D(mul_2d_f32, float, *)
+IREE_VMVX_DEFINE_BINARY_2D(mul_2d_i32, int32_t, *)
+#undef IREE_VMVX_DEFINE_BINARY_2D
+
+// out = a * b + c
+IREE_VM_ABI_EXPORT(iree_vmvx_module_fma_2d_f32,  //
+                   iree_vmvx_module_state_t,     //
+                   riiiriiiriiiriiiii, v) {
+  int32_t size0 = args->i16;
+  int32_t size1 = args->i17;
+  void* a_ptr = NULL;
+  IREE_RETURN_IF_ERROR(iree_vmvx_map_view_2d(args->r0, /*writable=*/false,
+                                             sizeof(float), args->i1, args->i2,
+                                             args->i3, size0, size1, &a_ptr));
+  void* b_ptr = NULL;
+  IREE_RETURN_IF_ERROR(iree_vmvx_map_view_2d(args->r4, /*writable=*/false,
+                                             sizeof(float), args->i5, args->i6,
+                                             args->i7, size0, size1, &b_ptr));
+  void* c_ptr = NULL;
+  IREE_RETURN_IF_ERROR(iree_vmvx_map_view_2d(
+      args->r8, /*writable=*/false, sizeof(float), args->i9, args->i10,
+      args->i11, size0, size1, &c_ptr));
+  void* out_ptr = NULL;
+  IREE_RETURN_IF_ERROR(iree_vmvx_map_view_2d(
+      args->r12, /*writable=*/true, sizeof(float), args->i13, args->i14,
+      args->i15, size0, size1, &out_ptr));
+  const float* a = (const float*)a_ptr;
+  const float* b = (const float*)b_ptr;
+  const float* c = (const float*)c_ptr;
+  float* out = (float*)out_ptr;
+  iree_host_size_t a_stride1 = (iree_host_size_t)args->i3;
+  iree_host_size_t b_stride1 = (iree_host_size_t)args->i7;
+  iree_host_size_t c_stride1 = (iree_host_size_t)args->i11;
+  iree_host_size_t out_stride1 = (iree_host_size_t)args->i15;
+  for (int32_t i = 0; i < size0; ++i) {
+    const float* a_row = a + i * (iree_host_size_t)args->i2;
+    const float* b_row = b + i * (iree_host_size_t)args->i6;
+    const float* c_row = c + i * (iree_host_size_t)args->i10;
+    float* out_row = out + i * (iree_host_size_t)args->i14;
+    if (a_stride1 == 1 && b_stride1 == 1 && c_stride1 == 1 &&
+        out_stride1 == 1) {
+      for (int32_t j = 0; j < size1; ++j) {
+        out_row[j] = a_row[j] * b_row[j] + c_row[j];
+      }
+    } else {
+      for (int32_t j = 0; j < size1; ++j) {
+        out_row[j * out_stride1] =
+            a_row[j * a_stride1] * b_row[j * b_stride1] + c_row[j * c_stride1];
+      }
+    }
+  }
+  return iree_ok_status();
+}
+
+//===----------------------------------------------------------------------===//
+// Reductions
+//===----------------------------------------------------------------------===//
+
+// Number of independent accumulators used when reducing contiguous rows.
+// Splitting the accumulation breaks the serial dependency between iterations
+// so that the loop can be vectorized without fast-math reassociation.
+#define IREE_VMVX_REDUCE_LANES 8
+
+// Defines `out[i] = reduce(out[i], in[i, 0..size1))` over |T| elements.
+// |combine| is a macro taking (acc, value) and returning the combined value.
+#define IREE_VMVX_DEFINE_REDUCE_2D(name, T, combine)                           \
+  IREE_VM_ABI_EXPORT(iree_vmvx_module_##name, iree_vmvx_module_state_t,        \
+                     riiiriiii, v) {                                           \
+    int32_t size0 = args->i7;                                                  \
+    int32_t size1 = args->i8;                                                  \
+    void* in_ptr = NULL;                                                       \
+    IREE_RETURN_IF_ERROR(iree_vmvx_map_view_2d(                                \
+        args->r0, /*writable=*/false, sizeof(T), args->i1, args->i2, args->i3, \
+        size0, size1, &in_ptr));                                               \
+    void* out_ptr = NULL;                                                      \
+    IREE_RETURN_IF_ERROR(iree_vmvx_map_view_2d(                                \
+        args->r4, /*writable=*/true, sizeof(T), args->i5, args->i6,            \
+        /*stride1=*/0, size0, 1, &out_ptr));                                   \
+    const T* in = (const T*)in_ptr;                                            \
+    T* out = (T*)out_ptr;                                                      \
+    iree_host_size_t in_stride1 = (iree_host_size_t)args->i3;                  \
+    for (int32_t i = 0; i < size0; ++i) {                                      \
+      const T* in_row = in + i * (iree_host_size_t)args->i2;                   \
+      T* out_value = out + i * (iree_host_size_t)args->i6;                     \
+      T acc = *out_value;                                                      \
+      int32_t j = 0;                                                           \
+      if (in_stride1 == 1 && size1 >= IREE_VMVX_REDUCE_LANES) {                \
+        T lanes[IREE_VMVX_REDUCE_LANES];                                       \
+        for (int32_t k = 0; k < IREE_VMVX_REDUCE_LANES; ++k) {                 \
+          lanes[k] = in_row[k];                                                \
+        }                                                                      \
+        for (j = IREE_VMVX_REDUCE_LANES;                                       \
+             j + IREE_VMVX_REDUCE_LANES <= size1;                              \
+             j += IREE_VMVX_REDUCE_LANES) {                                    \
+          for (int32_t k = 0; k < IREE_VMVX_REDUCE_LANES; ++k) {               \
+            lanes[k] = combine(lanes[k], in_row[j + k]);                       \
+          }                                                                    \
+        }                                                                      \
+        for (int32_t k = 0; k < IREE_VMVX_REDUCE_LANES; ++k) {                 \
+          acc = combine(acc, lanes[k]);                                        \
+        }                                                                      \
+      }                                                                        \
+      for (; j < size1; ++j) {                                                 \
+        acc = combine(acc, in_row[j * in_stride1]);                            \
+      }                                                                        \
+      *out_value = acc;                                                        \
+    }                                                                          \
+    return iree_ok_status();                                                   \
+  }
+#define IREE_VMVX_COMBINE_SUM(acc, value) ((acc) + (value))
+#define IREE_VMVX_COMBINE_MAX(acc, value) ((value) > (acc) ? (value) : (acc))
+IREE_VMVX_DEFINE_REDUCE_2D(reduce_max_2d_f32, float, IREE_VMVX_COMBINE_MAX)
+IREE_VMVX_DEFINE_REDUCE_2D(reduce_sum_2d_f32, float, IREE_VMVX_COMBINE_SUM)
+IREE_VMVX_DEFINE_REDUCE_2D(reduce_sum_2d_i32, int32_t, IREE_VMVX_COMBINE_SUM)
+#undef IREE_VMVX_COMBINE_MAX
+#undef IREE_VMVX_COMBINE_SUM
+#undef IREE_VMVX_DEFINE_REDUCE_2D
+
+//===----------------------------------------------------------------------===//
+// Matrix multiplication
+//===----------------------------------------------------------------------===//
+
+// Tile sizes in elements used to block the matmul loops. A K tile of LHS
+// columns and RHS rows is walked for every row of the output while a row tile
+// of N output elements stays resident in L1.
+#define IREE_VMVX_MATMUL_TILE_K 64
+#define IREE_VMVX_MATMUL_TILE_N 256
+
+// out[M, N] += lhs[M, K] * rhs[K, N]
+// All operands are row-major with unit inner strides and the given row strides.
+IREE_VM_ABI_EXPORT(iree_vmvx_module_matmul_f32f32f32,  //
+                   iree_vmvx_module_state_t,           //
+                   riiriiriiiii, v) {
+  int32_t m = args->i9;
+  int32_t n = args->i10;
+  int32_t k = args->i11;
+  void* lhs_ptr = NULL;
+  IREE_RETURN_IF_ERROR(iree_vmvx_map_view_2d(args->r0, /*writable=*/false,
+                                             sizeof(float), args->i1, args->i2,
+                                             /*stride1=*/1, m, k, &lhs_ptr));
+  void* rhs_ptr = NULL;
+  IREE_RETURN_IF_ERROR(iree_vmvx_map_view_2d(args->r3, /*writable=*/false,
+                                             sizeof(float), args->i4, args->i5,
+                                             /*stride1=*/1, k, n, &rhs_ptr));
+  void* out_ptr = NULL;
+  IREE_RETURN_IF_ERROR(iree_vmvx_map_view_2d(args->r6, /*writable=*/true,
+                                             sizeof(float), args->i7, args->i8,
+                                             /*stride1=*/1, m, n, &out_ptr));
+  const float* lhs = (const float*)lhs_ptr;
+  const float* rhs = (const float*)rhs_ptr;
+  float* out = (float*)out_ptr;
+  iree_host_size_t lhs_stride = (iree_host_size_t)args->i2;
+  iree_host_size_t rhs_stride = (iree_host_size_t)args->i5;
+  iree_host_size_t out_stride = (iree_host_size_t)args->i8;
+  for (int32_t j0 = 0; j0 < n; j0 += IREE_VMVX_MATMUL_TILE_N) {
+    int32_t j1 = iree_min(n, j0 + IREE_VMVX_MATMUL_TILE_N);
+    for (int32_t k0 = 0; k0 < k; k0 += IREE_VMVX_MATMUL_TILE_K) {
+      int32_t k1 = iree_min(k, k0 + IREE_VMVX_MATMUL_TILE_K);
+      for (int32_t i = 0; i < m; ++i) {
+        const float* lhs_row = lhs + i * lhs_stride;
+        float* IREE_RESTRICT out_row = out + i * out_stride;
+        for (int32_t kk = k0; kk < k1; ++kk) {
+          const float lhs_value = lhs_row[kk];
+          const float* IREE_RESTRICT rhs_row = rhs + kk * rhs_stride;
+          for (int32_t j = j0; j < j1; ++j) {
+            out_row[j] += lhs_value * rhs_row[j];
+          }
+        }
+      }
+    }
+  }
   return iree_ok_status();
 }
 
@@ -0,0 +1,248 @@
+// Copyright 2021 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/modules/vmvx/module.h"
+
+#include <cstdint>
+#include <initializer_list>
+#include <string>
+#include <vector>
+
+#include "iree/base/api.h"
+#include "iree/testing/gtest.h"
+#include "iree/testing/status_matchers.h"
+#include "iree/vm/api.h"
+#include "iree/vm/ref_cc.h"
+
+namespace {
+
+// An argument to a VMVX function; either an i32 or a !vm.buffer.
+struct Arg {
+  Arg(int32_t value) : value(value) {}
+  Arg(const iree::vm::ref<iree_vm_buffer_t>& buffer) : buffer(buffer.get()) {}
+  int32_t value = 0;
+  iree_vm_buffer_t* buffer = nullptr;
+};
+
+// Calls the VMVX microkernels directly with buffers and offsets/strides/sizes
+// as the compiler would after flattening memrefs.
+class VMVXModuleTest : public ::testing::Test {
+ protected:
+  static void SetUpTestSuite() {
+    IREE_CHECK_OK(iree_vm_register_builtin_types());
+  }
+
+  virtual void SetUp() {
+    IREE_CHECK_OK(iree_vm_instance_create(iree_allocator_system(), &instance_));
+    iree_vm_module_t* module = nullptr;
+    IREE_CHECK_OK(iree_vmvx_module_create(iree_allocator_system(), &module));
+    IREE_CHECK_OK(iree_vm_context_create_with_modules(
+        instance_, &module, 1, iree_allocator_system(), &context_));
+    iree_vm_module_release(module);
+  }
+
+  virtual void TearDown() {
+    iree_vm_context_release(context_);
+    iree_vm_instance_release(instance_);
+  }
+
+  // Returns a new mutable buffer containing |values|.
+  template <typename T>
+  iree::vm::ref<iree_vm_buffer_t> CreateBuffer(const std::vector<T>& values) {
+    iree::vm::ref<iree_vm_buffer_t> buffer;
+    IREE_CHECK_OK(iree_vm_buffer_create(
+        IREE_VM_BUFFER_ACCESS_MUTABLE | IREE_VM_BUFFER_ACCESS_ORIGIN_HOST,
+        values.size() * sizeof(T), iree_allocator_system(), &buffer));
+    IREE_CHECK_OK(iree_vm_buffer_write_elements(
+        values.data(), buffer.get(), /*target_offset=*/0, values.size(),
+        sizeof(T)));
+    return buffer;
+  }
+
+  // Returns the contents of |buffer| as elements of type |T|.
+  template <typename T>
+  std::vector<T> ReadBuffer(const iree::vm::ref<iree_vm_buffer_t>& buffer) {
+    std::vector<T> values(iree_vm_buffer_length(buffer.get()) / sizeof(T));
+    IREE_CHECK_OK(iree_vm_buffer_read_elements(buffer.get(),
+                                               /*source_offset=*/0,
+                                               values.data(), values.size(),
+                                               sizeof(T)));
+    return values;
+  }
+
+  // Invokes the vmvx.|function_name| function with |args|.
+  iree_status_t Invoke(const char* function_name,
+                       std::initializer_list<Arg> args) {
+    std::string full_name = std::string("vmvx.") + function_name;
+    iree_vm_function_t function;
+    IREE_RETURN_IF_ERROR(iree_vm_context_resolve_function(
+        context_, iree_make_cstring_view(full_name.c_str()), &function));
+    iree::vm::ref<iree_vm_list_t> inputs;
+    IREE_RETURN_IF_ERROR(iree_vm_list_create(
+        /*element_type=*/nullptr, args.size(), iree_allocator_system(),
+        &inputs));
+    for (const auto& arg : args) {
+      if (arg.buffer) {
+        iree_vm_ref_t ref = iree_vm_buffer_retain_ref(arg.buffer);
+        IREE_RETURN_IF_ERROR(iree_vm_list_push_ref_move(inputs.get(), &ref));
+      } else {
+        iree_vm_value_t value = iree_vm_value_make_i32(arg.value);
+        IREE_RETURN_IF_ERROR(iree_vm_list_push_value(inputs.get(), &value));
+      }
+    }
+    return iree_vm_invoke(context_, function, /*policy=*/nullptr, inputs.get(),
+                          /*outputs=*/nullptr, iree_allocator_system());
+  }
+
+ private:
+  iree_vm_instance_t* instance_ = nullptr;
+  iree_vm_context_t* context_ = nullptr;
+};
+
+TEST_F(VMVXModuleTest, Copy2D) {
+  // Copies the middle 2x2 of a 4x4 source into the top-right of a 3x3 target.
+  auto source = CreateBuffer<uint16_t>({
+      0, 1, 2, 3,      //
+      4, 5, 6, 7,      //
+      8, 9, 10, 11,    //
+      12, 13, 14, 15,  //
+  });
+  auto target = CreateBuffer<uint16_t>(std::vector<uint16_t>(9, 0xFFFF));
+  IREE_ASSERT_OK(Invoke("copy.2d.x16", {source, 5, 4, 1,  //
+                                        target, 1, 3, 1,  //
+                                        2, 2}));
+  EXPECT_EQ(ReadBuffer<uint16_t>(target), (std::vector<uint16_t>{
+                                              0xFFFF, 5, 6,            //
+                                              0xFFFF, 9, 10,           //
+                                              0xFFFF, 0xFFFF, 0xFFFF,  //
+                                          }));
+}
+
+TEST_F(VMVXModuleTest, Copy2DTransposed) {
+  // Swapping the source strides transposes the 2x3 source into the target.
+  auto source = CreateBuffer<uint8_t>({1, 2, 3, 4, 5, 6});
+  auto target = CreateBuffer<uint8_t>(std::vector<uint8_t>(6, 0));
+  IREE_ASSERT_OK(Invoke("copy.2d.x8", {source, 0, 1, 3,  //
+                                       target, 0, 2, 1,  //
+                                       3, 2}));
+  EXPECT_EQ(ReadBuffer<uint8_t>(target),
+            (std::vector<uint8_t>{1, 4, 2, 5, 3, 6}));
+}
+
+TEST_F(VMVXModuleTest, Fill2D) {
+  // Fills every other element of the last row.
+  auto target = CreateBuffer<uint32_t>(std::vector<uint32_t>(8, 0));
+  IREE_ASSERT_OK(Invoke("fill.2d.x32", {0x12345678, target, 4, 4, 2, 1, 2}));
+  EXPECT_EQ(ReadBuffer<uint32_t>(target),
+            (std::vector<uint32_t>{0, 0, 0, 0, 0x12345678, 0, 0x12345678, 0}));
+}
+
+TEST_F(VMVXModuleTest, Fill2DTruncatesPattern) {
+  auto target = CreateBuffer<uint8_t>(std::vector<uint8_t>(4, 0));
+  IREE_ASSERT_OK(Invoke("fill.2d.x8", {0x1234, target, 1, 0, 1, 1, 2}));
+  EXPECT_EQ(ReadBuffer<uint8_t>(target),
+            (std::vector<uint8_t>{0, 0x34, 0x34, 0}));
+}
+
+TEST_F(VMVXModuleTest, Add2D) {
+  auto lhs = CreateBuffer<float>({1.0f, 2.0f, 3.0f, 4.0f});
+  auto rhs = CreateBuffer<float>({10.0f, 20.0f, 30.0f, 40.0f});
+  auto out = CreateBuffer<float>(std::vector<float>(4, 0.0f));
+  IREE_ASSERT_OK(Invoke("add.2d.f32", {lhs, 0, 2, 1,  //
+                                       rhs, 0, 2, 1,  //
+                                       out, 0, 2, 1,  //
+                                       2, 2}));
+  EXPECT_EQ(ReadBuffer<float>(out),
+            (std::vector<float>{11.0f, 22.0f, 33.0f, 44.0f}));
+}
+
+TEST_F(VMVXModuleTest, Mul2DBroadcast) {
+  // A zero stride on the rhs broadcasts a single row across the lhs rows.
+  auto lhs = CreateBuffer<int32_t>({1, 2, 3, 4, 5, 6});
+  auto rhs = CreateBuffer<int32_t>({2, 3, 4});
+  auto out = CreateBuffer<int32_t>(std::vector<int32_t>(6, 0));
+  IREE_ASSERT_OK(Invoke("mul.2d.i32", {lhs, 0, 3, 1,  //
+                                       rhs, 0, 0, 1,  //
+                                       out, 0, 3, 1,  //
+                                       2, 3}));
+  EXPECT_EQ(ReadBuffer<int32_t>(out),
+            (std::vector<int32_t>{2, 6, 12, 8, 15, 24}));
+}
+
+TEST_F(VMVXModuleTest, Fma2D) {
+  auto a = CreateBuffer<float>({1.0f, 2.0f, 3.0f});
+  auto b = CreateBuffer<float>({4.0f, 5.0f, 6.0f});
+  auto c = CreateBuffer<float>({0.5f, 0.5f, 0.5f});
+  auto out = CreateBuffer<float>(std::vector<float>(3, 0.0f));
+  IREE_ASSERT_OK(Invoke("fma.2d.f32", {a, 0, 0, 1,    //
+                                       b, 0, 0, 1,    //
+                                       c, 0, 0, 1,    //
+                                       out, 0, 0, 1,  //
+                                       1, 3}));
+  EXPECT_EQ(ReadBuffer<float>(out), (std::vector<float>{4.5f, 10.5f, 18.5f}));
+}
+
+TEST_F(VMVXModuleTest, ReduceSum2D) {
+  // Rows longer than the accumulator lane count exercise the split loop.
+  std::vector<int32_t> in_values(2 * 19);
+  for (size_t i = 0; i < in_values.size(); ++i) in_values[i] = (int32_t)i;
+  auto in = CreateBuffer<int32_t>(in_values);
+  auto out = CreateBuffer<int32_t>({100, 200});
+  IREE_ASSERT_OK(Invoke("reduce.sum.2d.i32", {in, 0, 19, 1,  //
+                                              out, 0, 1,     //
+                                              2, 19}));
+  // sum(0..18) = 171 and sum(19..37) = 532.
+  EXPECT_EQ(ReadBuffer<int32_t>(out), (std::vector<int32_t>{271, 732}));
+}
+
+TEST_F(VMVXModuleTest, ReduceMax2DStrided) {
+  // Reduces the columns of a 2x3 input by swapping the strides.
+  auto in = CreateBuffer<float>({1.0f, 8.0f, -3.0f, 4.0f, 2.0f, -6.0f});
+  auto out = CreateBuffer<float>({-100.0f, -100.0f, -100.0f});
+  IREE_ASSERT_OK(Invoke("reduce.max.2d.f32", {in, 0, 1, 3,  //
+                                              out, 0, 1,    //
+                                              3, 2}));
+  EXPECT_EQ(ReadBuffer<float>(out), (std::vector<float>{4.0f, 8.0f, -3.0f}));
+}
+
+TEST_F(VMVXModuleTest, Matmul) {
+  // out[2x3] += lhs[2x2] * rhs[2x3] with a padded lhs row stride.
+  auto lhs = CreateBuffer<float>({1.0f, 2.0f, 0.0f,  //
+                                  3.0f, 4.0f, 0.0f});
+  auto rhs = CreateBuffer<float>({1.0f, 0.0f, 2.0f,  //
+                                  0.0f, 1.0f, 3.0f});
+  auto out = CreateBuffer<float>(std::vector<float>(6, 1.0f));
+  IREE_ASSERT_OK(Invoke("matmul.f32f32f32", {lhs, 0, 3,  //
+                                             rhs, 0, 3,  //
+                                             out, 0, 3,  //
+                                             2, 3, 2}));
+  EXPECT_EQ(ReadBuffer<float>(out), (std::vector<float>{
+                                        2.0f, 3.0f, 9.0f,   //
+                                        4.0f, 5.0f, 19.0f,  //
+                                    }));
+}
+
+TEST_F(VMVXModuleTest, EmptyView) {
+  // Empty views are never dereferenced and so may have any offset.
+  auto target = CreateBuffer<uint32_t>({0});
+  IREE_EXPECT_OK(Invoke("fill.2d.x32", {1, target, 100, 1, 1, 0, 4}));
+  EXPECT_EQ(ReadBuffer<uint32_t>(target), (std::vector<uint32_t>{0}));
+}
+
+TEST_F(VMVXModuleTest, ViewOutOfRange) {
+  auto target = CreateBuffer<uint32_t>(std::vector<uint32_t>(4, 0));
+  IREE_EXPECT_STATUS_IS(IREE_STATUS_OUT_OF_RANGE,
+                        Invoke("fill.2d.x32", {1, target, 1, 2, 1, 2, 2}));
+  EXPECT_EQ(ReadBuffer<uint32_t>(target), (std::vector<uint32_t>(4, 0)));
+}
+
+TEST_F(VMVXModuleTest, NegativeView) {
+  auto target = CreateBuffer<uint32_t>(std::vector<uint32_t>(4, 0));
+  IREE_EXPECT_STATUS_IS(IREE_STATUS_INVALID_ARGUMENT,
+                        Invoke("fill.2d.x32", {1, target, -1, 1, 1, 1, 1}));
+}
+
+}  // namespace
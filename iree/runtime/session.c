@@ -211,23 +211,27 @@ iree_runtime_session_append_bytecode_module_from_file(
   IREE_TRACE_ZONE_BEGIN(z0);
   IREE_TRACE_ZONE_APPEND_TEXT(z0, file_path);
 
-  // TODO(#3909): actually map the memory here. For now we just load the
-  // contents.
-  iree_allocator_t flatbuffer_allocator =
-      iree_runtime_session_host_allocator(session);
-  iree_byte_span_t flatbuffer_data;
+  // Map the file read-only so that the pages (including all rodata segments
+  // the module references in-place) are shared with any other process mapping
+  // the same file and only paged in as they are used. The module takes
+  // ownership of the mapping and unmaps it when destroyed.
+  iree_file_contents_t* flatbuffer_contents = NULL;
   IREE_RETURN_AND_END_ZONE_IF_ERROR(
-      z0, iree_file_read_contents(file_path, flatbuffer_allocator,
-                                  &flatbuffer_data));
+      z0, iree_file_map_contents(file_path, IREE_FILE_MAP_FLAG_PREFETCH,
+                                 iree_runtime_session_host_allocator(session),
+                                 &flatbuffer_contents));
 
-  iree_status_t status =
-      iree_runtime_session_append_bytecode_module_from_memory(
-          session,
-          iree_make_const_byte_span(flatbuffer_data.data,
-                                    flatbuffer_data.data_length),
-          flatbuffer_allocator);
-  if (!iree_status_is_ok(status)) {
-    iree_allocator_free(flatbuffer_allocator, flatbuffer_data.data);
+  iree_vm_module_t* module = NULL;
+  iree_status_t status = iree_vm_bytecode_module_create(
+      flatbuffer_contents->const_buffer,
+      iree_file_contents_deallocator(flatbuffer_contents),
+      iree_runtime_session_host_allocator(session), &module);
+  if (iree_status_is_ok(status)) {
+    // The module owns the contents now and will free them when destroyed.
+    status = iree_runtime_session_append_module(session, module);
+    iree_vm_module_release(module);
+  } else {
+    iree_file_contents_free(flatbuffer_contents);
   }
 
   IREE_TRACE_ZONE_END(z0);
@@ -286,10 +290,8 @@ IREE_API_EXPORT iree_status_t iree_runtime_session_call_direct(
       iree_vm_context_state_resolver(iree_runtime_session_context(session)),
       iree_runtime_session_host_allocator(session));
 
-  // Issue the call.
-  iree_vm_execution_result_t result;
-  iree_status_t status = call->function.module->begin_call(
-      call->function.module->self, stack, call, &result);
+  // Issue the call and run it to completion.
+  iree_status_t status = iree_vm_invoke_call(stack, call);
 
   // Cleanup the stack.
   iree_vm_stack_deinitialize(stack);
@@ -151,6 +151,10 @@ iree_runtime_session_append_bytecode_module_from_memory(
     iree_allocator_t flatbuffer_allocator);
 
 // Appends a bytecode module to the context loaded from the given |file_path|.
+// Where supported the file is memory mapped read-only and shared with other
+// processes mapping the same file. Module contents such as rodata segments are
+// referenced in-place and paged in on demand. The mapping is retained until
+// the module is destroyed.
 //
 // NOTE: only valid if the context is not yet frozen; see
 // iree_vm_context_freeze for more information.
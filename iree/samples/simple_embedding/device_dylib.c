@@ -10,6 +10,7 @@
 
 #include "iree/base/api.h"
 #include "iree/hal/api.h"
+#include "iree/hal/local/executable_import_registry.h"
 #include "iree/hal/local/executable_loader.h"
 #include "iree/hal/local/loaders/embedded_library_loader.h"
 #include "iree/hal/local/loaders/legacy_library_loader.h"
@@ -23,10 +24,13 @@ iree_status_t create_sample_device(iree_hal_device_t** device) {
 
   iree_hal_executable_loader_t* loaders[2] = {NULL, NULL};
   iree_host_size_t loader_count = 0;
+  iree_hal_executable_import_provider_t import_provider =
+      iree_hal_executable_import_registry_provider(
+          iree_hal_executable_import_registry_builtin());
   IREE_RETURN_IF_ERROR(iree_hal_embedded_library_loader_create(
-      iree_allocator_system(), &loaders[loader_count++]));
+      import_provider, iree_allocator_system(), &loaders[loader_count++]));
   IREE_RETURN_IF_ERROR(iree_hal_legacy_library_loader_create(
-      iree_allocator_system(), &loaders[loader_count++]));
+      import_provider, iree_allocator_system(), &loaders[loader_count++]));
 
   iree_task_executor_t* executor = NULL;
   IREE_RETURN_IF_ERROR(
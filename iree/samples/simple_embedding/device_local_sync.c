@@ -10,6 +10,7 @@
 
 #include "iree/base/api.h"
 #include "iree/hal/api.h"
+#include "iree/hal/local/executable_import_registry.h"
 #include "iree/hal/local/executable_loader.h"
 #include "iree/hal/local/loaders/legacy_library_loader.h"
 #include "iree/hal/local/sync_device.h"
@@ -22,6 +23,8 @@ iree_status_t create_sample_device(iree_hal_device_t** device) {
   iree_hal_executable_loader_t* dylib_loader = NULL;
   // TODO(marbre): Use embedded instead of legacy loader.
   IREE_RETURN_IF_ERROR(iree_hal_legacy_library_loader_create(
+      iree_hal_executable_import_registry_provider(
+          iree_hal_executable_import_registry_builtin()),
       iree_allocator_system(), &dylib_loader));
   iree_hal_executable_loader_t* loaders[1] = {dylib_loader};
 
@@ -12,6 +12,7 @@
 #include "iree/base/internal/flags.h"
 #include "iree/base/tracing.h"
 #include "iree/task/topology.h"
+#include "iree/task/tuning.h"
 
 //===----------------------------------------------------------------------===//
 // Executor configuration
@@ -33,6 +34,13 @@ IREE_FLAG(
     "threads that would otherwise need to perform the syscalls during\n"
     "coordination.");
 
+IREE_FLAG(
+    int32_t, task_worker_local_memory,
+    IREE_TASK_WORKER_DEFAULT_LOCAL_MEMORY_SIZE,
+    "Specifies the bytes of per-worker local memory allocated for use by\n"
+    "dispatched tiles. Tiles may use this for scratch storage and reduce the\n"
+    "need for heap allocations or large stack frames. Set to 0 to disable.");
+
 //===----------------------------------------------------------------------===//
 // Topology configuration
 //===----------------------------------------------------------------------===//
@@ -50,7 +58,17 @@ IREE_FLAG(
     "   cores up to the value specified by --task_topology_max_group_count.\n"
     "   This optimizes for temporal and spatial cache locality but may suffer\n"
     "   from oversubscription if there are other processes trying to use the\n"
-    "   same cores.\n");
+    "   same cores.\n"
+    " 'numa_nodes':\n"
+    "   Creates one group per physical core distributed evenly across all\n"
+    "   NUMA nodes up to the value specified by\n"
+    "   --task_topology_max_group_count. Workers are ordered by node such\n"
+    "   that work stealing and dispatch slices stay on the node that\n"
+    "   produced them where possible.\n"
+    " 'l3_cache_domains':\n"
+    "   Like 'numa_nodes' but distributes groups across unique L3\n"
+    "   (last-level) cache domains, which may be finer grained than NUMA\n"
+    "   nodes on chiplet architectures.\n");
 
 IREE_FLAG(
     int32_t, task_topology_group_count, 0,
@@ -65,6 +83,13 @@ IREE_FLAG(
     "detected and used when --task_topology_group_count=0 and is ignored\n"
     "otherwise.\n");
 
+IREE_FLAG(
+    int32_t, task_topology_numa_node, -1,
+    "Restricts the task system to the physical cores of the given NUMA node\n"
+    "when --task_topology_group_count=0. Up to\n"
+    "--task_topology_max_group_count groups will be created. Specifying -1\n"
+    "uses all nodes as specified by --task_topology_mode.\n");
+
 // TODO(benvanik): add --task_topology_dump to dump out the current machine
 // configuration as seen by the topology utilities.
 
@@ -94,12 +119,22 @@ iree_status_t iree_task_executor_create_from_flags(
   if (FLAG_task_topology_group_count != 0) {
     iree_task_topology_initialize_from_group_count(
         FLAG_task_topology_group_count, &topology);
+  } else if (FLAG_task_topology_numa_node >= 0) {
+    iree_task_topology_initialize_from_numa_node(
+        (uint32_t)FLAG_task_topology_numa_node,
+        FLAG_task_topology_max_group_count, &topology);
   } else if (strcmp(FLAG_task_topology_mode, "physical_cores") == 0) {
     iree_task_topology_initialize_from_physical_cores(
         FLAG_task_topology_max_group_count, &topology);
   } else if (strcmp(FLAG_task_topology_mode, "unique_l2_cache_groups") == 0) {
     iree_task_topology_initialize_from_unique_l2_cache_groups(
         FLAG_task_topology_max_group_count, &topology);
+  } else if (strcmp(FLAG_task_topology_mode, "numa_nodes") == 0) {
+    iree_task_topology_initialize_from_numa_nodes(
+        FLAG_task_topology_max_group_count, &topology);
+  } else if (strcmp(FLAG_task_topology_mode, "l3_cache_domains") == 0) {
+    iree_task_topology_initialize_from_l3_cache_domains(
+        FLAG_task_topology_max_group_count, &topology);
   } else {
     status = iree_make_status(
         IREE_STATUS_INVALID_ARGUMENT,
@@ -109,8 +144,10 @@ iree_status_t iree_task_executor_create_from_flags(
   }
 
   if (iree_status_is_ok(status)) {
-    status = iree_task_executor_create(scheduling_mode, &topology,
-                                       host_allocator, out_executor);
+    status = iree_task_executor_create(
+        scheduling_mode, &topology,
+        (iree_host_size_t)iree_max(0, FLAG_task_worker_local_memory),
+        host_allocator, out_executor);
   }
 
   iree_task_topology_deinitialize(&topology);
@@ -23,10 +23,12 @@
 #include "iree/task/worker.h"
 
 static void iree_task_executor_destroy(iree_task_executor_t* executor);
+static int iree_task_executor_wait_thread_main(iree_task_executor_t* executor);
 
 iree_status_t iree_task_executor_create(
     iree_task_scheduling_mode_t scheduling_mode,
-    const iree_task_topology_t* topology, iree_allocator_t allocator,
+    const iree_task_topology_t* topology,
+    iree_host_size_t worker_local_memory_size, iree_allocator_t allocator,
     iree_task_executor_t** out_executor) {
   iree_host_size_t worker_count = iree_task_topology_group_count(topology);
   if (worker_count > IREE_TASK_EXECUTOR_MAX_WORKER_COUNT) {
@@ -48,13 +50,26 @@ iree_status_t iree_task_executor_create(
   IREE_ASSERT_ARGUMENT(out_executor);
   *out_executor = NULL;
 
-  iree_host_size_t executor_size =
+  // Worker-local memory is stored at the end of the executor allocation with
+  // each worker's memory aligned to a cache line. We overallocate by one
+  // alignment unit as the allocator only guarantees iree_max_align_t.
+  worker_local_memory_size = iree_host_align(
+      worker_local_memory_size, IREE_TASK_WORKER_LOCAL_MEMORY_ALIGNMENT);
+  iree_host_size_t executor_base_size =
       sizeof(iree_task_executor_t) + worker_count * sizeof(iree_task_worker_t);
+  iree_host_size_t executor_size = executor_base_size;
+  if (worker_local_memory_size > 0) {
+    executor_size += IREE_TASK_WORKER_LOCAL_MEMORY_ALIGNMENT +
+                     worker_count * worker_local_memory_size;
+  }
 
   iree_task_executor_t* executor = NULL;
   IREE_RETURN_AND_END_ZONE_IF_ERROR(
       z0, iree_allocator_malloc(allocator, executor_size, (void**)&executor));
-  memset(executor, 0, executor_size);
+  // NOTE: worker-local memory is not cleared here so that its pages are first
+  // touched by the worker threads using them. On NUMA systems this allocates
+  // the pages on the node of each worker instead of the node of the caller.
+  memset(executor, 0, executor_base_size);
   iree_atomic_ref_count_init(&executor->ref_count);
   executor->allocator = allocator;
   executor->scheduling_mode = scheduling_mode;
@@ -62,6 +77,7 @@ iree_status_t iree_task_executor_create(
   iree_atomic_task_slist_initialize(&executor->incoming_waiting_slist);
   iree_slim_mutex_initialize(&executor->coordinator_mutex);
   iree_slim_mutex_initialize(&executor->wait_mutex);
+  iree_notification_initialize(&executor->wait_thread_state_notification);
 
   // Simple PRNG used to generate seeds for the per-worker PRNGs used to
   // distribute work. This isn't strong (and doesn't need to be); it's just
@@ -79,10 +95,20 @@ iree_status_t iree_task_executor_create(
 
   // Wait set used to batch syscalls for polling/waiting on wait handles.
   // This is currently limited to a relatively small max to make bad behavior
-  // clearer with nice RESOURCE_EXHAUSTED errors.
+  // clearer with nice RESOURCE_EXHAUSTED errors. The one reserved handle is
+  // used to wake whichever thread is blocked waiting on the wait set.
+  if (iree_status_is_ok(status)) {
+    status =
+        iree_wait_set_allocate(IREE_TASK_EXECUTOR_MAX_OUTSTANDING_WAITS + 1,
+                               allocator, &executor->wait_set);
+  }
   if (iree_status_is_ok(status)) {
-    status = iree_wait_set_allocate(IREE_TASK_EXECUTOR_MAX_OUTSTANDING_WAITS,
-                                    allocator, &executor->wait_set);
+    status = iree_event_initialize(/*initial_state=*/false,
+                                   &executor->wait_wake_event);
+    if (iree_status_is_ok(status)) {
+      status = iree_wait_set_insert(executor->wait_set,
+                                    executor->wait_wake_event);
+    }
   }
 
   // Pool used for all dispatch->slice fanout tasks. These only live within the
@@ -108,10 +134,24 @@ iree_status_t iree_task_executor_create(
   if (iree_status_is_ok(status)) {
     executor->worker_count = worker_count;
     executor->workers = (iree_task_worker_t*)(executor + 1);
+    uint8_t* worker_local_memory_base = (uint8_t*)iree_host_align(
+        (uintptr_t)executor + executor_base_size,
+        IREE_TASK_WORKER_LOCAL_MEMORY_ALIGNMENT);
     iree_task_affinity_set_t worker_idle_mask = 0;
     iree_task_affinity_set_t worker_live_mask = 0;
     iree_task_affinity_set_t worker_suspend_mask = 0;
+    executor->numa_node_count = 1;
     for (iree_host_size_t i = 0; i < worker_count; ++i) {
+      const iree_task_topology_group_t* group =
+          iree_task_topology_get_group(topology, i);
+      bool is_new_numa_node = i > 0;
+      for (iree_host_size_t j = 0; j < i && is_new_numa_node; ++j) {
+        is_new_numa_node =
+            iree_task_topology_get_group(topology, j)->numa_node !=
+            group->numa_node;
+      }
+      if (is_new_numa_node) ++executor->numa_node_count;
+
       iree_task_affinity_set_t worker_bit = iree_task_affinity_for_worker(i);
       worker_idle_mask |= worker_bit;
       worker_live_mask |= worker_bit;
@@ -120,10 +160,15 @@ iree_status_t iree_task_executor_create(
         worker_suspend_mask |= worker_bit;
       }
 
+      iree_byte_span_t local_memory = iree_make_byte_span(NULL, 0);
+      if (worker_local_memory_size > 0) {
+        local_memory = iree_make_byte_span(
+            worker_local_memory_base + i * worker_local_memory_size,
+            worker_local_memory_size);
+      }
       iree_task_worker_t* worker = &executor->workers[i];
       status = iree_task_worker_initialize(
-          executor, i, iree_task_topology_get_group(topology, i), &seed_prng,
-          worker);
+          executor, i, group, local_memory, &seed_prng, worker);
       if (!iree_status_is_ok(status)) break;
     }
     iree_atomic_task_affinity_set_store(&executor->worker_live_mask,
@@ -137,6 +182,24 @@ iree_status_t iree_task_executor_create(
                                         iree_memory_order_relaxed);
   }
 
+  // Bring up the wait thread now that there are workers for it to post to.
+  // It will immediately block until waits are submitted.
+  if (iree_status_is_ok(status) &&
+      (scheduling_mode & IREE_TASK_SCHEDULING_MODE_DEDICATED_WAIT_THREAD)) {
+    iree_thread_create_params_t thread_params;
+    memset(&thread_params, 0, sizeof(thread_params));
+    thread_params.name = iree_make_cstring_view("iree-task-wait");
+    // Waits gate the scheduling of any dependent work so we want the thread to
+    // run as soon as they resolve; it otherwise spends all its time blocked.
+    thread_params.priority_class = IREE_THREAD_PRIORITY_CLASS_HIGH;
+    iree_atomic_store_int32(&executor->wait_thread_state,
+                            IREE_TASK_EXECUTOR_WAIT_THREAD_STATE_RUNNING,
+                            iree_memory_order_seq_cst);
+    status = iree_thread_create(
+        (iree_thread_entry_t)iree_task_executor_wait_thread_main, executor,
+        thread_params, allocator, &executor->wait_thread);
+  }
+
   if (!iree_status_is_ok(status)) {
     // NOTE: destroy will ensure that any workers we have initialized are
     // properly cleaned up.
@@ -150,10 +213,32 @@ iree_status_t iree_task_executor_create(
   return iree_ok_status();
 }
 
+// Returns true if the wait thread is in the zombie state (exited and awaiting
+// teardown).
+static bool iree_task_executor_wait_thread_is_zombie(
+    iree_task_executor_t* executor) {
+  return iree_atomic_load_int32(&executor->wait_thread_state,
+                                iree_memory_order_seq_cst) ==
+         IREE_TASK_EXECUTOR_WAIT_THREAD_STATE_ZOMBIE;
+}
+
 static void iree_task_executor_destroy(iree_task_executor_t* executor) {
   if (!executor) return;
   IREE_TRACE_ZONE_BEGIN(z0);
 
+  // Stop the wait thread first as it may post work to the workers.
+  if (executor->wait_thread) {
+    iree_atomic_store_int32(&executor->wait_thread_state,
+                            IREE_TASK_EXECUTOR_WAIT_THREAD_STATE_EXITING,
+                            iree_memory_order_seq_cst);
+    iree_event_set(&executor->wait_wake_event);
+    iree_notification_await(
+        &executor->wait_thread_state_notification,
+        (iree_condition_fn_t)iree_task_executor_wait_thread_is_zombie,
+        executor);
+    iree_thread_release(executor->wait_thread);
+  }
+
   // First ask all workers to exit. We do this prior to waiting on them to exit
   // so that we parallelize the shutdown logic (which may flush pending tasks).
   for (iree_host_size_t i = 0; i < executor->worker_count; ++i) {
@@ -161,6 +246,10 @@ static void iree_task_executor_destroy(iree_task_executor_t* executor) {
     iree_task_worker_request_exit(worker);
   }
 
+  // Wake any worker blocked waiting on the wait_set so that it sees the exit
+  // request.
+  iree_event_set(&executor->wait_wake_event);
+
   // Now that all workers should be in the process of exiting we can join with
   // them. Some may take longer than others to exit but that's fine as we can't
   // return from here until they do anyway.
@@ -169,7 +258,16 @@ static void iree_task_executor_destroy(iree_task_executor_t* executor) {
     iree_task_worker_deinitialize(worker);
   }
 
+  // Discard any tasks that never became ready, such as those still waiting on
+  // wait handles that were never signaled. This ends the scopes of any fences
+  // depending on them so that waiters on the scopes are not left hanging.
+  iree_atomic_task_slist_discard(&executor->incoming_ready_slist);
+  iree_atomic_task_slist_discard(&executor->incoming_waiting_slist);
+  iree_task_list_discard(&executor->waiting_list);
+
   iree_wait_set_free(executor->wait_set);
+  iree_event_deinitialize(&executor->wait_wake_event);
+  iree_notification_deinitialize(&executor->wait_thread_state_notification);
   iree_slim_mutex_deinitialize(&executor->wait_mutex);
   iree_slim_mutex_deinitialize(&executor->coordinator_mutex);
   iree_atomic_task_slist_deinitialize(&executor->incoming_ready_slist);
@@ -295,6 +393,21 @@ void iree_task_executor_schedule_ready_tasks(
   IREE_TRACE_ZONE_END(z0);
 }
 
+// Concatenates |waiting_list| onto the incoming waiting list and wakes the
+// dedicated wait thread (if any) so that it begins waiting on the new tasks.
+// The list is reset and may not be used after the call.
+static void iree_task_executor_post_waiting_list(
+    iree_task_executor_t* executor, iree_task_list_t* waiting_list) {
+  if (iree_task_list_is_empty(waiting_list)) return;
+  iree_atomic_task_slist_concat(&executor->incoming_waiting_slist,
+                                waiting_list->head, waiting_list->tail);
+  iree_task_list_initialize(waiting_list);
+  if (executor->scheduling_mode &
+      IREE_TASK_SCHEDULING_MODE_DEDICATED_WAIT_THREAD) {
+    iree_event_set(&executor->wait_wake_event);
+  }
+}
+
 void iree_task_executor_merge_submission(iree_task_executor_t* executor,
                                          iree_task_submission_t* submission) {
   // Concatenate all of the incoming tasks into the submission list.
@@ -304,9 +417,7 @@ void iree_task_executor_merge_submission(iree_task_executor_t* executor,
   iree_atomic_task_slist_concat(&executor->incoming_ready_slist,
                                 submission->ready_list.head,
                                 submission->ready_list.tail);
-  iree_atomic_task_slist_concat(&executor->incoming_waiting_slist,
-                                submission->waiting_list.head,
-                                submission->waiting_list.tail);
+  iree_task_executor_post_waiting_list(executor, &submission->waiting_list);
 
   // NOTE: after concatenating the intrusive next_task pointers may immediately
   // be modified by other threads. We can no longer assume anything about the
@@ -336,16 +447,38 @@ void iree_task_executor_flush(iree_task_executor_t* executor) {
   IREE_TRACE_ZONE_END(z0);
 }
 
+// Returns true if |wake_handle| is the executor's own wait_wake_event.
+static bool iree_task_executor_is_wait_wake_event(
+    iree_task_executor_t* executor, iree_wait_handle_t wake_handle) {
+  return wake_handle.type == executor->wait_wake_event.type &&
+         memcmp(&wake_handle.value, &executor->wait_wake_event.value,
+                sizeof(wake_handle.value)) == 0;
+}
+
 // Merges incoming likely-unresolved wait tasks into the primary executor lists.
 // The handle of each task will be inserted into the wait_set (where it may be
 // a duplicate).
 //
-// Only called during coordination and expects the coordinator lock to be held.
+// Takes the wait lock itself. Without a wait thread this is called by the
+// coordinator with the coordinator lock held; with one it is only called by the
+// wait thread, which does not take the coordinator lock. If the wait lock is
+// held by a worker blocked in the wait_set the merge is marked as pending and
+// the wait_wake_event is set to interrupt the wait so the lock gets released.
 static void iree_task_executor_merge_wait_list(
     iree_task_executor_t* executor, iree_task_list_t* incoming_waiting_list) {
   if (iree_task_list_is_empty(incoming_waiting_list)) return;
 
-  iree_slim_mutex_lock(&executor->wait_mutex);
+  // A worker may be blocked waiting on the wait_set while holding the wait
+  // lock; wake it so that it releases the lock and we can insert. Workers
+  // won't start a new blocking wait while a merge is pending.
+  if (!iree_slim_mutex_try_lock(&executor->wait_mutex)) {
+    iree_atomic_fetch_add_int32(&executor->wait_merge_pending_count, 1,
+                                iree_memory_order_seq_cst);
+    iree_event_set(&executor->wait_wake_event);
+    iree_slim_mutex_lock(&executor->wait_mutex);
+    iree_atomic_fetch_sub_int32(&executor->wait_merge_pending_count, 1,
+                                iree_memory_order_seq_cst);
+  }
 
   // Walk the list of incoming wait tasks and add them to our wait_set.
   iree_task_wait_t* wait_task =
@@ -424,6 +557,12 @@ static void iree_task_executor_poll_waiting_tasks(
     iree_status_t status = iree_wait_any(executor->wait_set,
                                          IREE_TIME_INFINITE_PAST, &wake_handle);
     if (iree_status_is_ok(status)) {
+      if (iree_task_executor_is_wait_wake_event(executor, wake_handle)) {
+        // Meant for a blocked worker but no one is blocked while we hold the
+        // wait lock; workers check their wake conditions before blocking.
+        iree_event_reset(&executor->wait_wake_event);
+        continue;
+      }
       // One or more waiters is ready. We don't support multi-wake right now so
       // we'll just take the one we got back and try again.
       iree_task_executor_wake_waiting_task(executor, wake_handle,
@@ -483,13 +622,58 @@ static void iree_task_executor_wait_any_task(
   //     try steal
   //     if fail to steal: coordinate
 
-  iree_slim_mutex_lock(&executor->wait_mutex);
+  // Only one worker waits on the wait_set at a time; if another already is
+  // then it will handle any waits that resolve and we can go idle until work is
+  // posted to us. If the lock is only briefly held by a coordinator merging or
+  // polling waits then we retry so that the waits are not left unattended.
+  if (!iree_slim_mutex_try_lock(&executor->wait_mutex)) {
+    if (!iree_atomic_task_affinity_set_load(&executor->worker_waiting_mask,
+                                            iree_memory_order_seq_cst)) {
+      iree_notification_post(&current_worker->wake_notification, 1);
+    }
+    iree_slim_mutex_lock(&executor->coordinator_mutex);
+    IREE_TRACE_ZONE_END(z0);
+    return;
+  }
 
-  iree_time_t deadline_ns = IREE_TIME_INFINITE_FUTURE;
+  // While we are blocked other threads may need us to return: coordinators to
+  // merge new waits into the wait_set and posters to have us run the tasks
+  // they've posted to our mailbox. Both set the wait_wake_event after
+  // publishing their request and we reset it and check for requests before
+  // blocking so that none are missed. Tasks posted before we marked ourselves
+  // as waiting are found by flushing our mailbox.
+  iree_atomic_task_affinity_set_fetch_or(&executor->worker_waiting_mask,
+                                         current_worker->worker_bit,
+                                         iree_memory_order_seq_cst);
+  iree_task_t* posted_task = iree_task_queue_flush_from_lifo_slist(
+      &current_worker->local_task_queue, &current_worker->mailbox_slist);
+  if (posted_task) {
+    iree_task_queue_push_front(&current_worker->local_task_queue, posted_task);
+  }
+  iree_event_reset(&executor->wait_wake_event);
+  bool was_interrupted =
+      posted_task != NULL ||
+      !(iree_atomic_task_affinity_set_load(&executor->worker_waiting_mask,
+                                           iree_memory_order_seq_cst) &
+        current_worker->worker_bit) ||
+      iree_atomic_load_int32(&executor->wait_merge_pending_count,
+                             iree_memory_order_seq_cst) > 0 ||
+      iree_atomic_load_int32(&current_worker->state,
+                             iree_memory_order_seq_cst) ==
+          IREE_TASK_WORKER_STATE_EXITING;
+  iree_status_t status = iree_ok_status();
   iree_wait_handle_t wake_handle;
-  iree_status_t status =
-      iree_wait_any(executor->wait_set, deadline_ns, &wake_handle);
+  if (!was_interrupted) {
+    status = iree_wait_any(executor->wait_set, IREE_TIME_INFINITE_FUTURE,
+                           &wake_handle);
+    was_interrupted =
+        iree_status_is_ok(status) &&
+        iree_task_executor_is_wait_wake_event(executor, wake_handle);
+  }
 
+  iree_atomic_task_affinity_set_fetch_and(&executor->worker_waiting_mask,
+                                          ~current_worker->worker_bit,
+                                          iree_memory_order_seq_cst);
   iree_slim_mutex_unlock(&executor->wait_mutex);
 
   // TODO(#4026): propagate failure to all scopes involved.
@@ -499,7 +683,11 @@ static void iree_task_executor_wait_any_task(
   iree_slim_mutex_lock(&executor->coordinator_mutex);
 
   int woken_tasks = 0;
-  if (iree_status_is_ok(status)) {
+  if (was_interrupted) {
+    // Asked to return to coordination; nothing has resolved. Unless we have
+    // been posted work we'll come back around and wait again.
+    iree_notification_post(&current_worker->wake_notification, 1);
+  } else if (iree_status_is_ok(status)) {
     // One or more waiters is ready. We don't support multi-wake right now so
     // we'll just take the one we got back and try again.
     iree_task_executor_wake_waiting_task(executor, wake_handle,
@@ -562,11 +750,19 @@ void iree_task_executor_coordinate(iree_task_executor_t* executor,
     // breadth-first traversal of task graphs even if they originate from
     // various places and have no relation - hopefully leading to better average
     // latency.
+    //
+    // When there is a dedicated wait thread it owns the incoming waiting list
+    // and the coordinator only hands off newly waiting tasks to it.
+    bool use_wait_thread =
+        (executor->scheduling_mode &
+         IREE_TASK_SCHEDULING_MODE_DEDICATED_WAIT_THREAD) != 0;
     iree_task_submission_t pending_submission;
     iree_task_submission_initialize_from_lifo_slist(
         &executor->incoming_ready_slist, &pending_submission);
-    iree_task_list_append_from_fifo_slist(&pending_submission.waiting_list,
-                                          &executor->incoming_waiting_slist);
+    if (!use_wait_thread) {
+      iree_task_list_append_from_fifo_slist(&pending_submission.waiting_list,
+                                            &executor->incoming_waiting_slist);
+    }
 
     // Scratch coordinator submission batch used during scheduling to batch up
     // all tasks that will be posted to each worker. We could stash this on the
@@ -587,7 +783,9 @@ void iree_task_executor_coordinate(iree_task_executor_t* executor,
     // If any waits have resolved then they'll be moved to the ready list here
     // and then get processed FIFO with the tasks that were ready in the
     // request.
-    iree_task_executor_poll_waiting_tasks(executor, &pending_submission);
+    if (!use_wait_thread) {
+      iree_task_executor_poll_waiting_tasks(executor, &pending_submission);
+    }
 
     // Schedule all ready tasks in this batch. Some may complete inline (such
     // as ready barriers with all their dependencies resolved) while others may
@@ -595,19 +793,26 @@ void iree_task_executor_coordinate(iree_task_executor_t* executor,
     iree_task_executor_schedule_ready_tasks(executor, &pending_submission,
                                             post_batch);
 
-    // Merge any newly waiting tasks into the global wait list.
-    iree_task_executor_merge_wait_list(executor,
-                                       &pending_submission.waiting_list);
+    // Merge any newly waiting tasks into the global wait list (or pass them
+    // off to the wait thread).
+    if (use_wait_thread) {
+      iree_task_executor_post_waiting_list(executor,
+                                           &pending_submission.waiting_list);
+    } else {
+      iree_task_executor_merge_wait_list(executor,
+                                         &pending_submission.waiting_list);
+    }
 
     // Post all new work to workers; they may wake and begin executing
     // immediately. Returns whether this worker has new tasks for it to work on.
     bool did_post = iree_task_post_batch_submit(post_batch);
-    if (!did_post && wait_on_idle) {
+    if (!did_post && wait_on_idle && !use_wait_thread) {
       // No work was found; wait on one or more of our wait handles.
       // This will block the calling thread but that's fine as they were going
       // to wait anyway and were just speculatively seeing if there was work
       // first by requesting coordination. If work completes here we'll catch it
-      // on the poll next loop around.
+      // on the poll next loop around. With a dedicated wait thread the worker
+      // instead goes idle and will be woken when the wait thread posts work.
       iree_task_executor_wait_any_task(executor, current_worker,
                                        &pending_submission);
     }
@@ -627,6 +832,107 @@ void iree_task_executor_coordinate(iree_task_executor_t* executor,
   IREE_TRACE_ZONE_END(z0);
 }
 
+// Blocks until one or more waiting tasks resolve or the wait thread is woken.
+// Any tasks made ready by the resolved waits are added to |pending_submission|.
+// After the first wake all other waits that have resolved are polled so that
+// they can be scheduled together.
+//
+// Only called from the dedicated wait thread.
+static void iree_task_executor_wait_thread_wait(
+    iree_task_executor_t* executor,
+    iree_task_submission_t* pending_submission) {
+  IREE_TRACE_ZONE_BEGIN(z0);
+  iree_slim_mutex_lock(&executor->wait_mutex);
+
+  int woken_tasks = 0;
+  iree_time_t deadline_ns = IREE_TIME_INFINITE_FUTURE;
+  while (true) {
+    iree_wait_handle_t wake_handle;
+    iree_status_t status =
+        iree_wait_any(executor->wait_set, deadline_ns, &wake_handle);
+    if (iree_status_is_deadline_exceeded(status)) {
+      // Indicates nothing more was woken.
+      break;
+    } else if (!iree_status_is_ok(status)) {
+      // (Spurious?) error during wait.
+      // TODO(#4026): propagate failure to all scopes involved.
+      IREE_ASSERT_TRUE(iree_status_is_ok(status));
+      iree_status_ignore(status);
+      break;
+    } else if (iree_task_executor_is_wait_wake_event(executor, wake_handle)) {
+      // New waits were posted or we were asked to exit; the caller will handle
+      // both before waiting again.
+      break;
+    }
+    iree_task_executor_wake_waiting_task(executor, wake_handle,
+                                         pending_submission);
+    ++woken_tasks;
+    deadline_ns = IREE_TIME_INFINITE_PAST;
+  }
+
+  iree_slim_mutex_unlock(&executor->wait_mutex);
+  IREE_TRACE_ZONE_APPEND_VALUE(z0, woken_tasks);
+  IREE_TRACE_ZONE_END(z0);
+}
+
+// Main function of the dedicated wait thread.
+// The thread takes the place of the coordinator in managing the waiting_list
+// and wait_set: coordinators post newly waiting tasks to the
+// incoming_waiting_slist and wake us with the wait_wake_event. When
+// waits resolve we schedule the tasks that depended on them directly to
+// workers instead of waiting for a worker to coordinate.
+static int iree_task_executor_wait_thread_main(iree_task_executor_t* executor) {
+  IREE_TRACE_ZONE_BEGIN_NAMED(thread_zone, "iree_task_executor_wait_thread");
+
+  // Scratch post batch reused across wakes. As with coordination this lives on
+  // the stack of the thread that uses it.
+  iree_task_post_batch_t* post_batch =
+      iree_alloca(sizeof(iree_task_post_batch_t) +
+                  executor->worker_count * sizeof(iree_task_list_t));
+
+  while (iree_atomic_load_int32(&executor->wait_thread_state,
+                                iree_memory_order_seq_cst) ==
+         IREE_TASK_EXECUTOR_WAIT_THREAD_STATE_RUNNING) {
+    // Reset the wake event prior to draining the incoming list so that any
+    // waits posted after we drain will wake us again.
+    iree_event_reset(&executor->wait_wake_event);
+
+    iree_task_submission_t pending_submission;
+    iree_task_submission_initialize(&pending_submission);
+    iree_task_list_append_from_fifo_slist(&pending_submission.waiting_list,
+                                          &executor->incoming_waiting_slist);
+    iree_task_executor_merge_wait_list(executor,
+                                       &pending_submission.waiting_list);
+
+    iree_task_executor_wait_thread_wait(executor, &pending_submission);
+
+    // Schedule any newly ready tasks to workers. Scheduling may retire tasks
+    // inline and we need to exclude coordinators while it does so.
+    if (!iree_task_list_is_empty(&pending_submission.ready_list)) {
+      iree_slim_mutex_lock(&executor->coordinator_mutex);
+      iree_task_post_batch_initialize(executor, /*current_worker=*/NULL,
+                                      post_batch);
+      iree_task_executor_schedule_ready_tasks(executor, &pending_submission,
+                                              post_batch);
+      iree_task_post_batch_submit(post_batch);
+      iree_slim_mutex_unlock(&executor->coordinator_mutex);
+    }
+
+    // Scheduling may have produced more waiting tasks (such as a wait
+    // dependent on another wait); these are ours to wait on.
+    iree_task_executor_merge_wait_list(executor,
+                                       &pending_submission.waiting_list);
+  }
+
+  IREE_TRACE_ZONE_END(thread_zone);
+  iree_atomic_store_int32(&executor->wait_thread_state,
+                          IREE_TASK_EXECUTOR_WAIT_THREAD_STATE_ZOMBIE,
+                          iree_memory_order_seq_cst);
+  iree_notification_post(&executor->wait_thread_state_notification,
+                         IREE_ALL_WAITERS);
+  return 0;
+}
+
 static iree_task_t* iree_task_executor_try_steal_task_from_affinity_set(
     iree_task_executor_t* executor, iree_task_affinity_set_t victim_mask,
     uint32_t max_theft_attempts, int rotation_offset,
@@ -680,7 +986,10 @@ static iree_task_t* iree_task_executor_try_steal_task_from_affinity_set(
 // We do a scan through ideal victims indicated by the
 // |constructive_sharing_mask|; these are the workers most likely to have some
 // cache benefits to taking their work as they share some level of the cache
-// hierarchy and should be better to steal from than any random worker.
+// hierarchy and should be better to steal from than any random worker. If none
+// of those have work we next try the workers on the same NUMA node indicated
+// by |numa_node_mask| and only then workers on remote nodes, as their work
+// likely touches memory that is remote to us.
 //
 // To prevent biasing any particular victim we use a fast prng function to
 // select where in the set of potential victims defined by the topology
@@ -690,7 +999,8 @@ static iree_task_t* iree_task_executor_try_steal_task_from_affinity_set(
 iree_task_t* iree_task_executor_try_steal_task(
     iree_task_executor_t* executor,
     iree_task_affinity_set_t constructive_sharing_mask,
-    uint32_t max_theft_attempts, iree_prng_minilcg128_state_t* theft_prng,
+    iree_task_affinity_set_t numa_node_mask, uint32_t max_theft_attempts,
+    iree_prng_minilcg128_state_t* theft_prng,
     iree_task_queue_t* local_task_queue) {
   IREE_TRACE_ZONE_BEGIN(z0);
 
@@ -721,8 +1031,16 @@ iree_task_t* iree_task_executor_try_steal_task(
     IREE_TRACE_ZONE_APPEND_TEXT(z0, "local");
   } else {
     task = iree_task_executor_try_steal_task_from_affinity_set(
-        executor, victim_mask & ~constructive_sharing_mask, max_theft_attempts,
-        rotation_offset, local_task_queue);
+        executor, victim_mask & ~constructive_sharing_mask & numa_node_mask,
+        max_theft_attempts, rotation_offset, local_task_queue);
+    if (task) {
+      IREE_TRACE_ZONE_APPEND_TEXT(z0, "node-local");
+    }
+  }
+  if (!task) {
+    task = iree_task_executor_try_steal_task_from_affinity_set(
+        executor, victim_mask & ~constructive_sharing_mask & ~numa_node_mask,
+        max_theft_attempts, rotation_offset, local_task_queue);
     if (task) {
       IREE_TRACE_ZONE_APPEND_TEXT(z0, "non-local");
     }
@@ -133,6 +133,11 @@ extern "C" {
 //      respective iree_task_worker_t mailbox_slist and the workers with new
 //      tasks are notified to wake up (if not already awake).
 //
+//   With IREE_TASK_SCHEDULING_MODE_DEDICATED_WAIT_THREAD the wait thread
+//   performs (a) for the incoming_waiting_slist and (b) by blocking on the
+//   waiting tasks and then runs (c) and (d) itself when they resolve. The
+//   coordinator only handles ready tasks and never waits.
+//
 // 4. iree_task_worker_main_pump_once (LIFO mailbox -> FIFO thread-local list)
 //    When either woken or after completing all available thread-local work
 //    each worker will check its mailbox_slist to see if any tasks have been
@@ -286,12 +291,14 @@ enum iree_task_scheduling_mode_bits_t {
   // begin processing simultaneously immediately after the submission is made.
   IREE_TASK_SCHEDULING_MODE_DEFER_WORKER_STARTUP = 1u << 0,
 
-  // TODO(#4027): implement IREE_TASK_SCHEDULING_MODE_DEDICATED_WAIT_THREAD.
   // Creates a dedicated thread performing waits on root wait handles.
   // On workloads with many short-duration waits this will reduce total latency
   // as the waits are aggressively processed and dependent tasks are scheduled.
   // It also keeps any wait-related syscalls off the worker threads that would
   // otherwise need to perform the syscalls during coordination.
+  //
+  // The wait thread is idle (blocked in the kernel) unless waits resolve and
+  // schedules the newly-ready tasks directly to worker mailboxes.
   IREE_TASK_SCHEDULING_MODE_DEDICATED_WAIT_THREAD = 1u << 1,
 };
 typedef uint32_t iree_task_scheduling_mode_t;
@@ -301,10 +308,15 @@ typedef struct iree_task_executor_t iree_task_executor_t;
 
 // Creates a task executor using the specified topology.
 // |topology| is only used during creation and need not live beyond this call.
+// |worker_local_memory_size| bytes of scratch memory will be reserved for each
+// worker and provided to all tiles it executes via
+// iree_task_tile_context_t::local_memory. The size may be 0 to disable
+// worker-local memory; see IREE_TASK_WORKER_DEFAULT_LOCAL_MEMORY_SIZE.
 // |out_executor| must be released by the caller.
 iree_status_t iree_task_executor_create(
     iree_task_scheduling_mode_t scheduling_mode,
-    const iree_task_topology_t* topology, iree_allocator_t allocator,
+    const iree_task_topology_t* topology,
+    iree_host_size_t worker_local_memory_size, iree_allocator_t allocator,
     iree_task_executor_t** out_executor);
 
 // Retains the given |executor| for the caller.
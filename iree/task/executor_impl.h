@@ -10,6 +10,7 @@
 #include "iree/base/internal/math.h"
 #include "iree/base/internal/prng.h"
 #include "iree/base/internal/synchronization.h"
+#include "iree/base/internal/threading.h"
 #include "iree/base/tracing.h"
 #include "iree/task/affinity_set.h"
 #include "iree/task/executor.h"
@@ -24,6 +25,19 @@
 extern "C" {
 #endif  // __cplusplus
 
+// Lifetime states of the dedicated wait thread.
+typedef enum iree_task_executor_wait_thread_state_e {
+  // Wait thread is blocked on or processing waits.
+  IREE_TASK_EXECUTOR_WAIT_THREAD_STATE_RUNNING = 0,
+  // Wait thread should exit (or is exiting) and will soon enter the zombie
+  // state. The executor requests the exit by setting this and then waking the
+  // thread with the wait_wake_event.
+  IREE_TASK_EXECUTOR_WAIT_THREAD_STATE_EXITING = 1,
+  // Wait thread has exited and will no longer touch the executor.
+  // The thread handle is still valid and must be destroyed.
+  IREE_TASK_EXECUTOR_WAIT_THREAD_STATE_ZOMBIE = 2,
+} iree_task_executor_wait_thread_state_t;
+
 struct iree_task_executor_t {
   iree_atomic_ref_count_t ref_count;
   iree_allocator_t allocator;
@@ -78,6 +92,29 @@ struct iree_task_executor_t {
   // keeping the waiting_list and wait_set in sync.
   iree_wait_set_t* wait_set;
 
+  // Thread performing all waits when the executor was created with
+  // IREE_TASK_SCHEDULING_MODE_DEDICATED_WAIT_THREAD. The wait thread takes the
+  // place of the coordinator in managing waiting_list and wait_set and
+  // coordinators instead hand off wait tasks via incoming_waiting_slist.
+  iree_thread_t* wait_thread;
+  // Event in the wait_set used to wake whichever thread is blocked waiting on
+  // it: the wait thread when new wait tasks arrive in incoming_waiting_slist or
+  // when it has been asked to exit, or otherwise a worker holding wait_mutex
+  // while a coordinator needs it to merge new wait tasks or a worker has been
+  // posted new tasks.
+  iree_event_t wait_wake_event;
+  // Number of coordinators waiting on wait_mutex to merge new wait tasks.
+  // Workers will not begin blocking on the wait_set while this is non-zero.
+  iree_atomic_int32_t wait_merge_pending_count;
+  // A bitset indicating which worker (at most one, holding wait_mutex) is
+  // blocked or about to block on the wait_set. Posters clear the bits of the
+  // workers they post to and set wait_wake_event if any were set.
+  iree_atomic_task_affinity_set_t worker_waiting_mask;
+  // iree_task_executor_wait_thread_state_t used to request the wait thread
+  // exit and to wait for it to do so.
+  iree_atomic_int32_t wait_thread_state;
+  iree_notification_t wait_thread_state_notification;
+
   // A bitset indicating which workers are live and usable; all attempts to
   // push work onto a particular worker should check first with this mask. This
   // may change over time either automatically or by user request ("don't use
@@ -99,6 +136,10 @@ struct iree_task_executor_t {
   // live join/leave behavior we could change this to a registration mechanism.
   iree_host_size_t worker_count;
   iree_task_worker_t* workers;  // [worker_count]
+
+  // Number of distinct NUMA nodes the workers are attached to. When >1 work
+  // distribution favors keeping the same work on the same nodes.
+  iree_host_size_t numa_node_count;
 };
 
 // Merges a submission into the primary FIFO queues.
@@ -133,7 +174,8 @@ void iree_task_executor_coordinate(iree_task_executor_t* executor,
 iree_task_t* iree_task_executor_try_steal_task(
     iree_task_executor_t* executor,
     iree_task_affinity_set_t constructive_sharing_mask,
-    uint32_t max_theft_attempts, iree_prng_minilcg128_state_t* theft_prng,
+    iree_task_affinity_set_t numa_node_mask, uint32_t max_theft_attempts,
+    iree_prng_minilcg128_state_t* theft_prng,
     iree_task_queue_t* local_task_queue);
 
 #ifdef __cplusplus
@@ -6,11 +6,17 @@
 
 #include "iree/task/executor.h"
 
+#include <atomic>
+#include <chrono>
 #include <cstddef>
+#include <thread>
+#include <vector>
 
 #include "iree/base/internal/prng.h"
 #include "iree/base/tracing.h"
+#include "iree/task/tuning.h"
 #include "iree/testing/gtest.h"
+#include "iree/testing/status_matchers.h"
 
 namespace {
 
@@ -56,8 +62,9 @@ TEST(ExecutorTest, Any) {
   iree_task_executor_t* executor = NULL;
   iree_task_scheduling_mode_t scheduling_mode =
       IREE_TASK_SCHEDULING_MODE_RESERVED;
-  IREE_CHECK_OK(iree_task_executor_create(scheduling_mode, &topology, allocator,
-                                          &executor));
+  IREE_CHECK_OK(iree_task_executor_create(
+      scheduling_mode, &topology, IREE_TASK_WORKER_DEFAULT_LOCAL_MEMORY_SIZE,
+      allocator, &executor));
   iree_task_topology_deinitialize(&topology);
 
   //
@@ -170,4 +177,149 @@ TEST(ExecutorTest, Any) {
   iree_task_executor_release(executor);
 }
 
+// Executor using a dedicated thread to wait on wait tasks instead of the
+// coordinating worker.
+class ExecutorWaitThreadTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    iree_task_topology_t topology;
+    iree_task_topology_initialize_from_group_count(/*group_count=*/4,
+                                                   &topology);
+    IREE_ASSERT_OK(iree_task_executor_create(
+        IREE_TASK_SCHEDULING_MODE_DEDICATED_WAIT_THREAD, &topology,
+        IREE_TASK_WORKER_DEFAULT_LOCAL_MEMORY_SIZE, iree_allocator_system(),
+        &executor_));
+    iree_task_topology_deinitialize(&topology);
+    iree_task_scope_initialize(iree_make_cstring_view("scope"), &scope_);
+  }
+
+  void TearDown() override {
+    iree_task_executor_release(executor_);
+    iree_task_scope_deinitialize(&scope_);
+  }
+
+  // Initializes |out_task| as a call that increments |call_count|.
+  void InitializeCountingCall(std::atomic<int>* call_count,
+                              iree_task_call_t* out_task) {
+    iree_task_call_initialize(
+        &scope_,
+        iree_task_make_call_closure(
+            [](uintptr_t user_context, iree_task_t* task,
+               iree_task_submission_t* pending_submission) {
+              ++*(std::atomic<int>*)user_context;
+              return iree_ok_status();
+            },
+            (uintptr_t)call_count),
+        out_task);
+  }
+
+  // Makes a fence the completion task of |tail_task| and submits
+  // |root_tasks| in a single batch.
+  void SubmitWithFence(const std::vector<iree_task_t*>& root_tasks,
+                       iree_task_t* tail_task) {
+    iree_task_fence_t* fence = NULL;
+    IREE_ASSERT_OK(
+        iree_task_executor_acquire_fence(executor_, &scope_, &fence));
+    iree_task_set_completion_task(tail_task, &fence->header);
+    iree_task_submission_t submission;
+    iree_task_submission_initialize(&submission);
+    for (iree_task_t* task : root_tasks) {
+      iree_task_submission_enqueue(&submission, task);
+    }
+    iree_task_executor_submit(executor_, &submission);
+    iree_task_executor_flush(executor_);
+  }
+
+  iree_task_executor_t* executor_ = NULL;
+  iree_task_scope_t scope_;
+};
+
+// Tests that a wait task blocked on an event is woken by the wait thread when
+// the event is signaled and that its dependent task runs.
+TEST_F(ExecutorWaitThreadTest, WaitWokenByEvent) {
+  iree_event_t event;
+  IREE_ASSERT_OK(iree_event_initialize(/*initial_state=*/false, &event));
+
+  std::atomic<int> call_count = {0};
+  iree_task_wait_t wait_task;
+  iree_task_wait_initialize(&scope_, event, &wait_task);
+  iree_task_call_t call_task;
+  InitializeCountingCall(&call_count, &call_task);
+  iree_task_set_completion_task(&wait_task.header, &call_task.header);
+  SubmitWithFence({&wait_task.header}, &call_task.header);
+
+  // Signal from another thread after the wait thread has started waiting.
+  std::atomic<bool> has_signaled = {false};
+  std::thread signal_thread([&]() {
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    EXPECT_EQ(0, call_count);
+    has_signaled = true;
+    iree_event_set(&event);
+  });
+
+  IREE_EXPECT_OK(iree_task_scope_wait_idle(&scope_, IREE_TIME_INFINITE_FUTURE));
+  EXPECT_TRUE(has_signaled);
+  EXPECT_EQ(1, call_count);
+
+  signal_thread.join();
+  iree_event_deinitialize(&event);
+}
+
+// Tests that the wait set keeps room for the wake event of the wait thread when
+// the maximum number of waits are outstanding at the same time.
+TEST_F(ExecutorWaitThreadTest, MaxOutstandingWaits) {
+  const int wait_count = IREE_TASK_EXECUTOR_MAX_OUTSTANDING_WAITS;
+  std::vector<iree_event_t> events(wait_count);
+  std::vector<iree_task_wait_t> wait_tasks(wait_count);
+  std::vector<iree_task_t*> root_tasks(wait_count);
+  std::atomic<int> call_count = {0};
+  iree_task_call_t call_task;
+  InitializeCountingCall(&call_count, &call_task);
+  for (int i = 0; i < wait_count; ++i) {
+    IREE_ASSERT_OK(iree_event_initialize(/*initial_state=*/false, &events[i]));
+    iree_task_wait_initialize(&scope_, events[i], &wait_tasks[i]);
+    iree_task_set_completion_task(&wait_tasks[i].header, &call_task.header);
+    root_tasks[i] = &wait_tasks[i].header;
+  }
+
+  // All waits are submitted in one batch so they are all inserted into the
+  // wait set together with the wake event.
+  SubmitWithFence(root_tasks, &call_task.header);
+
+  for (int i = 0; i < wait_count; ++i) {
+    iree_event_set(&events[i]);
+  }
+  IREE_EXPECT_OK(iree_task_scope_wait_idle(&scope_, IREE_TIME_INFINITE_FUTURE));
+  EXPECT_EQ(1, call_count);
+
+  for (int i = 0; i < wait_count; ++i) {
+    iree_event_deinitialize(&events[i]);
+  }
+}
+
+// Tests that releasing the executor with waits that will never be signaled
+// stops the wait thread and discards the waiting tasks and their dependents.
+TEST_F(ExecutorWaitThreadTest, ShutdownWithPendingWaits) {
+  iree_event_t event;
+  IREE_ASSERT_OK(iree_event_initialize(/*initial_state=*/false, &event));
+
+  std::atomic<int> call_count = {0};
+  iree_task_wait_t wait_task;
+  iree_task_wait_initialize(&scope_, event, &wait_task);
+  iree_task_call_t call_task;
+  InitializeCountingCall(&call_count, &call_task);
+  iree_task_set_completion_task(&wait_task.header, &call_task.header);
+  SubmitWithFence({&wait_task.header}, &call_task.header);
+  EXPECT_FALSE(iree_task_scope_is_idle(&scope_));
+
+  iree_task_executor_release(executor_);
+  executor_ = NULL;
+
+  // The fence was discarded with the wait and ended the scope.
+  EXPECT_EQ(0, call_count);
+  IREE_EXPECT_OK(iree_task_scope_wait_idle(&scope_, IREE_TIME_INFINITE_PAST));
+
+  iree_event_deinitialize(&event);
+}
+
 }  // namespace
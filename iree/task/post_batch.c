@@ -73,6 +73,14 @@ iree_host_size_t iree_task_post_batch_select_worker(
           &post_batch->executor->worker_idle_mask, iree_memory_order_relaxed);
   worker_idle_mask &= ~post_batch->worker_pending_mask;
   iree_task_affinity_set_t idle_affinity_set = affinity_set & worker_idle_mask;
+  if (post_batch->current_worker &&
+      (idle_affinity_set & post_batch->current_worker->numa_node_mask)) {
+    // Prefer idle workers on the same NUMA node as the posting worker as the
+    // work it produced likely accesses memory local to that node.
+    return iree_task_post_batch_select_random_worker(
+        post_batch,
+        idle_affinity_set & post_batch->current_worker->numa_node_mask);
+  }
   if (idle_affinity_set) {
     return iree_task_post_batch_select_random_worker(post_batch,
                                                      idle_affinity_set);
@@ -83,6 +91,17 @@ iree_host_size_t iree_task_post_batch_select_worker(
   return iree_task_post_batch_select_random_worker(post_batch, affinity_set);
 }
 
+iree_host_size_t iree_task_post_batch_select_dispatch_worker(
+    iree_task_post_batch_t* post_batch, iree_task_affinity_set_t affinity_set) {
+  if (post_batch->executor->numa_node_count > 1) {
+    // Always start with the first worker so that each range of the dispatch
+    // is assigned to the same node each time it runs. Memory first touched by
+    // a range will then be local to the node processing it the next time.
+    return iree_task_post_batch_select_random_worker(post_batch, affinity_set);
+  }
+  return iree_task_post_batch_select_worker(post_batch, affinity_set);
+}
+
 void iree_task_post_batch_enqueue(iree_task_post_batch_t* post_batch,
                                   iree_host_size_t worker_index,
                                   iree_task_t* task) {
@@ -120,6 +139,16 @@ static void iree_task_post_batch_wake_workers(
     }
   }
 
+  // A worker idle waiting on the executor wait_set isn't waiting on its wake
+  // notification and must be woken via the wait_wake_event instead.
+  iree_task_affinity_set_t waiting_mask =
+      iree_atomic_task_affinity_set_fetch_and(&executor->worker_waiting_mask,
+                                              ~wake_mask,
+                                              iree_memory_order_seq_cst);
+  if (IREE_UNLIKELY(waiting_mask & wake_mask)) {
+    iree_event_set(&executor->wait_wake_event);
+  }
+
   // TODO(#4016): use a FUTEX_WAKE_BITSET here to wake all of the workers that
   // have pending work in a single syscall (vs. popcnt(worker_pending_mask)
   // syscalls). This will reduce wake latency for workers later in the set;
@@ -55,6 +55,13 @@ iree_host_size_t iree_task_post_batch_worker_count(
 iree_host_size_t iree_task_post_batch_select_worker(
     iree_task_post_batch_t* post_batch, iree_task_affinity_set_t affinity_set);
 
+// Selects the worker that should receive the first slice of a dispatch.
+// Subsequent slices are assigned to subsequent workers. When the executor spans
+// multiple NUMA nodes the selection is stable across dispatches so that the
+// same ranges of the dispatch are processed on the same nodes.
+iree_host_size_t iree_task_post_batch_select_dispatch_worker(
+    iree_task_post_batch_t* post_batch, iree_task_affinity_set_t affinity_set);
+
 // Enqueues a task to the given worker. Note that the pending work lists for
 // each work is kept in LIFO order so that we can easily concatenate it with the
 // worker mailbox slist that's in LIFO order.
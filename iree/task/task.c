@@ -358,12 +358,94 @@ static uint32_t iree_task_tile_to_color(
 
 #endif  // IREE_TASK_TRACING_PER_TILE_COLORS
 
+#if IREE_TASK_DISPATCH_STATISTICS_ENABLE
+
+static inline int64_t iree_task_statistic_load(
+    const iree_atomic_int64_t* value) {
+  return iree_atomic_load_int64((iree_atomic_int64_t*)value,
+                                iree_memory_order_relaxed);
+}
+
+static inline void iree_task_statistic_add(iree_atomic_int64_t* target,
+                                           int64_t value) {
+  if (!value) return;
+  iree_atomic_fetch_add_int64(target, value, iree_memory_order_relaxed);
+}
+
+// Lowers |target| to |value| if |value| is set and |target| is unset or larger.
+static void iree_task_statistic_min(iree_atomic_int64_t* target,
+                                    int64_t value) {
+  if (!value) return;
+  int64_t current = iree_atomic_load_int64(target, iree_memory_order_relaxed);
+  while ((!current || value < current) &&
+         !iree_atomic_compare_exchange_weak_int64(target, &current, value,
+                                                  iree_memory_order_relaxed,
+                                                  iree_memory_order_relaxed)) {
+  }
+}
+
+// Raises |target| to |value| if |value| is larger.
+static void iree_task_statistic_max(iree_atomic_int64_t* target,
+                                    int64_t value) {
+  int64_t current = iree_atomic_load_int64(target, iree_memory_order_relaxed);
+  while (value > current &&
+         !iree_atomic_compare_exchange_weak_int64(target, &current, value,
+                                                  iree_memory_order_relaxed,
+                                                  iree_memory_order_relaxed)) {
+  }
+}
+
+// Records |tile_count| tiles executed by |worker_id| from |start_time_ns| to
+// |end_time_ns| into the slice/shard-local |statistics|.
+static void iree_task_dispatch_statistics_record(
+    iree_task_dispatch_statistics_t* statistics, uint32_t worker_id,
+    uint32_t posted_worker_index, int64_t tile_count,
+    iree_time_t start_time_ns, iree_time_t end_time_ns) {
+  iree_task_statistic_add(&statistics->tiles_executed, tile_count);
+  if (posted_worker_index != UINT32_MAX && posted_worker_index != worker_id) {
+    iree_task_statistic_add(&statistics->tiles_stolen, tile_count);
+  }
+  if (tile_count > 0) {
+    iree_task_statistic_min(&statistics->first_tile_time_ns, start_time_ns);
+    iree_task_statistic_max(&statistics->last_tile_time_ns, end_time_ns);
+  }
+  iree_task_statistic_add(&statistics->worker_busy_time_ns[worker_id],
+                          end_time_ns - start_time_ns);
+}
+
 void iree_task_dispatch_statistics_merge(
     const iree_task_dispatch_statistics_t* source,
     iree_task_dispatch_statistics_t* target) {
-  // TODO(benvanik): statistics.
+  iree_task_statistic_add(
+      &target->tiles_executed,
+      iree_task_statistic_load(&source->tiles_executed));
+  iree_task_statistic_add(&target->tiles_stolen,
+                          iree_task_statistic_load(&source->tiles_stolen));
+  iree_task_statistic_add(
+      &target->shards_spawned,
+      iree_task_statistic_load(&source->shards_spawned));
+  iree_task_statistic_min(
+      &target->first_tile_time_ns,
+      iree_task_statistic_load(&source->first_tile_time_ns));
+  iree_task_statistic_max(
+      &target->last_tile_time_ns,
+      iree_task_statistic_load(&source->last_tile_time_ns));
+  for (iree_host_size_t i = 0; i < IREE_ARRAYSIZE(source->worker_busy_time_ns);
+       ++i) {
+    iree_task_statistic_add(
+        &target->worker_busy_time_ns[i],
+        iree_task_statistic_load(&source->worker_busy_time_ns[i]));
+  }
 }
 
+#else
+
+void iree_task_dispatch_statistics_merge(
+    const iree_task_dispatch_statistics_t* source,
+    iree_task_dispatch_statistics_t* target) {}
+
+#endif  // IREE_TASK_DISPATCH_STATISTICS_ENABLE
+
 //==============================================================================
 // IREE_TASK_TYPE_DISPATCH
 //==============================================================================
@@ -376,7 +458,11 @@ static void iree_task_dispatch_initialize_base(
   memcpy(out_task->workgroup_size, workgroup_size,
          sizeof(out_task->workgroup_size));
   out_task->shared_memory_size = 0;
+  out_task->tiles_per_reservation = 0;
   memset(&out_task->statistics, 0, sizeof(out_task->statistics));
+#if IREE_TASK_DISPATCH_STATISTICS_ENABLE
+  out_task->parent_statistics = NULL;
+#endif  // IREE_TASK_DISPATCH_STATISTICS_ENABLE
 }
 
 void iree_task_dispatch_initialize(iree_task_scope_t* scope,
@@ -398,6 +484,26 @@ void iree_task_dispatch_initialize_indirect(
   out_task->workgroup_count.ptr = workgroup_count_ptr;
 }
 
+// Returns the number of tiles each worker should take from |dispatch_task| at
+// a time given its total |tile_count| and the |worker_count| processing it.
+static uint32_t iree_task_dispatch_select_tiles_per_reservation(
+    const iree_task_dispatch_t* dispatch_task, uint32_t tile_count,
+    iree_host_size_t worker_count) {
+  uint32_t tiles_per_reservation = dispatch_task->tiles_per_reservation;
+  if (!tiles_per_reservation) {
+    tiles_per_reservation = IREE_TASK_DISPATCH_DEFAULT_TILES_PER_RESERVATION;
+  }
+  // Limit reservations such that each worker has a few to take (and steal) -
+  // otherwise small dispatches end up on a handful of workers.
+  iree_host_size_t max_tiles_per_reservation =
+      tile_count /
+      (worker_count * IREE_TASK_DISPATCH_MIN_RESERVATIONS_PER_WORKER);
+  if (tiles_per_reservation > max_tiles_per_reservation) {
+    tiles_per_reservation = (uint32_t)max_tiles_per_reservation;
+  }
+  return iree_max(1, tiles_per_reservation);
+}
+
 void iree_task_dispatch_issue_sliced(iree_task_dispatch_t* dispatch_task,
                                      iree_task_pool_t* slice_task_pool,
                                      iree_task_submission_t* pending_submission,
@@ -437,20 +543,30 @@ void iree_task_dispatch_issue_sliced(iree_task_dispatch_t* dispatch_task,
 #endif  // IREE_TRACING_FEATURES & IREE_TRACING_FEATURE_INSTRUMENTATION
 
   // Divide up all tiles into slices, our finest-granularity scheduling task.
-  const uint32_t tiles_per_slice_x = IREE_TASK_DISPATCH_TILES_PER_SLICE_X;
-  const uint32_t tiles_per_slice_y = IREE_TASK_DISPATCH_TILES_PER_SLICE_Y;
-  const uint32_t tiles_per_slice_z = IREE_TASK_DISPATCH_TILES_PER_SLICE_Z;
-  uint32_t slice_count_x = iree_max(1, workgroup_count[0] / tiles_per_slice_x);
-  uint32_t slice_count_y = iree_max(1, workgroup_count[1] / tiles_per_slice_y);
-  uint32_t slice_count_z = iree_max(1, workgroup_count[2] / tiles_per_slice_z);
+  // Slices cover whole rows along X before extending along Y such that tiles
+  // within a slice are spatially coherent.
+  iree_host_size_t worker_count = iree_task_post_batch_worker_count(post_batch);
+  const uint32_t tiles_per_slice =
+      iree_task_dispatch_select_tiles_per_reservation(
+          dispatch_task, total_workgroup_count, worker_count);
+  const uint32_t tiles_per_slice_x =
+      iree_min(workgroup_count[0], tiles_per_slice);
+  const uint32_t tiles_per_slice_y = iree_max(
+      1, iree_min(workgroup_count[1], tiles_per_slice / tiles_per_slice_x));
+  const uint32_t tiles_per_slice_z = 1;
+  uint32_t slice_count_x =
+      (workgroup_count[0] + tiles_per_slice_x - 1) / tiles_per_slice_x;
+  uint32_t slice_count_y =
+      (workgroup_count[1] + tiles_per_slice_y - 1) / tiles_per_slice_y;
+  uint32_t slice_count_z = workgroup_count[2];
 
   // Compute how many slices each worker will process.
   uint32_t slice_count = slice_count_x * slice_count_y * slice_count_z;
-  iree_host_size_t worker_count = iree_task_post_batch_worker_count(post_batch);
   uint32_t slices_per_worker = iree_max(1, slice_count / worker_count);
 
-  // Randomize starting worker.
-  iree_host_size_t worker_offset = iree_task_post_batch_select_worker(
+  // Select the starting worker. Topologies order workers by NUMA node so that
+  // contiguous ranges of slices are processed on the same node.
+  iree_host_size_t worker_offset = iree_task_post_batch_select_dispatch_worker(
       post_batch, dispatch_task->header.affinity_set);
   iree_host_size_t worker_index = worker_offset;
 
@@ -485,6 +601,8 @@ void iree_task_dispatch_issue_sliced(iree_task_dispatch_t* dispatch_task,
                                               slice_task_pool);
 
         // Enqueue on the worker selected for the task.
+        slice_task->posted_worker_index =
+            (uint32_t)(worker_index % worker_count);
         iree_task_post_batch_enqueue(post_batch, worker_index % worker_count,
                                      &slice_task->header);
         if (++worker_slice_count >= slices_per_worker) {
@@ -495,6 +613,11 @@ void iree_task_dispatch_issue_sliced(iree_task_dispatch_t* dispatch_task,
     }
   }
 
+#if IREE_TASK_DISPATCH_STATISTICS_ENABLE
+  iree_task_statistic_add(&dispatch_task->statistics.shards_spawned,
+                          slice_count);
+#endif  // IREE_TASK_DISPATCH_STATISTICS_ENABLE
+
   // NOTE: the dispatch is not retired until all slices complete. Upon the last
   // slice completing the lucky worker will retire the task inline and
   // potentially queue up more ready tasks that follow.
@@ -565,14 +688,9 @@ void iree_task_dispatch_issue_sharded(
   // Compute how many tiles we want each shard to reserve at a time from the
   // larger grid. A higher number reduces overhead and improves locality while
   // a lower number reduces maximum worst-case latency (coarser work stealing).
-  if (shared_state->tile_count <
-      worker_count * IREE_TASK_DISPATCH_MAX_TILES_PER_SHARD_RESERVATION) {
-    // Grid is small - allow it to be eagerly sliced up.
-    shared_state->tiles_per_reservation = 1;
-  } else {
-    shared_state->tiles_per_reservation =
-        IREE_TASK_DISPATCH_MAX_TILES_PER_SHARD_RESERVATION;
-  }
+  shared_state->tiles_per_reservation =
+      iree_task_dispatch_select_tiles_per_reservation(
+          dispatch_task, shared_state->tile_count, worker_count);
 
   // Randomize starting worker.
   iree_host_size_t worker_offset = iree_task_post_batch_select_worker(
@@ -585,11 +703,17 @@ void iree_task_dispatch_issue_sharded(
         dispatch_task, shared_state, shard_task_pool);
 
     // Enqueue on the worker selected for the task.
+    shard_task->posted_worker_index = (uint32_t)(worker_index % worker_count);
     iree_task_post_batch_enqueue(post_batch, worker_index % worker_count,
                                  &shard_task->header);
     ++worker_index;
   }
 
+#if IREE_TASK_DISPATCH_STATISTICS_ENABLE
+  iree_task_statistic_add(&dispatch_task->statistics.shards_spawned,
+                          (int64_t)shard_count);
+#endif  // IREE_TASK_DISPATCH_STATISTICS_ENABLE
+
   // NOTE: the dispatch is not retired until all shards complete. Upon the last
   // shard completing the lucky worker will retire the task inline and
   // potentially queue up more ready tasks that follow.
@@ -615,6 +739,12 @@ void iree_task_dispatch_retire(iree_task_dispatch_t* dispatch_task,
   iree_task_dispatch_statistics_merge(
       &dispatch_task->statistics,
       &dispatch_task->header.scope->dispatch_statistics);
+#if IREE_TASK_DISPATCH_STATISTICS_ENABLE
+  if (dispatch_task->parent_statistics) {
+    iree_task_dispatch_statistics_merge(&dispatch_task->statistics,
+                                        dispatch_task->parent_statistics);
+  }
+#endif  // IREE_TASK_DISPATCH_STATISTICS_ENABLE
 
   iree_task_retire(&dispatch_task->header, pending_submission);
   IREE_TRACE_ZONE_END(z0);
@@ -652,6 +782,7 @@ void iree_task_dispatch_slice_initialize(iree_task_dispatch_t* dispatch_task,
   // then the per-slice statistics will roll up into the dispatch statistics.
   out_task->dispatch_statistics = &dispatch_task->statistics;
   memset(&out_task->slice_statistics, 0, sizeof(out_task->slice_statistics));
+  out_task->posted_worker_index = UINT32_MAX;
 }
 
 iree_task_dispatch_slice_t* iree_task_dispatch_slice_allocate(
@@ -673,8 +804,8 @@ iree_task_dispatch_slice_t* iree_task_dispatch_slice_allocate(
 }
 
 iree_status_t iree_task_dispatch_slice_execute(
-    iree_task_dispatch_slice_t* task,
-    iree_task_submission_t* pending_submission) {
+    iree_task_dispatch_slice_t* task, uint32_t worker_id,
+    iree_byte_span_t local_memory, iree_task_submission_t* pending_submission) {
   IREE_TRACE_ZONE_BEGIN(z0);
   IREE_TRACE_ZONE_SET_COLOR(z0,
                             iree_math_ptr_to_xrgb(task->closure.user_context));
@@ -691,6 +822,8 @@ iree_status_t iree_task_dispatch_slice_execute(
          sizeof(tile_context.workgroup_count));
   tile_context.shared_memory = task->shared_memory;
   tile_context.statistics = &task->slice_statistics;
+  tile_context.worker_id = worker_id;
+  tile_context.local_memory = local_memory;
 
   const uint32_t base_x = task->workgroup_base[0];
   const uint32_t base_y = task->workgroup_base[1];
@@ -698,6 +831,9 @@ iree_status_t iree_task_dispatch_slice_execute(
   const uint32_t range_x = task->workgroup_range[0];
   const uint32_t range_y = task->workgroup_range[1];
   const uint32_t range_z = task->workgroup_range[2];
+#if IREE_TASK_DISPATCH_STATISTICS_ENABLE
+  const iree_time_t start_time_ns = iree_time_now();
+#endif  // IREE_TASK_DISPATCH_STATISTICS_ENABLE
   for (uint32_t z = base_z; z <= range_z; ++z) {
     tile_context.workgroup_xyz[2] = z;
     for (uint32_t y = base_y; y <= range_y; ++y) {
@@ -730,6 +866,14 @@ iree_status_t iree_task_dispatch_slice_execute(
     }
   }
 
+#if IREE_TASK_DISPATCH_STATISTICS_ENABLE
+  const int64_t tile_count = (int64_t)(range_x - base_x + 1) *
+                             (range_y - base_y + 1) * (range_z - base_z + 1);
+  iree_task_dispatch_statistics_record(
+      &task->slice_statistics, worker_id, task->posted_worker_index,
+      tile_count, start_time_ns, iree_time_now());
+#endif  // IREE_TASK_DISPATCH_STATISTICS_ENABLE
+
   // Push aggregate statistics up to the dispatch.
   if (task->dispatch_statistics) {
     iree_task_dispatch_statistics_merge(&task->slice_statistics,
@@ -754,6 +898,7 @@ void iree_task_dispatch_shard_initialize(
   iree_task_set_completion_task(&out_task->header, &dispatch_task->header);
   out_task->dispatch_task = dispatch_task;
   out_task->shared_state = shared_state;
+  out_task->posted_worker_index = UINT32_MAX;
 }
 
 iree_task_dispatch_shard_t* iree_task_dispatch_shard_allocate(
@@ -773,8 +918,8 @@ iree_task_dispatch_shard_t* iree_task_dispatch_shard_allocate(
 }
 
 iree_status_t iree_task_dispatch_shard_execute(
-    iree_task_dispatch_shard_t* task,
-    iree_task_submission_t* pending_submission) {
+    iree_task_dispatch_shard_t* task, uint32_t worker_id,
+    iree_byte_span_t local_memory, iree_task_submission_t* pending_submission) {
   IREE_TRACE_ZONE_BEGIN(z0);
 
   iree_task_dispatch_t* dispatch_task = task->dispatch_task;
@@ -789,6 +934,8 @@ iree_status_t iree_task_dispatch_shard_execute(
   memcpy(&tile_context.workgroup_count, dispatch_task->workgroup_count.value,
          sizeof(tile_context.workgroup_count));
   tile_context.shared_memory = shared_state->shared_memory;
+  tile_context.worker_id = worker_id;
+  tile_context.local_memory = local_memory;
   uint32_t workgroup_count_x = tile_context.workgroup_count[0];
   uint32_t workgroup_count_y = tile_context.workgroup_count[1];
 
@@ -799,6 +946,11 @@ iree_status_t iree_task_dispatch_shard_execute(
   memset(&shard_statistics, 0, sizeof(shard_statistics));
   tile_context.statistics = &shard_statistics;
 
+#if IREE_TASK_DISPATCH_STATISTICS_ENABLE
+  const iree_time_t start_time_ns = iree_time_now();
+  int64_t tiles_executed = 0;
+#endif  // IREE_TASK_DISPATCH_STATISTICS_ENABLE
+
   // Loop over all tiles until they are all processed.
   const uint32_t tile_count = shared_state->tile_count;
   const uint32_t tiles_per_reservation = shared_state->tiles_per_reservation;
@@ -847,9 +999,18 @@ iree_status_t iree_task_dispatch_shard_execute(
       }
     }
 
+#if IREE_TASK_DISPATCH_STATISTICS_ENABLE
+    tiles_executed += tile_range - tile_base;
+#endif  // IREE_TASK_DISPATCH_STATISTICS_ENABLE
     tile_base = next_tile_base;
   }
 
+#if IREE_TASK_DISPATCH_STATISTICS_ENABLE
+  iree_task_dispatch_statistics_record(
+      &shard_statistics, worker_id, task->posted_worker_index, tiles_executed,
+      start_time_ns, iree_time_now());
+#endif  // IREE_TASK_DISPATCH_STATISTICS_ENABLE
+
   // Push aggregate statistics up to the dispatch.
   iree_task_dispatch_statistics_merge(&shard_statistics,
                                       &dispatch_task->statistics);
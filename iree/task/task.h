@@ -17,6 +17,7 @@
 #include "iree/base/internal/synchronization.h"
 #include "iree/base/internal/wait_handle.h"
 #include "iree/task/affinity_set.h"
+#include "iree/task/tuning.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -386,11 +387,29 @@ void iree_task_wait_initialize(iree_task_scope_t* scope,
 // If we find ourselves with a lot of hardware-specific counters (vs more
 // generic ones like 'l2 cache misses' or 'ipc') then we can sprinkle in some
 // #ifdefs.
+//
+// NOTE: each of these increases the command buffer storage requirements and
+// they are only present when IREE_TASK_DISPATCH_STATISTICS_ENABLE is set.
 typedef struct iree_task_dispatch_statistics_t {
-  // TODO(benvanik): statistics counters.
-  // NOTE: each of these increases the command buffer storage requirements; we
-  // should always guard these with a compiler flag.
+#if IREE_TASK_DISPATCH_STATISTICS_ENABLE
+  // Total number of tiles executed.
+  iree_atomic_int64_t tiles_executed;
+  // Number of tiles executed by a worker other than the one the containing
+  // slice/shard was originally posted to (work stealing).
+  iree_atomic_int64_t tiles_stolen;
+  // Total number of slices/shards the dispatch was divided into.
+  iree_atomic_int64_t shards_spawned;
+  // Time at which the earliest tile began execution or 0 if none have.
+  iree_atomic_int64_t first_tile_time_ns;
+  // Time at which the latest tile completed execution or 0 if none have.
+  // The wall time of the dispatch is last_tile_time_ns - first_tile_time_ns.
+  iree_atomic_int64_t last_tile_time_ns;
+  // Total time each worker spent executing tiles, indexed by worker ID.
+  // Comparing these against the wall time shows load imbalance.
+  iree_atomic_int64_t worker_busy_time_ns[IREE_TASK_EXECUTOR_MAX_WORKER_COUNT];
+#else
   iree_atomic_int32_t reserved;
+#endif  // IREE_TASK_DISPATCH_STATISTICS_ENABLE
 } iree_task_dispatch_statistics_t;
 
 // Merges statistics from |source| to |target| atomically per-field.
@@ -435,6 +454,16 @@ typedef iree_alignas(iree_max_align_t) struct {
   // Shared statistics counters for the dispatch slice.
   iree_task_dispatch_statistics_t* statistics;
 
+  // Index of the worker executing the tile in the range [0, worker_count).
+  // Tiles executing concurrently are guaranteed to have unique worker IDs.
+  uint32_t worker_id;
+
+  // Worker-local scratch memory exclusively available to the tile while it
+  // executes. The contents are undefined at the start of the tile and must not
+  // be retained across tiles. Aligned to at least a cache line and may be
+  // empty if the executor was created without worker-local memory.
+  iree_byte_span_t local_memory;
+
   // TODO(benvanik): cpuid uarch.
   // TODO(benvanik): per-tile coroutine storage.
 } iree_task_tile_context_t;
@@ -450,7 +479,7 @@ typedef iree_alignas(iree_max_align_t) struct {
   uint32_t tile_count;
 
   // Maximum number of tiles to fetch per tile reservation from the grid.
-  // Bounded by IREE_TASK_DISPATCH_MAX_TILES_PER_SHARD_RESERVATION and a
+  // Sourced from iree_task_dispatch_t::tiles_per_reservation and bounded by a
   // reasonable number chosen based on the tile and shard counts.
   uint32_t tiles_per_reservation;
 
@@ -538,9 +567,23 @@ typedef iree_alignas(iree_max_align_t) struct iree_task_dispatch_t {
   // closure.
   uint32_t shared_memory_size;
 
+  // Preferred number of tiles a worker processes each time it takes work from
+  // the dispatch (per slice or shard reservation). Reduced as required to
+  // ensure all workers can participate in small dispatches. 0 uses
+  // IREE_TASK_DISPATCH_DEFAULT_TILES_PER_RESERVATION.
+  uint32_t tiles_per_reservation;
+
   // Statistics storage used for aggregating counters across all slices.
   iree_task_dispatch_statistics_t statistics;
 
+#if IREE_TASK_DISPATCH_STATISTICS_ENABLE
+  // Optional statistics storage that |statistics| is merged into when the
+  // dispatch retires in addition to the scope statistics. Allows attributing
+  // dispatches to an owner such as a command buffer. Must remain valid until
+  // the dispatch has retired.
+  iree_task_dispatch_statistics_t* parent_statistics;
+#endif  // IREE_TASK_DISPATCH_STATISTICS_ENABLE
+
   // Shared state across all slices/shards/etc.
   // Stored once per dispatch and then referenced by all subtasks.
   union {
@@ -620,6 +663,10 @@ typedef iree_alignas(iree_max_align_t) struct {
   // contention on the shared dispatch statistics across multiple threads.
   iree_task_dispatch_statistics_t slice_statistics;
 
+  // Index of the worker the slice was posted to when issued or UINT32_MAX if
+  // unassigned. Tiles executed by any other worker were stolen.
+  uint32_t posted_worker_index;
+
   // Per-tile initialized coroutine storage for all tiles in the range
   // initialized as each tile begins execution.
   // TODO(benvanik): coroutine storage as iree_task_tile_storage_t.
@@ -651,6 +698,10 @@ typedef iree_alignas(iree_max_align_t) struct {
   // Each shard will be read/modify/writing this and there's likely to be
   // contention.
   iree_task_dispatch_shard_state_t* shared_state;
+
+  // Index of the worker the shard was posted to when issued or UINT32_MAX if
+  // unassigned. Tiles executed by any other worker were stolen.
+  uint32_t posted_worker_index;
 } iree_task_dispatch_shard_t;
 
 void iree_task_dispatch_shard_initialize(
@@ -120,13 +120,15 @@ iree_task_dispatch_slice_t* iree_task_dispatch_slice_allocate(
     iree_task_pool_t* slice_task_pool);
 
 // Executes and retires a dispatch slice task.
+// |worker_id| and |local_memory| identify the executing worker and are passed
+// through to each tile.
 // May block the caller for an indeterminate amount of time and should only be
 // called from threads owned by or donated to the executor.
 // Returns ok if all tiles were successfully executed and otherwise returns
 // an unspecified status (probably the first non-ok status hit).
 iree_status_t iree_task_dispatch_slice_execute(
-    iree_task_dispatch_slice_t* task,
-    iree_task_submission_t* pending_submission);
+    iree_task_dispatch_slice_t* task, uint32_t worker_id,
+    iree_byte_span_t local_memory, iree_task_submission_t* pending_submission);
 
 //==============================================================================
 // IREE_TASK_TYPE_DISPATCH_SHARD
@@ -140,14 +142,16 @@ iree_task_dispatch_shard_t* iree_task_dispatch_shard_allocate(
     iree_task_pool_t* shard_task_pool);
 
 // Executes and retires a dispatch shard task.
+// |worker_id| and |local_memory| identify the executing worker and are passed
+// through to each tile.
 // May block the caller for an indeterminate amount of time and should only be
 // called from threads owned by or donated to the executor.
 // Returns ok if all tiles processed in the shard successfully executed and
 // otherwise returns an unspecified status (probably the first non-ok status
 // hit).
 iree_status_t iree_task_dispatch_shard_execute(
-    iree_task_dispatch_shard_t* task,
-    iree_task_submission_t* pending_submission);
+    iree_task_dispatch_shard_t* task, uint32_t worker_id,
+    iree_byte_span_t local_memory, iree_task_submission_t* pending_submission);
 
 #ifdef __cplusplus
 }  // extern "C"
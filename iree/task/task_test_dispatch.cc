@@ -6,12 +6,15 @@
 
 #include <cstdint>
 #include <cstdio>
+#include <cstring>
 #include <memory>
 
 #include "iree/base/api.h"
+#include "iree/task/scope.h"
 #include "iree/task/submission.h"
 #include "iree/task/task.h"
 #include "iree/task/testing/task_test.h"
+#include "iree/task/tuning.h"
 #include "iree/testing/gtest.h"
 #include "iree/testing/status_matchers.h"
 
@@ -67,7 +70,8 @@ class TaskDispatchTest : public TaskTest {
  public:
   void DispatchAndVerifyGrid(const uint32_t workgroup_size[3],
                              const uint32_t workgroup_count[3],
-                             uint32_t dispatch_flags) {
+                             uint32_t dispatch_flags,
+                             uint32_t tiles_per_reservation = 0) {
     GridCoverage coverage(workgroup_count);
     iree_task_dispatch_t task;
     iree_task_dispatch_initialize(&scope_,
@@ -75,6 +79,7 @@ class TaskDispatchTest : public TaskTest {
                                       GridCoverage::Tile, (uintptr_t)&coverage),
                                   workgroup_size, workgroup_count, &task);
     task.header.flags |= dispatch_flags;
+    task.tiles_per_reservation = tiles_per_reservation;
     IREE_ASSERT_OK(SubmitTasksAndWaitIdle(&task.header, &task.header));
     EXPECT_TRUE(coverage.Verify());
   }
@@ -132,6 +137,70 @@ TEST_F(TaskDispatchTest, Issue345Sliced) {
                         IREE_TASK_FLAG_DISPATCH_SLICED);
 }
 
+// Grids that do not evenly divide into reservations must still have all tiles
+// covered exactly once regardless of the tiles per reservation requested.
+TEST_F(TaskDispatchTest, TilesPerReservationSharded) {
+  const uint32_t kWorkgroupSize[3] = {1, 1, 1};
+  const uint32_t kWorkgroupCount[3] = {37, 5, 3};
+  for (uint32_t tiles_per_reservation : {0u, 1u, 7u, 64u, 100000u}) {
+    DispatchAndVerifyGrid(kWorkgroupSize, kWorkgroupCount, 0,
+                          tiles_per_reservation);
+  }
+}
+
+TEST_F(TaskDispatchTest, TilesPerReservationSliced) {
+  const uint32_t kWorkgroupSize[3] = {1, 1, 1};
+  const uint32_t kWorkgroupCount[3] = {37, 5, 3};
+  for (uint32_t tiles_per_reservation : {0u, 1u, 7u, 64u, 100000u}) {
+    DispatchAndVerifyGrid(kWorkgroupSize, kWorkgroupCount,
+                          IREE_TASK_FLAG_DISPATCH_SLICED,
+                          tiles_per_reservation);
+  }
+}
+
+TEST_F(TaskDispatchTest, WorkerLocalMemory) {
+  static const uint32_t kWorkgroupSize[3] = {1, 1, 1};
+  static const uint32_t kWorkgroupCount[3] = {3, 4, 5};
+  iree_atomic_int32_t failure_count = IREE_ATOMIC_VAR_INIT(0);
+
+  // Each tile fills the worker-local memory with its worker ID and then
+  // verifies that no other tile wrote to it concurrently.
+  iree_task_dispatch_t task;
+  iree_task_dispatch_initialize(
+      &scope_,
+      iree_task_make_dispatch_closure(
+          [](uintptr_t user_context,
+             const iree_task_tile_context_t* tile_context,
+             iree_task_submission_t* pending_submission) {
+            iree_atomic_int32_t* failure_count_ptr =
+                (iree_atomic_int32_t*)user_context;
+            iree_byte_span_t local_memory = tile_context->local_memory;
+            if (local_memory.data_length !=
+                    IREE_TASK_WORKER_DEFAULT_LOCAL_MEMORY_SIZE ||
+                ((uintptr_t)local_memory.data %
+                 IREE_TASK_WORKER_LOCAL_MEMORY_ALIGNMENT) != 0) {
+              iree_atomic_fetch_add_int32(failure_count_ptr, 1,
+                                          iree_memory_order_seq_cst);
+              return iree_ok_status();
+            }
+            uint8_t pattern = (uint8_t)(tile_context->worker_id + 1);
+            memset(local_memory.data, pattern, local_memory.data_length);
+            for (iree_host_size_t i = 0; i < local_memory.data_length; ++i) {
+              if (local_memory.data[i] != pattern) {
+                iree_atomic_fetch_add_int32(failure_count_ptr, 1,
+                                            iree_memory_order_seq_cst);
+                break;
+              }
+            }
+            return iree_ok_status();
+          },
+          (uintptr_t)&failure_count),
+      kWorkgroupSize, kWorkgroupCount, &task);
+  IREE_ASSERT_OK(SubmitTasksAndWaitIdle(&task.header, &task.header));
+  EXPECT_EQ(0, iree_atomic_load_int32(&failure_count,
+                                      iree_memory_order_seq_cst));
+}
+
 TEST_F(TaskDispatchTest, IssueIndirect) {
   static const uint32_t kWorkgroupSize[3] = {1, 1, 1};
   static const uint32_t kWorkgroupCount[3] = {3, 4, 5};
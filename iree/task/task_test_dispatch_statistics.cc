@@ -0,0 +1,165 @@
+// Copyright 2021 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+// Tests for dispatch statistics. Links against //iree/task:task_statistics
+// which is built with IREE_TASK_DISPATCH_STATISTICS_ENABLE=1 as the statistics
+// are compiled out of the default build.
+
+#include <cstdint>
+#include <cstring>
+
+#include "iree/base/api.h"
+#include "iree/task/executor.h"
+#include "iree/task/scope.h"
+#include "iree/task/submission.h"
+#include "iree/task/task.h"
+#include "iree/task/topology.h"
+#include "iree/task/tuning.h"
+#include "iree/testing/gtest.h"
+#include "iree/testing/status_matchers.h"
+
+#if !IREE_TASK_DISPATCH_STATISTICS_ENABLE
+#error "must be compiled with IREE_TASK_DISPATCH_STATISTICS_ENABLE=1"
+#endif  // !IREE_TASK_DISPATCH_STATISTICS_ENABLE
+
+namespace {
+
+static const uint32_t kWorkgroupSize[3] = {1, 1, 1};
+static const uint32_t kWorkgroupCount[3] = {3, 4, 5};
+static const int64_t kTileCount = 3 * 4 * 5;
+static const iree_host_size_t kWorkerCount = 8;
+
+static int64_t Load(const iree_atomic_int64_t& value) {
+  return iree_atomic_load_int64(const_cast<iree_atomic_int64_t*>(&value),
+                                iree_memory_order_relaxed);
+}
+
+// Tile that counts its execution and spins until the clock advances so that
+// every tile is guaranteed to take a measurable amount of time.
+static iree_status_t CountingTile(uintptr_t user_context,
+                                  const iree_task_tile_context_t* tile_context,
+                                  iree_task_submission_t* pending_submission) {
+  iree_atomic_int64_t* tile_count = (iree_atomic_int64_t*)user_context;
+  iree_atomic_fetch_add_int64(tile_count, 1, iree_memory_order_relaxed);
+  iree_time_t start_time_ns = iree_time_now();
+  while (iree_time_now() <= start_time_ns) {
+  }
+  return iree_ok_status();
+}
+
+class TaskDispatchTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    iree_task_topology_t topology;
+    iree_task_topology_initialize_from_group_count(kWorkerCount, &topology);
+    IREE_ASSERT_OK(iree_task_executor_create(
+        IREE_TASK_SCHEDULING_MODE_RESERVED, &topology,
+        IREE_TASK_WORKER_DEFAULT_LOCAL_MEMORY_SIZE, iree_allocator_system(),
+        &executor_));
+    iree_task_topology_deinitialize(&topology);
+    iree_task_scope_initialize(iree_make_cstring_view("scope"), &scope_);
+  }
+
+  void TearDown() override {
+    iree_task_scope_deinitialize(&scope_);
+    iree_task_executor_release(executor_);
+  }
+
+  // Runs a dispatch over kWorkgroupCount with |dispatch_flags| and waits for it
+  // to retire. Merges into |parent_statistics| if provided.
+  void Dispatch(uint32_t dispatch_flags,
+                iree_task_dispatch_statistics_t* parent_statistics = nullptr) {
+    iree_atomic_int64_t tile_count = IREE_ATOMIC_VAR_INIT(0);
+    iree_task_dispatch_t task;
+    iree_task_dispatch_initialize(
+        &scope_,
+        iree_task_make_dispatch_closure(CountingTile, (uintptr_t)&tile_count),
+        kWorkgroupSize, kWorkgroupCount, &task);
+    task.header.flags |= dispatch_flags;
+    task.parent_statistics = parent_statistics;
+
+    iree_task_fence_t* fence = nullptr;
+    IREE_ASSERT_OK(
+        iree_task_executor_acquire_fence(executor_, &scope_, &fence));
+    iree_task_set_completion_task(&task.header, &fence->header);
+    iree_task_submission_t submission;
+    iree_task_submission_initialize(&submission);
+    iree_task_submission_enqueue(&submission, &task.header);
+    iree_task_executor_submit(executor_, &submission);
+    iree_task_executor_flush(executor_);
+    IREE_ASSERT_OK(
+        iree_task_scope_wait_idle(&scope_, IREE_TIME_INFINITE_FUTURE));
+    ASSERT_EQ(kTileCount, Load(tile_count));
+  }
+
+  // Verifies |statistics| describe |dispatch_count| dispatches.
+  static void VerifyStatistics(
+      const iree_task_dispatch_statistics_t& statistics,
+      int64_t dispatch_count) {
+    EXPECT_EQ(kTileCount * dispatch_count, Load(statistics.tiles_executed));
+    EXPECT_LE(Load(statistics.tiles_stolen), Load(statistics.tiles_executed));
+    EXPECT_GE(Load(statistics.shards_spawned), dispatch_count);
+    EXPECT_LE(Load(statistics.shards_spawned), kTileCount * dispatch_count);
+
+    // Every tile takes at least 1ns so the wall and busy times must cover at
+    // least the slowest and all tiles, respectively.
+    int64_t first_tile_time_ns = Load(statistics.first_tile_time_ns);
+    int64_t last_tile_time_ns = Load(statistics.last_tile_time_ns);
+    EXPECT_GT(first_tile_time_ns, 0);
+    EXPECT_GT(last_tile_time_ns, first_tile_time_ns);
+    int64_t busy_time_ns = 0;
+    for (iree_host_size_t i = 0;
+         i < IREE_ARRAYSIZE(statistics.worker_busy_time_ns); ++i) {
+      int64_t worker_busy_time_ns = Load(statistics.worker_busy_time_ns[i]);
+      if (i >= kWorkerCount) {
+        EXPECT_EQ(0, worker_busy_time_ns);
+      }
+      busy_time_ns += worker_busy_time_ns;
+    }
+    EXPECT_GE(busy_time_ns, kTileCount * dispatch_count);
+  }
+
+  iree_task_executor_t* executor_ = nullptr;
+  iree_task_scope_t scope_;
+};
+
+// Checks that all tiles of both a sharded and a sliced dispatch are counted and
+// rolled up into the scope statistics.
+TEST_F(TaskDispatchTest, Statistics) {
+  static const uint32_t kDispatchFlags[] = {0, IREE_TASK_FLAG_DISPATCH_SLICED};
+  for (uint32_t dispatch_flags : kDispatchFlags) {
+    Dispatch(dispatch_flags);
+    VerifyStatistics(iree_task_scope_consume_statistics(&scope_), 1);
+  }
+}
+
+// Scope statistics accumulate across dispatches until consumed.
+TEST_F(TaskDispatchTest, StatisticsAccumulate) {
+  Dispatch(/*dispatch_flags=*/0);
+  Dispatch(IREE_TASK_FLAG_DISPATCH_SLICED);
+  VerifyStatistics(iree_task_scope_consume_statistics(&scope_), 2);
+
+  // Consuming resets the statistics.
+  iree_task_dispatch_statistics_t statistics =
+      iree_task_scope_consume_statistics(&scope_);
+  EXPECT_EQ(0, Load(statistics.tiles_executed));
+  EXPECT_EQ(0, Load(statistics.shards_spawned));
+  EXPECT_EQ(0, Load(statistics.first_tile_time_ns));
+  EXPECT_EQ(0, Load(statistics.last_tile_time_ns));
+}
+
+// Dispatches with parent statistics (as issued from command buffers) merge into
+// both the parent and the scope.
+TEST_F(TaskDispatchTest, StatisticsParent) {
+  iree_task_dispatch_statistics_t parent_statistics;
+  memset(&parent_statistics, 0, sizeof(parent_statistics));
+  Dispatch(/*dispatch_flags=*/0, &parent_statistics);
+  Dispatch(IREE_TASK_FLAG_DISPATCH_SLICED, &parent_statistics);
+  VerifyStatistics(parent_statistics, 2);
+  VerifyStatistics(iree_task_scope_consume_statistics(&scope_), 2);
+}
+
+}  // namespace
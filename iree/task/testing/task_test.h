@@ -17,6 +17,7 @@
 #include "iree/task/scope.h"
 #include "iree/task/task.h"
 #include "iree/task/topology.h"
+#include "iree/task/tuning.h"
 #include "iree/testing/status_matchers.h"
 
 class TaskTest : public ::testing::Test {
@@ -24,9 +25,10 @@ class TaskTest : public ::testing::Test {
   virtual void SetUp() {
     iree_task_topology_t topology;
     iree_task_topology_initialize_from_group_count(8, &topology);
-    IREE_ASSERT_OK(iree_task_executor_create(IREE_TASK_SCHEDULING_MODE_RESERVED,
-                                             &topology, iree_allocator_system(),
-                                             &executor_));
+    IREE_ASSERT_OK(iree_task_executor_create(
+        IREE_TASK_SCHEDULING_MODE_RESERVED, &topology,
+        IREE_TASK_WORKER_DEFAULT_LOCAL_MEMORY_SIZE, iree_allocator_system(),
+        &executor_));
     iree_task_topology_deinitialize(&topology);
 
     iree_task_scope_initialize(iree_make_cstring_view("scope"), &scope_);
@@ -15,6 +15,10 @@
 #include "iree/base/target_platform.h"
 #include "iree/base/tracing.h"
 
+#if defined(__linux__)
+#include <dirent.h>
+#endif  // __linux__
+
 void iree_task_topology_group_initialize(
     uint8_t group_index, iree_task_topology_group_t* out_group) {
   memset(out_group, 0, sizeof(*out_group));
@@ -23,6 +27,8 @@ void iree_task_topology_group_initialize(
            group_index);
   iree_thread_affinity_set_any(&out_group->ideal_thread_affinity);
   out_group->constructive_sharing_mask = IREE_TASK_TOPOLOGY_GROUP_MASK_ALL;
+  out_group->numa_node = 0;
+  out_group->numa_node_mask = IREE_TASK_TOPOLOGY_GROUP_MASK_ALL;
 }
 
 void iree_task_topology_initialize(iree_task_topology_t* out_topology) {
@@ -175,6 +181,44 @@ static void iree_task_topology_set_affinity_from_processor(
 #endif  // cpuinfo-like platform field
 }
 
+// Returns the NUMA node |processor| is attached to.
+// cpuinfo does not expose NUMA information so on Linux we look for the
+// nodeN link sysfs places in each cpu directory. Elsewhere (or if sysfs is
+// not available) each package (socket) is treated as its own node.
+static uint32_t iree_task_topology_query_processor_numa_node(
+    const struct cpuinfo_processor* processor) {
+#if defined(__linux__)
+  char path[64];
+  snprintf(path, IREE_ARRAYSIZE(path), "/sys/devices/system/cpu/cpu%u",
+           processor->linux_id);
+  DIR* dir = opendir(path);
+  if (dir) {
+    uint32_t numa_node = UINT32_MAX;
+    struct dirent* entry = NULL;
+    while ((entry = readdir(dir)) != NULL) {
+      unsigned int value = 0;
+      if (strncmp(entry->d_name, "node", 4) == 0 &&
+          sscanf(entry->d_name + 4, "%u", &value) == 1) {
+        numa_node = value;
+        break;
+      }
+    }
+    closedir(dir);
+    if (numa_node != UINT32_MAX) return numa_node;
+  }
+#endif  // __linux__
+  const struct cpuinfo_package* first_package = cpuinfo_get_package(0);
+  if (!processor->package || !first_package) return 0;
+  return (uint32_t)(processor->package - first_package);
+}
+
+// Returns the NUMA node |core| is attached to.
+static uint32_t iree_task_topology_query_core_numa_node(
+    const struct cpuinfo_core* core) {
+  return iree_task_topology_query_processor_numa_node(
+      cpuinfo_get_processor(core->processor_start));
+}
+
 // Returns a bitset with all *processors* that share the same |cache|.
 static uint64_t iree_task_topology_calculate_cache_bits(
     const struct cpuinfo_cache* cache) {
@@ -192,15 +236,19 @@ static uint64_t iree_task_topology_calculate_cache_bits(
 
 // Constructs a constructive sharing mask for all *processors* that share the
 // same cache as the specified |processor|.
+//
+// L3 caches are only included when |include_l3_cache| is set as on many
+// systems they are shared by all processors on a node and would make every
+// other group on the node look equally good to steal from.
 static uint64_t iree_task_topology_calculate_constructive_sharing_mask(
-    const struct cpuinfo_processor* processor) {
+    const struct cpuinfo_processor* processor, bool include_l3_cache) {
   uint64_t mask = 0;
   mask |= iree_task_topology_calculate_cache_bits(processor->cache.l1i);
   mask |= iree_task_topology_calculate_cache_bits(processor->cache.l1d);
   mask |= iree_task_topology_calculate_cache_bits(processor->cache.l2);
-  // TODO(benvanik): include L3 here too (for systems that have it)? Or use L3
-  // info purely for distribution and focus the group mask on lower-latency
-  // caches?
+  if (include_l3_cache) {
+    mask |= iree_task_topology_calculate_cache_bits(processor->cache.l3);
+  }
   return mask;
 }
 
@@ -220,6 +268,50 @@ static void iree_task_topology_group_initialize_from_core(
       cpuinfo_get_processor(processor_i);
   iree_task_topology_set_affinity_from_processor(
       processor, &out_group->ideal_thread_affinity);
+  out_group->numa_node =
+      iree_task_topology_query_processor_numa_node(processor);
+}
+
+// Stably sorts the groups in |topology| by NUMA node so that groups on the
+// same node have contiguous indices. Dispatches distribute contiguous ranges
+// of tiles to contiguous worker indices and this keeps those ranges on the
+// same node. Must be called prior to computing the group masks.
+static void iree_task_topology_sort_groups_by_numa_node(
+    iree_task_topology_t* topology) {
+  // Insertion sort as n is always <= 64 and usually already sorted.
+  for (iree_host_size_t i = 1; i < topology->group_count; ++i) {
+    iree_task_topology_group_t group = topology->groups[i];
+    iree_host_size_t j = i;
+    while (j > 0 && topology->groups[j - 1].numa_node > group.numa_node) {
+      topology->groups[j] = topology->groups[j - 1];
+      --j;
+    }
+    topology->groups[j] = group;
+  }
+  for (iree_host_size_t i = 0; i < topology->group_count; ++i) {
+    iree_task_topology_group_t* group = &topology->groups[i];
+    group->group_index = (uint8_t)i;
+    snprintf(group->name, IREE_ARRAYSIZE(group->name), "worker[%u]",
+             (uint32_t)i);
+  }
+}
+
+// Fixes numa_node_mask values such that they represent the other topology
+// groups attached to the same NUMA node.
+static void iree_task_topology_fixup_numa_node_masks(
+    iree_task_topology_t* topology) {
+  for (iree_host_size_t i = 0; i < topology->group_count; ++i) {
+    iree_task_topology_group_t* group = &topology->groups[i];
+    iree_task_topology_group_mask_t group_mask = 0;
+    for (iree_host_size_t j = 0; j < topology->group_count; ++j) {
+      if (i == j) continue;
+      const iree_task_topology_group_t* other_group = &topology->groups[j];
+      if (other_group->numa_node == group->numa_node) {
+        group_mask |= iree_math_rotl_u64(1ull, other_group->group_index);
+      }
+    }
+    group->numa_node_mask = group_mask;
+  }
 }
 
 // Fixes constructive_sharing_mask values such that they represent other chosen
@@ -227,7 +319,7 @@ static void iree_task_topology_group_initialize_from_core(
 // the topology groups doesn't need to know anything about which physical
 // processor IDs a particular group is mapped to.
 static void iree_task_topology_fixup_constructive_sharing_masks(
-    iree_task_topology_t* topology) {
+    bool include_l3_cache, iree_task_topology_t* topology) {
   // O(n^2), but n is always <= 64 (and often <= 8).
   for (iree_host_size_t i = 0; i < topology->group_count; ++i) {
     iree_task_topology_group_t* group = &topology->groups[i];
@@ -235,7 +327,7 @@ static void iree_task_topology_fixup_constructive_sharing_masks(
     // Compute the processors that we can constructively share with.
     uint64_t constructive_sharing_mask =
         iree_task_topology_calculate_constructive_sharing_mask(
-            cpuinfo_get_processor(group->processor_index));
+            cpuinfo_get_processor(group->processor_index), include_l3_cache);
 
     iree_task_topology_group_mask_t group_mask = 0;
     for (iree_host_size_t j = 0; j < topology->group_count; ++j) {
@@ -333,7 +425,10 @@ void iree_task_topology_initialize_from_physical_cores_with_filter(
     }
   }
 
-  iree_task_topology_fixup_constructive_sharing_masks(out_topology);
+  iree_task_topology_sort_groups_by_numa_node(out_topology);
+  iree_task_topology_fixup_constructive_sharing_masks(
+      /*include_l3_cache=*/false, out_topology);
+  iree_task_topology_fixup_numa_node_masks(out_topology);
   IREE_TRACE_ZONE_END(z0);
 }
 
@@ -372,6 +467,147 @@ void iree_task_topology_initialize_from_unique_l2_cache_groups(
     ++group_i;
   }
 
-  iree_task_topology_fixup_constructive_sharing_masks(out_topology);
+  iree_task_topology_sort_groups_by_numa_node(out_topology);
+  iree_task_topology_fixup_constructive_sharing_masks(
+      /*include_l3_cache=*/false, out_topology);
+  iree_task_topology_fixup_numa_node_masks(out_topology);
+  IREE_TRACE_ZONE_END(z0);
+}
+
+iree_host_size_t iree_task_topology_query_numa_node_count(void) {
+  if (!iree_task_topology_is_cpuinfo_available()) return 1;
+  uint32_t max_numa_node = 0;
+  for (uint32_t i = 0; i < cpuinfo_get_cores_count(); ++i) {
+    max_numa_node = iree_max(
+        max_numa_node,
+        iree_task_topology_query_core_numa_node(cpuinfo_get_core(i)));
+  }
+  return (iree_host_size_t)max_numa_node + 1;
+}
+
+// Matches only cores attached to the NUMA node specified in |user_data|.
+static bool iree_task_topology_core_filter_numa_node(
+    const struct cpuinfo_core* core, uintptr_t user_data) {
+  return iree_task_topology_query_core_numa_node(core) == user_data;
+}
+
+void iree_task_topology_initialize_from_numa_node(
+    uint32_t numa_node, iree_host_size_t max_group_count,
+    iree_task_topology_t* out_topology) {
+  iree_task_topology_initialize_from_physical_cores_with_filter(
+      iree_task_topology_core_filter_numa_node, numa_node, max_group_count,
+      out_topology);
+  if (!out_topology->group_count) {
+    // No cores on the node (or no NUMA information).
+    iree_task_topology_initialize_from_physical_cores(max_group_count,
+                                                      out_topology);
+  }
+}
+
+// Maximum number of distinct domains that cores are distributed across.
+// Domains beyond this are folded together.
+#define IREE_TASK_TOPOLOGY_MAX_DOMAIN_COUNT 64
+
+// Returns the index of the domain |core| belongs to.
+typedef uint32_t (*iree_task_topology_core_domain_fn_t)(
+    const struct cpuinfo_core* core);
+
+static uint32_t iree_task_topology_core_domain_numa_node(
+    const struct cpuinfo_core* core) {
+  return iree_task_topology_query_core_numa_node(core) %
+         IREE_TASK_TOPOLOGY_MAX_DOMAIN_COUNT;
+}
+
+static uint32_t iree_task_topology_core_domain_l3_cache(
+    const struct cpuinfo_core* core) {
+  const struct cpuinfo_cache* cache =
+      cpuinfo_get_processor(core->processor_start)->cache.l3;
+  if (!cache) return 0;
+  return (uint32_t)(cache - cpuinfo_get_l3_cache(0)) %
+         IREE_TASK_TOPOLOGY_MAX_DOMAIN_COUNT;
+}
+
+// Initializes |out_topology| with one group per physical core distributed
+// round-robin across the domains returned by |domain_fn| up to
+// |max_group_count| and ordered by domain.
+static void iree_task_topology_initialize_from_core_domains(
+    iree_task_topology_core_domain_fn_t domain_fn, bool include_l3_cache,
+    iree_host_size_t max_group_count, iree_task_topology_t* out_topology) {
+  max_group_count =
+      iree_min(max_group_count, IREE_TASK_TOPOLOGY_GROUP_BIT_COUNT);
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  // Count the cores in each domain.
+  uint32_t core_count = cpuinfo_get_cores_count();
+  uint32_t domain_core_counts[IREE_TASK_TOPOLOGY_MAX_DOMAIN_COUNT] = {0};
+  for (uint32_t i = 0; i < core_count; ++i) {
+    ++domain_core_counts[domain_fn(cpuinfo_get_core(i))];
+  }
+
+  // Take one core from each domain in turn until we run out of cores or hit
+  // the maximum so that domains are evenly utilized.
+  uint32_t domain_quotas[IREE_TASK_TOPOLOGY_MAX_DOMAIN_COUNT] = {0};
+  iree_host_size_t group_count = 0;
+  bool any_remaining = true;
+  while (any_remaining && group_count < max_group_count) {
+    any_remaining = false;
+    for (uint32_t domain_i = 0;
+         domain_i < IREE_TASK_TOPOLOGY_MAX_DOMAIN_COUNT &&
+         group_count < max_group_count;
+         ++domain_i) {
+      if (domain_quotas[domain_i] < domain_core_counts[domain_i]) {
+        ++domain_quotas[domain_i];
+        ++group_count;
+        any_remaining = true;
+      }
+    }
+  }
+
+  // Emit the selected cores in domain order.
+  iree_task_topology_initialize(out_topology);
+  iree_host_size_t group_i = 0;
+  for (uint32_t domain_i = 0; domain_i < IREE_TASK_TOPOLOGY_MAX_DOMAIN_COUNT;
+       ++domain_i) {
+    uint32_t remaining = domain_quotas[domain_i];
+    for (uint32_t core_i = 0; core_i < core_count && remaining; ++core_i) {
+      const struct cpuinfo_core* core = cpuinfo_get_core(core_i);
+      if (domain_fn(core) != domain_i) continue;
+      iree_task_topology_group_initialize_from_core(
+          (uint32_t)group_i, core, &out_topology->groups[group_i]);
+      ++group_i;
+      --remaining;
+    }
+  }
+  out_topology->group_count = group_i;
+
+  iree_task_topology_sort_groups_by_numa_node(out_topology);
+  iree_task_topology_fixup_constructive_sharing_masks(include_l3_cache,
+                                                      out_topology);
+  iree_task_topology_fixup_numa_node_masks(out_topology);
   IREE_TRACE_ZONE_END(z0);
 }
+
+void iree_task_topology_initialize_from_numa_nodes(
+    iree_host_size_t max_group_count, iree_task_topology_t* out_topology) {
+  if (!iree_task_topology_is_cpuinfo_available()) {
+    iree_task_topology_initialize_from_physical_cores(max_group_count,
+                                                      out_topology);
+    return;
+  }
+  iree_task_topology_initialize_from_core_domains(
+      iree_task_topology_core_domain_numa_node, /*include_l3_cache=*/false,
+      max_group_count, out_topology);
+}
+
+void iree_task_topology_initialize_from_l3_cache_domains(
+    iree_host_size_t max_group_count, iree_task_topology_t* out_topology) {
+  if (!iree_task_topology_is_cpuinfo_available() ||
+      !cpuinfo_get_l3_caches_count()) {
+    iree_task_topology_initialize_from_numa_nodes(max_group_count,
+                                                  out_topology);
+    return;
+  }
+  iree_task_topology_initialize_from_core_domains(
+      iree_task_topology_core_domain_l3_cache, /*include_l3_cache=*/true,
+      max_group_count, out_topology);
+}
@@ -54,6 +54,17 @@ typedef struct iree_task_topology_group_t {
   // workers in a group all share an L2 cache then the groups indicated here may
   // all share the same L3 cache.
   iree_task_topology_group_mask_t constructive_sharing_mask;
+
+  // NUMA node the processors of this group are attached to, or 0 if unknown.
+  // Used for diagnostics and for ordering groups within topologies such that
+  // groups on the same node are contiguous.
+  uint32_t numa_node;
+
+  // A bitmask of other group indices that are attached to the same NUMA node.
+  // Work moved between these groups continues to access node-local memory
+  // while work moved to any other group may need to access remote memory
+  // across the socket interconnect. Defaults to all groups when unknown.
+  iree_task_topology_group_mask_t numa_node_mask;
 } iree_task_topology_group_t;
 
 // Initializes |out_group| with a |group_index| derived name.
@@ -163,6 +174,41 @@ void iree_task_topology_initialize_from_physical_cores_with_filter(
 void iree_task_topology_initialize_from_unique_l2_cache_groups(
     iree_host_size_t max_group_count, iree_task_topology_t* out_topology);
 
+// Returns the total number of NUMA nodes in the machine or 1 if unknown.
+// On Linux this is queried from sysfs and elsewhere each processor package is
+// treated as its own node.
+iree_host_size_t iree_task_topology_query_numa_node_count(void);
+
+// Initializes a topology with one group for each physical core attached to
+// |numa_node|. Use this to create one executor per NUMA node such that all
+// work scheduled on each executor stays on the node. Falls back to the same
+// behavior as iree_task_topology_initialize_from_physical_cores if NUMA
+// information is not available or |numa_node| has no cores.
+void iree_task_topology_initialize_from_numa_node(
+    uint32_t numa_node, iree_host_size_t max_group_count,
+    iree_task_topology_t* out_topology);
+
+// Initializes a topology with one group for each physical core distributed
+// evenly across all NUMA nodes up to |max_group_count|. Groups are ordered by
+// node so that contiguous ranges of dispatch tiles are assigned to workers on
+// the same node and work stealing prefers workers on the same node.
+//
+// If NUMA information is not available this falls back to the same behavior
+// as iree_task_topology_initialize_from_physical_cores.
+void iree_task_topology_initialize_from_numa_nodes(
+    iree_host_size_t max_group_count, iree_task_topology_t* out_topology);
+
+// Initializes a topology with one group for each physical core distributed
+// evenly across all L3 (last-level) cache domains up to |max_group_count|.
+// Groups are ordered by cache domain and constructively share with all other
+// groups in the same domain so that work stealing prefers victims whose data
+// is likely already in the shared cache.
+//
+// If L3 cache information is not available this falls back to the same
+// behavior as iree_task_topology_initialize_from_numa_nodes.
+void iree_task_topology_initialize_from_l3_cache_domains(
+    iree_host_size_t max_group_count, iree_task_topology_t* out_topology);
+
 // TODO(#4654): more helpers and better defaults for the platforms we support.
 // Users can always make their own but just using these is the common path.
 // Ideas:
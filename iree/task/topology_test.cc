@@ -131,6 +131,24 @@ static void EnsureTopologyValid(iree_host_size_t max_group_count,
     const iree_task_topology_group_t* group =
         iree_task_topology_get_group(topology, i);
     EXPECT_EQ(i, group->group_index);
+    // Groups must be ordered by NUMA node and their node mask must contain
+    // exactly the other groups on the same node (never the group itself).
+    if (i > 0) {
+      const iree_task_topology_group_t* prev_group =
+          iree_task_topology_get_group(topology, i - 1);
+      EXPECT_LE(prev_group->numa_node, group->numa_node);
+    }
+    for (iree_host_size_t j = 0; j < iree_task_topology_group_count(topology);
+         ++j) {
+      const iree_task_topology_group_t* other_group =
+          iree_task_topology_get_group(topology, j);
+      bool in_mask = (group->numa_node_mask & (1ull << j)) != 0;
+      if (i == j) {
+        EXPECT_FALSE(in_mask);
+      } else {
+        EXPECT_EQ(other_group->numa_node == group->numa_node, in_mask);
+      }
+    }
   }
 }
 
@@ -143,4 +161,32 @@ TEST(TopologyTest, FromPhysicalCores) {
   iree_task_topology_deinitialize(&topology);
 }
 
+TEST(TopologyTest, FromNumaNodes) {
+  static constexpr iree_host_size_t kMaxGroupCount = 4;
+  iree_task_topology_t topology;
+  iree_task_topology_initialize(&topology);
+  iree_task_topology_initialize_from_numa_nodes(kMaxGroupCount, &topology);
+  EnsureTopologyValid(kMaxGroupCount, &topology);
+  iree_task_topology_deinitialize(&topology);
+}
+
+TEST(TopologyTest, FromL3CacheDomains) {
+  static constexpr iree_host_size_t kMaxGroupCount = 4;
+  iree_task_topology_t topology;
+  iree_task_topology_initialize(&topology);
+  iree_task_topology_initialize_from_l3_cache_domains(kMaxGroupCount,
+                                                      &topology);
+  EnsureTopologyValid(kMaxGroupCount, &topology);
+  iree_task_topology_deinitialize(&topology);
+}
+
+TEST(TopologyTest, FromNumaNode) {
+  static constexpr iree_host_size_t kMaxGroupCount = 4;
+  iree_task_topology_t topology;
+  iree_task_topology_initialize(&topology);
+  iree_task_topology_initialize_from_numa_node(0, kMaxGroupCount, &topology);
+  EnsureTopologyValid(kMaxGroupCount, &topology);
+  iree_task_topology_deinitialize(&topology);
+}
+
 }  // namespace
@@ -78,37 +78,84 @@ extern "C" {
 #define IREE_TASK_EXECUTOR_MAX_THEFT_TASK_COUNT \
   IREE_TASK_EXECUTOR_MAX_WORKER_COUNT
 
-// Number of tiles that will be batched into a single slice along each XYZ dim.
+// Default number of tiles that will be batched into a single slice or shard
+// reservation from the grid when the dispatch does not specify its own
+// iree_task_dispatch_t::tiles_per_reservation.
 //
-// Larger numbers reduce overhead and ensure that more tiles are executed
-// locally on the same worker (== shared caches) while also increasing potential
-// latency as work-stealing (always per-slice) is less effective.
-//
-// Numbers >1 on Y and Z can be used to cluster tiles together within the same
-// slice when spatial coherence outside of the X dimension is useful.
-//
-// The current usage of this is provisional; we may do all of this from the
-// compiler and want this behavior to be relatively fixed so that we can predict
-// it better. The only thing we want to be introducing here is flexibility for
-// when worker topology differs at runtime from what is knowable during offline
-// compilation.
-#define IREE_TASK_DISPATCH_TILES_PER_SLICE_X (8)
-#define IREE_TASK_DISPATCH_TILES_PER_SLICE_Y (1)
-#define IREE_TASK_DISPATCH_TILES_PER_SLICE_Z (1)
-
-// Number of tiles that will be batched into a single reservation from the grid.
-// This is a maximum; if there are fewer tiles that would otherwise allow for
-// maximum parallelism then this may be ignored.
-//
-// The more tiles reserved at a time the higher the chance for latency to
-// increase as many reserved tiles are held up on one worker while another may
-// have otherwise been able to steal them and help finish them sooner.
+// The more tiles reserved at a time the lower the scheduling overhead and the
+// more tiles are executed locally on the same worker (== shared caches) while
+// also increasing potential latency as many reserved tiles are held up on one
+// worker while another may have otherwise been able to steal them and help
+// finish them sooner.
 //
 // The fewer tiles reserved at a time the higher the chance for cache-locality
 // destroying behavior where multiple workers all stomp on the same cache lines
 // (as say worker 0 and worker 1 both fight over sequential tiles adjacent in
 // memory).
-#define IREE_TASK_DISPATCH_MAX_TILES_PER_SHARD_RESERVATION (8)
+//
+// Executables can override this per entry point when they know the cost of
+// their tiles; this is only used when no better information is available.
+#define IREE_TASK_DISPATCH_DEFAULT_TILES_PER_RESERVATION (8)
+
+// Minimum number of reservations each worker should be able to make from a
+// dispatch before the tiles per reservation are reduced.
+//
+// Small dispatches would otherwise be split into only a few large reservations
+// that leave workers idle and nothing for them to steal. With a value of N a
+// dispatch must have at least N reservations per worker available before any
+// reservation is made larger than a single tile.
+#define IREE_TASK_DISPATCH_MIN_RESERVATIONS_PER_WORKER (4)
+
+// Minimum length in bytes of a buffer transfer (fill/copy) before it is split
+// into tiles that can be processed by multiple workers in parallel.
+//
+// Below this size a single worker performs the entire transfer as the fixed
+// cost of fanning out and joining the tiles is greater than the additional
+// memory bandwidth gained. See task_command_buffer_benchmark for the crossover.
+#define IREE_TASK_TRANSFER_TILING_THRESHOLD (1 * 1024 * 1024)
+
+// Length in bytes of each tile of a tiled buffer transfer.
+// Must be a multiple of the largest supported fill pattern length (8 bytes).
+// Tiles should be large enough to amortize the per-tile buffer mapping and
+// small enough that work-stealing can balance the transfer across workers.
+#define IREE_TASK_TRANSFER_TILE_SIZE (128 * 1024)
+
+// Default size in bytes of the worker-local memory available to each tile
+// executed on a worker. This is scratch space that tiles can use for packing
+// and other temporaries without having to allocate. The contents are undefined
+// at the start of each tile and must not be retained across tiles.
+//
+// Sized to fit comfortably within the L2 cache of most cores so that the
+// memory stays hot across tiles executed by the same worker.
+#define IREE_TASK_WORKER_DEFAULT_LOCAL_MEMORY_SIZE (64 * 1024)
+
+// Alignment in bytes of the worker-local memory. Each worker's memory starts
+// on its own cache line so that workers never share lines.
+#define IREE_TASK_WORKER_LOCAL_MEMORY_ALIGNMENT \
+  iree_hardware_destructive_interference_size
+
+// Whether to count per-dispatch execution statistics in
+// iree_task_dispatch_statistics_t. When disabled the statistics structure is
+// empty and no counting or timing is performed. When enabled each slice/shard
+// samples the clock once at the start and end of its execution and merges its
+// counters into the dispatch as it retires.
+//
+// This is independent of tracing so that the statistics can be gathered in
+// production builds where Tracy is not available.
+//
+// NOTE: this changes the layout of iree_task_dispatch_statistics_t and
+// iree_task_dispatch_t, which are embedded by value in other libraries such as
+// iree/hal/local/. Override it project-wide (for example by adding
+// -DIREE_TASK_DISPATCH_STATISTICS_ENABLE=1 to the global compiler flags) and
+// never only when compiling iree/task/: mixing values in one binary is an ODR
+// violation that corrupts memory at runtime. The only consumers today are
+// iree_task_scope_consume_statistics and the internal
+// iree_hal_task_command_buffer_consume_statistics; no public HAL API exposes
+// them. The task_statistics_test target builds a private copy of iree/task/
+// with the statistics enabled to keep them tested.
+#if !defined(IREE_TASK_DISPATCH_STATISTICS_ENABLE)
+#define IREE_TASK_DISPATCH_STATISTICS_ENABLE 0
+#endif  // !IREE_TASK_DISPATCH_STATISTICS_ENABLE
 
 // Whether to enable per-tile colors for each tile tracing zone based on the
 // tile grid xyz. Not cheap and can be disabled to reduce tracing overhead.
@@ -22,18 +22,22 @@ static int iree_task_worker_main(iree_task_worker_t* worker);
 iree_status_t iree_task_worker_initialize(
     iree_task_executor_t* executor, iree_host_size_t worker_index,
     const iree_task_topology_group_t* topology_group,
-    iree_prng_splitmix64_state_t* seed_prng, iree_task_worker_t* out_worker) {
+    iree_byte_span_t local_memory, iree_prng_splitmix64_state_t* seed_prng,
+    iree_task_worker_t* out_worker) {
   IREE_TRACE_ZONE_BEGIN(z0);
 
   out_worker->executor = executor;
+  out_worker->worker_index = (uint32_t)worker_index;
   out_worker->worker_bit = iree_task_affinity_for_worker(worker_index);
   out_worker->ideal_thread_affinity = topology_group->ideal_thread_affinity;
   out_worker->constructive_sharing_mask =
       topology_group->constructive_sharing_mask;
+  out_worker->numa_node_mask = topology_group->numa_node_mask;
   out_worker->max_theft_attempts =
       executor->worker_count / IREE_TASK_EXECUTOR_MAX_THEFT_ATTEMPTS_DIVISOR;
   iree_prng_minilcg128_initialize(iree_prng_splitmix64_next(seed_prng),
                                   &out_worker->theft_prng);
+  out_worker->local_memory = local_memory;
 
   iree_task_worker_state_t initial_state = IREE_TASK_WORKER_STATE_RUNNING;
   if (executor->scheduling_mode &
@@ -183,12 +187,14 @@ static iree_status_t iree_task_worker_execute(
     }
     case IREE_TASK_TYPE_DISPATCH_SLICE: {
       IREE_RETURN_IF_ERROR(iree_task_dispatch_slice_execute(
-          (iree_task_dispatch_slice_t*)task, pending_submission));
+          (iree_task_dispatch_slice_t*)task, worker->worker_index,
+          worker->local_memory, pending_submission));
       break;
     }
     case IREE_TASK_TYPE_DISPATCH_SHARD: {
       IREE_RETURN_IF_ERROR(iree_task_dispatch_shard_execute(
-          (iree_task_dispatch_shard_t*)task, pending_submission));
+          (iree_task_dispatch_shard_t*)task, worker->worker_index,
+          worker->local_memory, pending_submission));
       break;
     }
     default:
@@ -230,12 +236,13 @@ static bool iree_task_worker_pump_once(
 
   // If we ran out of work assigned to this specific worker try to steal some
   // from other workers that we hopefully share some of the cache hierarchy
-  // with. Their tasks will be moved from their local queue into ours and the
-  // the first task in the queue is popped off and returned.
+  // (or at least the NUMA node) with. Their tasks will be moved from their
+  // local queue into ours and the the first task in the queue is popped off
+  // and returned.
   if (!task) {
     task = iree_task_executor_try_steal_task(
         worker->executor, worker->constructive_sharing_mask,
-        worker->max_theft_attempts, &worker->theft_prng,
+        worker->numa_node_mask, worker->max_theft_attempts, &worker->theft_prng,
         &worker->local_task_queue);
   }
 
@@ -359,6 +366,14 @@ static int iree_task_worker_main(iree_task_worker_t* worker) {
                                  iree_memory_order_seq_cst) !=
       IREE_TASK_WORKER_STATE_EXITING;
   if (IREE_LIKELY(should_run)) {
+    // Clear the worker-local memory from this thread now that it is running
+    // with its requested affinity. This is the first touch of the pages and on
+    // NUMA systems places them on the node of the worker instead of the node
+    // of the thread that created the executor.
+    if (worker->local_memory.data_length > 0) {
+      memset(worker->local_memory.data, 0, worker->local_memory.data_length);
+    }
+
     // << work happens here >>
     iree_task_worker_pump_until_exit(worker);
   }
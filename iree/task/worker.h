@@ -84,6 +84,9 @@ typedef struct iree_task_worker_t {
   // pool. Executors always outlive the workers they own.
   iree_task_executor_t* executor;
 
+  // Index of the worker in the executor worker list.
+  uint32_t worker_index;
+
   // Bit the worker represents in the various worker bitsets.
   iree_task_affinity_set_t worker_bit;
 
@@ -97,6 +100,10 @@ typedef struct iree_task_worker_t {
   // all share the same L3 cache.
   iree_task_affinity_set_t constructive_sharing_mask;
 
+  // A bitmask of other workers attached to the same NUMA node. Stealing from
+  // or posting to these workers keeps work accessing node-local memory.
+  iree_task_affinity_set_t numa_node_mask;
+
   // Maximum number of attempts to make when trying to steal tasks from other
   // workers. This could be 64 (try stealing from all workers) or just a handful
   // (try stealing from these 3 other cores that share your L3 cache).
@@ -106,6 +113,10 @@ typedef struct iree_task_worker_t {
   // Only ever touched by the worker thread as it steals work.
   iree_prng_minilcg128_state_t theft_prng;
 
+  // Worker-local memory provided to each tile executed by the worker.
+  // Owned by the executor and only ever touched by the worker thread.
+  iree_byte_span_t local_memory;
+
   // Thread handle of the worker. If the thread has exited the handle will
   // remain valid so that the executor can query its state.
   iree_thread_t* thread;
@@ -138,10 +149,14 @@ static_assert(offsetof(iree_task_worker_t, local_task_queue) >=
 // tasks. Where supported the worker will be created in a suspended state so
 // that we aren't creating a thundering herd on startup:
 // https://en.wikipedia.org/wiki/Thundering_herd_problem
+//
+// |local_memory| is the worker-local scratch memory passed to all tiles
+// executed by the worker and must remain valid for the lifetime of the worker.
 iree_status_t iree_task_worker_initialize(
     iree_task_executor_t* executor, iree_host_size_t worker_index,
     const iree_task_topology_group_t* topology_group,
-    iree_prng_splitmix64_state_t* seed_prng, iree_task_worker_t* out_worker);
+    iree_byte_span_t local_memory, iree_prng_splitmix64_state_t* seed_prng,
+    iree_task_worker_t* out_worker);
 
 // Deinitializes a worker that has successfully exited. The worker must be in
 // the IREE_TASK_WORKER_STATE_ZOMBIE state.
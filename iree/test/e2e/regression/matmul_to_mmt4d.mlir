@@ -0,0 +1,137 @@
+// Matmuls whose shapes are multiples of the default 8x8x1 blocks are packed
+// into the mmt4d layout with -iree-flow-enable-matmul-to-mmt4d. The operands
+// are not splats so that any mismatch between the packing, the blocked matmul,
+// and the unpacking of the result shows up in the values. Constant RHS operands
+// are packed at compile time.
+
+func @f32() {
+  %lhs = iree.unfoldable_constant dense<[
+      [-5.0, 0.0, 5.0, -1.0],
+      [4.0, -2.0, 3.0, -3.0],
+      [2.0, -4.0, 1.0, -5.0],
+      [0.0, 5.0, -1.0, 4.0],
+      [-2.0, 3.0, -3.0, 2.0],
+      [-4.0, 1.0, -5.0, 0.0],
+      [5.0, -1.0, 4.0, -2.0],
+      [3.0, -3.0, 2.0, -4.0],
+      [1.0, -5.0, 0.0, 5.0],
+      [-1.0, 4.0, -2.0, 3.0],
+      [-3.0, 2.0, -4.0, 1.0],
+      [-5.0, 0.0, 5.0, -1.0],
+      [4.0, -2.0, 3.0, -3.0],
+      [2.0, -4.0, 1.0, -5.0],
+      [0.0, 5.0, -1.0, 4.0],
+      [-2.0, 3.0, -3.0, 2.0]]> : tensor<16x4xf32>
+  %rhs = iree.unfoldable_constant dense<[
+      [-3.0, 0.0, 3.0, -1.0, 2.0, -2.0, 1.0, -3.0, 0.0, 3.0, -1.0, 2.0, -2.0, 1.0, -3.0, 0.0, 3.0, -1.0, 2.0, -2.0, 1.0, -3.0, 0.0, 3.0],
+      [-1.0, 2.0, -2.0, 1.0, -3.0, 0.0, 3.0, -1.0, 2.0, -2.0, 1.0, -3.0, 0.0, 3.0, -1.0, 2.0, -2.0, 1.0, -3.0, 0.0, 3.0, -1.0, 2.0, -2.0],
+      [1.0, -3.0, 0.0, 3.0, -1.0, 2.0, -2.0, 1.0, -3.0, 0.0, 3.0, -1.0, 2.0, -2.0, 1.0, -3.0, 0.0, 3.0, -1.0, 2.0, -2.0, 1.0, -3.0, 0.0],
+      [3.0, -1.0, 2.0, -2.0, 1.0, -3.0, 0.0, 3.0, -1.0, 2.0, -2.0, 1.0, -3.0, 0.0, 3.0, -1.0, 2.0, -2.0, 1.0, -3.0, 0.0, 3.0, -1.0, 2.0]]> : tensor<4x24xf32>
+  %res = "mhlo.dot"(%lhs, %rhs) : (tensor<16x4xf32>, tensor<4x24xf32>) -> tensor<16x24xf32>
+  check.expect_almost_eq_const(%res, dense<[
+      [17.0, -14.0, -17.0, 22.0, -16.0, 23.0, -15.0, 17.0, -14.0, -17.0, 22.0, -16.0, 23.0, -15.0, 17.0, -14.0, -17.0, 22.0, -16.0, 23.0, -15.0, 17.0, -14.0, -17.0],
+      [-16.0, -10.0, 10.0, 9.0, 8.0, 7.0, -8.0, -16.0, -10.0, 10.0, 9.0, 8.0, 7.0, -8.0, -16.0, -10.0, 10.0, 9.0, 8.0, 7.0, -8.0, -16.0, -10.0, 10.0],
+      [-16.0, -6.0, 4.0, 7.0, 10.0, 13.0, -12.0, -16.0, -6.0, 4.0, 7.0, 10.0, 13.0, -12.0, -16.0, -6.0, 4.0, 7.0, 10.0, 13.0, -12.0, -16.0, -6.0, 4.0],
+      [6.0, 9.0, -2.0, -6.0, -10.0, -14.0, 17.0, 6.0, 9.0, -2.0, -6.0, -10.0, -14.0, 17.0, 6.0, 9.0, -2.0, -6.0, -10.0, -14.0, 17.0, 6.0, 9.0, -2.0],
+      [6.0, 13.0, -8.0, -8.0, -8.0, -8.0, 13.0, 6.0, 13.0, -8.0, -8.0, -8.0, -8.0, 13.0, 6.0, 13.0, -8.0, -8.0, -8.0, -8.0, 13.0, 6.0, 13.0, -8.0],
+      [6.0, 17.0, -14.0, -10.0, -6.0, -2.0, 9.0, 6.0, 17.0, -14.0, -10.0, -6.0, -2.0, 9.0, 6.0, 17.0, -14.0, -10.0, -6.0, -2.0, 9.0, 6.0, 17.0, -14.0],
+      [-16.0, -12.0, 13.0, 10.0, 7.0, 4.0, -6.0, -16.0, -12.0, 13.0, 10.0, 7.0, 4.0, -6.0, -16.0, -12.0, 13.0, 10.0, 7.0, 4.0, -6.0, -16.0, -12.0, 13.0],
+      [-16.0, -8.0, 7.0, 8.0, 9.0, 10.0, -10.0, -16.0, -8.0, 7.0, 8.0, 9.0, 10.0, -10.0, -16.0, -8.0, 7.0, 8.0, 9.0, 10.0, -10.0, -16.0, -8.0, 7.0],
+      [17.0, -15.0, 23.0, -16.0, 22.0, -17.0, -14.0, 17.0, -15.0, 23.0, -16.0, 22.0, -17.0, -14.0, 17.0, -15.0, 23.0, -16.0, 22.0, -17.0, -14.0, 17.0, -15.0, 23.0],
+      [6.0, 11.0, -5.0, -7.0, -9.0, -11.0, 15.0, 6.0, 11.0, -5.0, -7.0, -9.0, -11.0, 15.0, 6.0, 11.0, -5.0, -7.0, -9.0, -11.0, 15.0, 6.0, 11.0, -5.0],
+      [6.0, 15.0, -11.0, -9.0, -7.0, -5.0, 11.0, 6.0, 15.0, -11.0, -9.0, -7.0, -5.0, 11.0, 6.0, 15.0, -11.0, -9.0, -7.0, -5.0, 11.0, 6.0, 15.0, -11.0],
+      [17.0, -14.0, -17.0, 22.0, -16.0, 23.0, -15.0, 17.0, -14.0, -17.0, 22.0, -16.0, 23.0, -15.0, 17.0, -14.0, -17.0, 22.0, -16.0, 23.0, -15.0, 17.0, -14.0, -17.0],
+      [-16.0, -10.0, 10.0, 9.0, 8.0, 7.0, -8.0, -16.0, -10.0, 10.0, 9.0, 8.0, 7.0, -8.0, -16.0, -10.0, 10.0, 9.0, 8.0, 7.0, -8.0, -16.0, -10.0, 10.0],
+      [-16.0, -6.0, 4.0, 7.0, 10.0, 13.0, -12.0, -16.0, -6.0, 4.0, 7.0, 10.0, 13.0, -12.0, -16.0, -6.0, 4.0, 7.0, 10.0, 13.0, -12.0, -16.0, -6.0, 4.0],
+      [6.0, 9.0, -2.0, -6.0, -10.0, -14.0, 17.0, 6.0, 9.0, -2.0, -6.0, -10.0, -14.0, 17.0, 6.0, 9.0, -2.0, -6.0, -10.0, -14.0, 17.0, 6.0, 9.0, -2.0],
+      [6.0, 13.0, -8.0, -8.0, -8.0, -8.0, 13.0, 6.0, 13.0, -8.0, -8.0, -8.0, -8.0, 13.0, 6.0, 13.0, -8.0, -8.0, -8.0, -8.0, 13.0, 6.0, 13.0, -8.0]]> : tensor<16x24xf32>) : tensor<16x24xf32>
+  return
+}
+
+func @i32() {
+  %lhs = iree.unfoldable_constant dense<[
+      [-5, 0, 5, -1],
+      [4, -2, 3, -3],
+      [2, -4, 1, -5],
+      [0, 5, -1, 4],
+      [-2, 3, -3, 2],
+      [-4, 1, -5, 0],
+      [5, -1, 4, -2],
+      [3, -3, 2, -4],
+      [1, -5, 0, 5],
+      [-1, 4, -2, 3],
+      [-3, 2, -4, 1],
+      [-5, 0, 5, -1],
+      [4, -2, 3, -3],
+      [2, -4, 1, -5],
+      [0, 5, -1, 4],
+      [-2, 3, -3, 2]]> : tensor<16x4xi32>
+  %rhs = iree.unfoldable_constant dense<[
+      [-3, 0, 3, -1, 2, -2, 1, -3, 0, 3, -1, 2, -2, 1, -3, 0, 3, -1, 2, -2, 1, -3, 0, 3],
+      [-1, 2, -2, 1, -3, 0, 3, -1, 2, -2, 1, -3, 0, 3, -1, 2, -2, 1, -3, 0, 3, -1, 2, -2],
+      [1, -3, 0, 3, -1, 2, -2, 1, -3, 0, 3, -1, 2, -2, 1, -3, 0, 3, -1, 2, -2, 1, -3, 0],
+      [3, -1, 2, -2, 1, -3, 0, 3, -1, 2, -2, 1, -3, 0, 3, -1, 2, -2, 1, -3, 0, 3, -1, 2]]> : tensor<4x24xi32>
+  %res = "mhlo.dot"(%lhs, %rhs) : (tensor<16x4xi32>, tensor<4x24xi32>) -> tensor<16x24xi32>
+  check.expect_eq_const(%res, dense<[
+      [17, -14, -17, 22, -16, 23, -15, 17, -14, -17, 22, -16, 23, -15, 17, -14, -17, 22, -16, 23, -15, 17, -14, -17],
+      [-16, -10, 10, 9, 8, 7, -8, -16, -10, 10, 9, 8, 7, -8, -16, -10, 10, 9, 8, 7, -8, -16, -10, 10],
+      [-16, -6, 4, 7, 10, 13, -12, -16, -6, 4, 7, 10, 13, -12, -16, -6, 4, 7, 10, 13, -12, -16, -6, 4],
+      [6, 9, -2, -6, -10, -14, 17, 6, 9, -2, -6, -10, -14, 17, 6, 9, -2, -6, -10, -14, 17, 6, 9, -2],
+      [6, 13, -8, -8, -8, -8, 13, 6, 13, -8, -8, -8, -8, 13, 6, 13, -8, -8, -8, -8, 13, 6, 13, -8],
+      [6, 17, -14, -10, -6, -2, 9, 6, 17, -14, -10, -6, -2, 9, 6, 17, -14, -10, -6, -2, 9, 6, 17, -14],
+      [-16, -12, 13, 10, 7, 4, -6, -16, -12, 13, 10, 7, 4, -6, -16, -12, 13, 10, 7, 4, -6, -16, -12, 13],
+      [-16, -8, 7, 8, 9, 10, -10, -16, -8, 7, 8, 9, 10, -10, -16, -8, 7, 8, 9, 10, -10, -16, -8, 7],
+      [17, -15, 23, -16, 22, -17, -14, 17, -15, 23, -16, 22, -17, -14, 17, -15, 23, -16, 22, -17, -14, 17, -15, 23],
+      [6, 11, -5, -7, -9, -11, 15, 6, 11, -5, -7, -9, -11, 15, 6, 11, -5, -7, -9, -11, 15, 6, 11, -5],
+      [6, 15, -11, -9, -7, -5, 11, 6, 15, -11, -9, -7, -5, 11, 6, 15, -11, -9, -7, -5, 11, 6, 15, -11],
+      [17, -14, -17, 22, -16, 23, -15, 17, -14, -17, 22, -16, 23, -15, 17, -14, -17, 22, -16, 23, -15, 17, -14, -17],
+      [-16, -10, 10, 9, 8, 7, -8, -16, -10, 10, 9, 8, 7, -8, -16, -10, 10, 9, 8, 7, -8, -16, -10, 10],
+      [-16, -6, 4, 7, 10, 13, -12, -16, -6, 4, 7, 10, 13, -12, -16, -6, 4, 7, 10, 13, -12, -16, -6, 4],
+      [6, 9, -2, -6, -10, -14, 17, 6, 9, -2, -6, -10, -14, 17, 6, 9, -2, -6, -10, -14, 17, 6, 9, -2],
+      [6, 13, -8, -8, -8, -8, 13, 6, 13, -8, -8, -8, -8, 13, 6, 13, -8, -8, -8, -8, 13, 6, 13, -8]]> : tensor<16x24xi32>) : tensor<16x24xi32>
+  return
+}
+
+func @constant_rhs() {
+  %lhs = iree.unfoldable_constant dense<[
+      [-5.0, 0.0, 5.0, -1.0],
+      [4.0, -2.0, 3.0, -3.0],
+      [2.0, -4.0, 1.0, -5.0],
+      [0.0, 5.0, -1.0, 4.0],
+      [-2.0, 3.0, -3.0, 2.0],
+      [-4.0, 1.0, -5.0, 0.0],
+      [5.0, -1.0, 4.0, -2.0],
+      [3.0, -3.0, 2.0, -4.0],
+      [1.0, -5.0, 0.0, 5.0],
+      [-1.0, 4.0, -2.0, 3.0],
+      [-3.0, 2.0, -4.0, 1.0],
+      [-5.0, 0.0, 5.0, -1.0],
+      [4.0, -2.0, 3.0, -3.0],
+      [2.0, -4.0, 1.0, -5.0],
+      [0.0, 5.0, -1.0, 4.0],
+      [-2.0, 3.0, -3.0, 2.0]]> : tensor<16x4xf32>
+  %rhs = constant dense<[
+      [-3.0, 0.0, 3.0, -1.0, 2.0, -2.0, 1.0, -3.0, 0.0, 3.0, -1.0, 2.0, -2.0, 1.0, -3.0, 0.0, 3.0, -1.0, 2.0, -2.0, 1.0, -3.0, 0.0, 3.0],
+      [-1.0, 2.0, -2.0, 1.0, -3.0, 0.0, 3.0, -1.0, 2.0, -2.0, 1.0, -3.0, 0.0, 3.0, -1.0, 2.0, -2.0, 1.0, -3.0, 0.0, 3.0, -1.0, 2.0, -2.0],
+      [1.0, -3.0, 0.0, 3.0, -1.0, 2.0, -2.0, 1.0, -3.0, 0.0, 3.0, -1.0, 2.0, -2.0, 1.0, -3.0, 0.0, 3.0, -1.0, 2.0, -2.0, 1.0, -3.0, 0.0],
+      [3.0, -1.0, 2.0, -2.0, 1.0, -3.0, 0.0, 3.0, -1.0, 2.0, -2.0, 1.0, -3.0, 0.0, 3.0, -1.0, 2.0, -2.0, 1.0, -3.0, 0.0, 3.0, -1.0, 2.0]]> : tensor<4x24xf32>
+  %res = "mhlo.dot"(%lhs, %rhs) : (tensor<16x4xf32>, tensor<4x24xf32>) -> tensor<16x24xf32>
+  check.expect_almost_eq_const(%res, dense<[
+      [17.0, -14.0, -17.0, 22.0, -16.0, 23.0, -15.0, 17.0, -14.0, -17.0, 22.0, -16.0, 23.0, -15.0, 17.0, -14.0, -17.0, 22.0, -16.0, 23.0, -15.0, 17.0, -14.0, -17.0],
+      [-16.0, -10.0, 10.0, 9.0, 8.0, 7.0, -8.0, -16.0, -10.0, 10.0, 9.0, 8.0, 7.0, -8.0, -16.0, -10.0, 10.0, 9.0, 8.0, 7.0, -8.0, -16.0, -10.0, 10.0],
+      [-16.0, -6.0, 4.0, 7.0, 10.0, 13.0, -12.0, -16.0, -6.0, 4.0, 7.0, 10.0, 13.0, -12.0, -16.0, -6.0, 4.0, 7.0, 10.0, 13.0, -12.0, -16.0, -6.0, 4.0],
+      [6.0, 9.0, -2.0, -6.0, -10.0, -14.0, 17.0, 6.0, 9.0, -2.0, -6.0, -10.0, -14.0, 17.0, 6.0, 9.0, -2.0, -6.0, -10.0, -14.0, 17.0, 6.0, 9.0, -2.0],
+      [6.0, 13.0, -8.0, -8.0, -8.0, -8.0, 13.0, 6.0, 13.0, -8.0, -8.0, -8.0, -8.0, 13.0, 6.0, 13.0, -8.0, -8.0, -8.0, -8.0, 13.0, 6.0, 13.0, -8.0],
+      [6.0, 17.0, -14.0, -10.0, -6.0, -2.0, 9.0, 6.0, 17.0, -14.0, -10.0, -6.0, -2.0, 9.0, 6.0, 17.0, -14.0, -10.0, -6.0, -2.0, 9.0, 6.0, 17.0, -14.0],
+      [-16.0, -12.0, 13.0, 10.0, 7.0, 4.0, -6.0, -16.0, -12.0, 13.0, 10.0, 7.0, 4.0, -6.0, -16.0, -12.0, 13.0, 10.0, 7.0, 4.0, -6.0, -16.0, -12.0, 13.0],
+      [-16.0, -8.0, 7.0, 8.0, 9.0, 10.0, -10.0, -16.0, -8.0, 7.0, 8.0, 9.0, 10.0, -10.0, -16.0, -8.0, 7.0, 8.0, 9.0, 10.0, -10.0, -16.0, -8.0, 7.0],
+      [17.0, -15.0, 23.0, -16.0, 22.0, -17.0, -14.0, 17.0, -15.0, 23.0, -16.0, 22.0, -17.0, -14.0, 17.0, -15.0, 23.0, -16.0, 22.0, -17.0, -14.0, 17.0, -15.0, 23.0],
+      [6.0, 11.0, -5.0, -7.0, -9.0, -11.0, 15.0, 6.0, 11.0, -5.0, -7.0, -9.0, -11.0, 15.0, 6.0, 11.0, -5.0, -7.0, -9.0, -11.0, 15.0, 6.0, 11.0, -5.0],
+      [6.0, 15.0, -11.0, -9.0, -7.0, -5.0, 11.0, 6.0, 15.0, -11.0, -9.0, -7.0, -5.0, 11.0, 6.0, 15.0, -11.0, -9.0, -7.0, -5.0, 11.0, 6.0, 15.0, -11.0],
+      [17.0, -14.0, -17.0, 22.0, -16.0, 23.0, -15.0, 17.0, -14.0, -17.0, 22.0, -16.0, 23.0, -15.0, 17.0, -14.0, -17.0, 22.0, -16.0, 23.0, -15.0, 17.0, -14.0, -17.0],
+      [-16.0, -10.0, 10.0, 9.0, 8.0, 7.0, -8.0, -16.0, -10.0, 10.0, 9.0, 8.0, 7.0, -8.0, -16.0, -10.0, 10.0, 9.0, 8.0, 7.0, -8.0, -16.0, -10.0, 10.0],
+      [-16.0, -6.0, 4.0, 7.0, 10.0, 13.0, -12.0, -16.0, -6.0, 4.0, 7.0, 10.0, 13.0, -12.0, -16.0, -6.0, 4.0, 7.0, 10.0, 13.0, -12.0, -16.0, -6.0, 4.0],
+      [6.0, 9.0, -2.0, -6.0, -10.0, -14.0, 17.0, 6.0, 9.0, -2.0, -6.0, -10.0, -14.0, 17.0, 6.0, 9.0, -2.0, -6.0, -10.0, -14.0, 17.0, 6.0, 9.0, -2.0],
+      [6.0, 13.0, -8.0, -8.0, -8.0, -8.0, 13.0, 6.0, 13.0, -8.0, -8.0, -8.0, -8.0, 13.0, 6.0, 13.0, -8.0, -8.0, -8.0, -8.0, 13.0, 6.0, 13.0, -8.0]]> : tensor<16x24xf32>) : tensor<16x24xf32>
+  return
+}
@@ -174,18 +174,26 @@ static iree_status_t iree_vm_bytecode_function_enter(
 // Enters an internal bytecode stack frame from an external caller.
 // A new |out_callee_frame| will be pushed to the stack with storage space for
 // the registers used by the function and |arguments| will be marshaled into the
-// ABI-defined registers.
+// ABI-defined registers. |cconv_results| and |results| are stashed on the frame
+// so that the eventual return can marshal results even after a resume.
 //
 // Note that callers are expected to have matched our expectations for
 // |arguments| and we don't validate that here.
 static iree_status_t iree_vm_bytecode_external_enter(
     iree_vm_stack_t* stack, const iree_vm_function_t function,
     iree_string_view_t cconv_arguments, iree_byte_span_t arguments,
+    iree_string_view_t cconv_results, iree_byte_span_t results,
     iree_vm_stack_frame_t** out_callee_frame,
     iree_vm_registers_t* out_callee_registers) {
   // Enter the bytecode function and allocate registers.
   IREE_RETURN_IF_ERROR(iree_vm_bytecode_function_enter(
       stack, function, out_callee_frame, out_callee_registers));
+  iree_vm_bytecode_frame_storage_t* callee_storage =
+      (iree_vm_bytecode_frame_storage_t*)iree_vm_stack_frame_storage(
+          *out_callee_frame);
+  callee_storage->entry_frame_depth = (*out_callee_frame)->depth;
+  callee_storage->cconv_results = cconv_results;
+  callee_storage->results = results;
 
   // Marshal arguments from the ABI format to the VM registers.
   iree_vm_registers_t callee_registers = *out_callee_registers;
@@ -298,8 +306,18 @@ static iree_status_t iree_vm_bytecode_internal_enter(
   // This assumes that the destination stack frame registers are unused and ok
   // to overwrite directly. Each bank begins left-aligned at 0 and increments
   // per arg of its type.
+  // The caller storage must be requeried as the stack may have been
+  // reallocated when entering the callee.
+  iree_vm_stack_frame_t* caller_frame = iree_vm_stack_parent_frame(stack);
+  caller_storage =
+      (iree_vm_bytecode_frame_storage_t*)iree_vm_stack_frame_storage(
+          caller_frame);
+  iree_vm_bytecode_frame_storage_t* callee_storage =
+      (iree_vm_bytecode_frame_storage_t*)iree_vm_stack_frame_storage(
+          *out_callee_frame);
+  callee_storage->entry_frame_depth = caller_storage->entry_frame_depth;
   iree_vm_registers_t src_regs =
-      iree_vm_bytecode_get_register_storage(iree_vm_stack_parent_frame(stack));
+      iree_vm_bytecode_get_register_storage(caller_frame);
   iree_vm_registers_t* dst_regs = out_callee_registers;
   int i32_reg_offset = 0;
   int ref_reg_offset = 0;
@@ -473,15 +491,17 @@ static iree_status_t iree_vm_bytecode_issue_import_call(
   // Call external function.
   iree_status_t call_status = call.function.module->begin_call(
       call.function.module->self, stack, &call, out_result);
-  if (IREE_UNLIKELY(!iree_status_is_ok(call_status))) {
+  if (iree_status_is_deferred(call_status)) {
+    // Callee yielded; the caller rewinds and reissues the call on resume.
+    return call_status;
+  } else if (IREE_UNLIKELY(!iree_status_is_ok(call_status))) {
     // TODO(benvanik): set execution result to failure/capture stack.
     return iree_status_annotate(call_status,
                                 iree_make_cstring_view("while calling import"));
   }
 
-  // NOTE: we don't support yielding within imported functions right now so it's
-  // safe to assume the stack is still valid here. If the called function can
-  // yield then we'll need to requery all pointers here.
+  // NOTE: the stack may have been reallocated by the callee so we need to
+  // requery all pointers here.
   *out_caller_frame = iree_vm_stack_current_frame(stack);
   *out_caller_registers =
       iree_vm_bytecode_get_register_storage(*out_caller_frame);
@@ -607,6 +627,28 @@ static iree_status_t iree_vm_bytecode_call_import_variadic(
                                             out_caller_registers, out_result);
 }
 
+// Handles a non-OK |call_status| from an import call issued by the frame at
+// |caller_depth|. If the import deferred the caller is rewound to |call_pc| so
+// that the call is reissued (with freshly marshaled arguments) when resumed.
+static iree_status_t iree_vm_bytecode_suspend_import_call(
+    iree_vm_stack_t* stack, int32_t caller_depth,
+    iree_vm_source_offset_t call_pc, iree_status_t call_status) {
+  if (!iree_status_is_deferred(call_status)) return call_status;
+  // NOTE: the stack may have been reallocated by the callee.
+  iree_vm_stack_frame_t* caller_frame = iree_vm_stack_current_frame(stack);
+  if (IREE_UNLIKELY(!caller_frame || caller_frame->depth != caller_depth)) {
+    // The callee left its own frames on the stack (such as another bytecode
+    // module that yielded). We can't resume those as the ABI buffers used to
+    // call them live on the native stack of this dispatch.
+    iree_status_ignore(call_status);
+    return iree_make_status(IREE_STATUS_UNIMPLEMENTED,
+                            "yielding is only supported within a single "
+                            "bytecode module or at native import calls");
+  }
+  caller_frame->pc = call_pc;
+  return call_status;
+}
+
 //===----------------------------------------------------------------------===//
 // Main interpreter dispatch routine
 //===----------------------------------------------------------------------===//
@@ -621,14 +663,21 @@ iree_status_t iree_vm_bytecode_dispatch(
   // defining below.
   DEFINE_DISPATCH_TABLES();
 
-  // Enter function (as this is the initial call).
-  // The callee's return will take care of storing the output registers when it
-  // actually does return, either immediately or in the future via a resume.
   iree_vm_stack_frame_t* current_frame = NULL;
   iree_vm_registers_t regs;
-  IREE_RETURN_IF_ERROR(
-      iree_vm_bytecode_external_enter(stack, call->function, cconv_arguments,
-                                      call->arguments, &current_frame, &regs));
+  if (call) {
+    // Enter function (as this is the initial call).
+    // The callee's return will take care of storing the output registers when
+    // it actually does return, either immediately or in the future via a
+    // resume.
+    IREE_RETURN_IF_ERROR(iree_vm_bytecode_external_enter(
+        stack, call->function, cconv_arguments, call->arguments, cconv_results,
+        call->results, &current_frame, &regs));
+  } else {
+    // Resume the top-most frame where it left off when it yielded.
+    current_frame = iree_vm_stack_current_frame(stack);
+    regs = iree_vm_bytecode_get_register_storage(current_frame);
+  }
 
   // Primary dispatch state. This is our 'native stack frame' and really
   // just enough to make dereferencing common addresses (like the current
@@ -644,7 +693,10 @@ iree_status_t iree_vm_bytecode_dispatch(
       module->function_descriptor_table[current_frame->function.ordinal]
           .bytecode_offset;
   iree_vm_source_offset_t pc = current_frame->pc;
-  const int32_t entry_frame_depth = current_frame->depth;
+  const int32_t entry_frame_depth =
+      ((const iree_vm_bytecode_frame_storage_t*)iree_vm_stack_frame_storage(
+           current_frame))
+          ->entry_frame_depth;
 
   BEGIN_DISPATCH_CORE() {
     //===------------------------------------------------------------------===//
@@ -1393,6 +1445,7 @@ iree_status_t iree_vm_bytecode_dispatch(
     });
 
     DISPATCH_OP(CORE, Call, {
+      const iree_vm_source_offset_t call_pc = pc - 1;
       int32_t function_ordinal = VM_DecFuncAttr("callee");
       const iree_vm_register_list_t* src_reg_list =
           VM_DecVariadicOperands("operands");
@@ -1405,9 +1458,14 @@ iree_status_t iree_vm_bytecode_dispatch(
       int is_import = (function_ordinal & 0x80000000u) != 0;
       if (is_import) {
         // Call import (and possible yield).
-        IREE_RETURN_IF_ERROR(iree_vm_bytecode_call_import(
+        const int32_t caller_depth = current_frame->depth;
+        iree_status_t call_status = iree_vm_bytecode_call_import(
             stack, module_state, function_ordinal, regs, src_reg_list,
-            dst_reg_list, &current_frame, &regs, out_result));
+            dst_reg_list, &current_frame, &regs, out_result);
+        if (IREE_UNLIKELY(!iree_status_is_ok(call_status))) {
+          return iree_vm_bytecode_suspend_import_call(stack, caller_depth,
+                                                      call_pc, call_status);
+        }
       } else {
         // Switch execution to the target function and continue running in the
         // bytecode dispatcher.
@@ -1424,6 +1482,7 @@ iree_status_t iree_vm_bytecode_dispatch(
     DISPATCH_OP(CORE, CallVariadic, {
       // TODO(benvanik): dedupe with above or merge and always have the seg size
       // list be present (but empty) for non-variadic calls.
+      const iree_vm_source_offset_t call_pc = pc - 1;
       int32_t function_ordinal = VM_DecFuncAttr("callee");
       const iree_vm_register_list_t* segment_size_list =
           VM_DecVariadicOperands("segment_sizes");
@@ -1444,9 +1503,14 @@ iree_status_t iree_vm_bytecode_dispatch(
       }
 
       // Call import (and possible yield).
-      IREE_RETURN_IF_ERROR(iree_vm_bytecode_call_import_variadic(
+      const int32_t caller_depth = current_frame->depth;
+      iree_status_t call_status = iree_vm_bytecode_call_import_variadic(
           stack, module_state, function_ordinal, regs, segment_size_list,
-          src_reg_list, dst_reg_list, &current_frame, &regs, out_result));
+          src_reg_list, dst_reg_list, &current_frame, &regs, out_result);
+      if (IREE_UNLIKELY(!iree_status_is_ok(call_status))) {
+        return iree_vm_bytecode_suspend_import_call(stack, caller_depth,
+                                                    call_pc, call_status);
+      }
     });
 
     DISPATCH_OP(CORE, Return, {
@@ -1456,9 +1520,12 @@ iree_status_t iree_vm_bytecode_dispatch(
 
       if (current_frame->depth <= entry_frame_depth) {
         // Return from the top-level entry frame - return back to call().
-        return iree_vm_bytecode_external_leave(stack, current_frame, &regs,
-                                               src_reg_list, cconv_results,
-                                               call->results);
+        const iree_vm_bytecode_frame_storage_t* entry_storage =
+            (const iree_vm_bytecode_frame_storage_t*)
+                iree_vm_stack_frame_storage(current_frame);
+        return iree_vm_bytecode_external_leave(
+            stack, current_frame, &regs, src_reg_list,
+            entry_storage->cconv_results, entry_storage->results);
       }
 
       // Store results into the caller frame and pop back to the parent.
@@ -1488,8 +1555,11 @@ iree_status_t iree_vm_bytecode_dispatch(
     //===------------------------------------------------------------------===//
 
     DISPATCH_OP(CORE, Yield, {
-      // TODO(benvanik): yield with execution results.
-      return iree_ok_status();
+      // Suspend with all frames left on the stack; resuming continues with the
+      // op following the yield.
+      current_frame->pc = pc;
+      out_result->yield_reason = IREE_VM_YIELD_REASON_YIELD;
+      return iree_status_from_code(IREE_STATUS_DEFERRED);
     });
 
     //===------------------------------------------------------------------===//
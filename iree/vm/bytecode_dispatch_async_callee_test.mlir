@@ -0,0 +1,10 @@
+vm.module @async_callee {
+  // Yields once before returning %arg0 + 1.
+  vm.export @yield_add_1
+  vm.func @yield_add_1(%arg0 : i32) -> i32 {
+    vm.yield
+    %c1 = vm.const.i32 1 : i32
+    %0 = vm.add.i32 %arg0, %c1 : i32
+    vm.return %0 : i32
+  }
+}
@@ -0,0 +1,506 @@
+// Copyright 2021 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+// Tests covering yielding and resuming bytecode execution.
+//
+// bytecode_dispatch_async_test.mlir contains the functions used here for
+// testing and imports from bytecode_dispatch_async_callee_test.mlir and the
+// native_async module defined below.
+
+#include <array>
+#include <cstring>
+
+#include "iree/base/api.h"
+#include "iree/base/logging.h"
+#include "iree/testing/gtest.h"
+#include "iree/testing/status_matchers.h"
+#include "iree/vm/api.h"
+#include "iree/vm/bytecode_dispatch_async_callee_test_module_c.h"
+#include "iree/vm/bytecode_dispatch_async_test_module_c.h"
+#include "iree/vm/bytecode_module.h"
+
+namespace {
+
+//===----------------------------------------------------------------------===//
+// native_async
+//===----------------------------------------------------------------------===//
+// A native module with a function that defers until the wait it reports has
+// been performed. Each attempt and each wait is counted in the per-context
+// state so that tests can verify calls are reissued on resume.
+
+typedef struct native_async_state_t {
+  iree_allocator_t allocator;
+  // Number of times defer_add_1 was called, including deferred attempts.
+  int32_t attempt_count;
+  // Number of times the wait reported by defer_add_1 was performed.
+  int32_t wait_count;
+  // Set by the wait and consumed by the next defer_add_1 attempt.
+  bool ready;
+} native_async_state_t;
+
+static iree_status_t IREE_API_PTR
+native_async_alloc_state(void* self, iree_allocator_t allocator,
+                         iree_vm_module_state_t** out_module_state) {
+  native_async_state_t* state = NULL;
+  IREE_RETURN_IF_ERROR(
+      iree_allocator_malloc(allocator, sizeof(*state), (void**)&state));
+  memset(state, 0, sizeof(*state));
+  state->allocator = allocator;
+  *out_module_state = (iree_vm_module_state_t*)state;
+  return iree_ok_status();
+}
+
+static void IREE_API_PTR
+native_async_free_state(void* self, iree_vm_module_state_t* module_state) {
+  native_async_state_t* state = (native_async_state_t*)module_state;
+  iree_allocator_free(state->allocator, state);
+}
+
+// Wait function reported in the execution result when defer_add_1 defers.
+static iree_status_t IREE_API_PTR native_async_wait(void* object,
+                                                    uint64_t value,
+                                                    iree_timeout_t timeout) {
+  native_async_state_t* state = (native_async_state_t*)object;
+  ++state->wait_count;
+  state->ready = true;
+  return iree_ok_status();
+}
+
+// vm.import @native_async.attempt_count() -> i32
+static iree_status_t native_async_attempt_count(
+    iree_vm_stack_t* stack, const iree_vm_function_call_t* call,
+    iree_vm_native_function_target_t target_fn, void* module,
+    void* module_state, iree_vm_execution_result_t* out_result) {
+  native_async_state_t* state = (native_async_state_t*)module_state;
+  *reinterpret_cast<int32_t*>(call->results.data) = state->attempt_count;
+  return iree_ok_status();
+}
+
+// vm.import @native_async.defer_add_1(%arg0 : i32) -> i32
+//
+// Defers with an await on the module state unless a wait has been performed
+// since the last attempt. Deferring has no side effects on the results.
+static iree_status_t native_async_defer_add_1(
+    iree_vm_stack_t* stack, const iree_vm_function_call_t* call,
+    iree_vm_native_function_target_t target_fn, void* module,
+    void* module_state, iree_vm_execution_result_t* out_result) {
+  native_async_state_t* state = (native_async_state_t*)module_state;
+  ++state->attempt_count;
+  if (!state->ready) {
+    out_result->yield_reason = IREE_VM_YIELD_REASON_AWAIT;
+    out_result->wait.object = state;
+    out_result->wait.value = 1;
+    out_result->wait.wait_fn = native_async_wait;
+    return iree_status_from_code(IREE_STATUS_DEFERRED);
+  }
+  state->ready = false;
+  int32_t arg0 = *reinterpret_cast<int32_t*>(call->arguments.data);
+  *reinterpret_cast<int32_t*>(call->results.data) = arg0 + 1;
+  return iree_ok_status();
+}
+
+// vm.import @native_async.defer_use_buffer(%arg0 : !vm.buffer)
+//
+// Defers like defer_add_1 and otherwise only borrows the buffer reference.
+static iree_status_t native_async_defer_use_buffer(
+    iree_vm_stack_t* stack, const iree_vm_function_call_t* call,
+    iree_vm_native_function_target_t target_fn, void* module,
+    void* module_state, iree_vm_execution_result_t* out_result) {
+  native_async_state_t* state = (native_async_state_t*)module_state;
+  ++state->attempt_count;
+  if (!state->ready) {
+    out_result->yield_reason = IREE_VM_YIELD_REASON_AWAIT;
+    out_result->wait.object = state;
+    out_result->wait.value = 1;
+    out_result->wait.wait_fn = native_async_wait;
+    return iree_status_from_code(IREE_STATUS_DEFERRED);
+  }
+  state->ready = false;
+  iree_vm_buffer_t* buffer = nullptr;
+  return iree_vm_buffer_check_deref(
+      *reinterpret_cast<iree_vm_ref_t*>(call->arguments.data), &buffer);
+}
+
+// vm.import @native_async.wait_count() -> i32
+static iree_status_t native_async_wait_count(
+    iree_vm_stack_t* stack, const iree_vm_function_call_t* call,
+    iree_vm_native_function_target_t target_fn, void* module,
+    void* module_state, iree_vm_execution_result_t* out_result) {
+  native_async_state_t* state = (native_async_state_t*)module_state;
+  *reinterpret_cast<int32_t*>(call->results.data) = state->wait_count;
+  return iree_ok_status();
+}
+
+static const iree_vm_native_export_descriptor_t native_async_exports_[] = {
+    {iree_make_cstring_view("attempt_count"), iree_make_cstring_view("0v_i"),
+     0, NULL},
+    {iree_make_cstring_view("defer_add_1"), iree_make_cstring_view("0i_i"), 0,
+     NULL},
+    {iree_make_cstring_view("defer_use_buffer"), iree_make_cstring_view("0r_v"),
+     0, NULL},
+    {iree_make_cstring_view("wait_count"), iree_make_cstring_view("0v_i"), 0,
+     NULL},
+};
+static const iree_vm_native_function_ptr_t native_async_funcs_[] = {
+    {(iree_vm_native_function_shim_t)native_async_attempt_count, NULL},
+    {(iree_vm_native_function_shim_t)native_async_defer_add_1, NULL},
+    {(iree_vm_native_function_shim_t)native_async_defer_use_buffer, NULL},
+    {(iree_vm_native_function_shim_t)native_async_wait_count, NULL},
+};
+static_assert(IREE_ARRAYSIZE(native_async_funcs_) ==
+                  IREE_ARRAYSIZE(native_async_exports_),
+              "function pointer table must be 1:1 with exports");
+static const iree_vm_native_module_descriptor_t native_async_descriptor_ = {
+    iree_make_cstring_view("native_async"),
+    0,
+    NULL,
+    IREE_ARRAYSIZE(native_async_exports_),
+    native_async_exports_,
+    IREE_ARRAYSIZE(native_async_funcs_),
+    native_async_funcs_,
+    0,
+    NULL,
+};
+
+static iree_status_t native_async_create(iree_allocator_t allocator,
+                                         iree_vm_module_t** out_module) {
+  iree_vm_module_t interface;
+  IREE_RETURN_IF_ERROR(iree_vm_module_initialize(&interface, NULL));
+  interface.alloc_state = native_async_alloc_state;
+  interface.free_state = native_async_free_state;
+  return iree_vm_native_module_create(&interface, &native_async_descriptor_,
+                                      allocator, out_module);
+}
+
+//===----------------------------------------------------------------------===//
+// VMBytecodeDispatchAsyncTest
+//===----------------------------------------------------------------------===//
+
+static iree_vm_module_t* CreateBytecodeModule(
+    const struct iree_file_toc_t* module_file_toc) {
+  iree_vm_module_t* module = nullptr;
+  IREE_CHECK_OK(iree_vm_bytecode_module_create(
+      iree_const_byte_span_t{
+          reinterpret_cast<const uint8_t*>(module_file_toc->data),
+          module_file_toc->size},
+      iree_allocator_null(), iree_allocator_system(), &module));
+  return module;
+}
+
+class VMBytecodeDispatchAsyncTest : public ::testing::Test {
+ protected:
+  virtual void SetUp() {
+    IREE_CHECK_OK(iree_vm_register_builtin_types());
+    IREE_CHECK_OK(iree_vm_instance_create(iree_allocator_system(), &instance_));
+
+    iree_vm_module_t* native_module = nullptr;
+    IREE_CHECK_OK(
+        native_async_create(iree_allocator_system(), &native_module));
+    iree_vm_module_t* callee_module = CreateBytecodeModule(
+        iree_vm_bytecode_dispatch_async_callee_test_module_create());
+    iree_vm_module_t* test_module = CreateBytecodeModule(
+        iree_vm_bytecode_dispatch_async_test_module_create());
+
+    std::array<iree_vm_module_t*, 3> modules = {native_module, callee_module,
+                                                test_module};
+    IREE_CHECK_OK(iree_vm_context_create_with_modules(
+        instance_, modules.data(), modules.size(), iree_allocator_system(),
+        &context_));
+
+    iree_vm_module_release(native_module);
+    iree_vm_module_release(callee_module);
+    iree_vm_module_release(test_module);
+  }
+
+  virtual void TearDown() {
+    iree_vm_context_release(context_);
+    iree_vm_instance_release(instance_);
+  }
+
+  iree_vm_function_t ResolveFunction(const char* function_name) {
+    iree_vm_function_t function;
+    IREE_CHECK_OK(iree_vm_context_resolve_function(
+        context_, iree_make_cstring_view(function_name), &function));
+    return function;
+  }
+
+  // Creates an invocation of |function_name| with a single i32 argument.
+  // The invocation runs until it completes or first yields.
+  iree_vm_invocation_t* CreateInvocation(const char* function_name,
+                                         int32_t arg0) {
+    iree_vm_list_t* inputs = nullptr;
+    IREE_CHECK_OK(iree_vm_list_create(/*element_type=*/nullptr, 1,
+                                      iree_allocator_system(), &inputs));
+    iree_vm_value_t arg0_value = iree_vm_value_make_i32(arg0);
+    IREE_CHECK_OK(iree_vm_list_push_value(inputs, &arg0_value));
+    iree_vm_invocation_t* invocation = nullptr;
+    IREE_CHECK_OK(iree_vm_invocation_create(
+        context_, ResolveFunction(function_name), /*policy=*/nullptr, inputs,
+        iree_allocator_system(), &invocation));
+    iree_vm_list_release(inputs);
+    return invocation;
+  }
+
+  // Creates an invocation of native_async.defer_use_buffer with a buffer
+  // allocated from |buffer_allocator| that is only referenced by the
+  // invocation. The invocation defers until its wait is performed.
+  iree_vm_invocation_t* CreateBufferInvocation(
+      iree_allocator_t buffer_allocator) {
+    iree_vm_buffer_t* buffer = nullptr;
+    IREE_CHECK_OK(iree_vm_buffer_create(
+        IREE_VM_BUFFER_ACCESS_MUTABLE | IREE_VM_BUFFER_ACCESS_ORIGIN_HOST, 16,
+        buffer_allocator, &buffer));
+    iree_vm_list_t* inputs = nullptr;
+    IREE_CHECK_OK(iree_vm_list_create(/*element_type=*/nullptr, 1,
+                                      iree_allocator_system(), &inputs));
+    iree_vm_ref_t buffer_ref = iree_vm_buffer_move_ref(buffer);
+    IREE_CHECK_OK(iree_vm_list_push_ref_move(inputs, &buffer_ref));
+    iree_vm_invocation_t* invocation = nullptr;
+    IREE_CHECK_OK(iree_vm_invocation_create(
+        context_, ResolveFunction("native_async.defer_use_buffer"),
+        /*policy=*/nullptr, inputs, iree_allocator_system(), &invocation));
+    iree_vm_list_release(inputs);
+    return invocation;
+  }
+
+  // Returns an allocator that counts frees in |free_count|.
+  static iree_allocator_t CountingAllocator(int* free_count) {
+    iree_allocator_t allocator = {
+        /*.self=*/free_count,
+        /*.alloc=*/iree_allocator_system_allocate,
+        /*.free=*/
+        +[](void* self, void* ptr) {
+          ++*(int*)self;
+          iree_allocator_system_free(nullptr, ptr);
+        },
+    };
+    return allocator;
+  }
+
+  // Returns the i32 result of a completed |invocation|.
+  int32_t GetInvocationResult(iree_vm_invocation_t* invocation) {
+    const iree_vm_list_t* outputs = iree_vm_invocation_output(invocation);
+    IREE_CHECK(outputs);
+    iree_vm_value_t ret0_value;
+    IREE_CHECK_OK(iree_vm_list_get_value(outputs, 0, &ret0_value));
+    return ret0_value.i32;
+  }
+
+  // Synchronously invokes a native_async counter function.
+  int32_t QueryNativeCounter(const char* function_name) {
+    iree_vm_list_t* outputs = nullptr;
+    IREE_CHECK_OK(iree_vm_list_create(/*element_type=*/nullptr, 1,
+                                      iree_allocator_system(), &outputs));
+    IREE_CHECK_OK(iree_vm_invoke(context_, ResolveFunction(function_name),
+                                 /*policy=*/nullptr, /*inputs=*/nullptr,
+                                 outputs, iree_allocator_system()));
+    iree_vm_value_t ret0_value;
+    IREE_CHECK_OK(iree_vm_list_get_value(outputs, 0, &ret0_value));
+    iree_vm_list_release(outputs);
+    return ret0_value.i32;
+  }
+
+  iree_vm_instance_t* instance_ = nullptr;
+  iree_vm_context_t* context_ = nullptr;
+};
+
+// Tests that vm.yield suspends the invocation and that each resume continues
+// from the op following the yield with registers intact.
+TEST_F(VMBytecodeDispatchAsyncTest, YieldAndResume) {
+  iree_vm_invocation_t* invocation =
+      CreateInvocation("async_test.yield_sequence", 100);
+  IREE_EXPECT_STATUS_IS(IREE_STATUS_DEFERRED,
+                        iree_vm_invocation_query_status(invocation));
+  EXPECT_EQ(IREE_VM_YIELD_REASON_YIELD,
+            iree_vm_invocation_execution_result(invocation)->yield_reason);
+  EXPECT_EQ(nullptr, iree_vm_invocation_output(invocation));
+
+  IREE_EXPECT_STATUS_IS(IREE_STATUS_DEFERRED,
+                        iree_vm_invocation_resume(invocation));
+  IREE_EXPECT_OK(iree_vm_invocation_resume(invocation));
+  EXPECT_EQ(103, GetInvocationResult(invocation));
+
+  // Resuming a completed invocation is a no-op.
+  IREE_EXPECT_OK(iree_vm_invocation_resume(invocation));
+  EXPECT_EQ(103, GetInvocationResult(invocation));
+
+  iree_vm_invocation_release(invocation);
+}
+
+// Tests yielding from an internal callee frame; the resumed callee must return
+// into its suspended caller.
+TEST_F(VMBytecodeDispatchAsyncTest, YieldFromInternalCall) {
+  iree_vm_invocation_t* invocation =
+      CreateInvocation("async_test.call_yield_internal", 100);
+  IREE_EXPECT_STATUS_IS(IREE_STATUS_DEFERRED,
+                        iree_vm_invocation_query_status(invocation));
+  IREE_EXPECT_STATUS_IS(IREE_STATUS_DEFERRED,
+                        iree_vm_invocation_resume(invocation));
+  IREE_EXPECT_OK(iree_vm_invocation_resume(invocation));
+  EXPECT_EQ(102, GetInvocationResult(invocation));
+  iree_vm_invocation_release(invocation);
+}
+
+// Tests that iree_vm_invocation_await resumes across yields to completion.
+TEST_F(VMBytecodeDispatchAsyncTest, AwaitYields) {
+  iree_vm_invocation_t* invocation =
+      CreateInvocation("async_test.yield_sequence", 5);
+  IREE_EXPECT_OK(
+      iree_vm_invocation_await(invocation, IREE_TIME_INFINITE_FUTURE));
+  EXPECT_EQ(8, GetInvocationResult(invocation));
+  iree_vm_invocation_release(invocation);
+}
+
+// Tests that the synchronous iree_vm_invoke runs yielding functions to
+// completion.
+TEST_F(VMBytecodeDispatchAsyncTest, InvokeRunsThroughYields) {
+  iree_vm_list_t* inputs = nullptr;
+  IREE_ASSERT_OK(iree_vm_list_create(/*element_type=*/nullptr, 1,
+                                     iree_allocator_system(), &inputs));
+  iree_vm_value_t arg0_value = iree_vm_value_make_i32(1);
+  IREE_ASSERT_OK(iree_vm_list_push_value(inputs, &arg0_value));
+  iree_vm_list_t* outputs = nullptr;
+  IREE_ASSERT_OK(iree_vm_list_create(/*element_type=*/nullptr, 1,
+                                     iree_allocator_system(), &outputs));
+
+  IREE_ASSERT_OK(iree_vm_invoke(
+      context_, ResolveFunction("async_test.call_deferred_import"),
+      /*policy=*/nullptr, inputs, outputs, iree_allocator_system()));
+  iree_vm_value_t ret0_value;
+  IREE_ASSERT_OK(iree_vm_list_get_value(outputs, 0, &ret0_value));
+  EXPECT_EQ(3, ret0_value.i32);
+  EXPECT_EQ(2, QueryNativeCounter("native_async.wait_count"));
+
+  iree_vm_list_release(inputs);
+  iree_vm_list_release(outputs);
+}
+
+// Tests that a native import returning IREE_STATUS_DEFERRED suspends the
+// bytecode caller with the wait it reported and is reissued with the same
+// arguments on resume.
+TEST_F(VMBytecodeDispatchAsyncTest, DeferredImportIsReissued) {
+  iree_vm_invocation_t* invocation =
+      CreateInvocation("async_test.call_deferred_import", 10);
+  IREE_EXPECT_STATUS_IS(IREE_STATUS_DEFERRED,
+                        iree_vm_invocation_query_status(invocation));
+  const iree_vm_execution_result_t* result =
+      iree_vm_invocation_execution_result(invocation);
+  EXPECT_EQ(IREE_VM_YIELD_REASON_AWAIT, result->yield_reason);
+  EXPECT_EQ(1u, result->wait.value);
+  EXPECT_NE(nullptr, result->wait.wait_fn);
+  EXPECT_EQ(1, QueryNativeCounter("native_async.attempt_count"));
+
+  // Resuming before the wait is satisfied reissues the import, which defers
+  // again without making progress.
+  IREE_EXPECT_STATUS_IS(IREE_STATUS_DEFERRED,
+                        iree_vm_invocation_resume(invocation));
+  EXPECT_EQ(2, QueryNativeCounter("native_async.attempt_count"));
+
+  // Satisfy the wait; the reissued first import completes and the second
+  // import defers.
+  IREE_EXPECT_OK(iree_vm_execution_result_wait(
+      iree_vm_invocation_execution_result(invocation), iree_infinite_timeout()));
+  IREE_EXPECT_STATUS_IS(IREE_STATUS_DEFERRED,
+                        iree_vm_invocation_resume(invocation));
+  EXPECT_EQ(4, QueryNativeCounter("native_async.attempt_count"));
+
+  IREE_EXPECT_OK(
+      iree_vm_invocation_await(invocation, IREE_TIME_INFINITE_FUTURE));
+  EXPECT_EQ(12, GetInvocationResult(invocation));
+  EXPECT_EQ(5, QueryNativeCounter("native_async.attempt_count"));
+  EXPECT_EQ(2, QueryNativeCounter("native_async.wait_count"));
+
+  iree_vm_invocation_release(invocation);
+}
+
+// Tests that aborting a suspended invocation discards its stack and outputs.
+TEST_F(VMBytecodeDispatchAsyncTest, AbortSuspended) {
+  iree_vm_invocation_t* invocation =
+      CreateInvocation("async_test.call_yield_internal", 1);
+  IREE_EXPECT_STATUS_IS(IREE_STATUS_DEFERRED,
+                        iree_vm_invocation_query_status(invocation));
+
+  IREE_EXPECT_OK(iree_vm_invocation_abort(invocation));
+  IREE_EXPECT_STATUS_IS(IREE_STATUS_ABORTED,
+                        iree_vm_invocation_query_status(invocation));
+  EXPECT_EQ(nullptr, iree_vm_invocation_output(invocation));
+
+  // Resuming and awaiting an aborted invocation report the abort.
+  IREE_EXPECT_STATUS_IS(IREE_STATUS_ABORTED,
+                        iree_vm_invocation_resume(invocation));
+  IREE_EXPECT_STATUS_IS(
+      IREE_STATUS_ABORTED,
+      iree_vm_invocation_await(invocation, IREE_TIME_INFINITE_FUTURE));
+
+  // Aborting a completed invocation is a no-op.
+  IREE_EXPECT_OK(iree_vm_invocation_abort(invocation));
+  iree_vm_invocation_release(invocation);
+}
+
+// Tests that releasing a suspended invocation aborts it cleanly.
+TEST_F(VMBytecodeDispatchAsyncTest, ReleaseSuspended) {
+  iree_vm_invocation_t* invocation =
+      CreateInvocation("async_test.call_deferred_import", 1);
+  IREE_EXPECT_STATUS_IS(IREE_STATUS_DEFERRED,
+                        iree_vm_invocation_query_status(invocation));
+  iree_vm_invocation_release(invocation);
+
+  // The context remains usable after the suspended stack was discarded.
+  EXPECT_EQ(1, QueryNativeCounter("native_async.attempt_count"));
+}
+
+// Tests that the ref arguments borrowed by a native callee without results are
+// released when the invocation completes.
+TEST_F(VMBytecodeDispatchAsyncTest, RefArgumentsWithVoidResultsCompleted) {
+  int free_count = 0;
+  iree_vm_invocation_t* invocation =
+      CreateBufferInvocation(CountingAllocator(&free_count));
+  IREE_EXPECT_STATUS_IS(IREE_STATUS_DEFERRED,
+                        iree_vm_invocation_query_status(invocation));
+  IREE_EXPECT_OK(
+      iree_vm_invocation_await(invocation, IREE_TIME_INFINITE_FUTURE));
+  EXPECT_EQ(0, iree_vm_list_size(iree_vm_invocation_output(invocation)));
+  EXPECT_EQ(1, free_count);
+  iree_vm_invocation_release(invocation);
+  EXPECT_EQ(1, free_count);
+}
+
+// Tests that the ref arguments of a suspended callee without results are
+// released when the invocation is aborted.
+TEST_F(VMBytecodeDispatchAsyncTest, RefArgumentsWithVoidResultsAborted) {
+  int free_count = 0;
+  iree_vm_invocation_t* invocation =
+      CreateBufferInvocation(CountingAllocator(&free_count));
+  IREE_EXPECT_STATUS_IS(IREE_STATUS_DEFERRED,
+                        iree_vm_invocation_query_status(invocation));
+  EXPECT_EQ(0, free_count);
+  IREE_EXPECT_OK(iree_vm_invocation_abort(invocation));
+  EXPECT_EQ(1, free_count);
+  iree_vm_invocation_release(invocation);
+  EXPECT_EQ(1, free_count);
+}
+
+// Tests that a bytecode module yielding while called from another bytecode
+// module is rejected instead of resuming with dangling ABI buffers.
+TEST_F(VMBytecodeDispatchAsyncTest, CrossModuleYieldUnimplemented) {
+  // The callee can yield when called directly.
+  iree_vm_invocation_t* direct_invocation =
+      CreateInvocation("async_callee.yield_add_1", 1);
+  IREE_EXPECT_OK(
+      iree_vm_invocation_await(direct_invocation, IREE_TIME_INFINITE_FUTURE));
+  EXPECT_EQ(2, GetInvocationResult(direct_invocation));
+  iree_vm_invocation_release(direct_invocation);
+
+  iree_vm_invocation_t* invocation =
+      CreateInvocation("async_test.call_yielding_bytecode_import", 1);
+  iree_status_t status = iree_vm_invocation_query_status(invocation);
+  IREE_EXPECT_STATUS_IS(IREE_STATUS_UNIMPLEMENTED, status);
+  iree_status_free(status);
+  EXPECT_EQ(nullptr, iree_vm_invocation_output(invocation));
+  iree_vm_invocation_release(invocation);
+}
+
+}  // namespace
@@ -0,0 +1,50 @@
+vm.module @async_test {
+  // Imported from the native module defined in bytecode_dispatch_async_test.cc
+  // that defers until its wait has been satisfied.
+  vm.import @native_async.defer_add_1(%arg : i32) -> i32
+
+  // Imported from bytecode_dispatch_async_callee_test.mlir.
+  vm.import @async_callee.yield_add_1(%arg : i32) -> i32
+
+  // Yields twice with state live across both yields.
+  vm.export @yield_sequence
+  vm.func @yield_sequence(%arg0 : i32) -> i32 {
+    %c1 = vm.const.i32 1 : i32
+    %0 = vm.add.i32 %arg0, %c1 : i32
+    vm.yield
+    %1 = vm.add.i32 %0, %c1 : i32
+    vm.yield
+    %2 = vm.add.i32 %1, %c1 : i32
+    vm.return %2 : i32
+  }
+
+  // Yields from an internal callee so that resuming has to continue a frame
+  // that is not the entry frame and then return into the caller.
+  vm.func @yield_add_1(%arg0 : i32) -> i32 attributes {noinline} {
+    vm.yield
+    %c1 = vm.const.i32 1 : i32
+    %0 = vm.add.i32 %arg0, %c1 : i32
+    vm.return %0 : i32
+  }
+  vm.export @call_yield_internal
+  vm.func @call_yield_internal(%arg0 : i32) -> i32 {
+    %0 = vm.call @yield_add_1(%arg0) : (i32) -> i32
+    %1 = vm.call @yield_add_1(%0) : (i32) -> i32
+    vm.return %1 : i32
+  }
+
+  // Calls a native import that defers; the call is reissued on resume.
+  vm.export @call_deferred_import
+  vm.func @call_deferred_import(%arg0 : i32) -> i32 {
+    %0 = vm.call @native_async.defer_add_1(%arg0) : (i32) -> i32
+    %1 = vm.call @native_async.defer_add_1(%0) : (i32) -> i32
+    vm.return %1 : i32
+  }
+
+  // Calls a bytecode function in another module that yields; not supported.
+  vm.export @call_yielding_bytecode_import
+  vm.func @call_yielding_bytecode_import(%arg0 : i32) -> i32 {
+    %0 = vm.call @async_callee.yield_add_1(%arg0) : (i32) -> i32
+    vm.return %0 : i32
+  }
+}
@@ -90,6 +90,16 @@ typedef struct iree_vm_bytecode_frame_storage_t {
   // Relative byte offsets from the head of this struct.
   iree_host_size_t i32_register_offset;
   iree_host_size_t ref_register_offset;
+
+  // Depth of the frame that entered the module from an external caller. All
+  // frames called from it share the same value so that a resumed dispatch can
+  // tell when it is returning back to the external caller.
+  int32_t entry_frame_depth;
+
+  // Result calling convention and storage of the external caller. Only valid
+  // on the entry frame. The storage is required to remain valid across yields.
+  iree_string_view_t cconv_results;
+  iree_byte_span_t results;
 } iree_vm_bytecode_frame_storage_t;
 
 // Interleaved src-dst register sets for branch register remapping.
@@ -16,13 +16,152 @@
 #include "iree/vm/bytecode_module_impl.h"
 
 // Perform an strcmp between a flatbuffers string and an IREE string view.
-static bool iree_vm_flatbuffer_strcmp(flatbuffers_string_t lhs,
-                                      iree_string_view_t rhs) {
+static int iree_vm_flatbuffer_strcmp(flatbuffers_string_t lhs,
+                                     iree_string_view_t rhs) {
   size_t lhs_size = flatbuffers_string_len(lhs);
   int x = strncmp(lhs, rhs.data, lhs_size < rhs.size ? lhs_size : rhs.size);
   return x != 0 ? x : lhs_size < rhs.size ? -1 : lhs_size > rhs.size;
 }
 
+// Returns the number of functions in the table for |linkage|.
+static size_t iree_vm_bytecode_module_function_count(
+    iree_vm_BytecodeModuleDef_table_t module_def,
+    iree_vm_function_linkage_t linkage) {
+  switch (linkage) {
+    case IREE_VM_FUNCTION_LINKAGE_IMPORT:
+      return iree_vm_ImportFunctionDef_vec_len(
+          iree_vm_BytecodeModuleDef_imported_functions(module_def));
+    case IREE_VM_FUNCTION_LINKAGE_EXPORT:
+      return iree_vm_ExportFunctionDef_vec_len(
+          iree_vm_BytecodeModuleDef_exported_functions(module_def));
+    default:
+      return iree_vm_InternalFunctionDef_vec_len(
+          iree_vm_BytecodeModuleDef_internal_functions(module_def));
+  }
+}
+
+// Returns the name of the function at |ordinal| in the table for |linkage|.
+// The |ordinal| must be in range of the table.
+static flatbuffers_string_t iree_vm_bytecode_module_function_name(
+    iree_vm_BytecodeModuleDef_table_t module_def,
+    iree_vm_function_linkage_t linkage, size_t ordinal) {
+  switch (linkage) {
+    case IREE_VM_FUNCTION_LINKAGE_IMPORT:
+      return iree_vm_ImportFunctionDef_full_name(
+          iree_vm_ImportFunctionDef_vec_at(
+              iree_vm_BytecodeModuleDef_imported_functions(module_def),
+              ordinal));
+    case IREE_VM_FUNCTION_LINKAGE_EXPORT:
+      return iree_vm_ExportFunctionDef_local_name(
+          iree_vm_ExportFunctionDef_vec_at(
+              iree_vm_BytecodeModuleDef_exported_functions(module_def),
+              ordinal));
+    default:
+      return iree_vm_InternalFunctionDef_local_name(
+          iree_vm_InternalFunctionDef_vec_at(
+              iree_vm_BytecodeModuleDef_internal_functions(module_def),
+              ordinal));
+  }
+}
+
+// Returns the optional index of ordinals sorted by name for the function table
+// of |linkage| or NULL if the module was compiled without one.
+static flatbuffers_int32_vec_t iree_vm_bytecode_module_function_name_index(
+    iree_vm_BytecodeModuleDef_table_t module_def,
+    iree_vm_function_linkage_t linkage) {
+  switch (linkage) {
+    case IREE_VM_FUNCTION_LINKAGE_IMPORT:
+      return iree_vm_BytecodeModuleDef_imported_function_name_index(
+          module_def);
+    case IREE_VM_FUNCTION_LINKAGE_EXPORT:
+      return iree_vm_BytecodeModuleDef_exported_function_name_index(
+          module_def);
+    default:
+      return iree_vm_BytecodeModuleDef_internal_function_name_index(
+          module_def);
+  }
+}
+
+// Finds the ordinal of the function named |name| in the table for |linkage|.
+// Binary searches the name index when the module has one and otherwise scans
+// the table. Returns false if no function with the given name exists.
+static bool iree_vm_bytecode_module_find_function_ordinal(
+    iree_vm_BytecodeModuleDef_table_t module_def,
+    iree_vm_function_linkage_t linkage, iree_string_view_t name,
+    size_t* out_ordinal) {
+  flatbuffers_int32_vec_t name_index =
+      iree_vm_bytecode_module_function_name_index(module_def, linkage);
+  if (name_index) {
+    size_t low = 0;
+    size_t high = flatbuffers_int32_vec_len(name_index);
+    while (low < high) {
+      size_t mid = low + (high - low) / 2;
+      size_t ordinal = (size_t)flatbuffers_int32_vec_at(name_index, mid);
+      int cmp = iree_vm_flatbuffer_strcmp(
+          iree_vm_bytecode_module_function_name(module_def, linkage, ordinal),
+          name);
+      if (cmp == 0) {
+        *out_ordinal = ordinal;
+        return true;
+      } else if (cmp < 0) {
+        low = mid + 1;
+      } else {
+        high = mid;
+      }
+    }
+    return false;
+  }
+
+  size_t count = iree_vm_bytecode_module_function_count(module_def, linkage);
+  for (size_t ordinal = 0; ordinal < count; ++ordinal) {
+    if (iree_vm_flatbuffer_strcmp(iree_vm_bytecode_module_function_name(
+                                      module_def, linkage, ordinal),
+                                  name) == 0) {
+      *out_ordinal = ordinal;
+      return true;
+    }
+  }
+  return false;
+}
+
+// Verifies that the optional name index for the function table of |linkage|
+// has one in-range ordinal per function ordered by function name.
+static iree_status_t iree_vm_bytecode_module_function_name_index_verify(
+    iree_vm_BytecodeModuleDef_table_t module_def,
+    iree_vm_function_linkage_t linkage, const char* table_name) {
+  flatbuffers_int32_vec_t name_index =
+      iree_vm_bytecode_module_function_name_index(module_def, linkage);
+  if (!name_index) return iree_ok_status();
+  size_t count = iree_vm_bytecode_module_function_count(module_def, linkage);
+  if (flatbuffers_int32_vec_len(name_index) != count) {
+    return iree_make_status(
+        IREE_STATUS_INVALID_ARGUMENT,
+        "%s name index has %zu entries but the table has %zu functions",
+        table_name, flatbuffers_int32_vec_len(name_index), count);
+  }
+  flatbuffers_string_t previous_name = NULL;
+  for (size_t i = 0; i < count; ++i) {
+    int32_t ordinal = flatbuffers_int32_vec_at(name_index, i);
+    if (ordinal < 0 || (size_t)ordinal >= count) {
+      return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                              "%s name index[%zu] ordinal %d out of range",
+                              table_name, i, ordinal);
+    }
+    flatbuffers_string_t name =
+        iree_vm_bytecode_module_function_name(module_def, linkage, ordinal);
+    if (previous_name &&
+        iree_vm_flatbuffer_strcmp(
+            previous_name,
+            iree_make_string_view(name, flatbuffers_string_len(name))) > 0) {
+      return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                              "%s name index[%zu] not sorted by name",
+                              table_name, i);
+    }
+    previous_name = name;
+  }
+  return iree_ok_status();
+}
+
 // Resolves a type through either builtin rules or the ref registered types.
 static bool iree_vm_bytecode_module_resolve_type(
     iree_vm_TypeDef_table_t type_def, iree_vm_type_def_t* out_type) {
@@ -241,6 +380,13 @@ static iree_status_t iree_vm_bytecode_module_flatbuffer_verify(
     // TODO(benvanik): run bytecode verifier on contents.
   }
 
+  IREE_RETURN_IF_ERROR(iree_vm_bytecode_module_function_name_index_verify(
+      module_def, IREE_VM_FUNCTION_LINKAGE_IMPORT, "imports"));
+  IREE_RETURN_IF_ERROR(iree_vm_bytecode_module_function_name_index_verify(
+      module_def, IREE_VM_FUNCTION_LINKAGE_EXPORT, "exports"));
+  IREE_RETURN_IF_ERROR(iree_vm_bytecode_module_function_name_index_verify(
+      module_def, IREE_VM_FUNCTION_LINKAGE_INTERNAL, "functions"));
+
   return iree_ok_status();
 }
 
@@ -438,61 +584,36 @@ static iree_status_t iree_vm_bytecode_module_lookup_function(
                             "function name required for query");
   }
 
-  // NOTE: we could organize imports/exports alphabetically so we could bsearch.
   iree_vm_bytecode_module_t* module = (iree_vm_bytecode_module_t*)self;
-  if (linkage == IREE_VM_FUNCTION_LINKAGE_IMPORT) {
-    iree_vm_ImportFunctionDef_vec_t imported_functions =
-        iree_vm_BytecodeModuleDef_imported_functions(module->def);
-    for (size_t ordinal = 0;
-         ordinal < iree_vm_ImportFunctionDef_vec_len(imported_functions);
-         ++ordinal) {
-      iree_vm_ImportFunctionDef_table_t import_def =
-          iree_vm_ImportFunctionDef_vec_at(imported_functions, ordinal);
-      if (iree_vm_flatbuffer_strcmp(
-              iree_vm_ImportFunctionDef_full_name(import_def), name) == 0) {
-        return iree_vm_bytecode_module_get_function(self, linkage, ordinal,
-                                                    out_function, NULL, NULL);
-      }
-    }
-    return iree_make_status(IREE_STATUS_NOT_FOUND,
-                            "import with the given name not found");
-  } else if (linkage == IREE_VM_FUNCTION_LINKAGE_EXPORT) {
-    iree_vm_ExportFunctionDef_vec_t exported_functions =
-        iree_vm_BytecodeModuleDef_exported_functions(module->def);
-    for (size_t ordinal = 0;
-         ordinal < iree_vm_ExportFunctionDef_vec_len(exported_functions);
-         ++ordinal) {
-      iree_vm_ExportFunctionDef_table_t export_def =
-          iree_vm_ExportFunctionDef_vec_at(exported_functions, ordinal);
-      if (iree_vm_flatbuffer_strcmp(
-              iree_vm_ExportFunctionDef_local_name(export_def), name) == 0) {
-        return iree_vm_bytecode_module_get_function(
-            self, IREE_VM_FUNCTION_LINKAGE_INTERNAL,
-            iree_vm_ExportFunctionDef_internal_ordinal(export_def),
-            out_function, NULL, NULL);
-      }
+  size_t ordinal = 0;
+  if (!iree_vm_bytecode_module_find_function_ordinal(module->def, linkage,
+                                                     name, &ordinal)) {
+    switch (linkage) {
+      case IREE_VM_FUNCTION_LINKAGE_IMPORT:
+        return iree_make_status(IREE_STATUS_NOT_FOUND,
+                                "import with the given name not found");
+      case IREE_VM_FUNCTION_LINKAGE_EXPORT:
+        return iree_make_status(IREE_STATUS_NOT_FOUND,
+                                "export with the given name not found");
+      default:
+        return iree_make_status(IREE_STATUS_NOT_FOUND,
+                                "function with the given name not found");
     }
-    return iree_make_status(IREE_STATUS_NOT_FOUND,
-                            "export with the given name not found");
-  } else {
-    iree_vm_InternalFunctionDef_vec_t internal_functions =
-        iree_vm_BytecodeModuleDef_internal_functions(module->def);
-    for (size_t ordinal = 0;
-         ordinal < iree_vm_InternalFunctionDef_vec_len(internal_functions);
-         ++ordinal) {
-      iree_vm_InternalFunctionDef_table_t function_def =
-          iree_vm_InternalFunctionDef_vec_at(internal_functions, ordinal);
-      if (iree_vm_flatbuffer_strcmp(
-              iree_vm_InternalFunctionDef_local_name(function_def), name) ==
-          0) {
-        return iree_vm_bytecode_module_get_function(
-            self, IREE_VM_FUNCTION_LINKAGE_INTERNAL, ordinal, out_function,
-            NULL, NULL);
-      }
-    }
-    return iree_make_status(IREE_STATUS_NOT_FOUND,
-                            "function with the given name not found");
   }
+
+  if (linkage == IREE_VM_FUNCTION_LINKAGE_EXPORT) {
+    // Exports resolve to the internal function they reference.
+    iree_vm_ExportFunctionDef_table_t export_def =
+        iree_vm_ExportFunctionDef_vec_at(
+            iree_vm_BytecodeModuleDef_exported_functions(module->def),
+            ordinal);
+    return iree_vm_bytecode_module_get_function(
+        self, IREE_VM_FUNCTION_LINKAGE_INTERNAL,
+        iree_vm_ExportFunctionDef_internal_ordinal(export_def), out_function,
+        NULL, NULL);
+  }
+  return iree_vm_bytecode_module_get_function(self, linkage, ordinal,
+                                              out_function, NULL, NULL);
 }
 
 // Lays out the nested tables within a |state| structure.
@@ -727,6 +848,33 @@ static iree_status_t iree_vm_bytecode_module_begin_call(
   return status;
 }
 
+static iree_status_t iree_vm_bytecode_module_resume_call(
+    void* self, iree_vm_stack_t* stack,
+    iree_vm_execution_result_t* out_result) {
+  IREE_TRACE_ZONE_BEGIN(z0);
+  IREE_ASSERT_ARGUMENT(out_result);
+  memset(out_result, 0, sizeof(iree_vm_execution_result_t));
+
+  // The top-most frame must be one we left behind when yielding. All of the
+  // state required to continue (including where to store the results) lives
+  // in the frames.
+  iree_vm_bytecode_module_t* module = (iree_vm_bytecode_module_t*)self;
+  iree_vm_stack_frame_t* frame = iree_vm_stack_current_frame(stack);
+  if (IREE_UNLIKELY(!frame) ||
+      IREE_UNLIKELY(frame->function.module != &module->interface)) {
+    IREE_TRACE_ZONE_END(z0);
+    return iree_make_status(IREE_STATUS_FAILED_PRECONDITION,
+                            "no suspended bytecode frame for this module on "
+                            "the stack to resume");
+  }
+
+  iree_status_t status = iree_vm_bytecode_dispatch(
+      stack, module, /*call=*/NULL, iree_string_view_empty(),
+      iree_string_view_empty(), out_result);
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
 IREE_API_EXPORT iree_status_t iree_vm_bytecode_module_create(
     iree_const_byte_span_t flatbuffer_data,
     iree_allocator_t flatbuffer_allocator, iree_allocator_t allocator,
@@ -802,6 +950,7 @@ IREE_API_EXPORT iree_status_t iree_vm_bytecode_module_create(
   module->interface.free_state = iree_vm_bytecode_module_free_state;
   module->interface.resolve_import = iree_vm_bytecode_module_resolve_import;
   module->interface.begin_call = iree_vm_bytecode_module_begin_call;
+  module->interface.resume_call = iree_vm_bytecode_module_resume_call;
   module->interface.get_function_reflection_attr =
       iree_vm_bytecode_module_get_function_reflection_attr;
 
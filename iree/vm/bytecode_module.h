@@ -20,6 +20,9 @@ extern "C" {
 // If a |flatbuffer_allocator| is provided then it will be used to free the
 // |flatbuffer_data| when the module is destroyed and otherwise the ownership of
 // the flatbuffer_data remains with the caller.
+//
+// The |flatbuffer_data| is never written and may be read-only memory such as a
+// file mapping. Rodata segments reference the data in-place without copies.
 IREE_API_EXPORT iree_status_t iree_vm_bytecode_module_create(
     iree_const_byte_span_t flatbuffer_data,
     iree_allocator_t flatbuffer_allocator, iree_allocator_t allocator,
@@ -123,6 +123,10 @@ typedef struct iree_vm_bytecode_module_state_t {
 // Begins (or resumes) execution of the current frame and continues until
 // either a yield or return. |out_result| will contain the result status for
 // continuation, if needed.
+//
+// When |call| is NULL execution resumes from the top-most frame of |stack|,
+// which must be a frame of |module| left by a prior dispatch that returned
+// IREE_STATUS_DEFERRED.
 iree_status_t iree_vm_bytecode_dispatch(iree_vm_stack_t* stack,
                                         iree_vm_bytecode_module_t* module,
                                         const iree_vm_function_call_t* call,
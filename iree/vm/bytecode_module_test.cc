@@ -10,10 +10,164 @@
 
 #include "iree/vm/bytecode_module.h"
 
+#include <cstdint>
+#include <vector>
+
+#include "iree/base/api.h"
 #include "iree/testing/gtest.h"
+#include "iree/testing/status_matchers.h"
+#include "iree/vm/api.h"
+
+// NOTE: include order matters:
+#include "iree/base/internal/flatcc.h"
+#include "iree/schemas/bytecode_module_def_builder.h"
 
 namespace {
 
-// TODO(benvanik): bytecode_module_test.cc for flatbuffer/module implementation.
+// Builds a module exporting one function per name in |export_names|, each
+// implemented by the internal function of the same ordinal and name. The
+// exported function name index is only added if |export_name_index| is set.
+std::vector<uint8_t> BuildModule(
+    const std::vector<const char*>& export_names,
+    const std::vector<int32_t>* export_name_index) {
+  flatcc_builder_t builder;
+  flatcc_builder_init(&builder);
+  iree_vm_BytecodeModuleDef_start_as_root(&builder);
+
+  std::vector<iree_vm_FunctionDescriptor_t> function_descriptors(
+      export_names.size());
+  for (auto& function_descriptor : function_descriptors) {
+    iree_vm_FunctionDescriptor_assign(&function_descriptor,
+                                      /*bytecode_offset=*/0,
+                                      /*bytecode_length=*/0,
+                                      /*i32_register_count=*/0,
+                                      /*ref_register_count=*/0);
+  }
+  auto function_descriptors_ref = iree_vm_FunctionDescriptor_vec_create(
+      &builder, function_descriptors.data(), function_descriptors.size());
+  auto bytecode_data_ref =
+      flatbuffers_uint8_vec_create(&builder, /*data=*/NULL, /*len=*/0);
+
+  std::vector<iree_vm_ExportFunctionDef_ref_t> export_function_refs;
+  std::vector<iree_vm_InternalFunctionDef_ref_t> internal_function_refs;
+  for (size_t i = 0; i < export_names.size(); ++i) {
+    auto export_name_ref =
+        flatbuffers_string_create_str(&builder, export_names[i]);
+    iree_vm_ExportFunctionDef_start(&builder);
+    iree_vm_ExportFunctionDef_local_name_add(&builder, export_name_ref);
+    iree_vm_ExportFunctionDef_internal_ordinal_add(&builder, (int32_t)i);
+    export_function_refs.push_back(iree_vm_ExportFunctionDef_end(&builder));
+
+    auto local_name_ref =
+        flatbuffers_string_create_str(&builder, export_names[i]);
+    iree_vm_InternalFunctionDef_start(&builder);
+    iree_vm_InternalFunctionDef_local_name_add(&builder, local_name_ref);
+    internal_function_refs.push_back(
+        iree_vm_InternalFunctionDef_end(&builder));
+  }
+  auto exported_functions_ref = iree_vm_ExportFunctionDef_vec_create(
+      &builder, export_function_refs.data(), export_function_refs.size());
+  auto internal_functions_ref = iree_vm_InternalFunctionDef_vec_create(
+      &builder, internal_function_refs.data(), internal_function_refs.size());
+
+  flatbuffers_int32_vec_ref_t export_name_index_ref = 0;
+  if (export_name_index) {
+    export_name_index_ref = flatbuffers_int32_vec_create(
+        &builder, export_name_index->data(), export_name_index->size());
+  }
+
+  auto module_name_ref = flatbuffers_string_create_str(&builder, "module");
+  iree_vm_BytecodeModuleDef_name_add(&builder, module_name_ref);
+  iree_vm_BytecodeModuleDef_exported_functions_add(&builder,
+                                                   exported_functions_ref);
+  iree_vm_BytecodeModuleDef_internal_functions_add(&builder,
+                                                   internal_functions_ref);
+  iree_vm_BytecodeModuleDef_function_descriptors_add(&builder,
+                                                     function_descriptors_ref);
+  iree_vm_BytecodeModuleDef_bytecode_data_add(&builder, bytecode_data_ref);
+  iree_vm_BytecodeModuleDef_exported_function_name_index_add(
+      &builder, export_name_index_ref);
+  iree_vm_BytecodeModuleDef_end_as_root(&builder);
+
+  std::vector<uint8_t> module_data(flatcc_builder_get_buffer_size(&builder));
+  flatcc_builder_copy_buffer(&builder, module_data.data(), module_data.size());
+  flatcc_builder_clear(&builder);
+  return module_data;
+}
+
+iree_status_t CreateModule(const std::vector<uint8_t>& module_data,
+                           iree_vm_module_t** out_module) {
+  return iree_vm_bytecode_module_create(
+      iree_make_const_byte_span(module_data.data(), module_data.size()),
+      iree_allocator_null(), iree_allocator_system(), out_module);
+}
+
+// Exports not sorted by name so that the name index differs from the table.
+static const std::vector<const char*> kExportNames = {"c", "a", "b"};
+// Ordinals of kExportNames sorted by name.
+static const std::vector<int32_t> kExportNameIndex = {1, 2, 0};
+
+TEST(BytecodeModuleTest, FunctionNameIndexLookup) {
+  for (bool has_index : {true, false}) {
+    auto module_data =
+        BuildModule(kExportNames, has_index ? &kExportNameIndex : NULL);
+    iree_vm_module_t* module = NULL;
+    IREE_ASSERT_OK(CreateModule(module_data, &module));
+
+    // Hits resolve to the internal function implementing the export.
+    for (size_t i = 0; i < kExportNames.size(); ++i) {
+      iree_vm_function_t function;
+      IREE_ASSERT_OK(iree_vm_module_lookup_function_by_name(
+          module, IREE_VM_FUNCTION_LINKAGE_EXPORT,
+          iree_make_cstring_view(kExportNames[i]), &function));
+      EXPECT_EQ(IREE_VM_FUNCTION_LINKAGE_INTERNAL, function.linkage);
+      EXPECT_EQ(i, function.ordinal);
+    }
+
+    // Misses before, between, and after the sorted names as well as prefixes
+    // and extensions of present names.
+    for (const char* name : {"0", "aa", "ba", "d", "bb"}) {
+      iree_vm_function_t function;
+      IREE_EXPECT_STATUS_IS(
+          IREE_STATUS_NOT_FOUND,
+          iree_vm_module_lookup_function_by_name(
+              module, IREE_VM_FUNCTION_LINKAGE_EXPORT,
+              iree_make_cstring_view(name), &function));
+    }
+
+    iree_vm_module_release(module);
+  }
+}
+
+TEST(BytecodeModuleTest, FunctionNameIndexUnsorted) {
+  std::vector<int32_t> export_name_index = {0, 1, 2};
+  auto module_data = BuildModule(kExportNames, &export_name_index);
+  iree_vm_module_t* module = NULL;
+  IREE_EXPECT_STATUS_IS(IREE_STATUS_INVALID_ARGUMENT,
+                        CreateModule(module_data, &module));
+  EXPECT_EQ(nullptr, module);
+}
+
+TEST(BytecodeModuleTest, FunctionNameIndexOrdinalOutOfRange) {
+  for (int32_t ordinal : {-1, 3}) {
+    std::vector<int32_t> export_name_index = {1, 2, ordinal};
+    auto module_data = BuildModule(kExportNames, &export_name_index);
+    iree_vm_module_t* module = NULL;
+    IREE_EXPECT_STATUS_IS(IREE_STATUS_INVALID_ARGUMENT,
+                          CreateModule(module_data, &module));
+    EXPECT_EQ(nullptr, module);
+  }
+}
+
+TEST(BytecodeModuleTest, FunctionNameIndexLengthMismatch) {
+  for (auto export_name_index :
+       {std::vector<int32_t>{1, 2}, std::vector<int32_t>{1, 2, 0, 0}}) {
+    auto module_data = BuildModule(kExportNames, &export_name_index);
+    iree_vm_module_t* module = NULL;
+    IREE_EXPECT_STATUS_IS(IREE_STATUS_INVALID_ARGUMENT,
+                          CreateModule(module_data, &module));
+    EXPECT_EQ(nullptr, module);
+  }
+}
 
 }  // namespace
@@ -12,6 +12,7 @@
 
 #include "iree/base/internal/atomics.h"
 #include "iree/base/tracing.h"
+#include "iree/vm/invocation.h"
 
 struct iree_vm_context_t {
   iree_atomic_ref_count_t ref_count;
@@ -54,10 +55,9 @@ static iree_status_t iree_vm_context_run_function(
     return status;
   }
 
-  iree_vm_execution_result_t result;
-  status = module->begin_call(module->self, stack, &call, &result);
-
-  // TODO(benvanik): ensure completed synchronously.
+  // Initializers may yield (such as when awaiting on device work) but we have
+  // no way of deferring context creation and run them to completion here.
+  status = iree_vm_invoke_call(stack, &call);
 
   IREE_TRACE_ZONE_END(z0);
   return status;
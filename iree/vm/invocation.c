@@ -11,6 +11,7 @@
 #include <string.h>
 
 #include "iree/base/api.h"
+#include "iree/base/internal/atomics.h"
 #include "iree/base/tracing.h"
 #include "iree/vm/ref.h"
 #include "iree/vm/stack.h"
@@ -18,7 +19,7 @@
 
 // Marshals caller arguments from the variant list to the ABI convention.
 static iree_status_t iree_vm_invoke_marshal_inputs(
-    iree_string_view_t cconv_arguments, iree_vm_list_t* inputs,
+    iree_string_view_t cconv_arguments, const iree_vm_list_t* inputs,
     iree_byte_span_t arguments) {
   // We are 1:1 right now with no variadic args, so do a quick verification on
   // the input list.
@@ -144,7 +145,52 @@ static iree_status_t iree_vm_invoke_marshal_outputs(
   return iree_ok_status();
 }
 
-// TODO(benvanik): implement this as an iree_vm_invocation_t sequence.
+// Releases any refs remaining in the ABI |arguments| buffer after a call.
+// Bytecode callees move their arguments into registers while native callees
+// only borrow them and leave the references marshaled from the inputs here.
+// Result buffers share the layout and may be released the same way with their
+// cconv fragment.
+static void iree_vm_invoke_release_arguments(iree_string_view_t cconv_arguments,
+                                             iree_byte_span_t arguments) {
+  uint8_t* p = arguments.data;
+  for (iree_host_size_t i = 0; i < cconv_arguments.size; ++i) {
+    switch (cconv_arguments.data[i]) {
+      case IREE_VM_CCONV_TYPE_VOID:
+        break;
+      case IREE_VM_CCONV_TYPE_I32:
+      case IREE_VM_CCONV_TYPE_F32:
+        p += sizeof(int32_t);
+        break;
+      case IREE_VM_CCONV_TYPE_I64:
+      case IREE_VM_CCONV_TYPE_F64:
+        p += sizeof(int64_t);
+        break;
+      case IREE_VM_CCONV_TYPE_REF:
+        iree_vm_ref_release((iree_vm_ref_t*)p);
+        p += sizeof(iree_vm_ref_t);
+        break;
+    }
+  }
+}
+
+IREE_API_EXPORT iree_status_t iree_vm_invoke_call(
+    iree_vm_stack_t* stack, const iree_vm_function_call_t* call) {
+  IREE_ASSERT_ARGUMENT(stack);
+  IREE_ASSERT_ARGUMENT(call);
+  iree_vm_execution_result_t result;
+  iree_status_t status = call->function.module->begin_call(
+      call->function.module->self, stack, call, &result);
+  while (iree_status_is_deferred(status)) {
+    // Nothing else is running on this thread so block until the callee is able
+    // to make progress again.
+    status = iree_vm_execution_result_wait(&result, iree_infinite_timeout());
+    if (iree_status_is_ok(status)) {
+      status = iree_vm_function_call_resume(stack, call, &result);
+    }
+  }
+  return status;
+}
+
 static iree_status_t iree_vm_invoke_within(
     iree_vm_context_t* context, iree_vm_stack_t* stack,
     iree_vm_function_t function, const iree_vm_invocation_policy_t* policy,
@@ -177,18 +223,16 @@ static iree_status_t iree_vm_invoke_within(
   results.data = iree_alloca(results.data_length);
   memset(results.data, 0, results.data_length);
 
-  // Perform execution. Note that for synchronous execution we expect this to
-  // complete without yielding.
+  // Perform execution, blocking on any waits the callee yields on.
   iree_vm_function_call_t call;
   memset(&call, 0, sizeof(call));
   call.function = function;
   call.arguments = arguments;
   call.results = results;
-  iree_vm_execution_result_t result;
-  iree_status_t status =
-      function.module->begin_call(function.module->self, stack, &call, &result);
+  iree_status_t status = iree_vm_invoke_call(stack, &call);
+  iree_vm_invoke_release_arguments(cconv_arguments, arguments);
   if (!iree_status_is_ok(status)) {
-    iree_vm_function_call_release(&call, &signature);
+    iree_vm_invoke_release_arguments(cconv_results, results);
     return status;
   }
 
@@ -215,3 +259,241 @@ IREE_API_EXPORT iree_status_t iree_vm_invoke(
   IREE_TRACE_ZONE_END(z0);
   return status;
 }
+
+//===----------------------------------------------------------------------===//
+// iree_vm_invocation_t
+//===----------------------------------------------------------------------===//
+
+struct iree_vm_invocation_t {
+  iree_atomic_ref_count_t ref_count;
+  iree_allocator_t allocator;
+  iree_vm_context_t* context;
+
+  // Calling convention fragments of the function; reference module memory.
+  iree_string_view_t cconv_arguments;
+  iree_string_view_t cconv_results;
+
+  // Call with argument and result buffers stored in the trailing allocation.
+  // Both must remain valid for as long as the invocation may be resumed.
+  iree_vm_function_call_t call;
+
+  // Stack holding the frames of the suspended invocation. Initialized in the
+  // trailing allocation and NULL once the invocation has finished.
+  iree_vm_stack_t* stack;
+
+  // IREE_STATUS_DEFERRED while suspended and the final status otherwise.
+  iree_status_t status;
+  iree_vm_execution_result_t result;
+
+  // Outputs populated when the invocation completes successfully.
+  iree_vm_list_t* outputs;
+
+  // + trailing argument buffer
+  // + trailing result buffer
+  // + trailing stack storage
+};
+
+// Tears down the stack and releases any ABI buffer contents of |invocation|.
+static void iree_vm_invocation_reset(iree_vm_invocation_t* invocation) {
+  if (!invocation->stack) return;
+  // Pops (and cleans up) any frames left by a suspended invocation.
+  iree_vm_stack_deinitialize(invocation->stack);
+  invocation->stack = NULL;
+  // Drops refs the callee did not consume and any results not marshaled out.
+  // Each buffer is released independently as either may be empty.
+  iree_vm_invoke_release_arguments(invocation->cconv_arguments,
+                                   invocation->call.arguments);
+  iree_vm_invoke_release_arguments(invocation->cconv_results,
+                                   invocation->call.results);
+  memset(&invocation->result, 0, sizeof(invocation->result));
+}
+
+// Updates |invocation| with the |status| of the most recent begin/resume.
+// Invocations that yielded remain suspended and otherwise their results are
+// marshaled into the output list and their stack is torn down.
+static void iree_vm_invocation_update(iree_vm_invocation_t* invocation,
+                                      iree_status_t status) {
+  if (iree_status_is_deferred(status)) {
+    invocation->status = status;
+    return;
+  }
+  if (iree_status_is_ok(status)) {
+    status = iree_vm_list_create(/*element_type=*/NULL,
+                                 invocation->cconv_results.size,
+                                 invocation->allocator, &invocation->outputs);
+  }
+  if (iree_status_is_ok(status)) {
+    status = iree_vm_invoke_marshal_outputs(invocation->cconv_results,
+                                            invocation->call.results,
+                                            invocation->outputs);
+  }
+  iree_vm_invocation_reset(invocation);
+  invocation->status = status;
+}
+
+IREE_API_EXPORT iree_status_t iree_vm_invocation_create(
+    iree_vm_context_t* context, iree_vm_function_t function,
+    const iree_vm_invocation_policy_t* policy, const iree_vm_list_t* inputs,
+    iree_allocator_t allocator, iree_vm_invocation_t** out_invocation) {
+  IREE_ASSERT_ARGUMENT(context);
+  IREE_ASSERT_ARGUMENT(out_invocation);
+  *out_invocation = NULL;
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  iree_vm_function_signature_t signature =
+      iree_vm_function_signature(&function);
+  iree_string_view_t cconv_arguments = iree_string_view_empty();
+  iree_string_view_t cconv_results = iree_string_view_empty();
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0, iree_vm_function_call_get_cconv_fragments(
+              &signature, &cconv_arguments, &cconv_results));
+  iree_host_size_t argument_size = 0;
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0, iree_vm_function_call_compute_cconv_fragment_size(
+              cconv_arguments, /*segment_size_list=*/NULL, &argument_size));
+  iree_host_size_t result_size = 0;
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0, iree_vm_function_call_compute_cconv_fragment_size(
+              cconv_results, /*segment_size_list=*/NULL, &result_size));
+
+  // Allocate the invocation with its ABI buffers and stack storage inline.
+  iree_host_size_t header_size =
+      iree_host_align(sizeof(iree_vm_invocation_t), iree_max_align_t);
+  iree_host_size_t argument_offset = header_size;
+  iree_host_size_t result_offset =
+      argument_offset + iree_host_align(argument_size, iree_max_align_t);
+  iree_host_size_t stack_offset =
+      result_offset + iree_host_align(result_size, iree_max_align_t);
+  iree_host_size_t total_size = stack_offset + IREE_VM_STACK_DEFAULT_SIZE;
+  iree_vm_invocation_t* invocation = NULL;
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0, iree_allocator_malloc(allocator, total_size, (void**)&invocation));
+  iree_atomic_ref_count_init(&invocation->ref_count);
+  invocation->allocator = allocator;
+  invocation->context = context;
+  iree_vm_context_retain(context);
+  invocation->cconv_arguments = cconv_arguments;
+  invocation->cconv_results = cconv_results;
+  invocation->call.function = function;
+  invocation->call.arguments = iree_make_byte_span(
+      (uint8_t*)invocation + argument_offset, argument_size);
+  invocation->call.results = iree_make_byte_span(
+      (uint8_t*)invocation + result_offset, result_size);
+
+  iree_status_t status = iree_vm_stack_initialize(
+      iree_make_byte_span((uint8_t*)invocation + stack_offset,
+                          IREE_VM_STACK_DEFAULT_SIZE),
+      iree_vm_context_state_resolver(context), allocator, &invocation->stack);
+  if (iree_status_is_ok(status)) {
+    status = iree_vm_invoke_marshal_inputs(cconv_arguments, inputs,
+                                           invocation->call.arguments);
+  }
+  if (!iree_status_is_ok(status)) {
+    iree_vm_invocation_reset(invocation);
+    iree_vm_invocation_release(invocation);
+    IREE_TRACE_ZONE_END(z0);
+    return status;
+  }
+
+  // Run until the invocation completes or first yields. Failures during
+  // execution are reported via the invocation status.
+  iree_vm_invocation_update(
+      invocation,
+      function.module->begin_call(function.module->self, invocation->stack,
+                                  &invocation->call, &invocation->result));
+
+  *out_invocation = invocation;
+  IREE_TRACE_ZONE_END(z0);
+  return iree_ok_status();
+}
+
+static void iree_vm_invocation_destroy(iree_vm_invocation_t* invocation) {
+  IREE_TRACE_ZONE_BEGIN(z0);
+  iree_vm_invocation_reset(invocation);
+  iree_vm_list_release(invocation->outputs);
+  iree_status_ignore(invocation->status);
+  iree_vm_context_release(invocation->context);
+  iree_allocator_free(invocation->allocator, invocation);
+  IREE_TRACE_ZONE_END(z0);
+}
+
+IREE_API_EXPORT void iree_vm_invocation_retain(
+    iree_vm_invocation_t* invocation) {
+  if (invocation) {
+    iree_atomic_ref_count_inc(&invocation->ref_count);
+  }
+}
+
+IREE_API_EXPORT void iree_vm_invocation_release(
+    iree_vm_invocation_t* invocation) {
+  if (invocation && iree_atomic_ref_count_dec(&invocation->ref_count) == 1) {
+    iree_vm_invocation_destroy(invocation);
+  }
+}
+
+IREE_API_EXPORT iree_status_t
+iree_vm_invocation_query_status(iree_vm_invocation_t* invocation) {
+  IREE_ASSERT_ARGUMENT(invocation);
+  return iree_status_clone(invocation->status);
+}
+
+IREE_API_EXPORT const iree_vm_execution_result_t*
+iree_vm_invocation_execution_result(iree_vm_invocation_t* invocation) {
+  IREE_ASSERT_ARGUMENT(invocation);
+  return &invocation->result;
+}
+
+IREE_API_EXPORT iree_status_t
+iree_vm_invocation_resume(iree_vm_invocation_t* invocation) {
+  IREE_ASSERT_ARGUMENT(invocation);
+  if (!iree_status_is_deferred(invocation->status)) {
+    return iree_vm_invocation_query_status(invocation);
+  }
+  IREE_TRACE_ZONE_BEGIN(z0);
+  iree_vm_invocation_update(
+      invocation,
+      iree_vm_function_call_resume(invocation->stack, &invocation->call,
+                                   &invocation->result));
+  IREE_TRACE_ZONE_END(z0);
+  return iree_vm_invocation_query_status(invocation);
+}
+
+IREE_API_EXPORT const iree_vm_list_t* iree_vm_invocation_output(
+    iree_vm_invocation_t* invocation) {
+  IREE_ASSERT_ARGUMENT(invocation);
+  return iree_status_is_ok(invocation->status) ? invocation->outputs : NULL;
+}
+
+IREE_API_EXPORT iree_status_t iree_vm_invocation_await(
+    iree_vm_invocation_t* invocation, iree_time_t deadline) {
+  IREE_ASSERT_ARGUMENT(invocation);
+  IREE_TRACE_ZONE_BEGIN(z0);
+  iree_status_t status = iree_ok_status();
+  while (iree_status_is_deferred(invocation->status)) {
+    if (iree_time_now() >= deadline) {
+      status = iree_status_from_code(IREE_STATUS_DEADLINE_EXCEEDED);
+      break;
+    }
+    status = iree_vm_execution_result_wait(&invocation->result,
+                                           iree_make_deadline(deadline));
+    if (!iree_status_is_ok(status)) break;
+    iree_vm_invocation_update(
+        invocation,
+        iree_vm_function_call_resume(invocation->stack, &invocation->call,
+                                     &invocation->result));
+  }
+  IREE_TRACE_ZONE_END(z0);
+  if (!iree_status_is_ok(status)) return status;
+  return iree_vm_invocation_query_status(invocation);
+}
+
+IREE_API_EXPORT iree_status_t
+iree_vm_invocation_abort(iree_vm_invocation_t* invocation) {
+  IREE_ASSERT_ARGUMENT(invocation);
+  if (!iree_status_is_deferred(invocation->status)) return iree_ok_status();
+  IREE_TRACE_ZONE_BEGIN(z0);
+  iree_vm_invocation_reset(invocation);
+  invocation->status = iree_status_from_code(IREE_STATUS_ABORTED);
+  IREE_TRACE_ZONE_END(z0);
+  return iree_ok_status();
+}
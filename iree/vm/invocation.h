@@ -39,30 +39,62 @@ IREE_API_EXPORT iree_status_t iree_vm_invoke(
     const iree_vm_invocation_policy_t* policy, iree_vm_list_t* inputs,
     iree_vm_list_t* outputs, iree_allocator_t allocator);
 
-// TODO(benvanik): document and implement.
+// Issues |call| on |stack| and runs it to completion on the calling thread,
+// blocking on any waits the callee yields on. This is intended for hosts that
+// marshal their own ABI buffers but don't want to handle yields themselves.
+// The |stack| must be empty when called.
+IREE_API_EXPORT iree_status_t iree_vm_invoke_call(
+    iree_vm_stack_t* stack, const iree_vm_function_call_t* call);
+
+// Creates an invocation of |function| and begins executing it on the calling
+// thread until it either completes or yields.
+//
+// Invocations own their VM stack such that any number of suspended
+// invocations can be multiplexed on a single host thread: use
+// iree_vm_invocation_execution_result to find what a suspended invocation is
+// waiting on and iree_vm_invocation_resume to continue it once ready.
+// Invocations are not thread-safe and must be externally synchronized.
+//
+// |inputs| is used to pass values and objects into the target function and
+// must match the signature defined by the compiled function. The list is only
+// used during creation and ownership remains with the caller.
 IREE_API_EXPORT iree_status_t iree_vm_invocation_create(
     iree_vm_context_t* context, iree_vm_function_t function,
     const iree_vm_invocation_policy_t* policy, const iree_vm_list_t* inputs,
     iree_allocator_t allocator, iree_vm_invocation_t** out_invocation);
 
 // Retains the given |invocation| for the caller.
-IREE_API_EXPORT iree_status_t
-iree_vm_invocation_retain(iree_vm_invocation_t* invocation);
+IREE_API_EXPORT void iree_vm_invocation_retain(
+    iree_vm_invocation_t* invocation);
 
 // Releases the given |invocation| from the caller.
-IREE_API_EXPORT iree_status_t
-iree_vm_invocation_release(iree_vm_invocation_t* invocation);
+// Invocations released while suspended are aborted.
+IREE_API_EXPORT void iree_vm_invocation_release(
+    iree_vm_invocation_t* invocation);
 
 // Queries the completion status of the invocation.
 // Returns one of the following:
 //   IREE_STATUS_OK: the invocation completed successfully.
-//   IREE_STATUS_UNAVAILABLE: the invocation has not yet completed.
-//   IREE_STATUS_CANCELLED: the invocation was cancelled internally.
+//   IREE_STATUS_DEFERRED: the invocation is suspended and must be resumed.
 //   IREE_STATUS_ABORTED: the invocation was aborted.
 //   IREE_STATUS_*: an error occurred during invocation.
 IREE_API_EXPORT iree_status_t
 iree_vm_invocation_query_status(iree_vm_invocation_t* invocation);
 
+// Returns the execution result describing why a suspended |invocation| yielded
+// (such as the wait it is blocked on). Only valid while the invocation is
+// suspended and until it is resumed.
+IREE_API_EXPORT const iree_vm_execution_result_t*
+iree_vm_invocation_execution_result(iree_vm_invocation_t* invocation);
+
+// Resumes a suspended |invocation| on the calling thread until it either
+// completes or yields again. Callers should only resume once the wait reported
+// by iree_vm_invocation_execution_result has been satisfied; resuming earlier
+// is safe but the invocation will immediately yield again.
+// Returns iree_vm_invocation_query_status after execution stops.
+IREE_API_EXPORT iree_status_t
+iree_vm_invocation_resume(iree_vm_invocation_t* invocation);
+
 // Returns a reference to the output of the invocation.
 // The returned structure is valid for the lifetime of the invocation and
 // callers must retain any refs they want to outlive the invocation once
@@ -72,14 +104,15 @@ iree_vm_invocation_query_status(iree_vm_invocation_t* invocation);
 IREE_API_EXPORT const iree_vm_list_t* iree_vm_invocation_output(
     iree_vm_invocation_t* invocation);
 
-// Blocks the caller until the invocation completes (successfully or otherwise).
+// Blocks the caller until the invocation completes (successfully or otherwise)
+// by repeatedly waiting on and resuming it.
 //
 // Returns IREE_STATUS_DEADLINE_EXCEEDED if |deadline| elapses before the
 // invocation completes and otherwise returns iree_vm_invocation_query_status.
 IREE_API_EXPORT iree_status_t iree_vm_invocation_await(
     iree_vm_invocation_t* invocation, iree_time_t deadline);
 
-// Attempts to abort the invocation if it is in-flight.
+// Attempts to abort the invocation if it is suspended.
 // A no-op if the invocation has already completed.
 IREE_API_EXPORT iree_status_t
 iree_vm_invocation_abort(iree_vm_invocation_t* invocation);
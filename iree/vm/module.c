@@ -11,6 +11,7 @@
 #include "iree/base/internal/atomics.h"
 #include "iree/base/tracing.h"
 #include "iree/vm/ref.h"
+#include "iree/vm/stack.h"
 
 IREE_API_EXPORT iree_status_t iree_vm_function_call_get_cconv_fragments(
     const iree_vm_function_signature_t* signature,
@@ -323,3 +324,33 @@ IREE_API_EXPORT iree_status_t iree_vm_get_function_reflection_attr(
       function.module->self, function.linkage, function.ordinal, index, key,
       value);
 }
+
+IREE_API_EXPORT iree_status_t iree_vm_function_call_resume(
+    iree_vm_stack_t* stack, const iree_vm_function_call_t* call,
+    iree_vm_execution_result_t* out_result) {
+  IREE_ASSERT_ARGUMENT(stack);
+  IREE_ASSERT_ARGUMENT(call);
+  IREE_ASSERT_ARGUMENT(out_result);
+  iree_vm_stack_frame_t* frame = iree_vm_stack_current_frame(stack);
+  if (!frame) {
+    // Nothing was left on the stack so the call never started.
+    iree_vm_module_t* module = call->function.module;
+    return module->begin_call(module->self, stack, call, out_result);
+  }
+  iree_vm_module_t* module = frame->function.module;
+  return module->resume_call(module->self, stack, out_result);
+}
+
+IREE_API_EXPORT iree_status_t iree_vm_execution_result_wait(
+    const iree_vm_execution_result_t* result, iree_timeout_t timeout) {
+  IREE_ASSERT_ARGUMENT(result);
+  if (result->yield_reason != IREE_VM_YIELD_REASON_AWAIT ||
+      !result->wait.wait_fn) {
+    return iree_ok_status();
+  }
+  IREE_TRACE_ZONE_BEGIN(z0);
+  iree_status_t status =
+      result->wait.wait_fn(result->wait.object, result->wait.value, timeout);
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
@@ -14,6 +14,7 @@
 #include "iree/base/alignment.h"
 #include "iree/base/api.h"
 #include "iree/base/internal/atomics.h"
+#include "iree/vm/ref.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -250,14 +251,42 @@ IREE_API_EXPORT void iree_vm_function_call_release(
     iree_vm_function_call_t* call,
     const iree_vm_function_signature_t* signature);
 
-// Results of an iree_vm_module_execute request.
+// Describes why execution of a call yielded back to the host.
+typedef enum iree_vm_yield_reason_e {
+  // Execution did not yield (it either completed or failed).
+  IREE_VM_YIELD_REASON_NONE = 0,
+  // Execution yielded cooperatively (such as with vm.yield) and may be resumed
+  // at any time.
+  IREE_VM_YIELD_REASON_YIELD = 1,
+  // Execution is blocked on the external wait described in
+  // iree_vm_execution_result_t::wait and should be resumed once satisfied.
+  IREE_VM_YIELD_REASON_AWAIT = 2,
+} iree_vm_yield_reason_t;
+
+// Blocks the caller until |object| reaches |value| or |timeout| elapses.
+// Returns IREE_STATUS_DEADLINE_EXCEEDED if the timeout elapses first.
+typedef iree_status_t(IREE_API_PTR* iree_vm_wait_fn_t)(void* object,
+                                                        uint64_t value,
+                                                        iree_timeout_t timeout);
+
+// Results of a begin_call/resume_call request.
 typedef struct iree_vm_execution_result_t {
-  // TODO(benvanik): yield information.
-  // Yield modes:
-  // - yield (yield instruction)
-  // - await (with 1+ wait handles)
-  // - break
-  int reserved;
+  // Reason execution yielded when the call returns IREE_STATUS_DEFERRED.
+  iree_vm_yield_reason_t yield_reason;
+
+  // Wait the execution is blocked on when |yield_reason| is
+  // IREE_VM_YIELD_REASON_AWAIT. The object is not retained and is only valid
+  // until the call is resumed or the stack holding it is deinitialized.
+  //
+  // Hosts multiplexing many invocations can use |type| to batch waits on
+  // objects they understand (such as HAL semaphores) and otherwise fall back
+  // to |wait_fn|.
+  struct {
+    iree_vm_ref_type_t type;
+    void* object;
+    uint64_t value;
+    iree_vm_wait_fn_t wait_fn;
+  } wait;
 } iree_vm_execution_result_t;
 
 // Defines an interface that can be used to reflect and execute functions on a
@@ -316,11 +345,19 @@ typedef struct iree_vm_module_t {
   // Begins a function call with the given |call| arguments.
   // Execution may yield in the case of asynchronous code and require one or
   // more calls to the resume method to complete.
+  //
+  // Returns IREE_STATUS_DEFERRED when execution yielded and populates
+  // |out_result| with the reason. If the callee left frames on |stack| the
+  // call must be continued with resume_call on the module owning the top-most
+  // frame. If no frames were left (as with native functions that are not
+  // ready to run) the call had no side effects and must be reissued with
+  // begin_call.
   iree_status_t(IREE_API_PTR* begin_call)(
       void* self, iree_vm_stack_t* stack, const iree_vm_function_call_t* call,
       iree_vm_execution_result_t* out_result);
 
-  // Resumes execution of a previously-yielded call.
+  // Resumes execution of a previously-yielded call from the top-most frame of
+  // |stack|. May yield again with IREE_STATUS_DEFERRED as with begin_call.
   iree_status_t(IREE_API_PTR* resume_call)(
       void* self, iree_vm_stack_t* stack,
       iree_vm_execution_result_t* out_result);
@@ -409,6 +446,21 @@ IREE_API_EXPORT iree_status_t iree_vm_get_function_reflection_attr(
     iree_vm_function_t function, iree_host_size_t index,
     iree_string_view_t* key, iree_string_view_t* value);
 
+// Continues a |call| that returned IREE_STATUS_DEFERRED on |stack|.
+// The |stack| must have been empty when the call was begun. Calls that left
+// frames on the stack are resumed from the top-most frame and calls that left
+// none (such as native functions that were not yet ready to run) are reissued
+// with the original |call| arguments.
+IREE_API_EXPORT iree_status_t iree_vm_function_call_resume(
+    iree_vm_stack_t* stack, const iree_vm_function_call_t* call,
+    iree_vm_execution_result_t* out_result);
+
+// Blocks the caller until the wait described by |result| is satisfied or
+// |timeout| elapses. Returns immediately if the execution yielded without
+// waiting on anything.
+IREE_API_EXPORT iree_status_t iree_vm_execution_result_wait(
+    const iree_vm_execution_result_t* result, iree_timeout_t timeout);
+
 #ifdef __cplusplus
 }  // extern "C"
 #endif  // __cplusplus
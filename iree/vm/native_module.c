@@ -289,7 +289,9 @@ static iree_status_t IREE_API_PTR iree_vm_native_module_begin_call(
   }
 
   // NOTE: VM stack is currently unused. We could stash things here for the
-  // debugger or use it for coroutine state.
+  // debugger. Native functions that are not ready to run return
+  // IREE_STATUS_DEFERRED without side effects and are reissued by the caller
+  // instead of being resumed so there is no coroutine state to preserve.
   iree_host_size_t frame_size = 0;
 
   iree_vm_stack_frame_t* callee_frame = NULL;
@@ -301,9 +303,17 @@ static iree_status_t IREE_API_PTR iree_vm_native_module_begin_call(
   const iree_vm_native_function_ptr_t* function_ptr =
       &module->descriptor->functions[call->function.ordinal];
   iree_vm_module_state_t* module_state = callee_frame->module_state;
+  memset(out_result, 0, sizeof(*out_result));
   iree_status_t status = function_ptr->shim(stack, call, function_ptr->target,
                                             module, module_state, out_result);
-  if (IREE_UNLIKELY(!iree_status_is_ok(status))) {
+  if (iree_status_is_deferred(status)) {
+    // Pop our frame so that the caller can reissue the call when resumed.
+    if (out_result->yield_reason == IREE_VM_YIELD_REASON_NONE) {
+      out_result->yield_reason = IREE_VM_YIELD_REASON_YIELD;
+    }
+    IREE_RETURN_IF_ERROR(iree_vm_stack_function_leave(stack));
+    return status;
+  } else if (IREE_UNLIKELY(!iree_status_is_ok(status))) {
     iree_string_view_t module_name = iree_vm_native_module_name(module);
     iree_string_view_t function_name = iree_string_view_empty();
     iree_status_ignore(iree_vm_native_module_get_export_function(
@@ -324,8 +334,11 @@ iree_vm_native_module_resume_call(void* self, iree_vm_stack_t* stack,
   if (module->user_interface.resume_call) {
     return module->user_interface.resume_call(module->self, stack, out_result);
   }
-  return iree_make_status(IREE_STATUS_UNIMPLEMENTED,
-                          "native module does not support resume");
+  // Deferred native calls leave no frames on the stack and are reissued with
+  // begin_call so there is never anything for us to resume.
+  return iree_make_status(IREE_STATUS_FAILED_PRECONDITION,
+                          "native functions are reissued with begin_call "
+                          "instead of being resumed");
 }
 
 IREE_API_EXPORT iree_status_t iree_vm_native_module_create(
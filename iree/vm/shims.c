@@ -7,6 +7,7 @@
 #include "iree/vm/shims.h"
 
 IREE_VM_ABI_DEFINE_SHIM(irii, v);
+IREE_VM_ABI_DEFINE_SHIM(iriiiii, v);
 IREE_VM_ABI_DEFINE_SHIM(r, i);
 IREE_VM_ABI_DEFINE_SHIM(r, ii);
 IREE_VM_ABI_DEFINE_SHIM(r, iii);
@@ -25,13 +26,19 @@ IREE_VM_ABI_DEFINE_SHIM(rii, i);
 IREE_VM_ABI_DEFINE_SHIM(rii, r);
 IREE_VM_ABI_DEFINE_SHIM(riii, r);
 IREE_VM_ABI_DEFINE_SHIM(riii, v);
+IREE_VM_ABI_DEFINE_SHIM(riiiriiii, v);
+IREE_VM_ABI_DEFINE_SHIM(riiiriiiii, v);
+IREE_VM_ABI_DEFINE_SHIM(riiiriiiriiiii, v);
+IREE_VM_ABI_DEFINE_SHIM(riiiriiiriiiriiiii, v);
 IREE_VM_ABI_DEFINE_SHIM(riirii, r);
+IREE_VM_ABI_DEFINE_SHIM(riiriiriiiii, v);
 IREE_VM_ABI_DEFINE_SHIM(rrrCrD, r);
 IREE_VM_ABI_DEFINE_SHIM(ririi, v);
 IREE_VM_ABI_DEFINE_SHIM(rr, i);
 IREE_VM_ABI_DEFINE_SHIM(rr, r);
 IREE_VM_ABI_DEFINE_SHIM(rr, v);
 IREE_VM_ABI_DEFINE_SHIM(rr, ii);
+IREE_VM_ABI_DEFINE_SHIM(rr, ri);
 IREE_VM_ABI_DEFINE_SHIM(rrCiriiD, r);
 IREE_VM_ABI_DEFINE_SHIM(rriCiD, v);
 IREE_VM_ABI_DEFINE_SHIM(rriCiriiD, v);
@@ -67,10 +67,15 @@
 // Shim function declaration/definition and accessor utilities
 //===----------------------------------------------------------------------===//
 
+// Target functions may return IREE_STATUS_DEFERRED to indicate that they are
+// not yet able to run. They must not have side effects or populate |rets| when
+// doing so as the call will be reissued once resumed. |out_result| may be
+// populated to describe what the function is waiting on.
 typedef iree_status_t(IREE_API_PTR* iree_vm_native_function_target2_t)(
     iree_vm_stack_t* IREE_RESTRICT stack, void* IREE_RESTRICT module,
     void* IREE_RESTRICT module_state, const void* IREE_RESTRICT args,
-    void* IREE_RESTRICT rets);
+    void* IREE_RESTRICT rets,
+    iree_vm_execution_result_t* IREE_RESTRICT out_result);
 
 #define IREE_VM_ABI_DECLARE_SHIM(arg_types, ret_types)                         \
   iree_status_t iree_vm_shim_##arg_types##_##ret_types(                        \
@@ -96,7 +101,7 @@ typedef iree_status_t(IREE_API_PTR* iree_vm_native_function_target2_t)(
                               "argument/result signature mismatch");           \
     }                                                                          \
     iree_vm_abi_##ret_types##_reset(rets);                                     \
-    return target_fn(stack, module, module_state, args, rets);                 \
+    return target_fn(stack, module, module_state, args, rets, out_result);     \
   }
 
 #define IREE_VM_ABI_EXPORT(function_name, module_state, arg_types, ret_types) \
@@ -104,7 +109,8 @@ typedef iree_status_t(IREE_API_PTR* iree_vm_native_function_target2_t)(
       iree_vm_stack_t* IREE_RESTRICT stack, void* IREE_RESTRICT module,       \
       module_state* IREE_RESTRICT state,                                      \
       IREE_VM_ABI_TYPE_NAME(arg_types) * IREE_RESTRICT args,                  \
-      IREE_VM_ABI_TYPE_NAME(ret_types) * IREE_RESTRICT rets)
+      IREE_VM_ABI_TYPE_NAME(ret_types) * IREE_RESTRICT rets,                  \
+      iree_vm_execution_result_t* IREE_RESTRICT out_result)
 
 // TODO(benvanik): special case when source type and target type match.
 #define IREE_VM_ABI_VLA_STACK_CAST(args, vla_count, vla_field, target_type, \
@@ -189,6 +195,16 @@ IREE_VM_ABI_FIXED_STRUCT(irii, {
   int32_t i3;
 });
 
+IREE_VM_ABI_FIXED_STRUCT(iriiiii, {
+  int32_t i0;
+  iree_vm_ref_t r1;
+  int32_t i2;
+  int32_t i3;
+  int32_t i4;
+  int32_t i5;
+  int32_t i6;
+});
+
 IREE_VM_ABI_FIXED_STRUCT(r, { iree_vm_ref_t r0; });
 
 IREE_VM_ABI_FIXED_STRUCT(rr, {
@@ -237,6 +253,84 @@ IREE_VM_ABI_FIXED_STRUCT(riirii, {
   int32_t i5;
 });
 
+IREE_VM_ABI_FIXED_STRUCT(riiiriiii, {
+  iree_vm_ref_t r0;
+  int32_t i1;
+  int32_t i2;
+  int32_t i3;
+  iree_vm_ref_t r4;
+  int32_t i5;
+  int32_t i6;
+  int32_t i7;
+  int32_t i8;
+});
+
+IREE_VM_ABI_FIXED_STRUCT(riiiriiiii, {
+  iree_vm_ref_t r0;
+  int32_t i1;
+  int32_t i2;
+  int32_t i3;
+  iree_vm_ref_t r4;
+  int32_t i5;
+  int32_t i6;
+  int32_t i7;
+  int32_t i8;
+  int32_t i9;
+});
+
+IREE_VM_ABI_FIXED_STRUCT(riiiriiiriiiii, {
+  iree_vm_ref_t r0;
+  int32_t i1;
+  int32_t i2;
+  int32_t i3;
+  iree_vm_ref_t r4;
+  int32_t i5;
+  int32_t i6;
+  int32_t i7;
+  iree_vm_ref_t r8;
+  int32_t i9;
+  int32_t i10;
+  int32_t i11;
+  int32_t i12;
+  int32_t i13;
+});
+
+IREE_VM_ABI_FIXED_STRUCT(riiiriiiriiiriiiii, {
+  iree_vm_ref_t r0;
+  int32_t i1;
+  int32_t i2;
+  int32_t i3;
+  iree_vm_ref_t r4;
+  int32_t i5;
+  int32_t i6;
+  int32_t i7;
+  iree_vm_ref_t r8;
+  int32_t i9;
+  int32_t i10;
+  int32_t i11;
+  iree_vm_ref_t r12;
+  int32_t i13;
+  int32_t i14;
+  int32_t i15;
+  int32_t i16;
+  int32_t i17;
+});
+
+IREE_VM_ABI_FIXED_STRUCT(riiriiriiiii, {
+  iree_vm_ref_t r0;
+  int32_t i1;
+  int32_t i2;
+  iree_vm_ref_t r3;
+  int32_t i4;
+  int32_t i5;
+  iree_vm_ref_t r6;
+  int32_t i7;
+  int32_t i8;
+  int32_t i9;
+  int32_t i10;
+  int32_t i11;
+});
+
 IREE_VM_ABI_FIXED_STRUCT(rriii, {
   iree_vm_ref_t r0;
   iree_vm_ref_t r1;
@@ -369,6 +463,7 @@ IREE_VM_ABI_VLA_STRUCT(rriCiriiD, a3_count, a3, {
 //===----------------------------------------------------------------------===//
 
 IREE_VM_ABI_DECLARE_SHIM(irii, v);
+IREE_VM_ABI_DECLARE_SHIM(iriiiii, v);
 IREE_VM_ABI_DECLARE_SHIM(r, i);
 IREE_VM_ABI_DECLARE_SHIM(r, ii);
 IREE_VM_ABI_DECLARE_SHIM(r, iii);
@@ -390,13 +485,19 @@ IREE_VM_ABI_DECLARE_SHIM(rii, v);
 IREE_VM_ABI_DECLARE_SHIM(rif, v);
 IREE_VM_ABI_DECLARE_SHIM(riii, r);
 IREE_VM_ABI_DECLARE_SHIM(riii, v);
+IREE_VM_ABI_DECLARE_SHIM(riiiriiii, v);
+IREE_VM_ABI_DECLARE_SHIM(riiiriiiii, v);
+IREE_VM_ABI_DECLARE_SHIM(riiiriiiriiiii, v);
+IREE_VM_ABI_DECLARE_SHIM(riiiriiiriiiriiiii, v);
 IREE_VM_ABI_DECLARE_SHIM(riirii, r);
+IREE_VM_ABI_DECLARE_SHIM(riiriiriiiii, v);
 IREE_VM_ABI_DECLARE_SHIM(rrrCrD, r);
 IREE_VM_ABI_DECLARE_SHIM(ririi, v);
 IREE_VM_ABI_DECLARE_SHIM(rr, i);
 IREE_VM_ABI_DECLARE_SHIM(rr, r);
 IREE_VM_ABI_DECLARE_SHIM(rr, v);
 IREE_VM_ABI_DECLARE_SHIM(rr, ii);
+IREE_VM_ABI_DECLARE_SHIM(rr, ri);
 IREE_VM_ABI_DECLARE_SHIM(rrCiriiD, r);
 IREE_VM_ABI_DECLARE_SHIM(rriCiD, v);
 IREE_VM_ABI_DECLARE_SHIM(rriCiriiD, v);
@@ -0,0 +1,303 @@
+#!/usr/bin/env python3
+
+# Copyright 2021 The IREE Authors
+#
+# Licensed under the Apache License v2.0 with LLVM Exceptions.
+# See https://llvm.org/LICENSE.txt for license information.
+# SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+"""Tunes the CPU lowering configuration of each dispatch of a model.
+
+Compiles the model for the local CPU with one benchmark function per dispatch
+(--iree-flow-export-dispatch-benchmark-funcs), enumerates candidate lowering
+configurations around the one selected by the compiler for the root op of each
+dispatch, benchmarks every candidate of each dispatch in isolation with
+iree-benchmark-module, and writes a tuning database with the fastest
+configuration per dispatch signature. The database is consumed by the compiler
+with --iree-codegen-llvm-tuning-db=<path>.
+
+Candidates are compiled in rounds: round N uses the N-th candidate of every
+dispatch signature at once so the model is only compiled once per round.
+
+Example:
+  python3 scripts/autotune_cpu_dispatches.py \\
+      --input=model.mlir \\
+      --translate_flag=--iree-input-type=mhlo \\
+      --translate_flag=--iree-llvm-target-cpu-features=host \\
+      -o tuning_db.json
+"""
+
+import argparse
+import itertools
+import json
+import math
+import os
+import subprocess
+import sys
+import tempfile
+
+TUNING_DATABASE_VERSION = 1
+
+# Scale factors applied to the tile sizes selected by the compiler.
+TILE_SIZE_FACTORS = (0.25, 0.5, 1, 2, 4)
+
+TIME_UNIT_TO_NS = {"ns": 1, "us": 1e3, "ms": 1e6, "s": 1e9}
+
+
+def parse_arguments():
+  """Parses command line arguments."""
+  parser = argparse.ArgumentParser(description=__doc__.split("\n")[0])
+  parser.add_argument("--input",
+                      type=str,
+                      required=True,
+                      metavar="<input-file>",
+                      help="The model to compile with iree-translate")
+  parser.add_argument("--translate_flag",
+                      type=str,
+                      action="append",
+                      default=[],
+                      metavar="<flag>",
+                      help="Additional flag passed to iree-translate")
+  parser.add_argument("--iree_translate",
+                      type=str,
+                      default="iree-translate",
+                      metavar="<path>",
+                      help="Path to iree-translate")
+  parser.add_argument("--iree_benchmark_module",
+                      type=str,
+                      default="iree-benchmark-module",
+                      metavar="<path>",
+                      help="Path to iree-benchmark-module")
+  parser.add_argument("--driver",
+                      type=str,
+                      default="dylib",
+                      metavar="<driver>",
+                      help="The IREE driver to benchmark with")
+  parser.add_argument("--benchmark_repetitions",
+                      type=int,
+                      default=3,
+                      metavar="<count>",
+                      help="Number of times each dispatch is benchmarked")
+  parser.add_argument("--max_candidates",
+                      type=int,
+                      default=16,
+                      metavar="<count>",
+                      help="Maximum number of candidates per dispatch")
+  parser.add_argument("--work_dir",
+                      type=str,
+                      default=None,
+                      metavar="<dir>",
+                      help="Directory for intermediate files (default: temp)")
+  parser.add_argument("-o",
+                      "--output",
+                      type=str,
+                      required=True,
+                      metavar="<output-file>",
+                      help="The tuning database to write")
+  return parser.parse_args()
+
+
+def get_benchmark_function(entry):
+  """Returns the benchmark function exported for the dispatch of |entry|."""
+  name = entry["executable"]
+  if entry["entryPoint"] != name:
+    name += "_" + entry["entryPoint"]
+  return name + "_benchmark"
+
+
+def compile_module(args, output_path, extra_flags):
+  """Compiles the input to |output_path|; returns False on failure."""
+  command = [
+      args.iree_translate, args.input, "--iree-mlir-to-vm-bytecode-module",
+      "--iree-hal-target-backends=dylib-llvm-aot",
+      "--iree-flow-export-dispatch-benchmark-funcs", "-o", output_path
+  ] + args.translate_flag + extra_flags
+  result = subprocess.run(command, stderr=subprocess.PIPE)
+  if result.returncode != 0:
+    print(f"Compilation failed: {' '.join(command)}", file=sys.stderr)
+    print(result.stderr.decode("utf-8", errors="replace"), file=sys.stderr)
+    return False
+  return True
+
+
+def benchmark_function(args, module_path, function_name):
+  """Returns the fastest time in ns of |function_name| or None on failure."""
+  command = [
+      args.iree_benchmark_module, f"--module_file={module_path}",
+      f"--driver={args.driver}", f"--entry_function={function_name}",
+      "--benchmark_format=json",
+      f"--benchmark_repetitions={args.benchmark_repetitions}"
+  ]
+  result = subprocess.run(command,
+                          stdout=subprocess.PIPE,
+                          stderr=subprocess.DEVNULL)
+  if result.returncode != 0:
+    return None
+  times = []
+  for benchmark in json.loads(result.stdout)["benchmarks"]:
+    if benchmark.get("run_type", "iteration") != "iteration":
+      continue
+    times.append(benchmark["real_time"] *
+                 TIME_UNIT_TO_NS[benchmark.get("time_unit", "ns")])
+  return min(times) if times else None
+
+
+def read_dumped_entries(dump_dir):
+  """Returns the first dumped entry of each dispatch signature."""
+  entries = {}
+  for file_name in sorted(os.listdir(dump_dir)):
+    if not file_name.endswith(".json"):
+      continue
+    with open(os.path.join(dump_dir, file_name)) as f:
+      for entry in json.load(f)["entries"]:
+        entries.setdefault(entry["signature"], entry)
+  return entries
+
+
+def scale_tile_sizes(tile_sizes, factor):
+  """Scales the tiled (> 1) sizes by |factor| keeping them at least 1."""
+  return [
+      max(int(size * factor), 1) if size > 1 else size for size in tile_sizes
+  ]
+
+
+def is_valid_config(tile_sizes):
+  """Returns True if each level of tiling evenly divides the enclosing one."""
+  for outer, inner in zip(tile_sizes, tile_sizes[1:]):
+    for outer_size, inner_size in zip(outer, inner):
+      if outer_size == 0 or inner_size == 0:
+        continue
+      if inner_size > outer_size or outer_size % inner_size != 0:
+        return False
+  return True
+
+
+def enumerate_candidates(entry, max_candidates):
+  """Returns candidate tile sizes around those selected by the compiler.
+
+  All levels but the innermost (vector) level of multi-level configurations are
+  scaled uniformly; single-level configurations are scaled per dimension.
+  Candidates are ordered by their distance to the default and the default
+  itself is excluded.
+  """
+  default = entry["tileSizes"]
+  if len(default) > 1:
+    level_choices = [[(factor, scale_tile_sizes(level, factor))
+                      for factor in TILE_SIZE_FACTORS]
+                     for level in default[:-1]]
+    candidates = []
+    for choice in itertools.product(*level_choices):
+      distance = sum(abs(math.log2(factor)) for factor, _ in choice)
+      tile_sizes = [sizes for _, sizes in choice] + [default[-1]]
+      candidates.append((distance, tile_sizes))
+  else:
+    tiled_dims = [i for i, size in enumerate(default[0]) if size > 1]
+    candidates = []
+    for factors in itertools.product(TILE_SIZE_FACTORS,
+                                     repeat=len(tiled_dims)):
+      sizes = list(default[0])
+      for dim, factor in zip(tiled_dims, factors):
+        sizes[dim] = max(int(sizes[dim] * factor), 1)
+      distance = sum(abs(math.log2(factor)) for factor in factors)
+      candidates.append((distance, [sizes]))
+
+  result = []
+  for _, tile_sizes in sorted(candidates, key=lambda c: c[0]):
+    if tile_sizes == default or tile_sizes in result:
+      continue
+    if not is_valid_config(tile_sizes):
+      continue
+    result.append(tile_sizes)
+    if len(result) == max_candidates:
+      break
+  return result
+
+
+def make_database_entry(entry, tile_sizes, time_ns=None):
+  db_entry = {
+      "signature": entry["signature"],
+      "executable": entry["executable"],
+      "entryPoint": entry["entryPoint"],
+      "tileSizes": tile_sizes,
+      "nativeVectorSize": entry.get("nativeVectorSize", []),
+  }
+  if time_ns is not None:
+    db_entry["timeNs"] = time_ns
+  return db_entry
+
+
+def write_database(path, db_entries):
+  with open(path, "w") as f:
+    json.dump({
+        "version": TUNING_DATABASE_VERSION,
+        "entries": db_entries
+    },
+              f,
+              indent=2)
+    f.write("\n")
+
+
+def main(args):
+  work_dir = args.work_dir or tempfile.mkdtemp(prefix="iree-autotune-")
+  os.makedirs(work_dir, exist_ok=True)
+
+  # Compile once with the default configurations and record them.
+  dump_dir = os.path.join(work_dir, "default_configs")
+  os.makedirs(dump_dir, exist_ok=True)
+  default_module = os.path.join(work_dir, "default.vmfb")
+  if not compile_module(
+      args, default_module,
+      [f"--iree-codegen-llvm-tuning-db-dump-dir={dump_dir}"]):
+    return 1
+  entries = read_dumped_entries(dump_dir)
+  print(f"Found {len(entries)} dispatch signatures")
+
+  best = {}
+  for signature, entry in entries.items():
+    time_ns = benchmark_function(args, default_module,
+                                 get_benchmark_function(entry))
+    if time_ns is None:
+      print(f"  skipping {signature}: no benchmark function")
+      continue
+    print(f"  {signature}: default {entry['tileSizes']} {time_ns:.0f} ns")
+    best[signature] = (time_ns, entry["tileSizes"])
+
+  candidates = {
+      signature: enumerate_candidates(entries[signature], args.max_candidates)
+      for signature in best
+  }
+  num_rounds = max([len(c) for c in candidates.values()], default=0)
+  for round_index in range(num_rounds):
+    round_entries = {
+        signature: c[round_index]
+        for signature, c in candidates.items()
+        if round_index < len(c)
+    }
+    round_db = os.path.join(work_dir, f"round_{round_index}.json")
+    write_database(round_db, [
+        make_database_entry(entries[signature], tile_sizes)
+        for signature, tile_sizes in round_entries.items()
+    ])
+    round_module = os.path.join(work_dir, f"round_{round_index}.vmfb")
+    print(f"Round {round_index + 1}/{num_rounds}")
+    if not compile_module(args, round_module,
+                          [f"--iree-codegen-llvm-tuning-db={round_db}"]):
+      continue
+    for signature, tile_sizes in round_entries.items():
+      time_ns = benchmark_function(args, round_module,
+                                   get_benchmark_function(entries[signature]))
+      if time_ns is None:
+        continue
+      if time_ns < best[signature][0]:
+        print(f"  {signature}: {tile_sizes} {time_ns:.0f} ns")
+        best[signature] = (time_ns, tile_sizes)
+
+  write_database(args.output, [
+      make_database_entry(entries[signature], tile_sizes, time_ns)
+      for signature, (time_ns, tile_sizes) in sorted(best.items())
+  ])
+  print(f"Wrote {len(best)} entries to {args.output}")
+  return 0
+
+
+if __name__ == "__main__":
+  sys.exit(main(parse_arguments()))